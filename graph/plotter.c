@@ -294,6 +294,7 @@ struct MultigrapherStruct
 static int clip_line (Multigrapher *multigrapher, double *x0_p, double *y0_p, double *x1_p, double *y1_p);
 static int spacing_type (double spacing);
 static outcode compute_outcode (Multigrapher *multigrapher, double x, double y, bool tolerant);
+static bool extends_polyline (Multigrapher *multigrapher, const Point *point);
 static void plot_abscissa_log_subsubtick (Multigrapher *multigrapher, double xval);
 static void plot_errorbar (Multigrapher *multigrapher, const Point *p);
 static void plot_ordinate_log_subsubtick (Multigrapher *multigrapher, double xval);
@@ -2324,17 +2325,66 @@ set_line_style (Multigrapher *multigrapher, int style, bool use_color)
 }
 
 
-/* plot_point_array() calls plot_point() on each point in an array of
- * points.
+/* Maximum number of points that plot_point_array() passes to libplot in a
+   single call to pl_fpolyline_r(). */
+#define POLYLINE_BATCH_SIZE 1024
+
+/* plot_point_array() plots each point in an array of points, just as
+ * plot_point() would.  But runs of points that merely extend the polyline
+ * under construction (see extends_polyline() below) are converted to
+ * libplot coordinates and passed to libplot in batches, via
+ * pl_fpolyline_r(), rather than one at a time via pl_fcont_r().
  */
 
 void
 plot_point_array (Multigrapher *multigrapher, const Point *p, int length)
 {
-  int index;
+  double x[POLYLINE_BATCH_SIZE], y[POLYLINE_BATCH_SIZE];
+  int index = 0, n;
 
-  for (index = 0; index < length; index++)
-    plot_point (multigrapher, &(p[index]));
+  while (index < length)
+    {
+      n = 0;
+      if (!multigrapher->first_point_of_polyline
+	  && compute_outcode (multigrapher, multigrapher->oldpoint_x,
+			      multigrapher->oldpoint_y, true) == 0)
+	/* previous point is within the plotting area */
+	while (index < length && n < POLYLINE_BATCH_SIZE
+	       && extends_polyline (multigrapher, &(p[index])))
+	  {
+	    x[n] = XV (p[index].x);
+	    y[n] = YV (p[index].y);
+	    multigrapher->oldpoint_x = p[index].x;
+	    multigrapher->oldpoint_y = p[index].y;
+	    n++;
+	    index++;
+	  }
+
+      if (n > 0)
+	pl_fpolyline_r (multigrapher->plotter, n, x, y);
+      else
+	{
+	  plot_point (multigrapher, &(p[index]));
+	  index++;
+	}
+    }
+}
+
+/* extends_polyline() returns true if plot_point(), applied to the
+ * specified point, would do nothing but invoke pl_fcont_r() on it: the
+ * point is joined to the previous point (which the caller must have
+ * checked is within the plotting area), it is itself within the plotting
+ * area so that no clipping is needed, and it has neither a symbol nor an
+ * errorbar.
+ */
+
+static bool
+extends_polyline (Multigrapher *multigrapher, const Point *point)
+{
+  return (point->pendown && point->linemode > 0
+	  && point->symbol <= 0
+	  && !point->have_x_errorbar && !point->have_y_errorbar
+	  && compute_outcode (multigrapher, point->x, point->y, true) == 0);
 }
 
 /* plot_point() plots a single point, including the appropriate symbol and
@@ -189,9 +189,11 @@ int pl_fpointrel_r (plPlotter *plotter, double dx, double dy);
 int pl_fspace_r (plPlotter *plotter, double x0, double y0, double x1, double y1);
 int pl_fspace2_r (plPlotter *plotter, double x0, double y0, double x1, double y1, double x2, double y2);
 
-/* 6 floating point operations with no integer counterpart (GNU additions) */
+/* 8 floating point operations with no integer counterpart (GNU additions) */
 int pl_fconcat_r (plPlotter *plotter, double m0, double m1, double m2, double m3, double m4, double m5);
 int pl_fmiterlimit_r (plPlotter *plotter, double limit);
+int pl_fpoints_r (plPlotter *plotter, int n, const double *x, const double *y);
+int pl_fpolyline_r (plPlotter *plotter, int n, const double *x, const double *y);
 int pl_frotate_r (plPlotter *plotter, double theta);
 int pl_fscale_r (plPlotter *plotter, double x, double y);
 int pl_fsetmatrix_r (plPlotter *plotter, double m0, double m1, double m2, double m3, double m4, double m5);
@@ -314,9 +316,11 @@ int pl_fpointrel (double dx, double dy);
 int pl_fspace (double x0, double y0, double x1, double y1);
 int pl_fspace2 (double x0, double y0, double x1, double y1, double x2, double y2);
 
-/* 6 floating point operations with no integer counterpart (GNU additions) */
+/* 8 floating point operations with no integer counterpart (GNU additions) */
 int pl_fconcat (double m0, double m1, double m2, double m3, double m4, double m5);
 int pl_fmiterlimit (double limit);
+int pl_fpoints (int n, const double *x, const double *y);
+int pl_fpolyline (int n, const double *x, const double *y);
 int pl_frotate (double theta);
 int pl_fscale (double x, double y);
 int pl_fsetmatrix (double m0, double m1, double m2, double m3, double m4, double m5);
@@ -110,10 +110,12 @@ typedef struct
    "boxes" (rectangles aligned with the coordinate axes).
 
    A simple path that is a sequence of segments is represented internally
-   as a list of plPathSegments.  Each contains a single endpoint (x,y), and
+   as a list of segments.  Each contains a single endpoint (x,y), and
    specifies how to get there (e.g., via a pen-up motion, which is used for
    the first point in a path, or via a line segment, or a curve defined by
-   control points).
+   control points).  Since most segments are line segments, the list is
+   stored compactly (see plPath below), and a plPathSegment is used only
+   to describe a single segment in full.
    
    A well-formed simple path of this `segment list' type has the form:
    { moveto { line | arc | ellarc | quad | cubic }* { closepath }? } */
@@ -133,6 +135,17 @@ typedef struct
   plPoint pd;			/* additional control point (S_CUBIC only) */
 } plPathSegment;
 
+/* Structure for a segment, other than the initial moveto, that isn't a
+   line segment, i.e., that is a curve or a closepath.  A segment list
+   keeps these in a sparse side table, in increasing order of index. */
+typedef struct
+{
+  int index;			/* index of segment in list */
+  plPathSegmentType type;	/* S_ARC, S_ELLARC, S_QUAD, S_CUBIC etc. */
+  plPoint pc;			/* intermediate control point (if any) */
+  plPoint pd;			/* additional control point (S_CUBIC only) */
+} plPathCurve;
+
 /* Allowed values for the path type field in a plPath (see below). */
 typedef enum 
 { 
@@ -152,11 +165,18 @@ typedef struct
 {
   plPathType type;	/* PATH_{SEGMENT_LIST,CIRCLE,ELLIPSE,BOX} */
   double llx, lly, urx, ury;    /* bounding box */
-  /* simple path of segment list type */
-  plPathSegment *segments;	/* list of path segments */
+  /* simple path of segment list type: the endpoint of each segment, with
+     the curves (if any) in a side table */
+  plPoint *points;		/* endpoints of segments */
   int num_segments;		/* number of segments in list */
-  int segments_len;		/* length of buffer for list storage (bytes) */
+  int segments_len;		/* number of slots allocated for endpoints */
+  plPathCurve *curves;		/* segments other than moveto/line, in order */
+  int num_curves;		/* number of entries in side table */
+  int curves_len;		/* number of slots allocated for side table */
   bool primitive;		/* advisory (see above; some Plotters use it)*/
+  double flatness;		/* tolerance for flattening curves (user
+				   coors), or 0.0 for fixed subdivision */
+  int flattened_vertices;	/* vertices added by flattening curves */
   /* simple path of built-in primitive type (circle/ellipse/box) */
   plPoint pc;			/* CIRCLE/ELLIPSE: center */
   double radius;		/* CIRCLE: radius */
@@ -258,6 +278,23 @@ typedef struct
     && (pixel1).u.rgb[1] == (pixel2).u.rgb[1] \
     && (pixel1).u.rgb[2] == (pixel2).u.rgb[2]))
 
+/* BitmapPlotters and GIFPlotters draw on packed libxmi canvases (RGBA32
+   and INDEX8 respectively), so libxmi needs to know how to convert our
+   pixels to and from their packed forms.  See xmi.h. */
+#define MI_PIXEL_TO_RGBA32(pixel) \
+  ((unsigned int)(pixel).u.rgb[0] \
+   | ((unsigned int)(pixel).u.rgb[1] << 8) \
+   | ((unsigned int)(pixel).u.rgb[2] << 16) \
+   | ((unsigned int)0xff << 24))
+#define MI_RGBA32_TO_PIXEL(value, pixel) \
+  { (pixel).type = MI_PIXEL_RGB_TYPE; \
+    (pixel).u.rgb[0] = (unsigned char)((value) & 0xff); \
+    (pixel).u.rgb[1] = (unsigned char)(((value) >> 8) & 0xff); \
+    (pixel).u.rgb[2] = (unsigned char)(((value) >> 16) & 0xff); }
+#define MI_PIXEL_TO_INDEX8(pixel) ((pixel).u.index)
+#define MI_INDEX8_TO_PIXEL(value, pixel) \
+  { (pixel).type = MI_PIXEL_INDEX_TYPE; (pixel).u.index = (value); }
+
 
 /**********************************************************************/
 
@@ -391,6 +428,9 @@ typedef struct plDrawStateStruct
   double default_line_width;	/* width of lines in user coordinates */
   double default_font_size;	/* font size in user coordinates */
 
+/* FLATNESS parameter in user coordinates (also set by fsetmatrix()) */
+  double flatness;		/* tolerance for flattening curves, or 0.0 */
+
 /****************** DEVICE-DEPENDENT PART ***************************/
 
 /* elements specific to the HPGL Plotter drawing state */
@@ -472,6 +512,14 @@ typedef struct plDrawStateStruct
 #define NUM_PS_FONTS 35
 #define NUM_PCL_FONTS 45
 
+/* A completed chunk of the device code stored in a plOutbuf. */
+typedef struct plOutbufChunkStruct
+{
+  char *data;			/* contents of chunk */
+  unsigned long len;		/* size of contents */
+  struct plOutbufChunkStruct *next; /* next chunk in plOutbuf, if any */
+} plOutbufChunk;
+
 typedef struct plOutbufStruct
 {
   /* if non-NULL, a plOutbuf containing a page header */
@@ -480,12 +528,19 @@ typedef struct plOutbufStruct
   /* if non-NULL, a plOutbuf containing a page trailer */
   struct plOutbufStruct *trailer;
 
-  /* device code for the graphics on the page */
-  char *base;			/* start of buffer */
-  unsigned long len;		/* size of buffer */
+  /* device code for the graphics on the page: whatever has been spilled
+     to a temporary file, followed by a list of completed chunks, followed
+     by the current chunk */
+  FILE *spill_fp;		/* temporary file, if any */
+  unsigned long spilled;	/* size of spilled contents */
+  plOutbufChunk *first_chunk;	/* completed chunks held in memory */
+  plOutbufChunk *last_chunk;
+  unsigned long chunk_contents;	/* size of contents of completed chunks */
+  unsigned long memory_limit;	/* if > 0, max memory for completed chunks */
+  char *base;			/* start of current chunk */
+  unsigned long len;		/* size of current chunk */
   char *point;			/* current point (high-water mark) */
-  char *reset_point;		/* point below which contents are frozen */
-  unsigned long contents;	/* size of contents */
+  unsigned long contents;	/* size of contents of current chunk */
   unsigned long reset_contents;	/* size of frozen contents if any */
 
   /* page-specific information that some Plotters generate and use (this is
@@ -506,9 +561,8 @@ typedef struct plOutbufStruct
   struct plOutbufStruct *next;
 } plOutbuf;
 
-/* Each Plotter caches the color names that have previously been mapped to
-   RGB triples via libplot's colorname database (see g_colorname.h).
-   For the cache, a linked list is currently used. */
+/* An entry in libplot's colorname database (see g_colorname.h), which
+   maps color names to RGB triples. */
 
 typedef struct
 {
@@ -518,17 +572,6 @@ typedef struct
   unsigned char blue;
 } plColorNameInfo;
 
-typedef struct plCachedColorNameInfoStruct
-{
-  const plColorNameInfo *info;
-  struct plCachedColorNameInfoStruct *next;
-} plCachedColorNameInfo;
-
-typedef struct
-{
-  plCachedColorNameInfo *cached_colors;	/* head of linked list */
-} plColorNameCache;
-
 #ifndef X_DISPLAY_MISSING
 /* Each X DrawablePlotter (or X Plotter) keeps track of which fonts have
    been request from an X server, in any connection, by constructing a
@@ -569,7 +612,7 @@ typedef struct plColorRecordStruct
    Plotter class (should be moved elsewhere if possible). */
 
 /* Number of recognized Plotter parameters (see g_params2.c). */
-#define NUM_PLOTTER_PARAMETERS 35
+#define NUM_PLOTTER_PARAMETERS 48
 
 /* Maximum number of pens, or logical pens, for an HP-GL/2 device.  Some
    such devices permit as many as 256, but all should permit at least 32.
@@ -581,6 +624,12 @@ typedef struct plColorRecordStruct
    libplot/extern.h. */
 #define FIG_MAX_NUM_USER_COLORS 512
 
+/* Size of the hash table that maps 24-bit RGBs to indices in a GIF
+   Plotter's colormap.  Must be a power of 2, and at least four times the
+   maximum size of the colormap (256), since once the colormap is full the
+   table also caches the nearest entry for colors that are not in it. */
+#define GIF_COLOR_HASH_SIZE 1024
+
 /* Supported Plotter types.  These values are used in a `tag field', in
    libplot but not libplotter.  (C++ doesn't have such things, at least it
    didn't until RTTI was invented :-)). */
@@ -676,6 +725,9 @@ typedef enum
    it's the core Plotter code that changes them; not the device-specific
    drivers.  They're flagged by D: (i.e. dynamic), in their description. */
 
+/* number of discarded paths kept for reuse (see g_subpaths.c) */
+#define PL_NUM_SPARE_PATHS 4
+
 typedef struct
 {
   /* data members (a great many!) which are really Plotter parameters */
@@ -723,6 +775,14 @@ typedef struct
 
   /* path-related parameters (also internal) */
   int max_unfilled_path_length; /* user-settable, for unfilled polylines */
+  unsigned long page_memory_limit; /* user-settable, 0 means no limit */
+  double flatness;		/* user-settable, device units; 0.0 means
+				   curves are subdivided a fixed number of
+				   times when flattened */
+  bool report_stats;		/* user-settable, report statistics? */
+  bool cull_paths;		/* user-settable, drop off-page paths? */
+  double decimation;		/* user-settable, device units; 0.0 means
+				   polylines are not decimated */
   bool have_mixed_paths;	/* can mix arcs/Beziers and lines in paths? */
   plScalingType allowed_arc_scaling; /* scaling allowed for circular arcs */
   plScalingType allowed_ellarc_scaling;	/* scaling allowed for elliptic arcs */
@@ -735,9 +795,6 @@ typedef struct
   /* color-related parameters (also internal) */
   bool emulate_color;		/* emulate color by grayscale? */
 
-  /* cache of previously retrieved color names (used for speed) */
-  plColorNameCache *color_name_cache;/* pointer to color name cache */
-
   /* info on the device coordinate frame (ranges for viewport in terms of
      native device coordinates, etc.; note that if flipped_y=true, then
      jmax<jmin or ymax<ymin) */
@@ -779,6 +836,14 @@ typedef struct
   plOutbuf *page;		/* D: output buffer for current page */
   plOutbuf *first_page;		/* D: first page (if a linked list is kept) */
 
+  /* discarded paths, with their storage, kept for reuse on current page */
+  plPath *spare_paths[PL_NUM_SPARE_PATHS]; /* D: */
+  int num_spare_paths;		/* D: number of spare paths */
+  unsigned long flattened_vertices; /* D: vertices added by flattening
+				       curves, on current page */
+  unsigned long decimated_vertices; /* D: vertices dropped by decimating
+				       polylines, on current page */
+
 } plPlotterData;
 
 /* The macro Q___ is used for declaring Plotter methods (as function
@@ -986,6 +1051,8 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   int fontsize (int size);
   int fpoint (double x, double y);
   int fpointrel (double dx, double dy);
+  int fpoints (int n, const double *x, const double *y);
+  int fpolyline (int n, const double *x, const double *y);
   int frotate (double theta);
   int fscale (double x, double y);
   int fsetmatrix (double m0, double m1, double m2, double m3, double m4, double m5);
@@ -1191,8 +1258,14 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   /* data members specific to Bitmap Plotters */
   void * b_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int b_xn, b_yn;		/* bitmap dimensions */
+  bool b_antialias;		/* anti-aliased drawing? */
+  int b_threads;		/* number of threads used in rasterizing */
   void * b_painted_set;	/* D: libxmi's canvas (a (miPaintedSet *)) */
   void * b_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * b_coverage_set;	/* D: anti-aliased spans (a (miCoverageSet *)) */
+  int b_color_class;		/* D: 0/1/2 = page is mono/gray/color so far */
+  int b_num_painted_colors;	/* D: # of colors painted, or -1 if unknown */
+  int b_painted_colors[256];	/* D: 24-bit RGBs of colors painted so far */
   /* data members specific to Metafile Plotters */
   /* 0. parameters */
   bool meta_portable_output;	/* portable, not binary output format? */
@@ -1369,30 +1442,39 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
   bool z_interlace;		/* interlaced PNG? */
   bool z_transparent;		/* transparent PNG? */
   plColor z_transparent_color;	/* if so, transparent color (24-bit RGB) */
+  int z_compression_level;	/* zlib compression level, or -1 (default) */
+  int z_compression_strategy;	/* zlib compression strategy, or -1 */
+  int z_filter;			/* mask of PNG row filters, or -1 */
 #endif /* INCLUDE_PNG_SUPPORT */
 /* data members specific to GIF Plotters */
   int i_xn, i_yn;		/* bitmap dimensions */
-  int i_num_pixels;		/* total pixels (used by scanner) */
   bool i_animation;		/* animated (multi-image) GIF? */
   int i_iterations;		/* number of times GIF should be looped */
   int i_delay;			/* delay after image, in 1/100 sec units */
   bool i_interlace;		/* interlaced GIF? */
+  bool i_rle;			/* miGIF run-length encoding, not LZW? */
+  bool i_quantize;		/* build each frame's colormap when written? */
+  bool i_antialias;		/* anti-aliased drawing? */
   bool i_transparent;		/* transparent GIF? */
   plColor i_transparent_color;	/* if so, transparent color (24-bit RGB) */
   void * i_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int i_transparent_index;	/* D: transparent color index (if any) */
   void * i_painted_set;	/* D: libxmi's canvas (a (miPaintedSet *)) */
   void * i_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * i_coverage_set;	/* D: anti-aliased spans (a (miCoverageSet *)) */
   plColor i_colormap[256];	/* D: frame colormap (containing 24-bit RGBs)*/
   int i_num_color_indices;	/* D: number of color indices allocated */
+  int i_color_hash_key[GIF_COLOR_HASH_SIZE]; /* D: hashed 24-bit RGBs, or -1 */
+  unsigned char i_color_hash_index[GIF_COLOR_HASH_SIZE]; /* D: their indices */
+  int i_num_color_hash_entries;	/* D: number of hash table entries in use */
   bool i_frame_nonempty;	/* D: something drawn in current frame? */
   int i_bit_depth;		/* D: bit depth (ceil(log2(num_indices))) */
-  int i_pixels_scanned;		/* D: number that scanner has scanned */
-  int i_pass;			/* D: scanner pass (used if interlacing) */
-  plIntPoint i_hot;		/* D: scanner hot spot */
   plColor i_global_colormap[256]; /* D: colormap for first frame (stashed) */
   int i_num_global_color_indices;/* D: number of indices in global colormap */
   bool i_header_written;	/* D: GIF header written yet? */
+  bool i_differencing;		/* D: frames after first written as changes? */
+  unsigned char *i_prev_frame;	/* D: if so, previous frame's color indices */
+  plColor i_prev_colormap[256];	/* D: if so, previous frame's colormap */
 #ifndef X_DISPLAY_MISSING
 /* data members specific to X Drawable Plotters and X Plotters */
   Display *x_dpy;		/* X display */
@@ -1446,6 +1528,7 @@ typedef struct plPlotterStruct	/* this tag is used only by libplot */
 
 #ifndef NOT_LIBPLOTTER
   void _flush_plotter_outstreams (void);
+  void _report_mi_stats (const void * ptr_painted_set, const void * ptr_ellipse_cache);
 #endif /* NOT_LIBPLOTTER */
 
 }
@@ -1588,15 +1671,23 @@ class BitmapPlotter : public Plotter
   virtual int _maybe_output_image (void);
   /* BitmapPlotter-specific internal functions */
   void _b_delete_image (void);
+  void _b_draw_antialiased_path (void);
   void _b_draw_elliptic_arc (plPoint p0, plPoint p1, plPoint pc);
   void _b_draw_elliptic_arc_2 (plPoint p0, plPoint p1, plPoint pc);
   void _b_draw_elliptic_arc_internal (int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
   void _b_new_image (void);
+  void _b_note_color (int red, int green, int blue);
   /* BitmapPlotter-specific data members */
   void * b_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int b_xn, b_yn;		/* bitmap dimensions */
+  bool b_antialias;		/* anti-aliased drawing? */
+  int b_threads;		/* number of threads used in rasterizing */
   void * b_painted_set;	/* D: libxmi's canvas (a (miPaintedSet *)) */
   void * b_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * b_coverage_set;	/* D: anti-aliased spans (a (miCoverageSet *)) */
+  int b_color_class;		/* D: 0/1/2 = page is mono/gray/color so far */
+  int b_num_painted_colors;	/* D: # of colors painted, or -1 if unknown */
+  int b_painted_colors[256];	/* D: 24-bit RGBs of colors painted so far */
 };
 
 /* The TekPlotter class, which produces Tektronix output */
@@ -2179,6 +2270,9 @@ class PNGPlotter : public BitmapPlotter
   bool z_interlace;		/* interlaced PNG? */
   bool z_transparent;		/* transparent PNG? */
   plColor z_transparent_color;	/* if so, transparent color (24-bit RGB) */
+  int z_compression_level;	/* zlib compression level, or -1 (default) */
+  int z_compression_strategy;	/* zlib compression strategy, or -1 */
+  int z_filter;			/* mask of PNG row filters, or -1 */
 };
 #endif /* INCLUDE_PNG_SUPPORT */
 
@@ -2216,43 +2310,50 @@ class GIFPlotter : public Plotter
   bool paint_paths (void);
   /* GIFPlotter-specific internal functions */
   unsigned char _i_new_color_index (int red, int green, int blue);
-  int _i_scan_pixel (void);
+  void _i_color_pixel (void * ptr_pixel, plColor color, unsigned char index);
   void _i_delete_image (void);
+  void _i_draw_antialiased_path (void);
   void _i_draw_elliptic_arc (plPoint p0, plPoint p1, plPoint pc);
   void _i_draw_elliptic_arc_2 (plPoint p0, plPoint p1, plPoint pc);
   void _i_draw_elliptic_arc_internal (int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
   void _i_new_image (void);
+  void _i_quantize_image (void);
   void _i_set_bg_color (void);
   void _i_set_fill_color (void);
   void _i_set_pen_color (void);
-  void _i_start_scan (void);
   void _i_write_gif_header (void);
   void _i_write_gif_image (void);
   void _i_write_gif_trailer (void);
   void _i_write_short_int (unsigned int i);
   /* GIFPlotter-specific data members */
   int i_xn, i_yn;		/* bitmap dimensions */
-  int i_num_pixels;		/* total pixels (used by scanner) */
   bool i_animation;		/* animated (multi-image) GIF? */
   int i_iterations;		/* number of times GIF should be looped */
   int i_delay;			/* delay after image, in 1/100 sec units */
   bool i_interlace;		/* interlaced GIF? */
+  bool i_rle;			/* miGIF run-length encoding, not LZW? */
+  bool i_quantize;		/* build each frame's colormap when written? */
+  bool i_antialias;		/* anti-aliased drawing? */
   bool i_transparent;		/* transparent GIF? */
   plColor i_transparent_color;	/* if so, transparent color (24-bit RGB) */
   void * i_arc_cache_data;	/* pointer to cache (used by miPolyArc_r) */
   int i_transparent_index;	/* D: transparent color index (if any) */
   void * i_painted_set;	        /* D: libxmi's canvas (a (miPaintedSet *)) */
   void * i_canvas;		/* D: libxmi's canvas (a (miCanvas *)) */
+  void * i_coverage_set;	/* D: anti-aliased spans (a (miCoverageSet *)) */
   plColor i_colormap[256];	/* D: frame colormap (containing 24-bit RGBs)*/
   int i_num_color_indices;	/* D: number of color indices allocated */
+  int i_color_hash_key[GIF_COLOR_HASH_SIZE]; /* D: hashed 24-bit RGBs, or -1 */
+  unsigned char i_color_hash_index[GIF_COLOR_HASH_SIZE]; /* D: their indices */
+  int i_num_color_hash_entries;	/* D: number of hash table entries in use */
   bool i_frame_nonempty;	/* D: something drawn in current frame? */
   int i_bit_depth;		/* D: bit depth (ceil(log2(num_indices))) */
-  int i_pixels_scanned;		/* D: number that scanner has scanned */
-  int i_pass;			/* D: scanner pass (used if interlacing) */
-  plIntPoint i_hot;		/* D: scanner hot spot */
   plColor i_global_colormap[256]; /* D: colormap for first frame (stashed) */
   int i_num_global_color_indices;/* D: number of indices in global colormap */
   bool i_header_written;	/* D: GIF header written yet? */
+  bool i_differencing;		/* D: frames after first written as changes? */
+  unsigned char *i_prev_frame;	/* D: if so, previous frame's color indices */
+  plColor i_prev_colormap[256];	/* D: if so, previous frame's colormap */
 };
 
 #ifndef X_DISPLAY_MISSING
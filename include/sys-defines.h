@@ -127,6 +127,14 @@
 #endif
 #endif /* not UINT_MAX */
 
+#ifndef ULONG_MAX
+#ifdef	__STDC__
+#define ULONG_MAX ((unsigned long)(~(0UL)))
+#else
+#define ULONG_MAX ((unsigned long)(~((unsigned long)0)))
+#endif
+#endif /* not ULONG_MAX */
+
 #ifndef INT_MAX
 #ifdef MAXINT
 #define INT_MAX MAXINT
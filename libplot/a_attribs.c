@@ -61,37 +61,32 @@ _pl_a_set_attributes (S___(Plotter *_plotter))
       && _plotter->drawstate->fill_type > 0
       && _plotter->ai_fill_rule_type != desired_fill_rule)
     {
-      sprintf (_plotter->data->page->point, "%d XR\n", desired_fill_rule);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%d XR\n", desired_fill_rule);
       _plotter->ai_fill_rule_type = desired_fill_rule;
     }
   
   if (_plotter->ai_cap_style != desired_ai_cap_style)
     {
-      sprintf (_plotter->data->page->point, "%d J\n", desired_ai_cap_style);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%d J\n", desired_ai_cap_style);
       _plotter->ai_cap_style = desired_ai_cap_style;
     }
   
   if (_plotter->ai_join_style != desired_ai_join_style)
     {
-      sprintf (_plotter->data->page->point, "%d j\n", desired_ai_join_style);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%d j\n", desired_ai_join_style);
       _plotter->ai_join_style = desired_ai_join_style;
     }
 
   if (_plotter->drawstate->join_type == PL_JOIN_MITER
       && _plotter->ai_miter_limit != desired_ai_miter_limit)
     {
-      sprintf (_plotter->data->page->point, "%.4g M\n", desired_ai_miter_limit);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%.4g M\n", desired_ai_miter_limit);
       _plotter->ai_miter_limit = desired_ai_miter_limit;
     }
 
   if (_plotter->ai_line_width != desired_ai_line_width)
     {
-      sprintf (_plotter->data->page->point, "%.4f w\n", desired_ai_line_width);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%.4f w\n", desired_ai_line_width);
       _plotter->ai_line_width = desired_ai_line_width;
       changed_width = true;
     }
@@ -182,18 +177,15 @@ _pl_a_set_attributes (S___(Plotter *_plotter))
 	}
 
       /* emit dash array */
-      sprintf (_plotter->data->page->point, "[");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "[");
       for (i = 0; i < num_dashes; i++)
 	{
 	  if (i == 0)
-	    sprintf (_plotter->data->page->point, "%.4f", dashbuf[i]);
+	    _outbuf_printf (_plotter->data->page, "%.4f", dashbuf[i]);
 	  else
-	    sprintf (_plotter->data->page->point, " %.4f", dashbuf[i]);	  
-	  _update_buffer (_plotter->data->page);      
+	    _outbuf_printf (_plotter->data->page, " %.4f", dashbuf[i]);
 	}
-      sprintf (_plotter->data->page->point, "] %.4f d\n", offset);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "] %.4f d\n", offset);
 
       /* Update our knowledge of AI's line type (i.e. dashing style). 
 	 This new value will be one of PL_L_SOLID etc., or the pseudo value
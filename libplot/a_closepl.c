@@ -72,13 +72,12 @@ _pl_a_end_page (S___(Plotter *_plotter))
     iymid = IROUND(ymid);      
     
     /* emit first few comment lines */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%!PS-Adobe-3.0\n\
 %%%%Creator: GNU libplot drawing library %s\n\
 %%%%For: (Unknown) (Unknown)\n\
 %%%%Title: (Untitled)\n", 
-	     PL_LIBPLOT_VER_STRING);
-    _update_buffer (page_header);
+		    PL_LIBPLOT_VER_STRING);
     
     /* emit creation date and time, if possible */
     time(&clock);
@@ -92,10 +91,9 @@ _pl_a_end_page (S___(Plotter *_plotter))
 			      weekday, month, day, hour_min_sec, year);
 	if (num_matched == 5)
 	  {
-	    sprintf (page_header->point, "\
+	    _outbuf_printf (page_header, "\
 %%%%CreationDate: (%s %s %s) (%s)\n",
-		     day, month, year, hour_min_sec);
-	    _update_buffer (page_header);
+			    day, month, year, hour_min_sec);
 	  }
       }
     
@@ -103,111 +101,97 @@ _pl_a_end_page (S___(Plotter *_plotter))
     _bbox_of_outbuf (_plotter->data->page, &x_min, &x_max, &y_min, &y_max);
     if (x_min > x_max || y_min > y_max) /* no objects */
       /* place degenerate box at center of page */
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%%%BoundingBox: %d %d %d %d\n",
-	       ixmid, iymid, ixmid, iymid);
+		      ixmid, iymid, ixmid, iymid);
     else
       /* emit true bounding box */
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%%%BoundingBox: %d %d %d %d\n",
-	       IROUND(x_min - 0.5), IROUND(y_min - 0.5),
-	       IROUND(x_max + 0.5), IROUND(y_max + 0.5));
-    _update_buffer (page_header);
+		      IROUND(x_min - 0.5), IROUND(y_min - 0.5),
+		      IROUND(x_max + 0.5), IROUND(y_max + 0.5));
     if (_plotter->ai_version >= AI_VERSION_5)
       /* emit hi-res bounding box too */
       {
 	if (x_min > x_max || y_min > y_max) /* empty page */
 	  /* place degenerate box at center of page */
-	    sprintf (page_header->point, "\
+	    _outbuf_printf (page_header, "\
 %%%%HiResBoundingBox: %.4f %.4f %.4f %.4f\n",
-		     xmid, ymid, xmid, ymid);
+			    xmid, ymid, xmid, ymid);
 	else
 	  /* emit true bounding box */
-	  sprintf (page_header->point, "\
+	  _outbuf_printf (page_header, "\
 %%%%HiResBoundingBox: %.4f %.4f %.4f %.4f\n",
-		   x_min, y_min, x_max, y_max);
-	_update_buffer (page_header);
+			  x_min, y_min, x_max, y_max);
       }
     
     /* emit process colors used */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%DocumentProcessColors:");
-    _update_buffer (page_header);
     if (_plotter->ai_cyan_used)
       {
-	sprintf (page_header->point, " Cyan");
-	_update_buffer (page_header);
+	_outbuf_puts (page_header, " Cyan");
       }
     if (_plotter->ai_magenta_used)
       {
-	sprintf (page_header->point, " Magenta");
-	_update_buffer (page_header);
+	_outbuf_puts (page_header, " Magenta");
       }
     if (_plotter->ai_yellow_used)
       {
-	sprintf (page_header->point, " Yellow");
-	_update_buffer (page_header);
+	_outbuf_puts (page_header, " Yellow");
       }
     if (_plotter->ai_black_used)
       {
-	sprintf (page_header->point, " Black");
-	_update_buffer (page_header);
+	_outbuf_puts (page_header, " Black");
       }
-    sprintf (page_header->point, "\n");
-    _update_buffer (page_header);      
+    _outbuf_puts (page_header, "\n");
     
     /* tell AI to include any PS [or PCL] fonts that are needed */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%DocumentFonts: ");
-    _update_buffer (page_header);
     for (i = 0; i < PL_NUM_PS_FONTS; i++)
       if (_plotter->data->page->ps_font_used[i])
 	{
 	  if (fonts_used)	/* not first font */
-	    sprintf (page_header->point, 
-		     "%%%%+ %s\n", _pl_g_ps_font_info[i].ps_name);
+	    _outbuf_printf (page_header,
+			    "%%%%+ %s\n", _pl_g_ps_font_info[i].ps_name);
 	  else		/* first font */
-	    sprintf (page_header->point, 
-		     "%s\n", _pl_g_ps_font_info[i].ps_name);
-	  _update_buffer (page_header);
+	    _outbuf_printf (page_header,
+			    "%s\n", _pl_g_ps_font_info[i].ps_name);
 	  fonts_used = true;
 	}
     for (i = 0; i < PL_NUM_PCL_FONTS; i++)
       if (_plotter->data->page->pcl_font_used[i])
 	{
 	  if (fonts_used)	/* not first font */
-	    sprintf (page_header->point, 
-		     "%%%%+ %s\n", _pl_g_pcl_font_info[i].ps_name);
+	    _outbuf_printf (page_header,
+			    "%%%%+ %s\n", _pl_g_pcl_font_info[i].ps_name);
 	  else		/* first font */
-	    sprintf (page_header->point, 
-		     "%s\n", _pl_g_pcl_font_info[i].ps_name);
-	  _update_buffer (page_header);
+	    _outbuf_printf (page_header,
+			    "%s\n", _pl_g_pcl_font_info[i].ps_name);
 	  fonts_used = true;
 	}
     if (!fonts_used)
       {
-	sprintf (page_header->point, "\n");
-	_update_buffer (page_header);
+	_outbuf_puts (page_header, "\n");
       }
     
     /* tell AI or print spooler that we need procsets */
     if (_plotter->ai_version == AI_VERSION_5)
       {
-	sprintf (page_header->point, "\
+	_outbuf_printf (page_header, "\
 %%%%DocumentNeededResources: procset Adobe_level2_AI5 1.0 0\n\
 %%%%+ procset Adobe_typography_AI5 1.0 0\n\
 %%%%+ procset Adobe_Illustrator_AI6_vars Adobe_Illustrator_AI6\n\
 %%%%+ procset Adobe_Illustrator_AI5 1.0 0\n");
-	_update_buffer (page_header);
 
 	/* claim to be AI 7.0 (that's what `3' means) */
-	sprintf (page_header->point, "\
+	_outbuf_printf (page_header, "\
 %%AI5_FileFormat 3\n");
-	_update_buffer (page_header);
       }
     else			/* AI_VERSION_3 */
       {
-	sprintf (page_header->point, "\
+	_outbuf_printf (page_header, "\
 %%%%DocumentNeededResources: procset Adobe_packedarray 2.0 0\n\
 %%%%+ procset Adobe_cmykcolor 1.1 0\n\
 %%%%+ procset Adobe_cshow 1.1 0\n\
@@ -215,47 +199,40 @@ _pl_a_end_page (S___(Plotter *_plotter))
 %%%%+ procset Adobe_typography_AI3 1.0 1\n\
 %%%%+ procset Adobe_pattern_AI3 1.0 0\n\
 %%%%+ procset Adobe_Illustrator_AI3 1.0 1\n");
-	_update_buffer (page_header);
       }
     
     /* AI3 directives. */
     
     /* tell AI whether or not we're monochrome */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%AI3_ColorUsage: ");
-    _update_buffer (page_header);
     if (_plotter->ai_cyan_used || _plotter->ai_magenta_used || _plotter->ai_yellow_used)
-      sprintf (page_header->point, "Color\n");
+      _outbuf_puts (page_header, "Color\n");
     else
-      sprintf (page_header->point, "Black&White\n");
-    _update_buffer (page_header);
+      _outbuf_puts (page_header, "Black&White\n");
     
     /* no linked images are embedded in this file */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%AI7_ImageSettings: 0\n");
-    _update_buffer (page_header);
     
     /* place degenerate template box at center of viewport (used for
        centering, in case size of artboard changes between successive
        versions of AI) */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%AI3_TemplateBox: %d %d %d %d\n",
-	     ixmid, iymid, ixmid, iymid);
-    _update_buffer (page_header);
+		    ixmid, iymid, ixmid, iymid);
     
     /* nominal imageable area of the page (used only by Macintosh version
        of AI?): we specify our horizontal range, and the full page height */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%AI3_TileBox: %d %d %d %d\n",
-	     IROUND(_plotter->data->xmin),
-	     0,
-	     IROUND(_plotter->data->xmax),
-	     IROUND(72 * _plotter->data->page_data->ysize));
-    _update_buffer (page_header);
+		    IROUND(_plotter->data->xmin),
+		    0,
+		    IROUND(_plotter->data->xmax),
+		    IROUND(72 * _plotter->data->page_data->ysize));
     
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%AI3_DocumentPreview: None\n");
-    _update_buffer (page_header);
       
     /* AI5 directives. */
     
@@ -292,53 +269,49 @@ _pl_a_end_page (S___(Plotter *_plotter))
     
     if (_plotter->ai_version >= AI_VERSION_5)
       {
-	sprintf (page_header->point, "\
+	_outbuf_printf (page_header, "\
 %%AI5_ArtSize: %d %d\n\
 %%AI5_RulerUnits: %d\n\
 %%AI5_ArtFlags: 1 0 0 1 0 0 1 1 0\n\
 %%AI5_TargetResolution: 800\n\
 %%AI5_NumLayers: 1\n\
 %%AI5_OpenViewLayers: 7\n",
-		 /* For `ArtSize' (size of the artboard in points), we
-		    specify the entire physical page. */
-		 /* page width */
-		 IROUND(72 * _plotter->data->page_data->xsize),
-		 /* page height */
-		 IROUND(72 * _plotter->data->page_data->ysize),
-		 /* label AI's rulers with centimeters or inches
-		    (4 = cm, 0 = in) */
-		 _plotter->data->page_data->metric ? 4 : 0);
-	_update_buffer (page_header);
+			/* For `ArtSize' (size of the artboard in points), we
+			   specify the entire physical page. */
+			/* page width */
+			IROUND(72 * _plotter->data->page_data->xsize),
+			/* page height */
+			IROUND(72 * _plotter->data->page_data->ysize),
+			/* label AI's rulers with centimeters or inches
+			   (4 = cm, 0 = in) */
+			_plotter->data->page_data->metric ? 4 : 0);
       }
     
     /* following three may be used only by old Macintosh versions of AI? */
     
     /* so-called page origin, taken to be lower left corner of nominal
        imageable area (see above) */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%PageOrigin:%d %d\n",
-	     IROUND(_plotter->data->xmin), 0);
-    _update_buffer (page_header);
+		    IROUND(_plotter->data->xmin), 0);
     
     /* paper rectangle, relative to the lower left corner of the nominal
        imageable area (see above) */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%AI3_PaperRect:%d %d %d %d\n",
-	     -IROUND(_plotter->data->xmin),
-	     IROUND(72 * _plotter->data->page_data->ysize),
-	     IROUND(72 * _plotter->data->page_data->xsize - _plotter->data->xmin),
-	     0);
-    _update_buffer (page_header);
+		    -IROUND(_plotter->data->xmin),
+		    IROUND(72 * _plotter->data->page_data->ysize),
+		    IROUND(72 * _plotter->data->page_data->xsize - _plotter->data->xmin),
+		    0);
     
     /* margins on all sides of the paper, i.e. the offsets between page
        edges and the nominal imageable area (see above) */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%AI3_Margin:%d %d %d %d\n",
-	     IROUND(_plotter->data->xmin),
-	     0,
-	     IROUND(-(72 * _plotter->data->page_data->xsize - _plotter->data->xmax)),
-	     0);
-    _update_buffer (page_header);
+		    IROUND(_plotter->data->xmin),
+		    0,
+		    IROUND(-(72 * _plotter->data->page_data->xsize - _plotter->data->xmax)),
+		    0);
     
     /* gridlines; parameters are:
        num. horizontal points between gridlines /
@@ -352,22 +325,20 @@ _pl_a_end_page (S___(Plotter *_plotter))
     
     if (_plotter->data->page_data->metric)
       /* visible grid spacing = 1 cm, 3 subdivisions / division */
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%AI7_GridSettings: %.4f 3 %.4f 3 1 0 0.8 0.8 0.8 0.9 0.9 0.9\n",
-	       72.0/2.54, 72.0/2.54);
+		      72.0/2.54, 72.0/2.54);
     else
       /* visible grid spacing = 1 in, 8 subdivisions / division */
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%AI7_GridSettings: 72 8 72 8 1 0 0.8 0.8 0.8 0.9 0.9 0.9\n");
-    _update_buffer (page_header);
     
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%EndComments\n");
-    _update_buffer (page_header);
     
     /* Prolog section: include the procsets */
     if (_plotter->ai_version == AI_VERSION_5)
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%%%BeginProlog\n\
 %%%%IncludeResource: procset Adobe_level2_AI5 1.0 0\n\
 %%%%IncludeResource: procset Adobe_typography_AI5 1.0 0\n\
@@ -375,7 +346,7 @@ _pl_a_end_page (S___(Plotter *_plotter))
 %%%%IncludeResource: procset Adobe_Illustrator_AI5 1.0 0\n\
 %%%%EndProlog\n");
     else			/* AI_VERSION_3 */
-      sprintf (page_header->point, "\
+      _outbuf_printf (page_header, "\
 %%%%BeginProlog\n\
 %%%%IncludeResource: procset Adobe_packedarray 2.0 0\n\
 Adobe_packedarray /initialize get exec\n\
@@ -386,12 +357,10 @@ Adobe_packedarray /initialize get exec\n\
 %%%%IncludeResource: procset Adobe_pattern_AI3 1.0 0\n\
 %%%%IncludeResource: procset Adobe_Illustrator_AI3 1.0 1\n\
 %%%%EndProlog\n");
-    _update_buffer (page_header);
       
     /* beginning of Setup section */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%BeginSetup\n");
-    _update_buffer (page_header);
     
     /* include fonts if any */
     if (fonts_used)
@@ -399,45 +368,41 @@ Adobe_packedarray /initialize get exec\n\
 	for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	  if (_plotter->data->page->ps_font_used[i])
 	    {
-	      sprintf (page_header->point, "\
+	      _outbuf_printf (page_header, "\
 %%%%IncludeFont: %s\n", 
-		       _pl_g_ps_font_info[i].ps_name);
-	      _update_buffer (page_header);
+			      _pl_g_ps_font_info[i].ps_name);
 	    }
 	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
 	  if (_plotter->data->page->pcl_font_used[i])
 	    {
-	      sprintf (page_header->point, "\
+	      _outbuf_printf (page_header, "\
 %%%%IncludeFont: %s\n", 
-		       _pl_g_pcl_font_info[i].ps_name);
-	      _update_buffer (page_header);
+			      _pl_g_pcl_font_info[i].ps_name);
 	    }
       }
     
     /* do setup of procsets */
     if (_plotter->ai_version == AI_VERSION_5)
-      sprintf (page_header->point, "\
+      _outbuf_puts (page_header, "\
 Adobe_level2_AI5 /initialize get exec\n\
 Adobe_Illustrator_AI5_vars Adobe_Illustrator_AI5 Adobe_typography_AI5 /initialize get exec\n\
 Adobe_ColorImage_AI6 /initialize get exec\n\
 Adobe_Illustrator_AI5 /initialize get exec\n");
     else			/* AI_VERSION_3 */
-      sprintf (page_header->point, "\
+      _outbuf_puts (page_header, "\
 Adobe_cmykcolor /initialize get exec\n\
 Adobe_cshow /initialize get exec\n\
 Adobe_customcolor /initialize get exec\n\
 Adobe_typography_AI3 /initialize get exec\n\
 Adobe_pattern_AI3 /initialize get exec\n\
 Adobe_Illustrator_AI3 /initialize get exec\n");
-    _update_buffer (page_header);
 
     if (fonts_used)
       /* do whatever font reencodings are needed */
       {
 	/* don't modify StandardEncoding */
-	sprintf (page_header->point, "[\n\
+	_outbuf_puts (page_header, "[\n\
 TE\n");
-	_update_buffer (page_header);
 	
 	/* reencode each used font */
 	for (i = 0; i < PL_NUM_PS_FONTS; i++)
@@ -453,31 +418,28 @@ TE\n");
 		reencoding = _ai_symbol_reencoding;
 	      else		/* don't know what to do */
 		reencoding = "";
-	      sprintf (page_header->point, "\
+	      _outbuf_printf (page_header, "\
 %%AI3_BeginEncoding: _%s %s\n\
 [%s/_%s/%s 0 0 0 TZ\n\
 %%AI3_EndEncoding AdobeType\n",
-		       _pl_g_ps_font_info[i].ps_name, _pl_g_ps_font_info[i].ps_name,
-                       reencoding,
-		       _pl_g_ps_font_info[i].ps_name, _pl_g_ps_font_info[i].ps_name);
-	      _update_buffer (page_header);
+			      _pl_g_ps_font_info[i].ps_name, _pl_g_ps_font_info[i].ps_name,
+			      reencoding,
+			      _pl_g_ps_font_info[i].ps_name, _pl_g_ps_font_info[i].ps_name);
 	    }
 	for (i = 0; i < PL_NUM_PCL_FONTS; i++)
 	  if (_plotter->data->page->pcl_font_used[i])
 	    {
-	      sprintf (page_header->point, "\
+	      _outbuf_printf (page_header, "\
 %%AI3_BeginEncoding: _%s %s\n\
 [/_%s/%s 0 0 0 TZ\n\
 %%AI3_EndEncoding TrueType\n",
-		       _pl_g_pcl_font_info[i].ps_name, _pl_g_pcl_font_info[i].ps_name,
-		       _pl_g_pcl_font_info[i].ps_name, _pl_g_pcl_font_info[i].ps_name);
-	      _update_buffer (page_header);
+			      _pl_g_pcl_font_info[i].ps_name, _pl_g_pcl_font_info[i].ps_name,
+			      _pl_g_pcl_font_info[i].ps_name, _pl_g_pcl_font_info[i].ps_name);
 	    }
       }
     /* end of Setup section */
-    sprintf (page_header->point, "\
+    _outbuf_printf (page_header, "\
 %%%%EndSetup\n");
-    _update_buffer (page_header);
     
     if (_plotter->ai_version >= AI_VERSION_5)
       /* objects will belong to layer #1 (if layers are supported) */
@@ -488,11 +450,10 @@ TE\n");
 	   ID for the layer (0 = light blue), and the final three
 	   attributes are intensities of R,G,B, on a 0..255 scale
 	   (79,128,255 apparently being what AI normally uses) */
-        sprintf (page_header->point, "\
+        _outbuf_printf (page_header, "\
 %%AI5_BeginLayer\n\
 1 1 1 1 0 0 0 79 128 255 Lb\n\
 (Layer 1) Ln\n");
-	_update_buffer (page_header);
       }
 
     /* place header in the plOutbuf of page */
@@ -509,20 +470,18 @@ TE\n");
     if (_plotter->ai_version >= AI_VERSION_5)
       /* after outputing objects, must end layer */
       {
-	sprintf (page_trailer->point, "\
+	_outbuf_printf (page_trailer, "\
 LB\n\
 %%AI5_EndLayer--\n");
-	_update_buffer (page_trailer);
       }
     
-    sprintf (page_trailer->point, "\
+    _outbuf_printf (page_trailer, "\
 %%%%PageTrailer\n\
 gsave annotatepage grestore showpage\n");
-    _update_buffer (page_trailer);
     
     /* trailer: terminate procsets */
     if (_plotter->ai_version == AI_VERSION_5)
-      sprintf (page_trailer->point, "\
+      _outbuf_printf (page_trailer, "\
 %%%%Trailer\n\
 Adobe_Illustrator_AI5 /terminate get exec\n\
 Adobe_ColorImage_AI6 /terminate get exec\n\
@@ -530,7 +489,7 @@ Adobe_typography_AI5 /terminate get exec\n\
 Adobe_level2_AI5 /terminate get exec\n\
 %%%%EOF\n");
     else			/* AI_VERSION_3 */
-      sprintf (page_trailer->point, "\
+      _outbuf_printf (page_trailer, "\
 %%%%Trailer\n\
 Adobe_Illustrator_AI3 /terminate get exec\n\
 Adobe_pattern_AI3 /terminate get exec\n\
@@ -540,7 +499,6 @@ Adobe_cshow /terminate get exec\n\
 Adobe_cmykcolor /terminate get exec\n\
 Adobe_packedarray /terminate get exec\n\
 %%%%EOF\n");
-    _update_buffer (page_trailer);
 
     /* place header in the plOutbuf of the page */
     _plotter->data->page->trailer = page_trailer;    
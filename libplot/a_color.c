@@ -48,9 +48,8 @@ _pl_a_set_pen_color(S___(Plotter *_plotter))
       || (_plotter->ai_pen_black != black))
     /* need to change pen CMYK */
     {
-      sprintf (_plotter->data->page->point, "%.4f %.4f %.4f %.4f K\n",
-	       cyan, magenta, yellow, black);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%.4f %.4f %.4f %.4f K\n",
+		      cyan, magenta, yellow, black);
       _plotter->ai_pen_cyan = cyan;
       _plotter->ai_pen_magenta = magenta;  
       _plotter->ai_pen_yellow = yellow;
@@ -109,9 +108,8 @@ _pl_a_set_fill_color(R___(Plotter *_plotter) bool force_pen_color)
       || (_plotter->ai_fill_black != black))
     /* need to change AI fill CMYK */
     {
-      sprintf (_plotter->data->page->point, "%.4f %.4f %.4f %.4f k\n",
-	       cyan, magenta, yellow, black);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%.4f %.4f %.4f %.4f k\n",
+		      cyan, magenta, yellow, black);
       _plotter->ai_fill_cyan = cyan;
       _plotter->ai_fill_magenta = magenta;  
       _plotter->ai_fill_yellow = yellow;
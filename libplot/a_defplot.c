@@ -161,14 +161,14 @@ _pl_a_initialize (S___(Plotter *_plotter))
   {
     const char *version_s;
     
-    version_s = (const char *)_get_plot_param (_plotter->data, "AI_VERSION");
+    version_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_AI_VERSION);
     if (strcmp (version_s, "3") == 0)
       _plotter->ai_version = AI_VERSION_3;
     else if (strcmp (version_s, "5") == 0)
       _plotter->ai_version = AI_VERSION_5;
     else      
       {
-	version_s = (const char *)_get_default_plot_param ("AI_VERSION");
+	version_s = (const char *)_get_default_plot_param (PL_PARAM_AI_VERSION);
 	if (strcmp (version_s, "3") == 0)
 	  _plotter->ai_version = AI_VERSION_3;
 	else if (strcmp (version_s, "5") == 0)
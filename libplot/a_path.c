@@ -56,8 +56,8 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -100,33 +100,33 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 		
 		/* compute path end point, and a nearby point, the vector
 		   to which will determine the shape of the path end */
-		xcurrent = _plotter->drawstate->path->segments[i].p.x;
-		ycurrent = _plotter->drawstate->path->segments[i].p.y;	  
+		xcurrent = _plotter->drawstate->path->points[i].x;
+		ycurrent = _plotter->drawstate->path->points[i].y;	  
 		
 		if (i == 0)	/* i = 0, initial end point */
 		  {
-		    if (_plotter->drawstate->path->segments[i+1].type == S_CUBIC)
+		    if (_path_segment_type (_plotter->drawstate->path, i+1) == S_CUBIC)
 		      {
-			xother = _plotter->drawstate->path->segments[i+1].pc.x;
-			yother = _plotter->drawstate->path->segments[i+1].pc.y;
+			xother = _path_curve (_plotter->drawstate->path, i+1)->pc.x;
+			yother = _path_curve (_plotter->drawstate->path, i+1)->pc.y;
 		      }
 		    else	/* line segment */
 		      {
-			xother = _plotter->drawstate->path->segments[i+1].p.x;
-			yother = _plotter->drawstate->path->segments[i+1].p.y;
+			xother = _plotter->drawstate->path->points[i+1].x;
+			yother = _plotter->drawstate->path->points[i+1].y;
 		      }
 		  }
 		else		/* i = numpoints - 1, final end point */
 		  {
-		    if (_plotter->drawstate->path->segments[i].type == S_CUBIC)
+		    if (_path_segment_type (_plotter->drawstate->path, i) == S_CUBIC)
 		      {
-			xother = _plotter->drawstate->path->segments[i].pd.x;
-			yother = _plotter->drawstate->path->segments[i].pd.y;
+			xother = _path_curve (_plotter->drawstate->path, i)->pd.x;
+			yother = _path_curve (_plotter->drawstate->path, i)->pd.y;
 		      }
 		    else	/* line segment */
 		      {
-			xother = _plotter->drawstate->path->segments[i-1].p.x;
-			yother = _plotter->drawstate->path->segments[i-1].p.y;
+			xother = _plotter->drawstate->path->points[i-1].x;
+			yother = _plotter->drawstate->path->points[i-1].y;
 		      }
 		  }
 		/* take path end into account: update bounding box */
@@ -154,33 +154,33 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 		    c = i + 1;
 		  }
 		
-		xcurrent = _plotter->drawstate->path->segments[b].p.x;
-		ycurrent = _plotter->drawstate->path->segments[b].p.y;
+		xcurrent = _plotter->drawstate->path->points[b].x;
+		ycurrent = _plotter->drawstate->path->points[b].y;
 		
 		/* compute points to left and right, vectors to which will
 		   determine the shape of the path join */
-		switch ((int)_plotter->drawstate->path->segments[b].type)
+		switch ((int)_path_segment_type (_plotter->drawstate->path, b))
 		  {
 		  case (int)S_LINE:
 		  default:
-		    xleft = _plotter->drawstate->path->segments[a].p.x;
-		    yleft = _plotter->drawstate->path->segments[a].p.y;
+		    xleft = _plotter->drawstate->path->points[a].x;
+		    yleft = _plotter->drawstate->path->points[a].y;
 		    break;
 		  case (int)S_CUBIC:
-		    xleft = _plotter->drawstate->path->segments[b].pd.x;
-		    yleft = _plotter->drawstate->path->segments[b].pd.y;
+		    xleft = _path_curve (_plotter->drawstate->path, b)->pd.x;
+		    yleft = _path_curve (_plotter->drawstate->path, b)->pd.y;
 		    break;
 		  }
-		switch ((int)_plotter->drawstate->path->segments[c].type)
+		switch ((int)_path_segment_type (_plotter->drawstate->path, c))
 		  {
 		  case (int)S_LINE:
 		  default:
-		    xright = _plotter->drawstate->path->segments[c].p.x;
-		    yright = _plotter->drawstate->path->segments[c].p.y;
+		    xright = _plotter->drawstate->path->points[c].x;
+		    yright = _plotter->drawstate->path->points[c].y;
 		    break;
 		  case (int)S_CUBIC:
-		    xright = _plotter->drawstate->path->segments[c].pc.x;
-		    yright = _plotter->drawstate->path->segments[c].pc.y;
+		    xright = _path_curve (_plotter->drawstate->path, c)->pc.x;
+		    yright = _path_curve (_plotter->drawstate->path, c)->pc.y;
 		    break;
 		  }
 		
@@ -217,63 +217,59 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 	    /* output to Illustrator the points that define this segment */
 	    
 	    if (i != 0 
-		&& (_plotter->drawstate->path->segments)[i].type == S_CUBIC)
+		&& _path_segment_type (_plotter->drawstate->path, i) == S_CUBIC)
 	      /* cubic Bezier segment, so output control points */
 	      {
-		sprintf (_plotter->data->page->point, 
-			 "%.4f %.4f %.4f %.4f ", 
-			 XD(_plotter->drawstate->path->segments[i].pc.x,
-			    _plotter->drawstate->path->segments[i].pc.y),
-			 YD(_plotter->drawstate->path->segments[i].pc.x,
-			    _plotter->drawstate->path->segments[i].pc.y),
-			 XD(_plotter->drawstate->path->segments[i].pd.x,
-		      _plotter->drawstate->path->segments[i].pd.y),
-			 YD(_plotter->drawstate->path->segments[i].pd.x,
-			    _plotter->drawstate->path->segments[i].pd.y));
-		_update_buffer (_plotter->data->page);
+		const plPathCurve *curve;
+
+		curve = _path_curve (_plotter->drawstate->path, i);
+		_outbuf_printf (_plotter->data->page,
+				"%.4f %.4f %.4f %.4f ",
+				XD(curve->pc.x, curve->pc.y),
+				YD(curve->pc.x, curve->pc.y),
+				XD(curve->pd.x, curve->pd.y),
+				YD(curve->pd.x, curve->pd.y));
 		/* update bounding box due to extremal x/y values in device
                    frame */
 		_set_bezier3_bbox (_plotter->data->page, 
-				   _plotter->drawstate->path->segments[i-1].p.x,
-				   _plotter->drawstate->path->segments[i-1].p.y,
-				   _plotter->drawstate->path->segments[i].pc.x,
-				   _plotter->drawstate->path->segments[i].pc.y,
-				   _plotter->drawstate->path->segments[i].pd.x,
-				   _plotter->drawstate->path->segments[i].pd.y,
-				   _plotter->drawstate->path->segments[i].p.x,
-				   _plotter->drawstate->path->segments[i].p.y,
+				   _plotter->drawstate->path->points[i-1].x,
+				   _plotter->drawstate->path->points[i-1].y,
+				   curve->pc.x, curve->pc.y,
+				   curve->pd.x, curve->pd.y,
+				   _plotter->drawstate->path->points[i].x,
+				   _plotter->drawstate->path->points[i].y,
 				   _plotter->drawstate->device_line_width,
 				   _plotter->drawstate->transform.m);
 	      }
 	    
 	    /* output terminal point of segment */
-	    sprintf (_plotter->data->page->point, 
-		     "%.4f %.4f ", 
-		     XD(_plotter->drawstate->path->segments[i].p.x,
-			_plotter->drawstate->path->segments[i].p.y),
-		     YD(_plotter->drawstate->path->segments[i].p.x,
-			_plotter->drawstate->path->segments[i].p.y));
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_put_fixed (_plotter->data->page,
+			       XD(_plotter->drawstate->path->points[i].x,
+				  _plotter->drawstate->path->points[i].y), 4);
+	    _outbuf_putc (_plotter->data->page, ' ');
+	    _outbuf_put_fixed (_plotter->data->page,
+			       YD(_plotter->drawstate->path->points[i].x,
+				  _plotter->drawstate->path->points[i].y), 4);
+	    _outbuf_putc (_plotter->data->page, ' ');
 	    
 	    /* tell Illustrator what sort of path segment this is */
 	    if (i == 0)
 	      /* start of path, so just move to point */
-	      sprintf (_plotter->data->page->point, "m\n");
+	      _outbuf_puts (_plotter->data->page, "m\n");
 	    else
 	      /* append line segment or Bezier segment to path */
-	      switch ((int)_plotter->drawstate->path->segments[i].type)
+	      switch ((int)_path_segment_type (_plotter->drawstate->path, i))
 		{
 		case (int)S_LINE:
 		default:
-		  sprintf (_plotter->data->page->point, 
-			   smooth_join_point ? "l\n" : "L\n");
+		  _outbuf_printf (_plotter->data->page,
+				  smooth_join_point ? "l\n" : "L\n");
 		  break;
 		case (int)S_CUBIC:
-		  sprintf (_plotter->data->page->point, 
-			   smooth_join_point ? "c\n" : "C\n");
+		  _outbuf_printf (_plotter->data->page,
+				  smooth_join_point ? "c\n" : "C\n");
 		  break;	    
 		}
-	    _update_buffer (_plotter->data->page);
 	    
 	  } /* end of loop over segments */
 	
@@ -285,19 +281,19 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 	      {
 		if (closed)
 		  /* close path, fill and stroke */
-		  sprintf (_plotter->data->page->point, "b\n");
+		  _outbuf_puts (_plotter->data->page, "b\n");
 		else
 		  /* fill and stroke */
-		  sprintf (_plotter->data->page->point, "B\n");
+		  _outbuf_puts (_plotter->data->page, "B\n");
 	      }
 	    else
 	      {
 		if (closed)
 		  /* close path, stroke */
-		  sprintf (_plotter->data->page->point, "s\n");
+		  _outbuf_puts (_plotter->data->page, "s\n");
 		else
 		  /* stroke */
-		  sprintf (_plotter->data->page->point, "S\n");
+		  _outbuf_puts (_plotter->data->page, "S\n");
 	      }
 	  }
 	else
@@ -308,13 +304,12 @@ _pl_a_paint_path (S___(Plotter *_plotter))
 	      {
 		if (closed)
 		  /* close path, fill */
-		  sprintf (_plotter->data->page->point, "f\n");
+		  _outbuf_puts (_plotter->data->page, "f\n");
 		else
 		  /* fill */
-		  sprintf (_plotter->data->page->point, "F\n");
+		  _outbuf_puts (_plotter->data->page, "F\n");
 	      }
 	  }
-	_update_buffer (_plotter->data->page);
       }
       break;
       
@@ -137,22 +137,18 @@ _pl_a_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     text_transformation_matrix[i] /= norm;
 
   /* AI directive: begin `point text' object */
-  strcpy (_plotter->data->page->point, "0 To\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 To\n");
 
   /* output text transformation matrix */
   for (i = 0; i < 6; i++)
     {
-      sprintf (_plotter->data->page->point, "%.4f ", 
-	       text_transformation_matrix[i]);
-      _update_buffer (_plotter->data->page);      
+      _outbuf_printf (_plotter->data->page, "%.4f ",
+		      text_transformation_matrix[i]);
     }
-  strcpy (_plotter->data->page->point, "0 Tp\nTP\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 Tp\nTP\n");
   
   /* set render mode: fill text, rather than several other possibilities */
-  strcpy (_plotter->data->page->point, "0 Tr\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 Tr\n");
 
   /* set AI's fill color to be the same as libplot's notion of pen color
      (since letters in label will be drawn as filled outlines) */
@@ -174,34 +170,27 @@ _pl_a_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
       ps_name = _pl_g_ps_font_info[master_font_index].ps_name;
     
     /* specify font name (underscore indicates reencoding), font size */
-    sprintf (_plotter->data->page->point, "/_%s %.4f Tf\n", 
-	     ps_name, device_font_size);
-    _update_buffer (_plotter->data->page);
+    _outbuf_printf (_plotter->data->page, "/_%s %.4f Tf\n",
+		    ps_name, device_font_size);
   }
   
   /* set line horizontal expansion factor, in percent */
-  strcpy (_plotter->data->page->point, "100 Tz\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "100 Tz\n");
 
   /* NO track kerning, please */
-  strcpy (_plotter->data->page->point, "0 Tt\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 Tt\n");
 
   /* turn off pairwise kerning (currently, a libplot convention) */
-  strcpy (_plotter->data->page->point, "0 TA\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 TA\n");
 
   /* turn off ALL inter-character spacing */
-  strcpy (_plotter->data->page->point, "0 0 0 TC\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 0 0 TC\n");
 
   /* use the default inter-word spacing; no more, no less */
-  strcpy (_plotter->data->page->point, "100 100 100 TW\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "100 100 100 TW\n");
 
   /* no indentation at beginning of `paragraphs' */
-  strcpy (_plotter->data->page->point, "0 0 0 Ti\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 0 0 Ti\n");
 
   /* specify justification */
   switch (h_just)
@@ -217,16 +206,13 @@ _pl_a_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
       justify_code = 2;
       break;
     }
-  sprintf (_plotter->data->page->point, "%d Ta\n", justify_code);
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "%d Ta\n", justify_code);
 
   /* no hanging quotation marks */
-  strcpy (_plotter->data->page->point, "0 Tq\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 Tq\n");
 
   /* no leading between lines of a paragraph or between paragraphs */
-  strcpy (_plotter->data->page->point, "0 0 Tl\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "0 0 Tl\n");
 
   /* compute width of the substring in user units (used below in
      constructing a bounding box) */
@@ -304,12 +290,10 @@ _pl_a_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
   _update_buffer (_plotter->data->page);
 
   /* AI directive: this is the text to be rendered */
-  strcpy (_plotter->data->page->point, " Tx\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, " Tx\n");
 
   /* AI directive: end of text object */
-  strcpy (_plotter->data->page->point, "TO\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "TO\n");
 
   /* flag current PS or PCL font as used */
   if (pcl_font)
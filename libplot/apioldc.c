@@ -753,6 +753,22 @@ pl_fpointrel (double x, double y)
   return _API_fpointrel (_old_api_plotter, x, y);
 }
 
+int
+pl_fpoints (int n, const double *x, const double *y)
+{
+  if (_old_api_plotters_len == 0)
+    _create_and_select_default_plotter ();
+  return _API_fpoints (_old_api_plotter, n, x, y);
+}
+
+int
+pl_fpolyline (int n, const double *x, const double *y)
+{
+  if (_old_api_plotters_len == 0)
+    _create_and_select_default_plotter ();
+  return _API_fpolyline (_old_api_plotter, n, x, y);
+}
+
 int
 pl_frotate (double theta)
 {
@@ -24,6 +24,16 @@ bool
 _pl_b_end_page (S___(Plotter *_plotter))
 {
   int retval;
+  miPoint origin;
+
+  /* if drawing operations have been recorded rather than carried out (see
+     _pl_b_new_image()), carry them out now, in parallel */
+  origin.x = 0;
+  origin.y = 0;
+  miRenderDeferredPaintedSet ((miPaintedSet *)_plotter->b_painted_set,
+			      (miCanvas *)_plotter->b_canvas, origin,
+			      _plotter->b_threads,
+			      (miEllipseCache *)_plotter->b_arc_cache_data);
 
   /* Possibly output the page's bitmap.  In the base BitmapPlotter class
      this is a no-op (see below), but it may do something in derived
@@ -40,11 +50,17 @@ _pl_b_end_page (S___(Plotter *_plotter))
 void
 _pl_b_delete_image (S___(Plotter *_plotter))
 {
+  /* if requested, report on storage used by libxmi in rasterizing */
+  _pl_g_report_mi_stats (R___(_plotter)
+			 _plotter->b_painted_set, _plotter->b_arc_cache_data);
+
   /* deallocate libxmi's drawing canvas (and painted set struct too) */
   miDeleteCanvas ((miCanvas *)_plotter->b_canvas);
   _plotter->b_canvas = (void *)NULL;
   miDeletePaintedSet ((miPaintedSet *)_plotter->b_painted_set);
   _plotter->b_painted_set = (void *)NULL;
+  miDeleteCoverageSet ((miCoverageSet *)_plotter->b_coverage_set);
+  _plotter->b_coverage_set = (void *)NULL;
 }
 
 /* This is the BitmapPlotter-specific version of the _maybe_output_image()
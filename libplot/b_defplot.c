@@ -133,12 +133,13 @@ _pl_b_initialize (S___(Plotter *_plotter))
   /* initialize data members specific to this derived class */
   _plotter->b_xn = _plotter->data->imax + 1;
   _plotter->b_yn = _plotter->data->jmin + 1;
+  _plotter->b_antialias = false;
+  _plotter->b_threads = 1;
   _plotter->b_painted_set = (void *)NULL;
   _plotter->b_canvas = (void *)NULL;
-
-  /* initialize storage used by libxmi's reentrant miDrawArcs_r() function
-     for cacheing rasterized ellipses */
-  _plotter->b_arc_cache_data = (void *)miNewEllipseCache ();
+  _plotter->b_coverage_set = (void *)NULL;
+  _plotter->b_color_class = 0;
+  _plotter->b_num_painted_colors = 0;
 
   /* determine the range of device coordinates over which the graphics
      display will extend (and hence the transformation from user to device
@@ -147,7 +148,7 @@ _pl_b_initialize (S___(Plotter *_plotter))
     const char *bitmap_size_s;
     int width = 1, height = 1;
 	
-    bitmap_size_s = (const char *)_get_plot_param (_plotter->data, "BITMAPSIZE");
+    bitmap_size_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_BITMAPSIZE);
     if (bitmap_size_s && parse_bitmap_size (bitmap_size_s, &width, &height)
 	/* insist on >=1 */
 	&& width >= 1 && height >= 1)
@@ -165,7 +166,37 @@ _pl_b_initialize (S___(Plotter *_plotter))
 
   /* initialize certain data members from device driver parameters */
       
-  /* for this class, there are none */
+  /* draw with anti-aliasing? */
+  {
+    const char *antialias_s;
+
+    antialias_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_ANTIALIAS);
+    if (strcasecmp (antialias_s, "yes") == 0)
+      _plotter->b_antialias = true;
+  }
+
+  /* determine number of threads used in rasterizing each page */
+  {
+    const char *threads_s;
+    int threads;
+
+    threads_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_BITMAP_THREADS);
+    if (sscanf (threads_s, "%d", &threads) > 0 && threads >= 1)
+      _plotter->b_threads = threads;
+  }
+
+  /* initialize storage used by libxmi's reentrant miDrawArcs_r() function
+     for cacheing rasterized ellipses, of user-specified size */
+  {
+    const char *cache_size_s;
+    int cache_size;
+
+    cache_size_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_ELLIPSE_CACHE_SIZE);
+    if (sscanf (cache_size_s, "%d", &cache_size) > 0 && cache_size >= 0)
+      _plotter->b_arc_cache_data = (void *)miNewEllipseCacheOfSize (cache_size);
+    else
+      _plotter->b_arc_cache_data = (void *)miNewEllipseCache ();
+  }
 }
 
 static bool 
@@ -36,6 +36,7 @@ _pl_b_new_image (S___(Plotter *_plotter))
 {
   unsigned char red, green, blue;
   miPixel pixel;
+  miPoint origin;
 
   /* compute 24-bit bg color, and construct a miPixel for it */
   red = ((unsigned int)(_plotter->drawstate->bgcolor.red) >> 8) & 0xff;
@@ -46,7 +47,64 @@ _pl_b_new_image (S___(Plotter *_plotter))
   pixel.u.rgb[1] = green;
   pixel.u.rgb[2] = blue;
 
-  /* create libxmi miPaintedSet and miCanvas structs */
-  _plotter->b_painted_set = (void *)miNewPaintedSet ();
-  _plotter->b_canvas = (void *)miNewCanvas ((unsigned int)_plotter->b_xn, (unsigned int)_plotter->b_yn, pixel);
+  /* page is as yet painted only in the bg color */
+  _plotter->b_color_class = 0;
+  _plotter->b_num_painted_colors = 0;
+  _pl_b_note_color (R___(_plotter) red, green, blue);
+
+  /* create libxmi miCanvas and miPaintedSet structs (the canvas has a
+     packed drawable, which can be painted quickly; since our pixels are
+     opaque, the painted set is an immediate-mode one, which paints spans
+     straight onto the canvas rather than storing and sorting them) */
+  _plotter->b_canvas = (void *)miNewPackedCanvas ((unsigned int)_plotter->b_xn, (unsigned int)_plotter->b_yn, MI_PACKED_RGBA32, pixel);
+  origin.x = 0;
+  origin.y = 0;
+  if (_plotter->b_threads > 1 && !_plotter->b_antialias)
+    /* drawing operations are instead recorded, and carried out at the end
+       of the page by several threads, each working on a tile of the
+       canvas (see _pl_b_end_page()) */
+    _plotter->b_painted_set = (void *)miNewDeferredPaintedSet ();
+  else
+    _plotter->b_painted_set = (void *)miNewImmediatePaintedSet ((miCanvas *)_plotter->b_canvas, origin);
+
+  /* if drawing with anti-aliasing, create a libxmi miCoverageSet too */
+  if (_plotter->b_antialias)
+    _plotter->b_coverage_set = (void *)miNewCoverageSet ((unsigned int)_plotter->b_xn, (unsigned int)_plotter->b_yn);
+}
+
+/* Internal function: record that pixels of the specified 24-bit color are
+   about to be painted on the canvas.  We keep track of whether the page is
+   monochrome (black and white), grayscale, or color, and of the colors
+   used, if there are no more than 256 of them, so that a PNGPlotter can
+   choose the most compact image type without first scanning the image
+   (see z_write.c).  If anti-aliasing, each new color is blended with
+   those already on the canvas, so black and white make gray; and the
+   canvas colors are not just the ones listed. */
+void
+_pl_b_note_color (R___(Plotter *_plotter) int red, int green, int blue)
+{
+  int rgb, i;
+
+  if (red != green || red != blue)
+    _plotter->b_color_class = 2;
+  else if (red != 0 && red != 0xff && _plotter->b_color_class == 0)
+    _plotter->b_color_class = 1;
+
+  if (_plotter->b_num_painted_colors < 0)
+    return;
+
+  /* search list of colors painted so far, most recently added first */
+  rgb = (red << 16) | (green << 8) | blue;
+  for (i = _plotter->b_num_painted_colors - 1; i >= 0; i--)
+    if (_plotter->b_painted_colors[i] == rgb)
+      return;
+
+  if (_plotter->b_antialias && _plotter->b_num_painted_colors > 0
+      && _plotter->b_color_class == 0)
+    _plotter->b_color_class = 1;
+  if (_plotter->b_num_painted_colors == 256)
+    /* too many to write as a palette image */
+    _plotter->b_num_painted_colors = -1;
+  else
+    _plotter->b_painted_colors[_plotter->b_num_painted_colors++] = rgb;
 }
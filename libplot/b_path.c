@@ -42,6 +42,13 @@ _pl_b_paint_path (S___(Plotter *_plotter))
     /* nothing to draw */
     return;
 
+  if (_plotter->b_antialias)
+    /* draw with anti-aliasing instead */
+    {
+      _pl_b_draw_antialiased_path (S___(_plotter));
+      return;
+    }
+
   switch ((int)_plotter->drawstate->path->type)
     {
     case (int)PATH_SEGMENT_LIST:
@@ -63,12 +70,12 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_b_draw_elliptic_arc (R___(_plotter) p0, p1, pc);
@@ -77,12 +84,12 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_b_draw_elliptic_arc_2 (R___(_plotter) p0, p1, pc);
@@ -106,8 +113,8 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    double xu, yu;
 	    int device_x, device_y;
 	    
-	    xu = _plotter->drawstate->path->segments[i].p.x;
-	    yu = _plotter->drawstate->path->segments[i].p.y;
+	    xu = _plotter->drawstate->path->points[i].x;
+	    yu = _plotter->drawstate->path->points[i].y;
 	    if (i > 0 && (xu != xu_last || yu != yu_last))
 	      /* in user space, not all points are the same */
 	      identical_user_coordinates = false;	
@@ -155,6 +162,7 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    fgPixel.u.rgb[0] = red;
 	    fgPixel.u.rgb[1] = green;
 	    fgPixel.u.rgb[2] = blue;
+	    _pl_b_note_color (R___(_plotter) red, green, blue);
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
@@ -186,6 +194,7 @@ _pl_b_paint_path (S___(Plotter *_plotter))
 	    fgPixel.u.rgb[0] = red;
 	    fgPixel.u.rgb[1] = green;
 	    fgPixel.u.rgb[2] = blue;
+	    _pl_b_note_color (R___(_plotter) red, green, blue);
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
@@ -318,6 +327,71 @@ _pl_b_paint_path (S___(Plotter *_plotter))
     }
 }
 
+/* Draw the path in the Plotter's drawing state with anti-aliasing.  Filling
+   and edging each add spans to the Plotter's libxmi miCoverageSet, which is
+   then blended onto the canvas in a single pass. */
+
+void
+_pl_b_draw_antialiased_path (S___(Plotter *_plotter))
+{
+  miGC *pGC;
+  miPixel fgPixel, bgPixel;
+  miPixel pixels[2];
+
+  /* determine background pixel color */
+  bgPixel.type = MI_PIXEL_RGB_TYPE;
+  bgPixel.u.rgb[0] = _plotter->drawstate->bgcolor.red & 0xff;
+  bgPixel.u.rgb[1] = _plotter->drawstate->bgcolor.green & 0xff;
+  bgPixel.u.rgb[2] = _plotter->drawstate->bgcolor.blue & 0xff;
+  pixels[0] = bgPixel;
+  pixels[1] = bgPixel;
+
+  /* construct an miGC (graphics context for the libxmi module); copy
+     attributes from the Plotter's GC to it */
+  pGC = miNewGC (2, pixels);
+  _set_common_mi_attributes (_plotter->drawstate, (void *)pGC);
+
+  if (_plotter->drawstate->fill_type)
+    /* not transparent, will fill */
+    {
+      /* set fg color in GC to a 24-bit version of our fill color */
+      fgPixel.type = MI_PIXEL_RGB_TYPE;
+      fgPixel.u.rgb[0] = ((unsigned int)(_plotter->drawstate->fillcolor.red) >> 8) & 0xff;
+      fgPixel.u.rgb[1] = ((unsigned int)(_plotter->drawstate->fillcolor.green) >> 8) & 0xff;
+      fgPixel.u.rgb[2] = ((unsigned int)(_plotter->drawstate->fillcolor.blue) >> 8) & 0xff;
+      _pl_b_note_color (R___(_plotter) fgPixel.u.rgb[0], fgPixel.u.rgb[1],
+			fgPixel.u.rgb[2]);
+      pixels[1] = fgPixel;
+      miSetGCPixels (pGC, 2, pixels);
+      _draw_mi_aa_path (_plotter->drawstate, _plotter->b_coverage_set,
+			(const void *)pGC, true);
+    }
+
+  if (_plotter->drawstate->pen_type)
+    /* pen is present, so edge the path */
+    {
+      /* set fg color in GC to a 24-bit version of our pen color */
+      fgPixel.type = MI_PIXEL_RGB_TYPE;
+      fgPixel.u.rgb[0] = ((unsigned int)(_plotter->drawstate->fgcolor.red) >> 8) & 0xff;
+      fgPixel.u.rgb[1] = ((unsigned int)(_plotter->drawstate->fgcolor.green) >> 8) & 0xff;
+      fgPixel.u.rgb[2] = ((unsigned int)(_plotter->drawstate->fgcolor.blue) >> 8) & 0xff;
+      _pl_b_note_color (R___(_plotter) fgPixel.u.rgb[0], fgPixel.u.rgb[1],
+			fgPixel.u.rgb[2]);
+      pixels[1] = fgPixel;
+      miSetGCPixels (pGC, 2, pixels);
+      _draw_mi_aa_path (_plotter->drawstate, _plotter->b_coverage_set,
+			(const void *)pGC, false);
+    }
+
+  /* deallocate miGC */
+  miDeleteGC (pGC);
+
+  /* blend spans onto canvas, and clear */
+  miBlendCoverageSetToCanvas ((miCoverageSet *)_plotter->b_coverage_set,
+			      (miCanvas *)_plotter->b_canvas);
+  miClearCoverageSet ((miCoverageSet *)_plotter->b_coverage_set);
+}
+
 /* Use libxmi rendering to draw what would be a circular arc in the user
    frame.  If this is called, the map from user to device coordinates is
    assumed to preserve coordinate axes (it may be anisotropic [x and y
@@ -542,6 +616,7 @@ _pl_b_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
       fgPixel.u.rgb[0] = red;
       fgPixel.u.rgb[1] = green;
       fgPixel.u.rgb[2] = blue;
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
@@ -577,6 +652,7 @@ _pl_b_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
       fgPixel.u.rgb[0] = red;
       fgPixel.u.rgb[1] = green;
       fgPixel.u.rgb[2] = blue;
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
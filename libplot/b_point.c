@@ -60,6 +60,7 @@ _pl_b_paint_point (S___(Plotter *_plotter))
       fgPixel.u.rgb[0] = red;
       fgPixel.u.rgb[1] = green;
       fgPixel.u.rgb[2] = blue;
+      _pl_b_note_color (R___(_plotter) red, green, blue);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       
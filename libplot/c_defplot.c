@@ -288,7 +288,7 @@ _pl_c_initialize (S___(Plotter *_plotter))
     const char* cgm_encoding_type;
     
     cgm_encoding_type = 
-      (const char *)_get_plot_param (_plotter->data, "CGM_ENCODING");
+      (const char *)_get_plot_param (_plotter->data, PL_PARAM_CGM_ENCODING);
     if (cgm_encoding_type != NULL)
       {
 	if (strcmp (cgm_encoding_type, "binary") == 0)
@@ -309,7 +309,7 @@ _pl_c_initialize (S___(Plotter *_plotter))
     const char* cgm_max_version_type;
     
     cgm_max_version_type = 
-      (const char *)_get_plot_param (_plotter->data, "CGM_MAX_VERSION");
+      (const char *)_get_plot_param (_plotter->data, PL_PARAM_CGM_MAX_VERSION);
     if (cgm_max_version_type != NULL)
       {
 	if (strcmp (cgm_max_version_type, "1") == 0)
@@ -1189,9 +1189,7 @@ _pl_c_terminate (S___(Plotter *_plotter))
       }
       
       /* WRITE DOCUMENT HEADER */
-      _write_bytes (_plotter->data, 
-			     (int)(doc_header->contents),
-			     (unsigned char *)doc_header->base);
+      _write_outbuf (_plotter->data, doc_header);
       _delete_outbuf (doc_header);
 
       /* loop over plOutbufs in which successive pages of graphics are
@@ -1560,17 +1558,6 @@ _pl_c_terminate (S___(Plotter *_plotter))
 					    &byte_count);
 	    }
       
-	  /* write the page header */
-	  _write_bytes (_plotter->data, 
-				 (int)(current_page_header->contents),
-				 (unsigned char *)current_page_header->base);
-	  _delete_outbuf (current_page_header);
-
-	  /* WRITE THE PICTURE */
-	  _write_bytes (_plotter->data, 
-				 (int)(current_page->contents),
-				 (unsigned char *)current_page->base);
-
 	  /* prepare a page trailer */
 
 	  current_page_trailer = _new_outbuf ();
@@ -1587,10 +1574,10 @@ _pl_c_terminate (S___(Plotter *_plotter))
 					  &byte_count);
 	  }
 
-	  /* write page trailer */
-	  _write_bytes (_plotter->data, 
-				 (int)(current_page_trailer->contents),
-				 (unsigned char *)current_page_trailer->base);
+	  /* WRITE THE PICTURE, including page header and trailer */
+	  _write_outbufs (_plotter->data, current_page_header,
+			  current_page, current_page_trailer);
+	  _delete_outbuf (current_page_header);
 	  _delete_outbuf (current_page_trailer);
 	  
 	  /* on to next page (if any) */
@@ -1616,9 +1603,7 @@ _pl_c_terminate (S___(Plotter *_plotter))
       }
       
       /* WRITE DOCUMENT TRAILER */
-      _write_bytes (_plotter->data, 
-			     (int)(doc_trailer->contents),
-			     (unsigned char *)doc_trailer->base);
+      _write_outbuf (_plotter->data, doc_trailer);
       _delete_outbuf (doc_trailer);
 
     }
@@ -143,8 +143,7 @@ _cgm_emit_command_header (plOutbuf *outbuf, int cgm_encoding, int element_class,
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, "%s", op_code);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, "%s", op_code);
       break;
     }
 }
@@ -296,8 +295,7 @@ _cgm_emit_integer (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, int
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %d", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %d", x);
       break;
     }
 }
@@ -333,8 +331,7 @@ _cgm_emit_unsigned_integer (plOutbuf *outbuf, bool no_partitioning, int cgm_enco
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %u", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %u", x);
       break;
     }
 }
@@ -367,8 +364,7 @@ _cgm_emit_unsigned_integer_8bit (plOutbuf *outbuf, bool no_partitioning, int cgm
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %u", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %u", x);
       break;
     }
 }
@@ -416,8 +412,7 @@ _cgm_emit_point (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, int x
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " (%d, %d)", x, y);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " (%d, %d)", x, y);
       break;
     }
 }
@@ -470,8 +465,7 @@ _cgm_emit_points (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, cons
     case CGM_ENCODING_CLEAR_TEXT:
       for (i = 0; i < npoints; i++)
 	{
-	  sprintf (outbuf->point, " (%d, %d)", x[i], y[i]);
-	  _update_buffer (outbuf);
+	  _outbuf_printf (outbuf, " (%d, %d)", x[i], y[i]);
 	}
       break;
     }
@@ -510,8 +504,7 @@ _cgm_emit_enum (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, int x,
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %s", text_string);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %s", text_string);
       break;
     }
 }
@@ -553,8 +546,7 @@ _cgm_emit_index (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, int x
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %d", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %d", x);
       break;
     }
 }
@@ -593,8 +585,7 @@ _cgm_emit_color_component (plOutbuf *outbuf, bool no_partitioning, int cgm_encod
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %u", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %u", x);
       break;
     }
 }
@@ -657,10 +648,9 @@ _cgm_emit_real_fixed_point (plOutbuf *outbuf, bool no_partitioning, int cgm_enco
 
     case CGM_ENCODING_CLEAR_TEXT:
       if (x != 0.0)
-	sprintf (outbuf->point, " %.8f", x);
+	_outbuf_printf (outbuf, " %.8f", x);
       else
-	sprintf (outbuf->point, " 0.0");
-      _update_buffer (outbuf);
+	_outbuf_puts (outbuf, " 0.0");
       break;
     }
 }
@@ -815,8 +805,7 @@ _cgm_emit_real_floating_point (plOutbuf *outbuf, bool no_partitioning, int cgm_e
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      sprintf (outbuf->point, " %.8f", x);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, " %.8f", x);
       break;
     }
 }
@@ -947,8 +936,7 @@ _cgm_emit_string (plOutbuf *outbuf, bool no_partitioning, int cgm_encoding, cons
 	*tp++ = (use_double_quotes ? '"' : '\'');
 	*tp++ = '\0';
 
-	strcpy (outbuf->point, t);
-	_update_buffer (outbuf);
+	_outbuf_puts (outbuf, t);
 	free (t);
       }
       break;
@@ -979,8 +967,7 @@ _cgm_emit_command_terminator (plOutbuf *outbuf, int cgm_encoding, int *byte_coun
       break;
 
     case CGM_ENCODING_CLEAR_TEXT:
-      strcpy (outbuf->point, ";\n");
-      _update_buffer (outbuf);
+      _outbuf_puts (outbuf, ";\n");
       break;
     }
 }
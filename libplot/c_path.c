@@ -66,6 +66,7 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 	int pass;
 	plPathSegmentType first_element_type;
 	int i, byte_count, data_byte_count, data_len;
+	plPathIterator iter;
 	int desired_interior_style;
 	const char *desired_interior_style_string;
 
@@ -77,8 +78,8 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 
 	/* check for closure */
 	if ((_plotter->drawstate->path->num_segments >= 3)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -101,23 +102,24 @@ _pl_c_paint_path (S___(Plotter *_plotter))
 	xarray = (plIntPathSegment *)_pl_xmalloc (_plotter->drawstate->path->num_segments * sizeof(plIntPathSegment));
       
 	/* add first point of path to xarray[] (a moveto, presumably) */
-	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
-	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
+	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
+	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
 	polyline_len = 1;
       
 	/* convert to integer CGM coordinates (unlike the HP-GL case [see
 	   h_path.c], we don't remove runs, so after this loop completes,
 	   polyline_len equals _plotter->drawstate->path->num_segments) */
       
+	_path_iter_start (&iter, _plotter->drawstate->path, 1);
 	for (i = 1; i < _plotter->drawstate->path->num_segments; i++)
 	  {
 	    plPathSegment datapoint;
 	    double xuser, yuser, xdev, ydev;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
+	    _path_iter_next (&iter, &datapoint);
 	    xuser = datapoint.p.x;
 	    yuser = datapoint.p.y;
 	    xdev = XD(xuser, yuser);
@@ -346,6 +346,15 @@ extern const struct plTypefaceInfoStruct _pl_g_stick_typeface_info[];
 typedef plPoint plVector;
 typedef plIntPoint plIntVector;
 
+/* state of an iteration over the segment list of a plPath, which fills in
+   a plPathSegment for each segment (see g_subpaths.c) */
+typedef struct
+{
+  const plPath *path;		/* path being traversed */
+  int index;			/* index of next segment */
+  int curve;			/* index of next entry in side table */
+} plPathIterator;
+
 /* Initializations for default values of Plotter data members, performed
    when space() is first called.  Latter doesn't apply to Plotters whose
    device models have type DISP_DEVICE_COORS_INTEGER_LIBXMI; the default
@@ -1132,6 +1141,60 @@ struct plParamRecord
 
 extern const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS];
 
+/* Indices of the recognized Plotter parameters in _known_params[] (see
+   g_param2.c), which must list them in this order. */
+enum
+{
+  PL_PARAM_AI_VERSION,
+  PL_PARAM_ANTIALIAS,
+  PL_PARAM_BG_COLOR,
+  PL_PARAM_BITMAPSIZE,
+  PL_PARAM_BITMAP_THREADS,
+  PL_PARAM_CGM_ENCODING,
+  PL_PARAM_CGM_MAX_VERSION,
+  PL_PARAM_CULL_PATHS,
+  PL_PARAM_DECIMATION,
+  PL_PARAM_DISPLAY,
+  PL_PARAM_ELLIPSE_CACHE_SIZE,
+  PL_PARAM_EMULATE_COLOR,
+  PL_PARAM_FLATNESS,
+  PL_PARAM_GIF_ANIMATION,
+  PL_PARAM_GIF_COMPRESSION,
+  PL_PARAM_GIF_DELAY,
+  PL_PARAM_GIF_ITERATIONS,
+  PL_PARAM_GIF_QUANTIZE,
+  PL_PARAM_HPGL_ASSIGN_COLORS,
+  PL_PARAM_HPGL_OPAQUE_MODE,
+  PL_PARAM_HPGL_PENS,
+  PL_PARAM_HPGL_ROTATE,
+  PL_PARAM_HPGL_VERSION,
+  PL_PARAM_INTERLACE,
+  PL_PARAM_MAX_LINE_LENGTH,
+  PL_PARAM_META_PORTABLE,
+  PL_PARAM_NO_INPUT,
+  PL_PARAM_PAGESIZE,
+  PL_PARAM_PAGE_MEMORY_LIMIT,
+  PL_PARAM_PCL_ASSIGN_COLORS,
+  PL_PARAM_PCL_BEZIERS,
+  PL_PARAM_PNG_COMPRESSION_LEVEL,
+  PL_PARAM_PNG_FILTER,
+  PL_PARAM_PNG_STRATEGY,
+  PL_PARAM_PNM_PORTABLE,
+  PL_PARAM_REPORT_STATS,
+  PL_PARAM_ROTATION,
+  PL_PARAM_TERM,
+  PL_PARAM_TRANSPARENT_COLOR,
+  PL_PARAM_USE_DOUBLE_BUFFERING,
+  PL_PARAM_VANISH_ON_DELETE,
+  PL_PARAM_WAIT_ON_DELETE,
+  PL_PARAM_XDRAWABLE_COLORMAP,
+  PL_PARAM_XDRAWABLE_DISPLAY,
+  PL_PARAM_XDRAWABLE_DRAWABLE1,
+  PL_PARAM_XDRAWABLE_DRAWABLE2,
+  PL_PARAM_XDRAWABLE_VISUAL,
+  PL_PARAM_X_AUTO_FLUSH
+};
+
 /* A pointer to a distinguished (global) PlotterParams object, used by the
    old C and C++ bindings.  The function parampl() sets parameters in this
    object.  (This is one reason why the old bindings are non-thread-safe.
@@ -1171,20 +1234,25 @@ extern void _matrix_product (const double m[6], const double n[6], double produc
 extern void _matrix_inverse (const double m[6], double inverse[6]);
 extern void _matrix_sing_vals (const double m[6], double *min_sing_val, double *max_sing_val);
 extern void _set_common_mi_attributes (plDrawState *drawstate, void * ptr);
-extern void * _get_default_plot_param (const char *parameter); 
+extern void _draw_mi_aa_path (plDrawState *drawstate, void * ptr_coverage_set, const void * ptr_gc, bool fill);
+extern void * _get_default_plot_param (int param); 
+extern int _plot_param_index (const char *parameter); 
 
 /* plPlotterData methods */
 /* lowest-level output routines used by Plotters */
 extern void _write_byte (const plPlotterData *data, unsigned char c);
 extern void _write_bytes (const plPlotterData *data, int n, const unsigned char *c);
 extern void _write_string (const plPlotterData *data, const char *s);
+extern void _write_outbuf (const plPlotterData *data, const plOutbuf *bufp);
+extern void _write_outbufs (const plPlotterData *data, const plOutbuf *header, const plOutbuf *bufp, const plOutbuf *trailer);
 /* other plPlotterData methods */
 extern bool _compute_ndc_to_device_map (plPlotterData *data);
 extern void _set_page_type (plPlotterData *data);
-extern void * _get_plot_param (const plPlotterData *data, const char *parameter); 
+extern void * _get_plot_param (const plPlotterData *data, int param); 
 
 /* plPath methods (see g_subpaths.c) */
 extern plPath * _flatten_path (const plPath *path);
+extern int _decimate_path (plPath *path, const double m[6], double tolerance, double half_width, double miter_limit);
 extern plPath * _new_plPath (void);
 extern plPath ** _merge_paths (const plPath **paths, int num_paths);
 extern void _add_arc (plPath *path, plPoint pc, plPoint p1);
@@ -1208,9 +1276,20 @@ extern void _add_ellipse_as_bezier3s (plPath *path, plPoint pc, double rx, doubl
 extern void _add_ellipse_as_ellarcs (plPath *path, plPoint pc, double rx, double ry, double angle, bool clockwise);
 extern void _add_ellipse_as_lines (plPath *path, plPoint pc, double rx, double ry, double angle, bool clockwise);
 extern void _add_line (plPath *path, plPoint p);
+extern void _add_lines (plPath *path, int n, const double *x, const double *y);
 extern void _add_moveto (plPath *path, plPoint p);
 extern void _delete_plPath (plPath *path);
 extern void _reset_plPath (plPath *path);
+extern void _truncate_plPath (plPath *path, int n);
+extern plPathSegmentType _path_segment_type (const plPath *path, int i);
+extern const plPathCurve * _path_curve (const plPath *path, int i);
+extern void _get_path_segment (const plPath *path, int i, plPathSegment *segment);
+extern void _path_iter_start (plPathIterator *iter, const plPath *path, int start);
+extern bool _path_iter_next (plPathIterator *iter, plPathSegment *segment);
+/* plPath reuse, per Plotter (see g_subpaths.c) */
+extern plPath * _reuse_plPath (plPlotterData *data, double flatness);
+extern void _recycle_plPath (plPlotterData *data, plPath *path);
+extern void _delete_spare_plPaths (plPlotterData *data);
 
 /* plOutbuf methods (see g_outbuf.c) */
 extern plOutbuf * _new_outbuf (void);
@@ -1222,6 +1301,12 @@ extern void _reset_outbuf (plOutbuf *outbuf);
 extern void _update_bbox (plOutbuf *bufp, double x, double y);
 extern void _update_buffer (plOutbuf *outbuf);
 extern void _update_buffer_by_added_bytes (plOutbuf *outbuf, int additional);
+extern int _outbuf_puts (plOutbuf *outbuf, const char *s);
+extern int _outbuf_putc (plOutbuf *outbuf, int c);
+extern int _outbuf_put_int (plOutbuf *outbuf, int i);
+extern int _outbuf_put_fixed (plOutbuf *outbuf, double x, int decimals);
+extern int _outbuf_put_general (plOutbuf *outbuf, double x, int precision);
+extern int _outbuf_printf (plOutbuf *outbuf, const char *format, ...);
 
 /* functions that update a device-frame bounding box for a page, as stored
    in a plOutbuf */
@@ -1250,10 +1335,8 @@ extern void _cgm_emit_command_terminator (plOutbuf *outbuf, int cgm_encoding, in
 /* SVGPlotter-related functions */
 extern const char * _libplot_color_to_svg_color (plColor color_48, char charbuf[8]);
 
-/* plColorNameCache methods */
-extern bool _string_to_color (const char *name, plColor *color_p, plColorNameCache *color_name_cache);
-extern plColorNameCache * _create_color_name_cache (void);
-extern void _delete_color_name_cache (plColorNameCache *color_cache);
+/* color name lookup (see g_colors.c) */
+extern bool _string_to_color (const char *name, plColor *color_p);
 
 /* Renaming of the global symbols in the libxmi scan conversion library,
    which we include in libplot/libplotter as a rendering module.  We
@@ -1263,11 +1346,18 @@ extern void _delete_color_name_cache (plColorNameCache *color_cache);
 
 /* libxmi API functions */
 
+#define miAADrawArcs _pl_miAADrawArcs
+#define miAADrawLines _pl_miAADrawLines
+#define miAAFillArcs _pl_miAAFillArcs
+#define miAAFillPolygon _pl_miAAFillPolygon
+#define miBlendCoverageSetToCanvas _pl_miBlendCoverageSetToCanvas
+#define miClearCoverageSet _pl_miClearCoverageSet
 #define miClearPaintedSet _pl_miClearPaintedSet
 #define miCopyCanvas _pl_miCopyCanvas
 #define miCopyGC _pl_miCopyGC
 #define miCopyPaintedSetToCanvas _pl_miCopyPaintedSetToCanvas
 #define miDeleteCanvas _pl_miDeleteCanvas
+#define miDeleteCoverageSet _pl_miDeleteCoverageSet
 #define miDeleteEllipseCache _pl_miDeleteEllipseCache
 #define miDeleteGC _pl_miDeleteGC
 #define miDeletePaintedSet _pl_miDeletePaintedSet
@@ -1278,10 +1368,19 @@ extern void _delete_color_name_cache (plColorNameCache *color_cache);
 #define miFillArcs _pl_miFillArcs
 #define miFillPolygon _pl_miFillPolygon
 #define miFillRectangles _pl_miFillRectangles
+#define miGetCoverageSpans _pl_miGetCoverageSpans
+#define miGetEllipseCacheStats _pl_miGetEllipseCacheStats
+#define miGetSpanArenaStats _pl_miGetSpanArenaStats
 #define miNewCanvas _pl_miNewCanvas
+#define miNewCoverageSet _pl_miNewCoverageSet
+#define miNewDeferredPaintedSet _pl_miNewDeferredPaintedSet
+#define miNewPackedCanvas _pl_miNewPackedCanvas
 #define miNewEllipseCache _pl_miNewEllipseCache
+#define miNewEllipseCacheOfSize _pl_miNewEllipseCacheOfSize
 #define miNewGC _pl_miNewGC
+#define miNewImmediatePaintedSet _pl_miNewImmediatePaintedSet
 #define miNewPaintedSet _pl_miNewPaintedSet
+#define miRenderDeferredPaintedSet _pl_miRenderDeferredPaintedSet
 #define miSetCanvasStipple _pl_miSetCanvasStipple
 #define miSetCanvasTexture _pl_miSetCanvasTexture
 #define miSetGCAttrib _pl_miSetGCAttrib
@@ -1291,6 +1390,8 @@ extern void _delete_color_name_cache (plColorNameCache *color_cache);
 #define miSetGCPixels _pl_miSetGCPixels
 #define miSetPixelMerge2 _pl_miSetPixelMerge2
 #define miSetPixelMerge3 _pl_miSetPixelMerge3
+#define miSetSpanMerge2 _pl_miSetSpanMerge2
+#define miSetSpanMerge3 _pl_miSetSpanMerge3
 
 /* an external libxmi symbol */
 #define mi_libxmi_ver _pl_mi_libxmi_ver
@@ -1321,6 +1422,13 @@ extern void _delete_color_name_cache (plColorNameCache *color_cache);
 #define miFreeStorage _pl_miFreeStorage
 #define miQuickSortSpansY _pl_miQuickSortSpansY
 #define miUniquifyPaintedSet _pl_miUniquifyPaintedSet
+#define miPaintSpansImmediately _pl_miPaintSpansImmediately
+#define miRecordDrawingOp _pl_miRecordDrawingOp
+#define miDeleteDeferredOps _pl_miDeleteDeferredOps
+#define miDeleteLineArcCache _pl_miDeleteLineArcCache
+#define miAllocSpanStorage _pl_miAllocSpanStorage
+#define miFreeSpanStorage _pl_miFreeSpanStorage
+#define miAccumEllipseCacheStats _pl_miAccumEllipseCacheStats
 #define miWideDash _pl_miWideDash
 #define miStepDash _pl_miStepDash
 #define miWideLine _pl_miWideLine
@@ -1460,6 +1568,8 @@ extern void _maybe_handle_x_events (Plotter *_plotter);
 #define _API_fontsize pl_fontsize_r
 #define _API_fpoint pl_fpoint_r
 #define _API_fpointrel pl_fpointrel_r
+#define _API_fpoints pl_fpoints_r
+#define _API_fpolyline pl_fpolyline_r
 #define _API_frotate pl_frotate_r
 #define _API_fscale pl_fscale_r
 #define _API_fsetmatrix pl_fsetmatrix_r
@@ -1561,6 +1671,8 @@ extern int _API_fontname (Plotter *_plotter, const char *s);
 extern int _API_fontsize (Plotter *_plotter, int size);
 extern int _API_fpoint (Plotter *_plotter, double x, double y);
 extern int _API_fpointrel (Plotter *_plotter, double dx, double dy);
+extern int _API_fpoints (Plotter *_plotter, int n, const double *x, const double *y);
+extern int _API_fpolyline (Plotter *_plotter, int n, const double *x, const double *y);
 extern int _API_frotate (Plotter *_plotter, double theta);
 extern int _API_fscale (Plotter *_plotter, double x, double y);
 extern int _API_fsetmatrix (Plotter *_plotter, double m0, double m1, double m2, double m3, double m4, double m5);
@@ -1639,6 +1751,7 @@ extern void _pl_g_maybe_replace_arc (Plotter *_plotter);
 extern void _pl_g_set_font (Plotter *_plotter);
 /* other protected Plotter functions (a mixed bag), for libplot */
 extern void _pl_g_flush_plotter_outstreams (Plotter *_plotter);
+extern void _pl_g_report_mi_stats (Plotter *_plotter, const void * ptr_painted_set, const void * ptr_ellipse_cache);
 ___END_DECLS
 #else  /* LIBPLOTTER */
 /* static Plotter public method (libplotter only) */
@@ -1709,6 +1822,8 @@ ___END_DECLS
 #define _API_fontsize Plotter::fontsize
 #define _API_fpoint Plotter::fpoint
 #define _API_fpointrel Plotter::fpointrel
+#define _API_fpoints Plotter::fpoints
+#define _API_fpolyline Plotter::fpolyline
 #define _API_frotate Plotter::frotate
 #define _API_fscale Plotter::fscale
 #define _API_fsetmatrix Plotter::fsetmatrix
@@ -1789,6 +1904,7 @@ ___END_DECLS
 #define _pl_g_set_font Plotter::_g_set_font
 /* other protected functions (a mixed bag), for libplotter */
 #define _pl_g_flush_plotter_outstreams Plotter::_flush_plotter_outstreams
+#define _pl_g_report_mi_stats Plotter::_report_mi_stats
 #endif /* LIBPLOTTER */
 
 #ifndef LIBPLOTTER
@@ -1854,10 +1970,12 @@ extern void _pl_b_terminate (Plotter *_plotter);
 extern int _pl_b_maybe_output_image (Plotter *_plotter);
 /* other BitmapPlotter internal functions, for libplot */
 extern void _pl_b_delete_image (Plotter *_plotter);
+extern void _pl_b_draw_antialiased_path (Plotter *_plotter);
 extern void _pl_b_draw_elliptic_arc (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_b_draw_elliptic_arc_2 (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_b_draw_elliptic_arc_internal (Plotter *_plotter, int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
 extern void _pl_b_new_image (Plotter *_plotter);
+extern void _pl_b_note_color (Plotter *_plotter, int red, int green, int blue);
 ___END_DECLS
 #else  /* LIBPLOTTER */
 /* BitmapPlotter protected methods, for libplotter */
@@ -1873,10 +1991,12 @@ ___END_DECLS
 #define _pl_b_maybe_output_image BitmapPlotter::_maybe_output_image
 /* other BitmapPlotter internal functions, for libplotter */
 #define _pl_b_delete_image BitmapPlotter::_b_delete_image
+#define _pl_b_draw_antialiased_path BitmapPlotter::_b_draw_antialiased_path
 #define _pl_b_draw_elliptic_arc BitmapPlotter::_b_draw_elliptic_arc
 #define _pl_b_draw_elliptic_arc_2 BitmapPlotter::_b_draw_elliptic_arc_2
 #define _pl_b_draw_elliptic_arc_internal BitmapPlotter::_b_draw_elliptic_arc_internal
 #define _pl_b_new_image BitmapPlotter::_b_new_image 
+#define _pl_b_note_color BitmapPlotter::_b_note_color
 #endif /* LIBPLOTTER */
 
 #ifndef LIBPLOTTER
@@ -2273,17 +2393,18 @@ extern void _pl_i_paint_path (Plotter *_plotter);
 extern void _pl_i_paint_point (Plotter *_plotter);
 extern void _pl_i_terminate (Plotter *_plotter);
 /* GIFPlotter internal functions, for libplot */
-extern int _pl_i_scan_pixel (Plotter *_plotter);
 extern unsigned char _pl_i_new_color_index (Plotter *_plotter, int red, int green, int blue);
+extern void _pl_i_color_pixel (Plotter *_plotter, void * ptr_pixel, plColor color, unsigned char index);
 extern void _pl_i_delete_image (Plotter *_plotter);
+extern void _pl_i_draw_antialiased_path (Plotter *_plotter);
 extern void _pl_i_draw_elliptic_arc (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_i_draw_elliptic_arc_2 (Plotter *_plotter, plPoint p0, plPoint p1, plPoint pc);
 extern void _pl_i_draw_elliptic_arc_internal (Plotter *_plotter, int xorigin, int yorigin, unsigned int squaresize_x, unsigned int squaresize_y, int startangle, int anglerange);
 extern void _pl_i_new_image (Plotter *_plotter);
+extern void _pl_i_quantize_image (Plotter *_plotter);
 extern void _pl_i_set_bg_color (Plotter *_plotter);
 extern void _pl_i_set_fill_color (Plotter *_plotter);
 extern void _pl_i_set_pen_color (Plotter *_plotter);
-extern void _pl_i_start_scan (Plotter *_plotter);
 extern void _pl_i_write_gif_header (Plotter *_plotter);
 extern void _pl_i_write_gif_image (Plotter *_plotter);
 extern void _pl_i_write_gif_trailer (Plotter *_plotter);
@@ -2300,17 +2421,18 @@ ___END_DECLS
 #define _pl_i_paint_point GIFPlotter::paint_point
 #define _pl_i_terminate GIFPlotter::terminate
 /* GIFPlotter internal functions, for libplotter */
-#define _pl_i_scan_pixel GIFPlotter::_i_scan_pixel
 #define _pl_i_new_color_index GIFPlotter::_i_new_color_index
+#define _pl_i_color_pixel GIFPlotter::_i_color_pixel
 #define _pl_i_delete_image GIFPlotter::_i_delete_image
+#define _pl_i_draw_antialiased_path GIFPlotter::_i_draw_antialiased_path
 #define _pl_i_draw_elliptic_arc GIFPlotter::_i_draw_elliptic_arc
 #define _pl_i_draw_elliptic_arc_2 GIFPlotter::_i_draw_elliptic_arc_2
 #define _pl_i_draw_elliptic_arc_internal GIFPlotter::_i_draw_elliptic_arc_internal
 #define _pl_i_new_image GIFPlotter::_i_new_image 
+#define _pl_i_quantize_image GIFPlotter::_i_quantize_image
 #define _pl_i_set_bg_color GIFPlotter::_i_set_bg_color
 #define _pl_i_set_fill_color GIFPlotter::_i_set_fill_color
 #define _pl_i_set_pen_color GIFPlotter::_i_set_pen_color
-#define _pl_i_start_scan GIFPlotter::_i_start_scan
 #define _pl_i_write_gif_header GIFPlotter::_i_write_gif_header
 #define _pl_i_write_gif_image GIFPlotter::_i_write_gif_image
 #define _pl_i_write_gif_trailer GIFPlotter::_i_write_gif_trailer
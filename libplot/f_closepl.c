@@ -38,30 +38,28 @@ _pl_f_end_page (S___(Plotter *_plotter))
   fig_header = _new_outbuf ();
       
   units = (_plotter->data->page_data->metric ? "Metric" : "Inches");
-  sprintf (fig_header->point,
-	   "#FIG 3.2\n%s\n%s\n%s\n%s\n%.2f\n%s\n%d\n%d %d\n",
-	   "Portrait",		/* portrait mode, not landscape */
-	   "Flush Left",	/* justification */
-	   units,		/* "Metric" or "Inches" */
-	   _plotter->data->page_data->fig_name, /* paper size */
-	   100.00,		/* export and print magnification */
-	   "Single",		/* "Single" or "Multiple" pages */
-	   -2,			/* color number for transparent color */
-	   IROUND(FIG_UNITS_PER_INCH), /* Fig units per inch */
-	   2			/* origin in lower left corner (ignored) */
-	   );
-  _update_buffer (fig_header);
+  _outbuf_printf (fig_header,
+		  "#FIG 3.2\n%s\n%s\n%s\n%s\n%.2f\n%s\n%d\n%d %d\n",
+		  "Portrait",		/* portrait mode, not landscape */
+		  "Flush Left",	/* justification */
+		  units,		/* "Metric" or "Inches" */
+		  _plotter->data->page_data->fig_name, /* paper size */
+		  100.00,		/* export and print magnification */
+		  "Single",		/* "Single" or "Multiple" pages */
+		  -2,			/* color number for transparent color */
+		  IROUND(FIG_UNITS_PER_INCH), /* Fig units per inch */
+		  2			/* origin in lower left corner (ignored) */
+		  );
       
   /* output user-defined colors if any */
   for (i = 0; i < _plotter->fig_num_usercolors; i++)
     {
-      sprintf (fig_header->point,
-	       "#COLOR\n%d %d #%06lx\n",
-	       0,	               /* color pseudo-object */
-	       FIG_USER_COLOR_MIN + i, /* color num, in xfig's range */
-	       _plotter->fig_usercolors[i] /* 24-bit RGB value */
-	       );
-      _update_buffer (fig_header);
+      _outbuf_printf (fig_header,
+		      "#COLOR\n%d %d #%06lx\n",
+		      0,	               /* color pseudo-object */
+		      FIG_USER_COLOR_MIN + i, /* color num, in xfig's range */
+		      _plotter->fig_usercolors[i] /* 24-bit RGB value */
+		      );
     }
   
   /* place header in the plOutbuf for the page */
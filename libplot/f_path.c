@@ -70,6 +70,7 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	bool closed; 
 	const char *format;
 	int i, polyline_subtype, line_style;
+	plPathIterator iter;
 	double nominal_spacing;
 	double device_line_width;
 	int quantized_device_line_width;
@@ -81,23 +82,23 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	  break;
       
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ARC)
 	  /* segment buffer contains a single arc, not a polyline */
 	  {
-	    double x0 = _plotter->drawstate->path->segments[0].p.x;
-	    double y0 = _plotter->drawstate->path->segments[0].p.y;      
-	    double x1 = _plotter->drawstate->path->segments[1].p.x;
-	    double y1 = _plotter->drawstate->path->segments[1].p.y;      
-	    double xc = _plotter->drawstate->path->segments[1].pc.x;
-	    double yc = _plotter->drawstate->path->segments[1].pc.y;      
+	    double x0 = _plotter->drawstate->path->points[0].x;
+	    double y0 = _plotter->drawstate->path->points[0].y;      
+	    double x1 = _plotter->drawstate->path->points[1].x;
+	    double y1 = _plotter->drawstate->path->points[1].y;      
+	    double xc = _path_curve (_plotter->drawstate->path, 1)->pc.x;
+	    double yc = _path_curve (_plotter->drawstate->path, 1)->pc.y;      
 	    
 	    _pl_f_draw_arc_internal (R___(_plotter) xc, yc, x0, y0, x1, y1);
 	    break;
 	  }
 	
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -159,36 +160,36 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	if (_plotter->fig_drawing_depth > 0)
 	  (_plotter->fig_drawing_depth)--;
 	
-	sprintf(_plotter->data->page->point,
-		format,
-		2,		/* polyline object */
-		polyline_subtype, /* polyline subtype */
-		line_style,	/* Fig line style */
-	  			/* thickness, in Fig display units */
-		(_plotter->drawstate->pen_type == 0 ? 0 :
-		 quantized_device_line_width), 
-		_plotter->drawstate->fig_fgcolor, /* pen color */
-		_plotter->drawstate->fig_fillcolor, /* fill color */
-		_plotter->fig_drawing_depth, /* depth */
-		0,		/* pen style, ignored */
-		_plotter->drawstate->fig_fill_level, /* area fill */
-		nominal_spacing, /* style val, in Fig display units (float) */
-		_pl_f_fig_join_style[_plotter->drawstate->join_type],/*join style */
-		_pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
-		0,		/* radius(of arc boxes, ignored here) */
-		0,		/* forward arrow */
-		0,		/* backward arrow */
-		_plotter->drawstate->path->num_segments /*num points in line */
-		);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page,
+			format,
+			2,		/* polyline object */
+			polyline_subtype, /* polyline subtype */
+			line_style,	/* Fig line style */
+					/* thickness, in Fig display units */
+			(_plotter->drawstate->pen_type == 0 ? 0 :
+			 quantized_device_line_width),
+			_plotter->drawstate->fig_fgcolor, /* pen color */
+			_plotter->drawstate->fig_fillcolor, /* fill color */
+			_plotter->fig_drawing_depth, /* depth */
+			0,		/* pen style, ignored */
+			_plotter->drawstate->fig_fill_level, /* area fill */
+			nominal_spacing, /* style val, in Fig display units (float) */
+			_pl_f_fig_join_style[_plotter->drawstate->join_type],/*join style */
+			_pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
+			0,		/* radius(of arc boxes, ignored here) */
+			0,		/* forward arrow */
+			0,		/* backward arrow */
+			_plotter->drawstate->path->num_segments /*num points in line */
+			);
 	
+	_path_iter_start (&iter, _plotter->drawstate->path, 0);
 	for (i=0; i<_plotter->drawstate->path->num_segments; i++)
 	  {
 	    plPathSegment datapoint;
 	    double xu, yu, xd, yd;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
+	    _path_iter_next (&iter, &datapoint);
 	    xu = datapoint.p.x;
 	    yu = datapoint.p.y;
 	    xd = XD(xu, yu);
@@ -197,16 +198,15 @@ _pl_f_paint_path (S___(Plotter *_plotter))
 	    device_y = IROUND(yd);
 	    
 	    if ((i%5) == 0)
-	      sprintf (_plotter->data->page->point, "\n\t");/* make human-readable */
+	      _outbuf_puts (_plotter->data->page, "\n\t");/* make human-readable */
 	    else
-	      sprintf (_plotter->data->page->point, " ");
-	    _update_buffer (_plotter->data->page);
+	      _outbuf_puts (_plotter->data->page, " ");
 	    
-	    sprintf (_plotter->data->page->point, "%d %d", device_x, device_y);
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_put_int (_plotter->data->page, device_x);
+	    _outbuf_putc (_plotter->data->page, ' ');
+	    _outbuf_put_int (_plotter->data->page, device_y);
 	  }
-	sprintf (_plotter->data->page->point, "\n");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "\n");
       }
       break;
 	
@@ -339,33 +339,32 @@ _pl_f_draw_arc_internal (R___(Plotter *_plotter) double xc, double yc, double x0
       p1 = ptmp;
     }
 
-  sprintf(_plotter->data->page->point,
-	  "#ARC\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %.3f %.3f %d %d %d %d %d %d\n",
-	  5,			/* arc object */
-	  1,			/* open-ended arc subtype */
-	  line_style,		/* Fig line style */
-	  			/* thickness, in Fig display units */
-	  (_plotter->drawstate->pen_type == 0 ? 0 :
-	   quantized_device_line_width), 
-	  _plotter->drawstate->fig_fgcolor, /* pen color */
-	  _plotter->drawstate->fig_fillcolor, /* fill color */
-	  _plotter->fig_drawing_depth, /* depth */
-	  0,			/* pen style, ignored */
-	  _plotter->drawstate->fig_fill_level, /* area fill */
-	  nominal_spacing,	/* style val, in Fig display units (float) */
-	  _pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
-	  1,			/* counterclockwise */
-	  0,			/* no forward arrow */
-	  0,			/* no backward arrow */
-	  XD(pc.x, pc.y),	/* center_x (float) */
-	  YD(pc.x, pc.y),	/* center_y (float) */
-	  IROUND(XD(p0.x, p0.y)), /* 1st point user entered (p0) */
-	  IROUND(YD(p0.x, p0.y)), 
-	  IROUND(XD(pb.x, pb.y)), /* 2nd point user entered (bisection point)*/
-	  IROUND(YD(pb.x, pb.y)),
-	  IROUND(XD(p1.x, p1.y)), /* last point user entered (p1) */
-	  IROUND(YD(p1.x, p1.y)));
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page,
+		  "#ARC\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %.3f %.3f %d %d %d %d %d %d\n",
+		  5,			/* arc object */
+		  1,			/* open-ended arc subtype */
+		  line_style,		/* Fig line style */
+					/* thickness, in Fig display units */
+		  (_plotter->drawstate->pen_type == 0 ? 0 :
+		   quantized_device_line_width),
+		  _plotter->drawstate->fig_fgcolor, /* pen color */
+		  _plotter->drawstate->fig_fillcolor, /* fill color */
+		  _plotter->fig_drawing_depth, /* depth */
+		  0,			/* pen style, ignored */
+		  _plotter->drawstate->fig_fill_level, /* area fill */
+		  nominal_spacing,	/* style val, in Fig display units (float) */
+		  _pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
+		  1,			/* counterclockwise */
+		  0,			/* no forward arrow */
+		  0,			/* no backward arrow */
+		  XD(pc.x, pc.y),	/* center_x (float) */
+		  YD(pc.x, pc.y),	/* center_y (float) */
+		  IROUND(XD(p0.x, p0.y)), /* 1st point user entered (p0) */
+		  IROUND(YD(p0.x, p0.y)),
+		  IROUND(XD(pb.x, pb.y)), /* 2nd point user entered (bisection point)*/
+		  IROUND(YD(pb.x, pb.y)),
+		  IROUND(XD(p1.x, p1.y)), /* last point user entered (p1) */
+		  IROUND(YD(p1.x, p1.y)));
 }
 
 void
@@ -407,28 +406,27 @@ _pl_f_draw_box_internal (R___(Plotter *_plotter) plPoint p0, plPoint p1)
   if (_plotter->fig_drawing_depth > 0)
     (_plotter->fig_drawing_depth)--;
   
-  sprintf(_plotter->data->page->point,
-	  "#POLYLINE [BOX]\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %d %d\n",
-	  2,			/* polyline object */
-	  P_BOX,		/* polyline subtype */
-	  line_style,		/* Fig line style */
-	  			/* thickness, in Fig display units */
-	  (_plotter->drawstate->pen_type == 0 ? 0 :
-	  quantized_device_line_width), 
-	  _plotter->drawstate->fig_fgcolor,	/* pen color */
-	  _plotter->drawstate->fig_fillcolor, /* fill color */
-	  _plotter->fig_drawing_depth, /* depth */
-	  0,			/* pen style, ignored */
-	  _plotter->drawstate->fig_fill_level, /* area fill */
-	  nominal_spacing,	/* style val, in Fig display units (float) */
-	  _pl_f_fig_join_style[_plotter->drawstate->join_type], /* join style */
-	  _pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
-	  0,			/* radius (of arc boxes, ignored here) */
-	  0,			/* forward arrow */
-	  0,			/* backward arrow */
-	  5			/* number of points in line */
-	  );
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page,
+		  "#POLYLINE [BOX]\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %d %d\n",
+		  2,			/* polyline object */
+		  P_BOX,		/* polyline subtype */
+		  line_style,		/* Fig line style */
+					/* thickness, in Fig display units */
+		  (_plotter->drawstate->pen_type == 0 ? 0 :
+		  quantized_device_line_width),
+		  _plotter->drawstate->fig_fgcolor,	/* pen color */
+		  _plotter->drawstate->fig_fillcolor, /* fill color */
+		  _plotter->fig_drawing_depth, /* depth */
+		  0,			/* pen style, ignored */
+		  _plotter->drawstate->fig_fill_level, /* area fill */
+		  nominal_spacing,	/* style val, in Fig display units (float) */
+		  _pl_f_fig_join_style[_plotter->drawstate->join_type], /* join style */
+		  _pl_f_fig_cap_style[_plotter->drawstate->cap_type], /* cap style */
+		  0,			/* radius (of arc boxes, ignored here) */
+		  0,			/* forward arrow */
+		  0,			/* backward arrow */
+		  5			/* number of points in line */
+		  );
   
   p0 = _plotter->drawstate->path->p0;
   p1 = _plotter->drawstate->path->p1;
@@ -437,16 +435,11 @@ _pl_f_draw_box_internal (R___(Plotter *_plotter) plPoint p0, plPoint p1)
   xd1 = IROUND(XD(p1.x, p1.y));
   yd1 = IROUND(YD(p1.x, p1.y));  
   
-  sprintf (_plotter->data->page->point, "\t%d %d ", xd0, yd0);
-  _update_buffer (_plotter->data->page);
-  sprintf (_plotter->data->page->point, "%d %d ", xd0, yd1);
-  _update_buffer (_plotter->data->page);
-  sprintf (_plotter->data->page->point, "%d %d ", xd1, yd1);
-  _update_buffer (_plotter->data->page);
-  sprintf (_plotter->data->page->point, "%d %d ", xd1, yd0);
-  _update_buffer (_plotter->data->page);
-  sprintf (_plotter->data->page->point, "%d %d\n", xd0, yd0);
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "\t%d %d ", xd0, yd0);
+  _outbuf_printf (_plotter->data->page, "%d %d ", xd0, yd1);
+  _outbuf_printf (_plotter->data->page, "%d %d ", xd1, yd1);
+  _outbuf_printf (_plotter->data->page, "%d %d ", xd1, yd0);
+  _outbuf_printf (_plotter->data->page, "%d %d\n", xd0, yd0);
 }
 
 void
@@ -543,34 +536,33 @@ _pl_f_draw_ellipse_internal (R___(Plotter *_plotter) double x, double y, double
   else
     format = "#ELLIPSE\n%d %d %d %d %d %d %d %d %d %.3f %d %.3f %d %d %d %d %d %d %d %d\n";
 
-  sprintf(_plotter->data->page->point,
-	  format,
-	  1,			/* ellipse object */
-	  subtype,		/* subtype, see above */
-	  line_style,		/* Fig line style */
-	  			/* thickness, in Fig display units */
-	  (_plotter->drawstate->pen_type == 0 ? 0 :
-	   quantized_device_line_width), 
-	  _plotter->drawstate->fig_fgcolor,	/* pen color */
-	  _plotter->drawstate->fig_fillcolor, /* fill color */
-	  _plotter->fig_drawing_depth, /* depth */
-	  0,			/* pen style, ignored */
-	  _plotter->drawstate->fig_fill_level, /* area fill */
-	  nominal_spacing,	/* style val, in Fig display units (float) */
-	  1,			/* direction, always 1 */
-	  theta_device,		/* inclination angle, in radians (float) */
-	  IROUND(XD(x,y)),	/* center_x (not float, unlike arc) */
-	  IROUND(YD(x,y)),	/* center_y (not float, unlike arc) */
-	  IROUND(rx_device),	/* radius_x */
-	  IROUND(ry_device),	/* radius_y */
-	  IROUND(XD(x,y)),	/* start_x, 1st point entered */
-	  IROUND(YD(x,y)),	/* start_y, 1st point entered */
-	  IROUND(XD(x,y)	/* end_x, last point entered */
-		 + semi_axis_1_x + semi_axis_2_x),
-	  IROUND(YD(x,y)	/* end_y, last point entered */
-		 + semi_axis_1_y + semi_axis_2_y) 
-	  );			
-  _update_buffer(_plotter->data->page);
+  _outbuf_printf (_plotter->data->page,
+		  format,
+		  1,			/* ellipse object */
+		  subtype,		/* subtype, see above */
+		  line_style,		/* Fig line style */
+					/* thickness, in Fig display units */
+		  (_plotter->drawstate->pen_type == 0 ? 0 :
+		   quantized_device_line_width),
+		  _plotter->drawstate->fig_fgcolor,	/* pen color */
+		  _plotter->drawstate->fig_fillcolor, /* fill color */
+		  _plotter->fig_drawing_depth, /* depth */
+		  0,			/* pen style, ignored */
+		  _plotter->drawstate->fig_fill_level, /* area fill */
+		  nominal_spacing,	/* style val, in Fig display units (float) */
+		  1,			/* direction, always 1 */
+		  theta_device,		/* inclination angle, in radians (float) */
+		  IROUND(XD(x,y)),	/* center_x (not float, unlike arc) */
+		  IROUND(YD(x,y)),	/* center_y (not float, unlike arc) */
+		  IROUND(rx_device),	/* radius_x */
+		  IROUND(ry_device),	/* radius_y */
+		  IROUND(XD(x,y)),	/* start_x, 1st point entered */
+		  IROUND(YD(x,y)),	/* start_y, 1st point entered */
+		  IROUND(XD(x,y)	/* end_x, last point entered */
+			 + semi_axis_1_x + semi_axis_2_x),
+		  IROUND(YD(x,y)	/* end_y, last point entered */
+			 + semi_axis_1_y + semi_axis_2_y)
+		  );
 }
 
 /* compute appropriate Fig line style, and also appropriate value for Fig's
@@ -52,28 +52,26 @@ _pl_f_paint_point (S___(Plotter *_plotter))
       x = _plotter->drawstate->pos.x;
       y = _plotter->drawstate->pos.x;
 
-      sprintf(_plotter->data->page->point,
-	      "#POLYLINE [OPEN]\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %d %d\n\t%d %d\n",
-	      2,		/* polyline object */
-	      P_OPEN,		/* polyline subtype */
-	      FIG_L_SOLID,	/* style */
-	      1,		/* thickness, in Fig display units */
-	      _plotter->drawstate->fig_fgcolor, /* pen color */
-	      _plotter->drawstate->fig_fgcolor, /* fill color */
-	      _plotter->fig_drawing_depth, /* depth */
-	      0,		/* pen style, ignored */
-	      20,		/* fig fill level (20 = full intensity) */
-	      0.0,		/* style val, ignored (?) */
-	      FIG_JOIN_ROUND,	/* join style = round */
-	      FIG_CAP_ROUND,	/* cap style = round */
-	      0,		/* radius (of arc boxes, ignored) */
-	      0,		/* forward arrow */
-	      0,		/* backward arrow */
-	      1,		/* number of points in polyline */
-	      IROUND(XD(x,y)), 
-	      IROUND(YD(x,y))
-	      );
-      
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page,
+		      "#POLYLINE [OPEN]\n%d %d %d %d %d %d %d %d %d %.3f %d %d %d %d %d %d\n\t%d %d\n",
+		      2,		/* polyline object */
+		      P_OPEN,		/* polyline subtype */
+		      FIG_L_SOLID,	/* style */
+		      1,		/* thickness, in Fig display units */
+		      _plotter->drawstate->fig_fgcolor, /* pen color */
+		      _plotter->drawstate->fig_fgcolor, /* fill color */
+		      _plotter->fig_drawing_depth, /* depth */
+		      0,		/* pen style, ignored */
+		      20,		/* fig fill level (20 = full intensity) */
+		      0.0,		/* style val, ignored (?) */
+		      FIG_JOIN_ROUND,	/* join style = round */
+		      FIG_CAP_ROUND,	/* cap style = round */
+		      0,		/* radius (of arc boxes, ignored) */
+		      0,		/* forward arrow */
+		      0,		/* backward arrow */
+		      1,		/* number of points in polyline */
+		      IROUND(XD(x,y)),
+		      IROUND(YD(x,y))
+		      );
     }
 }
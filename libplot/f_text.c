@@ -172,27 +172,26 @@ _pl_f_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     if (_plotter->fig_drawing_depth > 0)
       (_plotter->fig_drawing_depth)--;
 
-  sprintf(_plotter->data->page->point,
-	  "#TEXT\n%d %d %d %d %d %d %.3f %.3f %d %.3f %.3f %d %d %s\\001\n",
-	  4,			/* text object */
-	  /* xfig supports 3 justification types: left, center, or right. */
-	  fig_horizontal_alignment_style[h_just],/* horizontal just. type */
-	  _plotter->drawstate->fig_fgcolor, /* pen color */
-	  _plotter->fig_drawing_depth, /* depth */
-	  0,			/* pen style, ignored */
-	  _pl_g_ps_font_info[master_font_index].fig_id, /* Fig font id */
-	  (double)_plotter->drawstate->fig_font_point_size, /* point size (float) */
-	  angle_device,		/* text rotation in radians (float) */
-	  FONT_TYPE_PS,		/* Fig font type */
-	  /* these next two are used only for setting up `hot spots' */
-	  vertical_fig_length, /* string height, Fig units (float) */
-	  horizontal_fig_length, /* string width, Fig units (float) */
-	  /* coors of origin of label, in Fig units */
-	  IROUND(initial_x), 
-	  IROUND(initial_y),
-	  t);			/* munged string */
+  _outbuf_printf (_plotter->data->page,
+		  "#TEXT\n%d %d %d %d %d %d %.3f %.3f %d %.3f %.3f %d %d %s\\001\n",
+		  4,			/* text object */
+		  /* xfig supports 3 justification types: left, center, or right. */
+		  fig_horizontal_alignment_style[h_just],/* horizontal just. type */
+		  _plotter->drawstate->fig_fgcolor, /* pen color */
+		  _plotter->fig_drawing_depth, /* depth */
+		  0,			/* pen style, ignored */
+		  _pl_g_ps_font_info[master_font_index].fig_id, /* Fig font id */
+		  (double)_plotter->drawstate->fig_font_point_size, /* point size (float) */
+		  angle_device,		/* text rotation in radians (float) */
+		  FONT_TYPE_PS,		/* Fig font type */
+		  /* these next two are used only for setting up `hot spots' */
+		  vertical_fig_length, /* string height, Fig units (float) */
+		  horizontal_fig_length, /* string width, Fig units (float) */
+		  /* coors of origin of label, in Fig units */
+		  IROUND(initial_x),
+		  IROUND(initial_y),
+		  t);			/* munged string */
   free (t);
-  _update_buffer (_plotter->data->page);
 
   return label_width;
 }
@@ -90,7 +90,8 @@ _API_farc (R___(Plotter *_plotter) double xc, double yc, double x0, double y0, d
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -208,7 +209,8 @@ _API_fellarc (R___(Plotter *_plotter) double xc, double yc, double x0, double y0
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
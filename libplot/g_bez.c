@@ -65,7 +65,8 @@ _API_fbezier2 (R___(Plotter *_plotter) double x0, double y0, double x1, double y
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -184,7 +185,8 @@ _API_fbezier3 (R___(Plotter *_plotter) double x0, double y0, double x1, double y
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
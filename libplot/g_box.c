@@ -52,7 +52,8 @@ _API_fbox (R___(Plotter *_plotter) double x0, double y0, double x1, double y1)
     _API_endpath (S___(_plotter));
 
   /* begin a new path */
-  _plotter->drawstate->path = _new_plPath ();
+  _plotter->drawstate->path =
+    _reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
 
   p0.x = x0; 
   p0.y = y0;
@@ -58,7 +58,8 @@ _API_fcircle (R___(Plotter *_plotter) double x, double y, double r)
       bool clockwise;
 
       /* begin a new path */
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
 
       /* place circle in path buffer */
 
@@ -57,6 +57,30 @@ _API_closepl (S___(Plotter *_plotter))
   /* remove first drawing state too, so we can start afresh */
   _pl_g_delete_first_drawing_state (S___(_plotter));
 
+  /* free the paths kept for reuse on this page */
+  _delete_spare_plPaths (_plotter->data);
+
+  /* report the number of vertices produced by flattening curves, and
+     dropped by decimating polylines, on this page, if requested */
+  if (_plotter->data->report_stats && _plotter->data->flattened_vertices > 0)
+    {
+      char buf[64];
+
+      sprintf (buf, "curve flattening: %lu vertices",
+	       _plotter->data->flattened_vertices);
+      _plotter->warning (R___(_plotter) buf);
+    }
+  if (_plotter->data->report_stats && _plotter->data->decimated_vertices > 0)
+    {
+      char buf[64];
+
+      sprintf (buf, "polyline decimation: %lu vertices dropped",
+	       _plotter->data->decimated_vertices);
+      _plotter->warning (R___(_plotter) buf);
+    }
+  _plotter->data->flattened_vertices = 0;
+  _plotter->data->decimated_vertices = 0;
+
   switch ((int)_plotter->data->output_model)
     {
     case (int)PL_OUTPUT_NONE:
@@ -76,21 +100,10 @@ _API_closepl (S___(Plotter *_plotter))
 	  && (emit_not_just_the_first_page 
 	      || _plotter->data->page_number == 1))
 	{
-	  /* emit page header if any */
-	  if (_plotter->data->page->header 
-	      && _plotter->data->page->header->len > 0)
-	    _write_string (_plotter->data, 
-			   _plotter->data->page->header->base); 
-
-	  /* emit all the graphics on the page */
-	  if (_plotter->data->page && _plotter->data->page->len > 0)
-	    _write_string (_plotter->data, _plotter->data->page->base); 
-
-	  /* emit page trailer if any */
-	  if (_plotter->data->page->trailer 
-	      && _plotter->data->page->trailer->len > 0)
-	    _write_string (_plotter->data, 
-			   _plotter->data->page->trailer->base); 
+	  /* emit page header if any, all the graphics on the page, and
+	     page trailer if any */
+	  _write_outbufs (_plotter->data, _plotter->data->page->header,
+			  _plotter->data->page, _plotter->data->page->trailer);
 
 	  /* attempt to flush (will test whether stream is jammed) */
 	  retval2 = _API_flushpl (S___(_plotter));
@@ -699,3 +699,129 @@ static const plColorNameInfo _pl_g_colornames[NUM_COLORNAMES + 1] =
   {"yellowgreen",	0x9a, 0xcd, 0x32},
   {NULL,		   0,    0,    0}
 };
+
+/* A perfect hash index into the above table, shared by all Plotters.  A
+   name is hashed by 32-bit FNV-1a, applied to its characters after they
+   are mapped to lower case and any spaces are removed.  The low 8 bits of
+   the hash select one of NUM_COLORNAME_BUCKETS buckets, and the next 10
+   bits, exclusive-or'd with the bucket's displacement, select one of
+   NUM_COLORNAME_SLOTS slots, which holds the index of the only name in
+   the table that can match (or -1).  The displacements were chosen, a
+   bucket at a time, largest bucket first, as the smallest that send the
+   bucket's names to distinct unused slots; so if names are added to the
+   table, both arrays must be recomputed.  The program test/colorname.c
+   does that: `make check' runs it to verify them, and when run with
+   --generate it prints new ones. */
+
+#define NUM_COLORNAME_BUCKETS 256
+#define NUM_COLORNAME_SLOTS 1024
+
+static const unsigned char _pl_g_colorname_displacements[NUM_COLORNAME_BUCKETS] =
+{
+   22,   1,   0,   2,   4,  20,   1,   2,   0,   1,   0,   9,   1,   4,  18,   0,
+   16,  18,  43,  47,  15,   3,   0,  10,   0,  10,   0,   0,   1,   5,  15,  40,
+   23,   4,   0,  16,   8,  16,   2,   0,  16,   7,   2,   0,   8,   6,   0,   4,
+    5,   0,  43,  59,  10,   0,  30,  22,   1,   4,   0,   3,   0,   4,   0,   3,
+    0,   3,  21,  10,   2,  23,  33,   1,   0,  18,   0,  51,   4,   5,   0,   0,
+    5,   0,   4,   6,  16,   2,   0,   0,  20,  48,   7,   0,   1,   0,   0,   0,
+    0,   7,   0,  32,  37,   0,  24,   6,   4,  12,   2,   1,   2,   1,   0,  23,
+    6,   2,   3,   0,  16,   0,   6,   0,  18,  40,   4,   0,   0,   3,   4,  48,
+   59,   0,   5,   1,   3,   0,   1,   1,   0,   8,   1,  11,   4,   0,   4,   0,
+    0,  16,   0,   0,  18,   2,   0,   7,   0,   3,   2,   0,  21,   7,   0,  19,
+   60,  38,   2,   0,   3,  36,   0,   7,  11,   0,   4,   0,   0,   4,   0,  12,
+    5,   5,   5,   2,   0,   0,   2,   0,  52,  23,  14,  17,   0,   0,  24,   4,
+    4,   8,  32,   0,  23,   0,  46,   8,  19,  27,  24,   0,   1,  13,   3,   0,
+    6,   0,   0,   2,   2,  40,   9,  16,  12,   1,   1,   0,  27,  17,   5,  17,
+    0,  17,   0,   2,   0,  18,   0,  32,   1,   0,   6,   4,   8,   5,   0,  32,
+    0,   0,  11,   0,   0,   5,   8,   0,  17,   3,   5,   2,   8,   0,  10,   7
+};
+
+static const short _pl_g_colorname_slots[NUM_COLORNAME_SLOTS] =
+{
+   -1, 223, 224,  -1,  -1,  16, 596,  -1, 476,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1, 451,  -1,  -1, 473,  -1,  -1,  -1,  -1,
+   -1, 262,  -1,  -1, 128, 471, 470,  80,  -1, 472,  -1,  -1,
+   -1, 576,  -1,  -1,  -1,  45,  -1, 640,  -1,  -1, 463,  -1,
+   -1, 585,  -1, 149,  28, 270, 411, 583, 269, 477, 408,  25,
+  584, 582, 383,  27, 381,  26, 537, 382, 409, 266, 380, 263,
+  264, 267, 459, 265,  -1,  -1, 268,  -1, 272, 461,  -1, 410,
+  394, 391, 656,  -1, 392, 653, 654, 364, 458, 271, 460, 655,
+   -1,  -1,  -1, 322, 321, 393,  -1, 600,  -1,  -1, 598, 193,
+   -1,  -1,  -1, 597, 314,  -1, 313, 316, 318, 194, 315, 500,
+  203, 450,  -1, 319, 320, 204, 317, 599,  63,  64, 197, 198,
+  186, 195, 569, 641, 190, 200, 189, 191,  62,  65, 196, 199,
+  142, 188, 649, 187, 185, 648, 650, 192, 201, 621, 546, 554,
+  545, 544,  98, 505,  -1,  -1, 433, 436,  -1, 547, 434,  -1,
+   -1, 202,  -1, 407, 651,  -1,  -1,  -1, 475,  -1, 435, 389,
+  652,  -1, 444,  -1,  81,  -1,  -1,  -1,  -1, 401,  -1,  34,
+  161, 443,  11, 157,  31,  32, 524, 523, 442, 163, 164,  -1,
+  522, 525,  33, 112, 647, 326, 329, 325, 155, 441, 156, 327,
+  328, 162, 158, 330, 159, 331, 332, 160, 480, 421,  88, 165,
+  133, 607, 113, 168, 172, 134, 111, 323, 170, 114, 174, 601,
+  173, 167, 445, 132, 166, 131, 115, 100, 169, 171, 609,  -1,
+  608, 324, 462, 610,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1,  -1,  19,  -1,  20,  -1,  -1,  18,  -1,
+   -1,  -1,  -1,  21,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, 526,  -1,   8,  10,
+   -1,  -1,   9,   7, 118,  -1,  -1,  -1, 494,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+   -1, 575, 496, 130,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+   -1,  -1, 420,  66,  -1, 370,  -1,  -1,  72,  -1,  -1, 437,
+  646, 371, 499, 372, 175, 246,   0, 183, 412, 181, 254, 498,
+  253, 148, 180, 178,  -1, 497, 250, 184, 147, 176, 146, 177,
+   -1, 145, 248, 373, 247, 179, 252, 249, 245, 251, 432, 182,
+   -1, 486,  -1,  -1, 548,  -1, 515,  -1,  -1,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1,  -1, 481,  -1, 532,  -1,  -1,  49,  -1,
+   46, 562,  48,  -1, 560, 563,  -1, 561, 491,  -1,  -1,  -1,
+   47,  -1, 369, 390, 490,  -1, 485, 489, 488,  -1,  -1,  -1,
+  483, 543, 484,  -1,  82,  68, 606,  69, 302, 482,  67,  42,
+  301, 495,  44,  70, 298, 299, 297,  41, 117,  -1, 296,  43,
+   -1, 295, 294, 300,  -1,  83, 429, 293,  -1,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1,  -1,  -1,  -1, 573, 438,  -1,  -1, 574,
+  571,  -1,  -1,  91, 430,  90,  89, 572,  -1,  -1,  -1,  -1,
+  256,  76,  92, 440,  77,  -1, 428,  -1,  -1, 559, 564, 521,
+   -1,  -1,  74,  -1, 468, 396, 427,  75, 151, 303, 538, 466,
+  379, 549, 152, 479,  87, 150, 467, 153, 277, 307,  84, 304,
+  531, 282, 658, 465, 230, 308, 644, 643, 306, 310, 278, 487,
+  309,  -1,  -1, 657, 104, 276, 279,  86, 280, 232, 274, 469,
+  452, 273, 642, 102, 275, 225, 305, 645,  85, 231, 311,  30,
+   35, 281, 589, 229, 588, 587, 228, 226, 312, 103, 227, 101,
+  464, 590, 399,  -1, 398, 474,  -1, 397,  60, 233, 234,  -1,
+   -1,  -1,  -1,  -1, 418,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+   -1,  -1, 255,  29,  -1, 503, 502, 400, 501,  95,  96, 613,
+  612,  94, 614,  -1, 551, 615, 550,  97, 504,  -1,  -1, 552,
+   -1,  -1,  23,   4,   3, 553,   5,   2,  -1,  -1,  -1, 143,
+   -1,  -1,  -1,  -1, 527,  -1, 529, 361, 604, 141,  -1, 292,
+  108,  -1, 358, 530, 110, 357,  -1, 528, 362, 107, 356, 355,
+  603,   6, 109, 406, 354,  -1,  -1, 353, 605, 360,  -1,  -1,
+   -1, 478,  -1, 602,  -1,  -1,  -1,  -1, 290, 291,  -1, 395,
+   -1,  12,  -1, 286,  13, 154, 283,  15, 288,  14, 359,  78,
+  129, 124, 510, 284, 289, 285, 214, 287, 125,  -1, 209, 623,
+   36, 127,  37, 622, 206, 457, 625,  -1, 212, 624, 591,  38,
+  207, 210,  -1, 213,  -1, 415, 208, 144, 211,  39, 512, 205,
+  513,  -1, 581, 511,  -1,  -1, 413, 414, 514, 636, 634,  -1,
+   -1, 635, 126,  -1, 558, 416,  -1,  -1,  -1,  -1, 556,  -1,
+   -1, 632,  -1, 633,  -1,  -1,  -1,  -1, 557,  -1,  -1, 555,
+  426,  -1,  -1, 424, 423, 425, 594, 593, 631, 580,  51, 661,
+   -1,  -1, 422, 579, 578,  -1,  -1, 448, 592, 447, 446, 570,
+  595,  -1, 577,  53, 611,  52, 449,  -1,  54, 261, 105, 241,
+  239, 586, 404,  93, 403, 660, 417, 139, 236, 235, 384, 137,
+  138, 402, 237, 136, 626, 242, 405, 419, 663, 363, 240, 243,
+  238, 244, 662, 140, 439,  -1,  -1,  -1,  -1, 542,  -1,  -1,
+   22, 541,  -1, 539,  -1,  -1, 540,  58,  -1,  56,  -1,  -1,
+   -1,  59,  -1,  -1,  -1,  -1, 260,  57,  -1,  -1,  -1,  -1,
+  259, 257, 258,  -1,  -1, 533, 374,  73, 535, 536,  -1, 534,
+   -1,  -1,  -1,  79,  -1,  -1,  -1, 352,  -1, 351, 659,  -1,
+   -1, 664,  -1,  -1,  -1,  -1, 616, 345, 346, 367, 343, 344,
+  368,  -1, 350, 135,  -1, 347, 365, 493, 366,  -1, 378, 348,
+   -1, 385,  -1,  55, 387, 386,  -1,  99, 388, 520,  -1,  17,
+   -1,  -1,  -1,  -1, 349,  -1,  61,  -1, 517, 377, 568, 518,
+  565, 519, 566, 116,  -1,  -1,  -1, 376,  -1, 567,  -1,  50,
+  375,  -1,  -1,  40,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,
+  121, 122, 119,  -1,  -1,  -1, 338,  -1, 341,  -1,  -1,  -1,
+   -1,  -1,  -1,  -1, 220, 218,  -1,  -1, 619, 618,  -1, 617,
+  336, 620, 638,  -1, 335,   1, 508, 507, 453, 339, 454, 333,
+  431, 123, 334, 628, 219, 629, 337, 455, 516, 217, 120, 627,
+  106, 492, 506, 637, 215, 456, 340, 509,  24, 221, 216, 222,
+   71, 630, 639, 342
+};
@@ -249,7 +249,7 @@ _API_pencolorname (R___(Plotter *_plotter) const char *name)
   intgreen = _default_drawstate.fgcolor.green;
   intblue = _default_drawstate.fgcolor.blue;
 
-  if (_string_to_color (name, &color, _plotter->data->color_name_cache))
+  if (_string_to_color (name, &color))
     {
       unsigned int red, green, blue;
       
@@ -300,7 +300,7 @@ _API_fillcolorname (R___(Plotter *_plotter) const char *name)
   intgreen = _default_drawstate.fillcolor.green;
   intblue = _default_drawstate.fillcolor.blue;
 
-  if (_string_to_color (name, &color, _plotter->data->color_name_cache))
+  if (_string_to_color (name, &color))
     {
       unsigned int red, green, blue;
 
@@ -379,7 +379,7 @@ _API_bgcolorname (R___(Plotter *_plotter) const char *name)
   intgreen = _default_drawstate.bgcolor.green;
   intblue = _default_drawstate.bgcolor.blue;
 
-  if (_string_to_color (name, &color, _plotter->data->color_name_cache))
+  if (_string_to_color (name, &color))
     {
       unsigned int red, green, blue;
 
@@ -413,26 +413,22 @@ _API_bgcolorname (R___(Plotter *_plotter) const char *name)
    ignore spaces.  The retrieved RGB components are returned via a pointer.
 
    We don't wish to search through the entire (long) color database.  (It
-   contains 600+ color name strings.)  So any Plotter maintains a cache
-   of previously found colors. */
+   contains 600+ color name strings.)  So we compute the name's hash value,
+   which a precomputed perfect hash index in g_colorname.h maps to the one
+   entry in the database that could match. */
 
 bool
-_string_to_color (const char *name, plColor *color_p, plColorNameCache *color_name_cache)
+_string_to_color (const char *name, plColor *color_p)
 {
   plColor color;
-  plCachedColorNameInfo **cached_colors_p;
-  bool found = false;
-  char *squeezed_name, *nptr;
-  const plColorNameInfo *info, *found_info = NULL;
-  const char *optr;
-  plCachedColorNameInfo *cached_info;
+  const plColorNameInfo *info;
+  const char *optr, *iptr;
+  unsigned long hash;
+  int bucket, slot, index;
 
   if (name == NULL)		/* avoid core dumps */
     return false;
   
-  if (color_name_cache == NULL)	/* avoid core dumps */
-    return false;
-
   /* first check whether string is of the form "#ffffff" */
   if (string_to_precise_color (name, &color))
     {
@@ -440,74 +436,39 @@ _string_to_color (const char *name, plColor *color_p, plColorNameCache *color_na
       return true;
     }
 
-  /* copy string, removing spaces */
-  squeezed_name = (char *)_pl_xmalloc (strlen (name) + 1);
-  optr = name, nptr = squeezed_name;
-  while (*optr)
-    {
-      if (*optr == '\0')
-	break;
-      if (*optr != ' ')
-	*nptr++ = *optr;
-      optr++;
-    }
-  *nptr = '\0';
-
-  /* Search our list of cached, previously used color names, doing string
-     comparison.  If this were only for use by the X11 driver, we'd use
-     XrmPermStringToQuark to get a faster-compared representation. */
+  /* compute FNV-1a hash of the string, folding case and removing spaces */
+  hash = 2166136261UL;
+  for (optr = name; *optr; optr++)
+    if (*optr != ' ')
+      {
+	hash ^= (unsigned char)tolower ((unsigned char)*optr);
+	hash = (hash * 16777619UL) & 0xffffffffUL;
+      }
+
+  bucket = (int)(hash & (NUM_COLORNAME_BUCKETS - 1));
+  slot = (int)(((hash >> 8) ^ _pl_g_colorname_displacements[bucket])
+	       & (NUM_COLORNAME_SLOTS - 1));
+  index = _pl_g_colorname_slots[slot];
+  if (index < 0)
+    return false;
 
-  cached_colors_p = &color_name_cache->cached_colors;
-  cached_info = *cached_colors_p;
-  while (cached_info)
-    {
-      if (strcasecmp (cached_info->info->name, squeezed_name) == 0)
-	{
-	  found = true;
-	  found_info = cached_info->info;
-	  break;
-	}
-      cached_info = cached_info->next;
-    }
+  /* compare with the one candidate, in the same way */
+  info = &_pl_g_colornames[index];
+  for (optr = name, iptr = info->name; *optr; optr++)
+    if (*optr != ' ')
+      {
+	if (tolower ((unsigned char)*optr) != *iptr)
+	  return false;
+	iptr++;
+      }
+  if (*iptr != '\0')
+    return false;
 
-  if (!found)
-   /* not previously used, so search master colorname table (this is slower) */
-    {
-      info = _pl_g_colornames; /* start at head of list in g_colorname.h */
-      while (info->name)
-	{
-	  if (strcasecmp (info->name, squeezed_name) == 0)
-	    {
-	      found = true;
-	      found_info = info;
-	      break;
-	    }
-	  info++;
-	}
+  color_p->red = info->red;
+  color_p->green = info->green;
+  color_p->blue = info->blue;
 
-      if (found)
-	/* copy to head of cached color list */
-	{
-	  plCachedColorNameInfo *old_cached_colors, *cached_colors;
-
-	  old_cached_colors = *cached_colors_p;
-	  cached_colors = 
-	    (plCachedColorNameInfo *)_pl_xmalloc (sizeof (plCachedColorNameInfo));
-	  cached_colors->next = old_cached_colors;
-	  cached_colors->info = found_info;
-	  *cached_colors_p = cached_colors;
-	}
-    }
-  
-  free (squeezed_name);
-  if (found)
-    {
-      color_p->red = found_info->red;
-      color_p->green = found_info->green;
-      color_p->blue = found_info->blue;
-    }
-
-  return found;
+  return true;
 }
 
 /* Attempt to map a string to a 24-bit RGB; this will work if the string is
@@ -553,37 +514,3 @@ string_to_precise_color (const char *name, plColor *color_p)
 
   return (num_assigned == 3 ? true : false);
 }
-
-
-/* The cache of color names is currently implemented as a linked list. */
-
-plColorNameCache *
-_create_color_name_cache (void)
-{
-  plColorNameCache *new_cache;
-  
-  new_cache = (plColorNameCache *)_pl_xmalloc(sizeof(plColorNameCache));
-  new_cache->cached_colors = NULL;
-  return new_cache;
-}
-
-void 
-_delete_color_name_cache (plColorNameCache *color_name_cache)
-{
-  plCachedColorNameInfo *colorptr;
-
-  if (color_name_cache == (plColorNameCache *)NULL)
-    return;
-
-  colorptr = color_name_cache->cached_colors;
-  while (colorptr != NULL)	/* free linked list */
-    {
-      plCachedColorNameInfo *next_colorptr;
-      
-      next_colorptr = colorptr->next;
-      free (colorptr);
-      colorptr = next_colorptr;
-    }
-
-  free (color_name_cache);	/* free structure itself */
-}
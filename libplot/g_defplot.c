@@ -172,6 +172,11 @@ _pl_g_initialize (S___(Plotter *_plotter))
   _plotter->data->page = (plOutbuf *)NULL;
   _plotter->data->first_page = (plOutbuf *)NULL;  
 
+  /* no discarded paths kept for reuse yet (see g_subpaths.c) */
+  _plotter->data->num_spare_paths = 0;
+  _plotter->data->flattened_vertices = 0;
+  _plotter->data->decimated_vertices = 0;
+
   /* basic data members, will not differ in derived classes */
   _plotter->data->open = false;
   _plotter->data->opened = false;
@@ -212,6 +217,11 @@ _pl_g_initialize (S___(Plotter *_plotter))
 
   /* path-related parameters (also internal) */
   _plotter->data->max_unfilled_path_length = PL_MAX_UNFILLED_PATH_LENGTH;
+  _plotter->data->page_memory_limit = 0;
+  _plotter->data->flatness = 0.0;
+  _plotter->data->report_stats = false;
+  _plotter->data->cull_paths = false;
+  _plotter->data->decimation = 0.0;
   _plotter->data->have_mixed_paths = false;
   _plotter->data->allowed_arc_scaling = AS_NONE;
   _plotter->data->allowed_ellarc_scaling = AS_NONE;  
@@ -241,9 +251,6 @@ _pl_g_initialize (S___(Plotter *_plotter))
   /* compute the NDC to device-frame affine map, set it in Plotter */
   _compute_ndc_to_device_map (_plotter->data);
 
-  /* create, initialize cache of color name -> RGB correspondences */
-  _plotter->data->color_name_cache = _create_color_name_cache ();
-
   /* initialize certain data members from values of relevant device
      driver parameters */
 
@@ -252,7 +259,7 @@ _pl_g_initialize (S___(Plotter *_plotter))
     const char *emulate_s;
 
     emulate_s = (const char *)_get_plot_param (_plotter->data, 
-					       "EMULATE_COLOR");
+					       PL_PARAM_EMULATE_COLOR);
     if (strcmp (emulate_s, "yes") == 0)
       _plotter->data->emulate_color = true;
     else 
@@ -266,15 +273,106 @@ _pl_g_initialize (S___(Plotter *_plotter))
     int local_length;
 	
     length_s = (const char *)_get_plot_param (_plotter->data, 
-					      "MAX_LINE_LENGTH");
+					      PL_PARAM_MAX_LINE_LENGTH);
 
     if (sscanf (length_s, "%d", &local_length) <= 0 || local_length <= 0)
       {
-	length_s = (const char *)_get_default_plot_param ("MAX_LINE_LENGTH");
+	length_s = (const char *)_get_default_plot_param (PL_PARAM_MAX_LINE_LENGTH);
 	sscanf (length_s, "%d", &local_length);
       }
     _plotter->data->max_unfilled_path_length = local_length;
   }
+
+  /* set maximum amount of memory in which the graphics on each page are
+     kept (relevant to Plotters that do not do real time output); beyond
+     it, completed portions of a page are moved to a temporary file */
+  {
+    const char *limit_s;
+    unsigned long local_limit, multiplier;
+    char suffix;
+    int num_read;
+
+    limit_s = (const char *)_get_plot_param (_plotter->data, 
+					     PL_PARAM_PAGE_MEMORY_LIMIT);
+    num_read = sscanf (limit_s, "%lu%c", &local_limit, &suffix);
+    if (num_read <= 0)
+      local_limit = 0;		/* no limit */
+    else if (num_read == 2)
+      {
+	switch (suffix)
+	  {
+	  case 'k': case 'K':
+	    multiplier = 1024;
+	    break;
+	  case 'm': case 'M':
+	    multiplier = 1024 * 1024;
+	    break;
+	  case 'g': case 'G':
+	    multiplier = 1024 * 1024 * 1024;
+	    break;
+	  default:
+	    multiplier = 1;
+	    break;
+	  }
+	if (local_limit > ULONG_MAX / multiplier)
+	  local_limit = ULONG_MAX;
+	else
+	  local_limit *= multiplier;
+      }
+    _plotter->data->page_memory_limit = local_limit;
+  }
+
+  /* set tolerance, in device coordinates, to which curves are flattened
+     into polylines (relevant to Plotters that cannot draw curves); zero
+     means they are subdivided a fixed number of times */
+  {
+    const char *flatness_s;
+    double local_flatness;
+
+    flatness_s = (const char *)_get_plot_param (_plotter->data, 
+						PL_PARAM_FLATNESS);
+    if (sscanf (flatness_s, "%lf", &local_flatness) <= 0 
+	|| local_flatness <= 0.0)
+      local_flatness = 0.0;
+    _plotter->data->flatness = local_flatness;
+  }
+
+  /* determine whether paths that lie off the page are to be discarded,
+     and long polylines trimmed, by endpath() */
+  {
+    const char *cull_paths_s;
+
+    cull_paths_s = (const char *)_get_plot_param (_plotter->data, 
+						  PL_PARAM_CULL_PATHS);
+    if (strcasecmp (cull_paths_s, "yes") == 0)
+      _plotter->data->cull_paths = true;
+  }
+
+  /* set width, in device coordinates, of the columns into which the
+     device frame is divided when decimating polylines; zero means they
+     are not decimated */
+  {
+    const char *decimation_s;
+    double local_decimation;
+
+    decimation_s = (const char *)_get_plot_param (_plotter->data, 
+						  PL_PARAM_DECIMATION);
+    if (sscanf (decimation_s, "%lf", &local_decimation) <= 0 
+	|| local_decimation <= 0.0)
+      local_decimation = 0.0;
+    _plotter->data->decimation = local_decimation;
+  }
+
+  /* determine whether statistics are to be reported at closepl() time
+     (bitmap Plotters also report on rasterizing each page or frame) */
+  {
+    const char *report_stats_s;
+
+    report_stats_s = (const char *)_get_plot_param (_plotter->data, 
+						    PL_PARAM_REPORT_STATS);
+    if (strcasecmp (report_stats_s, "yes") == 0)
+      _plotter->data->report_stats = true;
+  }
       
   /* Ensure widths of labels rendered in the Stick fonts are correctly
      computed.  This is a kludge (in pre-HP-GL/2, Stick fonts were kerned;
@@ -283,7 +381,7 @@ _pl_g_initialize (S___(Plotter *_plotter))
     const char *version_s;
 
     version_s = (const char *)_get_plot_param (_plotter->data, 
-					       "HPGL_VERSION");
+					       PL_PARAM_HPGL_VERSION);
     if (strcmp (version_s, "2") == 0) /* modern HP-GL/2 (default) */
       _plotter->data->kern_stick_fonts = false;
     else if (strcmp (version_s, "1.5") == 0) /* HP7550A */
@@ -327,9 +425,6 @@ _pl_g_terminate (S___(Plotter *_plotter))
   /* free instance-specific copies of class parameters */
   _pl_g_free_params_in_plotter (S___(_plotter));
 
-  /* free color name cache */
-  _delete_color_name_cache (_plotter->data->color_name_cache);
-
   /* remove Plotter from sparse Plotter array */
 
 #ifdef PTHREAD_SUPPORT
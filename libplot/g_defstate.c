@@ -119,6 +119,10 @@ const plDrawState _default_drawstate = {
   0.0,				/* default line width in user coordinates */
   0.0,				/* default font size in user coordinates */
 
+/* FLATNESS parameter, converted to user coordinates (also set by
+   fsetmatrix()) */
+  0.0,				/* tolerance for flattening curves */
+
 /****************** DEVICE-DEPENDENT PART ***************************/
 
 /* elements specific to the HP-GL drawing state [DUMMY] */
@@ -77,7 +77,8 @@ _API_fellipse (R___(Plotter *_plotter) double xc, double yc, double rx, double r
 	aligned_ellipse = true;
       
       /* begin a new path */
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
 
       /* place ellipse in path buffer */
 
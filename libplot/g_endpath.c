@@ -33,9 +33,37 @@
 
 /* This file also contains the endsubpath() and closepath() methods. */
 
+/* If the CULL_PATHS parameter is "yes", endpath() first discards any
+   simple path that lies entirely off the page, and splits any long
+   unfilled polyline into the runs of its segments that come near the
+   page, so that off-page geometry never reaches paint_path().  Each
+   simple path is tested by mapping its bounding box to the NDC frame and
+   comparing it with the page, enlarged by a margin that covers the
+   widest line join or cap.  Since a simple path affects the fill of a
+   compound path only within its own bounding box, and a run of segments
+   is broken only at a vertex that is outside the enlarged page, what is
+   drawn on the page is unchanged. */
+
 #include "sys-defines.h"
 #include "extern.h"
 
+/* extra margin around the page, in NDC units (i.e., as a fraction of the
+   viewport size), allowing for device-dependent minimum line widths */
+#define CULL_FUZZ 0.01
+
+/* bits in the outcode of a point, relative to a rectangle */
+#define OUT_LEFT 1
+#define OUT_RIGHT 2
+#define OUT_BOTTOM 4
+#define OUT_TOP 8
+
+static bool _compute_cull_rect (const plPlotterData *data, const plDrawState *drawstate, double rect[4]);
+static bool _path_is_visible (const plPath *path, const double m[6], const double rect[4]);
+static int _outcode (double x, double y, const double rect[4]);
+static bool _segment_meets_rect (double x0, double y0, double x1, double y1, const double rect[4]);
+static int _trim_path (plPlotterData *data, const plPath *path, const double m[6], const double rect[4], plPath ***pieces);
+static void _cull_paths (plPlotterData *data, plDrawState *drawstate);
+
 int
 _API_endpath (S___(Plotter *_plotter))
 {
@@ -113,10 +141,10 @@ _API_endpath (S___(Plotter *_plotter))
 
 	      /* check for closure */
 	      if ((path->num_segments >= 3)
-		  && (path->segments[path->num_segments - 1].p.x == 
-		      path->segments[0].p.x)
-		  && (path->segments[path->num_segments - 1].p.y == 
-		      path->segments[0].p.y))
+		  && (path->points[path->num_segments - 1].x == 
+		      path->points[0].x)
+		  && (path->points[path->num_segments - 1].y == 
+		      path->points[0].y))
 		closed = true;
 	      else
 		closed = false;		/* 2-point ones should be open */
@@ -124,12 +152,12 @@ _API_endpath (S___(Plotter *_plotter))
 	      /* draw each point as a filled circle, diameter = line width */
 	      for (j = 0; j < path->num_segments - (closed ? 1 : 0); j++)
 		_API_fcircle (R___(_plotter)
-			      path->segments[j].p.x, 
-			      path->segments[j].p.y, 
+			      path->points[j].x, 
+			      path->points[j].y, 
 			      radius);
 	      if (closed)
 		/* restore graphics cursor */
-		_plotter->drawstate->pos = path->segments[0].p;
+		_plotter->drawstate->pos = path->points[0];
 	    }
 	  
 	  /* Restore graphics state.  This will first do a recursive
@@ -148,6 +176,31 @@ _API_endpath (S___(Plotter *_plotter))
   else
     /* normal case: line mode isn't disconnected, so no contortions needed */
     {
+      if (_plotter->data->cull_paths)
+	/* discard or trim simple paths that are (partly) off the page */
+	_cull_paths (_plotter->data, _plotter->drawstate);
+
+      if (_plotter->data->decimation > 0.0
+	  && _plotter->drawstate->fill_type == 0
+	  && _plotter->drawstate->line_type == PL_L_SOLID
+	  && !_plotter->drawstate->dash_array_in_effect)
+	/* Thin out the vertices of dense polylines, in the device frame.
+	   Not done for filled paths, since it would change the filled
+	   region, or for dashed lines, since it would shift the dashes.
+	   For a wide line with mitered joins, it is done only if no join
+	   that it removes or sharpens has a miter spike reaching further
+	   than the tolerance beyond the line.  (Zero-width lines, which
+	   libxmi draws one pixel wide without joins, have no spikes.) */
+	for (i = 0; i < _plotter->drawstate->num_paths; i++)
+	  _plotter->data->decimated_vertices += 
+	    _decimate_path (_plotter->drawstate->paths[i],
+			    _plotter->drawstate->transform.m,
+			    _plotter->data->decimation,
+			    _plotter->drawstate->join_type == PL_JOIN_MITER
+			    ? 0.5 * _plotter->drawstate->device_line_width
+			    : 0.0,
+			    _plotter->drawstate->miter_limit);
+
       if (_plotter->drawstate->num_paths == 1)
 	/* compound path is just a single simple path, so paint it by
 	   calling the Plotter-specific paint_path() method (the painting
@@ -157,7 +210,7 @@ _API_endpath (S___(Plotter *_plotter))
 	  _plotter->paint_path (S___(_plotter));
 	  _plotter->drawstate->path = (plPath *)NULL;
 	}
-      else
+      else if (_plotter->drawstate->num_paths > 1)
 	/* compound path comprises more than one simple path */
 	{
 	  /* first, attempt to use Plotter-specific support for painting
@@ -196,8 +249,9 @@ _API_endpath (S___(Plotter *_plotter))
 		      _plotter->drawstate->path = merged_paths[i];
 		      _plotter->paint_path (S___(_plotter));
 		      if (merged_paths[i] != _plotter->drawstate->paths[i])
-			_delete_plPath (merged_paths[i]);
+			_recycle_plPath (_plotter->data, merged_paths[i]);
 		    }
+		  free (merged_paths);
 		  _plotter->drawstate->path = (plPath *)NULL;
 		}
 	      
@@ -224,7 +278,7 @@ _API_endpath (S___(Plotter *_plotter))
   
   /* compound path is now painted, so remove it from paths buffer */
   for (i = 0; i < _plotter->drawstate->num_paths; i++)
-    _delete_plPath (_plotter->drawstate->paths[i]);
+    _recycle_plPath (_plotter->data, _plotter->drawstate->paths[i]);
   free (_plotter->drawstate->paths);
   _plotter->drawstate->paths = (plPath **)NULL;
   _plotter->drawstate->num_paths = 0;
@@ -278,3 +332,372 @@ _API_closepath (S___(Plotter *_plotter))
 }
 
 
+
+/* Compute the rectangle, in the NDC frame, outside of which nothing that
+   is drawn can be seen: the page (or for a Plotter with a virtual
+   display, the viewport), enlarged by the maximum distance from a path
+   to the edge of its stroke, and by CULL_FUZZ.  Return false if the page
+   is of unknown size. */
+static bool
+_compute_cull_rect (const plPlotterData *data, const plDrawState *drawstate, double rect[4])
+{
+  double min_sing_val, max_sing_val, margin;
+
+  if (data->display_model_type == (int)DISP_MODEL_PHYSICAL)
+    /* The page may extend beyond the viewport.  Express its edges in NDC
+       units; since the NDC frame may have been rotated about the center
+       of the viewport (see the ROTATION parameter), take the smallest
+       square centered there that contains the page. */
+    {
+      double xorigin, yorigin, half_size;
+
+      if (data->page_data == (const plPageData *)NULL
+	  || data->viewport_xsize <= 0.0 || data->viewport_ysize <= 0.0)
+	return false;
+      xorigin = data->viewport_xorigin + data->viewport_xoffset;
+      yorigin = data->viewport_yorigin + data->viewport_yoffset;
+      half_size = DMAX(DMAX(0.5 + xorigin / data->viewport_xsize,
+			    (data->page_data->xsize - xorigin) 
+			    / data->viewport_xsize - 0.5),
+		       DMAX(0.5 + yorigin / data->viewport_ysize,
+			    (data->page_data->ysize - yorigin) 
+			    / data->viewport_ysize - 0.5));
+      rect[0] = 0.5 - half_size;
+      rect[1] = 0.5 - half_size;
+      rect[2] = 0.5 + half_size;
+      rect[3] = 0.5 + half_size;
+    }
+  else
+    /* the viewport is the entire display */
+    {
+      rect[0] = 0.0;
+      rect[1] = 0.0;
+      rect[2] = 1.0;
+      rect[3] = 1.0;
+    }
+
+  /* A stroke extends at most half the line width from the path, except
+     at projecting caps and mitered joins; the line width in the NDC frame
+     is at most the user-frame width times the larger singular value. */
+  margin = 0.5 * drawstate->line_width;
+  if (drawstate->join_type == PL_JOIN_MITER)
+    margin *= DMAX(drawstate->miter_limit, M_SQRT2);
+  else
+    margin *= M_SQRT2;
+  _matrix_sing_vals (drawstate->transform.m_user_to_ndc, 
+		     &min_sing_val, &max_sing_val);
+  margin = margin * max_sing_val + CULL_FUZZ;
+
+  rect[0] -= margin;
+  rect[1] -= margin;
+  rect[2] += margin;
+  rect[3] += margin;
+
+  return true;
+}
+
+/* Test whether a simple path may be visible, i.e., whether its bounding
+   box, mapped by m to the NDC frame, meets the rectangle rect.  The
+   bounding box stored in a path covers only its juncture points, so the
+   curves and closed primitives in it are allowed for here. */
+static bool
+_path_is_visible (const plPath *path, const double m[6], const double rect[4])
+{
+  double llx, lly, urx, ury;
+  double x[4], y[4], nllx, nlly, nurx, nury;
+  int i;
+
+  switch ((int)path->type)
+    {
+    case (int)PATH_SEGMENT_LIST:
+      llx = path->llx, lly = path->lly, urx = path->urx, ury = path->ury;
+      for (i = 0; i < path->num_curves; i++)
+	{
+	  const plPathCurve *curve = &path->curves[i];
+	  plPoint p0, p1;
+	  double rx, ry;
+
+	  switch ((int)curve->type)
+	    {
+	    case (int)S_ARC:	/* whole circle */
+	      p1 = path->points[curve->index];
+	      rx = ry = sqrt ((p1.x - curve->pc.x) * (p1.x - curve->pc.x)
+			      + (p1.y - curve->pc.y) * (p1.y - curve->pc.y));
+	      break;
+	    case (int)S_ELLARC:	/* whole ellipse, with conjugate radii */
+	      p0 = path->points[curve->index - 1];
+	      p1 = path->points[curve->index];
+	      rx = (fabs (p0.x - curve->pc.x) + fabs (p1.x - curve->pc.x));
+	      ry = (fabs (p0.y - curve->pc.y) + fabs (p1.y - curve->pc.y));
+	      break;
+	    case (int)S_CUBIC:	/* control points */
+	      llx = DMIN(llx, curve->pd.x);
+	      lly = DMIN(lly, curve->pd.y);
+	      urx = DMAX(urx, curve->pd.x);
+	      ury = DMAX(ury, curve->pd.y);
+	      rx = ry = 0.0;
+	      break;
+	    case (int)S_QUAD:
+	      rx = ry = 0.0;
+	      break;
+	    default:		/* closepath */
+	      continue;
+	    }
+	  llx = DMIN(llx, curve->pc.x - rx);
+	  lly = DMIN(lly, curve->pc.y - ry);
+	  urx = DMAX(urx, curve->pc.x + rx);
+	  ury = DMAX(ury, curve->pc.y + ry);
+	}
+      break;
+    case (int)PATH_CIRCLE:
+      llx = path->pc.x - path->radius;
+      lly = path->pc.y - path->radius;
+      urx = path->pc.x + path->radius;
+      ury = path->pc.y + path->radius;
+      break;
+    case (int)PATH_ELLIPSE:
+      llx = path->pc.x - DMAX(path->rx, path->ry);
+      lly = path->pc.y - DMAX(path->rx, path->ry);
+      urx = path->pc.x + DMAX(path->rx, path->ry);
+      ury = path->pc.y + DMAX(path->rx, path->ry);
+      break;
+    case (int)PATH_BOX:
+      llx = path->llx, lly = path->lly, urx = path->urx, ury = path->ury;
+      break;
+    default:			/* shouldn't happen */
+      return true;
+    }
+
+  if (llx > urx || lly > ury)
+    /* empty path; leave it to the Plotter */
+    return true;
+
+  /* map corners of bounding box to NDC frame */
+  x[0] = llx, y[0] = lly;
+  x[1] = urx, y[1] = lly;
+  x[2] = urx, y[2] = ury;
+  x[3] = llx, y[3] = ury;
+  nllx = nlly = DBL_MAX;
+  nurx = nury = -(DBL_MAX);
+  for (i = 0; i < 4; i++)
+    {
+      double nx = m[0] * x[i] + m[2] * y[i] + m[4];
+      double ny = m[1] * x[i] + m[3] * y[i] + m[5];
+
+      nllx = DMIN(nllx, nx);
+      nlly = DMIN(nlly, ny);
+      nurx = DMAX(nurx, nx);
+      nury = DMAX(nury, ny);
+    }
+
+  return (nurx >= rect[0] && nllx <= rect[2]
+	  && nury >= rect[1] && nlly <= rect[3]);
+}
+
+/* Cohen-Sutherland outcode of a point, relative to a rectangle */
+static int
+_outcode (double x, double y, const double rect[4])
+{
+  int code = 0;
+
+  if (x < rect[0])
+    code |= OUT_LEFT;
+  else if (x > rect[2])
+    code |= OUT_RIGHT;
+  if (y < rect[1])
+    code |= OUT_BOTTOM;
+  else if (y > rect[3])
+    code |= OUT_TOP;
+
+  return code;
+}
+
+/* Test whether a line segment meets a rectangle.  Most segments are
+   accepted or rejected by their endpoints' outcodes; the rest are clipped
+   by the Liang-Barsky method. */
+static bool
+_segment_meets_rect (double x0, double y0, double x1, double y1, const double rect[4])
+{
+  int code0, code1, i;
+  double dx, dy, t0 = 0.0, t1 = 1.0;
+
+  code0 = _outcode (x0, y0, rect);
+  code1 = _outcode (x1, y1, rect);
+  if (code0 == 0 || code1 == 0)
+    return true;
+  if (code0 & code1)
+    return false;
+
+  dx = x1 - x0;
+  dy = y1 - y0;
+  for (i = 0; i < 4; i++)
+    {
+      double p, q;
+
+      switch (i)
+	{
+	case 0: p = -dx; q = x0 - rect[0]; break;
+	case 1: p = dx; q = rect[2] - x0; break;
+	case 2: p = -dy; q = y0 - rect[1]; break;
+	default: p = dy; q = rect[3] - y0; break;
+	}
+      if (p == 0.0)
+	{
+	  if (q < 0.0)
+	    return false;
+	}
+      else
+	{
+	  double t = q / p;
+
+	  if (p < 0.0)
+	    t0 = DMAX(t0, t);
+	  else
+	    t1 = DMIN(t1, t);
+	  if (t0 > t1)
+	    return false;
+	}
+    }
+
+  return true;
+}
+
+/* Split a polyline into the runs of its segments that meet the rectangle
+   rect (in the NDC frame, to which m maps the user frame).  If every
+   segment meets it, return 0.  Otherwise return the number of runs, and
+   an array of new paths, one per run, in *pieces.
+
+   Each run ends where a dropped segment begins, at a vertex outside rect.
+   Since rect was enlarged by the reach of a join or cap (see above), the
+   cap that replaces the join there can't be seen.  But if the polyline is
+   closed, the join at its first (and last) vertex must be kept.  So we
+   walk a closed polyline cyclically, starting just after a dropped
+   segment, and the run that contains that vertex passes through it. */
+static int
+_trim_path (plPlotterData *data, const plPath *path, const double m[6], const double rect[4], plPath ***pieces)
+{
+  unsigned char *visible;
+  double x0, y0;
+  int i, k, start = 0, num_dropped = 0, num_pieces = 0;
+  plPath *piece = (plPath *)NULL;
+
+  visible = (unsigned char *)_pl_xmalloc (path->num_segments);
+  x0 = m[0] * path->points[0].x + m[2] * path->points[0].y + m[4];
+  y0 = m[1] * path->points[0].x + m[3] * path->points[0].y + m[5];
+  for (i = 1; i < path->num_segments; i++)
+    {
+      double x1 = m[0] * path->points[i].x + m[2] * path->points[i].y + m[4];
+      double y1 = m[1] * path->points[i].x + m[3] * path->points[i].y + m[5];
+
+      visible[i] = _segment_meets_rect (x0, y0, x1, y1, rect);
+      if (!visible[i])
+	{
+	  num_dropped++;
+	  start = i;
+	}
+      x0 = x1;
+      y0 = y1;
+    }
+
+  if (num_dropped == 0)
+    {
+      free (visible);
+      return 0;
+    }
+
+  /* unless polyline is closed, walk it from its first segment */
+  if (path->points[0].x != path->points[path->num_segments - 1].x
+      || path->points[0].y != path->points[path->num_segments - 1].y)
+    start = 0;
+
+  *pieces = (plPath **)_pl_xmalloc ((path->num_segments / 2 + 1)
+				    * sizeof (plPath *));
+  for (k = 1; k < path->num_segments; k++)
+    {
+      /* segment i joins points[i - 1] and points[i] */
+      i = (start + k - 1) % (path->num_segments - 1) + 1;
+      if (!visible[i])
+	{
+	  piece = (plPath *)NULL;
+	  continue;
+	}
+      if (piece == (plPath *)NULL)
+	{
+	  piece = _reuse_plPath (data, path->flatness);
+	  piece->primitive = path->primitive;
+	  _add_moveto (piece, path->points[i - 1]);
+	  (*pieces)[num_pieces++] = piece;
+	}
+      _add_line (piece, path->points[i]);
+    }
+  free (visible);
+
+  return num_pieces;
+}
+
+/* Discard the simple paths in the paths buffer that can't be seen, and
+   if the compound path is to be edged with a solid line but not filled,
+   trim each polyline in it (see above). */
+static void
+_cull_paths (plPlotterData *data, plDrawState *drawstate)
+{
+  double rect[4];
+  const double *m = drawstate->transform.m_user_to_ndc;
+  plPath **paths;
+  int i, num_paths = 0, num_paths_len;
+  bool trim;
+
+  if (!_compute_cull_rect (data, drawstate, rect))
+    return;
+
+  trim = (drawstate->fill_type == 0 && drawstate->pen_type != 0
+	  && drawstate->line_type == PL_L_SOLID
+	  && !drawstate->dash_array_in_effect);
+
+  num_paths_len = drawstate->num_paths;
+  paths = (plPath **)_pl_xmalloc (num_paths_len * sizeof (plPath *));
+  for (i = 0; i < drawstate->num_paths; i++)
+    {
+      plPath *path = drawstate->paths[i], **pieces;
+      int num_pieces;
+
+      if (!_path_is_visible (path, m, rect))
+	{
+	  _recycle_plPath (data, path);
+	  continue;
+	}
+
+      if (trim && path->type == PATH_SEGMENT_LIST && path->num_curves == 0
+	  && path->num_segments > 2
+	  && (num_pieces = _trim_path (data, path, m, rect, &pieces)) > 0)
+	/* replace polyline by runs of its segments */
+	{
+	  int j;
+
+	  if (num_paths + num_pieces > num_paths_len)
+	    {
+	      num_paths_len = num_paths + num_pieces 
+		+ (drawstate->num_paths - i - 1);
+	      paths = (plPath **)_pl_xrealloc (paths, 
+					       num_paths_len 
+					       * sizeof (plPath *));
+	    }
+	  for (j = 0; j < num_pieces; j++)
+	    paths[num_paths++] = pieces[j];
+	  free (pieces);
+	  _recycle_plPath (data, path);
+	  continue;
+	}
+
+      paths[num_paths++] = path;
+    }
+
+  free (drawstate->paths);
+  if (num_paths == 0)
+    {
+      free (paths);
+      paths = (plPath **)NULL;
+    }
+  drawstate->paths = paths;
+  drawstate->num_paths = num_paths;
+}
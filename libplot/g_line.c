@@ -107,7 +107,8 @@ _API_fcont (R___(Plotter *_plotter) double x, double y)
   if (_plotter->drawstate->path == (plPath *)NULL)
     /* begin a new path, of segment list type */
     {
-      _plotter->drawstate->path = _new_plPath ();
+      _plotter->drawstate->path =
+	_reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
       prev_num_segments = 0;
       _add_moveto (_plotter->drawstate->path, p0);
     }
@@ -147,6 +148,93 @@ _API_fcont (R___(Plotter *_plotter) double x, double y)
   return 0;
 }
 
+/* fpolyline() is equivalent to invoking fcont() on each of the n points
+   (x[i],y[i]) in turn, but does the per-call work (checking for a
+   primitive, growing the segment buffer, updating the bounding box,
+   prepainting, and testing whether the path has grown too long) once per
+   run of points rather than once per point.  A run ends only where the
+   path would have been flushed out by fcont(), so the Plotter sees
+   exactly the same sequence of paths. */
+
+int
+_API_fpolyline (R___(Plotter *_plotter) int n, const double *x, const double *y)
+{
+  int prev_num_segments, num_to_add;
+  bool flushable;
+
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter)
+		       "fpolyline: invalid operation");
+      return -1;
+    }
+
+  /* sanity checks */
+  if (n < 0 || (n > 0 && (x == NULL || y == NULL)))
+    return -1;
+  if (n == 0)
+    return 0;
+
+  if (_plotter->drawstate->path != (plPath *)NULL
+      && (_plotter->drawstate->path->type != PATH_SEGMENT_LIST
+	  ||
+	  (_plotter->drawstate->path->type == PATH_SEGMENT_LIST
+	   && _plotter->drawstate->path->primitive)))
+    /* flush out the compound path, as in fcont() */
+    _API_endpath (S___(_plotter));
+
+  while (n > 0)
+    {
+      if (_plotter->drawstate->path == (plPath *)NULL)
+	/* begin a new path, of segment list type */
+	{
+	  _plotter->drawstate->path =
+	    _reuse_plPath (_plotter->data, _plotter->drawstate->flatness);
+	  prev_num_segments = 0;
+	  _add_moveto (_plotter->drawstate->path, _plotter->drawstate->pos);
+	}
+      else
+	prev_num_segments = _plotter->drawstate->path->num_segments;
+
+      /* if segment buffer is occupied by a single arc, replace arc by a
+	 polyline if that's called for (Plotter-dependent) */
+      if (_plotter->data->have_mixed_paths == false
+	  && _plotter->drawstate->path->num_segments == 2)
+	{
+	  _pl_g_maybe_replace_arc (S___(_plotter));
+	  if (_plotter->drawstate->path->num_segments > 2)
+	    prev_num_segments = 0;
+	}
+
+      /* add as many points as will fit before the path would be flushed */
+      flushable = (_plotter->drawstate->fill_type == 0
+		   && _plotter->path_is_flushable (S___(_plotter)));
+      num_to_add = n;
+      if (flushable)
+	num_to_add = IMIN(n, IMAX(1, _plotter->data->max_unfilled_path_length
+				  - _plotter->drawstate->path->num_segments));
+
+      _add_lines (_plotter->drawstate->path, num_to_add, x, y);
+
+      /* move to endpoint */
+      _plotter->drawstate->pos.x = x[num_to_add - 1];
+      _plotter->drawstate->pos.y = y[num_to_add - 1];
+
+      _plotter->maybe_prepaint_segments (R___(_plotter) prev_num_segments);
+
+      if (flushable
+	  && (_plotter->drawstate->path->num_segments
+	      >= _plotter->data->max_unfilled_path_length))
+	_API_endpath (S___(_plotter));
+
+      x += num_to_add;
+      y += num_to_add;
+      n -= num_to_add;
+    }
+
+  return 0;
+}
+
 /* Some Plotters, such as FigPlotters, support the drawing of single arc
    segments as primitives, but they don't allow mixed segment lists to
    appear in the path storage buffer, because they don't know how to handle
@@ -169,15 +257,15 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 	&& _plotter->drawstate->path->num_segments == 2))
     return;
 
-  switch (_plotter->drawstate->path->segments[1].type)
+  switch (_path_segment_type (_plotter->drawstate->path, 1))
     {
       plPoint pc, pd, p1;
       
     case S_ARC:
       /* segment buffer contains a single circular arc segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
-      _plotter->drawstate->path->num_segments = 1;
+      pc = _path_curve (_plotter->drawstate->path, 1)->pc;
+      p1 = _plotter->drawstate->path->points[1];
+      _truncate_plPath (_plotter->drawstate->path, 1);
 
       /* add polygonal approximation to circular arc to the segment buffer */
       _add_arc_as_lines (_plotter->drawstate->path, pc, p1);
@@ -185,9 +273,9 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
       
     case S_ELLARC:
       /* segment buffer contains a single elliptic arc segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
-      _plotter->drawstate->path->num_segments = 1;
+      pc = _path_curve (_plotter->drawstate->path, 1)->pc;
+      p1 = _plotter->drawstate->path->points[1];
+      _truncate_plPath (_plotter->drawstate->path, 1);
 
       /* add polygonal approximation to elliptic arc to the segment buffer */
       _add_ellarc_as_lines (_plotter->drawstate->path, pc, p1);
@@ -195,9 +283,9 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 
     case S_QUAD:
       /* segment buffer contains a single quad. Bezier segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      p1 = _plotter->drawstate->path->segments[1].p;
-      _plotter->drawstate->path->num_segments = 1;
+      pc = _path_curve (_plotter->drawstate->path, 1)->pc;
+      p1 = _plotter->drawstate->path->points[1];
+      _truncate_plPath (_plotter->drawstate->path, 1);
 
       /* add polygonal approximation to quad. Bezier to the segment buffer */
       _add_bezier2_as_lines (_plotter->drawstate->path, pc, p1);
@@ -205,10 +293,10 @@ _pl_g_maybe_replace_arc (S___(Plotter *_plotter))
 
     case S_CUBIC:
       /* segment buffer contains a single cubic Bezier segment, so remove it */
-      pc = _plotter->drawstate->path->segments[1].pc;
-      pd = _plotter->drawstate->path->segments[1].pd;
-      p1 = _plotter->drawstate->path->segments[1].p;
-      _plotter->drawstate->path->num_segments = 1;
+      pc = _path_curve (_plotter->drawstate->path, 1)->pc;
+      pd = _path_curve (_plotter->drawstate->path, 1)->pd;
+      p1 = _plotter->drawstate->path->points[1];
+      _truncate_plPath (_plotter->drawstate->path, 1);
 
       /* add polygonal approximation to cubic Bezier to the segment buffer */
       _add_bezier3_as_lines (_plotter->drawstate->path, pc, pd, p1);
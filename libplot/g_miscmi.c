@@ -16,10 +16,12 @@
    the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
    Boston, MA 02110-1301, USA. */
 
-/* This file contains a function called by Bitmap Plotters (including PNM
-   Plotters), and GIF Plotters, just before drawing.  It sets the
+/* This file contains functions called by Bitmap Plotters (including PNM
+   Plotters), and GIF Plotters, when drawing.  The first sets the
    attributes in the graphics context (of type `miGC') used by the libxmi
-   scan conversion routines. */
+   scan conversion routines.  The second draws a path with anti-aliasing,
+   by passing it to libxmi's anti-aliased drawing functions.  The third
+   reports on the storage used by libxmi in rasterizing a page. */
 
 #include "sys-defines.h"
 #include "extern.h"
@@ -186,3 +188,204 @@ _set_common_mi_attributes (plDrawState *drawstate, void * ptr)
   if (dash_array_allocated)
     free (dashbuf);
 }
+
+/* maximum distance, in pixels, between a flattened arc and the true arc
+   when drawing with anti-aliasing */
+#define MI_AA_ARC_FLATNESS 0.1
+
+/* Flatten an elliptic arc, i.e. the set of points pc + u cos t + v sin t
+   for t in [theta0,theta0+range], into an array of points in device
+   coordinates.  Since the user->device map is affine, the flattening may
+   be done in the user frame, whatever the map. */
+static miDoublePoint *
+_flatten_mi_aa_arc (plDrawState *drawstate, plPoint pc, plVector u, plVector v, double theta0, double range, int *npoints)
+{
+  double *m = drawstate->transform.m;
+  miDoublePoint *points;
+  double min_sing_val, max_sing_val, radius, step;
+  int i, n;
+
+  /* bound the radius of the arc in the device frame */
+  _matrix_sing_vals (m, &min_sing_val, &max_sing_val);
+  radius = max_sing_val * sqrt (u.x * u.x + u.y * u.y + v.x * v.x + v.y * v.y);
+  if (radius > MI_AA_ARC_FLATNESS)
+    step = 2.0 * acos (1.0 - MI_AA_ARC_FLATNESS / radius);
+  else
+    step = 0.5 * M_PI;
+  n = (int)ceil (FABS(range) / step);
+  n = IMAX(n, 8);
+
+  points = (miDoublePoint *)_pl_xmalloc ((n + 1) * sizeof(miDoublePoint));
+  for (i = 0; i <= n; i++)
+    {
+      double theta = theta0 + (range * i) / n;
+      double c = cos (theta), s = sin (theta);
+      double x = pc.x + u.x * c + v.x * s;
+      double y = pc.y + u.y * c + v.y * s;
+
+      points[i].x = XD_INTERNAL(x, y, m);
+      points[i].y = YD_INTERNAL(x, y, m);
+    }
+  *npoints = n + 1;
+
+  return points;
+}
+
+/* Draw the path in a drawing state with anti-aliasing, i.e., add spans to
+   a libxmi miCoverageSet (see mi_aa.c).  The path is filled if `fill' is
+   set, and edged otherwise, in the foreground pixel of the passed miGC,
+   which should have been prepared by _set_common_mi_attributes().  Unlike
+   in non-anti-aliased drawing, vertices are not rounded to integer device
+   coordinates, and line widths are not quantized. */
+void
+_draw_mi_aa_path (plDrawState *drawstate, void * ptr_coverage_set, const void * ptr_gc, bool fill)
+{
+  const plPath *path = drawstate->path;
+  double *m = drawstate->transform.m;
+  miCoverageSet *coverageSet;
+  const miGC *pGC;
+  miDoublePoint *points;
+  double line_width;
+  int i, npoints;
+
+  coverageSet = (miCoverageSet *)ptr_coverage_set; /* recover passed set */
+  pGC = (const miGC *)ptr_gc;	/* recover passed libxmi GC */
+
+  /* line width in device frame; a `zero-width' line is one pixel wide */
+  line_width = DMAX(drawstate->device_line_width, 1.0);
+
+  switch ((int)path->type)
+    {
+    case (int)PATH_SEGMENT_LIST:
+      if (path->num_segments < 2)
+	return;
+
+      if (path->num_segments == 2 && _path_segment_type (path, 1) == S_ARC)
+	/* a single circular arc, from p0 to p1; by libplot convention it
+	   subtends at most 180 degrees, and if p0, p1, pc are collinear, it
+	   goes counterclockwise */
+	{
+	  plPoint p0, p1, pc;
+	  plVector u, v;
+	  double range;
+
+	  p0 = path->points[0];
+	  p1 = path->points[1];
+	  pc = _path_curve (path, 1)->pc;
+	  u.x = p0.x - pc.x;
+	  u.y = p0.y - pc.y;
+	  v.x = -u.y;
+	  v.y = u.x;
+	  range = _xatan2 (p1.y - pc.y, p1.x - pc.x) - _xatan2 (u.y, u.x);
+	  if (range > M_PI)
+	    range -= 2 * M_PI;
+	  if (range <= -M_PI)
+	    range += 2 * M_PI;
+	  points = _flatten_mi_aa_arc (drawstate, pc, u, v, 0.0, range,
+				       &npoints);
+	}
+      else if (path->num_segments == 2 && _path_segment_type (path, 1) == S_ELLARC)
+	/* a single quarter-ellipse, from p0 to p1 */
+	{
+	  plPoint p0, p1, pc;
+	  plVector u, v;
+
+	  p0 = path->points[0];
+	  p1 = path->points[1];
+	  pc = _path_curve (path, 1)->pc;
+	  u.x = p0.x - pc.x;
+	  u.y = p0.y - pc.y;
+	  v.x = p1.x - pc.x;
+	  v.y = p1.y - pc.y;
+	  points = _flatten_mi_aa_arc (drawstate, pc, u, v, 0.0, 0.5 * M_PI,
+				       &npoints);
+	}
+      else
+	/* a polyline */
+	{
+	  bool identical_user_coordinates = true;
+
+	  npoints = path->num_segments;
+	  points = (miDoublePoint *)_pl_xmalloc (npoints * sizeof(miDoublePoint));
+	  for (i = 0; i < npoints; i++)
+	    {
+	      double xu = path->points[i].x, yu = path->points[i].y;
+
+	      if (i > 0 && (xu != path->points[0].x
+			    || yu != path->points[0].y))
+		identical_user_coordinates = false;
+	      points[i].x = XD_INTERNAL(xu, yu, m);
+	      points[i].y = YD_INTERNAL(xu, yu, m);
+	    }
+
+	  /* a polyline consisting of a single point is drawn as a filled
+	     circle only if the cap mode is "round" */
+	  if (!fill && identical_user_coordinates
+	      && drawstate->cap_type != PL_CAP_ROUND)
+	    {
+	      free (points);
+	      return;
+	    }
+	}
+      break;
+
+    case (int)PATH_ELLIPSE:
+      {
+	plVector u, v;
+	double theta = M_PI * path->angle / 180.0;
+
+	u.x = path->rx * cos (theta);
+	u.y = path->rx * sin (theta);
+	v.x = -path->ry * sin (theta);
+	v.y = path->ry * cos (theta);
+	points = _flatten_mi_aa_arc (drawstate, path->pc, u, v, 0.0, 2 * M_PI,
+				     &npoints);
+	/* make flattened ellipse exactly closed */
+	points[npoints - 1] = points[0];
+      }
+      break;
+
+    default:			/* shouldn't happen */
+      return;
+    }
+
+  if (fill)
+    miAAFillPolygon (coverageSet, pGC, npoints, points);
+  else
+    miAADrawLines (coverageSet, pGC, line_width, npoints, points);
+
+  free (points);
+}
+
+/* If the REPORT_STATS parameter was set, and anything was drawn into the
+   passed libxmi miPaintedSet, report on the span arena used by the set
+   and on the passed ellipse cache (the latter statistics are cumulative,
+   since the Plotter was created).  Called when a page is torn down. */
+void
+_pl_g_report_mi_stats (R___(Plotter *_plotter) const void * ptr_painted_set, const void * ptr_ellipse_cache)
+{
+  miSpanArenaStats arena_stats;
+  miEllipseCacheStats cache_stats;
+  char buf[256];
+
+  if (!_plotter->data->report_stats || ptr_painted_set == NULL)
+    return;
+
+  miGetSpanArenaStats ((const miPaintedSet *)ptr_painted_set, &arena_stats);
+  if (arena_stats.allocations == 0)
+    return;
+
+  sprintf (buf, "span arena: %lu allocations (%lu bytes) in %lu blocks, %lu mallocs saved",
+	   arena_stats.allocations, arena_stats.bytes, 
+	   arena_stats.blocks,
+	   arena_stats.allocations > arena_stats.blocks 
+	   ? arena_stats.allocations - arena_stats.blocks : 0UL);
+  _plotter->warning (R___(_plotter) buf);
+
+  miGetEllipseCacheStats ((const miEllipseCache *)ptr_ellipse_cache, 
+			  &cache_stats);
+  sprintf (buf, "ellipse cache: %lu hits, %lu misses, %lu evictions, %lu uncacheable, %d of %d entries used",
+	   cache_stats.hits, cache_stats.misses, cache_stats.evictions, 
+	   cache_stats.uncacheable, cache_stats.count, cache_stats.size);
+  _plotter->warning (R___(_plotter) buf);
+}
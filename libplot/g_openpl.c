@@ -50,12 +50,15 @@ _API_openpl (S___(Plotter *_plotter))
 	 deleted by closepl(); in the former case, only page #1 is written
 	 out */
       _plotter->data->page = _new_outbuf ();
+      _plotter->data->page->memory_limit = 
+	_plotter->data->page_memory_limit;
       break;
       
     case (int)PL_OUTPUT_PAGES_ALL_AT_ONCE:
       {
 	plOutbuf *new_page = _new_outbuf();
 
+	new_page->memory_limit = _plotter->data->page_memory_limit;
 	if (_plotter->data->opened == false) /* first page */
 	  {
 	    _plotter->data->page = new_page;
@@ -108,7 +111,7 @@ _API_openpl (S___(Plotter *_plotter))
     const char *bg_color_name_s;
 
     bg_color_name_s = 
-      (const char *)_get_plot_param (_plotter->data, "BG_COLOR");
+      (const char *)_get_plot_param (_plotter->data, PL_PARAM_BG_COLOR);
     if (bg_color_name_s)
       _API_bgcolorname (R___(_plotter) bg_color_name_s);
   }
@@ -23,11 +23,26 @@
    with a page of device code, a plOutbuf optionally stores bounding box
    information for the page.
 
-   plOutbufs are resized when they are too full.  The strange resizing
-   method (_UPDATE_BUFFER) is needed because on many systems, sprintf()
-   does not return the number of characters it writes.  _UPDATE_BUFFER must
-   be called after each call to sprintf(); it is not invoked automatically.
+   A plOutbuf is resized when it is more than half full, until it reaches
+   OUTBUF_CHUNK_LEN.  After that, its contents are retired as a completed
+   chunk, to which a pointer is kept, and a fresh buffer is begun; so the
+   device code for even a very large page is never copied.  If a memory
+   limit is set for the plOutbuf (see the PAGE_MEMORY_LIMIT parameter),
+   completed chunks are moved to an anonymous temporary file whenever they
+   would exceed it.  See g_write.c for how the contents are written out.
+
+   The strange method (_UPDATE_BUFFER) of updating a plOutbuf after a
+   write is needed because on many systems, sprintf() does not return the
+   number of characters it writes.  _UPDATE_BUFFER must be called after
+   each call to sprintf(); it is not invoked automatically.
    
+   Drivers should instead append to a plOutbuf with the typed appenders
+   _outbuf_puts(), _outbuf_putc(), _outbuf_put_int(), _outbuf_put_fixed()
+   and _outbuf_put_general(), or with _outbuf_printf(), which accepts the
+   subset of printf() formats that libplot's drivers use.  They format
+   integers and doubles themselves, know the length of what they write,
+   and update the plOutbuf accordingly, so the new text is not rescanned.
+
    Output buffers of this sort are a bit of a kludge.  They may eventually
    be replaced or supplemented by an in-core object hierarchy, which
    deletepl() will scan.
@@ -40,6 +55,7 @@
 
 #include "sys-defines.h"
 #include "extern.h"
+#include <stdarg.h>
 
 /* Initial length for a plOutbuf (should be large enough to handle any
    single one of our sprintf's or strcpy's [including final NUL], or other
@@ -53,6 +69,24 @@
    reallocating due to exhaustion of storage. */
 #define NEW_OUTBUF_LEN(old_outbuf_len) ((old_outbuf_len) < 10000000 ? 2 * (old_outbuf_len) : (old_outbuf_len) + 10000000)
 
+/* Length at which a plOutbuf stops being resized; beyond this, its
+   contents are retired in chunks of somewhat more than half this size. */
+#define OUTBUF_CHUNK_LEN 1048576
+
+/* forward references */
+static bool round_scaled (double x, int k, double *result);
+static bool is_negative (double x);
+static int format_digits (char *s, double m, int min_digits);
+static int format_fixed (char *s, double x, int decimals);
+static int format_general (char *s, double x, int precision);
+static bool simple_format (const char *format);
+static void outbuf_advance (plOutbuf *bufp, int additional);
+static void outbuf_make_room (plOutbuf *bufp, unsigned long needed);
+static void outbuf_expand (plOutbuf *bufp);
+static void outbuf_retire_chunk (plOutbuf *bufp);
+static void outbuf_spill (plOutbuf *bufp);
+static void outbuf_truncate (plOutbuf *bufp, unsigned long length);
+
 plOutbuf *
 _new_outbuf (void)
 {
@@ -64,7 +98,14 @@ _new_outbuf (void)
   bufp->base = (char *)_pl_xmalloc(INITIAL_OUTBUF_LEN * sizeof(char));
   bufp->len = (unsigned long)INITIAL_OUTBUF_LEN;
   bufp->next = NULL;
-  bufp->reset_point = bufp->base;
+  bufp->spill_fp = (FILE *)NULL;
+  bufp->spilled = (unsigned long)0L;
+  bufp->first_chunk = (plOutbufChunk *)NULL;
+  bufp->last_chunk = (plOutbufChunk *)NULL;
+  bufp->chunk_contents = (unsigned long)0L;
+  bufp->memory_limit = (unsigned long)0L;
+  bufp->point = bufp->base;
+  bufp->contents = (unsigned long)0L;
   bufp->reset_contents = (unsigned long)0L;
   _reset_outbuf (bufp);
 
@@ -76,9 +117,7 @@ _reset_outbuf (plOutbuf *bufp)
 {
   int i;
 
-  *(bufp->reset_point) = '\0';
-  bufp->point = bufp->reset_point;
-  bufp->contents = bufp->reset_contents;
+  outbuf_truncate (bufp, bufp->reset_contents);
 
   /* also initialize elements used by some drivers */
 
@@ -98,8 +137,8 @@ _reset_outbuf (plOutbuf *bufp)
 void
 _freeze_outbuf (plOutbuf *bufp)
 {
-  bufp->reset_point = bufp->point;
-  bufp->reset_contents = bufp->contents;
+  bufp->reset_contents = 
+    bufp->spilled + bufp->chunk_contents + bufp->contents;
 }
 
 void
@@ -107,6 +146,16 @@ _delete_outbuf (plOutbuf *bufp)
 {
   if (bufp)
     {
+      plOutbufChunk *chunk, *next_chunk;
+
+      for (chunk = bufp->first_chunk; chunk; chunk = next_chunk)
+	{
+	  next_chunk = chunk->next;
+	  free (chunk->data);
+	  free (chunk);
+	}
+      if (bufp->spill_fp)
+	fclose (bufp->spill_fp);
       free (bufp->base);
       free (bufp);
     }
@@ -134,19 +183,7 @@ _update_buffer (plOutbuf *bufp)
       exit (EXIT_FAILURE);
     }
   if (bufp->contents > (bufp->len >> 1))
-    /* expand buffer */
-    {
-      unsigned long oldlen, newlen;
-
-      oldlen = bufp->len;
-      newlen = NEW_OUTBUF_LEN(oldlen);
-
-      bufp->base = 
-	(char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
-      bufp->len = newlen;
-      bufp->point = bufp->base + bufp->contents;
-      bufp->reset_point = bufp->base + bufp->reset_contents;
-    }      
+    outbuf_expand (bufp);
 }
 
 /* A variant of _UPDATE_BUFFER in which the caller specifies how many bytes
@@ -166,19 +203,7 @@ _update_buffer_by_added_bytes (plOutbuf *bufp, int additional)
       exit (EXIT_FAILURE);
     }
   if (bufp->contents > (bufp->len >> 1))
-    /* expand buffer */
-    {
-      unsigned long oldlen, newlen;
-
-      oldlen = bufp->len;
-      newlen = NEW_OUTBUF_LEN(oldlen);
-
-      bufp->base = 
-	(char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
-      bufp->len = newlen;
-      bufp->point = bufp->base + bufp->contents;
-      bufp->reset_point = bufp->base + bufp->reset_contents;
-    }      
+    outbuf_expand (bufp);
 }
 
 /* update bounding box information for a plOutbuf, to take account of a
@@ -250,3 +275,575 @@ _bbox_of_outbufs (plOutbuf *bufp, double *xmin, double *xmax, double *ymin, doub
   *xmax = doc_x_max;
   *ymax = doc_y_max;
 }
+
+/* Make room in a plOutbuf that is more than half full, either by
+   resizing it, or if it has reached OUTBUF_CHUNK_LEN, by retiring its
+   contents as a completed chunk. */
+static void
+outbuf_expand (plOutbuf *bufp)
+{
+  unsigned long oldlen, newlen;
+  
+  if (bufp->len >= OUTBUF_CHUNK_LEN)
+    {
+      outbuf_retire_chunk (bufp);
+      return;
+    }
+
+  oldlen = bufp->len;
+  newlen = NEW_OUTBUF_LEN(oldlen);
+  
+  bufp->base = 
+    (char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
+  bufp->len = newlen;
+  bufp->point = bufp->base + bufp->contents;
+}
+
+/* Append the contents of a plOutbuf's buffer to its list of completed
+   chunks (without copying them), and begin a new, empty buffer of the
+   same size. */
+static void
+outbuf_retire_chunk (plOutbuf *bufp)
+{
+  plOutbufChunk *chunk;
+
+  chunk = (plOutbufChunk *)_pl_xmalloc (sizeof(plOutbufChunk));
+  /* trim unused storage; this doesn't copy, on most systems */
+  chunk->data = (char *)_pl_xrealloc (bufp->base, 
+				      bufp->contents * sizeof(char));
+  chunk->len = bufp->contents;
+  chunk->next = (plOutbufChunk *)NULL;
+  if (bufp->last_chunk)
+    bufp->last_chunk->next = chunk;
+  else
+    bufp->first_chunk = chunk;
+  bufp->last_chunk = chunk;
+  bufp->chunk_contents += chunk->len;
+
+  bufp->base = (char *)_pl_xmalloc (bufp->len * sizeof(char));
+  bufp->point = bufp->base;
+  bufp->contents = (unsigned long)0L;
+  *(bufp->point) = '\0';
+
+  if (bufp->memory_limit > 0
+      && bufp->chunk_contents + bufp->len > bufp->memory_limit)
+    outbuf_spill (bufp);
+}
+
+/* Move a plOutbuf's completed chunks to the end of its temporary file,
+   creating the file if necessary.  If the file can't be created or
+   written, the plOutbuf's memory limit is removed, and any chunks not yet
+   written stay in memory. */
+static void
+outbuf_spill (plOutbuf *bufp)
+{
+  plOutbufChunk *chunk, *next_chunk;
+
+  if (bufp->spill_fp == (FILE *)NULL)
+    {
+      bufp->spill_fp = tmpfile ();
+      if (bufp->spill_fp == (FILE *)NULL)
+	{
+	  bufp->memory_limit = 0;
+	  return;
+	}
+    }
+
+  /* the file may extend beyond the spilled contents, if the plOutbuf was
+     reset */
+  if (fseek (bufp->spill_fp, (long)bufp->spilled, SEEK_SET) < 0)
+    {
+      bufp->memory_limit = 0;
+      return;
+    }
+  for (chunk = bufp->first_chunk; chunk; chunk = next_chunk)
+    {
+      next_chunk = chunk->next;
+      if (fwrite (chunk->data, sizeof(char), chunk->len, bufp->spill_fp) 
+	  != chunk->len)
+	{
+	  bufp->memory_limit = 0;
+	  break;
+	}
+      bufp->spilled += chunk->len;
+      bufp->chunk_contents -= chunk->len;
+      free (chunk->data);
+      free (chunk);
+    }
+  bufp->first_chunk = chunk;
+  if (chunk == (plOutbufChunk *)NULL)
+    bufp->last_chunk = (plOutbufChunk *)NULL;
+}
+
+/* Discard all but the first `length' bytes of the contents of a plOutbuf.
+   Whatever remains of the chunk (or spilled contents) in which the cut
+   falls is copied back into the plOutbuf's buffer. */
+static void
+outbuf_truncate (plOutbuf *bufp, unsigned long length)
+{
+  unsigned long offset, keep;
+  plOutbufChunk *chunk, *prev_chunk, *next_chunk;
+
+  offset = bufp->spilled + bufp->chunk_contents;
+  if (length >= offset)
+    /* cut falls in the buffer */
+    keep = length - offset;
+  else
+    {
+      /* find chunk in which cut falls, if any */
+      offset = bufp->spilled;
+      prev_chunk = (plOutbufChunk *)NULL;
+      for (chunk = bufp->first_chunk; chunk; chunk = chunk->next)
+	{
+	  if (length <= offset + chunk->len)
+	    break;
+	  offset += chunk->len;
+	  prev_chunk = chunk;
+	}
+
+      if (chunk && length >= offset)
+	/* copy part of chunk back into buffer */
+	{
+	  keep = length - offset;
+	  bufp->point = bufp->base;
+	  bufp->contents = (unsigned long)0L;
+	  outbuf_make_room (bufp, keep);
+	  memcpy (bufp->base, chunk->data, keep);
+	}
+      else
+	/* cut falls in the spilled contents; read back at most half a
+	   buffer's worth, and consider the rest still spilled */
+	{
+	  keep = (length < (bufp->len >> 1) ? length : (bufp->len >> 1));
+	  offset = length - keep;
+	  if (fseek (bufp->spill_fp, (long)offset, SEEK_SET) < 0
+	      || fread (bufp->base, sizeof(char), keep, bufp->spill_fp) != keep)
+	    keep = 0;		/* shouldn't happen */
+	  chunk = bufp->first_chunk;
+	  prev_chunk = (plOutbufChunk *)NULL;
+	  bufp->spilled = offset;
+	}
+
+      /* discard chunk in which cut falls, and all later chunks */
+      for ( ; chunk; chunk = next_chunk)
+	{
+	  next_chunk = chunk->next;
+	  free (chunk->data);
+	  free (chunk);
+	}
+      if (prev_chunk)
+	prev_chunk->next = (plOutbufChunk *)NULL;
+      else
+	bufp->first_chunk = (plOutbufChunk *)NULL;
+      bufp->last_chunk = prev_chunk;
+      bufp->chunk_contents = offset - bufp->spilled;
+    }
+
+  bufp->point = bufp->base + keep;
+  bufp->contents = keep;
+  *(bufp->point) = '\0';
+}
+
+/* Typed appenders.  Each of these appends text at the current point of a
+   plOutbuf, and returns the number of characters appended.  The numeric
+   ones produce exactly what sprintf() would produce with the indicated
+   format, in the C locale.  A single character or number is written
+   straight at the current point, since after each update a plOutbuf is
+   at most half full, which leaves ample room. */
+
+/* powers of ten that are exactly representable as doubles */
+static const double pow10_table[23] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Round a nonnegative double, scaled by 10**k, to the nearest integer, in
+   the way that printf() rounds the exact binary value.  Returns false if
+   this can't be done reliably in double precision, i.e., if the scaled
+   value is too large, or is so close to a tie that the one rounding
+   error in the scaling could matter. */
+static bool
+round_scaled (double x, int k, double *result)
+{
+  double scaled, whole, frac, slop;
+
+  if (k > 22 || k < -22)
+    return false;
+  scaled = (k >= 0 ? x * pow10_table[k] : x / pow10_table[-k]);
+  if (!(scaled < 4503599627370496.0)) /* 2**52 */
+    return false;
+  whole = floor (scaled);
+  frac = scaled - whole;
+  slop = scaled * DBL_EPSILON + DBL_MIN;
+  if (frac > 0.5 - slop && frac < 0.5 + slop)
+    return false;
+  *result = (frac > 0.5 ? whole + 1.0 : whole);
+  return true;
+}
+
+/* Does a double have its sign bit set?  (True for -0.0, which printf()
+   prints with a minus sign.) */
+static bool
+is_negative (double x)
+{
+  return (x < 0.0 || (x == 0.0 && 1.0 / x < 0.0));
+}
+
+/* Write the decimal digits of a nonnegative integer less than 2**52,
+   passed as a double, padding with leading zeroes to at least a specified
+   number of digits.  Returns the number of digits written. */
+static int
+format_digits (char *s, double m, int min_digits)
+{
+  char digits[24];
+  unsigned long high, low;
+  int n = 0, i;
+
+  /* split into two parts that fit in 32 bits */
+  high = (unsigned long)(m / 1e9);
+  low = (unsigned long)(m - (double)high * 1e9);
+  do
+    {
+      digits[n++] = (char)('0' + low % 10);
+      low /= 10;
+    }
+  while (low > 0 || (high > 0 && n < 9));
+  while (high > 0)
+    {
+      digits[n++] = (char)('0' + high % 10);
+      high /= 10;
+    }
+  while (n < min_digits)
+    digits[n++] = '0';
+  for (i = 0; i < n; i++)
+    s[i] = digits[n - 1 - i];
+
+  return n;
+}
+
+/* Write a double as sprintf() would with the format "%.<decimals>f".
+   Returns the number of characters written. */
+static int
+format_fixed (char *s, double x, int decimals)
+{
+  double m;
+  int n = 0, ndigits;
+
+  if (x != x || x - x != 0.0	/* NaN or infinite */
+      || decimals > 22
+      || !round_scaled (fabs (x), decimals, &m))
+    {
+      sprintf (s, "%.*f", decimals, x);
+      return (int)strlen (s);
+    }
+
+  if (is_negative (x))
+    s[n++] = '-';
+  ndigits = format_digits (s + n, m, decimals + 1);
+  if (decimals > 0)
+    {
+      memmove (s + n + ndigits - decimals + 1, s + n + ndigits - decimals,
+	       (size_t)decimals);
+      s[n + ndigits - decimals] = '.';
+      n++;
+    }
+
+  return n + ndigits;
+}
+
+/* Write a double as sprintf() would with the format "%.<precision>g".
+   Returns the number of characters written. */
+static int
+format_general (char *s, double x, int precision)
+{
+  char digits[24];
+  double a, m;
+  int n = 0, exponent, tries, i, last;
+
+  if (precision == 0)
+    precision = 1;		/* as in printf() */
+  a = fabs (x);
+  if (x != x || x - x != 0.0	/* NaN or infinite */
+      || precision > 15 || a < 1e-5 || a >= 1e17)
+    {
+      if (x == 0.0)
+	{
+	  if (is_negative (x))
+	    s[n++] = '-';
+	  s[n++] = '0';
+	  return n;
+	}
+      sprintf (s, "%.*g", precision, x);
+      return (int)strlen (s);
+    }
+
+  /* estimate the decimal exponent, then round to `precision' significant
+     digits, correcting the exponent if the rounded value has too many or
+     too few digits */
+  exponent = 0;
+  if (a >= 1.0)
+    while (exponent < 22 && a >= pow10_table[exponent + 1])
+      exponent++;
+  else
+    while (exponent > -6 && a * pow10_table[-exponent] < 1.0)
+      exponent--;
+  for (tries = 0; ; tries++)
+    {
+      if (tries == 3 || !round_scaled (a, precision - 1 - exponent, &m))
+	{
+	  sprintf (s, "%.*g", precision, x);
+	  return (int)strlen (s);
+	}
+      if (m >= pow10_table[precision])
+	exponent++;
+      else if (m < pow10_table[precision - 1])
+	exponent--;
+      else
+	break;
+    }
+  format_digits (digits, m, precision);
+
+  /* trailing zeroes are dropped */
+  for (last = precision - 1; last > 0 && digits[last] == '0'; last--)
+    ;
+
+  if (is_negative (x))
+    s[n++] = '-';
+  if (exponent < -4 || exponent >= precision)
+    /* exponential notation, e.g. 1.2345e+20 */
+    {
+      s[n++] = digits[0];
+      if (last > 0)
+	{
+	  s[n++] = '.';
+	  for (i = 1; i <= last; i++)
+	    s[n++] = digits[i];
+	}
+      s[n++] = 'e';
+      s[n++] = (exponent < 0 ? '-' : '+');
+      if (exponent < 0)
+	exponent = -exponent;
+      s[n++] = (char)('0' + exponent / 10);
+      s[n++] = (char)('0' + exponent % 10);
+    }
+  else if (exponent >= 0)
+    /* fixed notation, e.g. 123.45 */
+    {
+      for (i = 0; i <= exponent; i++)
+	s[n++] = digits[i];
+      if (last > exponent)
+	{
+	  s[n++] = '.';
+	  for (i = exponent + 1; i <= last; i++)
+	    s[n++] = digits[i];
+	}
+    }
+  else
+    /* fixed notation, e.g. 0.0012345 */
+    {
+      s[n++] = '0';
+      s[n++] = '.';
+      for (i = -1; i > exponent; i--)
+	s[n++] = '0';
+      for (i = 0; i <= last; i++)
+	s[n++] = digits[i];
+    }
+
+  return n;
+}
+
+/* Advance the current point of a plOutbuf past newly written characters,
+   keeping the contents NUL-terminated. */
+static void
+outbuf_advance (plOutbuf *bufp, int additional)
+{
+  bufp->point[additional] = '\0';
+  _update_buffer_by_added_bytes (bufp, additional);
+}
+
+/* Ensure that a specified number of characters (and a NUL) can be written
+   at the current point of a plOutbuf. */
+static void
+outbuf_make_room (plOutbuf *bufp, unsigned long needed)
+{
+  unsigned long newlen;
+
+  if (bufp->contents + needed + 1 <= bufp->len)
+    return;
+
+  newlen = bufp->len;
+  while (bufp->contents + needed + 1 > newlen)
+    newlen = NEW_OUTBUF_LEN(newlen);
+  bufp->base = (char *)_pl_xrealloc (bufp->base, newlen * sizeof(char));
+  bufp->len = newlen;
+  bufp->point = bufp->base + bufp->contents;
+}
+
+int
+_outbuf_puts (plOutbuf *bufp, const char *s)
+{
+  int length;
+
+  length = (int)strlen (s);
+  outbuf_make_room (bufp, (unsigned long)length);
+  memcpy (bufp->point, s, (size_t)length);
+  outbuf_advance (bufp, length);
+  return length;
+}
+
+int
+_outbuf_putc (plOutbuf *bufp, int c)
+{
+  bufp->point[0] = (char)c;
+  outbuf_advance (bufp, 1);
+  return 1;
+}
+
+/* equivalent to "%d" */
+int
+_outbuf_put_int (plOutbuf *bufp, int i)
+{
+  int n = 0;
+
+  if (i < 0)
+    bufp->point[n++] = '-';
+  /* negate as a double, in case i is the most negative int */
+  n += format_digits (bufp->point + n, fabs ((double)i), 1);
+  outbuf_advance (bufp, n);
+  return n;
+}
+
+/* equivalent to "%.<decimals>f" */
+int
+_outbuf_put_fixed (plOutbuf *bufp, double x, int decimals)
+{
+  int n;
+
+  n = format_fixed (bufp->point, x, decimals);
+  outbuf_advance (bufp, n);
+  return n;
+}
+
+/* equivalent to "%.<precision>g" */
+int
+_outbuf_put_general (plOutbuf *bufp, double x, int precision)
+{
+  int n;
+
+  n = format_general (bufp->point, x, precision);
+  outbuf_advance (bufp, n);
+  return n;
+}
+
+/* Does a printf() format use only the conversions that _outbuf_printf()
+   handles itself, i.e., %d, %u, %c, %s, %%, and %f and %g with optional
+   precision? */
+static bool
+simple_format (const char *format)
+{
+  const char *p;
+
+  for (p = format; *p; p++)
+    if (*p == '%')
+      {
+	p++;
+	if (*p == '.')
+	  {
+	    p++;
+	    if (*p < '0' || *p > '9')
+	      return false;
+	    while (*p >= '0' && *p <= '9')
+	      p++;
+	    if (*p != 'f' && *p != 'g')
+	      return false;
+	  }
+	else if (*p != 'd' && *p != 'u' && *p != 'c' && *p != 's'
+		 && *p != '%' && *p != 'f' && *p != 'g')
+	  return false;
+      }
+  return true;
+}
+
+/* Append formatted text to a plOutbuf, as sprintf() would; return the
+   number of characters appended.  Formats that use anything other than
+   the simple conversions listed above are passed to vsprintf(). */
+int
+_outbuf_printf (plOutbuf *bufp, const char *format, ...)
+{
+  va_list ap;
+  const char *p, *run;
+  int total = 0, precision;
+
+  va_start (ap, format);
+  if (!simple_format (format))
+    {
+      vsprintf (bufp->point, format, ap);
+      va_end (ap);
+      total = (int)strlen (bufp->point);
+      _update_buffer_by_added_bytes (bufp, total);
+      return total;
+    }
+
+  p = format;
+  while (*p)
+    {
+      if (*p != '%')
+	/* copy a run of literal characters */
+	{
+	  run = p;
+	  while (*p && *p != '%')
+	    p++;
+	  outbuf_make_room (bufp, (unsigned long)(p - run));
+	  memcpy (bufp->point, run, (size_t)(p - run));
+	  outbuf_advance (bufp, (int)(p - run));
+	  total += (int)(p - run);
+	  continue;
+	}
+
+      p++;
+      precision = 6;		/* default, for %f and %g */
+      if (*p == '.')
+	{
+	  p++;
+	  precision = 0;
+	  while (*p >= '0' && *p <= '9')
+	    precision = 10 * precision + (*p++ - '0');
+	}
+      switch (*p++)
+	{
+	case 'd':
+	  total += _outbuf_put_int (bufp, va_arg (ap, int));
+	  break;
+	case 'u':
+	  {
+	    unsigned int u = va_arg (ap, unsigned int);
+	    int n;
+
+	    n = format_digits (bufp->point, (double)u, 1);
+	    outbuf_advance (bufp, n);
+	    total += n;
+	  }
+	  break;
+	case 'c':
+	  total += _outbuf_putc (bufp, va_arg (ap, int));
+	  break;
+	case 's':
+	  total += _outbuf_puts (bufp, va_arg (ap, const char *));
+	  break;
+	case 'f':
+	  total += _outbuf_put_fixed (bufp, va_arg (ap, double), precision);
+	  break;
+	case 'g':
+	  total += _outbuf_put_general (bufp, va_arg (ap, double), precision);
+	  break;
+	case '%':
+	default:
+	  total += _outbuf_putc (bufp, '%');
+	  break;
+	}
+    }
+  va_end (ap);
+
+  return total;
+}
@@ -43,13 +43,13 @@ _set_page_type (plPlotterData *data)
   
   /* examine user-specified value for PAGESIZE parameter, or the default
      value if we can't parse the user-specified value */
-  pagesize = (const char *)_get_plot_param (data, "PAGESIZE");
+  pagesize = (const char *)_get_plot_param (data, PL_PARAM_PAGESIZE);
   if (!parse_page_type (pagesize, &pagedata, 
 			 &viewport_xoffset, &viewport_yoffset,
 			 &viewport_xorigin, &viewport_yorigin,
 			 &viewport_xsize, &viewport_ysize))
     {
-      pagesize = (const char *)_get_default_plot_param ("PAGESIZE");
+      pagesize = (const char *)_get_default_plot_param (PL_PARAM_PAGESIZE);
       parse_page_type (pagesize, &pagedata, 
 			&viewport_xoffset, &viewport_yoffset,
 			&viewport_xorigin, &viewport_yorigin,
@@ -86,36 +86,31 @@ _setplparam (R___(PlotterParams *_plotter_params) const char *parameter, void *
 {
   int j;
 
-  for (j = 0; j < NUM_PLOTTER_PARAMETERS; j++)
+  j = _plot_param_index (parameter);
+  if (j < 0)
+    /* silently ignore requests to set unknown parameters */
+    return 0;
+
+  if (_known_params[j].is_string)
+    /* parameter value is a string, so treat specially: copy the string,
+       byte by byte */
     {
-      if (strcmp (_known_params[j].parameter, parameter) == 0)
+      if (_plotter_params->plparams[j])
+	free (_plotter_params->plparams[j]);
+      if (value != NULL)
 	{
-	  if (_known_params[j].is_string)
-	    /* parameter value is a string, so treat specially: copy the
-	       string, byte by byte */
-	    {
-	      if (_plotter_params->plparams[j])
-		free (_plotter_params->plparams[j]);
-	      if (value != NULL)
-		{
-		  _plotter_params->plparams[j] = 
-		    (char *)_pl_xmalloc (strlen ((char *)value) + 1);
-		  strcpy ((char *)_plotter_params->plparams[j], (char *)value);
-		}
-	      else
-		_plotter_params->plparams[j] = NULL;
-	    }
-	  else
-	    /* parameter value is a (void *), so just copy the
-               user-specified pointer */
-	    _plotter_params->plparams[j] = value;
-	  
-	  /* matched, so return happily */
-	  return 0;
+	  _plotter_params->plparams[j] = 
+	    (char *)_pl_xmalloc (strlen ((char *)value) + 1);
+	  strcpy ((char *)_plotter_params->plparams[j], (char *)value);
 	}
+      else
+	_plotter_params->plparams[j] = NULL;
     }
+  else
+    /* parameter value is a (void *), so just copy the user-specified
+       pointer */
+    _plotter_params->plparams[j] = value;
 
-  /* silently ignore requests to set unknown parameters */
   return 0;
 }
 
@@ -131,7 +126,8 @@ _setplparam (R___(PlotterParams *_plotter_params) const char *parameter, void *
 
    We support both parameters whose values are strings (which must be
    copied byte-by-byte) and those whose values are void pointers (which may
-   simply be copied. */
+   simply be copied).  A default value, being read-only global data, is
+   not copied: the Plotter points to it, and must not free it. */
 void 
 _pl_g_copy_params_to_plotter (R___(Plotter *_plotter) const PlotterParams *plotter_params)
 {
@@ -162,32 +158,21 @@ _pl_g_copy_params_to_plotter (R___(Plotter *_plotter) const PlotterParams *plott
 		(char *)_pl_xmalloc (strlen (envs) + 1);
 	      strcpy ((char *)_plotter->data->params[j], envs);
 	    }
-	  else if (_known_params[j].default_value)
-	    /* have default libplot value */
-	    {
-	      _plotter->data->params[j] = 
-		(char *)_pl_xmalloc (strlen ((char *)_known_params[j].default_value) + 1);
-	      strcpy ((char *)_plotter->data->params[j], 
-		      (char *)_known_params[j].default_value);
-	    }
-	  else			/* punt */
-	    _plotter->data->params[j] = NULL;
+	  else
+	    /* use default libplot value (possibly NULL) */
+	    _plotter->data->params[j] = _known_params[j].default_value;
 	}
     }
 }
 
-/* This retrieves the value of any specified Plotter parameter,
-   as stored in a Plotter instance. */
+/* This retrieves the value of any specified Plotter parameter, as stored
+   in a Plotter instance.  The parameter is specified by its index in the
+   _known_params[] array, i.e., by PL_PARAM_AI_VERSION etc. (see
+   extern.h), so no search is needed. */
 void *
-_get_plot_param (const plPlotterData *data, const char *parameter_name)
+_get_plot_param (const plPlotterData *data, int param)
 {
-  int j;
-
-  for (j = 0; j < NUM_PLOTTER_PARAMETERS; j++)
-    if (strcmp (_known_params[j].parameter, parameter_name) == 0)
-      return data->params[j];
-
-  return (void *)NULL;		/* name not matched */
+  return data->params[param];
 }
 
 /* This function is called when a Plotter is deleted, to delete the
@@ -199,7 +184,8 @@ _pl_g_free_params_in_plotter (S___(Plotter *_plotter))
 
   /* deallocate stored values of class variables */
   for (j = 0; j < NUM_PLOTTER_PARAMETERS; j++)
-    if (_known_params[j].is_string && _plotter->data->params[j] != NULL)
+    if (_known_params[j].is_string && _plotter->data->params[j] != NULL
+	&& _plotter->data->params[j] != _known_params[j].default_value)
       /* stored parameter is a previously malloc'd string, so free it */
       free (_plotter->data->params[j]);
 
@@ -210,13 +196,31 @@ _pl_g_free_params_in_plotter (S___(Plotter *_plotter))
    array, which is read-only global data.  So unlike the preceding
    functions, this is not a Plotter method. */
 void *
-_get_default_plot_param (const char *parameter_name)
+_get_default_plot_param (int param)
 {
-  int j;
+  return _known_params[param].default_value;
+}
 
-  for (j = 0; j < NUM_PLOTTER_PARAMETERS; j++)
-    if (strcmp (_known_params[j].parameter, parameter_name) == 0)
-      return _known_params[j].default_value;
+/* This maps the name of a Plotter parameter to its index in the
+   _known_params[] array, or returns -1 if the name is not recognized.
+   The array is sorted by name, so a binary search suffices. */
+int
+_plot_param_index (const char *parameter_name)
+{
+  int lo = 0, hi = NUM_PLOTTER_PARAMETERS - 1;
+
+  while (lo <= hi)
+    {
+      int mid = (lo + hi) / 2;
+      int cmp = strcmp (parameter_name, _known_params[mid].parameter);
+
+      if (cmp == 0)
+	return mid;
+      else if (cmp < 0)
+	hi = mid - 1;
+      else
+	lo = mid + 1;
+    }
 
-  return (void *)NULL;		/* name not matched */
+  return -1;			/* name not matched */
 }
@@ -31,23 +31,34 @@
    Plotter the parameter is relevant to, and which datatype its value
    should be, if it is not a (char *). */
 
+/* The parameters are listed in strcmp() order, so that a name can be
+   looked up by binary search (see g_param.c); and the enum of parameter
+   indices in extern.h, PL_PARAM_AI_VERSION etc., must list them in the
+   same order. */
+
 #include "sys-defines.h"
 #include "extern.h"
 
 const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS] =
 {
-  /* String-valued (i.e. really (char *)-valued */
-
   {"AI_VERSION", (char *)"5", true}, /* ai [obsolescent; undocumented] */
+  {"ANTIALIAS", (char *)"no", true}, /* pnm, png, gif */
   {"BG_COLOR", (char *)"white", true}, /* X, pnm, gif, cgm */
   {"BITMAPSIZE", (char *)"570x570", true}, /* X, pnm, gif */
+  {"BITMAP_THREADS", (char *)"1", true}, /* pnm, png */
   {"CGM_ENCODING", (char *)"binary", true}, /* cgm */
   {"CGM_MAX_VERSION", (char *)"4", true}, /* cgm */
+  {"CULL_PATHS", (char *)"no", true}, /* all except meta */
+  {"DECIMATION", (char *)"0", true}, /* all except meta */
   {"DISPLAY", (char *)"", true}, /* X */
+  {"ELLIPSE_CACHE_SIZE", (char *)"64", true}, /* pnm, png, gif */
   {"EMULATE_COLOR", (char *)"no", true}, /* all except meta */
+  {"FLATNESS", (char *)"0", true}, /* all that flatten curves */
   {"GIF_ANIMATION", (char *)"yes", true}, /* gif */
+  {"GIF_COMPRESSION", (char *)"lzw", true}, /* gif */
   {"GIF_DELAY", (char *)"0", true}, /* gif */
   {"GIF_ITERATIONS", (char *)"0", true}, /* gif */
+  {"GIF_QUANTIZE", (char *)"no", true}, /* gif */
   {"HPGL_ASSIGN_COLORS", (char *)"no", true}, /* hpgl */
   {"HPGL_OPAQUE_MODE", (char *)"yes", true}, /* hpgl */
   {"HPGL_PENS", (char *)NULL, true}, /* hpgl */
@@ -56,24 +67,26 @@ const struct plParamRecord _known_params[NUM_PLOTTER_PARAMETERS] =
   {"INTERLACE", (char *)"no", true}, /* gif */
   {"MAX_LINE_LENGTH", (char *)PL_MAX_UNFILLED_PATH_LENGTH_STRING, true}, /* all but tek and meta */
   {"META_PORTABLE", (char *)"no", true}, /* meta */
+  {"NO_INPUT", (char *)"no", true}, /* X */
   {"PAGESIZE", (char *)"letter", true}, /* hpgl, pcl, fig, cgm, ps, ai */
+  {"PAGE_MEMORY_LIMIT", (char *)"0", true}, /* svg, ai, ps, cgm, fig, pcl, hpgl */
   {"PCL_ASSIGN_COLORS", (char *)"no", true}, /* pcl */
   {"PCL_BEZIERS", (char *)"yes", true},	/* pcl */
+  {"PNG_COMPRESSION_LEVEL", (char *)"default", true}, /* png */
+  {"PNG_FILTER", (char *)"default", true}, /* png */
+  {"PNG_STRATEGY", (char *)"default", true}, /* png */
   {"PNM_PORTABLE", (char *)"no", true}, /* pnm */
+  {"REPORT_STATS", (char *)"no", true}, /* pnm, png, gif */
   {"ROTATION", (char *)"no", true}, /* tek, hpgl, pcl, fig, ps, ai, X, XDrawable */
   {"TERM", (char *)"tek", true}, /* tek only! */
   {"TRANSPARENT_COLOR", (char *)"none", true}, /* gif */
   {"USE_DOUBLE_BUFFERING", (char *)"no", true}, /* X, XDrawable */
-  {"NO_INPUT", (char *)"no", true}, /* X */
   {"VANISH_ON_DELETE", (char *)"no", true}, /* X */
   {"WAIT_ON_DELETE", (char *)"no", true}, /* X */
-  {"X_AUTO_FLUSH", (char *)"yes", true}, /* X */
-
-  /* Pointer-valued (i.e. non-string, i.e. non-(char *)-valued) */
-
   {"XDRAWABLE_COLORMAP", NULL, false}, /* XDrawable, is a Colormap* */
   {"XDRAWABLE_DISPLAY", NULL, false}, /* XDrawable, is a Display* */
   {"XDRAWABLE_DRAWABLE1", NULL, false}, /* XDrawable, is a Drawable* */
   {"XDRAWABLE_DRAWABLE2", NULL, false}, /* XDrawable, is a Drawable* */
   {"XDRAWABLE_VISUAL", NULL, false}, /* XDrawable, is a Visual* */
+  {"X_AUTO_FLUSH", (char *)"yes", true}, /* X */
 };
@@ -49,6 +49,48 @@ _API_fpoint (R___(Plotter *_plotter) double x, double y)
   return 0;
 }
 
+/* fpoints() is equivalent to invoking fpoint() on each of the n points
+   (x[i],y[i]) in turn.  The path under construction, if any, is flushed
+   out only once. */
+
+int
+_API_fpoints (R___(Plotter *_plotter) int n, const double *x, const double *y)
+{
+  int i;
+
+  if (!_plotter->data->open)
+    {
+      _plotter->error (R___(_plotter)
+		       "fpoints: invalid operation");
+      return -1;
+    }
+
+  /* sanity checks */
+  if (n < 0 || (n > 0 && (x == NULL || y == NULL)))
+    return -1;
+  if (n == 0)
+    return 0;
+
+  _API_endpath (S___(_plotter)); /* flush path if any */
+
+  if (_plotter->drawstate->pen_type == 0)
+    /* no pen to draw with, so just update our notion of position */
+    {
+      _plotter->drawstate->pos.x = x[n - 1];
+      _plotter->drawstate->pos.y = y[n - 1];
+      return 0;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      _plotter->drawstate->pos.x = x[i];
+      _plotter->drawstate->pos.y = y[i];
+      _plotter->paint_point (S___(_plotter));
+    }
+
+  return 0;
+}
+
 /* The internal point-drawing function, which point() is a wrapper around.
    It draws a point at the current location.  There is no standard
    definition of `point', so any Plotter is free to implement this as it
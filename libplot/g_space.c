@@ -286,7 +286,19 @@ _API_fsetmatrix (R___(Plotter *_plotter) double m0, double m1, double m2, double
      _paint_text(), which will first do the retrieval. */
   if (_plotter->data->fontsize_invoked == false)
     _plotter->drawstate->font_size = _plotter->drawstate->default_font_size;
-  
+
+  /* Convert the FLATNESS parameter, if any, from the device frame to the
+     user frame.  A distance in the user frame is stretched by at most the
+     larger singular value of the user_frame->device_frame map, so curves
+     flattened to within this distance in the user frame will be within
+     FLATNESS in the device frame. */
+  _matrix_sing_vals (t, &min_sing_val, &max_sing_val);
+  if (_plotter->data->flatness > 0.0 && max_sing_val > 0.0)
+    _plotter->drawstate->flatness
+      = _plotter->data->flatness / max_sing_val;
+  else
+    _plotter->drawstate->flatness = 0.0;
+
   return 0;
 }
 
@@ -435,9 +447,9 @@ _compute_ndc_to_device_map (plPlotterData *data)
 
   /* compute map #1 as product of maps 1a, 1b, 1c */
 
-  rotation_s = (const char *)_get_plot_param (data, "ROTATION");
+  rotation_s = (const char *)_get_plot_param (data, PL_PARAM_ROTATION);
   if (rotation_s == NULL)
-    rotation_s = (const char *)_get_default_plot_param ("ROTATION");
+    rotation_s = (const char *)_get_default_plot_param (PL_PARAM_ROTATION);
 
   if (strcmp (rotation_s, "no") == 0)
     rotation_angle = 0.0;	/* "no" means 0 degrees */
@@ -30,7 +30,11 @@
    contain no more than 2**MAX_NUM_BEZIER2_SUBDIVISIONS and
    2**MAX_NUM_BEZIER3_SUBDIVISIONS line segments.  However, each bisection
    algorithm used for drawing a Bezier normally usually its recursion based
-   on a relative flatness criterion (see below). */
+   on a relative flatness criterion (see below).
+
+   If the path being added to has a nonzero `flatness' field, set from the
+   FLATNESS parameter, each of these algorithms instead subdivides until
+   every line segment lies within that distance of the curve. */
 
 #include "sys-defines.h"
 #include "extern.h"
@@ -57,7 +61,15 @@
 #define REL_QUAD_FLATNESS 5e-4
 #define REL_CUBIC_FLATNESS 5e-4
 
+/* If a path has a nonzero `flatness' field (see the FLATNESS parameter),
+   arcs and Beziers are instead subdivided until each line segment in the
+   polygonal approximation deviates from the curve by no more than that
+   distance, in user coordinates; or until they have been subdivided this
+   many times. */
+#define MAX_ADAPTIVE_SUBDIVISIONS TABULATED_ARC_SUBDIVISIONS
+
 #define DATAPOINTS_BUFSIZ PL_MAX_UNFILLED_PATH_LENGTH
+#define NUM_CURVES_BUFSIZ 16
 #define DIST(p0,p1) (sqrt( ((p0).x - (p1).x)*((p0).x - (p1).x) \
 			  + ((p0).y - (p1).y)*((p0).y - (p1).y)))
 
@@ -65,7 +77,8 @@
 
 /* forward references */
 static void _prepare_chord_table (double sagitta, double custom_chord_table[TABULATED_ARC_SUBDIVISIONS]);
-static void _fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *custom_chord_table, const double m[4]);
+static int _num_arc_subdivisions (double sagitta, double size, double flatness);
+static void _fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *custom_chord_table, const double m[4], int num_subdivisions);
 
 /* ctor for plPath class; constructs an empty plPath, with type set to
    PATH_SEGMENT_LIST (default type) */
@@ -77,11 +90,16 @@ _new_plPath (void)
   path = (plPath *)_pl_xmalloc (sizeof (plPath));
 
   path->type = PATH_SEGMENT_LIST;
-  path->segments = (plPathSegment *)NULL;
+  path->points = (plPoint *)NULL;
   path->segments_len = 0;	/* number of slots allocated */
   path->num_segments = 0;	/* number of slots occupied */
+  path->curves = (plPathCurve *)NULL;
+  path->curves_len = 0;
+  path->num_curves = 0;
 
   path->primitive = false;
+  path->flatness = 0.0;
+  path->flattened_vertices = 0;
   path->llx = DBL_MAX;
   path->lly = DBL_MAX;
   path->urx = -(DBL_MAX);
@@ -97,34 +115,138 @@ _delete_plPath (plPath *path)
   if (path == (plPath *)NULL)
     return;
   
-  if (path->type == PATH_SEGMENT_LIST 
-      && path->segments_len > 0) /* number of slots allocated */
-    free (path->segments);
+  /* a path of any type may hold storage, if it was recycled (see below) */
+  if (path->segments_len > 0)	/* number of slots allocated */
+    free (path->points);
+  if (path->curves_len > 0)
+    free (path->curves);
   free (path);
 }
 
-/* reset function for plPath class */
+/* reset function for plPath class; the path becomes empty, but the
+   storage allocated for its segment list is retained */
 void
 _reset_plPath (plPath *path)
 {
   if (path == (plPath *)NULL)
     return;
   
-  if (path->type == PATH_SEGMENT_LIST 
-      && path->segments_len > 0) /* number of slots allocated */
-    free (path->segments);
-  path->segments = (plPathSegment *)NULL;
-  path->segments_len = 0;
   path->type = PATH_SEGMENT_LIST; /* restore to default */
   path->num_segments = 0;
+  path->num_curves = 0;
   
   path->primitive = false;
+  path->flatness = 0.0;
+  path->flattened_vertices = 0;
   path->llx = DBL_MAX;
   path->lly = DBL_MAX;
   path->urx = -(DBL_MAX);
   path->ury = -(DBL_MAX);
 }
 
+/* Paths are constructed and discarded at a high rate (by default, an
+   unfilled polyline is flushed out every PL_MAX_UNFILLED_PATH_LENGTH
+   points), so a Plotter keeps a few discarded paths, together with their
+   segment storage, for reuse by later paths on the same page.
+   _reuse_plPath() returns an empty path, with the specified flatness
+   (in user coordinates; see _flatten_path()), and _recycle_plPath()
+   disposes of a path that is no longer needed, adding the number of
+   vertices produced by flattening curves in it to the Plotter's count.
+   The spare paths are freed by _delete_spare_plPaths(), which closepl()
+   invokes. */
+
+/* A path whose storage has grown beyond this many segments isn't kept. */
+#define MAX_SPARE_PATH_LEN (64 * DATAPOINTS_BUFSIZ)
+
+plPath *
+_reuse_plPath (plPlotterData *data, double flatness)
+{
+  plPath *path;
+
+  if (data->num_spare_paths > 0)
+    path = data->spare_paths[--(data->num_spare_paths)];
+  else
+    path = _new_plPath ();
+  path->flatness = flatness;
+
+  return path;
+}
+
+void
+_recycle_plPath (plPlotterData *data, plPath *path)
+{
+  if (path == (plPath *)NULL)
+    return;
+
+  data->flattened_vertices += path->flattened_vertices;
+  if (data->num_spare_paths < PL_NUM_SPARE_PATHS
+      && path->segments_len <= MAX_SPARE_PATH_LEN)
+    {
+      _reset_plPath (path);
+      data->spare_paths[(data->num_spare_paths)++] = path;
+    }
+  else
+    _delete_plPath (path);
+}
+
+void
+_delete_spare_plPaths (plPlotterData *data)
+{
+  while (data->num_spare_paths > 0)
+    _delete_plPath (data->spare_paths[--(data->num_spare_paths)]);
+}
+
+/* Internal functions that make room in the segment list for n more
+   segments, and for one more entry in the side table of curves. */
+
+static void
+_grow_segments (plPath *path, int n)
+{
+  int new_len;
+
+  if (path->num_segments + n <= path->segments_len)
+    return;
+
+  new_len = (path->segments_len > 0 ? path->segments_len : DATAPOINTS_BUFSIZ);
+  while (path->num_segments + n > new_len)
+    new_len *= 2;
+  if (path->segments_len > 0)
+    path->points = (plPoint *)
+      _pl_xrealloc (path->points, new_len * sizeof(plPoint));
+  else
+    path->points = (plPoint *)_pl_xmalloc (new_len * sizeof(plPoint));
+  path->segments_len = new_len;
+}
+
+static plPathCurve *
+_new_curve (plPath *path, plPathSegmentType type)
+{
+  plPathCurve *curve;
+
+  if (path->num_curves == path->curves_len)
+    /* full, so reallocate */
+    {
+      if (path->curves_len > 0)
+	{
+	  path->curves = (plPathCurve *)
+	    _pl_xrealloc (path->curves, 
+			  2 * path->curves_len * sizeof(plPathCurve));
+	  path->curves_len *= 2;
+	}
+      else
+	{
+	  path->curves = (plPathCurve *)
+	    _pl_xmalloc (NUM_CURVES_BUFSIZ * sizeof(plPathCurve));
+	  path->curves_len = NUM_CURVES_BUFSIZ;
+	}
+    }
+
+  curve = &(path->curves[(path->num_curves)++]);
+  curve->index = path->num_segments;
+  curve->type = type;
+  return curve;
+}
+
 void
 _add_moveto (plPath *path, plPoint p)
 {
@@ -134,13 +256,10 @@ _add_moveto (plPath *path, plPoint p)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments > 0)
     return;
   
-  /* empty, so allocate a segment buffer */
-  path->segments = (plPathSegment *) 
-    _pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-  path->segments_len = DATAPOINTS_BUFSIZ;
+  /* empty, so allocate a segment buffer if there isn't one */
+  _grow_segments (path, 1);
   
-  path->segments[0].type = S_MOVETO;
-  path->segments[0].p = p;
+  path->points[0] = p;
   path->num_segments = 1;
   
   path->llx = p.x;
@@ -158,25 +277,11 @@ _add_line (plPath *path, plPoint p)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
   if (path->num_segments == path->segments_len)
     /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
+    _grow_segments (path, 1);
   
-  path->segments[path->num_segments].type = S_LINE;
-  path->segments[path->num_segments].p = p;
+  path->points[path->num_segments] = p;
   path->num_segments++;
   
   path->llx = DMIN(path->llx, p.x);
@@ -185,6 +290,46 @@ _add_line (plPath *path, plPoint p)
   path->ury = DMAX(path->ury, p.y);
 }
 
+/* Add n line segments, with endpoints (x[i],y[i]), in a single operation.
+   The segment buffer is enlarged at most once, and the bounding box is
+   updated only at the end. */
+void
+_add_lines (plPath *path, int n, const double *x, const double *y)
+{
+  plPoint *point;
+  double llx, lly, urx, ury;
+  int i;
+
+  if (path == (plPath *)NULL || n <= 0)
+    return;
+
+  if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
+    return;
+
+  _grow_segments (path, n);
+
+  llx = path->llx;
+  lly = path->lly;
+  urx = path->urx;
+  ury = path->ury;
+  point = path->points + path->num_segments;
+  for (i = 0; i < n; i++, point++)
+    {
+      point->x = x[i];
+      point->y = y[i];
+      llx = DMIN(llx, x[i]);
+      lly = DMIN(lly, y[i]);
+      urx = DMAX(urx, x[i]);
+      ury = DMAX(ury, y[i]);
+    }
+  path->num_segments += n;
+
+  path->llx = llx;
+  path->lly = lly;
+  path->urx = urx;
+  path->ury = ury;
+}
+
 void
 _add_closepath (plPath *path)
 {
@@ -194,150 +339,197 @@ _add_closepath (plPath *path)
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)	/* meaningless */
-    return;
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_CLOSEPATH;
-  path->segments[path->num_segments].p = path->segments[0].p;
+  _grow_segments (path, 1);
+  _new_curve (path, S_CLOSEPATH);
+  path->points[path->num_segments] = path->points[0];
   path->num_segments++;
 }
 
 void
 _add_bezier2 (plPath *path, plPoint pc, plPoint p)
 {
+  plPathCurve *curve;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_QUAD;
-  path->segments[path->num_segments].p = p;
-  path->segments[path->num_segments].pc = pc;
+  _grow_segments (path, 1);
+  curve = _new_curve (path, S_QUAD);
+  curve->pc = pc;
+  path->points[path->num_segments] = p;
   path->num_segments++;
 }
 
 void
 _add_bezier3 (plPath *path, plPoint pc, plPoint pd, plPoint p)
 {
+  plPathCurve *curve;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_CUBIC;
-  path->segments[path->num_segments].p = p;
-  path->segments[path->num_segments].pc = pc;
-  path->segments[path->num_segments].pd = pd;
+  _grow_segments (path, 1);
+  curve = _new_curve (path, S_CUBIC);
+  curve->pc = pc;
+  curve->pd = pd;
+  path->points[path->num_segments] = p;
   path->num_segments++;
 }
 
 void
 _add_arc (plPath *path, plPoint pc, plPoint p1)
 {
+  plPathCurve *curve;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
-    }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
-    {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
-    }
-  
-  path->segments[path->num_segments].type = S_ARC;
-  path->segments[path->num_segments].p = p1;
-  path->segments[path->num_segments].pc = pc;
+  _grow_segments (path, 1);
+  curve = _new_curve (path, S_ARC);
+  curve->pc = pc;
+  path->points[path->num_segments] = p1;
   path->num_segments++;
 }
 
 void
 _add_ellarc (plPath *path, plPoint pc, plPoint p1)
 {
+  plPathCurve *curve;
+
   if (path == (plPath *)NULL)
     return;
   
   if (path->type != PATH_SEGMENT_LIST || path->num_segments == 0)
     return;
   
-  if (path->num_segments == 0)
-    /* empty, so allocate a segment buffer */
+  _grow_segments (path, 1);
+  curve = _new_curve (path, S_ELLARC);
+  curve->pc = pc;
+  path->points[path->num_segments] = p1;
+  path->num_segments++;
+}
+
+/* Remove all segments after the first n, e.g. so that a single arc may be
+   replaced by its polygonal approximation. */
+void
+_truncate_plPath (plPath *path, int n)
+{
+  if (path == (plPath *)NULL || path->type != PATH_SEGMENT_LIST
+      || n < 0 || n >= path->num_segments)
+    return;
+
+  path->num_segments = n;
+  while (path->num_curves > 0 
+	 && path->curves[path->num_curves - 1].index >= n)
+    path->num_curves--;
+}
+
+/* Segment list accessors.  A segment list is stored compactly: the
+   endpoint of each segment is kept in the `points' array, and only those
+   segments that are neither the initial moveto nor a line segment appear
+   in the `curves' side table, which is sorted by segment index.  So a
+   polyline requires no storage beyond its vertices. */
+
+/* Return the side-table entry for segment i, or NULL if it's a moveto or
+   a line segment. */
+const plPathCurve *
+_path_curve (const plPath *path, int i)
+{
+  int lo = 0, hi = path->num_curves - 1;
+
+  while (lo <= hi)
     {
-      path->segments = (plPathSegment *) 
-	_pl_xmalloc (DATAPOINTS_BUFSIZ * sizeof(plPathSegment));
-      path->segments_len = DATAPOINTS_BUFSIZ;
+      int mid = (lo + hi) / 2;
+      
+      if (path->curves[mid].index < i)
+	lo = mid + 1;
+      else if (path->curves[mid].index > i)
+	hi = mid - 1;
+      else
+	return &(path->curves[mid]);
     }
-  
-  if (path->num_segments == path->segments_len)
-    /* full, so reallocate */
+  return (const plPathCurve *)NULL;
+}
+
+plPathSegmentType
+_path_segment_type (const plPath *path, int i)
+{
+  const plPathCurve *curve;
+
+  if (i == 0)
+    return S_MOVETO;
+  if (path->num_curves == 0)
+    return S_LINE;
+  curve = _path_curve (path, i);
+  return (curve ? curve->type : S_LINE);
+}
+
+/* Fill in a full description of segment i. */
+void
+_get_path_segment (const plPath *path, int i, plPathSegment *segment)
+{
+  const plPathCurve *curve;
+
+  segment->p = path->points[i];
+  if (i == 0)
+    segment->type = S_MOVETO;
+  else if (path->num_curves == 0 
+	   || (curve = _path_curve (path, i)) == (const plPathCurve *)NULL)
+    segment->type = S_LINE;
+  else
     {
-      path->segments = (plPathSegment *) 
-	_pl_xrealloc (path->segments, 
-			2 * path->segments_len * sizeof(plPathSegment));
-      path->segments_len *= 2;
+      segment->type = curve->type;
+      segment->pc = curve->pc;
+      segment->pd = curve->pd;
     }
-  
-  path->segments[path->num_segments].type = S_ELLARC;
-  path->segments[path->num_segments].p = p1;
-  path->segments[path->num_segments].pc = pc;
-  path->num_segments++;
+}
+
+/* Iteration over a segment list, in order, starting at segment `start';
+   this takes constant time per segment. */
+void
+_path_iter_start (plPathIterator *iter, const plPath *path, int start)
+{
+  int curve = 0;
+
+  while (curve < path->num_curves && path->curves[curve].index < start)
+    curve++;
+  iter->path = path;
+  iter->index = start;
+  iter->curve = curve;
+}
+
+bool
+_path_iter_next (plPathIterator *iter, plPathSegment *segment)
+{
+  const plPath *path = iter->path;
+  int i = iter->index;
+
+  if (i >= path->num_segments)
+    return false;
+
+  segment->p = path->points[i];
+  if (iter->curve < path->num_curves && path->curves[iter->curve].index == i)
+    {
+      const plPathCurve *curve = &(path->curves[(iter->curve)++]);
+
+      segment->type = curve->type;
+      segment->pc = curve->pc;
+      segment->pd = curve->pd;
+    }
+  else
+    segment->type = (i == 0 ? S_MOVETO : S_LINE);
+  iter->index++;
+
+  return true;
 }
 
 void
@@ -425,7 +617,7 @@ _add_arc_as_lines (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   if (p0.x == p1.x && p0.y == p1.y)
     /* zero-length arc, draw as zero-length line segment */
@@ -469,7 +661,8 @@ _add_arc_as_lines (plPath *path, plPoint pc, plPoint p1)
 	 counterclockwise rotation by 90 degrees, depending on orientation */
 
       m[0] = 0.0, m[1] = orientation, m[2] = -orientation, m[3] = 0.0;
-      _fakearc (path, p0, p1, USER_DEFINED_ARC, custom_chord_table, m);
+      _fakearc (path, p0, p1, USER_DEFINED_ARC, custom_chord_table, m,
+		_num_arc_subdivisions (sagitta, radius, path->flatness));
     }
 }
 
@@ -498,7 +691,7 @@ _add_ellarc_as_lines (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors from pc to p0, and pc to p1 */
   v0.x = p0.x - pc.x;
@@ -520,8 +713,17 @@ _add_ellarc_as_lines (plPath *path, plPoint pc, plPoint p1)
       m[2] = - (v0.y * v0.y + v1.y * v1.y) / cross;
       m[3] = (v0.x * v0.y + v1.x * v1.y) / cross;
       
-      /* draw polyline inscribed in the quarter-ellipse */
-      _fakearc (path, p0, p1, QUARTER_ARC, (double *)NULL, m);
+      /* Draw polyline inscribed in the quarter-ellipse, which is the image
+	 of a quarter-circle of unit radius under the map taking (1,0) to v0
+	 and (0,1) to v1; that map stretches the chordal deviation by at
+	 most its norm. */
+      double v[6];
+
+      v[0] = v0.x, v[1] = v0.y, v[2] = v1.x, v[3] = v1.y;
+      v[4] = v[5] = 0.0;
+      _fakearc (path, p0, p1, QUARTER_ARC, (double *)NULL, m,
+		_num_arc_subdivisions (1.0 - 0.5 * M_SQRT2, _matrix_norm (v),
+				       path->flatness));
     }
 }
 
@@ -564,7 +766,7 @@ _add_arc_as_bezier3 (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors to starting, ending points */
   v0.x = p0.x - pc.x;
@@ -660,7 +862,7 @@ _add_ellarc_as_bezier3 (plPath *path, plPoint pc, plPoint p1)
     return;
       
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
 
   /* vectors to starting, ending points */
   v0.x = p0.x - pc.x;
@@ -686,10 +888,11 @@ _add_ellarc_as_bezier3 (plPath *path, plPoint pc, plPoint p1)
 void
 _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
 {
-  plPoint r0[MAX_NUM_BEZIER2_SUBDIVISIONS + 1], r1[MAX_NUM_BEZIER2_SUBDIVISIONS + 1], r2[MAX_NUM_BEZIER2_SUBDIVISIONS + 1];
-  int level[MAX_NUM_BEZIER2_SUBDIVISIONS + 1];
-  int n = 0;	/* index of top of stack, < MAX_NUM_BEZIER2_SUBDIVISIONS */
+  plPoint r0[MAX_ADAPTIVE_SUBDIVISIONS + 1], r1[MAX_ADAPTIVE_SUBDIVISIONS + 1], r2[MAX_ADAPTIVE_SUBDIVISIONS + 1];
+  int level[MAX_ADAPTIVE_SUBDIVISIONS + 1];
+  int n = 0;	/* index of top of stack, < max_level */
   int segments_drawn = 0;
+  int max_level;
   plPoint p0;
   double sqdist, max_squared_length;
       
@@ -700,11 +903,20 @@ _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
     return;
   
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
   
   /* squared distance between p0 and p */
   sqdist = (p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y);
   max_squared_length = REL_QUAD_FLATNESS * REL_QUAD_FLATNESS * sqdist;
+  max_level = MAX_NUM_BEZIER2_SUBDIVISIONS;
+
+  if (path->flatness > 0.0)
+    /* A quadratic Bezier deviates from its chord by at most a quarter of
+       the length of p0-2*p1+p2. */
+    {
+      max_squared_length = 16.0 * path->flatness * path->flatness;
+      max_level = MAX_ADAPTIVE_SUBDIVISIONS;
+    }
 
   r0[0] = p0;
   r1[0] = pc;
@@ -720,7 +932,7 @@ _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
       q1 = r1[n];
       q2 = r2[n];
       
-      if (current_level >= MAX_NUM_BEZIER2_SUBDIVISIONS) 
+      if (current_level >= max_level) 
 	/* to avoid stack overflow, draw as line segment */
 	{
 	  _add_line (path, q2);
@@ -772,6 +984,8 @@ _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
 	    }
 	}
     }
+
+  path->flattened_vertices += segments_drawn;
 }
 
 /* Approximate a cubic Bezier by a polyline: standard deCasteljau bisection
@@ -784,10 +998,11 @@ _add_bezier2_as_lines (plPath *path, plPoint pc, plPoint p)
 void
 _add_bezier3_as_lines (plPath *path, plPoint pc, plPoint pd, plPoint p)
 {
-  plPoint r0[MAX_NUM_BEZIER3_SUBDIVISIONS + 1], r1[MAX_NUM_BEZIER3_SUBDIVISIONS + 1], r2[MAX_NUM_BEZIER3_SUBDIVISIONS + 1], r3[MAX_NUM_BEZIER3_SUBDIVISIONS + 1];
-  int level[MAX_NUM_BEZIER3_SUBDIVISIONS + 1];
-  int n = 0;	/* index of top of stack, < MAX_NUM_BEZIER3_SUBDIVISIONS */
+  plPoint r0[MAX_ADAPTIVE_SUBDIVISIONS + 1], r1[MAX_ADAPTIVE_SUBDIVISIONS + 1], r2[MAX_ADAPTIVE_SUBDIVISIONS + 1], r3[MAX_ADAPTIVE_SUBDIVISIONS + 1];
+  int level[MAX_ADAPTIVE_SUBDIVISIONS + 1];
+  int n = 0;	/* index of top of stack, < max_level */
   int segments_drawn = 0;
+  int max_level;
   plPoint p0;
   double sqdist, max_squared_length;
   
@@ -798,11 +1013,20 @@ _add_bezier3_as_lines (plPath *path, plPoint pc, plPoint pd, plPoint p)
     return;
   
   /* determine starting point */
-  p0 = path->segments[path->num_segments - 1].p;
+  p0 = path->points[path->num_segments - 1];
   
   /* squared distance between p0 and p */
   sqdist = (p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y);
   max_squared_length = REL_CUBIC_FLATNESS * REL_CUBIC_FLATNESS * sqdist;
+  max_level = MAX_NUM_BEZIER3_SUBDIVISIONS;
+
+  if (path->flatness > 0.0)
+    /* A cubic Bezier deviates from its chord by at most three quarters of
+       the greater of the lengths of p0-2*p1+p2 and p1-2*p2+p3. */
+    {
+      max_squared_length = (16.0 / 9.0) * path->flatness * path->flatness;
+      max_level = MAX_ADAPTIVE_SUBDIVISIONS;
+    }
 
   r0[0] = p0;
   r1[0] = pc;
@@ -821,7 +1045,7 @@ _add_bezier3_as_lines (plPath *path, plPoint pc, plPoint pd, plPoint p)
       q2 = r2[n];
       q3 = r3[n];
       
-      if (current_level >= MAX_NUM_BEZIER3_SUBDIVISIONS) 
+      if (current_level >= max_level) 
 	/* draw line segment, to avoid stack overflow */
 	{
 	  _add_line (path, q3);
@@ -886,6 +1110,8 @@ _add_bezier3_as_lines (plPath *path, plPoint pc, plPoint pd, plPoint p)
 	    }
 	}
     }
+
+  path->flattened_vertices += segments_drawn;
 }
   
 void
@@ -1198,11 +1424,11 @@ _add_circle_as_lines (plPath *path, plPoint pc, double radius, bool clockwise)
    points). */
 
 static void 
-_fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *custom_chord_table, const double m[4])
+_fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *custom_chord_table, const double m[4], int num_subdivisions)
 {
-  plPoint p[NUM_ARC_SUBDIVISIONS + 1], q[NUM_ARC_SUBDIVISIONS + 1];
-  int level[NUM_ARC_SUBDIVISIONS + 1];
-  int n = 0;	/* index of top of stack, < NUM_ARC_SUBDIVISIONS */
+  plPoint p[TABULATED_ARC_SUBDIVISIONS + 1], q[TABULATED_ARC_SUBDIVISIONS + 1];
+  int level[TABULATED_ARC_SUBDIVISIONS + 1];
+  int n = 0;	/* index of top of stack, < num_subdivisions */
   int segments_drawn = 0;
   const double *our_chord_table;
 
@@ -1216,7 +1442,7 @@ _fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *cust
   level[0] = 0;
   while (n >= 0)		/* i.e. while stack is nonempty */
     {
-      if (level[n] >= NUM_ARC_SUBDIVISIONS) 
+      if (level[n] >= num_subdivisions) 
 	{			/* draw line segment */
 	  _add_line (path, q[n]);
 	  segments_drawn++;
@@ -1255,6 +1481,33 @@ _fakearc (plPath *path, plPoint p0, plPoint p1, int arc_type, const double *cust
 	  n++;
 	}
     }
+
+  path->flattened_vertices += segments_drawn;
+}
+
+/* _num_arc_subdivisions() returns the number of times _fakearc() should
+   bisect an arc, given the arc's (chordal deviation)/radius `sagitta', and
+   `size', its radius or (for a quarter-ellipse) an upper bound on the
+   factor by which the affine map taking a unit quarter-circle to it
+   stretches distances.  If the flatness is zero, the fixed number
+   NUM_ARC_SUBDIVISIONS is returned; otherwise the smallest number that
+   brings the chordal deviation of each piece within the flatness. */
+static int
+_num_arc_subdivisions (double sagitta, double size, double flatness)
+{
+  int num_subdivisions = 0;
+
+  if (flatness <= 0.0)
+    return NUM_ARC_SUBDIVISIONS;
+
+  while (num_subdivisions < MAX_ADAPTIVE_SUBDIVISIONS 
+	 && size * sagitta > flatness)
+    {
+      sagitta = 1.0 - sqrt (1.0 - 0.5 * sagitta);
+      num_subdivisions++;
+    }
+
+  return num_subdivisions;
 }
 
 /* prepare_chord_table() computes the list of chordal deviation factors
@@ -1284,7 +1537,8 @@ _prepare_chord_table (double sagitta, double custom_chord_table[TABULATED_ARC_SU
    of line segments (with an initial moveto and possibly a final
    closepath), it is returned unchanged; this can be tested for by
    comparing pointers for equality.  If a new path is returned, it must be
-   freed with _delete_plPath(). */
+   freed with _delete_plPath() or _recycle_plPath().  It is flattened to
+   the same tolerance as the supplied path (see the `flatness' field). */
 
 plPath *
 _flatten_path (const plPath *path)
@@ -1301,11 +1555,10 @@ _flatten_path (const plPath *path)
 	bool do_flatten = false;
 	int i;
 
-	for (i = 0; i < path->num_segments; i++)
+	for (i = 0; i < path->num_curves; i++)
 	  {
-	    if (path->segments[i].type != S_MOVETO
-		&& path->segments[i].type != S_LINE
-		&& path->segments[i].type != S_CLOSEPATH)
+	    if (path->curves[i].type != S_MOVETO
+		&& path->curves[i].type != S_CLOSEPATH)
 	      {
 		do_flatten = true;
 		break;
@@ -1316,16 +1569,21 @@ _flatten_path (const plPath *path)
 	  newpath = (plPath *)path; /* just return original path */
 	else
 	  {
+	    plPathIterator iter;
+	    plPathSegment segment;
+
 	    newpath = _new_plPath ();
-	    for (i = 0; i < path->num_segments; i++)
+	    newpath->flatness = path->flatness;
+	    _path_iter_start (&iter, path, 0);
+	    while (_path_iter_next (&iter, &segment))
 	      {
-		switch ((int)(path->segments[i].type))
+		switch ((int)(segment.type))
 		  {
 		  case (int)S_MOVETO:
-		    _add_moveto (newpath, path->segments[i].p);
+		    _add_moveto (newpath, segment.p);
 		    break;
 		  case (int)S_LINE:
-		    _add_line (newpath, path->segments[i].p);
+		    _add_line (newpath, segment.p);
 		    break;
 		  case (int)S_CLOSEPATH:
 		    _add_closepath (newpath);
@@ -1335,24 +1593,24 @@ _flatten_path (const plPath *path)
 
 		  case (int)S_ARC:
 		    _add_arc_as_lines (newpath, 
-				       path->segments[i].pc, 
-				       path->segments[i].p);
+				       segment.pc, 
+				       segment.p);
 		    break;
 		  case (int)S_ELLARC:
 		    _add_ellarc_as_lines (newpath, 
-					  path->segments[i].pc, 
-					  path->segments[i].p);
+					  segment.pc, 
+					  segment.p);
 		    break;
 		  case (int)S_QUAD:
 		    _add_bezier2_as_lines (newpath, 
-					   path->segments[i].pc, 
-					   path->segments[i].p);
+					   segment.pc, 
+					   segment.p);
 		    break;
 		  case (int)S_CUBIC:
 		    _add_bezier3_as_lines (newpath, 
-					   path->segments[i].pc, 
-					   path->segments[i].pd, 
-					   path->segments[i].p);
+					   segment.pc, 
+					   segment.pd, 
+					   segment.p);
 		    break;
 		  default:	/* shouldn't happen */
 		    break;
@@ -1363,11 +1621,13 @@ _flatten_path (const plPath *path)
       }
     case PATH_CIRCLE:
       newpath = _new_plPath ();
+      newpath->flatness = path->flatness;
       _add_circle_as_lines (newpath, 
 			    path->pc, path->radius, path->clockwise);
       break;
     case PATH_ELLIPSE:
       newpath = _new_plPath ();
+      newpath->flatness = path->flatness;
       _add_ellipse_as_lines (newpath, 
 			     path->pc, path->rx, path->ry, path->angle,
 			     path->clockwise);
@@ -1383,6 +1643,175 @@ _flatten_path (const plPath *path)
   return newpath;
 }
 
+/* Decimate a polyline, i.e. a simple path of segment list type consisting
+   only of line segments, in place.  The affine map m takes the user frame
+   to the device frame, which is divided into vertical strips (`columns')
+   of width `tolerance'.  Each maximal run of consecutive vertices that lie
+   in the same column is replaced by at most four of them, in their
+   original order: the first and last, and those with the least and
+   greatest y coordinates in the device frame.  Within a column, the
+   original polyline passes through every y value between the least and
+   greatest, so each point of either polyline is within `tolerance' of the
+   other (in the device frame).  Dense data, such as a long time series
+   plotted on a narrower bitmap, is reduced to a few vertices per column.
+
+   If the polyline will be drawn with mitered joins, half_width is half
+   the line width in the device frame (otherwise it is zero).  A miter
+   join reaches beyond the edges of the line, by half_width times one less
+   than its miter ratio, unless that ratio exceeds miter_limit and it is
+   beveled instead.  Decimation removes joins, and changes the angles of
+   others; so it is abandoned if a join that it removes or changes
+   reaches more than `tolerance' beyond the line.  Return the number of
+   vertices dropped. */
+
+/* how far a miter join at b, between segments from a and to c, reaches
+   beyond the edges of the line (in the device frame) */
+static double
+_miter_excess (const double m[6], plPoint a, plPoint b, plPoint c, double half_width, double miter_limit)
+{
+  double ux, uy, vx, vy, len_u, len_v, cosine, ratio;
+
+  ux = m[0] * (a.x - b.x) + m[2] * (a.y - b.y);
+  uy = m[1] * (a.x - b.x) + m[3] * (a.y - b.y);
+  vx = m[0] * (c.x - b.x) + m[2] * (c.y - b.y);
+  vy = m[1] * (c.x - b.x) + m[3] * (c.y - b.y);
+  len_u = sqrt (ux * ux + uy * uy);
+  len_v = sqrt (vx * vx + vy * vy);
+  if (len_u == 0.0 || len_v == 0.0)
+    return 0.0;
+  /* cosine of the angle between the segments; miter ratio is
+     1/sin(angle/2) */
+  cosine = (ux * vx + uy * vy) / (len_u * len_v);
+  if (cosine >= 1.0)
+    return 0.0;			/* segments double back: beveled */
+  ratio = sqrt (2.0 / (1.0 - cosine));
+  if (ratio > miter_limit)
+    return 0.0;			/* beveled */
+  return half_width * (ratio - 1.0);
+}
+
+int
+_decimate_path (plPath *path, const double m[6], double tolerance, double half_width, double miter_limit)
+{
+  plPoint *points;
+  double inv_tolerance;
+  int *kept;
+  int n, i, num_kept;
+
+  if (path == (plPath *)NULL || tolerance <= 0.0)
+    return 0;
+  if (path->type != PATH_SEGMENT_LIST || path->num_curves > 0
+      || path->num_segments < 5)
+    return 0;
+
+  points = path->points;
+  n = path->num_segments;
+  inv_tolerance = 1.0 / tolerance;
+
+  /* indices of the vertices to keep, in increasing order */
+  kept = (int *)_pl_xmalloc (n * sizeof(int));
+  num_kept = 0;
+  i = 0;
+  while (i < n)
+    {
+      double column, y, ymin, ymax;
+      int j, jmin, jmax, keep[4], num_keep, k;
+
+      column = floor ((m[0] * points[i].x + m[2] * points[i].y + m[4])
+		      * inv_tolerance);
+      ymin = ymax = m[1] * points[i].x + m[3] * points[i].y + m[5];
+      jmin = jmax = i;
+      for (j = i + 1; j < n; j++)
+	{
+	  if (floor ((m[0] * points[j].x + m[2] * points[j].y + m[4])
+		     * inv_tolerance) != column)
+	    break;
+	  y = m[1] * points[j].x + m[3] * points[j].y + m[5];
+	  if (y < ymin)
+	    {
+	      ymin = y;
+	      jmin = j;
+	    }
+	  else if (y > ymax)
+	    {
+	      ymax = y;
+	      jmax = j;
+	    }
+	}
+      j--;			/* last vertex in the column */
+
+      num_keep = 0;
+      keep[num_keep++] = i;
+      if (jmin < jmax)
+	{
+	  keep[num_keep++] = jmin;
+	  keep[num_keep++] = jmax;
+	}
+      else
+	{
+	  keep[num_keep++] = jmax;
+	  keep[num_keep++] = jmin;
+	}
+      keep[num_keep++] = j;
+      for (k = 0; k < num_keep; k++)
+	if (k == 0 || keep[k] != keep[k - 1])
+	  kept[num_kept++] = keep[k];
+
+      i = j + 1;
+    }
+
+  if (half_width > 0.0 && num_kept < n)
+    /* check the joins that are removed, and those whose neighbors change */
+    {
+      bool closed, ok = true;
+      int k;
+
+      for (k = 1; k < num_kept - 1 && ok; k++)
+	{
+	  int prev = kept[k - 1], next = kept[k + 1];
+
+	  for (i = prev + 1; i < kept[k] && ok; i++) /* removed */
+	    if (_miter_excess (m, points[i - 1], points[i], points[i + 1], 
+			       half_width, miter_limit) > tolerance)
+	      ok = false;
+	  if (ok && (prev != kept[k] - 1 || next != kept[k] + 1)
+	      && _miter_excess (m, points[prev], points[kept[k]], points[next],
+				half_width, miter_limit) > tolerance)
+	    ok = false;
+	}
+      for (i = kept[num_kept - 2] + 1; i < n - 1 && ok; i++) /* removed */
+	if (_miter_excess (m, points[i - 1], points[i], points[i + 1], 
+			   half_width, miter_limit) > tolerance)
+	  ok = false;
+
+      /* a closed polyline also has a join at its first vertex */
+      closed = (points[0].x == points[n - 1].x 
+		&& points[0].y == points[n - 1].y);
+      if (ok && closed && num_kept >= 3
+	  && (kept[1] != 1 || kept[num_kept - 2] != n - 2)
+	  && _miter_excess (m, points[kept[num_kept - 2]], points[0], 
+			    points[kept[1]], half_width, miter_limit)
+	     > tolerance)
+	ok = false;
+
+      if (!ok)
+	{
+	  free (kept);
+	  return 0;
+	}
+    }
+
+  /* copy the kept vertices down; since the indices increase, no vertex is
+     overwritten before it is copied */
+  for (i = 0; i < num_kept; i++)
+    points[i] = points[kept[i]];
+  free (kept);
+
+  path->num_segments = num_kept;
+
+  return n - num_kept;
+}
+
 /**********************************************************************/
 
 /* The code below exports the _merge_paths() function, which munges an
@@ -1420,6 +1849,56 @@ _flatten_path (const plPath *path)
    if its last defining vertex is the same as the first.  THIS CONVENTION
    WILL GO AWAY. */
 
+/* Finding the subpaths that contain a given subpath, and the closest
+   pair of vertices in two subpaths, would take time quadratic in the
+   number of subpaths and in their sizes, if done naively.  So the code
+   below uses several simple spatial indices, all built on demand:
+
+   1. a uniform grid of cells, each listing the subpaths whose bounding
+      boxes meet it (very large subpaths are kept in a separate list),
+      for finding the subpaths that may contain a given one;
+   2. for a subpath with many segments, a uniform grid of cells, each
+      listing the segments that meet it, for counting the crossings of a
+      ray with the subpath;
+   3. for a subpath with many vertices, a k-d tree of its vertices, for
+      finding the vertex nearest a given point;
+   4. for a parent subpath, a binary tree of its children, for finding
+      the child nearest the merged path, and the children that may be
+      nearer a newly inserted child than to the rest of the merged path.
+
+   None of them changes the result: wherever the naive algorithm would
+   break a tie by taking the first candidate, so do these. */
+
+/* A uniform grid of cells covering a rectangle, in which each item (a
+   subpath, or a segment of a subpath) is listed in each cell that its
+   bounding box meets.  Within each cell, items appear in increasing
+   order. */
+
+typedef struct
+{
+  double llx, lly;		/* lower left corner of grid */
+  double cell_width, cell_height;
+  double inv_cell_width, inv_cell_height; /* 0.0 if dimension is zero */
+  int nx, ny;			/* number of columns, rows */
+  int *cell_start;		/* cell c's items are items[cell_start[c]] .. */
+  int *items;			/* .. items[cell_start[c+1] - 1] */
+  int *marks;			/* per-item marks, for visiting items once */
+  int mark;			/* current mark */
+  bool incomplete;		/* some item had a non-numeric bounding box */
+} cell_grid;
+
+/* An entry in a k-d tree of vertices.  The tree is stored implicitly: the
+   entries in positions lo..hi-1 form a subtree whose root is at position
+   (lo+hi)/2, and whose left and right subtrees are on either side. */
+
+typedef struct
+{
+  plPoint p;			/* vertex */
+  int index;			/* index of vertex in subpath */
+  int axis;			/* 0 or 1: subtree is split on x or y */
+  double llx, lly, urx, ury;	/* bounding box of subtree */
+} tree_vertex;
+
 /* ad hoc structure for an annotated plPath, in particular one that has
    been flattened into line segments and annotated; used only in this file,
    for merging purposes */
@@ -1438,8 +1917,61 @@ typedef struct subpath_struct
 
   double llx, lly, urx, ury;    /* bounding box of the subpath */
   bool inserted;		/* subpath has been inserted into result? */
+  int flattened_vertices;	/* vertices added when flattening it */
+
+  cell_grid *segment_grid;	/* index of segments, if any */
+  tree_vertex *vertex_tree;	/* index of vertices, if any */
 } subpath;
 
+/* A node in a binary tree of the children of a parent subpath, which
+   keeps track of the (squared) distance from each child not yet inserted
+   to the merged path.  The tree is stored in heap order: node 1 is the
+   root, and node k has children 2k and 2k+1. */
+
+typedef struct
+{
+  double llx, lly, urx, ury;	/* bounding box of the children below */
+  double min_distance;		/* least distance, among those not inserted */
+  double max_distance;		/* greatest distance, or -1.0 if all inserted */
+  int min_child;		/* child with least distance (lowest index, if
+				   there is a tie), or -1 if all inserted */
+} child_node;
+
+/* The state of the insertion of the children of a parent subpath into
+   the merged path, which is stored as a linked list of vertices (so that
+   an index into the merged path, once computed, need not change). */
+
+typedef struct
+{
+  subpath *parent;		/* parent subpath */
+  child_node *nodes;		/* tree of children */
+  int *order;			/* children, in order of leaves of the tree */
+  int *leaf;			/* position of each child among the leaves */
+  double *distances;		/* from each child to merged path */
+  int *parent_best_indices;	/* closest vertex in merged path */
+  int *child_best_indices;	/* closest vertex in child */
+} merge_state;
+
+/* The center of a child's bounding box, used in building the tree of
+   children. */
+typedef struct
+{
+  double x, y;
+  int index;
+} child_center;
+
+/* Subpaths, and grids, above these sizes are indexed. */
+#define MIN_SEGMENTS_FOR_GRID 32
+#define MIN_VERTICES_FOR_TREE 16
+#define MAX_VERTEX_PAIRS_FOR_SEARCH 256
+
+/* A subpath whose bounding box meets more than this many cells of the
+   grid of subpaths is listed separately, rather than in each cell. */
+#define MAX_CELLS_PER_SUBPATH 16
+
+/* Maximum number of cells in a grid. */
+#define MAX_GRID_CELLS (1 << 20)
+
 /* forward references */
 
 /* 0. ctors, dtors */
@@ -1447,26 +1979,41 @@ static subpath * new_subpath (void);
 static subpath ** new_subpath_array (int n);
 static void delete_subpath (subpath *s);
 static void delete_subpath_array (subpath **s, int n);
+static cell_grid * new_cell_grid (double llx, double lly, double urx, double ury, const double *boxes, int num_items, int num_cells);
+static void delete_cell_grid (cell_grid *g);
+static tree_vertex * new_vertex_tree (const plPathSegment *segments, int n);
 
 /* 1. functions that act on a subpath, i.e. an `annotated path' */
-static bool is_inside_of (const subpath *s, const subpath *other);
+static bool is_inside_of (const subpath *s, subpath *other);
 static double _cheap_lower_bound_on_distance (const subpath *path1, const subpath *path2);
 static void linearize_subpath (subpath *s);
 static void read_into_subpath (subpath *s, const plPath *path);
+static void write_from_segments (plPath *path, const plPathSegment *segments, int n);
 
 /* 2. miscellaneous */
 static void find_parents_in_subpath_list (subpath **annotated_paths, int num_paths);
-static void insert_subpath (plPathSegment *parent_segments, const plPathSegment *child_segments, int parent_size, int child_size, int parent_index, int child_index);
-static void _compute_closest (const plPathSegment *p1, const plPathSegment *p2, int size1, int size2, double *distance, int *index1, int *index2);
+static void insert_subpath (plPathSegment *merged, int *next, int *num_merged, int parent_index, const plPathSegment *child, int child_size, int child_index);
+static void _compute_closest (subpath *path1, subpath *path2, double *distance, int *index1, int *index2);
+static double lower_bound_on_box_distance (double llx1, double lly1, double urx1, double ury1, double llx2, double lly2, double urx2, double ury2);
+static int grid_column (const cell_grid *g, double x);
+static int grid_row (const cell_grid *g, double y);
+static bool segment_crosses_ray (const subpath *other, int k, double x1, double y1, double x2, double y2);
+static int count_crossings_in_grid (cell_grid *g, const subpath *other, double x1, double y1, double x2, double y2);
+static void build_vertex_tree (tree_vertex *t, int lo, int hi);
+static void search_vertex_tree (const tree_vertex *t, int lo, int hi, plPoint p, double *distance, int *index);
+static void build_child_tree (merge_state *m, int node, int lo, int hi, child_center *centers);
+static void update_child_tree (merge_state *m, int node, int lo, int hi, int pos);
+static void set_child_node (merge_state *m, int node, int lo, int hi);
+static void update_distances (merge_state *m, int node, int lo, int hi, int closest, int first_new_vertex);
 
 /**********************************************************************/
 
 /* ctor for subpath class */
-static subpath * 
+static subpath *
 new_subpath (void)
 {
   subpath *s;
-  
+
   s = (subpath *)_pl_xmalloc (sizeof (subpath));
 
   s->segments = (plPathSegment *)NULL;
@@ -1481,24 +2028,27 @@ new_subpath (void)
   s->urx = -DBL_MAX;
   s->ury = -DBL_MAX;
   s->inserted = false;
+  s->flattened_vertices = 0;
+  s->segment_grid = (cell_grid *)NULL;
+  s->vertex_tree = (tree_vertex *)NULL;
 
   return s;
 }
-  
+
 /* corresponding ctor for a subpath array */
 static subpath **
 new_subpath_array (int n)
 {
   int i;
   subpath **s;
-  
+
   s = (subpath **)_pl_xmalloc (n * sizeof (subpath *));
   for (i = 0; i < n; i++)
     s[i] = new_subpath ();
 
   return s;
 }
-  
+
 /* dtor for subpath class */
 static void
 delete_subpath (subpath *s)
@@ -1511,6 +2061,10 @@ delete_subpath (subpath *s)
 	free (s->children);
       if (s->parents)
 	free (s->parents);
+      if (s->segment_grid)
+	delete_cell_grid (s->segment_grid);
+      if (s->vertex_tree)
+	free (s->vertex_tree);
 
       free (s);
     }
@@ -1530,40 +2084,185 @@ delete_subpath_array (subpath **s, int n)
     }
 }
 
-/* replace every segment in a subpath by a lineto (invoked only on a child
-   subpath, i.e. a subpath with an identified parent) */
-static void 
-linearize_subpath (subpath *s)
+/* ctor for cell_grid class.  The grid covers the rectangle with corners
+   (llx,lly) and (urx,ury), and has about num_cells cells, as nearly square
+   as possible.  Item i has bounding box boxes[4*i]..boxes[4*i+3], i.e.
+   llx, lly, urx, ury; an item with llx > urx is omitted. */
+static cell_grid *
+new_cell_grid (double llx, double lly, double urx, double ury, const double *boxes, int num_items, int num_cells)
 {
-  /* replace first segment (moveto) with a lineto */
-  s->segments[0].type = S_LINE;
+  cell_grid *g;
+  double width = urx - llx, height = ury - lly;
+  int *fill;
+  int i, num_entries;
 
-  /* if final segment is a closepath, also replace with a lineto, back to
-     point #0 */
-  if (s->segments[s->num_segments-1].type == S_CLOSEPATH)
+  g = (cell_grid *)_pl_xmalloc (sizeof (cell_grid));
+
+  num_cells = IMAX(1, IMIN(num_cells, MAX_GRID_CELLS));
+  if (!(width > 0.0) && !(height > 0.0))
     {
-      s->segments[s->num_segments-1].type = S_LINE;
-      s->segments[s->num_segments-1].p = s->segments[0].p;
+      g->nx = 1;
+      g->ny = 1;
+    }
+  else if (!(width > 0.0))
+    {
+      g->nx = 1;
+      g->ny = num_cells;
+    }
+  else if (!(height > 0.0))
+    {
+      g->nx = num_cells;
+      g->ny = 1;
+    }
+  else
+    {
+      double nx = sqrt (num_cells * (width / height));
+
+      if (!(nx >= 1.0))
+	nx = 1.0;
+      if (nx > num_cells)
+	nx = num_cells;
+      g->nx = (int)nx;
+      g->ny = IMAX(1, num_cells / g->nx);
     }
-}
-
-/* Read a sequence of plPathSegments from a plPath into a previously empty
-   annotated subpath.  (This is called only after the plPath has been
-   flattened, so the segments include no arcs.)
-
-   Because the way in which _merge_paths() is currently called in libplot,
-   we need to handle the possibility that the plPath may not be closed.  If
-   it isn't, we add a closepath.
 
-   At present, we allow a final lineto to the start vertex to serve the
-   same purpose.  THIS IS A LIBPLOT CONVENTION THAT WILL GO AWAY. */
+  g->llx = llx;
+  g->lly = lly;
+  g->cell_width = (width > 0.0 ? width / g->nx : 0.0);
+  g->cell_height = (height > 0.0 ? height / g->ny : 0.0);
+  g->inv_cell_width = (width > 0.0 ? g->nx / width : 0.0);
+  g->inv_cell_height = (height > 0.0 ? g->ny / height : 0.0);
+  g->marks = (int *)NULL;
+  g->mark = 0;
+  g->incomplete = false;
+
+  /* count the entries in each cell; entries for cell c are counted in
+     cell_start[c+1] */
+  g->cell_start = (int *)_pl_xmalloc ((g->nx * g->ny + 1) * sizeof(int));
+  for (i = 0; i <= g->nx * g->ny; i++)
+    g->cell_start[i] = 0;
+  for (i = 0; i < num_items; i++)
+    {
+      const double *box = boxes + 4 * i;
+      int cx, cy, cx0, cx1, cy0, cy1;
 
-static void
+      if (box[0] > box[2])
+	continue;
+      if (!(box[0] <= box[2] && box[1] <= box[3]))
+	/* NaN */
+	{
+	  g->incomplete = true;
+	  continue;
+	}
+      cx0 = grid_column (g, box[0]);
+      cx1 = grid_column (g, box[2]);
+      cy0 = grid_row (g, box[1]);
+      cy1 = grid_row (g, box[3]);
+      for (cy = cy0; cy <= cy1; cy++)
+	for (cx = cx0; cx <= cx1; cx++)
+	  g->cell_start[cy * g->nx + cx + 1]++;
+    }
+  for (i = 0; i < g->nx * g->ny; i++)
+    g->cell_start[i + 1] += g->cell_start[i];
+  num_entries = g->cell_start[g->nx * g->ny];
+
+  /* list the items in each cell, in increasing order */
+  g->items = (int *)_pl_xmalloc (IMAX(1, num_entries) * sizeof(int));
+  fill = (int *)_pl_xmalloc (g->nx * g->ny * sizeof(int));
+  for (i = 0; i < g->nx * g->ny; i++)
+    fill[i] = g->cell_start[i];
+  for (i = 0; i < num_items; i++)
+    {
+      const double *box = boxes + 4 * i;
+      int cx, cy, cx0, cx1, cy0, cy1;
+
+      if (!(box[0] <= box[2] && box[1] <= box[3]))
+	continue;
+      cx0 = grid_column (g, box[0]);
+      cx1 = grid_column (g, box[2]);
+      cy0 = grid_row (g, box[1]);
+      cy1 = grid_row (g, box[3]);
+      for (cy = cy0; cy <= cy1; cy++)
+	for (cx = cx0; cx <= cx1; cx++)
+	  g->items[fill[cy * g->nx + cx]++] = i;
+    }
+  free (fill);
+
+  return g;
+}
+
+/* dtor for cell_grid class */
+static void
+delete_cell_grid (cell_grid *g)
+{
+  free (g->cell_start);
+  free (g->items);
+  if (g->marks)
+    free (g->marks);
+  free (g);
+}
+
+/* The column and row of the cell that contains a point.  Points outside
+   the grid are mapped to the nearest cell. */
+static int
+grid_column (const cell_grid *g, double x)
+{
+  double t = (x - g->llx) * g->inv_cell_width;
+
+  if (!(t >= 1.0))		/* including NaN */
+    return 0;
+  if (t >= g->nx)
+    return g->nx - 1;
+  return (int)t;
+}
+
+static int
+grid_row (const cell_grid *g, double y)
+{
+  double t = (y - g->lly) * g->inv_cell_height;
+
+  if (!(t >= 1.0))		/* including NaN */
+    return 0;
+  if (t >= g->ny)
+    return g->ny - 1;
+  return (int)t;
+}
+
+/* replace every segment in a subpath by a lineto (invoked only on a child
+   subpath, i.e. a subpath with an identified parent) */
+static void
+linearize_subpath (subpath *s)
+{
+  /* replace first segment (moveto) with a lineto */
+  s->segments[0].type = S_LINE;
+
+  /* if final segment is a closepath, also replace with a lineto, back to
+     point #0 */
+  if (s->segments[s->num_segments-1].type == S_CLOSEPATH)
+    {
+      s->segments[s->num_segments-1].type = S_LINE;
+      s->segments[s->num_segments-1].p = s->segments[0].p;
+    }
+}
+
+/* Read a sequence of plPathSegments from a plPath into a previously empty
+   annotated subpath.  (This is called only after the plPath has been
+   flattened, so the segments include no arcs.)
+
+   Because the way in which _merge_paths() is currently called in libplot,
+   we need to handle the possibility that the plPath may not be closed.  If
+   it isn't, we add a closepath.
+
+   At present, we allow a final lineto to the start vertex to serve the
+   same purpose.  THIS IS A LIBPLOT CONVENTION THAT WILL GO AWAY. */
+
+static void
 read_into_subpath (subpath *s, const plPath *path)
 {
+  plPathIterator iter;
   bool need_to_close = false;
   int i;
-  
+
   /* sanity check */
   if (path->type != PATH_SEGMENT_LIST)
     return;
@@ -1580,19 +2279,20 @@ read_into_subpath (subpath *s, const plPath *path)
   /* Is this path closed?  If not, we'll close manually the annotated path
      that we'll construct.  WE CURRENTLY TREAT FINAL = INITIAL AS
      INDICATING CLOSURE. */
-  if (path->segments[path->num_segments - 1].type != S_CLOSEPATH
+  if (_path_segment_type (path, path->num_segments - 1) != S_CLOSEPATH
       &&
-      (path->segments[path->num_segments - 1].p.x != path->segments[0].p.x
-       || path->segments[path->num_segments - 1].p.y != path->segments[0].p.y))
+      (path->points[path->num_segments - 1].x != path->points[0].x
+       || path->points[path->num_segments - 1].y != path->points[0].y))
     need_to_close = true;
 
   /* copy the segments, updating bounding box to take each juncture point
      into account */
+  _path_iter_start (&iter, path, 0);
   for (i = 0; i < path->num_segments; i++)
     {
       plPathSegment e;
-      
-      e = path->segments[i];
+
+      _path_iter_next (&iter, &e);
       s->segments[i] = e;
 
       if (e.p.x < s->llx)
@@ -1612,24 +2312,224 @@ read_into_subpath (subpath *s, const plPath *path)
 #else  /* currently, use line segment instead of closepath */
       s->segments[path->num_segments].type = S_LINE;
 #endif
-      s->segments[path->num_segments].p = path->segments[0].p;
+      s->segments[path->num_segments].p = path->points[0];
       s->num_segments++;
     }
 }
 
+/* Store a sequence of plPathSegments (a merged path, which contains no
+   arcs) in the segment list of a previously empty plPath. */
+
+static void
+write_from_segments (plPath *path, const plPathSegment *segments, int n)
+{
+  int i;
+
+  _grow_segments (path, n);
+  for (i = 0; i < n; i++)
+    {
+      path->num_segments = i;
+      if (i > 0 && segments[i].type != S_LINE)
+	{
+	  plPathCurve *curve = _new_curve (path, segments[i].type);
+
+	  curve->pc = segments[i].pc;
+	  curve->pd = segments[i].pd;
+	}
+      path->points[i] = segments[i].p;
+    }
+  path->num_segments = n;
+}
+
+/* Check whether the k'th segment of the closed path `other' crosses the
+   line segment from (x1,y1), effectively the point at infinity, to the
+   point (x2,y2). */
+static bool
+segment_crosses_ray (const subpath *other, int k, double x1, double y1, double x2, double y2)
+{
+  int j;
+  double x3, y3, x4, y4, det, det1, det2;
+
+  if (other->segments[k].type == S_CLOSEPATH) /* k > 0 */
+    {
+      x3 = other->segments[k-1].p.x;
+      y3 = other->segments[k-1].p.y;
+    }
+  else
+    {
+      x3 = other->segments[k].p.x;
+      y3 = other->segments[k].p.y;
+    }
+
+  j = (k == other->num_segments - 1 ? 0 : k + 1);
+  if (other->segments[j].type == S_CLOSEPATH)
+    return false;
+
+  x4 = other->segments[j].p.x;
+  y4 = other->segments[j].p.y;
+
+  /* (x3,y3)-(x4,y4) is a line segment in the closed path */
+
+  /* Check whether the line segments (x1,y1)-(x2,y2) and
+     (x3-y3)-(x4,y4) cross each other.
+
+     System to solve is:
+
+     [p1 + (p2 - p1) * t1] - [p3 + (p4 - p3) * t2] = 0
+
+     i.e.
+
+     (x2 - x1) * t1 - (x4 - x3) * t2 = x3 - x1;
+     (y2 - y1) * t1 - (y4 - y3) * t2 = y3 - y1;
+
+     Solutions are: t1 = det1/det
+                    t2 = det2/det
+
+     The line segments cross each other (in their interiors) if
+     0.0 < t1 < 1.0 and 0.0 < t2 < 1.0 */
+
+  det = (x2 - x1) * (-(y4 - y3)) - (-(x4 - x3)) * (y2 - y1);
+  if (det == 0.0)
+    /* line segments are parallel; ignore the degenerate case
+       that they might overlap */
+    return false;
+
+  det1 = (x3 - x1) * (-(y4 - y3)) - (-(x4 - x3)) * (y3 - y1);
+  det2 = (x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1);
+
+  if ((det<0.0 && (det1>0.0 || det2>0.0 || det1<det || det2<det))
+      ||
+      (det>0.0 && (det1<0.0 || det2<0.0 || det1>det || det2>det)))
+    /* solution for at least one of t1 and t2 is outside the
+       interval [0,1], so line segments do not cross */
+    return false;
+
+  /* We ignore the possibility that t1, t2 are both in the interval
+     [0,1], but
+     (t1 == 0.0) || (t1 == 1.0) || (t2 == 0.0) || (t2 == 1.0).
+
+     t1 == 0.0 should never happen, if p1 is effectively
+     the point at infinity.
+
+     So this degenerate case occurs only if the line segment
+     (x1,y1)-(x2,y2) goes through either (x3,y3) or (x4,y4), or
+     the specified point (x2,y2) lies on the line segment
+     (x3,y3)-(x4,y4) that is part of the path. */
+
+  return true;
+}
+
+/* Count the segments of `other' that cross the line segment from (x1,y1)
+   to (x2,y2), using a grid of its segments.  The line segment runs up and
+   to the right, so only the cells along it (and their neighbors, to allow
+   for rounding) need be examined.  Returns -1 if the grid can't be used. */
+static int
+count_crossings_in_grid (cell_grid *g, const subpath *other, double x1, double y1, double x2, double y2)
+{
+  double slope;
+  int row, crossings = 0;
+
+  if (g->incomplete || !(x1 > x2) || !(y1 > y2))
+    return -1;
+  slope = (x1 - x2) / (y1 - y2);
+
+  if (g->marks == (int *)NULL)
+    {
+      g->marks = (int *)_pl_xcalloc (other->num_segments, sizeof(int));
+      g->mark = 0;
+    }
+  if (g->mark == INT_MAX)
+    {
+      int k;
+
+      for (k = 0; k < other->num_segments; k++)
+	g->marks[k] = 0;
+      g->mark = 0;
+    }
+  g->mark++;
+
+  for (row = IMAX(0, grid_row (g, y2) - 1); row < g->ny; row++)
+    {
+      double ylo, yhi;
+      int col, col0, col1;
+
+      /* the part of the line segment lying in this row and its neighbors */
+      ylo = DMAX(y2, g->lly + (row - 1) * g->cell_height);
+      yhi = DMIN(y1, g->lly + (row + 2) * g->cell_height);
+      if (!(ylo <= yhi))
+	continue;
+      col0 = IMAX(0, grid_column (g, x2 + (ylo - y2) * slope) - 1);
+      col1 = IMIN(g->nx - 1, grid_column (g, x2 + (yhi - y2) * slope) + 1);
+
+      for (col = col0; col <= col1; col++)
+	{
+	  int c = row * g->nx + col, e;
+
+	  for (e = g->cell_start[c]; e < g->cell_start[c + 1]; e++)
+	    {
+	      int k = g->items[e];
+
+	      if (g->marks[k] == g->mark)
+		continue;
+	      g->marks[k] = g->mark;
+	      if (segment_crosses_ray (other, k, x1, y1, x2, y2))
+		crossings++;
+	    }
+	}
+    }
+
+  return crossings;
+}
+
 /* check if a subpath is inside another subpath */
-static bool 
-is_inside_of (const subpath *s, const subpath *other)
+static bool
+is_inside_of (const subpath *s, subpath *other)
 {
   int inside = 0;
   int outside = 0;
   int i;
-  
+
   /* if bbox fails to lie inside the other's bbox, false */
   if (!((s->llx >= other->llx) && (s->lly >= other->lly) &&
 	(s->urx <= other->urx) && (s->ury <= other->ury)))
     return false;
-  
+
+  /* if the other path is large, index its segments (once) */
+  if (other->num_segments >= MIN_SEGMENTS_FOR_GRID
+      && other->segment_grid == (cell_grid *)NULL)
+    {
+      double *boxes;
+      int k;
+
+      boxes = (double *)_pl_xmalloc (4 * other->num_segments * sizeof(double));
+      for (k = 0; k < other->num_segments; k++)
+	{
+	  double *box = boxes + 4 * k;
+	  plPoint p3, p4;
+	  int j;
+
+	  /* same segment as in segment_crosses_ray() */
+	  p3 = (other->segments[k].type == S_CLOSEPATH
+		? other->segments[k-1].p : other->segments[k].p);
+	  j = (k == other->num_segments - 1 ? 0 : k + 1);
+	  if (other->segments[j].type == S_CLOSEPATH)
+	    {
+	      box[0] = 1.0;	/* omit */
+	      box[2] = 0.0;
+	      continue;
+	    }
+	  p4 = other->segments[j].p;
+	  box[0] = DMIN(p3.x, p4.x);
+	  box[1] = DMIN(p3.y, p4.y);
+	  box[2] = DMAX(p3.x, p4.x);
+	  box[3] = DMAX(p3.y, p4.y);
+	}
+      other->segment_grid =
+	new_cell_grid (other->llx, other->lly, other->urx, other->ury,
+		       boxes, other->num_segments, other->num_segments);
+      free (boxes);
+    }
+
   /* otherwise, check all juncture points */
   for (i = 0; i < s->num_segments; i++)
     {
@@ -1639,8 +2539,9 @@ is_inside_of (const subpath *s, const subpath *other)
 	/* should have i = num_segments - 1, no associated juncture point */
 	continue;
 
-      /* Check if the vertex s->segments[i].p is inside `other'.  Could be
-	 done in a separate function, but we inline it for speed. */
+      /* Check if the vertex s->segments[i].p is inside `other', by
+	 counting the crossings of the path with a line segment from it to
+	 a point outside the path. */
       {
 	/* These two factors should be small positive floating-point
 	   numbers.  They should preferably be incommensurate, to minimize
@@ -1649,107 +2550,39 @@ is_inside_of (const subpath *s, const subpath *other)
 #define SMALL_X_FACTOR (M_SQRT2 * M_PI)
 #define SMALL_Y_FACTOR (M_SQRT2 + M_PI)
 
-	/* argument of the now-inlined function (besides `other') */
 	plPoint p;
-	/* local variables of the now-inlined function */
-	int k, crossings;
+	int k, crossings = -1;
 	/* (x1,y1) is effectively the point at infinity */
 	double x1, y1;
 	/* (x2,y2) is specified point */
 	double x2, y2;
-	
-	/* argument of the now-inlined function (besides `other') */
+
 	p = s->segments[i].p;
-  
+
 	/* (x1,y1) is effectively the point at infinity */
-	x1 = (DMAX(p.x, other->urx) 
-	      + SMALL_X_FACTOR * (DMAX(p.x, other->urx) 
+	x1 = (DMAX(p.x, other->urx)
+	      + SMALL_X_FACTOR * (DMAX(p.x, other->urx)
 				  - DMIN(p.x, other->llx)));
-	y1 = (DMAX(p.y, other->ury) 
-	      + SMALL_Y_FACTOR * (DMAX(p.y, other->ury) 
+	y1 = (DMAX(p.y, other->ury)
+	      + SMALL_Y_FACTOR * (DMAX(p.y, other->ury)
 				  - DMIN(p.y, other->lly)));
-	
+
 	/* (x2,y2) is specified point */
 	x2 = p.x;
 	y2 = p.y;
-	
-	crossings = 0;
-	for (k = 0; k < other->num_segments; k++)
+
+	if (other->segment_grid)
+	  crossings = count_crossings_in_grid (other->segment_grid, other,
+					       x1, y1, x2, y2);
+	if (crossings < 0)
+	  /* no usable grid, so check every segment */
 	  {
-	    int j;
-	    double x3, y3, x4, y4, det, det1, det2;
-	    
-	    if (other->segments[k].type == S_CLOSEPATH) /* k > 0 */
-	      {
-		x3 = other->segments[k-1].p.x;
-		y3 = other->segments[k-1].p.y;
-	      }
-	    else
-	      {
-		x3 = other->segments[k].p.x;
-		y3 = other->segments[k].p.y;
-	      }
-	    
-	    j = (k == other->num_segments - 1 ? 0 : k + 1);
-	    if (other->segments[j].type == S_CLOSEPATH)
-	      continue;
-	    
-	    x4 = other->segments[j].p.x;
-	    y4 = other->segments[j].p.y;
-	    
-	    /* (x3,y3)-(x4,y4) is a line segment in the closed path */
-	    
-	    /* Check whether the line segments (x1,y1)-(x2,y2) and
-	       (x3-y3)-(x4,y4) cross each other.
-	       
-	       System to solve is:
-	       
-	       [p1 + (p2 - p1) * t1] - [p3 + (p4 - p3) * t2] = 0
-	       
-	       i.e.
-	       
-	       (x2 - x1) * t1 - (x4 - x3) * t2 = x3 - x1;
-	       (y2 - y1) * t1 - (y4 - y3) * t2 = y3 - y1;
-	       
-	       Solutions are: t1 = det1/det
-	                      t2 = det2/det
-	       
-	       The line segments cross each other (in their interiors) if
-	       0.0 < t1 < 1.0 and 0.0 < t2 < 1.0 */
-      
-	    det = (x2 - x1) * (-(y4 - y3)) - (-(x4 - x3)) * (y2 - y1);
-	    if (det == 0.0)
-	      /* line segments are parallel; ignore the degenerate case
-		 that they might overlap */
-	      continue;
-      
-	    det1 = (x3 - x1) * (-(y4 - y3)) - (-(x4 - x3)) * (y3 - y1);
-	    det2 = (x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1);
-	    
-	    if ((det<0.0 && (det1>0.0 || det2>0.0 || det1<det || det2<det))
-		||
-		(det>0.0 && (det1<0.0 || det2<0.0 || det1>det || det2>det)))
-	      /* solution for at least one of t1 and t2 is outside the
-		 interval [0,1], so line segments do not cross */
-	      continue;
-       
-	    /* We ignore the possibility that t1, t2 are both in the interval
-	       [0,1], but
-	       (t1 == 0.0) || (t1 == 1.0) || (t2 == 0.0) || (t2 == 1.0).
-
-	       t1 == 0.0 should never happen, if p1 is effectively
-	       the point at infinity.
-
-	       So this degenerate case occurs only if the line segment
-	       (x1,y1)-(x2,y2) goes through either (x3,y3) or (x4,y4), or
-	       the specified point (x2,y2) lies on the line segment
-	       (x3,y3)-(x4,y4) that is part of the path. */
-      
-	    crossings++;
+	    crossings = 0;
+	    for (k = 0; k < other->num_segments; k++)
+	      if (segment_crosses_ray (other, k, x1, y1, x2, y2))
+		crossings++;
 	  }
-	
-	/* our determination of whether the point is inside the path;
-	   before we inlined this function, this was the return value */
+
 	point_is_inside = (crossings & 1) ? true : false;
       }
 
@@ -1770,29 +2603,101 @@ is_inside_of (const subpath *s, const subpath *other)
    is invoked, each subpath should consist of an initial moveto, at least
    one lineto, and a closepath (not currently enforced). */
 
-static void 
+static void
 find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
 {
   int i, j;
   subpath *parent;
-  
-  /* determine for each subpath the subpaths that are nominally outside it */
+  double llx = DBL_MAX, lly = DBL_MAX, urx = -DBL_MAX, ury = -DBL_MAX;
+  double *boxes;
+  int *large, num_large = 0;
+  cell_grid *g;
+
+  /* Index the subpaths by bounding box.  A subpath can be inside another
+     only if its lower left corner is in the other's bounding box, and
+     hence in a cell that the other's bounding box meets.  Subpaths whose
+     bounding boxes meet many cells are listed separately, in large[]. */
+  for (i = 0; i < num_paths; i++)
+    if (annotated_paths[i]->llx <= annotated_paths[i]->urx
+	&& annotated_paths[i]->lly <= annotated_paths[i]->ury)
+      {
+	llx = DMIN(llx, annotated_paths[i]->llx);
+	lly = DMIN(lly, annotated_paths[i]->lly);
+	urx = DMAX(urx, annotated_paths[i]->urx);
+	ury = DMAX(ury, annotated_paths[i]->ury);
+      }
+  if (llx > urx)
+    /* all subpaths are empty */
+    return;
+
+  boxes = (double *)_pl_xmalloc (4 * num_paths * sizeof(double));
+  for (i = 0; i < num_paths; i++)
+    {
+      boxes[4 * i] = annotated_paths[i]->llx;
+      boxes[4 * i + 1] = annotated_paths[i]->lly;
+      boxes[4 * i + 2] = annotated_paths[i]->urx;
+      boxes[4 * i + 3] = annotated_paths[i]->ury;
+    }
+  g = new_cell_grid (llx, lly, urx, ury, boxes, 0, num_paths);
+  large = (int *)_pl_xmalloc (num_paths * sizeof(int));
   for (i = 0; i < num_paths; i++)
     {
-      annotated_paths[i]->parents = new_subpath_array (num_paths);
-      for (j = 0; j < num_paths; j++)
+      double *box = boxes + 4 * i;
+
+      if (box[0] > box[2])	/* empty */
+	continue;
+      if ((grid_column (g, box[2]) - grid_column (g, box[0]) + 1.0)
+	  * (grid_row (g, box[3]) - grid_row (g, box[1]) + 1.0)
+	  > MAX_CELLS_PER_SUBPATH)
 	{
-	  if (j != i)
+	  large[num_large++] = i;
+	  box[0] = 1.0;		/* omit from grid */
+	  box[2] = 0.0;
+	}
+    }
+  delete_cell_grid (g);
+  g = new_cell_grid (llx, lly, urx, ury, boxes, num_paths, num_paths);
+  free (boxes);
+
+  /* determine for each subpath the subpaths that are nominally outside it,
+     in increasing order */
+  for (i = 0; i < num_paths; i++)
+    {
+      subpath *s = annotated_paths[i];
+      int c, e, e_end, m, parents_len = 0;
+
+      if (s->llx > s->urx)
+	/* empty, so inside of nothing */
+	continue;
+
+      /* merge the list of subpaths in the cell with the list of large
+	 subpaths */
+      c = grid_row (g, s->lly) * g->nx + grid_column (g, s->llx);
+      e = g->cell_start[c];
+      e_end = g->cell_start[c + 1];
+      m = 0;
+      while (e < e_end || m < num_large)
+	{
+	  if (m == num_large || (e < e_end && g->items[e] < large[m]))
+	    j = g->items[e++];
+	  else
+	    j = large[m++];
+
+	  if (j != i && is_inside_of (s, annotated_paths[j]))
 	    {
-	      if (is_inside_of (annotated_paths[i], annotated_paths[j]))
+	      if (s->num_outside == parents_len)
 		{
-		  annotated_paths[i]->parents[annotated_paths[i]->num_outside] = 
-		    annotated_paths[j];
-		  annotated_paths[i]->num_outside++;
+		  parents_len = (parents_len == 0 ? 4 : 2 * parents_len);
+		  s->parents = (subpath **)_pl_xrealloc (s->parents,
+							 parents_len * sizeof(subpath *));
 		}
+	      s->parents[s->num_outside] = annotated_paths[j];
+	      s->num_outside++;
 	    }
 	}
     }
+  delete_cell_grid (g);
+  free (large);
 
   /* Now find the real parent subpaths, i.e. the root subpaths.  A subpath
      is a parent subpath if the number of nominally-outside subpaths is
@@ -1801,18 +2706,7 @@ find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
      will flag a path as an isolate: technically a parent, but without
      children. */
 
-  for (i = 0; i < num_paths; i++)
-    {
-      if ((annotated_paths[i]->num_outside & 1) == 0)
-	/* an even number of subpaths outside, definitely a parent
-	   (i.e. doesn't have a parent itself, may or may not have children) */
-	{
-	  /* allocate space for children (if any) */
-	  annotated_paths[i]->children = new_subpath_array (num_paths);
-	}
-    }
-  
-  /* now determine which are children, and link them to their parents */
+  /* determine which are children, and link them to their parents */
 
   for (i = 0; i < num_paths; i++)
     {
@@ -1827,25 +2721,152 @@ find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
 	{
 	  for (j = 0; j < annotated_paths[i]->num_outside; j++)
 	    {
-	      if (annotated_paths[i]->num_outside == 
+	      if (annotated_paths[i]->num_outside ==
 		  annotated_paths[i]->parents[j]->num_outside + 1)
 		/* number outside is one more than the number outside a
-		   potential parent; flag as a child, and add it to the
-		   parent's child list */
+		   potential parent; flag as a child, and count it */
 		{
 		  parent = annotated_paths[i]->parents[j];
 		  annotated_paths[i]->parent = parent; /* give it a parent */
-		  parent->children[parent->num_children] = annotated_paths[i];
 		  parent->num_children++;
 		  break;
 		}
 	    }
 	}
     }
+
+  /* add each child to its parent's child list */
+  for (i = 0; i < num_paths; i++)
+    {
+      parent = annotated_paths[i]->parent;
+      if (parent == (subpath *)NULL)
+	continue;
+      if (parent->children == (subpath **)NULL)
+	{
+	  parent->children = (subpath **)_pl_xmalloc (parent->num_children * sizeof(subpath *));
+	  parent->num_children = 0;
+	}
+      parent->children[parent->num_children++] = annotated_paths[i];
+    }
+}
+
+/* Compare two vertices in a k-d tree, by x or y coordinate. */
+
+static int
+compare_x (const void *a, const void *b)
+{
+  const tree_vertex *u = (const tree_vertex *)a, *v = (const tree_vertex *)b;
+
+  if (u->p.x != v->p.x)
+    return (u->p.x < v->p.x ? -1 : 1);
+  return u->index - v->index;
+}
+
+static int
+compare_y (const void *a, const void *b)
+{
+  const tree_vertex *u = (const tree_vertex *)a, *v = (const tree_vertex *)b;
+
+  if (u->p.y != v->p.y)
+    return (u->p.y < v->p.y ? -1 : 1);
+  return u->index - v->index;
+}
+
+/* ctor for a k-d tree of the n vertices of a subpath */
+static tree_vertex *
+new_vertex_tree (const plPathSegment *segments, int n)
+{
+  tree_vertex *t;
+  int i;
+
+  t = (tree_vertex *)_pl_xmalloc (n * sizeof(tree_vertex));
+  for (i = 0; i < n; i++)
+    {
+      t[i].p = segments[i].p;
+      t[i].index = i;
+    }
+  build_vertex_tree (t, 0, n);
+
+  return t;
+}
+
+/* Arrange t[lo]..t[hi-1] as a subtree, split at its middle entry on
+   whichever axis the vertices are more spread out along. */
+static void
+build_vertex_tree (tree_vertex *t, int lo, int hi)
+{
+  double llx = DBL_MAX, lly = DBL_MAX, urx = -DBL_MAX, ury = -DBL_MAX;
+  int i, mid, axis;
+
+  if (hi - lo <= 0)
+    return;
+  for (i = lo; i < hi; i++)
+    {
+      llx = DMIN(llx, t[i].p.x);
+      lly = DMIN(lly, t[i].p.y);
+      urx = DMAX(urx, t[i].p.x);
+      ury = DMAX(ury, t[i].p.y);
+    }
+  axis = (ury - lly > urx - llx ? 1 : 0);
+  qsort (t + lo, hi - lo, sizeof(tree_vertex), axis ? compare_y : compare_x);
+  mid = (lo + hi) / 2;
+  t[mid].axis = axis;
+  t[mid].llx = llx;
+  t[mid].lly = lly;
+  t[mid].urx = urx;
+  t[mid].ury = ury;
+  build_vertex_tree (t, lo, mid);
+  build_vertex_tree (t, mid + 1, hi);
+}
+
+/* Search a subtree for the vertex nearest p, updating the (squared)
+   distance to the nearest vertex found so far, and its index.  If several
+   are equally near, the one with the lowest index is taken.  Subtrees
+   whose bounding boxes are farther away than the nearest vertex so far
+   are skipped. */
+static void
+search_vertex_tree (const tree_vertex *t, int lo, int hi, plPoint p, double *distance, int *index)
+{
+  const tree_vertex *v;
+  double tmp1, tmp2, d;
+  int mid;
+
+  if (lo >= hi)
+    return;
+  mid = (lo + hi) / 2;
+  v = t + mid;
+
+  tmp1 = (p.x < v->llx ? v->llx - p.x : p.x > v->urx ? p.x - v->urx : 0.0);
+  tmp2 = (p.y < v->lly ? v->lly - p.y : p.y > v->ury ? p.y - v->ury : 0.0);
+  if (tmp1 * tmp1 + tmp2 * tmp2 > *distance)
+    return;
+
+  tmp1 = p.x - v->p.x;
+  tmp2 = p.y - v->p.y;
+  d = tmp1 * tmp1 + tmp2 * tmp2;
+  if (d < *distance || (d == *distance && v->index < *index))
+    {
+      *distance = d;
+      *index = v->index;
+    }
+
+  /* search the near side first */
+  if ((v->axis ? tmp2 : tmp1) < 0.0)
+    {
+      search_vertex_tree (t, lo, mid, p, distance, index);
+      search_vertex_tree (t, mid + 1, hi, p, distance, index);
+    }
+  else
+    {
+      search_vertex_tree (t, mid + 1, hi, p, distance, index);
+      search_vertex_tree (t, lo, mid, p, distance, index);
+    }
 }
 
 /* Compute closest vertices in two paths.  Indices of closest vertices, and
-   (squared) distance between them, are returned via pointers.
+   (squared) distance between them, are returned via pointers.  If several
+   pairs are equally close, the pair that comes first (ordered by index in
+   the first path, then in the second) is taken.
 
    This is invoked in _merge_paths() only on paths that have been
    flattened, and have had the initial moveto and the optional final
@@ -1853,35 +2874,83 @@ find_parents_in_subpath_list (subpath **annotated_paths, int num_paths)
    segment type is S_LINE. */
 
 static void
-_compute_closest (const plPathSegment *p1, const plPathSegment *p2, int size1, int size2, double *distance, int *index1, int *index2)
+_compute_closest (subpath *path1, subpath *path2, double *distance, int *index1, int *index2)
 {
+  const plPathSegment *p1 = path1->segments, *p2 = path2->segments;
+  int size1 = path1->num_segments, size2 = path2->num_segments;
   int best_i = 0, best_j = 0;	/* keep compiler happy */
   double best_distance = DBL_MAX;
   int ii, jj;
-  
-  for (ii = 0; ii < size1; ii++)
+
+  if ((double)size1 * (double)size2 <= MAX_VERTEX_PAIRS_FOR_SEARCH
+      || IMAX(size1, size2) < MIN_VERTICES_FOR_TREE)
+    /* compare every pair */
     {
-      plPoint point1;
-      
-      point1 = p1[ii].p;
-      for (jj = 0; jj < size2; jj++)
+      for (ii = 0; ii < size1; ii++)
 	{
-	  double tmp1, tmp2, distance;
-	  plPoint point2;
-	  
-	  point2 = p2[jj].p;
-	  tmp1 = point1.x - point2.x;
-	  tmp2 = point1.y - point2.y;
-	  distance = tmp1 * tmp1 + tmp2 * tmp2;
-	  if (distance < best_distance)
+	  plPoint point1;
+
+	  point1 = p1[ii].p;
+	  for (jj = 0; jj < size2; jj++)
+	    {
+	      double tmp1, tmp2, distance;
+	      plPoint point2;
+
+	      point2 = p2[jj].p;
+	      tmp1 = point1.x - point2.x;
+	      tmp2 = point1.y - point2.y;
+	      distance = tmp1 * tmp1 + tmp2 * tmp2;
+	      if (distance < best_distance)
+		{
+		  best_distance = distance;
+		  best_i = ii;
+		  best_j = jj;
+		}
+	    }
+	}
+    }
+  else if (size2 >= size1)
+    /* find the vertex in path2 nearest each vertex in path1 */
+    {
+      if (path2->vertex_tree == (tree_vertex *)NULL)
+	path2->vertex_tree = new_vertex_tree (p2, size2);
+      for (ii = 0; ii < size1; ii++)
+	{
+	  /* look only for a vertex nearer than the nearest pair so far */
+	  double d = best_distance;
+	  int j = size2;
+
+	  search_vertex_tree (path2->vertex_tree, 0, size2, p1[ii].p, &d, &j);
+	  if (d < best_distance)
 	    {
-	      best_distance = distance;
+	      best_distance = d;
 	      best_i = ii;
+	      best_j = j;
+	    }
+	}
+    }
+  else
+    /* find the vertex in path1 nearest each vertex in path2 */
+    {
+      if (path1->vertex_tree == (tree_vertex *)NULL)
+	path1->vertex_tree = new_vertex_tree (p1, size1);
+      for (jj = 0; jj < size2; jj++)
+	{
+	  /* look only for a vertex nearer than the nearest pair so far, or
+	     as near but with a lower index */
+	  double d = best_distance;
+	  int i = best_i;
+
+	  search_vertex_tree (path1->vertex_tree, 0, size1, p2[jj].p, &d, &i);
+	  if (d < best_distance || (d == best_distance && i < best_i))
+	    {
+	      best_distance = d;
+	      best_i = i;
 	      best_j = jj;
 	    }
 	}
     }
-  
+
   /* return the three quantities */
   *distance = best_distance;
   *index1 = best_i;
@@ -1889,22 +2958,31 @@ _compute_closest (const plPathSegment *p1, const plPathSegment *p2, int size1, i
 }
 
 /* Compute a cheap lower bound on the (squared) distance between two
-   subpaths, by looking at their bounding boxes. */
+   subpaths, or two rectangles, by looking at their bounding boxes. */
 
 static double
 _cheap_lower_bound_on_distance (const subpath *path1, const subpath *path2)
+{
+  return lower_bound_on_box_distance (path1->llx, path1->lly,
+				      path1->urx, path1->ury,
+				      path2->llx, path2->lly,
+				      path2->urx, path2->ury);
+}
+
+static double
+lower_bound_on_box_distance (double llx1, double lly1, double urx1, double ury1, double llx2, double lly2, double urx2, double ury2)
 {
   double xdist = 0.0, ydist = 0.0, dist;
-  
-  if (path1->urx < path2->llx)
-    xdist = path2->llx - path1->urx;
-  else if (path2->urx < path1->llx)
-    xdist = path1->llx - path2->urx;    
-    
-  if (path1->ury < path2->lly)
-    ydist = path2->lly - path1->ury;
-  else if (path2->ury < path1->lly)
-    ydist = path1->lly - path2->ury;    
+
+  if (urx1 < llx2)
+    xdist = llx2 - urx1;
+  else if (urx2 < llx1)
+    xdist = llx1 - urx2;
+
+  if (ury1 < lly2)
+    ydist = lly2 - ury1;
+  else if (ury2 < lly1)
+    ydist = lly1 - ury2;
 
   dist = xdist * xdist + ydist * ydist;
 
@@ -1923,70 +3001,51 @@ _cheap_lower_bound_on_distance (const subpath *path1, const subpath *path2)
    I.e. if the child vertices are numbered 0..child_size-1, we map the case
    child_index = child_size-1 to child_index = 0.
 
-   The new path has parent_size + child_size + 1 vertices, of which the
-   last is a repetition of the first. */
-
-  /* INDEX MAP: 
+   The parent path (the merged path built up so far) is stored as a linked
+   list of vertices: next[i] is the vertex following vertex i, or -1.  The
+   child_size+1 new vertices are appended to the vertex array, so that
+   vertices already in the list keep their indices; they are linked in
+   after vertex parent_index, as follows. */
 
-     PARENT -> NEW PATH
-       i --> i                (if 0 <= i < parent_index + 1)
-       i --> i+child_size+1   (if parent_index + 1 <= i < parent_size)
+  /* INDEX MAP:
 
-     CHILD -> NEW PATH
-       i --> i+parent_index+child_size-child_index  (0 <= i < child_index+1)
-       i --> i+parent_index-child_index+1   (child_index+1 <= i < child_size-1)
-       		(0'th element of the child is same as child_size-1 element)
+     NEW VERTEX                      CONTENTS
 
-     NEW PATH                        CONTENTS
-
-     0..parent_index	             
-                                     0..parent_index of PARENT
-     parent_index+1
-                                     child_index of CHILD (i.e. ->join)
-     parent_index+2..parent_index+child_size-child_index-1
+     base	                     child_index of CHILD (i.e. ->join)
+     base+1..base+child_size-child_index-2
                                      child_index+1..child_size-2 of CHILD
-     parent_index+child_size-child_index..parent_index+child_size
+     base+child_size-child_index-1..base+child_size-1
                                      0..child_index of CHILD
-     parent_index+child_size+1
-                                     parent_index of PARENT (i.e. ->join)
-     parent_index+child_size+2..parent_size+child_size
-                                     parent_index+1..parent_size-1 of PARENT
+     base+child_size                 parent_index of PARENT (i.e. ->join)
 
+     where base is the number of vertices before the insertion.
   */
 
-/* Macros that map from vertices in the child path and the parent path, to
-   vertices in the merged path.  Here the argument `i' is the index in the
-   original path, and each macro evaluates to the index in the merger.  */
-
-/* The first macro should not be applied to i=child_size-1; as noted above,
-   that vertex is equivalent to i=0, so apply it to i=0 instead. */
-
-#define CHILD_VERTEX_IN_MERGED_PATH(i,parent_index,parent_size,child_index,child_size) ((i) <= (child_index) ? (i) + (parent_index) + (child_size) - (child_index) : (i) + (parent_index) - (child_index) + 1)
-#define PARENT_VERTEX_IN_MERGED_PATH(i,parent_index,parent_size,child_index,child_size) ((i) <= (parent_index) ? (i) : (i) + (child_size) + 1)
+/* Macro that maps from a vertex in the child path to the index of the
+   corresponding new vertex, relative to base.  It should not be applied
+   to i=child_size-1; as noted above, that vertex is equivalent to i=0, so
+   apply it to i=0 instead. */
 
+#define CHILD_VERTEX_IN_MERGED_PATH(i,child_index,child_size) ((i) <= (child_index) ? (i) + (child_size) - (child_index) - 1 : (i) - (child_index))
 
-static void 
-insert_subpath (plPathSegment *parent, const plPathSegment *child, int parent_size, int child_size, int parent_index, int child_index)
+static void
+insert_subpath (plPathSegment *merged, int *next, int *num_merged, int parent_index, const plPathSegment *child, int child_size, int child_index)
 {
-  int i;
+  int i, base = *num_merged;
   plPathSegment e1, e2;
   int src_index;
-  
+
   /* map case when joining vertex is final vertex of child to case when
      it's the 0'th vertex */
   if (child_index == child_size - 1)
     child_index = 0;
 
-  /* move up: add child_size+1 empty slots to parent path */
-  for (i = parent_size - 1; i >= parent_index + 1; i--)
-    parent[i + child_size + 1] = parent[i];
-  
   /* add a line segment from specified vertex of parent path to specified
      vertex of child path */
   e1 = child[child_index];
   e1.type = S_LINE;		/* unnecessary */
-  parent[parent_index + 1] = e1;
-  
+  merged[base] = e1;
+
   /* copy vertices of child into parent, looping back to start in child if
      necessary; note we skip the last (i.e. child_size-1'th) vertex, since
      the 0'th vertex is the same */
@@ -1996,14 +3055,229 @@ insert_subpath (plPathSegment *parent, const plPathSegment *child, int parent_si
       src_index++;
       if (src_index == child_size - 1)
 	src_index = 0;
-      parent[parent_index + 2 + i] = child[src_index];
+      merged[base + 1 + i] = child[src_index];
     }
-  
+
   /* add a line segment back from specified vertex of child path to
      specified vertex of parent path */
-  e2 = parent[parent_index];
+  e2 = merged[parent_index];
   e2.type = S_LINE;
-  parent[parent_index + child_size + 1] = e2;
+  merged[base + child_size] = e2;
+
+  /* link the new vertices in */
+  for (i = base; i < base + child_size; i++)
+    next[i] = i + 1;
+  next[base + child_size] = next[parent_index];
+  next[parent_index] = base;
+  *num_merged = base + child_size + 1;
+}
+
+static int
+compare_center_x (const void *a, const void *b)
+{
+  const child_center *u = (const child_center *)a, *v = (const child_center *)b;
+
+  if (u->x != v->x)
+    return (u->x < v->x ? -1 : 1);
+  return u->index - v->index;
+}
+
+static int
+compare_center_y (const void *a, const void *b)
+{
+  const child_center *u = (const child_center *)a, *v = (const child_center *)b;
+
+  if (u->y != v->y)
+    return (u->y < v->y ? -1 : 1);
+  return u->index - v->index;
+}
+
+/* Build the subtree of the tree of children rooted at `node', whose leaves
+   are at positions lo..hi-1, by splitting the children's centers at the
+   median on whichever axis they are more spread out along. */
+static void
+build_child_tree (merge_state *m, int node, int lo, int hi, child_center *centers)
+{
+  int i;
+
+  if (hi - lo == 1)
+    {
+      m->order[lo] = centers[lo].index;
+      m->leaf[centers[lo].index] = lo;
+    }
+  else
+    {
+      double llx = DBL_MAX, lly = DBL_MAX, urx = -DBL_MAX, ury = -DBL_MAX;
+      int mid = (lo + hi) / 2;
+
+      for (i = lo; i < hi; i++)
+	{
+	  llx = DMIN(llx, centers[i].x);
+	  lly = DMIN(lly, centers[i].y);
+	  urx = DMAX(urx, centers[i].x);
+	  ury = DMAX(ury, centers[i].y);
+	}
+      qsort (centers + lo, hi - lo, sizeof(child_center),
+	     ury - lly > urx - llx ? compare_center_y : compare_center_x);
+      build_child_tree (m, 2 * node, lo, mid, centers);
+      build_child_tree (m, 2 * node + 1, mid, hi, centers);
+    }
+  set_child_node (m, node, lo, hi);
+}
+
+/* Recompute the bounding box and distances stored in a node of the tree
+   of children, from those of its children (or, at a leaf, from the child
+   subpath itself). */
+static void
+set_child_node (merge_state *m, int node, int lo, int hi)
+{
+  child_node *n = m->nodes + node;
+
+  if (hi - lo == 1)
+    {
+      int j = m->order[lo];
+      subpath *child = m->parent->children[j];
+
+      n->llx = child->llx;
+      n->lly = child->lly;
+      n->urx = child->urx;
+      n->ury = child->ury;
+      if (child->inserted)
+	{
+	  n->min_child = -1;
+	  n->min_distance = DBL_MAX;
+	  n->max_distance = -1.0;
+	}
+      else
+	{
+	  n->min_child = j;
+	  n->min_distance = m->distances[j];
+	  n->max_distance = m->distances[j];
+	}
+    }
+  else
+    {
+      const child_node *left = m->nodes + 2 * node;
+      const child_node *right = m->nodes + 2 * node + 1;
+
+      n->llx = DMIN(left->llx, right->llx);
+      n->lly = DMIN(left->lly, right->lly);
+      n->urx = DMAX(left->urx, right->urx);
+      n->ury = DMAX(left->ury, right->ury);
+      n->max_distance = DMAX(left->max_distance, right->max_distance);
+      if (right->min_child < 0
+	  || (left->min_child >= 0
+	      && (left->min_distance < right->min_distance
+		  || (left->min_distance == right->min_distance
+		      && left->min_child < right->min_child))))
+	{
+	  n->min_child = left->min_child;
+	  n->min_distance = left->min_distance;
+	}
+      else
+	{
+	  n->min_child = right->min_child;
+	  n->min_distance = right->min_distance;
+	}
+    }
+}
+
+/* Update the nodes of the tree of children on the path to the leaf at
+   position pos. */
+static void
+update_child_tree (merge_state *m, int node, int lo, int hi, int pos)
+{
+  if (hi - lo > 1)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (pos < mid)
+	update_child_tree (m, 2 * node, lo, mid, pos);
+      else
+	update_child_tree (m, 2 * node + 1, mid, hi, pos);
+    }
+  set_child_node (m, node, lo, hi);
+}
+
+/* After the child `closest' has been chosen for insertion into the merged
+   path, update the distance from each other child not yet inserted to the
+   merged path, and the vertices that are closest, if the child is nearer
+   to `closest' than to the merged path.  Only the subtrees containing a
+   child whose distance may be greater than a lower bound on its distance
+   to `closest' are visited.  The vertices of `closest' will be numbered
+   from first_new_vertex on in the merged path. */
+static void
+update_distances (merge_state *m, int node, int lo, int hi, int closest, int first_new_vertex)
+{
+  child_node *n = m->nodes + node;
+  subpath *closest_child = m->parent->children[closest];
+
+  if (n->max_distance < 0.0)
+    /* all inserted */
+    return;
+  if (lower_bound_on_box_distance (n->llx, n->lly, n->urx, n->ury,
+				   closest_child->llx, closest_child->lly,
+				   closest_child->urx, closest_child->ury)
+      >= n->max_distance)
+    /* no child below can be nearer to `closest' than to the merged path */
+    return;
+
+  if (hi - lo == 1)
+    {
+      int j = m->order[lo];
+      double inter_child_distance;
+      int inter_child_best_index1, inter_child_best_index2;
+
+      if (j == closest)	/* ignore */
+	return;
+
+      /* compute distance (and closest vertex pairs) between `closest' and
+	 the j'th child; result is only of interest if the distance is less
+	 than distances[j], so we first compute a cheap lower bound on the
+	 result by looking at bounding boxes. */
+      if (!(_cheap_lower_bound_on_distance (m->parent->children[j],
+					    closest_child)
+	    < m->distances[j]))
+	return;
+
+      _compute_closest (m->parent->children[j], closest_child,
+			&inter_child_distance,
+			&inter_child_best_index1, /* vertex in j */
+			&inter_child_best_index2); /* in `closest' */
+
+      if (inter_child_distance < m->distances[j])
+	/* j'th child is nearer to a vertex in `closest', the child to be
+	   inserted, than to any vertex in the current merged path */
+	{
+	  int nearest_index_in_closest_child;
+
+	  m->distances[j] = inter_child_distance;
+	  m->child_best_indices[j] = inter_child_best_index1;
+
+	  /* Compute the index of the vertex in the merged path, taking into
+	     account the numbering of the vertices of `closest' when it is
+	     inserted.  The macro doesn't perform correctly if its first arg
+	     takes the maximum possible value; so instead, we map that
+	     possibility to `0'.  See comment above, before the macro
+	     definition. */
+	  nearest_index_in_closest_child = inter_child_best_index2;
+	  if (nearest_index_in_closest_child == closest_child->num_segments - 1)
+	    nearest_index_in_closest_child = 0;
+	  m->parent_best_indices[j] = first_new_vertex
+	    + CHILD_VERTEX_IN_MERGED_PATH(nearest_index_in_closest_child,
+					  m->child_best_indices[closest],
+					  closest_child->num_segments);
+	  set_child_node (m, node, lo, hi);
+	}
+    }
+  else
+    {
+      int mid = (lo + hi) / 2;
+
+      update_distances (m, 2 * node, lo, mid, closest, first_new_vertex);
+      update_distances (m, 2 * node + 1, mid, hi, closest, first_new_vertex);
+      set_child_node (m, node, lo, hi);
+    }
 }
 
 /* The key function exported by this module, which is used by libplot for
@@ -2035,7 +3309,12 @@ _merge_paths (const plPath **paths, int num_paths)
      bounding boxes are computed. */
   annotated_paths = new_subpath_array (num_paths);
   for (i = 0; i < num_paths; i++)
-    read_into_subpath (annotated_paths[i], flattened_paths[i]);
+    {
+      read_into_subpath (annotated_paths[i], flattened_paths[i]);
+      if (flattened_paths[i] != paths[i])
+	annotated_paths[i]->flattened_vertices
+	  = flattened_paths[i]->flattened_vertices;
+    }
 
   /* Flattened paths no longer needed, so delete them carefully (some may
      be the same as the original paths, due to _flatten_path() having
@@ -2043,6 +3322,7 @@ _merge_paths (const plPath **paths, int num_paths)
   for (i = 0; i < num_paths; i++)
     if (flattened_paths[i] != paths[i])
       _delete_plPath (flattened_paths[i]);
+  free (flattened_paths);
 
   /* determine which subpaths are parents, children */
   find_parents_in_subpath_list (annotated_paths, num_paths);
@@ -2064,8 +3344,11 @@ _merge_paths (const plPath **paths, int num_paths)
       int j, k, num_segments_in_merged_path;
       subpath *parent;
       plPath *merged_path;
-      double *parent_to_child_distances;
-      int *child_best_indices, *parent_best_indices;
+      plPathSegment *merged_segments, *segments;
+      int *next;
+      int num_merged_segments;
+      merge_state m;
+      child_center *centers;
 
       if (annotated_paths[i]->parent != (subpath *)NULL)
 	/* child path; original path will be merged into parent */
@@ -2088,221 +3371,114 @@ _merge_paths (const plPath **paths, int num_paths)
       parent = annotated_paths[i];
       num_segments_in_merged_path = parent->num_segments;
       for (j = 0; j < parent->num_children; j++)
-	num_segments_in_merged_path 
+	num_segments_in_merged_path
 	  += (parent->children[j]->num_segments + 1);
 
-      merged_path = _new_plPath ();
-      merged_path->segments = (plPathSegment *)_pl_xmalloc(num_segments_in_merged_path * sizeof (plPathSegment));
-      merged_path->num_segments = 0;
-      merged_path->segments_len = num_segments_in_merged_path;
+      merged_segments = (plPathSegment *)_pl_xmalloc(num_segments_in_merged_path * sizeof (plPathSegment));
+      next = (int *)_pl_xmalloc(num_segments_in_merged_path * sizeof (int));
 
       /* copy parent path into new empty path, i.e. initialize the merged
          path */
       for (j = 0; j < parent->num_segments; j++)
-	merged_path->segments[j] = parent->segments[j];
-      merged_path->num_segments = parent->num_segments;
-      
+	{
+	  merged_segments[j] = parent->segments[j];
+	  next[j] = j + 1;
+	}
+      next[parent->num_segments - 1] = -1;
+      num_merged_segments = parent->num_segments;
+
       /* Create temporary storage for `closest vertex pairs' and inter-path
-	 distances.  We first compute the shortest distance between each
-	 child path.  We also keep track of the shortest distance between
-	 each child and the merged path being constructed, and update it
-	 when any child is added.  */
+	 distances.  We keep track of the shortest distance between each
+	 child and the merged path being constructed, and update it when
+	 any child is added.  */
 
-      parent_to_child_distances = (double *)_pl_xmalloc(parent->num_children * sizeof (double));
-      parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
-      child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+      m.parent = parent;
+      m.distances = (double *)_pl_xmalloc(parent->num_children * sizeof (double));
+      m.parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+      m.child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
 
       /* compute closest vertices between merged path (i.e., right now, the
 	 parent) and any child; these arrays will be updated when any child
 	 is inserted into the merged path */
       for (j = 0; j < parent->num_children; j++)
-	_compute_closest (parent->segments,
-			  parent->children[j]->segments,
-			  parent->num_segments,
-			  parent->children[j]->num_segments,
-			  &(parent_to_child_distances[j]),
-			  &(parent_best_indices[j]),
-			  &(child_best_indices[j]));
-      
+	_compute_closest (parent, parent->children[j],
+			  &(m.distances[j]),
+			  &(m.parent_best_indices[j]),
+			  &(m.child_best_indices[j]));
+
+      /* build tree of children */
+      m.nodes = (child_node *)_pl_xmalloc(4 * parent->num_children * sizeof (child_node));
+      m.order = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+      m.leaf = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
+      centers = (child_center *)_pl_xmalloc(parent->num_children * sizeof (child_center));
+      for (j = 0; j < parent->num_children; j++)
+	{
+	  centers[j].x = 0.5 * (parent->children[j]->llx + parent->children[j]->urx);
+	  centers[j].y = 0.5 * (parent->children[j]->lly + parent->children[j]->ury);
+	  centers[j].index = j;
+	}
+      build_child_tree (&m, 1, 0, parent->num_children, centers);
+      free (centers);
+
       for (k = 0; k < parent->num_children; k++)
 	/* insert a child (the closest remaining one!) into the built-up
            merged path; and flag the child as having been inserted so that
            we don't pay attention to it thereafter */
 	{
-	  double min_distance;
-	  int closest = 0; /* keep compiler happy */
-	  double *new_parent_to_child_distances;
-	  int *new_child_best_indices, *new_parent_best_indices;
-
-	  /* allocate storage for arrays that will be used to update the
-	     three abovementioned arrays, with each pass through the loop */
-	  new_parent_to_child_distances = (double *)_pl_xmalloc(parent->num_children * sizeof (double));
-	  new_parent_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
-	  new_child_best_indices = (int *)_pl_xmalloc(parent->num_children * sizeof (int));
-
-	  /* initially, they're the same as the current arrays */
-	  for (j = 0; j < parent->num_children; j++)
-	    {
-	      new_parent_to_child_distances[j] = parent_to_child_distances[j];
-	      new_parent_best_indices[j] = parent_best_indices[j];
-	      new_child_best_indices[j] = child_best_indices[j];
-	    }
+	  int closest;
 
 	  /* find closest child to merged path, which has not yet been
              inserted */
-	  min_distance = DBL_MAX;
-	  for (j = 0; j < parent->num_children; j++)
-	    {
-	      if (parent->children[j]->inserted) /* ignore this child */
-		continue;
-	      
-	      if (parent_to_child_distances[j] < min_distance)
-		{
-		  closest = j;
-		  min_distance = parent_to_child_distances[j];
-		}
-	    }
-	  
-	  /* closest remaining child has index `closest'; it will be
-	     inserted into the current merged path */
+	  closest = m.nodes[1].min_child;
 
-	  /* loop over all children, skipping inserted ones and also
-	     skipping `closest', the next child to be inserted */
-	  for (j = 0; j < parent->num_children; j++)
-	    {
-	      double inter_child_distance;
-	      int inter_child_best_index1, inter_child_best_index2;
-	      double lower_bound_on_inter_child_distance;
-	      bool compute_carefully;
-
-	      if (parent->children[j]->inserted) /* ignore */
-		continue;
-	      
-	      if (j == closest)	/* ignore */
-		continue;
-	      
-	      /* compute distance (and closest vertex pairs) between
-		 `closest' and the j'th child; result is only of interest
-		 if the distance is less than parent_to_child_distances[j],
-		 so we first compute a cheap lower bound on the result by
-		 looking at bounding boxes. */
-
-	      lower_bound_on_inter_child_distance = 
-		_cheap_lower_bound_on_distance (parent->children[j],
-						parent->children[closest]);
-	      compute_carefully = 
-		(lower_bound_on_inter_child_distance < 
-		 parent_to_child_distances[j]) ? true : false;
-
-	      if (compute_carefully)
-		/* compute accurate inter-child distance; also which two
-		   vertices yield the minimum distance */
-		_compute_closest (parent->children[j]->segments,
-				  parent->children[closest]->segments,
-				  parent->children[j]->num_segments,
-				  parent->children[closest]->num_segments,
-				  &inter_child_distance,
-				  &inter_child_best_index1, /* vertex in j */
-				  &inter_child_best_index2); /* in `closest' */
-	      
-	      /* fill in j'th element of the new arrays
-		 parent_to_child_distances[], parent_best_indices[] and
-		 child_best_indices[] so as to take the insertion of the
-		 child into account; but we don't update the old arrays
-		 until we do the actual insertion */
-
-	      if (compute_carefully &&
-		  inter_child_distance < parent_to_child_distances[j])
-		/* j'th child is nearer to a vertex in `closest', the child
-		   to be inserted, than to any vertex in the current merged
-		   path, so all three arrays are affected */
-		{
-		  int nearest_index_in_closest_child;
+	  /* closest remaining child has index `closest'; it will be
+	     inserted into the current merged path.  Any other child that is
+	     nearer to it than to the current merged path will be nearer to
+	     the new merged path, so update the distances. */
+	  update_distances (&m, 1, 0, parent->num_children,
+			    closest, num_merged_segments);
 
-		  new_parent_to_child_distances[j] = inter_child_distance;
-		  new_child_best_indices[j] = inter_child_best_index1;
-		  nearest_index_in_closest_child = inter_child_best_index2;
-		  
-		  /* Compute new value of parent_best_indices[j], taking
-		     into account that `closest' will be inserted into the
-		     merged path, thereby remapping the relevant index in
-		     `closest'.  The macro doesn't perform correctly if its
-		     first arg takes the maximum possible value; so
-		     instead, we map that possibility to `0'.  See comment
-		     above, before the macro definition. */
-
-		  if (nearest_index_in_closest_child == 
-		      parent->children[closest]->num_segments - 1)
-		    nearest_index_in_closest_child = 0;
-		  new_parent_best_indices[j] = 
-		    CHILD_VERTEX_IN_MERGED_PATH(nearest_index_in_closest_child,
-						parent_best_indices[closest],
-						merged_path->num_segments, 
-						child_best_indices[closest],
-						parent->children[closest]->num_segments);
-		}
-	      else
-		/* j'th child is nearer to a vertex in the current merged
-		   path than to any vertex in `closest', the child to be
-		   inserted into the merged path */
-		{
-		  int nearest_index_in_parent;
-
-		  nearest_index_in_parent = parent_best_indices[j];
-
-		  /* compute new value of parent_best_indices[j], taking
-		     into account that `closest' will be inserted into the
-		     merged path, thereby remapping the relevant index in
-		     the merged path */
-		  new_parent_best_indices[j] = 
-		    PARENT_VERTEX_IN_MERGED_PATH(nearest_index_in_parent,
-						 parent_best_indices[closest],
-						 merged_path->num_segments, 
-						 child_best_indices[closest],
-						 parent->children[closest]->num_segments);
-		}
-	    }
-	  
 	  /* do the actual insertion, by adding a pair of lineto's between
              closest vertices; flag child as inserted */
-	  insert_subpath (merged_path->segments, 
-			  parent->children[closest]->segments, 
-			  merged_path->num_segments, 
+	  insert_subpath (merged_segments, next, &num_merged_segments,
+			  m.parent_best_indices[closest],
+			  parent->children[closest]->segments,
 			  parent->children[closest]->num_segments,
-			  parent_best_indices[closest],
-			  child_best_indices[closest]);
-	  merged_path->num_segments += 
-	    (parent->children[closest]->num_segments + 1);
+			  m.child_best_indices[closest]);
 	  parent->children[closest]->inserted = true;
-
-	  /* update the old arrays to take insertion into account: replace
-             them by the new ones */
-	  for (j = 0; j < parent->num_children; j++)
-	    {
-	      parent_to_child_distances[j] = new_parent_to_child_distances[j];
-	      parent_best_indices[j] = new_parent_best_indices[j];
-	      child_best_indices[j] = new_child_best_indices[j];
-	    }
-
-	  free (new_parent_to_child_distances);
-	  free (new_parent_best_indices);
-	  free (new_child_best_indices);
+	  update_child_tree (&m, 1, 0, parent->num_children,
+			     m.leaf[closest]);
 	}
       /* End of loop over all children of parent subpath; all >=1 children
 	 have now been inserted into the parent, i.e. into the `merged
 	 path' which the parent initialized.  However, the merged path's
 	 segments are all lines; so change the first to a moveto. */
 
-      merged_path->segments[0].type = S_MOVETO;
+      segments = (plPathSegment *)_pl_xmalloc(num_merged_segments * sizeof (plPathSegment));
+      for (j = 0, k = 0; j >= 0; j = next[j])
+	segments[k++] = merged_segments[j];
+      segments[0].type = S_MOVETO;
+      merged_path = _new_plPath ();
+      write_from_segments (merged_path, segments, num_merged_segments);
+      merged_path->flattened_vertices = parent->flattened_vertices;
+      for (j = 0; j < parent->num_children; j++)
+	merged_path->flattened_vertices
+	  += parent->children[j]->flattened_vertices;
+      free (segments);
+      free (merged_segments);
+      free (next);
       merged_paths[i] = merged_path;
 
       /* NOTE: SHOULD ALSO REPLACE LAST LINE SEGMENT BY A CLOSEPATH! */
 
       /* delete temporary storage for `closest vertex pairs' and inter-path
          distances */
-      free (parent_to_child_distances);
-      free (parent_best_indices);
-      free (child_best_indices);
+      free (m.distances);
+      free (m.parent_best_indices);
+      free (m.child_best_indices);
+      free (m.nodes);
+      free (m.order);
+      free (m.leaf);
     }
   /* end of loop over parent subpaths */
 
@@ -22,6 +22,33 @@
 #include "sys-defines.h"
 #include "extern.h"
 
+#if defined(HAVE_WRITEV) && defined(HAVE_SYS_UIO_H) && defined(HAVE_UNISTD_H)
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define USE_WRITEV
+#endif
+
+/* Maximum number of pieces of memory gathered into a single vectored
+   write (POSIX guarantees that at least 16 may be). */
+#define MAX_PIECES 16
+
+/* Size of the blocks in which the spilled contents of a plOutbuf are read
+   back from its temporary file. */
+#define SPILL_BLOCK_LEN 65536
+
+typedef struct
+{
+  const char *data[MAX_PIECES];
+  size_t len[MAX_PIECES];
+  int num_pieces;
+} plPieceList;
+
+/* forward references */
+static void add_piece (const plPlotterData *data, plPieceList *pieces, const char *s, size_t len);
+static void write_pieces (const plPlotterData *data, plPieceList *pieces);
+static void write_raw (const plPlotterData *data, const char *s, size_t len);
+
 void
 _write_byte (const plPlotterData *data, unsigned char c)
 {
@@ -59,3 +86,145 @@ _write_string (const plPlotterData *data, const char *s)
     (*(data->outstream)) << s;
 #endif
 }
+
+/* Write out the contents of a plOutbuf (see g_outbuf.c): the spilled
+   contents if any, then its completed chunks, then its buffer.  This is
+   binary-safe, unlike _write_string(). */
+void
+_write_outbuf (const plPlotterData *data, const plOutbuf *bufp)
+{
+  _write_outbufs (data, (const plOutbuf *)NULL, bufp, (const plOutbuf *)NULL);
+}
+
+/* Write out the contents of up to three plOutbufs, any of which may be
+   NULL: typically a page header, a page, and a page trailer.  Contents held
+   in memory are gathered into as few writes as possible; where writev() is
+   available, they are not copied through the stdio buffer. */
+void
+_write_outbufs (const plPlotterData *data, const plOutbuf *header, const plOutbuf *bufp, const plOutbuf *trailer)
+{
+  const plOutbuf *bufs[3];
+  plPieceList pieces;
+  int i;
+
+  bufs[0] = header;
+  bufs[1] = bufp;
+  bufs[2] = trailer;
+  pieces.num_pieces = 0;
+
+  for (i = 0; i < 3; i++)
+    {
+      const plOutbuf *b = bufs[i];
+      const plOutbufChunk *chunk;
+
+      if (b == (const plOutbuf *)NULL)
+	continue;
+
+      if (b->spilled > 0)
+	/* read back spilled contents, and write them in blocks */
+	{
+	  char *block;
+	  unsigned long remaining;
+	  size_t n;
+
+	  write_pieces (data, &pieces);
+	  block = (char *)_pl_xmalloc (SPILL_BLOCK_LEN * sizeof(char));
+	  remaining = b->spilled;
+	  if (fseek (b->spill_fp, 0L, SEEK_SET) == 0)
+	    while (remaining > 0)
+	      {
+		n = (remaining < SPILL_BLOCK_LEN ? 
+		     (size_t)remaining : (size_t)SPILL_BLOCK_LEN);
+		if (fread (block, sizeof(char), n, b->spill_fp) != n)
+		  break;	/* shouldn't happen */
+		write_raw (data, block, n);
+		remaining -= n;
+	      }
+	  free (block);
+	}
+
+      for (chunk = b->first_chunk; chunk; chunk = chunk->next)
+	add_piece (data, &pieces, chunk->data, (size_t)chunk->len);
+      add_piece (data, &pieces, b->base, (size_t)b->contents);
+    }
+  write_pieces (data, &pieces);
+}
+
+/* Add a piece of memory to a list of pieces to be written, first writing
+   out the list if it is full. */
+static void
+add_piece (const plPlotterData *data, plPieceList *pieces, const char *s, size_t len)
+{
+  if (len == 0)
+    return;
+  if (pieces->num_pieces == MAX_PIECES)
+    write_pieces (data, pieces);
+  pieces->data[pieces->num_pieces] = s;
+  pieces->len[pieces->num_pieces] = len;
+  pieces->num_pieces++;
+}
+
+/* Write out, and empty, a list of pieces of memory. */
+static void
+write_pieces (const plPlotterData *data, plPieceList *pieces)
+{
+  int i = 0;
+
+#ifdef USE_WRITEV
+  if (data->outfp && pieces->num_pieces > 0 
+      && fflush (data->outfp) == 0 && fileno (data->outfp) >= 0)
+    {
+      struct iovec iov[MAX_PIECES];
+      size_t offset = 0;	/* bytes of pieces[i] already written */
+      int fd = fileno (data->outfp);
+      ssize_t n;
+
+      while (i < pieces->num_pieces)
+	{
+	  int j;
+
+	  for (j = i; j < pieces->num_pieces; j++)
+	    {
+	      iov[j - i].iov_base = (char *)pieces->data[j] + (j == i ? offset : 0);
+	      iov[j - i].iov_len = pieces->len[j] - (j == i ? offset : 0);
+	    }
+	  n = writev (fd, iov, pieces->num_pieces - i);
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  if (n <= 0)
+	    {
+	      /* write the rest via stdio, so that the stream's error
+		 indicator will be set */
+	      write_raw (data, pieces->data[i] + offset, pieces->len[i] - offset);
+	      i++;
+	      break;
+	    }
+	  /* skip past what was written */
+	  while (i < pieces->num_pieces 
+		 && (size_t)n >= pieces->len[i] - offset)
+	    {
+	      n -= (ssize_t)(pieces->len[i] - offset);
+	      offset = 0;
+	      i++;
+	    }
+	  offset += (size_t)n;
+	}
+    }
+#endif
+
+  for ( ; i < pieces->num_pieces; i++)
+    write_raw (data, pieces->data[i], pieces->len[i]);
+  pieces->num_pieces = 0;
+}
+
+/* Write a block of memory to the output stream. */
+static void
+write_raw (const plPlotterData *data, const char *s, size_t len)
+{
+  if (data->outfp)
+    fwrite (s, sizeof(char), len, data->outfp);
+#ifdef LIBPLOTTER
+  else if (data->outstream)
+    data->outstream->write(s, len);
+#endif
+}
@@ -150,8 +150,7 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
       if (num_dashes == 0 || dash_cycle_length == 0.0)
 	/* just switch to solid line type */
 	{
-	  strcpy (_plotter->data->page->point, "LT;");
-	  _update_buffer (_plotter->data->page);      
+	  _outbuf_puts (_plotter->data->page, "LT;");
 	  _plotter->hpgl_line_type = HPGL_L_SOLID;
 	}
       else
@@ -160,16 +159,14 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	  bool odd_length = (num_dashes & 1 ? true : false);
 
 	  /* create user-defined line type */
-	  sprintf (_plotter->data->page->point, "UL%d",
-		   SPECIAL_HPGL_LINE_TYPE);
-	  _update_buffer (_plotter->data->page);      
+	  _outbuf_printf (_plotter->data->page, "UL%d",
+			  SPECIAL_HPGL_LINE_TYPE);
 	  for (i = 0; i < num_dashes; i++)
 	    {
-	      sprintf (_plotter->data->page->point, ",%.3f", 
-		       /* dash length as frac of iteration interval */
-		       100.0 * (odd_length ? 0.5 : 1.0) 
-		       * dashbuf[i] / dash_cycle_length);
-	      _update_buffer (_plotter->data->page);      
+	      _outbuf_printf (_plotter->data->page, ",%.3f",
+			      /* dash length as frac of iteration interval */
+			      100.0 * (odd_length ? 0.5 : 1.0)
+			      * dashbuf[i] / dash_cycle_length);
 	    }
 	  if (odd_length)
 	    /* if an odd number of dashes, emit the dash array twice
@@ -178,15 +175,13 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	    {
 	      for (i = 0; i < num_dashes; i++)
 		{
-		  sprintf (_plotter->data->page->point, ",%.3f", 
-			   /* dash length as frac of iteration interval */
-			   100.0 * (odd_length ? 0.5 : 1.0) 
-			   * dashbuf[i] / dash_cycle_length);
-		  _update_buffer (_plotter->data->page);      
+		  _outbuf_printf (_plotter->data->page, ",%.3f",
+				  /* dash length as frac of iteration interval */
+				  100.0 * (odd_length ? 0.5 : 1.0)
+				  * dashbuf[i] / dash_cycle_length);
 		}
 	    }
-	  sprintf (_plotter->data->page->point, ";");
-	  _update_buffer (_plotter->data->page);      
+	  _outbuf_puts (_plotter->data->page, ";");
 	  
 	  /* switch to new line type */
 	  {
@@ -198,9 +193,8 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	    height = (double)(HPGL_SCALED_DEVICE_TOP-HPGL_SCALED_DEVICE_BOTTOM);
 	    diagonal_p1_p2_distance = sqrt (width * width + height * height);
 	    iter_interval = 100 * (odd_length ? 2 : 1) * (dash_cycle_length/diagonal_p1_p2_distance);
-	    sprintf (_plotter->data->page->point, "LT%d,%.4f;", 
-		     SPECIAL_HPGL_LINE_TYPE, iter_interval);
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_printf (_plotter->data->page, "LT%d,%.4f;",
+			    SPECIAL_HPGL_LINE_TYPE, iter_interval);
 	    if (_plotter->drawstate->dash_array_in_effect)
 	      _plotter->hpgl_line_type = SPECIAL_HPGL_LINE_TYPE;
 	    else
@@ -313,30 +307,29 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	{
 	case PL_L_SOLID:
 	  /* "solid" */
-	  strcpy (_plotter->data->page->point, "LT;");
+	  _outbuf_puts (_plotter->data->page, "LT;");
 	  break;
 	case PL_L_DOTTED:
 	  /* "dotted": emulate dots by selecting shortdashed pattern with a
 	     short iteration interval */
-	  sprintf (_plotter->data->page->point, 
-		   "LT%d,%.4f;",
-		   HPGL_L_SHORTDASHED,
-		   0.5 * iter_interval);
+	  _outbuf_printf (_plotter->data->page,
+			  "LT%d,%.4f;",
+			  HPGL_L_SHORTDASHED,
+			  0.5 * iter_interval);
 	  break;
 	case PL_L_DOTDOTDOTDASHED:
 	  /* not a native line type before HP-GL/2; use "dotdotdashed" */
-	  sprintf (_plotter->data->page->point, 
-		   "LT%d,%.4f;", 
-		   HPGL_L_DOTDOTDASHED,
-		   iter_interval);
+	  _outbuf_printf (_plotter->data->page,
+			  "LT%d,%.4f;",
+			  HPGL_L_DOTDOTDASHED,
+			  iter_interval);
 	  break;
 	default:
-	  sprintf (_plotter->data->page->point, 
-		   "LT%d,%.4f;", 
-		   _hpgl_line_type[_plotter->drawstate->line_type], 
-		   iter_interval);
+	  _outbuf_printf (_plotter->data->page,
+			  "LT%d,%.4f;",
+			  _hpgl_line_type[_plotter->drawstate->line_type],
+			  iter_interval);
 	}
-      _update_buffer (_plotter->data->page);
       _plotter->hpgl_line_type = 
 	_hpgl_line_type[_plotter->drawstate->line_type];
     }
@@ -350,10 +343,9 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	  || (_plotter->hpgl_join_style 
 	      != _hpgl_join_style[_plotter->drawstate->join_type]))
 	{
-	  sprintf (_plotter->data->page->point, "LA1,%d,2,%d;", 
-		   _hpgl_cap_style[_plotter->drawstate->cap_type],
-		   _hpgl_join_style[_plotter->drawstate->join_type]);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "LA1,%d,2,%d;",
+			  _hpgl_cap_style[_plotter->drawstate->cap_type],
+			  _hpgl_join_style[_plotter->drawstate->join_type]);
 	  _plotter->hpgl_cap_style = 
 	    _hpgl_cap_style[_plotter->drawstate->cap_type];
 	  _plotter->hpgl_join_style = 
@@ -375,8 +367,7 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
 	new_limit = 1.0;
       new_limit_integer = (int)new_limit; /* floor */
       
-      sprintf (_plotter->data->page->point, "LA3,%d;", new_limit_integer);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "LA3,%d;", new_limit_integer);
       _plotter->hpgl_miter_limit = _plotter->drawstate->miter_limit;
     }
 
@@ -386,9 +377,8 @@ _pl_h_set_attributes (S___(Plotter *_plotter))
     {
       if (_plotter->hpgl_pen_width != desired_hpgl_pen_width)
 	{
-	  sprintf (_plotter->data->page->point, "PW%.4f;", 
-		   100.0 * desired_hpgl_pen_width);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "PW%.4f;",
+			  100.0 * desired_hpgl_pen_width);
 	  _plotter->hpgl_pen_width = desired_hpgl_pen_width;
 	}
     }
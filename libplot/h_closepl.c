@@ -34,30 +34,25 @@ _pl_h_end_page (S___(Plotter *_plotter))
   if (_plotter->hpgl_pendown == true)
     /* lift pen */
     {
-      sprintf (_plotter->data->page->point, "PU;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "PU;");
     }
   /* move to lower left hand corner */
-  sprintf (_plotter->data->page->point, "PA0,0;");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "PA0,0;");
 
   /* select pen zero, i.e. return pen to carousel */
   if (_plotter->hpgl_pen != 0)
     {
-      sprintf (_plotter->data->page->point, "SP0;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "SP0;");
     }
 
   if (_plotter->hpgl_version >= 1)
     /* have a `page advance' command, so use it */
     {
-      sprintf (_plotter->data->page->point, "PG0;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "PG0;");
     }
 
   /* add newline at end */
-  sprintf (_plotter->data->page->point, "\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "\n");
 
   /* if a PCL Plotter, switch back from HP-GL/2 mode to PCL mode */
   _maybe_switch_from_hpgl (S___(_plotter));
@@ -80,6 +75,5 @@ void
 _pl_q_maybe_switch_from_hpgl (S___(Plotter *_plotter))
 {
   /* switch back from HP-GL/2 to PCL 5 mode */
-  strcpy (_plotter->data->page->point, "\033%0A");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "\033%0A");
 }
@@ -131,8 +131,7 @@ _pl_h_set_pen_color(R___(Plotter *_plotter) int hpgl_object_type)
 		if (_plotter->hpgl_char_rendering_type != 
 		    HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE)
 		  {
-		    sprintf (_plotter->data->page->point, "CF;");
-		    _update_buffer (_plotter->data->page);
+		    _outbuf_puts (_plotter->data->page, "CF;");
 		    _plotter->hpgl_char_rendering_type =
 		      HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE;
 		  }
@@ -155,9 +154,8 @@ _pl_h_set_pen_color(R___(Plotter *_plotter) int hpgl_object_type)
 	 DesignJet) */
       {
 	/* assign current `free pen' to be the new color */
-	sprintf (_plotter->data->page->point, "PC%d,%d,%d,%d;", 
-		 _plotter->hpgl_free_pen, red, green, blue);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "PC%d,%d,%d,%d;",
+			_plotter->hpgl_free_pen, red, green, blue);
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].red = red;
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].green = green;
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].blue = blue;
@@ -191,8 +189,7 @@ _pl_h_set_pen_color(R___(Plotter *_plotter) int hpgl_object_type)
 	      if (_plotter->hpgl_char_rendering_type != 
 		  HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE)
 		{
-		  sprintf (_plotter->data->page->point, "CF;");
-		  _update_buffer (_plotter->data->page);
+		  _outbuf_puts (_plotter->data->page, "CF;");
 		  _plotter->hpgl_char_rendering_type =
 		    HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE;
 		}
@@ -258,8 +255,7 @@ _pl_h_set_pen_color(R___(Plotter *_plotter) int hpgl_object_type)
 	       with the current fill type (without edging) */
 	    if (_plotter->hpgl_char_rendering_type != HPGL_CHAR_FILL)
 	      {
-		sprintf (_plotter->data->page->point, "CF%d;", HPGL_CHAR_FILL);
-		_update_buffer (_plotter->data->page);
+		_outbuf_printf (_plotter->data->page, "CF%d;", HPGL_CHAR_FILL);
 		_plotter->hpgl_char_rendering_type = HPGL_CHAR_FILL;
 	      }
 	    /* set the fill type to be a shading level (expressed as a
@@ -311,8 +307,7 @@ _pl_h_set_pen_color(R___(Plotter *_plotter) int hpgl_object_type)
 		  if (_plotter->hpgl_char_rendering_type != 
 		      HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE)
 		    {
-		      sprintf (_plotter->data->page->point, "CF;");
-		      _update_buffer (_plotter->data->page);
+		      _outbuf_puts (_plotter->data->page, "CF;");
 		      _plotter->hpgl_char_rendering_type =
 			HPGL_CHAR_FILL_SOLID_AND_MAYBE_EDGE;
 		    }
@@ -447,9 +442,8 @@ _pl_h_set_fill_color(R___(Plotter *_plotter) bool force_pen_color)
       /* CASE #1: HP-GL/2 and can soft-define pen colors */
       {
 	/* assign current `free pen' to be the new color */
-	sprintf (_plotter->data->page->point, "PC%d,%d,%d,%d;", 
-		 _plotter->hpgl_free_pen, red, green, blue);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "PC%d,%d,%d,%d;",
+			_plotter->hpgl_free_pen, red, green, blue);
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].red = red;
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].green = green;
 	_plotter->hpgl_pen_color[_plotter->hpgl_free_pen].blue = blue;
@@ -554,12 +548,10 @@ _pl_h_set_hpgl_pen (R___(Plotter *_plotter) int new_pen)
     {
       if (_plotter->hpgl_pendown)
 	{
-	  sprintf (_plotter->data->page->point, "PU;");
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_puts (_plotter->data->page, "PU;");
 	  _plotter->hpgl_pendown = false;
 	}
-      sprintf (_plotter->data->page->point, "SP%d;", new_pen);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "SP%d;", new_pen);
       _plotter->hpgl_pen = new_pen;
     }
 }
@@ -592,24 +584,23 @@ _pl_h_set_hpgl_pen_type (R___(Plotter *_plotter) int new_hpgl_pen_type, double o
 	case HPGL_PEN_SOLID:
 	default:
 	  /* options ignored */
-	  sprintf (_plotter->data->page->point, "SV;");
+	  _outbuf_puts (_plotter->data->page, "SV;");
 	  break;
 	case HPGL_PEN_SHADED:
 	  /* option1 is shading level in percent */
-	  sprintf (_plotter->data->page->point, "SV%d,%.1f;", 
-		   new_hpgl_pen_type, option1);
+	  _outbuf_printf (_plotter->data->page, "SV%d,%.1f;",
+			  new_hpgl_pen_type, option1);
 	  /* stash shading level */
 	  _plotter->hpgl_pen_option1 = option1;
 	  break;
 	case HPGL_PEN_PREDEFINED_CROSSHATCH: /* imported from PCL or RTL */
 	  /* option1 is pattern type, in range 1..6 */
-	  sprintf (_plotter->data->page->point, "SV%d,%d;",
-		   new_hpgl_pen_type, IROUND(option1));
+	  _outbuf_printf (_plotter->data->page, "SV%d,%d;",
+			  new_hpgl_pen_type, IROUND(option1));
 	  /* stash pattern type */
 	  _plotter->hpgl_pen_option1 = option1;
 	  break;
 	}
-      _update_buffer (_plotter->data->page);
       _plotter->hpgl_pen_type = new_hpgl_pen_type;
     }
 }
@@ -649,12 +640,12 @@ _pl_h_set_hpgl_fill_type (R___(Plotter *_plotter) int new_hpgl_fill_type, double
 	case HPGL_FILL_SOLID_UNI: /* unidirectional solid fill */
 	default:
 	  /* options ignored */
-	  sprintf (_plotter->data->page->point, "FT%d;", new_hpgl_fill_type);
+	  _outbuf_printf (_plotter->data->page, "FT%d;", new_hpgl_fill_type);
 	  break;
 	case HPGL_FILL_SHADED:
 	  /* option1 is shading level in percent */
-	  sprintf (_plotter->data->page->point, "FT%d,%.1f;", 
-		   new_hpgl_fill_type, option1);
+	  _outbuf_printf (_plotter->data->page, "FT%d,%.1f;",
+			  new_hpgl_fill_type, option1);
 	  /* stash shading level */
 	  _plotter->hpgl_fill_option1 = option1;
 	  break;
@@ -666,11 +657,11 @@ _pl_h_set_hpgl_fill_type (R___(Plotter *_plotter) int new_hpgl_fill_type, double
 	     (for the latter, cf. setup commands in h_openpl.c).  Also, we
 	     always switch to the solid line type for drawing the lines
 	     (see warning above). */
-	  sprintf (_plotter->data->page->point, 
-		   "LT;SC;FT%d,%d,%d;SC%d,%d,%d,%d;",
-		   new_hpgl_fill_type, IROUND(option1), IROUND(option2),
-		   IROUND (_plotter->data->xmin), IROUND (_plotter->data->xmax), 
-		   IROUND (_plotter->data->ymin), IROUND (_plotter->data->ymax));
+	  _outbuf_printf (_plotter->data->page,
+			  "LT;SC;FT%d,%d,%d;SC%d,%d,%d,%d;",
+			  new_hpgl_fill_type, IROUND(option1), IROUND(option2),
+			  IROUND (_plotter->data->xmin), IROUND (_plotter->data->xmax),
+			  IROUND (_plotter->data->ymin), IROUND (_plotter->data->ymax));
 	  _plotter->hpgl_line_type = HPGL_L_SOLID;
 	  /* stash inter-line distance and angle of lines */
 	  _plotter->hpgl_fill_option1 = option1;
@@ -678,13 +669,12 @@ _pl_h_set_hpgl_fill_type (R___(Plotter *_plotter) int new_hpgl_fill_type, double
 	  break;
 	case HPGL_FILL_PREDEFINED_CROSSHATCH: /* imported from PCL or RTL */
 	  /* option1 is pattern type, in range 1..6 */
-	  sprintf (_plotter->data->page->point, "FT%d,%d;",
-		   new_hpgl_fill_type, IROUND(option1));
+	  _outbuf_printf (_plotter->data->page, "FT%d,%d;",
+			  new_hpgl_fill_type, IROUND(option1));
 	  /* stash pattern type */
 	  _plotter->hpgl_fill_option1 = option1;
 	  break;
 	}
-      _update_buffer (_plotter->data->page);
       _plotter->hpgl_fill_type = new_hpgl_fill_type;
     }
 }
@@ -266,7 +266,7 @@ _pl_h_initialize (S___(Plotter *_plotter))
   {
     const char *version_s;
     
-    version_s = (const char *)_get_plot_param (_plotter->data, "HPGL_VERSION");
+    version_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_HPGL_VERSION);
     /* there are three subcases: "1", "1.5", and "2" (default, see above) */
     if (strcmp (version_s, "1") == 0) /* generic HP-GL, HP7220 or HP7475A */
       {
@@ -354,7 +354,7 @@ _pl_h_initialize (S___(Plotter *_plotter))
   {
     const char *rotate_s;
 
-    rotate_s = (const char *)_get_plot_param (_plotter->data, "HPGL_ROTATE");
+    rotate_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_HPGL_ROTATE);
     /* four subcases: 0 (default), 90, 180, 270 (latter two only if "2") */
     if (strcasecmp (rotate_s, "yes") == 0
 	|| strcmp (rotate_s, "90") == 0)
@@ -372,7 +372,7 @@ _pl_h_initialize (S___(Plotter *_plotter))
   {
     const char *transparent_s;
 
-    transparent_s = (const char *)_get_plot_param (_plotter->data, "HPGL_OPAQUE_MODE" );
+    transparent_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_HPGL_OPAQUE_MODE);
     if (strcasecmp (transparent_s, "no") == 0)
       _plotter->hpgl_use_opaque_mode = false;
   }
@@ -384,7 +384,7 @@ _pl_h_initialize (S___(Plotter *_plotter))
     {
       const char *palette_s;
 	  
-      palette_s = (const char *)_get_plot_param (_plotter->data, "HPGL_ASSIGN_COLORS");
+      palette_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_HPGL_ASSIGN_COLORS);
       if (strcasecmp (palette_s, "yes") == 0)
 	_plotter->hpgl_can_assign_colors = true;
     }
@@ -403,7 +403,7 @@ _pl_h_initialize (S___(Plotter *_plotter))
   {
     const char *pen_s;
 
-    pen_s = (const char *)_get_plot_param (_plotter->data, "HPGL_PENS");
+    pen_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_HPGL_PENS);
     
     if (pen_s == NULL 
 	|| _pl_h_parse_pen_string (R___(_plotter) pen_s) == false
@@ -634,7 +634,7 @@ _pl_q_initialize (S___(Plotter *_plotter))
   {
     const char *palette_s;
     
-    palette_s = (const char *)_get_plot_param (_plotter->data, "PCL_ASSIGN_COLORS");
+    palette_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PCL_ASSIGN_COLORS);
     if (strcasecmp (palette_s, "yes") == 0)
       _plotter->hpgl_can_assign_colors = true;
   }
@@ -644,7 +644,7 @@ _pl_q_initialize (S___(Plotter *_plotter))
   {
     const char *bezier_s;
     
-    bezier_s = (const char *)_get_plot_param (_plotter->data, "PCL_BEZIERS");
+    bezier_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PCL_BEZIERS);
 
     if (strcasecmp (bezier_s, "yes") != 0)
       _plotter->data->allowed_cubic_scaling = AS_NONE;
@@ -749,7 +749,7 @@ _pl_h_parse_pen_string (R___(Plotter *_plotter) const char *pen_s)
 	}
 
       /* got color name string, parse it */
-      if (_string_to_color (name, &color, _plotter->data->color_name_cache))
+      if (_string_to_color (name, &color))
 	{
 	  _plotter->hpgl_pen_color[pen_num] = color;
 	  _plotter->hpgl_pen_defined[pen_num] = 2; /* hard-defined */
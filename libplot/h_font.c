@@ -117,9 +117,8 @@ _pl_h_set_font (S___(Plotter *_plotter))
       if (_plotter->hpgl_rel_label_run != new_relative_label_run
 	  || _plotter->hpgl_rel_label_rise != new_relative_label_rise)
 	{    
-	  sprintf (_plotter->data->page->point, "DR%.3f,%.3f;",
-		   new_relative_label_run, new_relative_label_rise);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "DR%.3f,%.3f;",
+			  new_relative_label_run, new_relative_label_rise);
 	  _plotter->hpgl_rel_label_run = new_relative_label_run;
 	  _plotter->hpgl_rel_label_rise = new_relative_label_rise;
 	}
@@ -238,9 +237,8 @@ _pl_h_set_font (S___(Plotter *_plotter))
 	(new_relative_char_width != _plotter->hpgl_rel_char_width
 	 || new_relative_char_height != _plotter->hpgl_rel_char_height))
       {
-	sprintf (_plotter->data->page->point, "SR%.3f,%.3f;", 
-		 new_relative_char_width, new_relative_char_height);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "SR%.3f,%.3f;",
+			new_relative_char_width, new_relative_char_height);
 	_plotter->hpgl_rel_char_width = new_relative_char_width;
 	_plotter->hpgl_rel_char_height = new_relative_char_height;
       }
@@ -249,8 +247,7 @@ _pl_h_set_font (S___(Plotter *_plotter))
   /* update slant angle if necessary */
   if (tan_slant != _plotter->hpgl_tan_char_slant)
     {
-      sprintf (_plotter->data->page->point, "SL%.3f;", tan_slant);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "SL%.3f;", tan_slant);
       _plotter->hpgl_tan_char_slant = tan_slant;
     }
 }
@@ -344,21 +341,20 @@ _pl_h_hpgl2_maybe_update_font (S___(Plotter *_plotter))
     {
       if (spacing == HPGL2_FIXED_SPACING)
 	/* fixed-width font */
-	sprintf (_plotter->data->page->point, 
-		 /* #4 (nominal point size) not needed but included anyway */
-		 "SD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
-		 symbol_set, spacing, 
-		 (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE, 
-		 posture, stroke_weight, typeface);
+	_outbuf_printf (_plotter->data->page,
+			/* #4 (nominal point size) not needed but included anyway */
+			"SD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
+			symbol_set, spacing,
+			(double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE,
+			posture, stroke_weight, typeface);
       else
 	/* variable-width font */
-	sprintf (_plotter->data->page->point, 
-		 /* #3 (nominal chars per inch) not needed but incl'd anyway */
-		 "SD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
-		 symbol_set, spacing, 
-		 (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE, 
-		 posture, stroke_weight, typeface);
-      _update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page,
+			/* #3 (nominal chars per inch) not needed but incl'd anyway */
+			"SD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
+			symbol_set, spacing,
+			(double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE,
+			posture, stroke_weight, typeface);
 
       /* A hack.  Due to HP's idiosyncratic definition of `ISO-Latin-1
 	 encoding' for PCL fonts, when plotting a label in an ISO-Latin-1
@@ -373,21 +369,20 @@ _pl_h_hpgl2_maybe_update_font (S___(Plotter *_plotter))
 	{
 	  if (spacing == HPGL2_FIXED_SPACING)
 	    /* fixed-width font */
-	    sprintf (_plotter->data->page->point, 
-		     /* #4 (nominal point size) not needed but included anyway */
-		     "AD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
-		     PCL_ISO_8859_1, spacing, 
-		     (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE, 
-		     posture, stroke_weight, typeface);
+	    _outbuf_printf (_plotter->data->page,
+			    /* #4 (nominal point size) not needed but included anyway */
+			    "AD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
+			    PCL_ISO_8859_1, spacing,
+			    (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE,
+			    posture, stroke_weight, typeface);
 	  else
 	    /* variable-width font */
-	    sprintf (_plotter->data->page->point, 
+	    _outbuf_printf (_plotter->data->page,
 		    /* #3 (nominal chars per inch) not needed but included anyway */
-		     "AD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
-		     PCL_ISO_8859_1, spacing, 
-		     (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE, 
-		     posture, stroke_weight, typeface);
-	  _update_buffer (_plotter->data->page);
+			    "AD1,%d,2,%d,3,%.3f,4,%.3f,5,%d,6,%d,7,%d;",
+			    PCL_ISO_8859_1, spacing,
+			    (double)HPGL2_NOMINAL_CHARS_PER_INCH, (double)HPGL2_NOMINAL_POINT_SIZE,
+			    posture, stroke_weight, typeface);
 	}
 
       _plotter->hpgl_symbol_set = symbol_set;
@@ -423,8 +418,7 @@ _pl_h_hpgl_maybe_update_font (S___(Plotter *_plotter))
   /* using `CS', select charset for lower half of font */
   if (new_hpgl_charset_lower != _plotter->hpgl_charset_lower)
     {
-      sprintf (_plotter->data->page->point, "CS%d;", new_hpgl_charset_lower);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "CS%d;", new_hpgl_charset_lower);
       _plotter->hpgl_charset_lower = new_hpgl_charset_lower;
       font_change = true;
     }
@@ -435,8 +429,7 @@ _pl_h_hpgl_maybe_update_font (S___(Plotter *_plotter))
   if (new_hpgl_charset_upper >= 0 
       && new_hpgl_charset_upper != _plotter->hpgl_charset_upper)
     {
-      sprintf (_plotter->data->page->point, "CA%d;", new_hpgl_charset_upper);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "CA%d;", new_hpgl_charset_upper);
       _plotter->hpgl_charset_upper = new_hpgl_charset_upper;
       font_change = true;
     }
@@ -92,18 +92,15 @@ _pl_h_begin_page (S___(Plotter *_plotter))
   /* output HP-GL prologue */
   if (_plotter->hpgl_version == 2)
     {
-      sprintf (_plotter->data->page->point, "BP;IN;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "BP;IN;");
       /* include HP-GL/2 `plot length' directive; important mostly for roll
 	 plotters */
-      sprintf (_plotter->data->page->point, "PS%d;",
-	       IROUND(_plotter->hpgl_plot_length));
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "PS%d;",
+		      IROUND(_plotter->hpgl_plot_length));
     }
   else
     {
-      sprintf (_plotter->data->page->point, "IN;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "IN;");
     }
   
   /* make use of HP-GL's plotting-area rotation capability, if requested by
@@ -111,28 +108,25 @@ _pl_h_begin_page (S___(Plotter *_plotter))
      which rotation=0 always) */
   if (_plotter->hpgl_rotation != 0)
     {
-      sprintf (_plotter->data->page->point, "RO%d;", _plotter->hpgl_rotation);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "RO%d;", _plotter->hpgl_rotation);
     }
   
   /* Set scaling points P1, P2 at lower left and upper right corners of our
      viewport; or more accurately, at the two points that (0,0) and (1,1),
      which are the lower right and upper right corners in NDC space, get
      mapped to. */
-  sprintf (_plotter->data->page->point, "IP%d,%d,%d,%d;",
-	   IROUND(_plotter->hpgl_p1.x), IROUND(_plotter->hpgl_p1.y),
-	   IROUND(_plotter->hpgl_p2.x), IROUND(_plotter->hpgl_p2.y));
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "IP%d,%d,%d,%d;",
+		  IROUND(_plotter->hpgl_p1.x), IROUND(_plotter->hpgl_p1.y),
+		  IROUND(_plotter->hpgl_p2.x), IROUND(_plotter->hpgl_p2.y));
   
   /* Set up `scaled device coordinates' within the viewport.  All
      coordinates in the output file will be scaled device coordinates, not
      physical device coordinates.  The range of scaled coordinates will be
      independent of the viewport positioning, page size, etc.; see the
      definitions of xmin,xmax,ymin,ymax in h_defplot.c. */
-  sprintf (_plotter->data->page->point, "SC%d,%d,%d,%d;",
-	   IROUND (_plotter->data->xmin), IROUND (_plotter->data->xmax), 
-	   IROUND (_plotter->data->ymin), IROUND (_plotter->data->ymax));
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "SC%d,%d,%d,%d;",
+		  IROUND (_plotter->data->xmin), IROUND (_plotter->data->xmax),
+		  IROUND (_plotter->data->ymin), IROUND (_plotter->data->ymax));
   
   if (_plotter->hpgl_version == 2)
     {
@@ -141,17 +135,14 @@ _pl_h_begin_page (S___(Plotter *_plotter))
 	 though many support only a default palette.) */
       if (_plotter->hpgl_can_assign_colors)
 	{
-	  sprintf (_plotter->data->page->point, "NP%d;", HPGL2_MAX_NUM_PENS);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "NP%d;", HPGL2_MAX_NUM_PENS);
 	}
       /* use relative units for pen width */
-      sprintf (_plotter->data->page->point, "WU1;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "WU1;");
     }
   
   /* select pen #1 (standard plotting convention) */
-  sprintf (_plotter->data->page->point, "SP1;");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "SP1;");
   
   /* For HP-GL/2 devices, set transparency mode to `opaque', if the user
      allows it.  It should always be opaque to agree with libplot
@@ -159,8 +150,7 @@ _pl_h_begin_page (S___(Plotter *_plotter))
      `TR' command allegedly does not NOP gracefully. */
   if (_plotter->hpgl_version == 2 && _plotter->hpgl_use_opaque_mode)
     {
-      sprintf (_plotter->data->page->point, "TR0;");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "TR0;");
     }
 
   /* freeze contents of output buffer, i.e. the initialization code we've
@@ -182,10 +172,8 @@ _pl_q_maybe_switch_to_hpgl (S___(Plotter *_plotter))
   if (_plotter->data->page_number > 1) /* not first page */
     /* eject previous page, by issuing PCL command */
     {	
-      strcpy (_plotter->data->page->point, "\f"); /* i.e. form feed */
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "\f"); /* i.e. form feed */
     }
   /* switch from PCL 5 to HP-GL/2 mode */
-  strcpy (_plotter->data->page->point, "\033%0B\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "\033%0B\n");
 }
@@ -50,6 +50,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	bool closed, use_polygon_buffer;
 	double last_x, last_y;
 	int i, polyline_len;
+	plPathIterator iter;
 	bool identical_user_coordinates = true;
 
 	/* sanity checks */
@@ -59,8 +60,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;	/* 2-point ones should be open */
@@ -71,22 +72,23 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	xarray = (plIntPathSegment *)_pl_xmalloc (_plotter->drawstate->path->num_segments * sizeof(plIntPathSegment));
 	
 	/* add first point of path to xarray[] (type field is a moveto) */
-	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
-	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->segments[0].p.x, 
-				  _plotter->drawstate->path->segments[0].p.y));
+	xarray[0].p.x = IROUND(XD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
+	xarray[0].p.y = IROUND(YD(_plotter->drawstate->path->points[0].x, 
+				  _plotter->drawstate->path->points[0].y));
 	polyline_len = 1;
 	/* save user coors of last point added to xarray[] */
-	last_x = _plotter->drawstate->path->segments[0].p.x;
-	last_y = _plotter->drawstate->path->segments[0].p.y;  
+	last_x = _plotter->drawstate->path->points[0].x;
+	last_y = _plotter->drawstate->path->points[0].y;  
 	
+	_path_iter_start (&iter, _plotter->drawstate->path, 1);
 	for (i = 1; i < _plotter->drawstate->path->num_segments; i++)
 	  {
 	    plPathSegment datapoint;
 	    double xuser, yuser, xdev, ydev;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
+	    _path_iter_next (&iter, &datapoint);
 	    xuser = datapoint.p.x;
 	    yuser = datapoint.p.y;
 	    if (xuser != last_x || yuser != last_y)
@@ -174,7 +176,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		/* move to center of circle */
 		savedpoint = _plotter->drawstate->pos;
 		_plotter->drawstate->pos = 
-		  _plotter->drawstate->path->segments[0].p;
+		  _plotter->drawstate->path->points[0];
 		_pl_h_set_position (S___(_plotter));
 		_plotter->drawstate->pos = savedpoint;
 		
@@ -199,9 +201,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		if (_plotter->hpgl_bad_pen == false)
 		  /* fill the circle (360 degree wedge) */
 		  {
-		    sprintf (_plotter->data->page->point, "WG%d,0,360;", 
-			     IROUND(device_frame_radius));
-		    _update_buffer (_plotter->data->page);
+		    _outbuf_printf (_plotter->data->page, "WG%d,0,360;",
+				    IROUND(device_frame_radius));
 		  }
 		/* KLUDGE: in pre-HP-GL/2, our `set_fill_color' function
 		   may alter the line type, since it may request *solid*
@@ -249,7 +250,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	_pl_h_set_attributes (S___(_plotter));
 	
 	savedpoint = _plotter->drawstate->pos;
-	_plotter->drawstate->pos = _plotter->drawstate->path->segments[0].p;
+	_plotter->drawstate->pos = _plotter->drawstate->path->points[0];
 	_pl_h_set_position (S___(_plotter));
 	_plotter->drawstate->pos = savedpoint;
 	
@@ -257,8 +258,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	  /* have a polygon buffer, and can use it to fill polyline */
 	  {
 	    /* enter polygon mode */
-	    strcpy (_plotter->data->page->point, "PM0;");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "PM0;");
 	  }
 	
 	if (use_polygon_buffer || _plotter->drawstate->pen_type)
@@ -270,8 +270,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    /* ensure that pen is down for drawing */
 	    if (_plotter->hpgl_pendown == false)
 	      {
-		strcpy (_plotter->data->page->point, "PD;");
-		_update_buffer (_plotter->data->page);
+		_outbuf_puts (_plotter->data->page, "PD;");
 		_plotter->hpgl_pendown = true;
 	      }
 	    
@@ -283,44 +282,38 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		  {
 		  case (int)S_LINE:
 		    /* emit one or more pen advances */
-		    strcpy (_plotter->data->page->point, "PA");
-		    _update_buffer (_plotter->data->page);
-		    sprintf (_plotter->data->page->point, "%d,%d", 
-			     xarray[i].p.x, xarray[i].p.y);
-		    _update_buffer (_plotter->data->page);
+		    _outbuf_puts (_plotter->data->page, "PA");
+		    _outbuf_printf (_plotter->data->page, "%d,%d",
+				    xarray[i].p.x, xarray[i].p.y);
 		    i++;
 		    while (i < polyline_len && xarray[i].type == S_LINE)
 		      {
-			sprintf (_plotter->data->page->point, 
-				 ",%d,%d", xarray[i].p.x, xarray[i].p.y);
-			_update_buffer (_plotter->data->page);
+			_outbuf_putc (_plotter->data->page, ',');
+			_outbuf_put_int (_plotter->data->page, xarray[i].p.x);
+			_outbuf_putc (_plotter->data->page, ',');
+			_outbuf_put_int (_plotter->data->page, xarray[i].p.y);
 			i++;
 		      }
-		    sprintf (_plotter->data->page->point, ";");
-		    _update_buffer (_plotter->data->page);	  
+		    _outbuf_puts (_plotter->data->page, ";");
 		    break;
 		    
 		  case (int)S_CUBIC:
 		    /* emit one or more cubic Bezier segments */
-		    strcpy (_plotter->data->page->point, "BZ");
-		    _update_buffer (_plotter->data->page);
-		    sprintf (_plotter->data->page->point, "%d,%d,%d,%d,%d,%d",
-			     xarray[i].pc.x, xarray[i].pc.y,
-			     xarray[i].pd.x, xarray[i].pd.y,
-			     xarray[i].p.x, xarray[i].p.y);
-		    _update_buffer (_plotter->data->page);
+		    _outbuf_puts (_plotter->data->page, "BZ");
+		    _outbuf_printf (_plotter->data->page, "%d,%d,%d,%d,%d,%d",
+				    xarray[i].pc.x, xarray[i].pc.y,
+				    xarray[i].pd.x, xarray[i].pd.y,
+				    xarray[i].p.x, xarray[i].p.y);
 		    i++;
 		    while (i < polyline_len && xarray[i].type == S_CUBIC)
 		      {
-			sprintf (_plotter->data->page->point, ",%d,%d,%d,%d,%d,%d",
-				 xarray[i].pc.x, xarray[i].pc.y,
-				 xarray[i].pd.x, xarray[i].pd.y,
-				 xarray[i].p.x, xarray[i].p.y);
-			_update_buffer (_plotter->data->page);
+			_outbuf_printf (_plotter->data->page, ",%d,%d,%d,%d,%d,%d",
+					xarray[i].pc.x, xarray[i].pc.y,
+					xarray[i].pd.x, xarray[i].pd.y,
+					xarray[i].p.x, xarray[i].p.y);
 			i++;
 		      }
-		  sprintf (_plotter->data->page->point, ";");
-		  _update_buffer (_plotter->data->page);	  
+		  _outbuf_puts (_plotter->data->page, ";");
 		  break;
 		  
 		  case (int)S_ARC:
@@ -335,22 +328,21 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 			/* HPGL_VERSION = 1.5 or 2 */
 			{
 			  if (degrees == (double)int_degrees)
-			    sprintf (_plotter->data->page->point, "AA%d,%d,%d;",
-				     xarray[i].pc.x, xarray[i].pc.y,
-				     int_degrees);
+			    _outbuf_printf (_plotter->data->page, "AA%d,%d,%d;",
+					    xarray[i].pc.x, xarray[i].pc.y,
+					    int_degrees);
 			  else
-			    sprintf (_plotter->data->page->point, "AA%d,%d,%.3f;",
-				     xarray[i].pc.x, xarray[i].pc.y,
-				     degrees);
+			    _outbuf_printf (_plotter->data->page, "AA%d,%d,%.3f;",
+					    xarray[i].pc.x, xarray[i].pc.y,
+					    degrees);
 			}
 		      else
 			/* HPGL_VERSION = 1, i.e. generic HP-GL */
 			/* note: generic HP-GL can only handle integer
 			   sweep angles */
-			sprintf (_plotter->data->page->point, "AA%d,%d,%d;",
-				 xarray[i].pc.x, xarray[i].pc.y,
-				 int_degrees);
-		      _update_buffer (_plotter->data->page);
+			_outbuf_printf (_plotter->data->page, "AA%d,%d,%d;",
+					xarray[i].pc.x, xarray[i].pc.y,
+					int_degrees);
 		      i++;
 		    }
 		    break;
@@ -371,19 +363,15 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    if (!closed)
 	      /* polyline is open, so lift pen and exit polygon mode */
 	      {
-		strcpy (_plotter->data->page->point, "PU;");
-		_update_buffer (_plotter->data->page);
+		_outbuf_puts (_plotter->data->page, "PU;");
 		_plotter->hpgl_pendown = false;
-		strcpy (_plotter->data->page->point, "PM2;");
-		_update_buffer (_plotter->data->page);
+		_outbuf_puts (_plotter->data->page, "PM2;");
 	      }
 	    else
 	      /* polyline is closed, so exit polygon mode and then lift pen */
 	      {
-		strcpy (_plotter->data->page->point, "PM2;");
-		_update_buffer (_plotter->data->page);
-		strcpy (_plotter->data->page->point, "PU;");
-		_update_buffer (_plotter->data->page);
+		_outbuf_puts (_plotter->data->page, "PM2;");
+		_outbuf_puts (_plotter->data->page, "PU;");
 		_plotter->hpgl_pendown = false;
 	      }
 	    
@@ -404,16 +392,15 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 		      {
 		      case PL_FILL_ODD_WINDING:
 		      default:
-			strcpy (_plotter->data->page->point, "FP;");
+			_outbuf_puts (_plotter->data->page, "FP;");
 			break;
 		      case PL_FILL_NONZERO_WINDING:		  
 			if (_plotter->hpgl_version == 2)
-			  strcpy (_plotter->data->page->point, "FP1;");
+			  _outbuf_puts (_plotter->data->page, "FP1;");
 			else	/* pre-HP-GL/2 doesn't support nonzero rule */
-			  strcpy (_plotter->data->page->point, "FP;");
+			  _outbuf_puts (_plotter->data->page, "FP;");
 			break;
 		      }
-		    _update_buffer (_plotter->data->page);
 		  }
 	    /* KLUDGE: in pre-HP-GL/2, our `set_fill_color' function may
 	       alter the line type, since it may request *solid*
@@ -435,8 +422,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
                      polyline */
 		  {
 		    _pl_h_set_pen_color (R___(_plotter) HPGL_OBJECT_PATH);
-		    strcpy (_plotter->data->page->point, "EP;");
-		    _update_buffer (_plotter->data->page);
+		    _outbuf_puts (_plotter->data->page, "EP;");
 		  }
 	      }
 	  }
@@ -482,9 +468,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    if (_plotter->hpgl_bad_pen == false)
 	      /* fill the rectangle */
 	      {
-		sprintf (_plotter->data->page->point, "RA%d,%d;", 
-			 IROUND(XD(p1.x,p1.y)), IROUND(YD(p1.x,p1.y)));
-		_update_buffer (_plotter->data->page);
+		_outbuf_printf (_plotter->data->page, "RA%d,%d;",
+				IROUND(XD(p1.x,p1.y)), IROUND(YD(p1.x,p1.y)));
 	      }
 	    /* KLUDGE: in pre-HP-GL/2, our `set_fill_color' function may
 	       alter the line type, since it may request *solid*
@@ -504,9 +489,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    if (_plotter->hpgl_bad_pen == false)
 	      /* edge the rectangle */
 	      {
-		sprintf (_plotter->data->page->point, "EA%d,%d;", 
-			 IROUND(XD(p1.x,p1.y)), IROUND(YD(p1.x,p1.y)));
-		_update_buffer (_plotter->data->page);
+		_outbuf_printf (_plotter->data->page, "EA%d,%d;",
+				IROUND(XD(p1.x,p1.y)), IROUND(YD(p1.x,p1.y)));
 	      }
 	  }
       }
@@ -539,9 +523,8 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    if (_plotter->hpgl_bad_pen == false)
 	      /* fill the circle (360 degree wedge) */
 	      {
-		sprintf (_plotter->data->page->point, "WG%d,0,360;", 
-			 IROUND(radius));
-		_update_buffer (_plotter->data->page);
+		_outbuf_printf (_plotter->data->page, "WG%d,0,360;",
+				IROUND(radius));
 	      }
 	    /* KLUDGE: in pre-HP-GL/2, our `set_fill_color' function may
 	       alter the line type, since it may request *solid*
@@ -561,8 +544,7 @@ _pl_h_paint_path (S___(Plotter *_plotter))
 	    if (_plotter->hpgl_bad_pen == false)
 	      /* do the edging */
 	      {
-		sprintf (_plotter->data->page->point, "CI%d;", IROUND(radius));
-		_update_buffer (_plotter->data->page);
+		_outbuf_printf (_plotter->data->page, "CI%d;", IROUND(radius));
 	      }
 	  }
       }
@@ -594,12 +576,11 @@ _pl_h_set_position (S___(Plotter *_plotter))
     {
       if (_plotter->hpgl_pendown == true)
 	{
-	  sprintf (_plotter->data->page->point, "PU;PA%d,%d;", xnew, ynew);
+	  _outbuf_printf (_plotter->data->page, "PU;PA%d,%d;", xnew, ynew);
 	  _plotter->hpgl_pendown = false;
 	}
       else
-	sprintf (_plotter->data->page->point, "PA%d,%d;", xnew, ynew);
-      _update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "PA%d,%d;", xnew, ynew);
 
       /* update our knowledge of pen position */
       _plotter->hpgl_position_is_unknown = false;
@@ -59,9 +59,8 @@ _pl_h_paint_point (S___(Plotter *_plotter))
 	{
 	  if (_plotter->hpgl_pen_width != POINT_HPGL_SIZE)
 	    {
-	      sprintf (_plotter->data->page->point, "PW%.4f;", 
-		       100.0 * POINT_HPGL_SIZE);
-	      _update_buffer (_plotter->data->page);
+	      _outbuf_printf (_plotter->data->page, "PW%.4f;",
+			      100.0 * POINT_HPGL_SIZE);
 	      _plotter->hpgl_pen_width = POINT_HPGL_SIZE;
 	    }
 	}
@@ -72,12 +71,10 @@ _pl_h_paint_point (S___(Plotter *_plotter))
 	  if (_plotter->hpgl_pendown == false)
 	    /* N.B. if pen were down, point would be invisible */
 	    {
-	      strcpy (_plotter->data->page->point, "PD;");
-	      _update_buffer (_plotter->data->page);
+	      _outbuf_puts (_plotter->data->page, "PD;");
 	      _plotter->hpgl_pendown = true;
 	    }
-	  strcpy (_plotter->data->page->point, "PU;");
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_puts (_plotter->data->page, "PU;");
 	  _plotter->hpgl_pendown = false;
 	}
       
@@ -364,15 +364,12 @@ _pl_h_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     /* output the label via an `LB' instruction, including label
        terminator; don't use sprintf to avoid having to escape % and \ */
     {
-      strcpy (_plotter->data->page->point, "LB");
-      _update_buffer (_plotter->data->page);
-      strcpy (_plotter->data->page->point, (const char *)t);
-      _update_buffer (_plotter->data->page);      
+      _outbuf_puts (_plotter->data->page, "LB");
+      _outbuf_puts (_plotter->data->page, (const char *)t);
       instruction_buf[0] = (unsigned char)3; /* ^C = default label terminator*/
       instruction_buf[1] = ';';
       instruction_buf[2] = '\0';
-      strcpy (_plotter->data->page->point, (const char *)instruction_buf);
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, (const char *)instruction_buf);
 
       /* where is the plotter pen now located?? we don't know, exactly */
       _plotter->hpgl_position_is_unknown = true;
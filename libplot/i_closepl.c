@@ -18,7 +18,8 @@
 
 #include "sys-defines.h"
 #include "extern.h"
-#include "i_rle.h"		/* use miGIF RLE (non-LZW) compression */
+#include "i_lzw.h"		/* LZW compression (the default) */
+#include "i_rle.h"		/* miGIF RLE (non-LZW) compression */
 #include "xmi.h"
 
 /* GIF89a frame disposal methods (a 3-bit field; values 4..7 are reserved) */
@@ -27,8 +28,24 @@
 #define DISP_RESTORE_TO_BACKGROUND 2
 #define DISP_RESTORE_TO_PREVIOUS 3
 
+/* starting rows and row increments for the four passes of an interlaced
+   GIF image (pass 0: every 8th row, starting with row 0; pass 1: every
+   8th row, starting with row 4; pass 2: every 4th row, starting with row
+   2; pass 3: every 2nd row, starting with row 1) */
+static const int interlace_start[4] = { 0, 4, 2, 1 };
+static const int interlace_step[4] = { 8, 8, 4, 2 };
+
+/* when deciding whether to write unchanged pixels as transparent, sample
+   every this many rows */
+#define RUN_SAMPLE_STEP 8
+
 /* forward references */
 static bool same_colormap (plColor cmap1[256], plColor cmap2[256], int num1, int num2);
+static bool changed_rectangle (const miCanvas *canvas, const plColor cmap[256], const unsigned char *prev_frame, const plColor prev_cmap[256], int xn, int yn, plIntPoint *origin, int *width, int *height);
+static bool fewer_runs_if_transparent (const miCanvas *canvas, const plColor cmap[256], const unsigned char *prev_frame, const plColor prev_cmap[256], int xn, plIntPoint origin, int width, int height);
+static void pack_colormap (const plColor cmap[256], unsigned long rgb[256]);
+static void save_frame (const miCanvas *canvas, unsigned char **prev_frame, int xn, int yn);
+static const unsigned char * transparent_row (const unsigned char *row, const unsigned char *prev_row, const unsigned long rgb[256], const unsigned long prev_rgb[256], int width, int transparent_index, unsigned char *buffer);
 
 bool
 _pl_i_end_page (S___(Plotter *_plotter))
@@ -44,12 +61,15 @@ _pl_i_end_page (S___(Plotter *_plotter))
     {
       if (_plotter->data->page_number == 1)
 	{
+	  /* if need be, build the frame's colormap (see i_color.c) */
+	  if (_plotter->i_quantize)
+	    _pl_i_quantize_image (S___(_plotter));
 	  if (_plotter->i_header_written == false)
 	    {
 	      _pl_i_write_gif_header (S___(_plotter));
 	      _plotter->i_header_written = true;
 	    }
-	  /* emit GIF image of current frame using RLE module (see i_rle.c) */
+	  /* emit GIF image of current frame */
 	  _pl_i_write_gif_image (S___(_plotter));
 	  _pl_i_write_gif_trailer (S___(_plotter));
 	}
@@ -105,10 +125,12 @@ _pl_i_write_gif_header (S___(Plotter *_plotter))
 
   /* Header block, including Signature and Version. */
 
-  /* To express transparency, a nontrivial number of iterations, or a
-     nontrivial delay between successive images, need GIF89a format, not
+  /* To express transparency, a nontrivial number of iterations, a
+     nontrivial delay between successive images, or a disposal method for
+     images that are written as differences, need GIF89a format, not
      GIF87a. */
   if (_plotter->i_transparent 
+      || _plotter->i_differencing
       || (_plotter->i_animation && _plotter->i_iterations > 0)
       || (_plotter->i_animation && _plotter->i_delay > 0))
     _write_string (_plotter->data, "GIF89a");
@@ -188,11 +210,48 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
 {
   bool write_local_table;
   int i, min_code_size, packed_bits;
+  plIntPoint origin;
+  int width, height, transparent_index;
+
+  /* By default, the image is the entire frame.  But if the frame is to be
+     written as a difference from its predecessor, it is only the
+     rectangle containing the pixels that have changed, if any (if none,
+     we write a single unchanged pixel, to preserve the timing of the
+     animation); and within the rectangle, unchanged pixels will be
+     written as transparent, if the colormap has an unused entry that can
+     serve as the transparent color index, and if doing so will yield
+     longer runs of identical pixels, which compress better. */
+  origin.x = 0;
+  origin.y = 0;
+  width = _plotter->i_xn;
+  height = _plotter->i_yn;
+  transparent_index = -1;
+  if (_plotter->i_differencing && _plotter->i_prev_frame)
+    {
+      if (changed_rectangle ((const miCanvas *)_plotter->i_canvas, 
+			     _plotter->i_colormap, _plotter->i_prev_frame, 
+			     _plotter->i_prev_colormap, 
+			     _plotter->i_xn, _plotter->i_yn,
+			     &origin, &width, &height) == false)
+	{
+	  width = 1;
+	  height = 1;
+	}
+      if (_plotter->i_num_color_indices < (1 << IMAX(_plotter->i_bit_depth, 1))
+	  && fewer_runs_if_transparent ((const miCanvas *)_plotter->i_canvas,
+					_plotter->i_colormap, 
+					_plotter->i_prev_frame, 
+					_plotter->i_prev_colormap, 
+					_plotter->i_xn, origin, width, height))
+	transparent_index = _plotter->i_num_color_indices;
+    }
 
   /* Graphic Control Block (a GIF89a feature; modifies following image
-     descriptor).  Needed to express transparency of each image, or a
-     non-default delay after each image. */
+     descriptor).  Needed to express transparency of each image, a
+     non-default delay after each image, or that images written as
+     differences should be left in place. */
   if (_plotter->i_transparent 
+      || _plotter->i_differencing
       || (_plotter->i_animation && _plotter->i_delay > 0))
     {
       unsigned char packed_byte;
@@ -209,10 +268,12 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
       /* Packed fields: Reserved (3 bits), Disposal Method (3 bits),
 	 User Input Flag (1 bit), Transparency Flag (final 1 bit) */
       packed_byte = 0;
-      if (_plotter->i_transparent)
+      if (_plotter->i_transparent || transparent_index >= 0)
 	packed_byte |= 1;
       if (_plotter->i_transparent && _plotter->i_animation)
 	packed_byte |= (DISP_RESTORE_TO_BACKGROUND << 2);
+      else if (_plotter->i_differencing)
+	packed_byte |= (DISP_NONE << 2);
       else
 	packed_byte |= (DISP_UNSPECIFIED << 2);
       _write_byte (_plotter->data, packed_byte);
@@ -221,8 +282,13 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
 	 (2-byte unsigned int) */
       _pl_i_write_short_int (R___(_plotter) (unsigned int)(_plotter->i_delay));
 
-      /* Transparent Color Index [the same for all frames] */ 
-     _write_byte (_plotter->data, (unsigned char)_plotter->i_transparent_index);
+      /* Transparent Color Index [the same for all frames, unless they are
+	 written as differences] */ 
+      if (transparent_index >= 0)
+	_write_byte (_plotter->data, (unsigned char)transparent_index);
+      else
+	_write_byte (_plotter->data, 
+		     (unsigned char)_plotter->i_transparent_index);
 
       /* Block Terminator (0-length data block) */
       _write_byte (_plotter->data, (unsigned char)0);
@@ -235,12 +301,12 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
 
   /* Image Left and Top Positions (w/ respect to logical screen;
      2-byte unsigned ints) */
-  _pl_i_write_short_int (R___(_plotter) 0);
-  _pl_i_write_short_int (R___(_plotter) 0);
+  _pl_i_write_short_int (R___(_plotter) (unsigned int)origin.x);
+  _pl_i_write_short_int (R___(_plotter) (unsigned int)origin.y);
 
   /* Image Width, Height (2-byte unsigned ints) */
-  _pl_i_write_short_int (R___(_plotter) (unsigned int)_plotter->i_xn);
-  _pl_i_write_short_int (R___(_plotter) (unsigned int)_plotter->i_yn);
+  _pl_i_write_short_int (R___(_plotter) (unsigned int)width);
+  _pl_i_write_short_int (R___(_plotter) (unsigned int)height);
 
   /* does current frame's color table differ from zeroth frame's color
      table (i.e. GIF file's global color table)? */
@@ -282,34 +348,96 @@ _pl_i_write_gif_image (S___(Plotter *_plotter))
      depth, since our allocated color indices are contiguous.  However,
      this has a floor of 2, and, also compression codes must start out one
      bit longer than the floored version, "because of some algorithmic
-     constraints".  See i_rle.c.) */
+     constraints".  See i_lzw.c and i_rle.c.) */
   min_code_size = IMAX(_plotter->i_bit_depth, 2);
   _write_byte (_plotter->data, (unsigned char)min_code_size);
 
-  /* initialize pixel scanner */
-  _pl_i_start_scan (S___(_plotter));
-
   /* Image Data, consisting of a sequence of sub-blocks of size at most 
-     255 bytes each, encoded as LZW with variable-length code
-     (actually, we use miGIF [RLE] rather than LZW; see i_rle.c) */
+     255 bytes each, encoded as LZW with variable-length code (by default;
+     see i_lzw.c), or with miGIF [RLE], which any LZW decoder will decode
+     (see i_rle.c).  The encoder is sent whole rows of color indices, taken
+     straight from the canvas (or, if unchanged pixels are to be written
+     as transparent, from a buffer into which each row is copied), in the
+     order in which they appear in the image data: top to bottom, or if
+     interlacing, in the four passes of interlace_start[] and
+     interlace_step[]. */
   {
-    rle_out *rle;
-    int pixel;
-      
+    const miPackedPixmap *packed;
+    unsigned char *row_buffer = (unsigned char *)NULL;
+    unsigned long rgb[256], prev_rgb[256];
+    rle_out *rle = (rle_out *)NULL;
+    lzw_out *lzw = (lzw_out *)NULL;
+    int pass, num_passes, y;
+
+    packed = ((const miCanvas *)_plotter->i_canvas)->packed;
+    if (transparent_index >= 0)
+      {
+	row_buffer = (unsigned char *)_pl_xmalloc ((size_t)width);
+	pack_colormap (_plotter->i_colormap, rgb);
+	pack_colormap (_plotter->i_prev_colormap, prev_rgb);
+      }
+
+    if (_plotter->i_rle)
 #ifdef LIBPLOTTER
-    rle = _rle_init (_plotter->data->outfp, _plotter->data->outstream,
-		     _plotter->i_bit_depth);
+      rle = _rle_init (_plotter->data->outfp, _plotter->data->outstream,
+		       _plotter->i_bit_depth);
 #else
-    rle = _rle_init (_plotter->data->outfp,
-		     _plotter->i_bit_depth);
+      rle = _rle_init (_plotter->data->outfp,
+		       _plotter->i_bit_depth);
 #endif
-    while ((pixel = _pl_i_scan_pixel (S___(_plotter))) != -1)
-      _rle_do_pixel (rle, pixel);
-    _rle_terminate (rle);
+    else
+#ifdef LIBPLOTTER
+      lzw = _lzw_init (_plotter->data->outfp, _plotter->data->outstream,
+		       _plotter->i_bit_depth);
+#else
+      lzw = _lzw_init (_plotter->data->outfp,
+		       _plotter->i_bit_depth);
+#endif
+
+    num_passes = (_plotter->i_interlace ? 4 : 1);
+    for (pass = 0; pass < num_passes; pass++)
+      {
+	int first = (_plotter->i_interlace ? interlace_start[pass] : 0);
+	int step = (_plotter->i_interlace ? interlace_step[pass] : 1);
+
+	for (y = first; y < height; y += step)
+	  {
+	    const unsigned char *row = 
+	      MI_PACKED_INDEX8_ROW(packed, origin.y + y) + origin.x;
+
+	    if (row_buffer)
+	      row = transparent_row (row, 
+				     _plotter->i_prev_frame 
+				     + (origin.y + y) * _plotter->i_xn + origin.x,
+				     rgb, prev_rgb, width, transparent_index,
+				     row_buffer);
+	    if (rle)
+	      _rle_do_row (rle, row, width);
+	    else
+	      _lzw_do_row (lzw, row, width);
+	  }
+      }
+
+    if (rle)
+      _rle_terminate (rle);
+    else
+      _lzw_terminate (lzw);
+    if (row_buffer)
+      free (row_buffer);
   }
 
   /* Block Terminator */
   _write_byte (_plotter->data, (unsigned char)0);
+
+  /* if later frames are to be written as differences, keep a copy of this
+     one, and its colormap */
+  if (_plotter->i_differencing)
+    {
+      save_frame ((const miCanvas *)_plotter->i_canvas, 
+		  &_plotter->i_prev_frame, _plotter->i_xn, _plotter->i_yn);
+      for (i = 0; i < 256; i++)
+	_plotter->i_prev_colormap[i] = _plotter->i_colormap[i];
+    }
 }
 
 void
@@ -319,90 +447,6 @@ _pl_i_write_gif_trailer (S___(Plotter *_plotter))
   _write_byte (_plotter->data, (unsigned char)';');
 }
 
-/* reset scanner variables (first pixel scanned is (0,0), i.e. upper
-   left-hand corner) */
-void
-_pl_i_start_scan (S___(Plotter *_plotter))
-{
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
-}
-
-/* Return index (in color table) of pixel under the hot spot, and continue
-   the scan by moving to the next pixel.  Return -1 when scan is finished. */
-int
-_pl_i_scan_pixel (S___(Plotter *_plotter))
-{
-  if (_plotter->i_pixels_scanned < _plotter->i_num_pixels)
-    {
-      miCanvas *canvas;
-      int x, y;
-      miPixel full_pixel;
-      int pixel;
-
-      /* use a libxmi macro, defined in xmi.h, to extract the miPixel at
-	 the hotspot; extract index field from it */
-      canvas = (miCanvas *)_plotter->i_canvas;
-      x = _plotter->i_hot.x;
-      y = _plotter->i_hot.y;      
-      MI_GET_CANVAS_DRAWABLE_PIXEL(canvas, x, y, full_pixel)
-      pixel = full_pixel.u.index;
-
-      _plotter->i_hot.x++;
-      if (_plotter->i_hot.x == _plotter->i_xn)
-	{
-	  _plotter->i_hot.x = 0;
-
-	  if (_plotter->i_interlace == false)
-	    _plotter->i_hot.y++;
-	  else			/* move to next scan line */
-	    {
-	      switch (_plotter->i_pass)
-		{
-		case 0:
-		  /* every 8th row, starting with row 0 */
-		  _plotter->i_hot.y += 8;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 4;
-		    }
-		  break;
-		case 1:
-		  /* every 8th row, starting with row 4 */
-		  _plotter->i_hot.y += 8;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 2;
-		    }
-		  break;
-		case 2:
-		  /* every 4th row, starting with row 2 */
-		  _plotter->i_hot.y += 4;
-		  if (_plotter->i_hot.y >= _plotter->i_yn)
-		    {
-		      _plotter->i_pass++;
-		      _plotter->i_hot.y = 1;
-		    }
-		  break;
-		case 3:
-		  /* every 2nd row, starting with row 1 */
-		  _plotter->i_hot.y += 2;
-		  break;
-		}
-	    }
-	}
-
-      _plotter->i_pixels_scanned++;
-      return pixel;
-    }
-  else				/* scan is finished */
-    return -1;
-}
-
 /* write out an unsigned short int, in range 0..65535, as 2 bytes in
    little-endian order */
 void
@@ -420,11 +464,17 @@ _pl_i_write_short_int (R___(Plotter *_plotter) unsigned int i)
 void
 _pl_i_delete_image (S___(Plotter *_plotter))
 {
+  /* if requested, report on storage used by libxmi in rasterizing */
+  _pl_g_report_mi_stats (R___(_plotter)
+			 _plotter->i_painted_set, _plotter->i_arc_cache_data);
+
   /* deallocate libxmi's drawing canvas (and painted set struct too) */
   miDeleteCanvas ((miCanvas *)_plotter->i_canvas);
   _plotter->i_canvas = (void *)NULL;
   miDeletePaintedSet ((miPaintedSet *)_plotter->i_painted_set);
   _plotter->i_painted_set = (void *)NULL;
+  miDeleteCoverageSet ((miCoverageSet *)_plotter->i_coverage_set);
+  _plotter->i_coverage_set = (void *)NULL;
 
   /* reset colormap */
   _plotter->i_num_color_indices = 0;
@@ -450,3 +500,136 @@ same_colormap (plColor cmap1[256], plColor cmap2[256], int num1, int num2)
       return false;
   return true;
 }
+
+/* Compute the smallest rectangle containing all pixels of a frame whose
+   colors differ from those of the corresponding pixels of the previous
+   frame (stored as color indices into its own colormap).  Return false if
+   there are none. */
+static bool
+changed_rectangle (const miCanvas *canvas, const plColor cmap[256], const unsigned char *prev_frame, const plColor prev_cmap[256], int xn, int yn, plIntPoint *origin, int *width, int *height)
+{
+  unsigned long rgb[256], prev_rgb[256];
+  int x, y, xmin = xn, xmax = -1, ymin = yn, ymax = -1;
+
+  /* pack colors, so each pixel needs only one comparison */
+  pack_colormap (cmap, rgb);
+  pack_colormap (prev_cmap, prev_rgb);
+
+  for (y = 0; y < yn; y++)
+    {
+      const unsigned char *row = MI_PACKED_INDEX8_ROW(canvas->packed, y);
+      const unsigned char *prev_row = prev_frame + y * xn;
+
+      /* leftmost changed pixel in row */
+      for (x = 0; x < xn; x++)
+	if (rgb[row[x]] != prev_rgb[prev_row[x]])
+	  break;
+      if (x == xn)
+	continue;		/* row unchanged */
+      if (x < xmin)
+	xmin = x;
+
+      /* rightmost changed pixel in row, if beyond those found so far */
+      for (x = xn - 1; x > xmax; x--)
+	if (rgb[row[x]] != prev_rgb[prev_row[x]])
+	  {
+	    xmax = x;
+	    break;
+	  }
+
+      if (ymin == yn)
+	ymin = y;
+      ymax = y;
+    }
+
+  if (ymax < 0)
+    return false;
+
+  origin->x = xmin;
+  origin->y = ymin;
+  *width = xmax - xmin + 1;
+  *height = ymax - ymin + 1;
+  return true;
+}
+
+/* Count the runs of identical pixels in the rows of a rectangle within a
+   frame, both as is and with the pixels that are unchanged from the
+   previous frame replaced by a single transparent value, and return true
+   if the latter count is smaller.  Making unchanged pixels transparent
+   helps when the changes are drawn over a detailed background, but can
+   hurt when it breaks up uniform areas.  To save time, only every
+   RUN_SAMPLE_STEP'th row is examined. */
+static bool
+fewer_runs_if_transparent (const miCanvas *canvas, const plColor cmap[256], const unsigned char *prev_frame, const plColor prev_cmap[256], int xn, plIntPoint origin, int width, int height)
+{
+  unsigned long rgb[256], prev_rgb[256];
+  long runs = 0, transparent_runs = 0;
+  int x, y;
+
+  pack_colormap (cmap, rgb);
+  pack_colormap (prev_cmap, prev_rgb);
+
+  for (y = origin.y; y < origin.y + height; y += RUN_SAMPLE_STEP)
+    {
+      const unsigned char *row = 
+	MI_PACKED_INDEX8_ROW(canvas->packed, y) + origin.x;
+      const unsigned char *prev_row = prev_frame + y * xn + origin.x;
+      int last = -1, last_transparent = -1;
+
+      for (x = 0; x < width; x++)
+	{
+	  int pixel = row[x];
+	  int transparent_pixel = 
+	    (rgb[pixel] == prev_rgb[prev_row[x]] ? 256 : pixel);
+
+	  if (pixel != last)
+	    runs++;
+	  if (transparent_pixel != last_transparent)
+	    transparent_runs++;
+	  last = pixel;
+	  last_transparent = transparent_pixel;
+	}
+    }
+
+  return (transparent_runs < runs ? true : false);
+}
+
+/* pack the red, green and blue components of each color in a colormap
+   into a single integer */
+static void
+pack_colormap (const plColor cmap[256], unsigned long rgb[256])
+{
+  int i;
+
+  for (i = 0; i < 256; i++)
+    rgb[i] = ((unsigned long)cmap[i].red << 16) 
+      | ((unsigned long)cmap[i].green << 8) | (unsigned long)cmap[i].blue;
+}
+
+/* Copy a row of the rectangle being written into a buffer, replacing each
+   pixel whose color is the same as that of the corresponding pixel of the
+   previous frame by the transparent color index; return the buffer. */
+static const unsigned char *
+transparent_row (const unsigned char *row, const unsigned char *prev_row, const unsigned long rgb[256], const unsigned long prev_rgb[256], int width, int transparent_index, unsigned char *buffer)
+{
+  int x;
+
+  for (x = 0; x < width; x++)
+    buffer[x] = (rgb[row[x]] == prev_rgb[prev_row[x]] 
+		 ? (unsigned char)transparent_index : row[x]);
+  return buffer;
+}
+
+/* copy the color indices of a frame, row by row, into a buffer that is
+   allocated the first time */
+static void
+save_frame (const miCanvas *canvas, unsigned char **prev_frame, int xn, int yn)
+{
+  int y;
+
+  if (*prev_frame == (unsigned char *)NULL)
+    *prev_frame = (unsigned char *)_pl_xmalloc ((size_t)xn * (size_t)yn);
+  for (y = 0; y < yn; y++)
+    memcpy (*prev_frame + y * xn, MI_PACKED_INDEX8_ROW(canvas->packed, y), 
+	    (size_t)xn);
+}
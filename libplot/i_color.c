@@ -19,13 +19,43 @@
 /* This file contains device-specific color database access routines.
    These routines are called by various GIFPlotter methods, before drawing
    objects.  They set the appropriate GIFPlotter-specific fields in the
-   drawing state. */
+   drawing state.  This file also contains the routine that, if the
+   GIF_QUANTIZE parameter is "yes", builds each frame's colormap from the
+   24-bit RGBs drawn in it, by median-cut quantization. */
 
 #include "sys-defines.h"
 #include "extern.h"
+#include "xmi.h"
+
+/* hash a 24-bit RGB, for the table mapping RGBs to color indices */
+#define COLOR_HASH(rgb) \
+  ((int)((((unsigned long)(rgb) * 0x9e3779b1UL) & 0xffffffffUL) >> 16) \
+   & (GIF_COLOR_HASH_SIZE - 1))
+
+/* a distinct color in a frame that is being quantized, with the number of
+   pixels that have it, and the colormap index to which it is mapped */
+typedef struct
+{
+  miRGBA32 rgb;
+  unsigned long count;
+  int index;
+} plHistogramEntry;
+
+/* a box in RGB space, containing a contiguous range of the entries in an
+   array of pointers to histogram entries */
+typedef struct
+{
+  int first, num_entries;
+  unsigned long count;
+} plColorBox;
 
 /* forward references */
 static int bit_depth (int colors);
+static plHistogramEntry * histogram_entry (plHistogramEntry **table, int *size, int *num_entries, miRGBA32 rgb);
+static int longest_axis (plHistogramEntry **entries, int num_entries);
+static int compare_red (const void *a, const void *b);
+static int compare_green (const void *a, const void *b);
+static int compare_blue (const void *a, const void *b);
 
 /* we call this routine to evaluate _plotter->drawstate->i_pen_color_index
    lazily, i.e. only when needed (just before a drawing operation) */
@@ -145,28 +175,27 @@ _pl_i_set_bg_color(S___(Plotter *_plotter))
     }
 }
 
-/* Internal function, called by each of the above.  It searches for a
-   24-bit RGB in the color table.  If not found, it's added to table,
-   unless table can't be expanded, in which case index with closest RGB is
-   returned. */
+/* Internal function, called by each of the above.  It looks up a 24-bit
+   RGB in the hash table that maps RGBs to color indices.  If not found,
+   it's added to the color table, unless table can't be expanded, in which
+   case index with closest RGB is returned (and remembered in the hash
+   table, if there's room).  If the colormap is to be built when the frame
+   is written, it isn't used while drawing, and this returns 0. */
 
 unsigned char 
 _pl_i_new_color_index (R___(Plotter *_plotter) int red, int green, int blue)
 {
-  int i, j;
-  int sqdist;
-  bool found = false;
-
-  for (i = 0; i < _plotter->i_num_color_indices; i++)
-    if (_plotter->i_colormap[i].red == red
-	&& _plotter->i_colormap[i].green == green
-	&& _plotter->i_colormap[i].blue == blue)
-      {
-	found = true;
-	break;
-      }
-  if (found)
-    return (unsigned char)i;
+  int i, j, h;
+  int sqdist, key;
+
+  if (_plotter->i_quantize)
+    return (unsigned char)0;
+
+  key = (red << 16) | (green << 8) | blue;
+  for (h = COLOR_HASH(key); _plotter->i_color_hash_key[h] >= 0;
+       h = (h + 1) & (GIF_COLOR_HASH_SIZE - 1))
+    if (_plotter->i_color_hash_key[h] == key)
+      return _plotter->i_color_hash_index[h];
 
   /* not found, try to allocate new index */
   i = _plotter->i_num_color_indices;
@@ -181,6 +210,10 @@ _pl_i_new_color_index (R___(Plotter *_plotter) int red, int green, int blue)
 	 In effect the colormap for any of these sizes will be of size 256. */
       _plotter->i_bit_depth = bit_depth (i + 1);
 
+      _plotter->i_color_hash_key[h] = key;
+      _plotter->i_color_hash_index[h] = (unsigned char)i;
+      _plotter->i_num_color_hash_entries++;
+
       return (unsigned char)i;
     }
   
@@ -204,9 +237,231 @@ _pl_i_new_color_index (R___(Plotter *_plotter) int red, int green, int blue)
 	  i = j;		/* best to date */
 	}
     }
+
+  /* remember the closest RGB, unless hash table is 3/4 full */
+  if (_plotter->i_num_color_hash_entries < 3 * (GIF_COLOR_HASH_SIZE / 4))
+    {
+      _plotter->i_color_hash_key[h] = key;
+      _plotter->i_color_hash_index[h] = (unsigned char)i;
+      _plotter->i_num_color_hash_entries++;
+    }
+
   return (unsigned char)i;
 }
 
+/* Internal function: construct the libxmi miPixel with which a color in
+   the drawing state is painted.  That is its index in the colormap,
+   unless the colormap is to be built when the frame is written, in which
+   case it is the 24-bit RGB itself. */
+
+void
+_pl_i_color_pixel (R___(Plotter *_plotter) void * ptr_pixel, plColor color, unsigned char index)
+{
+  miPixel *pixel = (miPixel *)ptr_pixel;
+
+  if (_plotter->i_quantize)
+    {
+      pixel->type = MI_PIXEL_RGB_TYPE;
+      pixel->u.rgb[0] = (unsigned char)color.red;
+      pixel->u.rgb[1] = (unsigned char)color.green;
+      pixel->u.rgb[2] = (unsigned char)color.blue;
+    }
+  else
+    {
+      pixel->type = MI_PIXEL_INDEX_TYPE;
+      pixel->u.index = index;
+    }
+}
+
+/* Internal function, called just before a frame is written out, if the
+   GIF_QUANTIZE parameter is "yes".  The frame has been drawn on a canvas
+   of 24-bit RGBs.  Build a colormap from the histogram of the colors in
+   it: if there are at most 256, one entry per color; otherwise one entry
+   per box of colors, where the boxes are obtained by repeatedly splitting
+   the most populous box at the median of its longest axis (Heckbert's
+   median-cut algorithm), and each entry is its box's mean color.  Then
+   replace the canvas by one of color indices.
+
+   If there is a transparent color, it keeps index #0 to itself, as
+   i_closepl.c requires, and only pixels of exactly that color get it. */
+
+void
+_pl_i_quantize_image (S___(Plotter *_plotter))
+{
+  miCanvas *canvas, *index_canvas;
+  miPixel pixel;
+  plHistogramEntry *table, *entry, **entries;
+  plColorBox boxes[256];
+  miRGBA32 transparent_rgb = 0, last_rgb;
+  int table_size, num_table_entries, num_entries, num_boxes, max_boxes;
+  int first_index, i, j, x, y;
+
+  canvas = (miCanvas *)_plotter->i_canvas;
+
+  /* histogram of the frame's colors, as an open-addressed hash table */
+  table_size = 1024;
+  num_table_entries = 0;
+  table = (plHistogramEntry *)_pl_xcalloc ((size_t)table_size,
+					   sizeof(plHistogramEntry));
+  entry = (plHistogramEntry *)NULL;
+  last_rgb = 0;
+  for (y = 0; y < _plotter->i_yn; y++)
+    {
+      const miRGBA32 *row = MI_PACKED_RGBA32_ROW(canvas->packed, y);
+
+      for (x = 0; x < _plotter->i_xn; x++)
+	{
+	  miRGBA32 rgb = row[x] & 0xffffff; /* ignore alpha */
+
+	  if (entry == (plHistogramEntry *)NULL || rgb != last_rgb)
+	    {
+	      entry = histogram_entry (&table, &table_size, 
+				       &num_table_entries, rgb);
+	      last_rgb = rgb;
+	    }
+	  entry->count++;
+	}
+    }
+
+  /* if there's a transparent color, reserve index #0 for it */
+  first_index = 0;
+  if (_plotter->i_transparent)
+    {
+      transparent_rgb = MI_RGBA32(_plotter->i_transparent_color.red,
+				  _plotter->i_transparent_color.green,
+				  _plotter->i_transparent_color.blue, 0);
+      _plotter->i_colormap[0] = _plotter->i_transparent_color;
+      first_index = 1;
+    }
+
+  /* gather the other colors */
+  entries = (plHistogramEntry **)_pl_xmalloc ((size_t)num_table_entries 
+					      * sizeof(plHistogramEntry *));
+  num_entries = 0;
+  for (i = 0; i < table_size; i++)
+    if (table[i].count > 0)
+      {
+	if (first_index > 0 && table[i].rgb == transparent_rgb)
+	  table[i].index = 0;
+	else
+	  entries[num_entries++] = &table[i];
+      }
+
+  /* split colors into boxes, one per remaining colormap entry */
+  max_boxes = 256 - first_index;
+  num_boxes = 0;
+  if (num_entries > 0)
+    {
+      boxes[0].first = 0;
+      boxes[0].num_entries = num_entries;
+      boxes[0].count = 0;
+      for (i = 0; i < num_entries; i++)
+	boxes[0].count += entries[i]->count;
+      num_boxes = 1;
+    }
+  while (num_boxes < max_boxes)
+    {
+      plColorBox *box = (plColorBox *)NULL;
+      unsigned long half, count;
+      int (*compare) (const void *, const void *);
+      
+      /* find most populous box that can be split */
+      for (i = 0; i < num_boxes; i++)
+	if (boxes[i].num_entries > 1
+	    && (box == (plColorBox *)NULL || boxes[i].count > box->count))
+	  box = &boxes[i];
+      if (box == (plColorBox *)NULL)
+	break;			/* each box holds a single color */
+
+      /* sort its colors along its longest axis */
+      switch (longest_axis (entries + box->first, box->num_entries))
+	{
+	case 0:
+	  compare = compare_red;
+	  break;
+	case 1:
+	  compare = compare_green;
+	  break;
+	case 2:
+	default:
+	  compare = compare_blue;
+	  break;
+	}
+      qsort ((void *)(entries + box->first), (size_t)box->num_entries,
+	     sizeof(plHistogramEntry *), compare);
+
+      /* split at the median pixel, leaving at least one color on each
+	 side */
+      half = box->count / 2;
+      count = entries[box->first]->count;
+      for (j = 1; j < box->num_entries - 1; j++)
+	{
+	  if (count >= half)
+	    break;
+	  count += entries[box->first + j]->count;
+	}
+      boxes[num_boxes].first = box->first + j;
+      boxes[num_boxes].num_entries = box->num_entries - j;
+      boxes[num_boxes].count = box->count - count;
+      box->num_entries = j;
+      box->count = count;
+      num_boxes++;
+    }
+
+  /* each box's colormap entry is its mean color */
+  for (i = 0; i < num_boxes; i++)
+    {
+      unsigned long red = 0, green = 0, blue = 0, count = boxes[i].count;
+
+      for (j = boxes[i].first; j < boxes[i].first + boxes[i].num_entries; j++)
+	{
+	  miRGBA32 rgb = entries[j]->rgb;
+	  unsigned long n = entries[j]->count;
+
+	  red += n * MI_RGBA32_COMPONENT(rgb, 0);
+	  green += n * MI_RGBA32_COMPONENT(rgb, 1);
+	  blue += n * MI_RGBA32_COMPONENT(rgb, 2);
+	  entries[j]->index = first_index + i;
+	}
+      _plotter->i_colormap[first_index + i].red = (int)((red + count / 2) / count);
+      _plotter->i_colormap[first_index + i].green = (int)((green + count / 2) / count);
+      _plotter->i_colormap[first_index + i].blue = (int)((blue + count / 2) / count);
+    }
+  _plotter->i_num_color_indices = first_index + num_boxes;
+  _plotter->i_bit_depth = bit_depth (_plotter->i_num_color_indices);
+
+  /* replace canvas of RGBs by a canvas of color indices */
+  pixel.type = MI_PIXEL_INDEX_TYPE;
+  pixel.u.index = 0;
+  index_canvas = miNewPackedCanvas ((unsigned int)_plotter->i_xn, 
+				    (unsigned int)_plotter->i_yn, 
+				    MI_PACKED_INDEX8, pixel);
+  entry = (plHistogramEntry *)NULL;
+  for (y = 0; y < _plotter->i_yn; y++)
+    {
+      const miRGBA32 *row = MI_PACKED_RGBA32_ROW(canvas->packed, y);
+      unsigned char *index_row = MI_PACKED_INDEX8_ROW(index_canvas->packed, y);
+
+      for (x = 0; x < _plotter->i_xn; x++)
+	{
+	  miRGBA32 rgb = row[x] & 0xffffff;
+
+	  if (entry == (plHistogramEntry *)NULL || rgb != last_rgb)
+	    {
+	      entry = histogram_entry (&table, &table_size, 
+				       &num_table_entries, rgb);
+	      last_rgb = rgb;
+	    }
+	  index_row[x] = (unsigned char)entry->index;
+	}
+    }
+  miDeleteCanvas (canvas);
+  _plotter->i_canvas = (void *)index_canvas;
+
+  free (entries);
+  free (table);
+}
+
 /* compute number of bits needed to represent all color indices
    (when this is called, colors >= 1) */
 static int
@@ -222,3 +477,116 @@ bit_depth (int colors)
 
   return size;
 }
+
+/* Find the entry for a 24-bit RGB in a histogram hash table, adding it
+   (with zero count, to be incremented at once by the caller; entries with
+   zero count are empty) if it isn't there yet.  The table is doubled in
+   size when it becomes half full. */
+static plHistogramEntry *
+histogram_entry (plHistogramEntry **table, int *size, int *num_entries, miRGBA32 rgb)
+{
+  plHistogramEntry *t = *table;
+  int h, mask = *size - 1;
+
+  for (h = COLOR_HASH(rgb) & mask; t[h].count > 0; 
+       h = (h + 1) & mask)
+    if (t[h].rgb == rgb)
+      return &t[h];
+
+  if (2 * (*num_entries + 1) > *size)
+    /* grow table, and rehash */
+    {
+      plHistogramEntry *new_t;
+      int i, new_size = 2 * *size;
+
+      new_t = (plHistogramEntry *)_pl_xcalloc ((size_t)new_size, 
+					       sizeof(plHistogramEntry));
+      for (i = 0; i < *size; i++)
+	if (t[i].count > 0)
+	  {
+	    for (h = COLOR_HASH(t[i].rgb) & (new_size - 1); 
+		 new_t[h].count > 0;
+		 h = (h + 1) & (new_size - 1))
+	      ;
+	    new_t[h] = t[i];
+	  }
+      free (t);
+      *table = t = new_t;
+      *size = new_size;
+      mask = new_size - 1;
+      for (h = COLOR_HASH(rgb) & mask; t[h].count > 0; 
+	   h = (h + 1) & mask)
+	;
+    }
+
+  t[h].rgb = rgb;
+  t[h].count = 0;		/* caller will increment this */
+  t[h].index = 0;
+  (*num_entries)++;
+  return &t[h];
+}
+
+/* return the axis (0, 1 or 2, for red, green or blue) along which a set
+   of colors has the greatest extent */
+static int
+longest_axis (plHistogramEntry **entries, int num_entries)
+{
+  int min[3], max[3], i, k, axis;
+
+  for (k = 0; k < 3; k++)
+    {
+      min[k] = 255;
+      max[k] = 0;
+    }
+  for (i = 0; i < num_entries; i++)
+    for (k = 0; k < 3; k++)
+      {
+	int c = MI_RGBA32_COMPONENT(entries[i]->rgb, k);
+
+	if (c < min[k])
+	  min[k] = c;
+	if (c > max[k])
+	  max[k] = c;
+      }
+  axis = 0;
+  for (k = 1; k < 3; k++)
+    if (max[k] - min[k] > max[axis] - min[axis])
+      axis = k;
+  return axis;
+}
+
+/* comparison functions for qsort(), ordering histogram entries by one
+   component of their RGBs (ties are broken by the whole RGB, so that the
+   order doesn't depend on qsort()) */
+#define COMPARE_COMPONENT(a, b, k) \
+  (MI_RGBA32_COMPONENT((*(plHistogramEntry * const *)(a))->rgb, (k)) \
+   - MI_RGBA32_COMPONENT((*(plHistogramEntry * const *)(b))->rgb, (k)))
+#define COMPARE_RGB(a, b) \
+  ((*(plHistogramEntry * const *)(a))->rgb \
+   < (*(plHistogramEntry * const *)(b))->rgb ? -1 : \
+   (*(plHistogramEntry * const *)(a))->rgb \
+   > (*(plHistogramEntry * const *)(b))->rgb ? 1 : 0)
+
+static int
+compare_red (const void *a, const void *b)
+{
+  int d = COMPARE_COMPONENT(a, b, 0);
+
+  return (d != 0 ? d : COMPARE_RGB(a, b));
+}
+
+static int
+compare_green (const void *a, const void *b)
+{
+  int d = COMPARE_COMPONENT(a, b, 1);
+
+  return (d != 0 ? d : COMPARE_RGB(a, b));
+}
+
+static int
+compare_blue (const void *a, const void *b)
+{
+  int d = COMPARE_COMPONENT(a, b, 2);
+
+  return (d != 0 ? d : COMPARE_RGB(a, b));
+}
@@ -134,33 +134,33 @@ _pl_i_initialize (S___(Plotter *_plotter))
   /* parameters */
   _plotter->i_xn = _plotter->data->imax + 1;
   _plotter->i_yn = _plotter->data->jmin + 1;
-  _plotter->i_num_pixels = (_plotter->i_xn) * (_plotter->i_yn);
   _plotter->i_animation = true;	/* default, can be turned off */
   _plotter->i_iterations = 0;
   _plotter->i_delay = 0;
   _plotter->i_interlace = false;
+  _plotter->i_rle = false;
+  _plotter->i_quantize = false;
+  _plotter->i_antialias = false;
   _plotter->i_transparent = false;  
   _plotter->i_transparent_color.red = 255; /* dummy */
   _plotter->i_transparent_color.green = 255; /* dummy */
   _plotter->i_transparent_color.blue = 255; /* dummy */
   _plotter->i_transparent_index = 0; /* dummy */
-  /* storage used by libxmi's reentrant miDrawArcs_r() function for
-     cacheing rasterized ellipses */
-  _plotter->i_arc_cache_data = (void *)miNewEllipseCache ();
   /* dynamic variables */
   _plotter->i_painted_set = (void *)NULL;
   _plotter->i_canvas = (void *)NULL;
-  /* N.B. _plotter->i_colormap is initialized in i_openpl.c */
+  _plotter->i_coverage_set = (void *)NULL;
+  /* N.B. _plotter->i_colormap and _plotter->i_color_hash_key are
+     initialized in i_openpl.c */
   _plotter->i_num_color_indices = 0;
+  _plotter->i_num_color_hash_entries = 0;
   _plotter->i_bit_depth = 0;
   _plotter->i_frame_nonempty = false;
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
   /* N.B. _plotter->i_global_colormap, i_num_global_color_indices are
      copied into later */
   _plotter->i_header_written = false;
+  _plotter->i_differencing = false;
+  _plotter->i_prev_frame = (unsigned char *)NULL;
 
   /* initialize certain data members from device driver parameters */
 
@@ -169,9 +169,9 @@ _pl_i_initialize (S___(Plotter *_plotter))
     const char *transparent_name_s;
     plColor color;
 
-    transparent_name_s = (const char *)_get_plot_param (_plotter->data, "TRANSPARENT_COLOR");
+    transparent_name_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_TRANSPARENT_COLOR);
     if (transparent_name_s 
-	&& _string_to_color (transparent_name_s, &color, _plotter->data->color_name_cache))
+	&& _string_to_color (transparent_name_s, &color))
       /* have 24-bit RGB */
       {
 	_plotter->i_transparent = true;
@@ -183,16 +183,56 @@ _pl_i_initialize (S___(Plotter *_plotter))
   {
     const char *interlace_s;
 
-    interlace_s = (const char *)_get_plot_param (_plotter->data, "INTERLACE" );
+    interlace_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_INTERLACE);
     if (strcasecmp (interlace_s, "yes") == 0)
       _plotter->i_interlace = true;
   }
   
+  /* compress with miGIF run-length encoding rather than LZW? */
+  {
+    const char *compression_s;
+
+    compression_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_GIF_COMPRESSION);
+    if (strcasecmp (compression_s, "rle") == 0)
+      _plotter->i_rle = true;
+  }
+  
+  /* build each frame's colormap from the colors in it, when written? */
+  {
+    const char *quantize_s;
+
+    quantize_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_GIF_QUANTIZE);
+    if (strcasecmp (quantize_s, "yes") == 0)
+      _plotter->i_quantize = true;
+  }
+  
+  /* draw with anti-aliasing? */
+  {
+    const char *antialias_s;
+
+    antialias_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_ANTIALIAS);
+    if (strcasecmp (antialias_s, "yes") == 0)
+      _plotter->i_antialias = true;
+  }
+
+  /* initialize storage used by libxmi's reentrant miDrawArcs_r() function
+     for cacheing rasterized ellipses, of user-specified size */
+  {
+    const char *cache_size_s;
+    int cache_size;
+
+    cache_size_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_ELLIPSE_CACHE_SIZE);
+    if (sscanf (cache_size_s, "%d", &cache_size) > 0 && cache_size >= 0)
+      _plotter->i_arc_cache_data = (void *)miNewEllipseCacheOfSize (cache_size);
+    else
+      _plotter->i_arc_cache_data = (void *)miNewEllipseCache ();
+  }
+
   /* turn off animation? */
   {
     const char *animate_s;
 
-    animate_s = (const char *)_get_plot_param (_plotter->data, "GIF_ANIMATION" );
+    animate_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_GIF_ANIMATION);
     if (strcasecmp (animate_s, "no") == 0)
       _plotter->i_animation = false;
   }
@@ -202,7 +242,7 @@ _pl_i_initialize (S___(Plotter *_plotter))
     const char *iteration_s;
     int num_iterations;
 
-    iteration_s = (const char *)_get_plot_param (_plotter->data, "GIF_ITERATIONS" );
+    iteration_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_GIF_ITERATIONS);
     if (sscanf (iteration_s, "%d", &num_iterations) > 0 
 	&& num_iterations >= 0 && num_iterations <= 65535)
       _plotter->i_iterations = num_iterations;
@@ -213,7 +253,7 @@ _pl_i_initialize (S___(Plotter *_plotter))
     const char *delay_s;
     int delay;
 
-    delay_s = (const char *)_get_plot_param (_plotter->data, "GIF_DELAY" );
+    delay_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_GIF_DELAY);
     if (sscanf (delay_s, "%d", &delay) > 0 
 	&& delay >= 0 && delay <= 65535)
       _plotter->i_delay = delay;
@@ -226,7 +266,7 @@ _pl_i_initialize (S___(Plotter *_plotter))
     const char *bitmap_size_s;
     int width = 1, height = 1;
 	
-    bitmap_size_s = (const char *)_get_plot_param (_plotter->data, "BITMAPSIZE");
+    bitmap_size_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_BITMAPSIZE);
     if (bitmap_size_s && parse_bitmap_size (bitmap_size_s, &width, &height)
 	/* insist on range of 1..65535 for GIF format */
 	&& width >= 1 && height >= 1
@@ -237,7 +277,6 @@ _pl_i_initialize (S___(Plotter *_plotter))
 	_plotter->data->jmin = height - 1;
 	_plotter->i_xn = width;
 	_plotter->i_yn = height;
-	_plotter->i_num_pixels = width * height;
       }
   }
 
@@ -275,6 +314,10 @@ _pl_i_terminate (S___(Plotter *_plotter))
   /* free storage used by libxmi's reentrant miDrawArcs_r() function */
   miDeleteEllipseCache ((miEllipseCache *)_plotter->i_arc_cache_data);
 
+  /* free copy of last frame written, if any */
+  if (_plotter->i_prev_frame)
+    free (_plotter->i_prev_frame);
+
 #ifndef LIBPLOTTER
   /* in libplot, manually invoke superclass termination method */
   _pl_g_terminate (S___(_plotter));
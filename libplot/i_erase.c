@@ -28,12 +28,20 @@ _pl_i_erase_page (S___(Plotter *_plotter))
   if (_plotter->i_animation && _plotter->data->page_number == 1 && _plotter->data->outfp
       && (_plotter->data->frame_number > 0 || _plotter->i_frame_nonempty))
     {
+      /* if need be, build the frame's colormap (see i_color.c) */
+      if (_plotter->i_quantize)
+	_pl_i_quantize_image (S___(_plotter));
       if (_plotter->i_header_written == false)
 	{
+	  /* more images will follow this one, so unless there is a
+	     transparent color (which requires each image to be drawn on a
+	     cleared screen), write each later image as the rectangle in
+	     which it differs from its predecessor; see i_closepl.c */
+	  _plotter->i_differencing = (_plotter->i_transparent ? false : true);
 	  _pl_i_write_gif_header (S___(_plotter));
 	  _plotter->i_header_written = true;
 	}
-      /* emit image using RLE module (see i_rle.c) */
+      /* emit image (see i_closepl.c) */
       _pl_i_write_gif_image (S___(_plotter));
     }
 
@@ -0,0 +1,214 @@
+/* This file is part of the GNU plotutils package.  Copyright (C) 1995,
+   1996, 1997, 1998, 1999, 2000, 2005, 2008, Free Software Foundation, Inc.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* This file (i_lzw.c) is a module that does LZW compression on a sequence
+   of integers ("pixel values"), and writes the resulting encoded sequence
+   to an output stream, as a sequence of GIF data sub-blocks.  The
+   accompanying header file (i_lzw.h) defines the external interface.
+
+   The string table is a hash table, keyed by (pixel value, prefix code)
+   pairs, with multiplicative hashing and linear probing.  Codes start out
+   one bit longer than the minimum needed to represent the set of pixel
+   values, and lengthen as the table fills; when all 2**LZW_BITS codes
+   have been assigned, a clear code is emitted and the table is started
+   afresh. */
+
+#include "sys-defines.h"	/* libplot-specific */
+#include "extern.h"		/* libplot-specific */
+#include "i_lzw.h"
+
+/* forward references */
+static void _lzw_clear_table (lzw_out *lzw);
+static void _lzw_block_out (lzw_out *lzw, unsigned char c);
+static void _lzw_output (lzw_out *lzw, int code);
+static void _lzw_write_block (lzw_out *lzw);
+
+static void 
+_lzw_write_block (lzw_out *lzw)
+{
+  if (lzw->ofile)
+    {
+      fputc (lzw->oblen, lzw->ofile);
+      fwrite ((void *) &(lzw->oblock[0]), 1, lzw->oblen, lzw->ofile);
+    }
+#ifdef LIBPLOTTER
+  else if (lzw->outstream)
+    {
+      lzw->outstream->put ((unsigned char)(lzw->oblen));
+      lzw->outstream->write ((const char *)(&(lzw->oblock[0])), lzw->oblen);
+    }
+#endif  
+
+  lzw->oblen = 0;
+}
+
+static void 
+_lzw_block_out (lzw_out *lzw, unsigned char c)
+{
+  lzw->oblock[(lzw->oblen)++] = c;
+  if (lzw->oblen >= 255)
+    _lzw_write_block (lzw);
+}
+
+/* Write a code, of the current length.  The length is updated after the
+   code is written, once the next code to be assigned no longer fits in
+   it; since a decoder assigns each code one step later than the encoder,
+   that is when the decoder lengthens its codes too. */
+static void 
+_lzw_output (lzw_out *lzw, int code)
+{
+  lzw->obuf |= (unsigned long)code << lzw->obits;
+  lzw->obits += lzw->n_bits;
+  while (lzw->obits >= 8)
+    { 
+      _lzw_block_out (lzw, (unsigned char)(lzw->obuf & 0xff));
+      lzw->obuf >>= 8;
+      lzw->obits -= 8;
+    }
+
+  if (lzw->clear_pending)
+    {
+      lzw->n_bits = lzw->init_bits;
+      lzw->max_code = (1 << lzw->n_bits) - 1;
+      lzw->clear_pending = false;
+    }
+  else if (lzw->free_code > lzw->max_code)
+    {
+      lzw->n_bits++;
+      if (lzw->n_bits == LZW_BITS)
+	/* no further lengthening; table is cleared when full instead */
+	lzw->max_code = 1 << LZW_BITS;
+      else
+	lzw->max_code = (1 << lzw->n_bits) - 1;
+    }
+}
+
+/* empty the string table, and emit a clear code */
+static void 
+_lzw_clear_table (lzw_out *lzw)
+{
+  /* all bits set, i.e. -1, marks an unused entry */
+  memset ((void *)lzw->hash_key, 0xff, sizeof(lzw->hash_key));
+  lzw->free_code = lzw->code_eof + 1;
+  lzw->clear_pending = true;
+  _lzw_output (lzw, lzw->code_clear);
+}
+
+/***********************************************************************/
+/* 			EXTERNAL INTERFACE			       */
+/***********************************************************************/
+
+/* create new LZW struct, which writes to a specified stream */
+lzw_out *
+#ifdef LIBPLOTTER
+_lzw_init (FILE *fp, ostream *out, int bit_depth)
+#else
+_lzw_init (FILE *fp, int bit_depth)
+#endif
+{
+  lzw_out *lzw;
+
+  lzw = (lzw_out *)_pl_xmalloc (sizeof(lzw_out));
+  lzw->ofile = fp;
+#ifdef LIBPLOTTER
+  lzw->outstream = out;
+#endif
+  lzw->obuf = 0;
+  lzw->obits = 0;
+  lzw->oblen = 0;
+
+  /* Initial length for compression codes, one bit longer than the minimum
+     number of bits needed to represent the set of pixel values, which has
+     a floor of 2 (the minimum code size written into the GIF stream). */
+  lzw->init_bits = IMAX(bit_depth, 2) + 1;
+  lzw->n_bits = lzw->init_bits;
+  lzw->max_code = (1 << lzw->n_bits) - 1;
+  lzw->code_clear = 1 << (lzw->init_bits - 1);
+  lzw->code_eof = lzw->code_clear + 1;
+  lzw->prefix = -1;
+
+  /* a GIF stream conventionally begins with a clear code */
+  _lzw_clear_table (lzw);
+
+  return lzw;
+}
+
+/* send a row of pixels to the LZW encoder; the string matched so far is
+   kept in a local variable while the row is processed */
+void
+_lzw_do_row (lzw_out *lzw, const unsigned char *pixels, int n)
+{
+  int prefix, key, c, h, i;
+
+  if (n <= 0)
+    return;
+
+  prefix = lzw->prefix;
+  i = 0;
+  if (prefix < 0)
+    /* first pixel: the string matched so far is the pixel itself */
+    prefix = pixels[i++];
+
+  for ( ; i < n; i++)
+    {
+      c = pixels[i];
+
+      /* look for the string (prefix, c) in the table */
+      key = (c << LZW_BITS) | prefix;
+      h = (int)((((unsigned long)key * 2654435761UL) & 0xffffffffUL)
+		>> (32 - LZW_HASH_BITS));
+      while (lzw->hash_key[h] >= 0 && lzw->hash_key[h] != key)
+	h = (h + 1) & (LZW_HASH_SIZE - 1);
+
+      if (lzw->hash_key[h] == key)
+	/* found, so extend the match */
+	prefix = lzw->hash_code[h];
+      else
+	/* not found, so emit the code for the prefix, and start a new
+	   string with c; add (prefix, c) to the table, if there is room */
+	{
+	  _lzw_output (lzw, prefix);
+	  prefix = c;
+	  if (lzw->free_code < (1 << LZW_BITS))
+	    {
+	      lzw->hash_code[h] = (unsigned short)(lzw->free_code++);
+	      lzw->hash_key[h] = key;
+	    }
+	  else
+	    _lzw_clear_table (lzw);
+	}
+    }
+
+  lzw->prefix = prefix;
+}
+
+/* flush out any data remaining in LZW; write EOF and deallocate LZW */
+void
+_lzw_terminate (lzw_out *lzw)
+{
+  /* if a string in progress, emit its code */
+  if (lzw->prefix >= 0)
+    _lzw_output (lzw, lzw->prefix);
+  _lzw_output (lzw, lzw->code_eof);
+  if (lzw->obits > 0)
+    _lzw_block_out (lzw, (unsigned char)(lzw->obuf & 0xff));
+  if (lzw->oblen > 0)
+    _lzw_write_block (lzw);
+  /* deallocate */
+  free (lzw);
+}
@@ -0,0 +1,65 @@
+/* This file is part of the GNU plotutils package.  Copyright (C) 1995,
+   1996, 1997, 1998, 1999, 2000, 2005, 2008, Free Software Foundation, Inc.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* This header file (i_lzw.h) defines the external interface to the module
+   i_lzw.c, which does LZW compression on a sequence of integers ("pixel
+   values"), as the GIF format specifies, and writes the resulting encoded
+   sequence to an output stream.  Its interface is the same as that of the
+   run-length encoder in i_rle.c, which it has replaced as the default. */
+
+/* maximum length of an LZW code in a GIF stream */
+#define LZW_BITS 12
+
+/* size of the hash table used as the string table; twice 2**LZW_BITS, so
+   that it is never more than half full, and probe sequences are short */
+#define LZW_HASH_BITS (LZW_BITS + 1)
+#define LZW_HASH_SIZE (1 << LZW_HASH_BITS)
+
+/* the LZW output structure */
+typedef struct
+{
+  int init_bits;		/* initial code length, incl. extra bit */
+  int n_bits;			/* current code length */
+  int max_code;			/* largest code of the current length */
+  int code_clear;		/* the clear code */
+  int code_eof;			/* the end-of-information code */
+  int free_code;		/* next code to be assigned */
+  bool clear_pending;		/* clear code output, lengths to be reset */
+  int prefix;			/* code for string matched so far, or -1 */
+  int hash_key[LZW_HASH_SIZE];	/* (pixel, prefix) pair, or -1 if unused */
+  unsigned short hash_code[LZW_HASH_SIZE]; /* code assigned to the pair */
+  unsigned long obuf;
+  int obits;
+  FILE *ofile;
+#ifdef LIBPLOTTER
+  ostream *outstream;
+#endif
+  unsigned char oblock[256];
+  int oblen;
+} lzw_out;
+
+/* create, initialize, and return a new LZW output structure */
+#ifdef LIBPLOTTER
+extern lzw_out *_lzw_init (FILE *fp, ostream *out, int bit_depth);
+#else
+extern lzw_out *_lzw_init (FILE *fp, int bit_depth);
+#endif
+/* write a row of pixels (color indices) to the structure */
+extern void _lzw_do_row (lzw_out *lzw, const unsigned char *pixels, int n);
+/* wind things up and deallocate the LZW output structure */
+extern void _lzw_terminate (lzw_out *lzw);
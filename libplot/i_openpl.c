@@ -30,14 +30,18 @@ _pl_i_begin_page (S___(Plotter *_plotter))
      
   _plotter->i_painted_set = (void *)NULL;
   _plotter->i_canvas = (void *)NULL;
+  _plotter->i_coverage_set = (void *)NULL;
   _plotter->i_num_color_indices = 0;
+  _plotter->i_num_color_hash_entries = 0;
   _plotter->i_bit_depth = 0;
   _plotter->i_frame_nonempty = false;
-  _plotter->i_pixels_scanned = 0;
-  _plotter->i_pass = 0;
-  _plotter->i_hot.x = 0;
-  _plotter->i_hot.y = 0;  
   _plotter->i_header_written = false;
+  _plotter->i_differencing = false;
+  if (_plotter->i_prev_frame)
+    {
+      free (_plotter->i_prev_frame);
+      _plotter->i_prev_frame = (unsigned char *)NULL;
+    }
 
   /* Create new image, consisting of bitmap and colormap; initialized to
      background color.  First entries in color table will be (1)
@@ -63,6 +67,7 @@ _pl_i_new_image (S___(Plotter *_plotter))
 {
   int i;
   miPixel pixel;
+  miPoint origin;
   
   /* colormap starts empty (unused entries initted to `black'; we may later
      need to output some of the unused entries because GIF colormap lengths
@@ -75,6 +80,11 @@ _pl_i_new_image (S___(Plotter *_plotter))
       _plotter->i_colormap[i].blue = 0;
     }      
 
+  /* hash table mapping 24-bit RGBs to color indices starts empty too */
+  _plotter->i_num_color_hash_entries = 0;
+  for (i = 0; i < GIF_COLOR_HASH_SIZE; i++)
+    _plotter->i_color_hash_key[i] = -1;
+
   /* flag any color indices stored in current drawing state as bogus */
   _plotter->drawstate->i_pen_color_status = false;
   _plotter->drawstate->i_fill_color_status = false;
@@ -84,7 +94,8 @@ _pl_i_new_image (S___(Plotter *_plotter))
      transparent color be the same for all images in the file.  So if we're
      animating, i.e. writing a multi-image file, we allocate the
      transparent color as the first color index (#0) in all images. */
-  if (_plotter->i_transparent && _plotter->i_animation)
+  if (_plotter->i_transparent && _plotter->i_animation
+      && _plotter->i_quantize == false)
     /* allocate color cell in colormap; see i_color.c */
     _pl_i_new_color_index (R___(_plotter) 
 			_plotter->i_transparent_color.red,
@@ -94,10 +105,22 @@ _pl_i_new_image (S___(Plotter *_plotter))
   /* allocate bg color as next color index in colormap (it could well be
      the same as the transparent index); also construct a miPixel for it */
   _pl_i_set_bg_color (S___(_plotter));
-  pixel.type = MI_PIXEL_INDEX_TYPE;
-  pixel.u.index = _plotter->drawstate->i_bg_color_index;
+  _pl_i_color_pixel (R___(_plotter) (void *)&pixel,
+		     _plotter->drawstate->i_bg_color,
+		     _plotter->drawstate->i_bg_color_index);
+
+  /* create libxmi miCanvas and miPaintedSet structs (the canvas has a
+     packed drawable, which can be painted quickly; since our pixels are
+     opaque, the painted set is an immediate-mode one, which paints spans
+     straight onto the canvas rather than storing and sorting them).  If
+     the colormap is to be built when the frame is written, the canvas
+     holds 24-bit RGBs until then, rather than color indices. */
+  _plotter->i_canvas = (void *)miNewPackedCanvas ((unsigned int)_plotter->i_xn, (unsigned int)_plotter->i_yn, (_plotter->i_quantize ? MI_PACKED_RGBA32 : MI_PACKED_INDEX8), pixel);
+  origin.x = 0;
+  origin.y = 0;
+  _plotter->i_painted_set = (void *)miNewImmediatePaintedSet ((miCanvas *)_plotter->i_canvas, origin);
 
-  /* create libxmi miPaintedSet and miCanvas structs */
-  _plotter->i_painted_set = (void *)miNewPaintedSet ();
-  _plotter->i_canvas = (void *)miNewCanvas ((unsigned int)_plotter->i_xn, (unsigned int)_plotter->i_yn, pixel);
+  /* if drawing with anti-aliasing, create a libxmi miCoverageSet too */
+  if (_plotter->i_antialias)
+    _plotter->i_coverage_set = (void *)miNewCoverageSet ((unsigned int)_plotter->i_xn, (unsigned int)_plotter->i_yn);
 }
@@ -42,6 +42,13 @@ _pl_i_paint_path (S___(Plotter *_plotter))
     /* nothing to draw */
     return;
 
+  if (_plotter->i_antialias)
+    /* draw with anti-aliasing instead */
+    {
+      _pl_i_draw_antialiased_path (S___(_plotter));
+      return;
+    }
+
   switch ((int)_plotter->drawstate->path->type)
     {
     case (int)PATH_SEGMENT_LIST:
@@ -62,12 +69,12 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_i_draw_elliptic_arc (R___(_plotter) p0, p1, pc);
@@ -76,12 +83,12 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use libxmi rendering */
 	    _pl_i_draw_elliptic_arc_2 (R___(_plotter) p0, p1, pc);
@@ -105,8 +112,8 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	    double xu, yu;
 	    int device_x, device_y;
 	    
-	    xu = _plotter->drawstate->path->segments[i].p.x;
-	    yu = _plotter->drawstate->path->segments[i].p.y;
+	    xu = _plotter->drawstate->path->points[i].x;
+	    yu = _plotter->drawstate->path->points[i].y;
 	    if (i > 0 && (xu != xu_last || yu != yu_last))
 	      /* in user space, not all points are the same */
 	      identical_user_coordinates = false;	
@@ -126,8 +133,9 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  }
 	
 	/* determine background pixel color */
-	bgPixel.type = MI_PIXEL_INDEX_TYPE;
-	bgPixel.u.index = _plotter->drawstate->i_bg_color_index;
+	_pl_i_color_pixel (R___(_plotter) (void *)&bgPixel,
+			   _plotter->drawstate->i_bg_color,
+			   _plotter->drawstate->i_bg_color_index);
 	pixels[0] = bgPixel;
 	pixels[1] = bgPixel;
 	
@@ -146,8 +154,9 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	    
 	    /* set fg color in GC (and bg color too) */
 	    _pl_i_set_fill_color (S___(_plotter));
-	    fgPixel.type = MI_PIXEL_INDEX_TYPE;
-	    fgPixel.u.index = _plotter->drawstate->i_fill_color_index;
+	    _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			       _plotter->drawstate->i_fill_color,
+			       _plotter->drawstate->i_fill_color_index);
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
@@ -172,8 +181,9 @@ _pl_i_paint_path (S___(Plotter *_plotter))
 	  {
 	    /* set fg color in GC (and bg color too) */
 	    _pl_i_set_pen_color (S___(_plotter));
-	    fgPixel.type = MI_PIXEL_INDEX_TYPE;
-	    fgPixel.u.index = _plotter->drawstate->i_pen_color_index;
+	    _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			       _plotter->drawstate->i_pen_color,
+			       _plotter->drawstate->i_pen_color_index);
 	    pixels[0] = bgPixel;
 	    pixels[1] = fgPixel;
 	    miSetGCPixels (pGC, 2, pixels);
@@ -308,6 +318,114 @@ _pl_i_paint_path (S___(Plotter *_plotter))
     }
 }
 
+/* Draw the path in the Plotter's drawing state with anti-aliasing.  Filling
+   and edging each add spans to the Plotter's libxmi miCoverageSet.  Each
+   partially covered pixel is then blended by interpolating between the
+   24-bit RGB values in the colormap, and allocating a color index for the
+   result (or, if the colormap is to be built when the frame is written,
+   between the 24-bit RGB values on the canvas). */
+
+/* interpolate between color components d and s, rounding to nearest */
+#define BLEND_COMPONENT(s, d, alpha) \
+  ((d) + (((s) - (d)) * (alpha) + ((s) >= (d) ? 1 : -1) * (MI_MAX_COVERAGE / 2)) / MI_MAX_COVERAGE)
+
+void
+_pl_i_draw_antialiased_path (S___(Plotter *_plotter))
+{
+  miGC *pGC;
+  miPixel fgPixel, bgPixel;
+  miPixel pixels[2];
+  const miCoverageSpan *spans;
+  const miPackedPixmap *packed;
+  int i, nspans;
+
+  /* determine background pixel color */
+  _pl_i_color_pixel (R___(_plotter) (void *)&bgPixel,
+		     _plotter->drawstate->i_bg_color,
+		     _plotter->drawstate->i_bg_color_index);
+  pixels[0] = bgPixel;
+  pixels[1] = bgPixel;
+
+  /* construct an miGC (graphics context for the libxmi module); copy
+     attributes from the Plotter's GC to it */
+  pGC = miNewGC (2, pixels);
+  _set_common_mi_attributes (_plotter->drawstate, (void *)pGC);
+
+  if (_plotter->drawstate->fill_type)
+    /* not transparent, will fill */
+    {
+      /* set fg color in GC */
+      _pl_i_set_fill_color (S___(_plotter));
+      _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			 _plotter->drawstate->i_fill_color,
+			 _plotter->drawstate->i_fill_color_index);
+      pixels[1] = fgPixel;
+      miSetGCPixels (pGC, 2, pixels);
+      _draw_mi_aa_path (_plotter->drawstate, _plotter->i_coverage_set,
+			(const void *)pGC, true);
+    }
+
+  if (_plotter->drawstate->pen_type)
+    /* pen is present, so edge the path */
+    {
+      /* set fg color in GC */
+      _pl_i_set_pen_color (S___(_plotter));
+      _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			 _plotter->drawstate->i_pen_color,
+			 _plotter->drawstate->i_pen_color_index);
+      pixels[1] = fgPixel;
+      miSetGCPixels (pGC, 2, pixels);
+      _draw_mi_aa_path (_plotter->drawstate, _plotter->i_coverage_set,
+			(const void *)pGC, false);
+    }
+
+  /* deallocate miGC */
+  miDeleteGC (pGC);
+
+  /* blend spans onto the canvas, and clear.  If the canvas holds 24-bit
+     RGBs, libxmi can do this itself; if it holds color indices, the
+     packed pixmap of indices is blended here. */
+  if (_plotter->i_quantize)
+    miBlendCoverageSetToCanvas ((const miCoverageSet *)_plotter->i_coverage_set,
+				(miCanvas *)_plotter->i_canvas);
+  else
+    {
+      packed = ((miCanvas *)_plotter->i_canvas)->packed;
+      nspans = miGetCoverageSpans ((miCoverageSet *)_plotter->i_coverage_set,
+				   &spans);
+      for (i = 0; i < nspans; i++)
+	{
+	  unsigned char *row = MI_PACKED_INDEX8_ROW(packed, spans[i].start.y);
+	  unsigned char source = spans[i].pixel.u.index;
+	  unsigned int k;
+
+	  for (k = 0; k < spans[i].width; k++)
+	    {
+	      int alpha = spans[i].coverage[k];
+	      unsigned char dest = row[spans[i].start.x + k];
+
+	      if (alpha == MI_MAX_COVERAGE)
+		row[spans[i].start.x + k] = source;
+	      else if (dest != source)
+		{
+		  const plColor *s = &_plotter->i_colormap[source];
+		  const plColor *d = &_plotter->i_colormap[dest];
+
+		  row[spans[i].start.x + k] = 
+		    _pl_i_new_color_index (R___(_plotter)
+					   BLEND_COMPONENT(s->red, d->red, alpha),
+					   BLEND_COMPONENT(s->green, d->green, alpha),
+					   BLEND_COMPONENT(s->blue, d->blue, alpha));
+		}
+	    }
+	}
+    }
+  miClearCoverageSet ((miCoverageSet *)_plotter->i_coverage_set);
+
+  /* something was drawn in frame */
+  _plotter->i_frame_nonempty = true;
+}
+
 /* Use libxmi rendering to draw what would be a circular arc in the user
    frame.  If this is called, the map from user to device coordinates is
    assumed to preserve coordinate axes (it may be anisotropic [x and y
@@ -481,8 +599,9 @@ _pl_i_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
   miPoint offset;
 
   /* determine background pixel color */
-  bgPixel.type = MI_PIXEL_INDEX_TYPE;
-  bgPixel.u.index = _plotter->drawstate->i_bg_color_index;
+  _pl_i_color_pixel (R___(_plotter) (void *)&bgPixel,
+		     _plotter->drawstate->i_bg_color,
+		     _plotter->drawstate->i_bg_color_index);
   pixels[0] = bgPixel;
   pixels[1] = bgPixel;
       
@@ -504,8 +623,9 @@ _pl_i_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
     {
       /* set fg color in GC (and bg color too) */
       _pl_i_set_fill_color (S___(_plotter));
-      fgPixel.type = MI_PIXEL_INDEX_TYPE;
-      fgPixel.u.index = _plotter->drawstate->i_fill_color_index;
+      _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			 _plotter->drawstate->i_fill_color,
+			 _plotter->drawstate->i_fill_color_index);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
@@ -534,8 +654,9 @@ _pl_i_draw_elliptic_arc_internal (R___(Plotter *_plotter) int xorigin, int yorig
 
       /* set fg color in GC (and bg color too) */ 
       _pl_i_set_pen_color (S___(_plotter));
-      fgPixel.type = MI_PIXEL_INDEX_TYPE;
-      fgPixel.u.index = _plotter->drawstate->i_pen_color_index;  
+      _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			 _plotter->drawstate->i_pen_color,
+			 _plotter->drawstate->i_pen_color_index);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       miSetGCPixels (pGC, 2, pixels);
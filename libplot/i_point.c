@@ -47,10 +47,12 @@ _pl_i_paint_point (S___(Plotter *_plotter))
       
       /* compute background and foreground color for miGC */
       _pl_i_set_pen_color (S___(_plotter));
-      bgPixel.type = MI_PIXEL_INDEX_TYPE;
-      bgPixel.u.index = _plotter->drawstate->i_bg_color_index;
-      fgPixel.type = MI_PIXEL_INDEX_TYPE;
-      fgPixel.u.index = _plotter->drawstate->i_pen_color_index;
+      _pl_i_color_pixel (R___(_plotter) (void *)&bgPixel,
+			 _plotter->drawstate->i_bg_color,
+			 _plotter->drawstate->i_bg_color_index);
+      _pl_i_color_pixel (R___(_plotter) (void *)&fgPixel,
+			 _plotter->drawstate->i_pen_color,
+			 _plotter->drawstate->i_pen_color_index);
       pixels[0] = bgPixel;
       pixels[1] = fgPixel;
       
@@ -393,21 +393,33 @@ _rle_init (FILE *fp, int bit_depth)
   return rle;
 }
 
-/* send one pixel to the RLE */
+/* send a row of pixels to the RLE; each run of identical pixels in the
+   row is found first, and then handled as a whole */
 void
-_rle_do_pixel (rle_out *rle, int c)
+_rle_do_row (rle_out *rle, const unsigned char *pixels, int n)
 {
-  /* if a run needs to be terminated by being written out, do so */
-  if ((rle->rl_count > 0) && (c != rle->rl_pixel))
-    _rl_flush (rle);
-  /* if current run can be continued, do so (internally) */
-  if (rle->rl_pixel == c)
-    rle->rl_count++;
-  /* otherwise start a new one */
-  else
-    { 
-      rle->rl_pixel = c;
-      rle->rl_count = 1;
+  int i, j;
+
+  for (i = 0; i < n; i = j)
+    {
+      int c = pixels[i];
+
+      /* pixels i..j-1 form a run */
+      for (j = i + 1; j < n && pixels[j] == c; j++)
+	;
+
+      /* if a run needs to be terminated by being written out, do so */
+      if ((rle->rl_count > 0) && (c != rle->rl_pixel))
+	_rl_flush (rle);
+      /* if current run can be continued, do so (internally) */
+      if (rle->rl_pixel == c)
+	rle->rl_count += j - i;
+      /* otherwise start a new one */
+      else
+	{ 
+	  rle->rl_pixel = c;
+	  rle->rl_count = j - i;
+	}
     }
 }
 
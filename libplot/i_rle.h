@@ -65,7 +65,7 @@ extern rle_out *_rle_init (FILE *fp, ostream *out, int bit_depth);
 #else
 extern rle_out *_rle_init (FILE *fp, int bit_depth);
 #endif
-/* write a single integer (pixel) to the structure */
-extern void _rle_do_pixel (rle_out *rle, int c);
+/* write a row of pixels (color indices) to the structure */
+extern void _rle_do_row (rle_out *rle, const unsigned char *pixels, int n);
 /* wind things up and deallocate the RLE output structure */
 extern void _rle_terminate (rle_out *rle);
@@ -102,6 +102,8 @@ _pl_m_initialize (S___(Plotter *_plotter))
 
   /* path-related parameters (also internal) */
   _plotter->data->max_unfilled_path_length = PL_MAX_UNFILLED_PATH_LENGTH;
+  _plotter->data->cull_paths = false; /* metafiles are device-independent */
+  _plotter->data->decimation = 0.0;
   _plotter->data->have_mixed_paths = true;
   _plotter->data->allowed_arc_scaling = AS_ANY;
   _plotter->data->allowed_ellarc_scaling = AS_ANY;
@@ -177,7 +179,7 @@ _pl_m_initialize (S___(Plotter *_plotter))
     const char *portable_s;
     
     portable_s = (const char *)_get_plot_param (_plotter->data, 
-						"META_PORTABLE");
+						PL_PARAM_META_PORTABLE);
     if (strcasecmp (portable_s, "yes") == 0)
       _plotter->meta_portable_output = true;
     else
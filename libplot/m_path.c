@@ -157,6 +157,7 @@ _pl_m_paint_path_internal (R___(Plotter *_plotter) const plPath *path)
     case (int)PATH_SEGMENT_LIST:
       {
 	plPathSegment segment;
+	plPathIterator iter;
 	int i;
 
 	/* last-minute sanity check */
@@ -165,7 +166,8 @@ _pl_m_paint_path_internal (R___(Plotter *_plotter) const plPath *path)
 	if (path->num_segments == 1) /* shouldn't happen */
 	  break;
 
-	segment = path->segments[0]; /* initial moveto */
+	_path_iter_start (&iter, path, 0);
+	_path_iter_next (&iter, &segment); /* initial moveto */
 	if (_plotter->meta_pos.x != segment.p.x
 	    || _plotter->meta_pos.y != segment.p.y)
 	  {
@@ -181,7 +183,7 @@ _pl_m_paint_path_internal (R___(Plotter *_plotter) const plPath *path)
 	    plPathSegment prev_segment;
 
 	    prev_segment = segment;
-	    segment = path->segments[i];
+	    _path_iter_next (&iter, &segment);
 	    switch ((int)segment.type)
 	      {
 	      case (int)S_LINE:
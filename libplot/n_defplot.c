@@ -86,7 +86,7 @@ _pl_n_initialize (S___(Plotter *_plotter))
   {
     const char *portable_s;
     
-    portable_s = (const char *)_get_plot_param (_plotter->data, "PNM_PORTABLE");
+    portable_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PNM_PORTABLE);
     if (strcasecmp (portable_s, "yes") == 0)
       _plotter->n_portable_output = true;
     else
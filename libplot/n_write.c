@@ -30,8 +30,13 @@
 #define MAX_PGM_PIXELS_PER_LINE 16
 #define MAX_PPM_PIXELS_PER_LINE 5
 
+/* extract a color component (0/1/2 = red/green/blue) of the pixel at
+   (i,j) in the packed RGBA32 pixmap of our miCanvas */
+#define PIXEL_RGB(packed, i, j, k) \
+  MI_RGBA32_COMPONENT(MI_PACKED_RGBA32_ROW((packed), (j))[(i)], (k))
+
 /* forward references */
-static int best_image_type (miPixel **pixmap, int width, int height);
+static int best_image_type (const miPackedPixmap *packed, int width, int height);
 
 /* do a rapid decimal printf of a nonnegative integer, in range 0..999
    to a character buffer */
@@ -76,12 +81,12 @@ _pl_n_write_pnm (S___(Plotter *_plotter))
 {
   int type;			/* 0,1,2 = PBM/PGM/PPM */
   int width, height;
-  miPixel **pixmap;
+  const miPackedPixmap *packed;
 
   width = _plotter->b_xn;
   height = _plotter->b_yn;
-  pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
-  type = best_image_type (pixmap, width, height);
+  packed = ((miCanvas *)(_plotter->b_canvas))->packed;
+  type = best_image_type (packed, width, height);
 
   switch (type)
     {
@@ -104,7 +109,7 @@ _pl_n_write_pbm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  const miPackedPixmap *packed = ((miCanvas *)(_plotter->b_canvas))->packed;
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -134,7 +139,7 @@ P1\n\
 	  for (j = 0; j < height; j++)
 	    for (i = 0; i < width; i++)
 	      {
-		if (pixmap[j][i].u.rgb[0] == 0)
+		if (PIXEL_RGB(packed, i, j, 0) == 0)
 		  linebuf[pos++] = '1';	/* 1 = black */
 		else
 		  linebuf[pos++] = '0';
@@ -166,7 +171,7 @@ P4\n\
 	      outbyte = 0;
 	      for (i = 0; i < width; i++)
 		{
-		  set = (pixmap[j][i].u.rgb[0] == 0 ? 1 : 0); /* 1 = black */
+		  set = (PIXEL_RGB(packed, i, j, 0) == 0 ? 1 : 0); /* 1 = black */
 		  outbyte = (outbyte << 1) | set;
 		  bitcount++;
 		  if (bitcount == 8)	/* write byte to row (8 bits) */
@@ -205,7 +210,7 @@ P1\n\
 	  for (j = 0; j < height; j++)
 	    for (i = 0; i < width; i++)
 	      {
-		if (pixmap[j][i].u.rgb[0] == 0)
+		if (PIXEL_RGB(packed, i, j, 0) == 0)
 		  linebuf[pos++] = '1';	/* 1 = black */
 		else
 		  linebuf[pos++] = '0';
@@ -240,7 +245,7 @@ P4\n\
 	      outbyte = 0;
 	      for (i = 0; i < width; i++)
 		{
-		  set = (pixmap[j][i].u.rgb[0] == 0 ? 1 : 0); /* 1 = black */
+		  set = (PIXEL_RGB(packed, i, j, 0) == 0 ? 1 : 0); /* 1 = black */
 		  outbyte = (outbyte << 1) | set;
 		  bitcount++;
 		  if (bitcount == 8)	/* write byte to row (8 bits) */
@@ -271,7 +276,7 @@ _pl_n_write_pgm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  const miPackedPixmap *packed = ((miCanvas *)(_plotter->b_canvas))->packed;
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -306,7 +311,7 @@ P2\n\
 	    for (i = 0; i < width; i++)
 	      {
 		/* emit <=3 decimal digits per grayscale pixel */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 0), linebuf, pos)
 		num_pixels++;
 		if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
 		  {
@@ -333,7 +338,7 @@ P5\n\
 	  for (j = 0; j < height; j++)
 	    {
 	      for (i = 0; i < width; i++)
-		rowbuf[i] = pixmap[j][i].u.rgb[0];
+		rowbuf[i] = PIXEL_RGB(packed, i, j, 0);
 	      fwrite ((void *)rowbuf, sizeof(unsigned char), width, fp);
 	    }
 	  free (rowbuf);
@@ -360,7 +365,7 @@ P2\n\
 	    for (i = 0; i < width; i++)
 	      {
 		/* emit <=3 decimal digits per grayscale pixel */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 0), linebuf, pos)
 		num_pixels++;
 		if (num_pixels >= MAX_PGM_PIXELS_PER_LINE || i == (width - 1))
 		  {
@@ -389,7 +394,7 @@ P5\n\
 	  for (j = 0; j < height; j++)
 	    {
 	      for (i = 0; i < width; i++)
-		rowbuf[i] = pixmap[j][i].u.rgb[0];
+		rowbuf[i] = PIXEL_RGB(packed, i, j, 0);
 	      stream->write ((const char *)rowbuf, width);
 	    }
 	  free (rowbuf);
@@ -404,7 +409,7 @@ _pl_n_write_ppm (S___(Plotter *_plotter))
 {
   int i, j;
   bool portable = _plotter->n_portable_output;
-  miPixel **pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
+  const miPackedPixmap *packed = ((miCanvas *)(_plotter->b_canvas))->packed;
   int width = _plotter->b_xn;
   int height = _plotter->b_yn;  
   FILE *fp = _plotter->data->outfp;
@@ -439,11 +444,11 @@ P3\n\
 	    for (i = 0; i < width; i++)
 	      {
 		/* emit <=3 decimal digits per RGB component */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 0), linebuf, pos)
 		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[1], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 1), linebuf, pos)
 		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[2], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 2), linebuf, pos)
 		num_pixels++;
 		if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
 		  {
@@ -472,7 +477,7 @@ P6\n\
 	    {
 	      for (i = 0; i < width; i++)
 		for (component = 0; component < 3; component++)
-		  rowbuf[3 * i + component] = pixmap[j][i].u.rgb[component];
+		  rowbuf[3 * i + component] = PIXEL_RGB(packed, i, j, component);
 	      fwrite ((void *)rowbuf, sizeof(unsigned char), 3 * width, fp);
 	    }
 	  free (rowbuf);
@@ -499,11 +504,11 @@ P3\n\
 	    for (i = 0; i < width; i++)
 	      {
 		/* emit <=3 decimal digits per RGB component */
-		FAST_PRINT (pixmap[j][i].u.rgb[0], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 0), linebuf, pos)
 		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[1], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 1), linebuf, pos)
 		linebuf[pos++] = ' ';
-		FAST_PRINT (pixmap[j][i].u.rgb[2], linebuf, pos)
+		FAST_PRINT (PIXEL_RGB(packed, i, j, 2), linebuf, pos)
 		num_pixels++;
 		if (num_pixels >= MAX_PPM_PIXELS_PER_LINE || i == (width - 1))
 		  {
@@ -534,7 +539,7 @@ P6\n\
 	    {
 	      for (i = 0; i < width; i++)
 		for (component = 0; component < 3; component++)
-		  rowbuf[3 * i + component] = pixmap[j][i].u.rgb[component];
+		  rowbuf[3 * i + component] = PIXEL_RGB(packed, i, j, component);
 	      stream->write ((const char *)rowbuf, 3 * width);
 	    }
 	  free (rowbuf);
@@ -545,7 +550,7 @@ P6\n\
 
 /* return best type for writing an image (0=mono, 1=grey, 2=color) */
 static int
-best_image_type (miPixel **pixmap, int width, int height)
+best_image_type (const miPackedPixmap *packed, int width, int height)
 {
   int i, j;
   int type = 0;			/* default is mono */
@@ -555,9 +560,9 @@ best_image_type (miPixel **pixmap, int width, int height)
       {
 	unsigned char red, green, blue;
 	
-	red = pixmap[j][i].u.rgb[0];
-	green = pixmap[j][i].u.rgb[1];
-	blue = pixmap[j][i].u.rgb[2];
+	red = PIXEL_RGB(packed, i, j, 0);
+	green = PIXEL_RGB(packed, i, j, 1);
+	blue = PIXEL_RGB(packed, i, j, 2);
 	if (type == 0)		/* up to now, all pixels are black or white */
 	  {
 	    if (! ((red == (unsigned char)0 && green == (unsigned char)0
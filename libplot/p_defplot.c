@@ -248,12 +248,11 @@ _pl_p_terminate (S___(Plotter *_plotter))
 
       if (num_pages == 1)
 	/* will plot an EPS file, not just a PS file */
-	sprintf (doc_header->point, "\
+	_outbuf_printf (doc_header, "\
 %%!PS-Adobe-3.0 EPSF-3.0\n");
       else
-	sprintf (doc_header->point, "\
+	_outbuf_printf (doc_header, "\
 %%!PS-Adobe-3.0\n");
-      _update_buffer (doc_header);
 
       /* Compute an ASCII representation of the current time, in a
 	 reentrant way if we're supporting pthreads (i.e. by using ctime_r
@@ -274,7 +273,7 @@ _pl_p_terminate (S___(Plotter *_plotter))
       time_string = ctime (&clock);
 #endif
 
-      sprintf (doc_header->point, "\
+      _outbuf_printf (doc_header, "\
 %%%%Creator: GNU libplot drawing library %s\n\
 %%%%Title: PostScript plot\n\
 %%%%CreationDate: %s\
@@ -283,21 +282,19 @@ _pl_p_terminate (S___(Plotter *_plotter))
 %%%%Pages: %d\n\
 %%%%PageOrder: Ascend\n\
 %%%%Orientation: Portrait\n",
-	       PL_LIBPLOT_VER_STRING, time_string, num_pages);
-      _update_buffer (doc_header);
+		      PL_LIBPLOT_VER_STRING, time_string, num_pages);
       
       /* emit the bounding box for the document */
       _bbox_of_outbufs (_plotter->data->first_page, &x_min, &x_max, &y_min, &y_max);
       if (x_min > x_max || y_min > y_max) 
 	/* all pages empty */
-	sprintf (doc_header->point, "\
+	_outbuf_printf (doc_header, "\
 %%%%BoundingBox: 0 0 0 0\n");
       else
-	sprintf (doc_header->point, "\
+	_outbuf_printf (doc_header, "\
 %%%%BoundingBox: %d %d %d %d\n",
-		 IROUND(x_min - 0.5), IROUND(y_min - 0.5),
-		 IROUND(x_max + 0.5), IROUND(y_max + 0.5));
-      _update_buffer (doc_header);
+			IROUND(x_min - 0.5), IROUND(y_min - 0.5),
+			IROUND(x_max + 0.5), IROUND(y_max + 0.5));
       
       /* determine fonts needed by document, by examining all pages */
       {
@@ -327,9 +324,8 @@ _pl_p_terminate (S___(Plotter *_plotter))
       {
 	bool first_font = true;
 
-	strcpy (doc_header->point, "\
+	_outbuf_puts (doc_header, "\
 %%DocumentNeededResources: ");
-	_update_buffer (doc_header);
 
 	for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	  {
@@ -337,15 +333,11 @@ _pl_p_terminate (S___(Plotter *_plotter))
 	      {
 		if (first_font == false)
 		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
+		    _outbuf_puts (doc_header, "%%+ ");
 		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, _pl_g_ps_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
+		_outbuf_puts (doc_header, "font ");
+		_outbuf_puts (doc_header, _pl_g_ps_font_info[i].ps_name);
+		_outbuf_puts (doc_header, "\n");
 		first_font = false;
 	      }
 	  }
@@ -356,69 +348,56 @@ _pl_p_terminate (S___(Plotter *_plotter))
 	      {
 		if (first_font == false)
 		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
+		    _outbuf_puts (doc_header, "%%+ ");
 		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
+		_outbuf_puts (doc_header, "font ");
 		/* use replacement font name if any (this is only to
                    support the Tidbits-is-Wingdings botch) */
 		if (_pl_g_pcl_font_info[i].substitute_ps_name)
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
+		  _outbuf_puts (doc_header, _pl_g_pcl_font_info[i].substitute_ps_name);
 		else
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
+		  _outbuf_puts (doc_header, _pl_g_pcl_font_info[i].ps_name);
+		_outbuf_puts (doc_header, "\n");
 		first_font = false;
 	      }
 	  }
 #endif
 	if (first_font)		/* no fonts needed in document */
 	  {
-	    strcpy (doc_header->point, "\n");
-	    _update_buffer (doc_header);	    
+	    _outbuf_puts (doc_header, "\n");
 	  }
       }
 
       /* emit final DSC lines in header */
       if (num_pages > 0)
 	{
-	  sprintf (doc_header->point, "\
+	  _outbuf_printf (doc_header, "\
 %%%%DocumentSuppliedResources: procset %s %s 0\n",
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
+			  PS_PROCSET_NAME, PS_PROCSET_VERSION);
 	}
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 %%EndComments\n\n");
-      _update_buffer (doc_header);
 
       /* write out list of fonts needed by the document, all over again;
 	 this time it's interpreted as the default font list for each page */
       {
 	bool first_font = true;
 
-	strcpy (doc_header->point, "\
+	_outbuf_puts (doc_header, "\
 %%BeginDefaults\n");
-	_update_buffer (doc_header);
-	strcpy (doc_header->point, "\
+	_outbuf_puts (doc_header, "\
 %%PageResources: ");
-	_update_buffer (doc_header);
 	for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	  {
 	    if (ps_font_used_in_doc[i])
 	      {
 		if (first_font == false)
 		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
+		    _outbuf_puts (doc_header, "%%+ ");
 		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, _pl_g_ps_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
+		_outbuf_puts (doc_header, "font ");
+		_outbuf_puts (doc_header, _pl_g_ps_font_info[i].ps_name);
+		_outbuf_puts (doc_header, "\n");
 		first_font = false;
 	      }
 	  }
@@ -429,71 +408,58 @@ _pl_p_terminate (S___(Plotter *_plotter))
 	      {
 		if (first_font == false)
 		  {
-		    strcpy (doc_header->point, "%%+ ");
-		    _update_buffer (doc_header);
+		    _outbuf_puts (doc_header, "%%+ ");
 		  }
-		strcpy (doc_header->point, "font ");
-		_update_buffer (doc_header);
+		_outbuf_puts (doc_header, "font ");
 		if (_pl_g_pcl_font_info[i].substitute_ps_name)
 		  /* this is to support the Tidbits-is-Wingdings botch */
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
+		  _outbuf_puts (doc_header, _pl_g_pcl_font_info[i].substitute_ps_name);
 		else
-		  strcpy (doc_header->point, _pl_g_pcl_font_info[i].ps_name);
-		_update_buffer (doc_header);
-		strcpy (doc_header->point, "\n");
-		_update_buffer (doc_header);
+		  _outbuf_puts (doc_header, _pl_g_pcl_font_info[i].ps_name);
+		_outbuf_puts (doc_header, "\n");
 		first_font = false;
 	      }
 	  }
 #endif
 	if (first_font)		/* no fonts needed in document */
 	  {
-	    strcpy (doc_header->point, "\n");
-	    _update_buffer (doc_header);
+	    _outbuf_puts (doc_header, "\n");
 	  }
 
-	strcpy (doc_header->point, "\
+	_outbuf_puts (doc_header, "\
 %%EndDefaults\n\n");
-	_update_buffer (doc_header);
       }
 
       /* Document Prolog */
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 %%BeginProlog\n");
-      _update_buffer (doc_header);
       if (num_pages > 1)
 	/* PS [not EPS] file, include procset in document prolog */
 	{
-	  sprintf (doc_header->point, "\
+	  _outbuf_printf (doc_header, "\
 %%%%BeginResource: procset %s %s 0\n", 
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
+			  PS_PROCSET_NAME, PS_PROCSET_VERSION);
 	  /* write out idraw-derived PS prologue (makes many definitions) */
 	  for (i=0; *_ps_procset[i]; i++)
 	    {
-	      strcpy (doc_header->point, _ps_procset[i]);
-	      _update_buffer (doc_header);
+	      _outbuf_puts (doc_header, _ps_procset[i]);
 	    }
-	  strcpy (doc_header->point, "\
+	  _outbuf_puts (doc_header, "\
 %%EndResource\n");
-	  _update_buffer (doc_header);
 	}
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 %%EndProlog\n\n");
-      _update_buffer (doc_header);
 
       /* Document Setup */
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 %%BeginSetup\n");
-      _update_buffer (doc_header);
 
       /* tell driver to include any PS [or PCL] fonts that are needed */
       for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	  if (ps_font_used_in_doc[i])
 	    {
-	      sprintf (doc_header->point, "\
+	      _outbuf_printf (doc_header, "\
 %%%%IncludeResource: font %s\n", _pl_g_ps_font_info[i].ps_name);
-	      _update_buffer (doc_header);
 	    }
 #ifdef USE_LJ_FONTS_IN_PS
       for (i = 0; i < PL_NUM_PCL_FONTS; i++)
@@ -501,20 +467,18 @@ _pl_p_terminate (S___(Plotter *_plotter))
 	    {
 	      /* this is to support the Tidbits-is-Wingdings botch */
 	      if (_pl_g_pcl_font_info[i].substitute_ps_name)
-		sprintf (doc_header->point, "\
+		_outbuf_printf (doc_header, "\
 %%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].substitute_ps_name);
 	      else
-		sprintf (doc_header->point, "\
+		_outbuf_printf (doc_header, "\
 %%%%IncludeResource: font %s\n", _pl_g_pcl_font_info[i].ps_name);
-	      _update_buffer (doc_header);
 	    }
 #endif
 
       /* push private dictionary on stack */
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 /DrawDict 50 dict def\n\
 DrawDict begin\n");
-      _update_buffer (doc_header);
 
       /* do ISO-Latin-1 reencoding for any fonts that need it */
       {
@@ -536,17 +500,15 @@ DrawDict begin\n");
 #endif
 	if (need_to_reencode)
 	  {
-	    strcpy (doc_header->point, _ps_fontproc);
-	    _update_buffer (doc_header);
+	    _outbuf_puts (doc_header, _ps_fontproc);
 	    
 	    for (i = 0; i < PL_NUM_PS_FONTS; i++)
 	      {
 		if (ps_font_used_in_doc[i] && _pl_g_ps_font_info[i].iso8859_1)
 		  {
-		    sprintf (doc_header->point, "\
+		    _outbuf_printf (doc_header, "\
 /%s reencodeISO def\n",
-			     _pl_g_ps_font_info[i].ps_name);
-		    _update_buffer (doc_header);
+				    _pl_g_ps_font_info[i].ps_name);
 		  }
 	      }
 #ifdef USE_LJ_FONTS_IN_PS
@@ -554,10 +516,9 @@ DrawDict begin\n");
 	      {
 		if (pcl_font_used_in_doc[i] && _pl_g_pcl_font_info[i].iso8859_1)
 		  {
-		    sprintf (doc_header->point, "\
+		    _outbuf_printf (doc_header, "\
 /%s reencodeISO def\n",
-			     _pl_g_pcl_font_info[i].ps_name);
-		    _update_buffer (doc_header);
+				    _pl_g_pcl_font_info[i].ps_name);
 		  }
 	      }
 #endif
@@ -568,40 +529,35 @@ DrawDict begin\n");
 	/* EPS [not just PS] file, include procset in setup section,
 	   so that it will modify only the private dictionary */
 	{
-	  sprintf (doc_header->point, "\
+	  _outbuf_printf (doc_header, "\
 %%%%BeginResource: procset %s %s 0\n", 
-		   PS_PROCSET_NAME, PS_PROCSET_VERSION);
-	  _update_buffer (doc_header);
+			  PS_PROCSET_NAME, PS_PROCSET_VERSION);
 
 	  /* write out idraw-derived PS prologue in p_header.h (makes many
              definitions) */
 	  for (i=0; *_ps_procset[i]; i++)
 	    {
-	      strcpy (doc_header->point, _ps_procset[i]);
-	      _update_buffer (doc_header);
+	      _outbuf_puts (doc_header, _ps_procset[i]);
 	    }
-	  strcpy (doc_header->point, "\
+	  _outbuf_puts (doc_header, "\
 %%EndResource\n");
-	  _update_buffer (doc_header);
 	}
 
-      strcpy (doc_header->point, "\
+      _outbuf_puts (doc_header, "\
 %%EndSetup\n\n");
-      _update_buffer (doc_header);
       
       /* Document header is now prepared, and stored in a plOutbuf.
 	 Now do the same for the doc trailer (much shorter). */
 
       /* Document Trailer: just pop private dictionary off stack */
       doc_trailer = _new_outbuf ();
-      strcpy (doc_trailer->point, "\
+      _outbuf_puts (doc_trailer, "\
 %%Trailer\n\
 end\n\
 %%EOF\n");
-      _update_buffer (doc_trailer);
 
       /* WRITE DOCUMENT HEADER (and free its plOutbuf) */
-      _write_string (_plotter->data, doc_header->base); 
+      _write_outbuf (_plotter->data, doc_header);
       _delete_outbuf (doc_header);
 
       /* now loop through pages, emitting each in turn */
@@ -616,32 +572,26 @@ end\n\
 	      /* prepare page header, and store it in a plOutbuf */
 	      page_header = _new_outbuf ();
 
-	      sprintf (page_header->point, "\
+	      _outbuf_printf (page_header, "\
 %%%%Page: %d %d\n", n, n);
-	      _update_buffer (page_header);
 
 	      /* write out list of fonts needed by the page */
 	      {
 		bool first_font = true;
 
-		strcpy (page_header->point, "\
+		_outbuf_puts (page_header, "\
 %%PageResources: ");
-		_update_buffer (page_header);
 		for (i = 0; i < PL_NUM_PS_FONTS; i++)
 		  {
 		    if (current_page->ps_font_used[i])
 		      {
 			if (first_font == false)
 			  {
-			    strcpy (page_header->point, "%%+ ");
-			    _update_buffer (page_header);
+			    _outbuf_puts (page_header, "%%+ ");
 			  }
-			strcpy (page_header->point, "font ");
-			_update_buffer (page_header);
-			strcpy (page_header->point, _pl_g_ps_font_info[i].ps_name);
-			_update_buffer (page_header);
-			strcpy (page_header->point, "\n");
-			_update_buffer (page_header);
+			_outbuf_puts (page_header, "font ");
+			_outbuf_puts (page_header, _pl_g_ps_font_info[i].ps_name);
+			_outbuf_puts (page_header, "\n");
 			first_font = false;
 		      }
 		  }
@@ -652,27 +602,22 @@ end\n\
 		      {
 			if (first_font == false)
 			  {
-			    strcpy (page_header->point, "%%+ ");
-			    _update_buffer (page_header);
+			    _outbuf_puts (page_header, "%%+ ");
 			  }
-			strcpy (page_header->point, "font ");
-			_update_buffer (page_header);
+			_outbuf_puts (page_header, "font ");
 			if (_pl_g_pcl_font_info[i].substitute_ps_name)
 			  /* this is to support the Tidbits-is-Wingdings botch */
-			  strcpy (page_header->point, _pl_g_pcl_font_info[i].substitute_ps_name);
+			  _outbuf_puts (page_header, _pl_g_pcl_font_info[i].substitute_ps_name);
 			else
-			  strcpy (page_header->point, _pl_g_pcl_font_info[i].ps_name);
-			_update_buffer (page_header);
-			strcpy (page_header->point, "\n");
-			_update_buffer (page_header);
+			  _outbuf_puts (page_header, _pl_g_pcl_font_info[i].ps_name);
+			_outbuf_puts (page_header, "\n");
 			first_font = false;
 		      }
 		  }
 #endif
 		if (first_font)	/* no fonts needed on page */
 		  {
-		    strcpy (page_header->point, "\n");
-		    _update_buffer (page_header);
+		    _outbuf_puts (page_header, "\n");
 		  }
 	      }
 
@@ -680,22 +625,20 @@ end\n\
 	      _bbox_of_outbuf (current_page, &x_min, &x_max, &y_min, &y_max);
 	      if (x_min > x_max || y_min > y_max)
 		/* empty page */
-		sprintf (page_header->point, "\
+		_outbuf_printf (page_header, "\
 %%%%PageBoundingBox: 0 0 0 0\n");
 	      else
-		sprintf (page_header->point, "\
+		_outbuf_printf (page_header, "\
 %%%%PageBoundingBox: %d %d %d %d\n",
-			 IROUND(x_min - 0.5), IROUND(y_min - 0.5),
-			 IROUND(x_max + 0.5), IROUND(y_max + 0.5));
-	      _update_buffer (page_header);
+				IROUND(x_min - 0.5), IROUND(y_min - 0.5),
+				IROUND(x_max + 0.5), IROUND(y_max + 0.5));
 	      /* Page Setup */
-	      strcpy (page_header->point, "\
+	      _outbuf_puts (page_header, "\
 %%BeginPageSetup\n");
-	      _update_buffer (page_header);
 	      /* emit initialization code (including idraw, PS directives) */
 	      /* N.B. `8' below is the version number of the idraw PS format
 		 we're producing; see <Unidraw/Components/psformat.h> */
-	      strcpy (page_header->point, "\
+	      _outbuf_puts (page_header, "\
 %I Idraw 8\n\n\
 Begin\n\
 %I b u\n\
@@ -707,28 +650,23 @@ Begin\n\
 [ 1 0 0 1 0 0 ] concat\n\
 /originalCTM matrix currentmatrix def\n\
 /trueoriginalCTM matrix currentmatrix def\n");
-	      _update_buffer (page_header);
-	      strcpy (page_header->point, "\
+	      _outbuf_puts (page_header, "\
 %%EndPageSetup\n\n");
-	      _update_buffer (page_header);	  
 
 	      /* Page header is now prepared, and stored in a plOutbuf.  
                  Do the same for the page trailer (much shorter). */
 
 	      page_trailer = _new_outbuf ();
 	      /* Page Trailer: includes `showpage' */
-	      strcpy (page_trailer->point, "\
+	      _outbuf_puts (page_trailer, "\
 %%PageTrailer\n\
 End %I eop\n\
 showpage\n\n");
-	      _update_buffer (page_trailer);
 	      /* Page trailer is now ready */
 
 	      /* WRITE PS CODE FOR THIS PAGE, including header, trailer */
-	      _write_string (_plotter->data, page_header->base); 
-	      if (current_page->len > 0)
-		_write_string (_plotter->data, current_page->base);
-	      _write_string (_plotter->data, page_trailer->base);
+	      _write_outbufs (_plotter->data, 
+			      page_header, current_page, page_trailer);
 
 	      /* free header, trailer plOutbufs */
 	      _delete_outbuf (page_trailer);
@@ -737,7 +675,7 @@ showpage\n\n");
 	}
       
       /* WRITE DOCUMENT TRAILER (and free its plOutbuf) */
-      _write_string (_plotter->data, doc_trailer->base); 
+      _write_outbuf (_plotter->data, doc_trailer);
       _delete_outbuf (doc_trailer);
     }
   
@@ -91,8 +91,8 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -107,7 +107,7 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	    plPoint datapoint;
 	    int x_int, y_int;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i].p;
+	    datapoint = _plotter->drawstate->path->points[i];
 	    x_int = IROUND(granularity * datapoint.x);
 	    y_int = IROUND(granularity * datapoint.y);
 	    
@@ -141,10 +141,9 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 
 	/* emit prolog and idraw instructions: start of MLine or Poly */
 	if (closed_int)
-	  strcpy (_plotter->data->page->point, "Begin %I Poly\n");
+	  _outbuf_puts (_plotter->data->page, "Begin %I Poly\n");
 	else
-	  strcpy (_plotter->data->page->point, "Begin %I MLine\n");
-	_update_buffer (_plotter->data->page);
+	  _outbuf_puts (_plotter->data->page, "Begin %I MLine\n");
 	
 	/* emit common attributes: CTM, fill rule, cap and join styles and
 	   miter limit, dash array, foreground and background colors, and
@@ -152,25 +151,21 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	_pl_p_emit_common_attributes (S___(_plotter));
 	
 	/* emit transformation matrix (all 6 elements) */
-	strcpy (_plotter->data->page->point, "%I t\n["); 
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "%I t\n[");
 	for (i = 0; i < 6; i++)
 	  {
 	    if ((i==0) || (i==1) || (i==2) || (i==3))
-	      sprintf (_plotter->data->page->point, "%.7g ", _plotter->drawstate->transform.m[i] / granularity);
+	      _outbuf_printf (_plotter->data->page, "%.7g ", _plotter->drawstate->transform.m[i] / granularity);
 	    else
-	      sprintf (_plotter->data->page->point, "%.7g ", _plotter->drawstate->transform.m[i]);
-	    _update_buffer (_plotter->data->page);
+	      _outbuf_printf (_plotter->data->page, "%.7g ", _plotter->drawstate->transform.m[i]);
 	  }
-	strcpy (_plotter->data->page->point, "\
+	_outbuf_puts (_plotter->data->page, "\
 ] concat\n");
-	_update_buffer (_plotter->data->page);
 	
 	/* emit idraw instruction: number of points in line */
-	sprintf (_plotter->data->page->point, "\
+	_outbuf_printf (_plotter->data->page, "\
 %%I %d\n", 
-		 numpoints);
-	_update_buffer (_plotter->data->page);
+			numpoints);
 	
 	/* if polyline is closed, loop through points _backward_, since the
 	   `Poly' function in the idraw prologue draws closed polylines in
@@ -190,21 +185,20 @@ _pl_p_paint_path (S___(Plotter *_plotter))
 	     i += index_increment)
 	  {
 	    /* output the data point */
-	    sprintf (_plotter->data->page->point, "\
-%d %d\n",
-		     xarray[i].x, xarray[i].y);
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_put_int (_plotter->data->page, xarray[i].x);
+	    _outbuf_putc (_plotter->data->page, ' ');
+	    _outbuf_put_int (_plotter->data->page, xarray[i].y);
+	    _outbuf_putc (_plotter->data->page, '\n');
 	  }
 	
 	if (closed_int)
-	  sprintf (_plotter->data->page->point, "\
+	  _outbuf_printf (_plotter->data->page, "\
 %d Poly\n\
 End\n\n", numpoints);
 	else
-	  sprintf (_plotter->data->page->point, "\
+	  _outbuf_printf (_plotter->data->page, "\
 %d MLine\n\
 End\n\n", numpoints);
-	_update_buffer (_plotter->data->page);
 
 	/* free temporary storage for quantized points */
 	free (xarray);
@@ -239,10 +233,10 @@ End\n\n", numpoints);
 		
 		j = (i == 0 ? 1 : numpoints - 2);
 		_set_line_end_bbox (_plotter->data->page,
-				    _plotter->drawstate->path->segments[i].p.x,
-				    _plotter->drawstate->path->segments[i].p.y,
-				    _plotter->drawstate->path->segments[j].p.x,
-				    _plotter->drawstate->path->segments[j].p.y,
+				    _plotter->drawstate->path->points[i].x,
+				    _plotter->drawstate->path->points[i].y,
+				    _plotter->drawstate->path->points[j].x,
+				    _plotter->drawstate->path->points[j].y,
 				    _plotter->drawstate->line_width,
 				    _plotter->drawstate->cap_type,
 				    _plotter->drawstate->transform.m);
@@ -265,12 +259,12 @@ End\n\n", numpoints);
 		    c = i + 1;
 		  }
 		_set_line_join_bbox(_plotter->data->page,
-				    _plotter->drawstate->path->segments[a].p.x,
-				    _plotter->drawstate->path->segments[a].p.y,
-				    _plotter->drawstate->path->segments[b].p.x,
-				    _plotter->drawstate->path->segments[b].p.y,
-				    _plotter->drawstate->path->segments[c].p.x,
-				    _plotter->drawstate->path->segments[c].p.y,
+				    _plotter->drawstate->path->points[a].x,
+				    _plotter->drawstate->path->points[a].y,
+				    _plotter->drawstate->path->points[b].x,
+				    _plotter->drawstate->path->points[b].y,
+				    _plotter->drawstate->path->points[c].x,
+				    _plotter->drawstate->path->points[c].y,
 				    _plotter->drawstate->line_width,
 				    _plotter->drawstate->join_type,
 				    _plotter->drawstate->miter_limit,
@@ -285,8 +279,7 @@ End\n\n", numpoints);
 	int i;
 
 	/* emit prolog and idraw instructions: start of Rect */
-	strcpy (_plotter->data->page->point, "Begin %I Rect\n");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "Begin %I Rect\n");
 	
 	/* emit common attributes: CTM, fill rule, cap and join styles and
 	   miter limit, dash array, foreground and background colors, and
@@ -294,31 +287,27 @@ End\n\n", numpoints);
 	_pl_p_emit_common_attributes (S___(_plotter));
 	
 	/* emit transformation matrix (all 6 elements) */
-	strcpy (_plotter->data->page->point, "%I t\n["); 
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "%I t\n[");
 	for (i = 0; i < 6; i++)
 	  {
 	    if ((i==0) || (i==1) || (i==2) || (i==3))
-	      sprintf (_plotter->data->page->point, "%.7g ", _plotter->drawstate->transform.m[i] / granularity);
+	      _outbuf_printf (_plotter->data->page, "%.7g ", _plotter->drawstate->transform.m[i] / granularity);
 	    else
-	      sprintf (_plotter->data->page->point, "%.7g ", _plotter->drawstate->transform.m[i]);
-	    _update_buffer (_plotter->data->page);
+	      _outbuf_printf (_plotter->data->page, "%.7g ", _plotter->drawstate->transform.m[i]);
 	  }
-	strcpy (_plotter->data->page->point, "\
+	_outbuf_puts (_plotter->data->page, "\
 ] concat\n");
-	_update_buffer (_plotter->data->page);
 	
 	/* output the two defining vertices (preceded by an empty idraw
            instruction), and wind things up */
-	sprintf (_plotter->data->page->point, "\
+	_outbuf_printf (_plotter->data->page, "\
 %%I\n\
 %d %d %d %d Rect\n\
 End\n\n",
-		 IROUND(granularity * _plotter->drawstate->path->p0.x),
-		 IROUND(granularity * _plotter->drawstate->path->p0.y),
-		 IROUND(granularity * _plotter->drawstate->path->p1.x),
-		 IROUND(granularity * _plotter->drawstate->path->p1.y));
-	_update_buffer (_plotter->data->page);
+			IROUND(granularity * _plotter->drawstate->path->p0.x),
+			IROUND(granularity * _plotter->drawstate->path->p0.y),
+			IROUND(granularity * _plotter->drawstate->path->p1.x),
+			IROUND(granularity * _plotter->drawstate->path->p1.y));
 		 
 	/* update bounding box */
 	_set_line_join_bbox(_plotter->data->page,
@@ -415,10 +404,9 @@ _pl_p_fellipse_internal (R___(Plotter *_plotter) double x, double y, double rx,
 
       /* emit prolog instruction and idraw directive: start of Elli or Circ */
       if (circlep)
-	strcpy (_plotter->data->page->point, "Begin %I Circ\n");
+	_outbuf_puts (_plotter->data->page, "Begin %I Circ\n");
       else
-	strcpy (_plotter->data->page->point, "Begin %I Elli\n");
-      _update_buffer(_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "Begin %I Elli\n");
       
       /* emit common attributes: CTM, fill rule, cap and join styles and
 	 miter limit, dash array, foreground and background colors, and
@@ -465,31 +453,27 @@ _pl_p_fellipse_internal (R___(Plotter *_plotter) double x, double y, double rx,
 		       ellipse_transformation_matrix);
   
       /* emit idraw directive: transformation matrix (all 6 elements) */
-      sprintf (_plotter->data->page->point, "%%I t\n[");
-      _update_buffer(_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%%I t\n[");
       for (i = 0; i < 6; i++)
 	{
 	  if ((i==0) || (i==1) || (i==2) || (i==3))
-	    sprintf (_plotter->data->page->point, "%.7g ", 
-		     ellipse_transformation_matrix[i] / granularity);
+	    _outbuf_printf (_plotter->data->page, "%.7g ",
+			    ellipse_transformation_matrix[i] / granularity);
 	  else
-	    sprintf (_plotter->data->page->point, "%.7g ", 
-		     ellipse_transformation_matrix[i]);
-	  _update_buffer(_plotter->data->page);
+	    _outbuf_printf (_plotter->data->page, "%.7g ",
+			    ellipse_transformation_matrix[i]);
 	}
-      sprintf (_plotter->data->page->point, "] concat\n");
-      _update_buffer(_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "] concat\n");
       
       /* emit idraw directive: draw Elli, and end Elli (or same for Circ) */
       if (circlep)
-	sprintf (_plotter->data->page->point, "%%I\n%d %d %d Circ\nEnd\n\n", 
-		 IROUND(granularity * x), IROUND(granularity * y), 
-		 IROUND(granularity * rx));
+	_outbuf_printf (_plotter->data->page, "%%I\n%d %d %d Circ\nEnd\n\n",
+			IROUND(granularity * x), IROUND(granularity * y),
+			IROUND(granularity * rx));
       else
-	sprintf (_plotter->data->page->point, "%%I\n%d %d %d %d Elli\nEnd\n\n", 
-		 IROUND(granularity * x), IROUND(granularity * y), 
-		 IROUND(granularity * rx), IROUND(granularity * ry));
-      _update_buffer(_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "%%I\n%d %d %d %d Elli\nEnd\n\n",
+			IROUND(granularity * x), IROUND(granularity * y),
+			IROUND(granularity * rx), IROUND(granularity * ry));
       
       /* update bounding box */
       _set_ellipse_bbox (_plotter->data->page, x, y, rx, ry, costheta, sintheta, 
@@ -559,44 +543,38 @@ _pl_p_emit_common_attributes (S___(Plotter *_plotter))
       else
 	linewidth_adjust = 1.0;
 
-      strcpy (_plotter->data->page->point, "[");
-      _update_buffer (_plotter->data->page);
+      _outbuf_puts (_plotter->data->page, "[");
 
       for (i = 0; i < 4; i++)
 	{
-	  sprintf (_plotter->data->page->point, "%.7g ", 
-		   linewidth_adjust * invnorm * _plotter->drawstate->transform.m[i]);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "%.7g ",
+			  linewidth_adjust * invnorm * _plotter->drawstate->transform.m[i]);
 	}
-      _update_buffer (_plotter->data->page);
-      strcpy (_plotter->data->page->point, "\
+      _outbuf_puts (_plotter->data->page, "\
 0 0 ] trueoriginalCTM originalCTM\n\
 concatmatrix pop\n");
-      _update_buffer (_plotter->data->page);
     }
   
   /* specify cap style and join style, and miter limit if mitering */
   if (_plotter->drawstate->join_type == PL_JOIN_MITER)
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_printf (_plotter->data->page, "\
 %d setlinecap %d setlinejoin %.4g setmiterlimit\n",
-	     ps_cap_style[_plotter->drawstate->cap_type], 
-	     ps_join_style[_plotter->drawstate->join_type],
-	     _plotter->drawstate->miter_limit);
+		    ps_cap_style[_plotter->drawstate->cap_type],
+		    ps_join_style[_plotter->drawstate->join_type],
+		    _plotter->drawstate->miter_limit);
   else
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_printf (_plotter->data->page, "\
 %d setlinecap %d setlinejoin\n",
-	     ps_cap_style[_plotter->drawstate->cap_type], 
-	     ps_join_style[_plotter->drawstate->join_type]);
-  _update_buffer (_plotter->data->page);
+		    ps_cap_style[_plotter->drawstate->cap_type],
+		    ps_join_style[_plotter->drawstate->join_type]);
   
   /* specify fill rule (i.e. whether to use even-odd filling) */
   if (_plotter->drawstate->fill_rule_type == PL_FILL_NONZERO_WINDING)
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_puts (_plotter->data->page, "\
 /eoFillRule false def\n");
   else
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_puts (_plotter->data->page, "\
 /eoFillRule true def\n");
-  _update_buffer (_plotter->data->page);
   
   if (_plotter->drawstate->pen_type != 0)
     /* pen is present, so will brush an outline of the path */
@@ -610,10 +588,9 @@ concatmatrix pop\n");
 	{
 	  /* idraw instruction: brush type (spec'd as bit vector, but for now
 	     we just use a solid brush */
-	  sprintf (_plotter->data->page->point, "\
+	  _outbuf_printf (_plotter->data->page, "\
 %%I b %ld\n", 
-		   (long int)0xffff);
-	  _update_buffer (_plotter->data->page);
+			  (long int)0xffff);
 	  
 	  num_dashes = _plotter->drawstate->dash_array_len;
 	  if (num_dashes > 0)
@@ -653,10 +630,9 @@ concatmatrix pop\n");
 	/* have one of the canonical line types */
 	{
 	  /* idraw brush type (spec'd as bit vector) */
-	  sprintf (_plotter->data->page->point, "\
+	  _outbuf_printf (_plotter->data->page, "\
 %%I b %ld\n", 
-		   idraw_brush_pattern[_plotter->drawstate->line_type]);
-	  _update_buffer (_plotter->data->page);
+			  idraw_brush_pattern[_plotter->drawstate->line_type]);
 	  
 	  if (_plotter->drawstate->line_type == PL_L_SOLID)
 	    {
@@ -699,60 +675,53 @@ concatmatrix pop\n");
       /* Note LineWidth must be an integer for idraw compatibility. */
       
       /* emit dash array */
-      sprintf (_plotter->data->page->point, "%d 0 0 [ ", 
-	       _plotter->drawstate->quantized_device_line_width);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "%d 0 0 [ ",
+		      _plotter->drawstate->quantized_device_line_width);
       for (i = 0; i < num_dashes; i++)
 	{
-	  sprintf (_plotter->data->page->point, "%.3g ", dashbuf[i]);
-	  _update_buffer (_plotter->data->page);
+	  _outbuf_printf (_plotter->data->page, "%.3g ", dashbuf[i]);
 	}
-      sprintf (_plotter->data->page->point, "] %.3g SetB\n", offset);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "] %.3g SetB\n", offset);
       free (dashbuf);
     }
   else
     /* pen_type = 0, we have no pen to draw with (though we may do filling) */
     {
-      sprintf (_plotter->data->page->point, "\
+      _outbuf_printf (_plotter->data->page, "\
 %%I b n\n\
 none SetB\n");
-      _update_buffer (_plotter->data->page);
     }
   
   /* idraw instruction: set foreground color */
   _pl_p_set_pen_color (S___(_plotter)); /* invoked lazily, when needed */
-  sprintf (_plotter->data->page->point, "\
+  _outbuf_printf (_plotter->data->page, "\
 %%I cfg %s\n\
 %g %g %g SetCFg\n",
-	   _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_fgcolor],
-	   _plotter->drawstate->ps_fgcolor_red, 
-	   _plotter->drawstate->ps_fgcolor_green, 
-	   _plotter->drawstate->ps_fgcolor_blue);
-  _update_buffer (_plotter->data->page);
+		  _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_fgcolor],
+		  _plotter->drawstate->ps_fgcolor_red,
+		  _plotter->drawstate->ps_fgcolor_green,
+		  _plotter->drawstate->ps_fgcolor_blue);
   
   /* idraw instruction: set background color */
   _pl_p_set_fill_color (S___(_plotter)); /* invoked lazily, when needed */
-  sprintf (_plotter->data->page->point, "\
+  _outbuf_printf (_plotter->data->page, "\
 %%I cbg %s\n\
 %g %g %g SetCBg\n",
-	   _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_bgcolor],
-	   _plotter->drawstate->ps_fillcolor_red, 
-	   _plotter->drawstate->ps_fillcolor_green, 
-	   _plotter->drawstate->ps_fillcolor_blue);
-  _update_buffer (_plotter->data->page);
+		  _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_bgcolor],
+		  _plotter->drawstate->ps_fillcolor_red,
+		  _plotter->drawstate->ps_fillcolor_green,
+		  _plotter->drawstate->ps_fillcolor_blue);
   
   /* includes idraw instruction: set fill pattern */
   if (_plotter->drawstate->fill_type == 0)	/* transparent */
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_printf (_plotter->data->page, "\
 %%I p\n\
 none SetP\n");
   else			/* filled, i.e. shaded, in the sense of idraw */
-    sprintf (_plotter->data->page->point, "\
+    _outbuf_printf (_plotter->data->page, "\
 %%I p\n\
 %f SetP\n", 
-	     _pl_p_idraw_stdshadings[_plotter->drawstate->ps_idraw_shading]);
-  _update_buffer (_plotter->data->page);
+		    _pl_p_idraw_stdshadings[_plotter->drawstate->ps_idraw_shading]);
   
   /* return factor we'll later use to scale up user-frame coordinates */
   return granularity;
@@ -181,17 +181,15 @@ _pl_p_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     text_transformation_matrix[i] /= norm;
 
   /* prologue instruction, plus idraw directive: start of Text */
-  strcpy (_plotter->data->page->point, "Begin %I Text\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "Begin %I Text\n");
 
   /* idraw directive, plus prologue instruction: set foreground color */
   _pl_p_set_pen_color (S___(_plotter));	/* invoked lazily, i.e. when needed */
-  sprintf (_plotter->data->page->point, "%%I cfg %s\n%g %g %g SetCFg\n",
-	   _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_fgcolor],
-	   _plotter->drawstate->ps_fgcolor_red,
-	   _plotter->drawstate->ps_fgcolor_green,
-	   _plotter->drawstate->ps_fgcolor_blue);
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "%%I cfg %s\n%g %g %g SetCFg\n",
+		  _pl_p_idraw_stdcolornames[_plotter->drawstate->ps_idraw_fgcolor],
+		  _plotter->drawstate->ps_fgcolor_red,
+		  _plotter->drawstate->ps_fgcolor_green,
+		  _plotter->drawstate->ps_fgcolor_blue);
 
   /* idraw directive: X Windows font name, which incorporates the X font
      size.  We use our primary X font name (the `x_name' field, not the
@@ -212,42 +210,36 @@ _pl_p_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
       else
 	ps_name = _pl_g_pcl_font_info[master_font_index].ps_name;
 
-      sprintf (_plotter->data->page->point,
-	       "%%I f -*-%s-*-%d-*-*-*-*-*-*-*\n", 
-	       (_pl_g_pcl_font_info[master_font_index]).x_name, 
-	       IROUND(device_font_size));
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page,
+		      "%%I f -*-%s-*-%d-*-*-*-*-*-*-*\n",
+		      (_pl_g_pcl_font_info[master_font_index]).x_name,
+		      IROUND(device_font_size));
 
       /* prolog instruction: PS font name and size */
-      sprintf (_plotter->data->page->point, "/%s %f SetF\n", 
-	       ps_name,
-	       device_font_size);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "/%s %f SetF\n",
+		      ps_name,
+		      device_font_size);
     }
   else				/* one of the 35 PS fonts */
     {
-      sprintf (_plotter->data->page->point,
-	       "%%I f -*-%s-*-%d-*-*-*-*-*-*-*\n", 
-	       (_pl_g_ps_font_info[master_font_index]).x_name, 
-	       IROUND(device_font_size));
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page,
+		      "%%I f -*-%s-*-%d-*-*-*-*-*-*-*\n",
+		      (_pl_g_ps_font_info[master_font_index]).x_name,
+		      IROUND(device_font_size));
 
       /* prolog instruction: PS font name and size */
-      sprintf (_plotter->data->page->point, "/%s %f SetF\n", 
-	       _pl_g_ps_font_info[master_font_index].ps_name,
-	       device_font_size);
-      _update_buffer (_plotter->data->page);
+      _outbuf_printf (_plotter->data->page, "/%s %f SetF\n",
+		      _pl_g_ps_font_info[master_font_index].ps_name,
+		      device_font_size);
     }
 
   /* idraw directive and prologue instruction: text transformation matrix */
-  strcpy (_plotter->data->page->point, "%I t\n[ ");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "%I t\n[ ");
 
   for (i = 0; i < 6; i++)
     {
-      sprintf (_plotter->data->page->point, "%.7g ", 
-	       text_transformation_matrix[i]);
-      _update_buffer (_plotter->data->page);      
+      _outbuf_printf (_plotter->data->page, "%.7g ",
+		      text_transformation_matrix[i]);
     }
   
   /* width of the string in user units (used below in constructing a
@@ -281,11 +273,10 @@ _pl_p_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
 
   /* Finish outputting transformation matrix; begin outputting string. */
   /* Escape all backslashes etc. in the text string, before output. */
-  strcpy (_plotter->data->page->point, " ] concat\n\
+  _outbuf_puts (_plotter->data->page, " ] concat\n\
 %I\n\
 [\n\
 (");
-  _update_buffer (_plotter->data->page);
 
   ptr = (unsigned char *)_plotter->data->page->point;
   while (*s)
@@ -314,11 +305,10 @@ _pl_p_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
   _update_buffer (_plotter->data->page);
 
   /* prologue instruction: end of text */
-  strcpy (_plotter->data->page->point, ")\n\
+  _outbuf_puts (_plotter->data->page, ")\n\
 ] Text\n\
 End\n\
 \n");
-  _update_buffer (_plotter->data->page);
 
   /* flag current PS or PCL font as used on this page */
 #ifdef USE_LJ_FONTS_IN_PS
@@ -72,10 +72,10 @@ _pl_r_paint_path (S___(Plotter *_plotter))
 		double x, y;
 		int i_x, i_y;
 		
-		x = XD(_plotter->drawstate->path->segments[i].p.x,
-		       _plotter->drawstate->path->segments[i].p.y);
-		y = YD(_plotter->drawstate->path->segments[i].p.x,
-		       _plotter->drawstate->path->segments[i].p.y);
+		x = XD(_plotter->drawstate->path->points[i].x,
+		       _plotter->drawstate->path->points[i].y);
+		y = YD(_plotter->drawstate->path->points[i].x,
+		       _plotter->drawstate->path->points[i].y);
 		i_x = IROUND(x);
 		i_y = IROUND(y);
 		if (i_x < REGIS_DEVICE_X_MIN
@@ -95,10 +95,10 @@ _pl_r_paint_path (S___(Plotter *_plotter))
 		plIntPoint first, oldpoint, newpoint;
 
 		_pl_r_set_fill_color (S___(_plotter));
-		x = XD(_plotter->drawstate->path->segments[0].p.x,
-		       _plotter->drawstate->path->segments[0].p.y);
-		y = YD(_plotter->drawstate->path->segments[0].p.x,
-			     _plotter->drawstate->path->segments[0].p.y);
+		x = XD(_plotter->drawstate->path->points[0].x,
+		       _plotter->drawstate->path->points[0].y);
+		y = YD(_plotter->drawstate->path->points[0].x,
+			     _plotter->drawstate->path->points[0].y);
 		first.x = IROUND(x);
 		first.y = IROUND(y);
 		_pl_r_regis_move (R___(_plotter) first.x, first.y); /* use P[..] */
@@ -109,10 +109,10 @@ _pl_r_paint_path (S___(Plotter *_plotter))
 		oldpoint = first;
 		for (i = 1; i < _plotter->drawstate->path->num_segments; i++)
 		  {
-		    x = XD(_plotter->drawstate->path->segments[i].p.x,
-			   _plotter->drawstate->path->segments[i].p.y);
-		    y = YD(_plotter->drawstate->path->segments[i].p.x,
-			   _plotter->drawstate->path->segments[i].p.y);
+		    x = XD(_plotter->drawstate->path->points[i].x,
+			   _plotter->drawstate->path->points[i].y);
+		    y = YD(_plotter->drawstate->path->points[i].x,
+			   _plotter->drawstate->path->points[i].y);
 		    newpoint.x = IROUND(x);
 		    newpoint.y = IROUND(y);
 		    /* emit vector; omit it if it has zero-length in the
@@ -154,14 +154,14 @@ _pl_r_paint_path (S___(Plotter *_plotter))
 		
 		/* nominal starting point and ending point for new line
 		   segment, in floating point device coordinates */
-		start.x = XD(_plotter->drawstate->path->segments[i-1].p.x,
-			     _plotter->drawstate->path->segments[i-1].p.y);
-		start.y = YD(_plotter->drawstate->path->segments[i-1].p.x,
-			     _plotter->drawstate->path->segments[i-1].p.y);
-		end.x = XD(_plotter->drawstate->path->segments[i].p.x,
-			   _plotter->drawstate->path->segments[i].p.y);
-		end.y = YD(_plotter->drawstate->path->segments[i].p.x,
-			   _plotter->drawstate->path->segments[i].p.y);
+		start.x = XD(_plotter->drawstate->path->points[i-1].x,
+			     _plotter->drawstate->path->points[i-1].y);
+		start.y = YD(_plotter->drawstate->path->points[i-1].x,
+			     _plotter->drawstate->path->points[i-1].y);
+		end.x = XD(_plotter->drawstate->path->points[i].x,
+			   _plotter->drawstate->path->points[i].y);
+		end.y = YD(_plotter->drawstate->path->points[i].x,
+			   _plotter->drawstate->path->points[i].y);
 
 		/* clip line segment to rectangular clipping region in
 		   device frame */
@@ -269,7 +269,7 @@ _pl_r_paint_path (S___(Plotter *_plotter))
 	    
 	    _plotter->drawstate->path = _flatten_path (oldpath);
 	    _plotter->paint_path (S___(_plotter)); /* recursive invocation */
-	    _delete_plPath (_plotter->drawstate->path);
+	    _recycle_plPath (_plotter->data, _plotter->drawstate->path);
 	    _plotter->drawstate->path = oldpath;	    
 	  }
 	else
@@ -37,10 +37,9 @@ _pl_s_end_page (S___(Plotter *_plotter))
   svg_header = _new_outbuf ();
       
   /* start with DTD */
-  sprintf (svg_header->point, "\
+  _outbuf_puts (svg_header, "\
 <?xml version=\"1.0\" encoding=\"ISO-8859-1\" standalone=\"no\"?>\n\
 <!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
-  _update_buffer (svg_header);
 
   /* Emit nominal physical size of the device-frame viewport (and specify
      that in the device-frame coordinates we use, it's a unit square).
@@ -50,48 +49,42 @@ _pl_s_end_page (S___(Plotter *_plotter))
      (see s_defplot.c).  Which is why we can take absolute values here. */
 
   if (_plotter->data->page_data->metric)
-    sprintf (svg_header->point, 
-	     "<svg version=\"1.1\" baseProfile=\"full\" id=\"body\" width=\"%.5gcm\" height=\"%.5gcm\" ",
-	     2.54 * FABS(_plotter->data->viewport_xsize),
-	     2.54 * FABS(_plotter->data->viewport_ysize));
+    _outbuf_printf (svg_header,
+		    "<svg version=\"1.1\" baseProfile=\"full\" id=\"body\" width=\"%.5gcm\" height=\"%.5gcm\" ",
+		    2.54 * FABS(_plotter->data->viewport_xsize),
+		    2.54 * FABS(_plotter->data->viewport_ysize));
   else
-    sprintf (svg_header->point, 
-	     "<svg version=\"1.1\" baseProfile=\"full\" id=\"body\" width=\"%.5gin\" height=\"%.5gin\" ",
-	     FABS(_plotter->data->viewport_xsize),
-	     FABS(_plotter->data->viewport_ysize));
-  _update_buffer (svg_header);
-  sprintf (svg_header->point, 
-	   "%s %s %s %s %s>\n",
-	   "viewBox=\"0 0 1 1\"",
-	   "preserveAspectRatio=\"none\"",
-	   /* bind SVG namespace */
-	   "xmlns=\"http://www.w3.org/2000/svg\"",
-	   /* bind XLink and XML Events namespaces for good measure */
-	   "xmlns:xlink=\"http://www.w3.org/1999/xlink\"",
-	   "xmlns:ev=\"http://www.w3.org/2001/xml-events\"");
-  _update_buffer (svg_header);
-
-  sprintf (svg_header->point, "<title>SVG drawing</title>\n");
-  _update_buffer (svg_header);
-
-  sprintf (svg_header->point, "<desc>This was produced by version %s of GNU libplot, a free library for exporting 2-D vector graphics.</desc>\n", 
-	   PL_LIBPLOT_VER_STRING);
-  _update_buffer (svg_header);
+    _outbuf_printf (svg_header,
+		    "<svg version=\"1.1\" baseProfile=\"full\" id=\"body\" width=\"%.5gin\" height=\"%.5gin\" ",
+		    FABS(_plotter->data->viewport_xsize),
+		    FABS(_plotter->data->viewport_ysize));
+  _outbuf_printf (svg_header,
+		  "%s %s %s %s %s>\n",
+		  "viewBox=\"0 0 1 1\"",
+		  "preserveAspectRatio=\"none\"",
+		  /* bind SVG namespace */
+		  "xmlns=\"http://www.w3.org/2000/svg\"",
+		  /* bind XLink and XML Events namespaces for good measure */
+		  "xmlns:xlink=\"http://www.w3.org/1999/xlink\"",
+		  "xmlns:ev=\"http://www.w3.org/2001/xml-events\"");
+
+  _outbuf_puts (svg_header, "<title>SVG drawing</title>\n");
+
+  _outbuf_printf (svg_header, "<desc>This was produced by version %s of GNU libplot, a free library for exporting 2-D vector graphics.</desc>\n",
+		  PL_LIBPLOT_VER_STRING);
 
   if (_plotter->s_bgcolor_suppressed == false)
   /* place a background rectangle behind, covering entire viewport */
     {
       char color_buf[8];	/* enough room for "#ffffff", incl. NUL */
 
-      sprintf (svg_header->point, 
-	       "<rect id=\"background\" x=\"0\" y=\"0\" width=\"1\" height=\"1\" stroke=\"none\" fill=\"%s\"/>\n",
-	       _libplot_color_to_svg_color (_plotter->s_bgcolor, color_buf));
-      _update_buffer (svg_header);
+      _outbuf_printf (svg_header,
+		      "<rect id=\"background\" x=\"0\" y=\"0\" width=\"1\" height=\"1\" stroke=\"none\" fill=\"%s\"/>\n",
+		      _libplot_color_to_svg_color (_plotter->s_bgcolor, color_buf));
     }
 
   /* enclose everything else in a container */
-  sprintf (svg_header->point, "<g id=\"content\" ");
-  _update_buffer (svg_header);
+  _outbuf_puts (svg_header, "<g id=\"content\" ");
       
   if (_plotter->s_matrix_is_unknown == false
       && _plotter->s_matrix_is_bogus == false)
@@ -116,87 +109,67 @@ _pl_s_end_page (S___(Plotter *_plotter))
     }
 
   /* turn off SVG's default [unfortunate] XML-inherited treatment of spaces */
-  sprintf (svg_header->point, "xml:space=\"preserve\" ");
-  _update_buffer (svg_header);
+  _outbuf_puts (svg_header, "xml:space=\"preserve\" ");
 
   /* specify style properties (all libplot defaults) */
 
-  sprintf (svg_header->point, "stroke=\"%s\" ",
-	   "black");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke=\"%s\" ",
+		  "black");
 
-  sprintf (svg_header->point, "stroke-linecap=\"%s\" ",
-	   "butt");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-linecap=\"%s\" ",
+		  "butt");
 
-  sprintf (svg_header->point, "stroke-linejoin=\"%s\" ",
-	   "miter");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-linejoin=\"%s\" ",
+		  "miter");
 
-  sprintf (svg_header->point, "stroke-miterlimit=\"%.5g\" ",
-	   PL_DEFAULT_MITER_LIMIT);
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-miterlimit=\"%.5g\" ",
+		  PL_DEFAULT_MITER_LIMIT);
 
-  sprintf (svg_header->point, "stroke-dasharray=\"%s\" ",
-	   "none");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-dasharray=\"%s\" ",
+		  "none");
 
   /* should use `px' here to specify user units, per the SVG Authoring
      Guide, but ImageMagick objects to that */
-  sprintf (svg_header->point, "stroke-dashoffset=\"%.5g\" ",
-	   0.0);
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-dashoffset=\"%.5g\" ",
+		  0.0);
 
-  sprintf (svg_header->point, "stroke-opacity=\"%.5g\" ",
-	   1.0);
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "stroke-opacity=\"%.5g\" ",
+		  1.0);
 
-  sprintf (svg_header->point, "fill=\"%s\" ",
-	   "none");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "fill=\"%s\" ",
+		  "none");
 
-  sprintf (svg_header->point, "fill-rule=\"%s\" ",
-	   "evenodd");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "fill-rule=\"%s\" ",
+		  "evenodd");
 
-  sprintf (svg_header->point, "fill-opacity=\"%.5g\" ",
-	   1.0);
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "fill-opacity=\"%.5g\" ",
+		  1.0);
 
-  sprintf (svg_header->point, "font-style=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "font-style=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "font-variant=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "font-variant=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "font-weight=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "font-weight=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "font-stretch=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "font-stretch=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "font-size-adjust=\"%s\" ",
-	   "none");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "font-size-adjust=\"%s\" ",
+		  "none");
 
-  sprintf (svg_header->point, "letter-spacing=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "letter-spacing=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "word-spacing=\"%s\" ",
-	   "normal");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "word-spacing=\"%s\" ",
+		  "normal");
 
-  sprintf (svg_header->point, "text-anchor=\"%s\"",
-	   "start");
-  _update_buffer (svg_header);
+  _outbuf_printf (svg_header, "text-anchor=\"%s\"",
+		  "start");
 
-  sprintf (svg_header->point, ">\n");
-  _update_buffer (svg_header);
+  _outbuf_puts (svg_header, ">\n");
 
   /* place SVG header in this page's plOutbuf */
   _plotter->data->page->header = svg_header;
@@ -204,11 +177,9 @@ _pl_s_end_page (S___(Plotter *_plotter))
   /* prepare SVG trailer too, write it to a plOutbuf */
   svg_trailer = _new_outbuf ();
   
-  sprintf (svg_trailer->point, "</g>\n");
-  _update_buffer (svg_trailer);
+  _outbuf_puts (svg_trailer, "</g>\n");
 
-  sprintf (svg_trailer->point, "</svg>\n");
-  _update_buffer (svg_trailer);
+  _outbuf_puts (svg_trailer, "</svg>\n");
   
   /* place SVG trailer in this page's plOutbuf */
   _plotter->data->page->trailer = svg_trailer;
@@ -381,8 +352,7 @@ write_svg_transform (plOutbuf *outbuf, const double m[6])
   else if (mm[0] == 0.0 && mm[1] == -1.0 && mm[2] == -1.0 && mm[3] == 0.0)
     type = 5;			/* y-flip + rotation by 270 + translation */
   
-  sprintf (outbuf->point, "transform=\"");
-  _update_buffer (outbuf);
+  _outbuf_puts (outbuf, "transform=\"");
       
   if (type != 0)
     {
@@ -391,12 +361,11 @@ write_svg_transform (plOutbuf *outbuf, const double m[6])
       if (mm[4] != 0.0 || mm[5] != 0.0)
 	{
 	  if (mm[5] == 0.0)
-	    sprintf (outbuf->point, "translate(%.5g) ",
-		     mm[4]);
+	    _outbuf_printf (outbuf, "translate(%.5g) ",
+			    mm[4]);
 	  else
-	    sprintf (outbuf->point, "translate(%.5g,%.5g) ",
-		     mm[4], mm[5]);
-	  _update_buffer (outbuf);	      
+	    _outbuf_printf (outbuf, "translate(%.5g,%.5g) ",
+			    mm[4], mm[5]);
 	}
 
       switch (type)
@@ -405,41 +374,36 @@ write_svg_transform (plOutbuf *outbuf, const double m[6])
 	  if (mm[0] != 1.0 || mm[3] != 1.0)
 	    {
 	      if (mm[3] == mm[0])
-		sprintf (outbuf->point, "scale(%.5g) ",
-			 mm[0]);
+		_outbuf_printf (outbuf, "scale(%.5g) ",
+				mm[0]);
 	      else if (mm[3] == -mm[0])
 		{
 		  if (mm[0] != 1.0)
-		    sprintf (outbuf->point, "scale(1,-1) scale(%.5g) ",
-			     mm[0]);
+		    _outbuf_printf (outbuf, "scale(1,-1) scale(%.5g) ",
+				    mm[0]);
 		  else
-		    sprintf (outbuf->point, "scale(1,-1) ");
+		    _outbuf_puts (outbuf, "scale(1,-1) ");
 		}
 	      else
-		sprintf (outbuf->point, "scale(%.5g,%.5g) ",
-			 mm[0], mm[3]);
-	      _update_buffer (outbuf);	      
+		_outbuf_printf (outbuf, "scale(%.5g,%.5g) ",
+				mm[0], mm[3]);
 	    }
 	  break;
 
 	case 2:
-	  sprintf (outbuf->point, "rotate(90) ");
-	  _update_buffer (outbuf);	      
+	  _outbuf_puts (outbuf, "rotate(90) ");
 	  break;
 
 	case 3:
-	  sprintf (outbuf->point, "rotate(270) ");
-	  _update_buffer (outbuf);	      
+	  _outbuf_puts (outbuf, "rotate(270) ");
 	  break;
 
 	case 4:
-	  sprintf (outbuf->point, "rotate(90) scale(1,-1) ");
-	  _update_buffer (outbuf);	      
+	  _outbuf_puts (outbuf, "rotate(90) scale(1,-1) ");
 	  break;
 
 	case 5:
-	  sprintf (outbuf->point, "rotate(270) scale(1,-1) ");
-	  _update_buffer (outbuf);	      
+	  _outbuf_puts (outbuf, "rotate(270) scale(1,-1) ");
 	  break;
 
 	default:		/* shouldn't happen */
@@ -449,11 +413,9 @@ write_svg_transform (plOutbuf *outbuf, const double m[6])
   else
     /* general affine transformation */
     {
-      sprintf (outbuf->point, "matrix(%.5g %.5g %.5g %.5g %.5g %.5g) ",
-	       mm[0], mm[1], mm[2], mm[3], mm[4], mm[5]);
-      _update_buffer (outbuf);
+      _outbuf_printf (outbuf, "matrix(%.5g %.5g %.5g %.5g %.5g %.5g) ",
+		      mm[0], mm[1], mm[2], mm[3], mm[4], mm[5]);
     }
 
-  sprintf (outbuf->point, "\" ");
-  _update_buffer (outbuf);
+  _outbuf_puts (outbuf, "\" ");
 }
@@ -65,8 +65,8 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;		/* 2-point ones should be open */
@@ -79,7 +79,7 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	  {
 	    plPathSegmentType element_type;
 	    
-	    element_type = _plotter->drawstate->path->segments[i].type;
+	    element_type = _path_segment_type (_plotter->drawstate->path, i);
 	    if (element_type != S_LINE)
 	      {
 		lines_only = false;
@@ -90,118 +90,94 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	if (lines_only && _plotter->drawstate->path->num_segments == 2)
 	  /* SVG line */
 	  {
-	    sprintf (_plotter->data->page->point, "<line ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "<line ");
 
 	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	    sprintf (_plotter->data->page->point,
-		     "x1=\"%.5g\" y1=\"%.5g\" x2=\"%.5g\" y2=\"%.5g\" ",
-		     _plotter->drawstate->path->segments[0].p.x,
-		     _plotter->drawstate->path->segments[0].p.y,
-		     _plotter->drawstate->path->segments[1].p.x,
-		     _plotter->drawstate->path->segments[1].p.y);
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_printf (_plotter->data->page,
+			    "x1=\"%.5g\" y1=\"%.5g\" x2=\"%.5g\" y2=\"%.5g\" ",
+			    _plotter->drawstate->path->points[0].x,
+			    _plotter->drawstate->path->points[0].y,
+			    _plotter->drawstate->path->points[1].x,
+			    _plotter->drawstate->path->points[1].y);
 
 	    write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 				   true, false);
 
-	    sprintf (_plotter->data->page->point, "/>\n");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "/>\n");
 	  }
 	
 	else if (lines_only && !closed)
 	  /* SVG polyline */
 	  {
-	    sprintf (_plotter->data->page->point, "<polyline ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "<polyline ");
 
 	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	    sprintf (_plotter->data->page->point,
-		     "points=\"");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "points=\"");
 	    for (i = 0; i < _plotter->drawstate->path->num_segments; i++)
 	      {
 		plPoint p;
 
-		p = _plotter->drawstate->path->segments[i].p;
-		sprintf (_plotter->data->page->point,
-			 "%.5g,%.5g ",
-			 p.x, p.y);
-		_update_buffer (_plotter->data->page);
+		p = _plotter->drawstate->path->points[i];
+		_outbuf_put_general (_plotter->data->page, p.x, 5);
+		_outbuf_putc (_plotter->data->page, ',');
+		_outbuf_put_general (_plotter->data->page, p.y, 5);
+		_outbuf_putc (_plotter->data->page, ' ');
 	      }
-	    sprintf (_plotter->data->page->point,
-		     "\" ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "\" ");
 
 	    write_svg_path_style (_plotter->data->page, _plotter->drawstate,
 				   true, true);
 
-	    sprintf (_plotter->data->page->point,
-		     "/>\n");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "/>\n");
 	  }
 	
 	else if (lines_only && closed)
 	  /* SVG polygon */
 	  {
-	    sprintf (_plotter->data->page->point, "<polygon ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "<polygon ");
 
 	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	    sprintf (_plotter->data->page->point,
-		     "points=\"");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "points=\"");
 	    for (i = 0; i < _plotter->drawstate->path->num_segments - 1; i++)
 	      {
 		plPoint p;
 
-		p = _plotter->drawstate->path->segments[i].p;
-		sprintf (_plotter->data->page->point,
-			 "%.5g,%.5g ",
-			 p.x, p.y);
-		_update_buffer (_plotter->data->page);
+		p = _plotter->drawstate->path->points[i];
+		_outbuf_put_general (_plotter->data->page, p.x, 5);
+		_outbuf_putc (_plotter->data->page, ',');
+		_outbuf_put_general (_plotter->data->page, p.y, 5);
+		_outbuf_putc (_plotter->data->page, ' ');
 	      }
-	    sprintf (_plotter->data->page->point,
-		     "\" ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "\" ");
 
 	    write_svg_path_style (_plotter->data->page, _plotter->drawstate,
 				   false, true);
 
-	    sprintf (_plotter->data->page->point,
-		     "/>\n");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "/>\n");
 	  }
 
 	else
 	  /* general SVG path */
 	  {
-	    sprintf (_plotter->data->page->point, "<path ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "<path ");
 
 	    _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	    sprintf (_plotter->data->page->point,
-		     "d=\"");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "d=\"");
 	    
 	    /* write SVG path data string */
 	    write_svg_path_data (_plotter->data->page, 
 				  _plotter->drawstate->path);
 
-	    sprintf (_plotter->data->page->point,
-		     "\" ");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "\" ");
 
 	    write_svg_path_style (_plotter->data->page, _plotter->drawstate,
 				   true, true);
 
-	    sprintf (_plotter->data->page->point,
-		     "/>\n");
-	    _update_buffer (_plotter->data->page);
+	    _outbuf_puts (_plotter->data->page, "/>\n");
 	  }
       }
       break;
@@ -218,21 +194,17 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	xmax = DMAX(p0.x, p1.x);
 	ymax = DMAX(p0.y, p1.y);
 
-	sprintf (_plotter->data->page->point, "<rect ");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "<rect ");
 
 	_pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-	sprintf (_plotter->data->page->point,
-		 "x=\"%.5g\" y=\"%.5g\" width=\"%.5g\" height=\"%.5g\" ",
-		 xmin, ymin, xmax - xmin, ymax - ymin);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page,
+			"x=\"%.5g\" y=\"%.5g\" width=\"%.5g\" height=\"%.5g\" ",
+			xmin, ymin, xmax - xmin, ymax - ymin);
 
 	write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 			       false, true);
-	sprintf (_plotter->data->page->point,
-		 "/>\n");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "/>\n");
       }
       break;
 
@@ -241,23 +213,19 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	plPoint pc;
 	double radius = _plotter->drawstate->path->radius;
 
-	sprintf (_plotter->data->page->point, "<circle ");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "<circle ");
 
 	_pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
 	pc = _plotter->drawstate->path->pc;
-	sprintf (_plotter->data->page->point,
-		 "cx=\"%.5g\" cy=\"%.5g\" r=\"%.5g\" ",
-		 pc.x, pc.y, radius);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page,
+			"cx=\"%.5g\" cy=\"%.5g\" r=\"%.5g\" ",
+			pc.x, pc.y, radius);
 
 	write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 			       false, false);
 
-	sprintf (_plotter->data->page->point,
-		 "/>\n");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "/>\n");
       }
       break;
       
@@ -269,8 +237,7 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	double angle = _plotter->drawstate->path->angle;	
 	double local_matrix[6];
 
-	sprintf (_plotter->data->page->point, "<ellipse ");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "<ellipse ");
 
 	pc = _plotter->drawstate->path->pc;
 	local_matrix[0] = cos (M_PI * angle / 180.0);
@@ -281,15 +248,13 @@ _pl_s_paint_path (S___(Plotter *_plotter))
 	local_matrix[5] = pc.y;
 	_pl_s_set_matrix (R___(_plotter) local_matrix);
 
-	sprintf (_plotter->data->page->point, "rx=\"%.5g\" ry=\"%.5g\" ",
-		 rx, ry);
-	_update_buffer (_plotter->data->page);
+	_outbuf_printf (_plotter->data->page, "rx=\"%.5g\" ry=\"%.5g\" ",
+			rx, ry);
 
 	write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 			       false, false);
 
-	sprintf (_plotter->data->page->point, "/>\n");
-	_update_buffer (_plotter->data->page);
+	_outbuf_puts (_plotter->data->page, "/>\n");
       }
       break;
 
@@ -303,15 +268,11 @@ _pl_s_paint_paths (S___(Plotter *_plotter))
 {
   int i;
 
-  sprintf (_plotter->data->page->point,
-	   "<path ");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "<path ");
   
   _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-  sprintf (_plotter->data->page->point,
-	   "d=\"");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "d=\"");
   
   for (i = 0; i < _plotter->drawstate->num_paths; i++)
     {
@@ -334,31 +295,30 @@ _pl_s_paint_paths (S___(Plotter *_plotter))
 	    radius = path->radius;
 	    if (path->clockwise == false)
 	      /* counter-clockwise */
-	      sprintf (_plotter->data->page->point, "\
+	      _outbuf_printf (_plotter->data->page, "\
 M%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
-		       pc.x + radius, pc.y, 
-		       radius, radius, 0.0, 0, 1, pc.x, pc.y + radius,
-		       radius, radius, 0.0, 0, 1, pc.x - radius, pc.y,
-		       radius, radius, 0.0, 0, 1, pc.x, pc.y - radius,
-		       radius, radius, 0.0, 0, 1, pc.x + radius, pc.y);
+			      pc.x + radius, pc.y,
+			      radius, radius, 0.0, 0, 1, pc.x, pc.y + radius,
+			      radius, radius, 0.0, 0, 1, pc.x - radius, pc.y,
+			      radius, radius, 0.0, 0, 1, pc.x, pc.y - radius,
+			      radius, radius, 0.0, 0, 1, pc.x + radius, pc.y);
 	    else
 	      /* clockwise */
-	      sprintf (_plotter->data->page->point, "\
+	      _outbuf_printf (_plotter->data->page, "\
 M%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
-		       pc.x + radius, pc.y, 
-		       radius, radius, 0.0, 0, 0, pc.x, pc.y - radius,
-		       radius, radius, 0.0, 0, 0, pc.x - radius, pc.y,
-		       radius, radius, 0.0, 0, 0, pc.x, pc.y + radius,
-		       radius, radius, 0.0, 0, 0, pc.x + radius, pc.y);
-	    _update_buffer (_plotter->data->page);
+			      pc.x + radius, pc.y,
+			      radius, radius, 0.0, 0, 0, pc.x, pc.y - radius,
+			      radius, radius, 0.0, 0, 0, pc.x - radius, pc.y,
+			      radius, radius, 0.0, 0, 0, pc.x, pc.y + radius,
+			      radius, radius, 0.0, 0, 0, pc.x + radius, pc.y);
 	  }
 	  break;
 
@@ -380,31 +340,30 @@ A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
 
 	    if (path->clockwise == false)
 	      /* counter-clockwise */
-	      sprintf (_plotter->data->page->point, "\
+	      _outbuf_printf (_plotter->data->page, "\
 M%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
-		       pc.x + v1.x, pc.y + v1.y, 
-		       rx, ry, 0.0, 0, 1, pc.x + v2.x, pc.y + v2.y,
-		       rx, ry, 0.0, 0, 1, pc.x - v1.x, pc.y - v1.y,
-		       rx, ry, 0.0, 0, 1, pc.x - v2.x, pc.y - v2.y,
-		       rx, ry, 0.0, 0, 1, pc.x + v1.x, pc.y + v1.y);
+			      pc.x + v1.x, pc.y + v1.y,
+			      rx, ry, 0.0, 0, 1, pc.x + v2.x, pc.y + v2.y,
+			      rx, ry, 0.0, 0, 1, pc.x - v1.x, pc.y - v1.y,
+			      rx, ry, 0.0, 0, 1, pc.x - v2.x, pc.y - v2.y,
+			      rx, ry, 0.0, 0, 1, pc.x + v1.x, pc.y + v1.y);
 	    else
 	      /* clockwise */
-	      sprintf (_plotter->data->page->point, "\
+	      _outbuf_printf (_plotter->data->page, "\
 M%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g \
 A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
-		       pc.x + v1.x, pc.y + v1.y, 
-		       rx, ry, 0.0, 0, 0, pc.x - v2.x, pc.y - v2.y,
-		       rx, ry, 0.0, 0, 0, pc.x - v1.x, pc.y - v1.y,
-		       rx, ry, 0.0, 0, 0, pc.x + v2.x, pc.y + v2.y,
-		       rx, ry, 0.0, 0, 0, pc.x + v1.x, pc.y + v1.y);
-	    _update_buffer (_plotter->data->page);
+			      pc.x + v1.x, pc.y + v1.y,
+			      rx, ry, 0.0, 0, 0, pc.x - v2.x, pc.y - v2.y,
+			      rx, ry, 0.0, 0, 0, pc.x - v1.x, pc.y - v1.y,
+			      rx, ry, 0.0, 0, 0, pc.x + v2.x, pc.y + v2.y,
+			      rx, ry, 0.0, 0, 0, pc.x + v1.x, pc.y + v1.y);
 	  }
 	  break;
 
@@ -426,14 +385,13 @@ A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
 	      x_move_is_first = (x_move_is_first == true ? false : true);
 
 	    if (x_move_is_first)
-	      sprintf (_plotter->data->page->point, 
-		       "M%.5g,%.5g H%.5g V%.5g H%.5g Z ",
-		       p0.x, p0.y, p1.x, p1.y, p0.x);
+	      _outbuf_printf (_plotter->data->page,
+			      "M%.5g,%.5g H%.5g V%.5g H%.5g Z ",
+			      p0.x, p0.y, p1.x, p1.y, p0.x);
 	    else
-	      sprintf (_plotter->data->page->point, 
-		       "M%.5g,%.5g V%.5g H%.5g V%.5g Z ",
-		       p0.x, p0.y, p1.y, p1.x, p0.y);
-	    _update_buffer (_plotter->data->page);
+	      _outbuf_printf (_plotter->data->page,
+			      "M%.5g,%.5g V%.5g H%.5g V%.5g Z ",
+			      p0.x, p0.y, p1.y, p1.x, p0.y);
 	  }
 	  break;
 
@@ -441,16 +399,12 @@ A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g Z ",
 	  break;
 	}
     }
-  sprintf (_plotter->data->page->point,
-	   "\" ");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "\" ");
 
   write_svg_path_style (_plotter->data->page, _plotter->drawstate, 
 			 true, true);
 
-  sprintf (_plotter->data->page->point,
-	   "/>\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "/>\n");
 
   return true;
 }
@@ -464,6 +418,7 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 {
   bool closed;
   plPoint p, oldpoint;
+  plPathIterator iter;
   int i;
   
   /* sanity check */
@@ -471,27 +426,29 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
     return;
 
   if ((path->num_segments >= 3)	/* check for closure */
-      && (path->segments[path->num_segments - 1].p.x == path->segments[0].p.x)
-      && (path->segments[path->num_segments - 1].p.y == path->segments[0].p.y))
+      && (path->points[path->num_segments - 1].x == path->points[0].x)
+      && (path->points[path->num_segments - 1].y == path->points[0].y))
     closed = true;
   else
     closed = false;		/* 2-point ones should be open */
 	
-  p = path->segments[0].p;	/* initial seg should be a moveto */
-  sprintf (page->point, "M%.5g,%.5g ",
-	   p.x, p.y);
-  _update_buffer (page);
+  p = path->points[0];	/* initial seg should be a moveto */
+  _outbuf_printf (page, "M%.5g,%.5g ",
+		  p.x, p.y);
   
   oldpoint = p;
+  _path_iter_start (&iter, path, 1);
   for (i = 1; i < path->num_segments; i++)
     {
+      plPathSegment segment;
       plPathSegmentType type;
       plPoint pc, pd;
       
-      type = path->segments[i].type;
-      p = path->segments[i].p;
-      pc = path->segments[i].pc;
-      pd = path->segments[i].pd;
+      _path_iter_next (&iter, &segment);
+      type = segment.type;
+      p = segment.p;
+      pc = segment.pc;
+      pd = segment.pd;
       
       if (closed
 	  && i == path->num_segments - 1
@@ -502,14 +459,23 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	{
 	case (int)S_LINE:
 	  if (p.y == oldpoint.y)
-	    sprintf (page->point, "H%.5g ",
-		     p.x);
+	    {
+	      _outbuf_putc (page, 'H');
+	      _outbuf_put_general (page, p.x, 5);
+	    }
 	  else if (p.x == oldpoint.x)
-	    sprintf (page->point, "V%.5g ",
-		     p.y);
+	    {
+	      _outbuf_putc (page, 'V');
+	      _outbuf_put_general (page, p.y, 5);
+	    }
 	  else
-	    sprintf (page->point, "L%.5g,%.5g ",
-		     p.x, p.y);
+	    {
+	      _outbuf_putc (page, 'L');
+	      _outbuf_put_general (page, p.x, 5);
+	      _outbuf_putc (page, ',');
+	      _outbuf_put_general (page, p.y, 5);
+	    }
+	  _outbuf_putc (page, ' ');
 	  break;
 	  
 	case (int)S_ARC:
@@ -522,12 +488,12 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	    
 	    radius = sqrt ((p.x - pc.x)*(p.x - pc.x)
 			   + (p.y - pc.y)*(p.y - pc.y));
-	    sprintf (page->point, "A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g ",
-		     radius, radius, 
-		     0.0, /* rotation of x-axis of ellipse */
-		     0, /* large-arc-flag, 0/1 = small/large */
-		     angle >= 0.0 ? 1 : 0,/* sweep-flag, 0/1 = clock/c'clock */
-		     p.x, p.y);
+	    _outbuf_printf (page, "A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g ",
+			    radius, radius,
+			    0.0, /* rotation of x-axis of ellipse */
+			    0, /* large-arc-flag, 0/1 = small/large */
+			    angle >= 0.0 ? 1 : 0,/* sweep-flag, 0/1 = clock/c'clock */
+			    p.x, p.y);
 	  }
 	  break;
 	  
@@ -575,37 +541,35 @@ write_svg_path_data (plOutbuf *page, const plPath *path)
 	    if (theta < VERY_SMALL_ANGLE && theta > -(VERY_SMALL_ANGLE))
 	      theta = 0.0;
 
-	    sprintf (page->point, "A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g ",
-		     rx, ry, 
-		     theta * 180.0 / M_PI, /* rotation of x-axis of ellipse */
-		     0, /* large-arc-flag, 0/1 = small/large */
-		     clockwise ? 0 : 1,	/* sweep-flag, 0/1 = clock/c'clock */
-		     p.x, p.y);
+	    _outbuf_printf (page, "A%.5g,%.5g,%.5g,%d,%d,%.5g,%.5g ",
+			    rx, ry,
+			    theta * 180.0 / M_PI, /* rotation of x-axis of ellipse */
+			    0, /* large-arc-flag, 0/1 = small/large */
+			    clockwise ? 0 : 1,	/* sweep-flag, 0/1 = clock/c'clock */
+			    p.x, p.y);
 	  }
 	  break;
 	  
 	case (int)S_QUAD:
-	  sprintf (page->point, "Q%.5g,%.5g,%.5g,%.5g ",
-		   pc.x, pc.y, p.x, p.y);
+	  _outbuf_printf (page, "Q%.5g,%.5g,%.5g,%.5g ",
+			  pc.x, pc.y, p.x, p.y);
 	  break;
 	  
 	case (int)S_CUBIC:
-	  sprintf (page->point, "C%.5g,%.5g,%.5g,%.5g,%.5g,%.5g ",
-		   pc.x, pc.y, pd.x, pd.y, p.x, p.y);
+	  _outbuf_printf (page, "C%.5g,%.5g,%.5g,%.5g,%.5g,%.5g ",
+			  pc.x, pc.y, pd.x, pd.y, p.x, p.y);
 	  break;
 	  
 	default:	/* shouldn't happen */
 	  break;
 	}
-      _update_buffer (page);
       
       oldpoint = p;
     }
   
   if (closed)
     {
-      sprintf (page->point, "Z ");
-      _update_buffer (page);
+      _outbuf_puts (page, "Z ");
     }
 }
 
@@ -621,25 +585,22 @@ write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_ca
 	  || drawstate->fgcolor.blue != 0)
 	/* non-black, i.e. non-default */
 	{
-	  sprintf (page->point, "stroke=\"%s\" ",
-		   _libplot_color_to_svg_color (drawstate->fgcolor, 
-						color_buf));
-	  _update_buffer (page);
+	  _outbuf_printf (page, "stroke=\"%s\" ",
+			  _libplot_color_to_svg_color (drawstate->fgcolor,
+						       color_buf));
 	}
       
       /* should use `px' here to specify user units, per the SVG Authoring
 	 Guide, but ImageMagick objects to that */
-      sprintf (page->point, "stroke-width=\"%.5g\" ",
-	       drawstate->line_width);
-      _update_buffer (page);
+      _outbuf_printf (page, "stroke-width=\"%.5g\" ",
+		      drawstate->line_width);
       
       if (need_cap)
 	{
 	  if (drawstate->cap_type != PL_CAP_BUTT) /* i.e. not default */
 	    {
-	      sprintf (page->point, "stroke-linecap=\"%s\" ",
-		       svg_cap_style[drawstate->cap_type]);
-	      _update_buffer (page);
+	      _outbuf_printf (page, "stroke-linecap=\"%s\" ",
+			      svg_cap_style[drawstate->cap_type]);
 	    }
 	}
       
@@ -647,17 +608,15 @@ write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_ca
 	{
 	  if (drawstate->join_type != PL_JOIN_MITER) /* i.e. not default */
 	    {
-	      sprintf (page->point, "stroke-linejoin=\"%s\" ",
-		       svg_join_style[drawstate->join_type]);
-	      _update_buffer (page);
+	      _outbuf_printf (page, "stroke-linejoin=\"%s\" ",
+			      svg_join_style[drawstate->join_type]);
 	    }
 	  
 	  if (drawstate->join_type == PL_JOIN_MITER
 	      && drawstate->miter_limit != PL_DEFAULT_MITER_LIMIT)
 	    {
-	      sprintf (page->point, "stroke-miterlimit=\"%.5g\" ",
-		       drawstate->miter_limit);
-	      _update_buffer (page);
+	      _outbuf_printf (page, "stroke-miterlimit=\"%.5g\" ",
+			      drawstate->miter_limit);
 	    }
 	}
 
@@ -711,23 +670,20 @@ write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_ca
 	      offset = 0.0;	/* true for all builtin line types */
 	    }
 
-	  sprintf (page->point, "stroke-dasharray=\"");
-	  _update_buffer (page);
+	  _outbuf_puts (page, "stroke-dasharray=\"");
 	  for (i = 0; i < num_dashes; i++)
 	    {
-	      sprintf (page->point, "%.5g%s",
-		       dashbuf[i],
-		       i < num_dashes - 1 ? ", " : "\" ");
-	      _update_buffer (page);
+	      _outbuf_printf (page, "%.5g%s",
+			      dashbuf[i],
+			      i < num_dashes - 1 ? ", " : "\" ");
 	    }
 
 	  if (offset != 0.0) /* not default */
 	    {
 	      /* should use `px' here to specify user units, per the SVG
 		 Authoring Guide, but ImageMagick objects to that */
-	      sprintf (page->point, "stroke-dashoffset=\"%.5g\" ",
-		       offset);
-	      _update_buffer (page);
+	      _outbuf_printf (page, "stroke-dashoffset=\"%.5g\" ",
+			      offset);
 	    }
 
 	  if (drawstate->dash_array_in_effect == false)
@@ -741,21 +697,18 @@ write_svg_path_style (plOutbuf *page, const plDrawState *drawstate, bool need_ca
     }
   else
     {
-      sprintf (page->point, "stroke=\"none\" ");
-      _update_buffer (page);
+      _outbuf_puts (page, "stroke=\"none\" ");
     }
 
   if (drawstate->fill_type)
     {
-      sprintf (page->point, "fill=\"%s\" ",
-	       _libplot_color_to_svg_color (drawstate->fillcolor, color_buf));
-      _update_buffer (page);
+      _outbuf_printf (page, "fill=\"%s\" ",
+		      _libplot_color_to_svg_color (drawstate->fillcolor, color_buf));
 
       if (drawstate->fill_rule_type != PL_FILL_ODD_WINDING) /* not default */
 	{
-	  sprintf (page->point, "fill-rule=\"%s\" ",
-		   svg_fill_style[drawstate->fill_rule_type]);
-	  _update_buffer (page);
+	  _outbuf_printf (page, "fill-rule=\"%s\" ",
+			  svg_fill_style[drawstate->fill_rule_type]);
 	}
     }
 }
@@ -32,23 +32,19 @@ static void write_svg_point_style (plOutbuf *page, const plDrawState *drawstate)
 void
 _pl_s_paint_point (S___(Plotter *_plotter))
 {
-  sprintf (_plotter->data->page->point, "<circle ");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "<circle ");
 
   _pl_s_set_matrix (R___(_plotter) identity_matrix); 
 
-  sprintf (_plotter->data->page->point,
-	   "cx=\"%.5g\" cy=\"%.5g\" r=\"%s\" ",
-	   _plotter->drawstate->pos.x,
-	   _plotter->drawstate->pos.y,
-	   "0.5px");		/* diameter = 1 pixel */
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page,
+		  "cx=\"%.5g\" cy=\"%.5g\" r=\"%s\" ",
+		  _plotter->drawstate->pos.x,
+		  _plotter->drawstate->pos.y,
+		  "0.5px");		/* diameter = 1 pixel */
   
   write_svg_point_style (_plotter->data->page, _plotter->drawstate);
 
-  sprintf (_plotter->data->page->point,
-	   "/>\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "/>\n");
 
   return;
 }
@@ -58,10 +54,8 @@ write_svg_point_style (plOutbuf *page, const plDrawState *drawstate)
 {
   char color_buf[8];		/* enough room for "#ffffff", incl. NUL */
 
-  sprintf (page->point, "stroke=\"none\" ");
-  _update_buffer (page);
+  _outbuf_puts (page, "stroke=\"none\" ");
   
-  sprintf (page->point, "fill=\"%s\"",
-	   _libplot_color_to_svg_color (drawstate->fgcolor, color_buf));
-  _update_buffer (page);
+  _outbuf_printf (page, "fill=\"%s\"",
+		  _libplot_color_to_svg_color (drawstate->fgcolor, color_buf));
 }
@@ -117,8 +117,7 @@ _pl_s_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
     }
   *tp = '\0';
   
-  sprintf (_plotter->data->page->point, "<text ");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "<text ");
 
   /* CTM equals CTM_local * CTM_base, if matrix multiplication is defined
      as in PS and libplot. (Which is the opposite of the SVG convention,
@@ -167,15 +166,12 @@ _pl_s_paint_text_string (R___(Plotter *_plotter) const unsigned char *s, int h_j
   write_svg_text_style (_plotter->data->page, _plotter->drawstate, 
 			 h_just, v_just);
 
-  sprintf (_plotter->data->page->point, ">");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, ">");
   
-  sprintf (_plotter->data->page->point, "%s",
-	   (char *)t);
-  _update_buffer (_plotter->data->page);
+  _outbuf_printf (_plotter->data->page, "%s",
+		  (char *)t);
   
-  sprintf (_plotter->data->page->point, "</text>\n");
-  _update_buffer (_plotter->data->page);
+  _outbuf_puts (_plotter->data->page, "</text>\n");
 
   free (t);
 
@@ -243,74 +239,65 @@ write_svg_text_style (plOutbuf *page, const plDrawState *drawstate, int h_just,
   if (css_generic_family)
     {
       if (css_family_is_ps_name)
-	sprintf (page->point, "font-family=\"%s,%s\" ",
-		 css_family, css_generic_family);
+	_outbuf_printf (page, "font-family=\"%s,%s\" ",
+			css_family, css_generic_family);
       else
-	sprintf (page->point, "font-family=\"%s,%s,%s\" ",
-		 ps_name, css_family, css_generic_family);
+	_outbuf_printf (page, "font-family=\"%s,%s,%s\" ",
+			ps_name, css_family, css_generic_family);
     }
   else
     {
       if (css_family_is_ps_name)
-	sprintf (page->point, "font-family=\"%s\" ",
-		 css_family);
+	_outbuf_printf (page, "font-family=\"%s\" ",
+			css_family);
       else
-	sprintf (page->point, "font-family=\"%s,%s\" ",
-		 ps_name, css_family);
+	_outbuf_printf (page, "font-family=\"%s,%s\" ",
+			ps_name, css_family);
     }
-  _update_buffer (page);
   
   if (strcmp (css_style, "normal") != 0) /* not default */
     {
-      sprintf (page->point, "font-style=\"%s\" ",
-	       css_style);
-      _update_buffer (page);
+      _outbuf_printf (page, "font-style=\"%s\" ",
+		      css_style);
     }
 
   if (strcmp (css_weight, "normal") != 0) /* not default */
     {
-      sprintf (page->point, "font-weight=\"%s\" ",
-	       css_weight);
-      _update_buffer (page);
+      _outbuf_printf (page, "font-weight=\"%s\" ",
+		      css_weight);
     }
 
   if (strcmp (css_stretch, "normal") != 0) /* not default */
     {
-      sprintf (page->point, "font-stretch=\"%s\" ",
-	       css_stretch);
-      _update_buffer (page);
+      _outbuf_printf (page, "font-stretch=\"%s\" ",
+		      css_stretch);
     }
 
-  sprintf (page->point, "font-size=\"%.5gpx\" ",
-	   /* see comments above for why we don't simply specify
-	      drawstate->font_size here */
-	   PL_SVG_FONT_SIZE_IN_PX);
-  _update_buffer (page);
+  _outbuf_printf (page, "font-size=\"%.5gpx\" ",
+		  /* see comments above for why we don't simply specify
+		     drawstate->font_size here */
+		  PL_SVG_FONT_SIZE_IN_PX);
 
   if (h_just != PL_JUST_LEFT)	/* not default */
     {
-      sprintf (page->point, "text-anchor=\"%s\" ",
-	       svg_horizontal_alignment_style[h_just]);
-      _update_buffer (page);
+      _outbuf_printf (page, "text-anchor=\"%s\" ",
+		      svg_horizontal_alignment_style[h_just]);
     }
 
   if (v_just != PL_JUST_BASE)	/* not default */
     {
-      sprintf (page->point, "alignment-baseline=\"%s\" ",
-	       svg_vertical_alignment_style[v_just]);
-      _update_buffer (page);
+      _outbuf_printf (page, "alignment-baseline=\"%s\" ",
+		      svg_vertical_alignment_style[v_just]);
     }
 
   /* currently, we never draw character outlines; we only fill */
-  sprintf (page->point, "stroke=\"none\" ");
-  _update_buffer (page);
+  _outbuf_puts (page, "stroke=\"none\" ");
 
   if (drawstate->pen_type)
     /* according to libplot convention, text should be filled, and since
        SVG's default filling is "none", we must say so */
     {
-      sprintf (page->point, "fill=\"%s\" ",
-	       _libplot_color_to_svg_color (drawstate->fgcolor, color_buf));
-      _update_buffer (page);
+      _outbuf_printf (page, "fill=\"%s\" ",
+		      _libplot_color_to_svg_color (drawstate->fgcolor, color_buf));
     }
 }
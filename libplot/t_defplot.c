@@ -155,7 +155,7 @@ _pl_t_initialize (S___(Plotter *_plotter))
   {
     const char* term_type;
     
-    term_type = (const char *)_get_plot_param (_plotter->data, "TERM");
+    term_type = (const char *)_get_plot_param (_plotter->data, PL_PARAM_TERM);
     if (term_type != NULL)
       {
 	if (strncmp (term_type, "xterm", 5) == 0
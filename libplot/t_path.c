@@ -94,14 +94,14 @@ _pl_t_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
 
       /* nominal starting point and ending point for new line segment, in
 	 floating point device coordinates */
-      start.x = XD(_plotter->drawstate->path->segments[i-1].p.x,
-		   _plotter->drawstate->path->segments[i-1].p.y);
-      start.y = YD(_plotter->drawstate->path->segments[i-1].p.x,
-		   _plotter->drawstate->path->segments[i-1].p.y);
-      end.x = XD(_plotter->drawstate->path->segments[i].p.x,
-		 _plotter->drawstate->path->segments[i].p.y);
-      end.y = YD(_plotter->drawstate->path->segments[i].p.x,
-		 _plotter->drawstate->path->segments[i].p.y);
+      start.x = XD(_plotter->drawstate->path->points[i-1].x,
+		   _plotter->drawstate->path->points[i-1].y);
+      start.y = YD(_plotter->drawstate->path->points[i-1].x,
+		   _plotter->drawstate->path->points[i-1].y);
+      end.x = XD(_plotter->drawstate->path->points[i].x,
+		 _plotter->drawstate->path->points[i].y);
+      end.y = YD(_plotter->drawstate->path->points[i].x,
+		 _plotter->drawstate->path->points[i].y);
       same_point = (start.x == end.x && start.y == end.y) ? true : false;
 
       /* clip line segment to rectangular clipping region in device frame */
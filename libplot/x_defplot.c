@@ -152,21 +152,21 @@ _pl_x_initialize (S___(Plotter *_plotter))
   /* initialize certain data members from device driver parameters */
 
   /* if this is NULL, won't be able to open Plotter */
-  _plotter->x_dpy = (Display *)_get_plot_param (_plotter->data, "XDRAWABLE_DISPLAY");
+  _plotter->x_dpy = (Display *)_get_plot_param (_plotter->data, PL_PARAM_XDRAWABLE_DISPLAY);
 
   /* we allow the visual to be NULL, i.e., not set, since we use it only
      for determining the visual class of the colormap (see below); since if
      it's Truecolor, that means we can avoid calling XAllocColor() */
-  _plotter->x_visual = (Visual *)_get_plot_param (_plotter->data, "XDRAWABLE_VISUAL");
+  _plotter->x_visual = (Visual *)_get_plot_param (_plotter->data, PL_PARAM_XDRAWABLE_VISUAL);
 
   /* we allow either or both of the drawables to be NULL, i.e. not set */
-  drawable_p1 = (Drawable *)_get_plot_param (_plotter->data, "XDRAWABLE_DRAWABLE1");
-  drawable_p2 = (Drawable *)_get_plot_param (_plotter->data, "XDRAWABLE_DRAWABLE2");
+  drawable_p1 = (Drawable *)_get_plot_param (_plotter->data, PL_PARAM_XDRAWABLE_DRAWABLE1);
+  drawable_p2 = (Drawable *)_get_plot_param (_plotter->data, PL_PARAM_XDRAWABLE_DRAWABLE2);
   _plotter->x_drawable1 = drawable_p1 ? *drawable_p1 : 0;
   _plotter->x_drawable2 = drawable_p2 ? *drawable_p2 : 0;
 
   /* allow user to specify a non-default colormap */
-  x_cmap_ptr = (Colormap *)_get_plot_param (_plotter->data, "XDRAWABLE_COLORMAP");
+  x_cmap_ptr = (Colormap *)_get_plot_param (_plotter->data, PL_PARAM_XDRAWABLE_COLORMAP);
   if (x_cmap_ptr != NULL)
     /* user-specified colormap */
     {
@@ -111,7 +111,7 @@ _pl_x_begin_page (S___(Plotter *_plotter))
   if (_plotter->x_drawable1 || _plotter->x_drawable2)
     {
       double_buffer_s = 
-	(const char *)_get_plot_param (_plotter->data, "USE_DOUBLE_BUFFERING");
+	(const char *)_get_plot_param (_plotter->data, PL_PARAM_USE_DOUBLE_BUFFERING);
       if (strcmp (double_buffer_s, "yes") == 0
 	  /* backward compatibility: "fast" now means the same as "yes" */
 	  || strcmp (double_buffer_s, "fast") == 0)
@@ -79,6 +79,7 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	bool closed;		/* not currently used */
 	int is_a_rectangle;
 	int i, polyline_len;
+	plPathIterator iter;
 	plPoint p0, p1, pc;
 	XPoint *xarray, local_xarray[MAX_NUM_POINTS_ON_STACK];
 	bool heap_storage;
@@ -92,12 +93,12 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	  break;
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ARC)
 	  /* segment buffer contains a single circular arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use native X rendering to draw the (transformed) circular
                arc */
@@ -107,12 +108,12 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	  }
 
 	if (_plotter->drawstate->path->num_segments == 2
-	    && _plotter->drawstate->path->segments[1].type == S_ELLARC)
+	    && _path_segment_type (_plotter->drawstate->path, 1) == S_ELLARC)
 	  /* segment buffer contains a single elliptic arc, not a polyline */
 	  {
-	    p0 = _plotter->drawstate->path->segments[0].p;
-	    p1 = _plotter->drawstate->path->segments[1].p;
-	    pc = _plotter->drawstate->path->segments[1].pc;
+	    p0 = _plotter->drawstate->path->points[0];
+	    p1 = _plotter->drawstate->path->points[1];
+	    pc = _path_curve (_plotter->drawstate->path, 1)->pc;
 	    
 	    /* use native X rendering to draw the (transformed) elliptic
                arc */
@@ -125,8 +126,8 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	   not an arc */
 
 	if ((_plotter->drawstate->path->num_segments >= 3)/*check for closure*/
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.x == _plotter->drawstate->path->segments[0].p.x)
-	    && (_plotter->drawstate->path->segments[_plotter->drawstate->path->num_segments - 1].p.y == _plotter->drawstate->path->segments[0].p.y))
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].x == _plotter->drawstate->path->points[0].x)
+	    && (_plotter->drawstate->path->points[_plotter->drawstate->path->num_segments - 1].y == _plotter->drawstate->path->points[0].y))
 	  closed = true;
 	else
 	  closed = false;	/* 2-point ones should be open */
@@ -180,13 +181,14 @@ _pl_x_paint_path (S___(Plotter *_plotter))
 	xu_last = 0.0;
 	yu_last = 0.0;
 	identical_user_coordinates = true;
+	_path_iter_start (&iter, _plotter->drawstate->path, 0);
 	for (i = 0; i < _plotter->drawstate->path->num_segments; i++)
 	  {
 	    plPathSegment datapoint;
 	    double xu, yu, xd, yd;
 	    int device_x, device_y;
 	    
-	    datapoint = _plotter->drawstate->path->segments[i];
+	    _path_iter_next (&iter, &datapoint);
 	    xu = datapoint.p.x;
 	    yu = datapoint.p.y;
 	    xd = XD(xu, yu);
@@ -1021,9 +1023,9 @@ _pl_x_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
 
   if (prev_num_segments == 0 && 
       _plotter->drawstate->path->num_segments == 2
-      && _plotter->drawstate->path->segments[0].type == S_MOVETO
-      && (_plotter->drawstate->path->segments[1].type == S_ARC
-	  || _plotter->drawstate->path->segments[1].type == S_ELLARC))
+      && _path_segment_type (_plotter->drawstate->path, 0) == S_MOVETO
+      && (_path_segment_type (_plotter->drawstate->path, 1) == S_ARC
+	  || _path_segment_type (_plotter->drawstate->path, 1) == S_ELLARC))
     return;
 
   if (prev_num_segments == 0)
@@ -1053,10 +1055,10 @@ _pl_x_maybe_prepaint_segments (R___(Plotter *_plotter) int prev_num_segments)
 
       /* starting and ending points for zero-width line segment: (xu,yu)
 	 and (x,y) respectively */
-      xu = _plotter->drawstate->path->segments[i-1].p.x;
-      yu = _plotter->drawstate->path->segments[i-1].p.y;
-      x = _plotter->drawstate->path->segments[i].p.x;
-      y = _plotter->drawstate->path->segments[i].p.y;
+      xu = _plotter->drawstate->path->points[i-1].x;
+      yu = _plotter->drawstate->path->points[i-1].y;
+      x = _plotter->drawstate->path->points[i].x;
+      y = _plotter->drawstate->path->points[i].y;
   
       /* convert to integer X11 coordinates */
       xd = XD(xu, yu);
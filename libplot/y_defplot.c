@@ -198,7 +198,7 @@ _pl_y_initialize (S___(Plotter *_plotter))
     const char *flush_s;
 
     flush_s = (const char *)_get_plot_param (_plotter->data,
-					     "X_AUTO_FLUSH");
+					     PL_PARAM_X_AUTO_FLUSH);
     if (strcasecmp (flush_s, "no") == 0)
       _plotter->y_auto_flush = false;
     else
@@ -210,7 +210,7 @@ _pl_y_initialize (S___(Plotter *_plotter))
     const char *no_input_s;
 
     no_input_s = (const char *)_get_plot_param (_plotter->data,
-					        "NO_INPUT");
+					        PL_PARAM_NO_INPUT);
     if (strcasecmp (no_input_s, "yes") == 0)
       _plotter->y_no_input = true;
     else
@@ -222,7 +222,7 @@ _pl_y_initialize (S___(Plotter *_plotter))
     const char *vanish_s;
 
     vanish_s = (const char *)_get_plot_param (_plotter->data,
-					      "VANISH_ON_DELETE");
+					      PL_PARAM_VANISH_ON_DELETE);
     if (strcasecmp (vanish_s, "yes") == 0)
       _plotter->y_vanish_on_delete = true;
     else
@@ -234,7 +234,7 @@ _pl_y_initialize (S___(Plotter *_plotter))
     const char *wait_s;
 
     wait_s = (const char *)_get_plot_param (_plotter->data,
-					    "WAIT_ON_DELETE");
+					    PL_PARAM_WAIT_ON_DELETE);
     if (strcasecmp (wait_s, "yes") == 0)
       _plotter->y_wait_on_delete = true;
     else
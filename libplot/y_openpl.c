@@ -211,7 +211,7 @@ _pl_y_begin_page (S___(Plotter *_plotter))
 
   /* take argument of the "-display" option from the DISPLAY parameter */
   {
-    display_s = (char *)_get_plot_param (_plotter->data, "DISPLAY");
+    display_s = (char *)_get_plot_param (_plotter->data, PL_PARAM_DISPLAY);
     if (display_s == NULL || *display_s == '\0')
       {
 	_plotter->error (R___(_plotter)
@@ -226,7 +226,7 @@ _pl_y_begin_page (S___(Plotter *_plotter))
      otherwise size will be taken from Xplot.geometry.  Fallback size is
      specified at head of this file. */
   {
-    bitmap_size_s = (char *)_get_plot_param (_plotter->data, "BITMAPSIZE");
+    bitmap_size_s = (char *)_get_plot_param (_plotter->data, PL_PARAM_BITMAPSIZE);
     if (bitmap_size_s && _bitmap_size_ok (bitmap_size_s))
       {
 	fake_argv[fake_argc++] = (String)"-geometry";
@@ -237,10 +237,10 @@ _pl_y_begin_page (S___(Plotter *_plotter))
   /* Take argument of "-bg" option from BG_COLOR parameter, if set;
      otherwise use default color (white). */
   {
-    bg_color_s = (char *)_get_plot_param (_plotter->data, "BG_COLOR");
+    bg_color_s = (char *)_get_plot_param (_plotter->data, PL_PARAM_BG_COLOR);
     if (bg_color_s)
       {
-	if (_string_to_color (bg_color_s, &color, _plotter->data->color_name_cache))
+	if (_string_to_color (bg_color_s, &color))
 	  /* color is in our database */
 	  {
 	    if (_plotter->data->emulate_color)
@@ -299,7 +299,7 @@ _pl_y_begin_page (S___(Plotter *_plotter))
 		   &fake_argc, fake_argv);
   if (_plotter->x_dpy == (Display *)NULL)
     {
-      display_s = (char *)_get_plot_param (_plotter->data, "DISPLAY");
+      display_s = (char *)_get_plot_param (_plotter->data, PL_PARAM_DISPLAY);
       if (display_s == NULL)	/* shouldn't happen */
 	_plotter->error (R___(_plotter)
 			 "the X Window System display could not be opened, as it is null");
@@ -434,7 +434,7 @@ _pl_y_begin_page (S___(Plotter *_plotter))
   /* determine whether to use double buffering */
   _plotter->x_double_buffering = X_DBL_BUF_NONE;
   double_buffer_s = (const char *)_get_plot_param (_plotter->data, 
-						   "USE_DOUBLE_BUFFERING");
+						   PL_PARAM_USE_DOUBLE_BUFFERING);
 
   /* backward compatibility: "fast" now means the same as "yes" */
   if (strcmp (double_buffer_s, "fast") == 0)
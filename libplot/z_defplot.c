@@ -24,6 +24,9 @@
 #include "sys-defines.h"
 #include "extern.h"
 
+#include <png.h>
+#include <zlib.h>
+
 #ifndef LIBPLOTTER
 /* In libplot, this is the initialization for the function-pointer part of
    a PNGPlotter struct.  It is the same as for a BitmapPlotter, except for
@@ -84,6 +87,9 @@ _pl_z_initialize (S___(Plotter *_plotter))
   _plotter->z_transparent_color.red = 255; /* dummy */
   _plotter->z_transparent_color.green = 255; /* dummy */
   _plotter->z_transparent_color.blue = 255; /* dummy */
+  _plotter->z_compression_level = -1; /* i.e. zlib's default */
+  _plotter->z_compression_strategy = -1; /* i.e. libpng's default */
+  _plotter->z_filter = -1;	/* i.e. libpng's default */
 
   /* initialize certain data members from device driver parameters */
       
@@ -91,7 +97,7 @@ _pl_z_initialize (S___(Plotter *_plotter))
   {
     const char *interlace_s;
 
-    interlace_s = (const char *)_get_plot_param (_plotter->data, "INTERLACE" );
+    interlace_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_INTERLACE);
     if (strcasecmp (interlace_s, "yes") == 0)
       _plotter->z_interlace = true;
   }
@@ -101,15 +107,65 @@ _pl_z_initialize (S___(Plotter *_plotter))
     const char *transparent_name_s;
     plColor color;
 
-    transparent_name_s = (const char *)_get_plot_param (_plotter->data, "TRANSPARENT_COLOR");
+    transparent_name_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_TRANSPARENT_COLOR);
     if (transparent_name_s 
-	&& _string_to_color (transparent_name_s, &color, _plotter->data->color_name_cache))
+	&& _string_to_color (transparent_name_s, &color))
       /* have 24-bit RGB */
       {
 	_plotter->z_transparent = true;
 	_plotter->z_transparent_color = color;
       }
   }
+
+  /* zlib compression level (0..9), if not the default */
+  {
+    const char *level_s;
+    int level;
+
+    level_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PNG_COMPRESSION_LEVEL);
+    if (sscanf (level_s, "%d", &level) == 1 && level >= 0 && level <= 9)
+      _plotter->z_compression_level = level;
+  }
+
+  /* zlib compression strategy, if not the default */
+  {
+    const char *strategy_s;
+
+    strategy_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PNG_STRATEGY);
+    if (strcasecmp (strategy_s, "filtered") == 0)
+      _plotter->z_compression_strategy = Z_FILTERED;
+    else if (strcasecmp (strategy_s, "huffman") == 0)
+      _plotter->z_compression_strategy = Z_HUFFMAN_ONLY;
+#ifdef Z_RLE
+    else if (strcasecmp (strategy_s, "rle") == 0)
+      _plotter->z_compression_strategy = Z_RLE;
+#endif
+#ifdef Z_FIXED
+    else if (strcasecmp (strategy_s, "fixed") == 0)
+      _plotter->z_compression_strategy = Z_FIXED;
+#endif
+    else if (strcasecmp (strategy_s, "plain") == 0)
+      _plotter->z_compression_strategy = Z_DEFAULT_STRATEGY;
+  }
+
+  /* row filter(s) to try, if not the default */
+  {
+    const char *filter_s;
+
+    filter_s = (const char *)_get_plot_param (_plotter->data, PL_PARAM_PNG_FILTER);
+    if (strcasecmp (filter_s, "none") == 0)
+      _plotter->z_filter = PNG_FILTER_NONE;
+    else if (strcasecmp (filter_s, "sub") == 0)
+      _plotter->z_filter = PNG_FILTER_SUB;
+    else if (strcasecmp (filter_s, "up") == 0)
+      _plotter->z_filter = PNG_FILTER_UP;
+    else if (strcasecmp (filter_s, "average") == 0)
+      _plotter->z_filter = PNG_FILTER_AVG;
+    else if (strcasecmp (filter_s, "paeth") == 0)
+      _plotter->z_filter = PNG_FILTER_PAETH;
+    else if (strcasecmp (filter_s, "all") == 0)
+      _plotter->z_filter = PNG_ALL_FILTERS;
+  }
 }
 
 /* The private `terminate' method, which is invoked when a Plotter is
@@ -68,8 +68,14 @@ extern pthread_mutex_t _message_mutex;
 static const char _short_months[12][4] = 
 { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 
+/* hash a packed RGBA32 pixel (less its alpha), for the table mapping the
+   pixels of a palette image to palette indices */
+#define COLOR_HASH_SIZE 1024
+#define COLOR_HASH(rgb) \
+  ((int)((((unsigned long)(rgb) * 0x9e3779b1UL) & 0xffffffffUL) >> 16) \
+   & (COLOR_HASH_SIZE - 1))
+
 /* forward references */
-static int _image_type (miPixel **pixmap, int width, int height);
 static void _our_error_fn_stdio (png_struct *png_ptr, const char *data);
 static void _our_warn_fn_stdio (png_struct *png_ptr, const char *data);
 #ifdef LIBPLOTTER
@@ -82,9 +88,15 @@ static void _our_write_fn (png_struct *png_ptr, png_byte *data, png_size_t lengt
 int
 _pl_z_maybe_output_image (S___(Plotter *_plotter))
 {
-  miPixel **pixmap;		/* pixmap in miCanvas */
+  const miPackedPixmap *packed;	/* packed pixmap in miCanvas */
   int width, height;
   int image_type, bit_depth, color_type;
+  int num_colors;		/* number of colors, if palette image */
+  png_color palette[256];
+  int hash_key[COLOR_HASH_SIZE]; /* hash table mapping pixels to indices */
+  png_byte hash_index[COLOR_HASH_SIZE];
+  png_byte *index_rows = (png_byte *)NULL; /* rows of indices, if palette */
+  int index_rowbytes = 0;
   png_struct *png_ptr;
   png_info *info_ptr;
   char time_buf[40], software_buf[64];
@@ -113,6 +125,119 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   if (_plotter->data->page_number != 1)
     return 0;
 
+  /* extract packed pixmap (rows of RGBA32 pixels) from miCanvas */
+  packed = ((miCanvas *)(_plotter->b_canvas))->packed;
+
+  /* What is best image type that can be used?  0/1/2/3 =
+     mono/gray/rgb/palette.  The first three were distinguished as the
+     page was drawn (see b_openpl.c), and the colors on the page were
+     listed, if there are no more than 256 of them.  If so, and the page
+     wasn't drawn with anti-aliasing (which blends them), a color page is
+     written as a palette image. */
+  width = _plotter->b_xn;
+  height = _plotter->b_yn;
+  image_type = _plotter->b_color_class;
+  num_colors = _plotter->b_num_painted_colors;
+  if (image_type == 2 && num_colors > 0 && !_plotter->b_antialias)
+    image_type = 3;		/* palette */
+  switch (image_type)
+    {
+    case 0:			/* mono */
+      bit_depth = 1;
+      color_type = PNG_COLOR_TYPE_GRAY;
+      break;
+    case 1:			/* gray */
+      bit_depth = 8;
+      color_type = PNG_COLOR_TYPE_GRAY;
+      break;
+    case 3:			/* palette */
+      bit_depth = (num_colors <= 2 ? 1 : num_colors <= 4 ? 2 
+		   : num_colors <= 16 ? 4 : 8);
+      color_type = PNG_COLOR_TYPE_PALETTE;
+      break;
+    case 2:			/* rgb */
+    default:
+      bit_depth = 8;
+      color_type = PNG_COLOR_TYPE_RGB;
+      break;
+    }
+
+  /* If palette image, build the palette, and convert the canvas's packed
+     RGBA32 pixels to rows of palette indices, using a hash table that maps
+     pixels to indices.  This is done before anything is written, since
+     every pixel should have one of the colors listed as the page was
+     drawn; but if a pixel doesn't, the page is written as an RGB image
+     instead. */
+  if (image_type == 3)
+    {
+      int per_byte = 8 / bit_depth;
+      bool missing = false;
+      int i, j;
+
+      for (i = 0; i < COLOR_HASH_SIZE; i++)
+	hash_key[i] = -1;
+      for (i = 0; i < num_colors; i++)
+	{
+	  int rgb = _plotter->b_painted_colors[i];
+	  int key, h;
+	  
+	  palette[i].red = (png_byte)((rgb >> 16) & 0xff);
+	  palette[i].green = (png_byte)((rgb >> 8) & 0xff);
+	  palette[i].blue = (png_byte)(rgb & 0xff);
+	  key = (int)(MI_RGBA32(palette[i].red, palette[i].green, 
+				palette[i].blue, 0));
+	  for (h = COLOR_HASH(key); hash_key[h] >= 0; 
+	       h = (h + 1) & (COLOR_HASH_SIZE - 1))
+	    ;
+	  hash_key[h] = key;
+	  hash_index[h] = (png_byte)i;
+	}
+
+      index_rowbytes = (width + per_byte - 1) / per_byte;
+      index_rows = 
+	(png_byte *)_pl_xcalloc ((size_t)height * index_rowbytes, 
+				 sizeof(png_byte));
+      for (j = 0; j < height && !missing; j++)
+	{
+	  const miRGBA32 *row = MI_PACKED_RGBA32_ROW(packed, j);
+	  png_byte *ptr = index_rows + (size_t)j * index_rowbytes;
+	  int last_key = -1, index = 0, key, h;
+
+	  for (i = 0; i < width; i++)
+	    {
+	      /* look up pixel's index (usually same as last one) */
+	      key = (int)(row[i] & 0xffffff);
+	      if (key != last_key)
+		{
+		  for (h = COLOR_HASH(key); 
+		       hash_key[h] >= 0 && hash_key[h] != key;
+		       h = (h + 1) & (COLOR_HASH_SIZE - 1))
+		    ;
+		  if (hash_key[h] != key)
+		    {
+		      missing = true;
+		      break;
+		    }
+		  index = hash_index[h];
+		  last_key = key;
+		}
+	      ptr[i / per_byte] |= (png_byte)
+		(index << (8 - bit_depth * (i % per_byte + 1)));
+	    }
+	}
+
+      if (missing)
+	{
+	  _plotter->warning (R___(_plotter) 
+			     "a color on the page is missing from the PNG palette, so writing an RGB image");
+	  free (index_rows);
+	  index_rows = (png_byte *)NULL;
+	  image_type = 2;
+	  bit_depth = 8;
+	  color_type = PNG_COLOR_TYPE_RGB;
+	}
+    }
+
   /* work out libpng error handling (i.e. callback functions and data) */
 #ifdef LIBPLOTTER
   if (errorstream)
@@ -153,13 +278,17 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 				     error_ptr, 
 				     error_fn_ptr, warn_fn_ptr);
   if (png_ptr == (png_struct *)NULL)
-    return -1;
+    {
+      free (index_rows);
+      return -1;
+    }
 
   /* allocate/initialize image information data */
   info_ptr = png_create_info_struct (png_ptr);
   if (info_ptr == (png_info *)NULL)
     {
       png_destroy_write_struct (&png_ptr, (png_info **)NULL);
+      free (index_rows);
       return -1;
     }
 
@@ -167,6 +296,7 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   if (setjmp (png_jmpbuf (png_ptr)))
     {
       png_destroy_write_struct (&png_ptr, (png_info **)NULL);
+      free (index_rows);
       return -1;
     }
   
@@ -188,30 +318,6 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
     png_init_io (png_ptr, fp);
 #endif /* not LIBPLOTTER */
 
-  /* extract pixmap (2D array of miPixels) from miCanvas */
-  pixmap = ((miCanvas *)(_plotter->b_canvas))->drawable->pixmap;
-
-  /* what is best image type that can be used?  0/1/2 = mono/gray/rgb */
-  width = _plotter->b_xn;
-  height = _plotter->b_yn;
-  image_type = _image_type (pixmap, width, height);
-  switch (image_type)
-    {
-    case 0:			/* mono */
-      bit_depth = 1;
-      color_type = PNG_COLOR_TYPE_GRAY;
-      break;
-    case 1:			/* gray */
-      bit_depth = 8;
-      color_type = PNG_COLOR_TYPE_GRAY;
-      break;
-    case 2:			/* rgb */
-    default:
-      bit_depth = 8;
-      color_type = PNG_COLOR_TYPE_RGB;
-      break;
-    }
-
   /* Set image information in file header.  Width and height are up to
      2^31, bit_depth is one of 1, 2, 4, 8, or 16, but valid values also
      depend on the color_type selected. color_type is one of
@@ -227,28 +333,30 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 		                      : PNG_INTERLACE_NONE,
 		PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
   
+  /* if palette image, set the palette (built above) */
+  if (image_type == 3)
+    png_set_PLTE (png_ptr, info_ptr, palette, num_colors);
+
   /* set transparent color (if user specified one) */
   if (_plotter->z_transparent)
     {
       plColor transparent_color = _plotter->z_transparent_color;
       bool transparent_color_ok = true;
       png_color_16 trans_value;
+      png_byte trans_alpha[256];
+      int num_trans = 0;
       
       switch (image_type)
 	{
 	case 0:			/* mono */
-	  if ((transparent_color.red != 0 && transparent_color.red != 0xffff)
-	      || 
-	      (transparent_color.green != 0 && transparent_color.green != 0xffff)
-	      || 
-	      (transparent_color.blue != 0 && transparent_color.blue != 0xffff)
+	  if ((transparent_color.red != 0 && transparent_color.red != 0xff)
 	      ||
 	      (transparent_color.red != transparent_color.green
 	       || transparent_color.red != transparent_color.blue))
 	    /* user-specified transparent color isn't monochrome */
 	    transparent_color_ok = false;
 	  else
-	    trans_value.gray = (png_uint_16)transparent_color.red;
+	    trans_value.gray = (png_uint_16)(transparent_color.red ? 1 : 0);
 	  break;
 	case 1:			/* gray */
 	  if (transparent_color.red != transparent_color.green
@@ -258,6 +366,23 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 	  else
 	    trans_value.gray = (png_uint_16)transparent_color.red;
 	  break;
+	case 3:			/* palette */
+	  /* transparency is an alpha value for each palette index, up to
+	     and including that of the transparent color */
+	  transparent_color_ok = false;
+	  for (num_trans = 0; num_trans < num_colors; num_trans++)
+	    {
+	      trans_alpha[num_trans] = (png_byte)0xff;
+	      if (palette[num_trans].red == transparent_color.red
+		  && palette[num_trans].green == transparent_color.green
+		  && palette[num_trans].blue == transparent_color.blue)
+		{
+		  trans_alpha[num_trans++] = (png_byte)0;
+		  transparent_color_ok = true;
+		  break;
+		}
+	    }
+	  break;
 	case 2:			/* rgb */
 	default:
 	  trans_value.red = (png_uint_16)transparent_color.red;
@@ -266,9 +391,24 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 	  break;
 	}
       if (transparent_color_ok)
-	png_set_tRNS (png_ptr, info_ptr, (png_byte *)NULL, 1, &trans_value);
+	{
+	  if (image_type == 3)
+	    png_set_tRNS (png_ptr, info_ptr, trans_alpha, num_trans, 
+			  (png_color_16 *)NULL);
+	  else
+	    png_set_tRNS (png_ptr, info_ptr, (png_byte *)NULL, 1, &trans_value);
+	}
     }
 
+  /* use user-specified zlib compression level and strategy, and row
+     filters, if any (see z_defplot.c) */
+  if (_plotter->z_compression_level >= 0)
+    png_set_compression_level (png_ptr, _plotter->z_compression_level);
+  if (_plotter->z_compression_strategy >= 0)
+    png_set_compression_strategy (png_ptr, _plotter->z_compression_strategy);
+  if (_plotter->z_filter >= 0)
+    png_set_filter (png_ptr, PNG_FILTER_TYPE_BASE, _plotter->z_filter);
+
   /* add some comments to file header */
   text_ptr[0].key = (char *)"Title";
   text_ptr[0].text = (char *)"PNG plot";
@@ -296,26 +436,18 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   
   /* Write out image data, a row at a time; support multiple passes over
      image if interlacing.  We don't simply call png_write_image() because
-     the image in the miCanvas's pixmap is a 2-D array of miPixels, and
-     sizeof(miPixel) > 4 is possible.  Instead we copy each miPixel in a
-     row into a local row buffer, and write out the row buffer. */
+     the image in the miCanvas's pixmap consists of packed RGBA32 pixels,
+     and may be monochrome or grayscale.  Instead we convert each row of
+     pixels into a local row buffer, and write out the row buffer.  (A
+     palette image's rows were converted above.) */
   {
     png_byte *rowbuf;
     int num_passes, pass;
 
-    switch (image_type)
-      {
-      case 0:			/* mono */
-	rowbuf = (png_byte *)_pl_xmalloc(((width + 7)/8) * sizeof(png_byte));
-	break;
-      case 1:			/* gray */
-	rowbuf = (png_byte *)_pl_xmalloc(width * sizeof(png_byte));	
-	break;
-      case 2:			/* rgb */
-      default:
-	rowbuf = (png_byte *)_pl_xmalloc(3 * width * sizeof(png_byte));
-	break;
-      }
+    if (image_type == 2)
+      rowbuf = (png_byte *)_pl_xmalloc(3 * width * sizeof(png_byte));
+    else
+      rowbuf = (png_byte *)_pl_xmalloc(width * sizeof(png_byte));
 
     if (_plotter->z_interlace)
       /* turn on interlace handling; if interlacing, need >1 pass over image */
@@ -329,43 +461,44 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
 
 	for (j = 0; j < height; j++)
 	  {
-	    png_byte *ptr;
+	    const miRGBA32 *row = MI_PACKED_RGBA32_ROW(packed, j);
+	    png_byte *ptr = rowbuf, *out = rowbuf;
 
 	    /* fill row buffer with 3 bytes per miPixel (RGB), or 1 byte
-	       (gray), or 1 bit (mono) */
-	    ptr = rowbuf;
-	    for (i = 0; i < width; i++)
+	       (gray), or 1 bit (mono); or use row of palette indices */
+	    switch (image_type)
 	      {
-		switch (image_type)
+	      case 0:		/* mono */
+		memset (rowbuf, 0, (width + 7) / 8);
+		for (i = 0; i < width; i++)
+		  if (MI_RGBA32_COMPONENT(row[i], 0)) /* white pixel */
+		    ptr[i / 8] |= (png_byte)(1 << (7 - (i % 8)));
+		break;
+	      case 1:		/* gray */
+		for (i = 0; i < width; i++)
+		  *ptr++ = (png_byte)MI_RGBA32_COMPONENT(row[i], 0);
+		break;
+	      case 3:		/* palette */
+		out = index_rows + (size_t)j * index_rowbytes;
+		break;
+	      case 2:		/* rgb */
+	      default:
+		for (i = 0; i < width; i++)
 		  {
-		  case 0:	/* mono */
-		    if (i % 8 == 0)
-		      {
-			if (i != 0)
-			  ptr++;
-			*ptr = (png_byte)0;
-		      }
-		    if (pixmap[j][i].u.rgb[0]) /* white pixel */
-		      *ptr |= (1 << (7 - (i % 8)));
-		    break;
-		  case 1:	/* gray */
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[0];
-		    break;
-		  case 2:	/* rgb */
-		  default:
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[0];
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[1];
-		    *ptr++ = (png_byte)pixmap[j][i].u.rgb[2];
-		    break;
+		    *ptr++ = (png_byte)MI_RGBA32_COMPONENT(row[i], 0);
+		    *ptr++ = (png_byte)MI_RGBA32_COMPONENT(row[i], 1);
+		    *ptr++ = (png_byte)MI_RGBA32_COMPONENT(row[i], 2);
 		  }
+		break;
 	      }
 	    
 	    /* write out row buffer */
-	    png_write_rows (png_ptr, &rowbuf, 1);
+	    png_write_rows (png_ptr, &out, 1);
 	  }
       }
 
     free (rowbuf);
+    free (index_rows);
   }
 
   /* write out PNG file trailer (could add more comments here) */
@@ -377,49 +510,6 @@ _pl_z_maybe_output_image (S___(Plotter *_plotter))
   return true;
 }
 
-/* return best type for writing an image (0=mono, 1=grey, 2=color) */
-static int
-_image_type (miPixel **pixmap, int width, int height)
-{
-  int i, j;
-  int type = 0;			/* default is mono */
-  
-  for (j = 0; j < height; j++)
-    for (i = 0; i < width; i++)
-      {
-	unsigned char red, green, blue;
-	
-	red = pixmap[j][i].u.rgb[0];
-	green = pixmap[j][i].u.rgb[1];
-	blue = pixmap[j][i].u.rgb[2];
-	if (type == 0)		/* up to now, all pixels are black or white */
-	  {
-	    if (! ((red == (unsigned char)0 && green == (unsigned char)0
-		    && blue == (unsigned char)0)
-		   || (red == (unsigned char)255 && green == (unsigned char)255
-		    && blue == (unsigned char)255)))
-	      {
-		if (red == green && red == blue)
-		  type = 1;	/* need grey */
-		else
-		  {
-		    type = 2;	/* need color */
-		    return type;
-		  }
-	      }
-	  }
-	else if (type == 1)
-	  {
-	    if (red != green || red != blue)
-	      {
-		type = 2;	/* need color */
-		return type;
-	      }
-	  }
-      }
-  return type;
-}
-
 /* custom error and warning handlers (for stdio) */
 static void 
 _our_error_fn_stdio (png_struct *png_ptr, const char *data)
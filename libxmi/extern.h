@@ -50,6 +50,13 @@
 #define miFreeStorage _miFreeStorage
 #define miQuickSortSpansY _miQuickSortSpansY
 #define miUniquifyPaintedSet _miUniquifyPaintedSet
+#define miPaintSpansImmediately _miPaintSpansImmediately
+#define miRecordDrawingOp _miRecordDrawingOp
+#define miDeleteDeferredOps _miDeleteDeferredOps
+#define miDeleteLineArcCache _miDeleteLineArcCache
+#define miAllocSpanStorage _miAllocSpanStorage
+#define miFreeSpanStorage _miFreeSpanStorage
+#define miAccumEllipseCacheStats _miAccumEllipseCacheStats
 #define miWideDash _miWideDash
 #define miStepDash _miStepDash
 #define miWideLine _miWideLine
@@ -0,0 +1,1142 @@
+/* This file is part of the GNU plotutils package.  Copyright (C) 2026,
+   Free Software Foundation, Inc.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* This file defines libxmi's miCoverageSet class, and the anti-aliased
+   drawing functions that add spans to it (see xmi.h).
+
+   Every drawing function works in the same way: it constructs a path (a
+   list of closed contours, in floating-point device coordinates), and
+   scan-converts it.  A wide polyline, for example, becomes a list of
+   quadrilaterals (one per segment), together with polygons for its joins
+   and caps.  They are all oriented counterclockwise, so scan-converting
+   them with the nonzero winding number rule yields their union.
+
+   Scan conversion is done by the standard active edge list algorithm,
+   applied to MI_AA_SUBSCANLINES sub-scanlines per row of pixels.  Along
+   each sub-scanline, the intervals that are inside the path are computed
+   exactly, and accumulated: partially covered pixels at the ends of each
+   interval are added to one array, and the run of fully covered pixels in
+   between is recorded in a second array, as a pair of differences.  At
+   the end of each row, a single pass over the two arrays yields the
+   coverage of each pixel. */
+
+#include "sys-defines.h"
+#include "extern.h"
+
+#include "xmi.h"
+#include "mi_gc.h"
+#include "mi_api.h"
+
+/* maximum distance, in pixels, between a flattened arc and the true arc */
+#define MI_AA_FLATNESS 0.1
+
+/* minimum number of segments in a flattened circle (or ellipse) */
+#define MI_AA_MIN_CIRCLE_SEGMENTS 8
+
+/* a growable list of points */
+typedef struct
+{
+  miDoublePoint *points;
+  int npoints;
+  int size;
+} miAAPointList;
+
+/* a path: a list of closed contours, whose vertices are stored
+   consecutively */
+typedef struct
+{
+  miAAPointList vertices;
+  int *counts;			/* number of vertices in each contour */
+  int ncontours;
+  int counts_size;
+  int start;			/* index of first vertex of current contour */
+} miAAPath;
+
+/* an edge of a path, directed downward (in the direction of increasing y) */
+typedef struct
+{
+  double x0, y0;		/* upper endpoint */
+  double y1;			/* y coordinate of lower endpoint */
+  double dxdy;			/* inverse slope */
+  int dir;			/* +1 if contour runs downward, -1 if up */
+} miAAEdge;
+
+/* a point at which a sub-scanline crosses an edge */
+typedef struct
+{
+  double x;
+  int dir;
+  int edge;			/* index of edge */
+} miAACrossing;
+
+/* a span, as stored in a miCoverageSet */
+typedef struct
+{
+  miPixel pixel;
+  int x, y;			/* leftmost pixel */
+  unsigned int width;
+  int offset;			/* offset of coverage values in buffer */
+} miAASpan;
+
+struct lib_miCoverageSet
+{
+  unsigned int width, height;	/* clipping rectangle */
+
+  miAASpan *spans;		/* spans, in order of addition */
+  int nspans;
+  int spans_size;
+  unsigned char *coverage;	/* coverage values of all spans */
+  int ncoverage;
+  int coverage_size;
+  miCoverageSpan *public_spans;	/* as returned by miGetCoverageSpans() */
+  int public_spans_size;
+
+  /* scratch storage, reused from one drawing operation to the next */
+  miAAPath path;		/* path being constructed */
+  miAAPointList flattened;	/* a flattened arc */
+  miAAPointList polyline;	/* a polyline, with duplicate points removed */
+  miAAPointList dash;		/* a single dash of a dashed polyline */
+  miAAEdge *edges;
+  int *active;			/* indices of edges in active edge list */
+  miAACrossing *crossings;
+  int edges_size;		/* size of each of preceding three arrays */
+  double *area;			/* partial coverage, indexed by x */
+  double *delta;		/* differences of full coverage, ditto */
+};
+
+/* forward references */
+static int miAAArcSegments (double radius, double range);
+static int miAACompareCrossings (const void *a, const void *b);
+static int miAACompareEdges (const void *a, const void *b);
+static void * miAAGrow (void *p, int *size, int needed, size_t eltsize);
+static void miAAAddInterval (miCoverageSet *coverageSet, double xleft, double xright, int *xlo, int *xhi);
+static void miAAAddPoint (miAAPointList *list, double x, double y);
+static void miAABeginContour (miAAPath *path);
+static void miAACap (miAAPath *path, int capStyle, double hw, miDoublePoint v, double ux, double uy);
+static void miAADisk (miAAPath *path, double x, double y, double radius);
+static void miAAEmitRow (miCoverageSet *coverageSet, miPixel pixel, int y, int xlo, int xhi);
+static void miAAEndContour (miAAPath *path, bool orient);
+static void miAAFlattenArc (miAAPointList *list, const miDoubleArc *arc, bool *full);
+static void miAAJoin (miAAPath *path, const miGC *pGC, double hw, miDoublePoint a, miDoublePoint v, miDoublePoint b);
+static void miAAQuad (miAAPath *path, double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3);
+static void miAARasterizePath (miCoverageSet *coverageSet, miPixel pixel, bool winding);
+static void miAAStrokeLines (miCoverageSet *coverageSet, const miGC *pGC, double hw, int npts, const miDoublePoint *pPts);
+static void miAAStrokePolyline (miAAPath *path, const miGC *pGC, double hw, int npts, const miDoublePoint *pts, bool closed);
+
+/* Ctor/dtor for the miCoverageSet class. */
+
+miCoverageSet *
+miNewCoverageSet (unsigned int width, unsigned int height)
+{
+  miCoverageSet *coverageSet;
+  unsigned int i;
+
+  coverageSet = (miCoverageSet *)mi_xmalloc (sizeof (miCoverageSet));
+  coverageSet->width = width;
+  coverageSet->height = height;
+
+  coverageSet->spans = (miAASpan *)NULL;
+  coverageSet->nspans = 0;
+  coverageSet->spans_size = 0;
+  coverageSet->coverage = (unsigned char *)NULL;
+  coverageSet->ncoverage = 0;
+  coverageSet->coverage_size = 0;
+  coverageSet->public_spans = (miCoverageSpan *)NULL;
+  coverageSet->public_spans_size = 0;
+
+  coverageSet->path.vertices.points = (miDoublePoint *)NULL;
+  coverageSet->path.vertices.npoints = 0;
+  coverageSet->path.vertices.size = 0;
+  coverageSet->path.counts = (int *)NULL;
+  coverageSet->path.ncontours = 0;
+  coverageSet->path.counts_size = 0;
+  coverageSet->path.start = 0;
+  coverageSet->flattened = coverageSet->path.vertices;
+  coverageSet->polyline = coverageSet->path.vertices;
+  coverageSet->dash = coverageSet->path.vertices;
+  coverageSet->edges = (miAAEdge *)NULL;
+  coverageSet->active = (int *)NULL;
+  coverageSet->crossings = (miAACrossing *)NULL;
+  coverageSet->edges_size = 0;
+
+  /* each row is accumulated in arrays of length width+2, since an interval
+     may end at x = width, and a difference may be recorded just past it */
+  coverageSet->area = (double *)mi_xmalloc ((width + 2) * sizeof(double));
+  coverageSet->delta = (double *)mi_xmalloc ((width + 2) * sizeof(double));
+  for (i = 0; i < width + 2; i++)
+    {
+      coverageSet->area[i] = 0.0;
+      coverageSet->delta[i] = 0.0;
+    }
+
+  return coverageSet;
+}
+
+void
+miDeleteCoverageSet (miCoverageSet *coverageSet)
+{
+  if (coverageSet == (miCoverageSet *)NULL)
+    return;
+
+  free (coverageSet->spans);
+  free (coverageSet->coverage);
+  free (coverageSet->public_spans);
+  free (coverageSet->path.vertices.points);
+  free (coverageSet->path.counts);
+  free (coverageSet->flattened.points);
+  free (coverageSet->polyline.points);
+  free (coverageSet->dash.points);
+  free (coverageSet->edges);
+  free (coverageSet->active);
+  free (coverageSet->crossings);
+  free (coverageSet->area);
+  free (coverageSet->delta);
+  free (coverageSet);
+}
+
+/* Remove all spans from a miCoverageSet; storage is retained for reuse. */
+void
+miClearCoverageSet (miCoverageSet *coverageSet)
+{
+  if (coverageSet == (miCoverageSet *)NULL)
+    return;
+
+  coverageSet->nspans = 0;
+  coverageSet->ncoverage = 0;
+}
+
+/* Public drawing functions. */
+
+void
+miAAFillPolygon (miCoverageSet *coverageSet, const miGC *pGC, int npts, const miDoublePoint *pPts)
+{
+  int i;
+
+  if (npts < 3)
+    return;
+
+  miAABeginContour (&coverageSet->path);
+  for (i = 0; i < npts; i++)
+    miAAAddPoint (&coverageSet->path.vertices, pPts[i].x, pPts[i].y);
+  miAAEndContour (&coverageSet->path, false);
+
+  miAARasterizePath (coverageSet, pGC->pixels[1],
+		     pGC->fillRule == MI_WINDING_RULE ? true : false);
+}
+
+void
+miAADrawLines (miCoverageSet *coverageSet, const miGC *pGC, double lineWidth, int npts, const miDoublePoint *pPts)
+{
+  double hw = (lineWidth > 0.0 ? 0.5 * lineWidth : 0.5);
+
+  miAAStrokeLines (coverageSet, pGC, hw, npts, pPts);
+  miAARasterizePath (coverageSet, pGC->pixels[1], true);
+}
+
+void
+miAAFillArcs (miCoverageSet *coverageSet, const miGC *pGC, int narcs, const miDoubleArc *parcs)
+{
+  int i, j;
+
+  for (i = 0; i < narcs; i++)
+    {
+      const miDoubleArc *arc = parcs + i;
+      miAAPointList *list = &coverageSet->flattened;
+      bool full;
+
+      miAAFlattenArc (list, arc, &full);
+      miAABeginContour (&coverageSet->path);
+      /* if arc is full, its last point duplicates its first */
+      for (j = 0; j < list->npoints - (full ? 1 : 0); j++)
+	miAAAddPoint (&coverageSet->path.vertices,
+		      list->points[j].x, list->points[j].y);
+      if (!full && pGC->arcMode == MI_ARC_PIE_SLICE)
+	miAAAddPoint (&coverageSet->path.vertices,
+		      arc->x + 0.5 * arc->width, arc->y + 0.5 * arc->height);
+      miAAEndContour (&coverageSet->path, true);
+    }
+
+  miAARasterizePath (coverageSet, pGC->pixels[1], true);
+}
+
+void
+miAADrawArcs (miCoverageSet *coverageSet, const miGC *pGC, double lineWidth, int narcs, const miDoubleArc *parcs)
+{
+  double hw = (lineWidth > 0.0 ? 0.5 * lineWidth : 0.5);
+  int i;
+
+  for (i = 0; i < narcs; i++)
+    {
+      bool full;
+
+      miAAFlattenArc (&coverageSet->flattened, parcs + i, &full);
+      miAAStrokeLines (coverageSet, pGC, hw,
+		       coverageSet->flattened.npoints,
+		       coverageSet->flattened.points);
+    }
+
+  miAARasterizePath (coverageSet, pGC->pixels[1], true);
+}
+
+/* Blend a miCoverageSet onto a miCanvas, in a single pass. */
+void
+miBlendCoverageSetToCanvas (const miCoverageSet *coverageSet, miCanvas *canvas)
+{
+  int xleft, ytop, xright, ybottom;
+  int i, x, xstart, xend;
+
+  MI_GET_CANVAS_DRAWABLE_BOUNDS(canvas, xleft, ytop, xright, ybottom)
+
+  for (i = 0; i < coverageSet->nspans; i++)
+    {
+      const miAASpan *span = coverageSet->spans + i;
+      const unsigned char *coverage = coverageSet->coverage + span->offset;
+
+      if (span->y < ytop || span->y > ybottom)
+	continue;
+      xstart = IMAX(span->x, xleft);
+      xend = IMIN(span->x + (int)span->width - 1, xright);
+
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+      if (canvas->packed != (miPackedPixmap *)NULL
+	  && canvas->packed->format == MI_PACKED_RGBA32)
+	/* interpolate each component linearly, leaving alpha alone */
+	{
+	  miRGBA32 source = MI_PIXEL_TO_RGBA32(span->pixel);
+	  miRGBA32 *row = MI_PACKED_RGBA32_ROW(canvas->packed, span->y);
+
+	  for (x = xstart; x <= xend; x++)
+	    {
+	      int alpha = coverage[x - span->x];
+
+	      if (alpha == MI_MAX_COVERAGE)
+		row[x] = source;
+	      else
+		{
+		  miRGBA32 dest = row[x];
+		  int k, value[3];
+
+		  for (k = 0; k < 3; k++)
+		    {
+		      int s = (int)MI_RGBA32_COMPONENT(source, k);
+		      int d = (int)MI_RGBA32_COMPONENT(dest, k);
+
+		      /* round to nearest (the numerator may be negative) */
+		      value[k] = d + ((s - d) * alpha
+				      + (s >= d ? 1 : -1) * (MI_MAX_COVERAGE / 2))
+			/ MI_MAX_COVERAGE;
+		    }
+		  row[x] = MI_RGBA32(value[0], value[1], value[2],
+				     MI_RGBA32_COMPONENT(dest, 3));
+		}
+	    }
+	  continue;
+	}
+#endif /* not MI_CANVAS_DRAWABLE_TYPE */
+
+      /* generic case: paint pixels that are at least half covered */
+      for (x = xstart; x <= xend; x++)
+	if (2 * (int)coverage[x - span->x] >= MI_MAX_COVERAGE)
+	  MI_SET_CANVAS_DRAWABLE_PIXEL(canvas, x, span->y, span->pixel)
+    }
+}
+
+int
+miGetCoverageSpans (miCoverageSet *coverageSet, const miCoverageSpan **spans)
+{
+  int i;
+
+  coverageSet->public_spans =
+    (miCoverageSpan *)miAAGrow (coverageSet->public_spans,
+				&coverageSet->public_spans_size,
+				coverageSet->nspans, sizeof(miCoverageSpan));
+  for (i = 0; i < coverageSet->nspans; i++)
+    {
+      const miAASpan *span = coverageSet->spans + i;
+      miCoverageSpan *public_span = coverageSet->public_spans + i;
+
+      public_span->pixel = span->pixel;
+      public_span->start.x = span->x;
+      public_span->start.y = span->y;
+      public_span->width = span->width;
+      public_span->coverage = coverageSet->coverage + span->offset;
+    }
+
+  *spans = coverageSet->public_spans;
+  return coverageSet->nspans;
+}
+
+/* Construction of paths. */
+
+/* Stroke a polyline into the path in a miCoverageSet, with runs of
+   identical points removed.  It is treated as closed if its first and last
+   points are the same.  If the miGC specifies dashing, it is broken into
+   dashes, and each is stroked separately. */
+static void
+miAAStrokeLines (miCoverageSet *coverageSet, const miGC *pGC, double hw, int npts, const miDoublePoint *pPts)
+{
+  miAAPointList *polyline = &coverageSet->polyline;
+  miAAPointList *dash = &coverageSet->dash;
+  const miDoublePoint *p;
+  int i, n, dash_length, index;
+  double remaining;
+  bool closed, on;
+
+  if (npts <= 0)
+    return;
+
+  polyline->npoints = 0;
+  for (i = 0; i < npts; i++)
+    if (i == 0
+	|| pPts[i].x != polyline->points[polyline->npoints - 1].x
+	|| pPts[i].y != polyline->points[polyline->npoints - 1].y)
+      miAAAddPoint (polyline, pPts[i].x, pPts[i].y);
+  p = polyline->points;
+  n = polyline->npoints;
+  closed = (n >= 3 && p[0].x == p[n - 1].x && p[0].y == p[n - 1].y
+	    ? true : false);
+
+  dash_length = 0;
+  if (pGC->lineStyle != MI_LINE_SOLID)
+    for (i = 0; i < pGC->numInDashList; i++)
+      dash_length += (int)pGC->dash[i];
+
+  if (dash_length == 0 || n == 1)
+    /* solid line */
+    {
+      miAAStrokePolyline (&coverageSet->path, pGC, hw, n, p, closed);
+      return;
+    }
+
+  /* Dashed line.  Off dashes are never drawn, i.e., MI_LINE_DOUBLE_DASH
+     is treated as MI_LINE_ON_OFF_DASH. */
+  index = 0;
+  remaining = (double)(pGC->dashOffset % dash_length);
+  while (remaining >= (double)pGC->dash[index])
+    {
+      remaining -= (double)pGC->dash[index];
+      index = (index + 1) % pGC->numInDashList;
+    }
+  remaining = (double)pGC->dash[index] - remaining;
+  on = (index % 2 == 0 ? true : false);
+
+  dash->npoints = 0;
+  if (on)
+    miAAAddPoint (dash, p[0].x, p[0].y);
+  for (i = 0; i + 1 < n; i++)
+    {
+      double dx = p[i + 1].x - p[i].x, dy = p[i + 1].y - p[i].y;
+      double length = sqrt (dx * dx + dy * dy);
+      double pos = 0.0;
+
+      while (length - pos > remaining)
+	/* dash ends within this segment */
+	{
+	  double x, y;
+
+	  pos += remaining;
+	  x = p[i].x + dx * (pos / length);
+	  y = p[i].y + dy * (pos / length);
+	  if (on)
+	    {
+	      miAAAddPoint (dash, x, y);
+	      miAAStrokePolyline (&coverageSet->path, pGC, hw,
+				  dash->npoints, dash->points, false);
+	      dash->npoints = 0;
+	    }
+	  else
+	    miAAAddPoint (dash, x, y);
+	  on = (on ? false : true);
+	  index = (index + 1) % pGC->numInDashList;
+	  remaining = (double)pGC->dash[index];
+	}
+      remaining -= length - pos;
+      if (on)
+	miAAAddPoint (dash, p[i + 1].x, p[i + 1].y);
+    }
+  if (on && dash->npoints > 0)
+    miAAStrokePolyline (&coverageSet->path, pGC, hw,
+			dash->npoints, dash->points, false);
+}
+
+/* Add the pieces of a stroked polyline to a path: a quadrilateral for each
+   segment, and polygons for joins and caps.  Points may be repeated. */
+static void
+miAAStrokePolyline (miAAPath *path, const miGC *pGC, double hw, int npts, const miDoublePoint *pts, bool closed)
+{
+  int i, first, last;
+  miDoublePoint prev;
+
+  /* skip over runs of identical points at the ends */
+  first = 0;
+  last = npts - 1;
+  while (first < last
+	 && pts[first].x == pts[first + 1].x && pts[first].y == pts[first + 1].y)
+    first++;
+  while (last > first
+	 && pts[last].x == pts[last - 1].x && pts[last].y == pts[last - 1].y)
+    last--;
+
+  if (first == last)
+    /* zero-length line: draw a dot, if the cap style has an extent */
+    {
+      if (pGC->capStyle == MI_CAP_ROUND)
+	miAADisk (path, pts[first].x, pts[first].y, hw);
+      else if (pGC->capStyle == MI_CAP_PROJECTING)
+	miAAQuad (path,
+		  pts[first].x - hw, pts[first].y - hw,
+		  pts[first].x + hw, pts[first].y - hw,
+		  pts[first].x + hw, pts[first].y + hw,
+		  pts[first].x - hw, pts[first].y + hw);
+      return;
+    }
+
+  /* segments */
+  prev = pts[first];
+  for (i = first + 1; i <= last; i++)
+    {
+      double dx = pts[i].x - prev.x, dy = pts[i].y - prev.y;
+      double length = sqrt (dx * dx + dy * dy);
+      double nx, ny;
+
+      if (length == 0.0)
+	continue;
+      nx = -dy / length * hw;
+      ny = dx / length * hw;
+      miAAQuad (path,
+		prev.x + nx, prev.y + ny, pts[i].x + nx, pts[i].y + ny,
+		pts[i].x - nx, pts[i].y - ny, prev.x - nx, prev.y - ny);
+      if (i < last)
+	{
+	  int j = i + 1;
+
+	  while (j < last && pts[j].x == pts[i].x && pts[j].y == pts[i].y)
+	    j++;
+	  miAAJoin (path, pGC, hw, prev, pts[i], pts[j]);
+	}
+      prev = pts[i];
+    }
+
+  if (closed)
+    /* join last segment to first */
+    {
+      int j = first + 1, k = last - 1;
+
+      while (pts[j].x == pts[first].x && pts[j].y == pts[first].y)
+	j++;
+      while (pts[k].x == pts[last].x && pts[k].y == pts[last].y)
+	k--;
+      miAAJoin (path, pGC, hw, pts[k], pts[first], pts[j]);
+    }
+  else
+    /* caps at both ends */
+    {
+      double dx, dy, length;
+      int j;
+
+      j = first + 1;
+      while (pts[j].x == pts[first].x && pts[j].y == pts[first].y)
+	j++;
+      dx = pts[first].x - pts[j].x;
+      dy = pts[first].y - pts[j].y;
+      length = sqrt (dx * dx + dy * dy);
+      miAACap (path, pGC->capStyle, hw, pts[first], dx / length, dy / length);
+
+      j = last - 1;
+      while (pts[j].x == pts[last].x && pts[j].y == pts[last].y)
+	j--;
+      dx = pts[last].x - pts[j].x;
+      dy = pts[last].y - pts[j].y;
+      length = sqrt (dx * dx + dy * dy);
+      miAACap (path, pGC->capStyle, hw, pts[last], dx / length, dy / length);
+    }
+}
+
+/* Add a join at vertex v, between segments a->v and v->b, to a path. */
+static void
+miAAJoin (miAAPath *path, const miGC *pGC, double hw, miDoublePoint a, miDoublePoint v, miDoublePoint b)
+{
+  double d1x, d1y, d2x, d2y, length, cross, dot, side;
+  double o1x, o1y, o2x, o2y, bx, by;
+
+  d1x = v.x - a.x;
+  d1y = v.y - a.y;
+  length = sqrt (d1x * d1x + d1y * d1y);
+  d1x /= length;
+  d1y /= length;
+  d2x = b.x - v.x;
+  d2y = b.y - v.y;
+  length = sqrt (d2x * d2x + d2y * d2y);
+  d2x /= length;
+  d2y /= length;
+  cross = d1x * d2y - d1y * d2x;
+  dot = d1x * d2x + d1y * d2y;
+
+  if (dot > 0.0 && hw * hw * fabs (cross) < 1e-3)
+    /* nearly collinear, so segments abut almost exactly, and the join would
+       cover a negligible area (less than 1/1000 of a pixel) */
+    return;
+
+  if (pGC->joinStyle == MI_JOIN_ROUND)
+    {
+      miAADisk (path, v.x, v.y, hw);
+      return;
+    }
+
+  /* outer corners of the two segments at v */
+  side = (cross > 0.0 ? -hw : hw);
+  o1x = v.x - d1y * side;
+  o1y = v.y + d1x * side;
+  o2x = v.x - d2y * side;
+  o2y = v.y + d2x * side;
+
+  /* unit vector bisecting the exterior angle */
+  bx = o1x + o2x - 2.0 * v.x;
+  by = o1y + o2y - 2.0 * v.y;
+  length = sqrt (bx * bx + by * by);
+  if (length > 1e-12 * hw)
+    {
+      bx /= length;
+      by /= length;
+    }
+  else
+    /* line doubles back on itself */
+    {
+      bx = d1x;
+      by = d1y;
+    }
+
+  if (pGC->joinStyle == MI_JOIN_MITER)
+    {
+      /* ratio of miter length to line width is 1/sin(theta/2), where theta
+	 is the interior angle */
+      double sine = sqrt (0.5 * (1.0 + dot));
+
+      if (sine > 0.0 && 1.0 / sine <= pGC->miterLimit)
+	{
+	  double m = hw / sine;
+
+	  miAAQuad (path, v.x, v.y, o1x, o1y,
+		    v.x + bx * m, v.y + by * m, o2x, o2y);
+	  return;
+	}
+      /* miter limit exceeded, so bevel instead */
+    }
+
+  switch (pGC->joinStyle)
+    {
+    case MI_JOIN_MITER:		/* miter limit was exceeded */
+    case MI_JOIN_BEVEL:
+    default:
+      miAABeginContour (path);
+      miAAAddPoint (&path->vertices, v.x, v.y);
+      miAAAddPoint (&path->vertices, o1x, o1y);
+      miAAAddPoint (&path->vertices, o2x, o2y);
+      miAAEndContour (path, true);
+      break;
+
+    case MI_JOIN_TRIANGULAR:
+      miAAQuad (path, v.x, v.y, o1x, o1y,
+		v.x + bx * hw, v.y + by * hw, o2x, o2y);
+      break;
+    }
+}
+
+/* Add a cap at endpoint v to a path; (ux,uy) is the outward direction. */
+static void
+miAACap (miAAPath *path, int capStyle, double hw, miDoublePoint v, double ux, double uy)
+{
+  double nx = -uy * hw, ny = ux * hw;
+
+  switch (capStyle)
+    {
+    case MI_CAP_NOT_LAST:
+    case MI_CAP_BUTT:
+    default:
+      break;
+    case MI_CAP_ROUND:
+      miAADisk (path, v.x, v.y, hw);
+      break;
+    case MI_CAP_PROJECTING:
+      miAAQuad (path, v.x + nx, v.y + ny,
+		v.x + nx + ux * hw, v.y + ny + uy * hw,
+		v.x - nx + ux * hw, v.y - ny + uy * hw,
+		v.x - nx, v.y - ny);
+      break;
+    case MI_CAP_TRIANGULAR:
+      miAABeginContour (path);
+      miAAAddPoint (&path->vertices, v.x + nx, v.y + ny);
+      miAAAddPoint (&path->vertices, v.x + ux * hw, v.y + uy * hw);
+      miAAAddPoint (&path->vertices, v.x - nx, v.y - ny);
+      miAAEndContour (path, true);
+      break;
+    }
+}
+
+static void
+miAAQuad (miAAPath *path, double x0, double y0, double x1, double y1, double x2, double y2, double x3, double y3)
+{
+  miAABeginContour (path);
+  miAAAddPoint (&path->vertices, x0, y0);
+  miAAAddPoint (&path->vertices, x1, y1);
+  miAAAddPoint (&path->vertices, x2, y2);
+  miAAAddPoint (&path->vertices, x3, y3);
+  miAAEndContour (path, true);
+}
+
+static void
+miAADisk (miAAPath *path, double x, double y, double radius)
+{
+  int i, n;
+
+  n = miAAArcSegments (radius, 2.0 * M_PI);
+  if (n < MI_AA_MIN_CIRCLE_SEGMENTS)
+    n = MI_AA_MIN_CIRCLE_SEGMENTS;
+  miAABeginContour (path);
+  for (i = 0; i < n; i++)
+    {
+      double theta = (2.0 * M_PI * i) / n;
+
+      miAAAddPoint (&path->vertices,
+		    x + radius * cos (theta), y + radius * sin (theta));
+    }
+  miAAEndContour (path, true);
+}
+
+/* Flatten an arc into a list of points.  If its angle range is 360
+   degrees or more, it is flattened into a closed polyline. */
+static void
+miAAFlattenArc (miAAPointList *list, const miDoubleArc *arc, bool *full)
+{
+  double rx = 0.5 * arc->width, ry = 0.5 * arc->height;
+  double xc = arc->x + rx, yc = arc->y + ry;
+  double start = arc->angle1 * (M_PI / 180.0);
+  double range = arc->angle2 * (M_PI / 180.0);
+  int i, n;
+
+  *full = false;
+  if (range >= 2.0 * M_PI || range <= -2.0 * M_PI)
+    {
+      range = (range > 0.0 ? 2.0 * M_PI : -2.0 * M_PI);
+      *full = true;
+    }
+
+  n = miAAArcSegments (DMAX(rx, ry), fabs (range));
+  if (*full && n < MI_AA_MIN_CIRCLE_SEGMENTS)
+    n = MI_AA_MIN_CIRCLE_SEGMENTS;
+
+  /* by convention, angles increase counterclockwise on the display,
+     i.e., y coordinates are flipped */
+  list->npoints = 0;
+  for (i = 0; i <= n; i++)
+    {
+      double theta = start + (range * i) / n;
+
+      if (*full && i == n)
+	miAAAddPoint (list, list->points[0].x, list->points[0].y);
+      else
+	miAAAddPoint (list, xc + rx * cos (theta), yc - ry * sin (theta));
+    }
+}
+
+/* Number of segments needed to approximate an arc of a circle of
+   specified radius, to within MI_AA_FLATNESS. */
+static int
+miAAArcSegments (double radius, double range)
+{
+  double step;
+  int n;
+
+  if (radius > MI_AA_FLATNESS)
+    step = 2.0 * acos (1.0 - MI_AA_FLATNESS / radius);
+  else
+    step = 0.5 * M_PI;
+  n = (int)ceil (range / step);
+
+  return (n < 1 ? 1 : n);
+}
+
+static void
+miAABeginContour (miAAPath *path)
+{
+  path->start = path->vertices.npoints;
+}
+
+/* End the current contour of a path.  If `orient' is set, its vertices are
+   reversed if need be, so that its signed area is nonnegative. */
+static void
+miAAEndContour (miAAPath *path, bool orient)
+{
+  miDoublePoint *p = path->vertices.points + path->start;
+  int i, n = path->vertices.npoints - path->start;
+
+  if (n < 3)
+    /* degenerate */
+    {
+      path->vertices.npoints = path->start;
+      return;
+    }
+
+  if (orient)
+    {
+      double area = 0.0;
+
+      for (i = 0; i < n; i++)
+	{
+	  const miDoublePoint *q = p + (i + 1) % n;
+
+	  area += p[i].x * q->y - q->x * p[i].y;
+	}
+      if (area < 0.0)
+	for (i = 0; i < n / 2; i++)
+	  {
+	    miDoublePoint tmp;
+
+	    tmp = p[i];
+	    p[i] = p[n - 1 - i];
+	    p[n - 1 - i] = tmp;
+	  }
+    }
+
+  path->counts = (int *)miAAGrow (path->counts, &path->counts_size,
+				  path->ncontours + 1, sizeof(int));
+  path->counts[path->ncontours++] = n;
+}
+
+static void
+miAAAddPoint (miAAPointList *list, double x, double y)
+{
+  list->points = (miDoublePoint *)miAAGrow (list->points, &list->size,
+					    list->npoints + 1,
+					    sizeof(miDoublePoint));
+  list->points[list->npoints].x = x;
+  list->points[list->npoints].y = y;
+  list->npoints++;
+}
+
+/* Scan conversion. */
+
+/* Scan-convert the path in a miCoverageSet, adding spans of the specified
+   pixel to it, and clear the path. */
+static void
+miAARasterizePath (miCoverageSet *coverageSet, miPixel pixel, bool winding)
+{
+  miAAPath *path = &coverageSet->path;
+  const miDoublePoint *p;
+  miAAEdge *edges;
+  int *active;
+  miAACrossing *crossings;
+  int i, j, k, c, nedges, nactive, nnew, next, y, ymin, ymax;
+  double ytop = 0.0, ybottom = 0.0;
+
+  if (path->vertices.npoints > coverageSet->edges_size)
+    {
+      int size = coverageSet->edges_size;
+
+      coverageSet->edges =
+	(miAAEdge *)miAAGrow (coverageSet->edges, &size,
+			      path->vertices.npoints, sizeof(miAAEdge));
+      free (coverageSet->active);
+      free (coverageSet->crossings);
+      coverageSet->active = (int *)mi_xmalloc (size * sizeof(int));
+      coverageSet->crossings =
+	(miAACrossing *)mi_xmalloc (size * sizeof(miAACrossing));
+      coverageSet->edges_size = size;
+    }
+  edges = coverageSet->edges;
+  active = coverageSet->active;
+  crossings = coverageSet->crossings;
+
+  /* build edge table, shifting coordinates so that pixel (x,y) is the unit
+     square with upper left corner (x,y) */
+  nedges = 0;
+  p = path->vertices.points;
+  for (c = 0; c < path->ncontours; p += path->counts[c], c++)
+    for (i = 0; i < path->counts[c]; i++)
+      {
+	const miDoublePoint *q = p + (i + 1) % path->counts[c];
+	double x0 = p[i].x + 0.5, y0 = p[i].y + 0.5;
+	double x1 = q->x + 0.5, y1 = q->y + 0.5;
+	miAAEdge *edge;
+
+	if (!(y0 != y1))	/* horizontal, or NaN */
+	  continue;
+	edge = edges + nedges++;
+	if (y0 < y1)
+	  {
+	    edge->x0 = x0;
+	    edge->y0 = y0;
+	    edge->y1 = y1;
+	    edge->dxdy = (x1 - x0) / (y1 - y0);
+	    edge->dir = 1;
+	  }
+	else
+	  {
+	    edge->x0 = x1;
+	    edge->y0 = y1;
+	    edge->y1 = y0;
+	    edge->dxdy = (x0 - x1) / (y0 - y1);
+	    edge->dir = -1;
+	  }
+	if (nedges == 1 || edge->y0 < ytop)
+	  ytop = edge->y0;
+	if (nedges == 1 || edge->y1 > ybottom)
+	  ybottom = edge->y1;
+      }
+  path->vertices.npoints = 0;
+  path->ncontours = 0;
+
+  if (nedges == 0 || ybottom <= 0.0 || ytop >= (double)coverageSet->height)
+    return;
+  ymin = (ytop < 0.0 ? 0 : (int)ytop);
+  ymax = (ybottom > (double)coverageSet->height
+	  ? (int)coverageSet->height - 1 : (int)ceil (ybottom) - 1);
+
+  qsort (edges, (size_t)nedges, sizeof(miAAEdge), miAACompareEdges);
+
+  nactive = 0;
+  next = 0;
+  for (y = ymin; y <= ymax; y++)
+    {
+      int xlo = (int)coverageSet->width + 1, xhi = -1;
+
+      /* update active edge list: drop edges lying above this row, add
+	 edges that begin above its bottom */
+      for (i = 0, j = 0; i < nactive; i++)
+	if (edges[active[i]].y1 > (double)y)
+	  active[j++] = active[i];
+      nactive = j;
+      nnew = 0;
+      while (next < nedges && edges[next].y0 < (double)(y + 1))
+	{
+	  if (edges[next].y1 > (double)y)
+	    {
+	      active[nactive++] = next;
+	      nnew++;
+	    }
+	  next++;
+	}
+      if (nactive == 0)
+	continue;
+
+      for (k = 0; k < MI_AA_SUBSCANLINES; k++)
+	{
+	  double ys = y + (k + 0.5) / MI_AA_SUBSCANLINES;
+	  double xstart = 0.0;
+	  int ncrossings = 0, nidle = 0, wind = 0;
+
+	  /* compute crossings, in the order of the active edge list; move
+	     the edges that aren't crossed to the front of the list */
+	  for (i = 0; i < nactive; i++)
+	    {
+	      const miAAEdge *edge = edges + active[i];
+
+	      if (edge->y0 <= ys && ys < edge->y1)
+		{
+		  crossings[ncrossings].x =
+		    edge->x0 + (ys - edge->y0) * edge->dxdy;
+		  crossings[ncrossings].dir = edge->dir;
+		  crossings[ncrossings].edge = active[i];
+		  ncrossings++;
+		}
+	      else
+		active[nidle++] = active[i];
+	    }
+
+	  /* sort crossings by x.  The active edge list is kept in the order
+	     of the preceding sub-scanline's crossings, so they are almost
+	     sorted, and insertion sort takes nearly linear time; except
+	     when many edges have just been added. */
+	  if (k == 0 && nnew > 16)
+	    qsort (crossings, (size_t)ncrossings, sizeof(miAACrossing),
+		   miAACompareCrossings);
+	  else
+	    for (i = 1; i < ncrossings; i++)
+	      if (crossings[i - 1].x > crossings[i].x)
+		{
+		  miAACrossing tmp;
+
+		  tmp = crossings[i];
+		  for (j = i; j > 0 && crossings[j - 1].x > tmp.x; j--)
+		    crossings[j] = crossings[j - 1];
+		  crossings[j] = tmp;
+		}
+
+	  /* rebuild active edge list: uncrossed edges, then crossed edges
+	     in order of increasing x */
+	  for (i = 0; i < ncrossings; i++)
+	    active[nidle + i] = crossings[i].edge;
+
+	  if (ncrossings < 2)
+	    continue;
+
+	  /* walk along sub-scanline, tracking the winding number */
+	  for (i = 0; i < ncrossings; i++)
+	    {
+	      bool was_inside = (winding ? wind != 0 : (wind & 1) != 0);
+	      bool inside;
+
+	      wind += crossings[i].dir;
+	      inside = (winding ? wind != 0 : (wind & 1) != 0);
+	      if (!was_inside && inside)
+		xstart = crossings[i].x;
+	      else if (was_inside && !inside)
+		miAAAddInterval (coverageSet, xstart, crossings[i].x,
+				 &xlo, &xhi);
+	    }
+	}
+
+      if (xhi >= 0)
+	miAAEmitRow (coverageSet, pixel, y, xlo, xhi);
+    }
+}
+
+/* Add an interval along a sub-scanline to the row being accumulated. */
+static void
+miAAAddInterval (miCoverageSet *coverageSet, double xleft, double xright, int *xlo, int *xhi)
+{
+  int ileft, iright;
+
+  if (xleft < 0.0)
+    xleft = 0.0;
+  if (xright > (double)coverageSet->width)
+    xright = (double)coverageSet->width;
+  if (!(xleft < xright))
+    return;
+
+  ileft = (int)xleft;
+  iright = (int)xright;
+  if (ileft == iright)
+    coverageSet->area[ileft] += xright - xleft;
+  else
+    {
+      coverageSet->area[ileft] += (ileft + 1) - xleft;
+      coverageSet->delta[ileft + 1] += 1.0;
+      coverageSet->delta[iright] -= 1.0;
+      coverageSet->area[iright] += xright - iright;
+    }
+
+  if (ileft < *xlo)
+    *xlo = ileft;
+  if (iright > *xhi)
+    *xhi = iright;
+}
+
+/* Compute the coverage of the pixels in the row that has been accumulated,
+   add spans of nonzero coverage to the miCoverageSet, and reset the
+   accumulation arrays. */
+static void
+miAAEmitRow (miCoverageSet *coverageSet, miPixel pixel, int y, int xlo, int xhi)
+{
+  double full = 0.0;
+  int x, xstart = -1;
+
+  coverageSet->coverage =
+    (unsigned char *)miAAGrow (coverageSet->coverage,
+			       &coverageSet->coverage_size,
+			       coverageSet->ncoverage + (xhi - xlo + 1),
+			       sizeof(unsigned char));
+
+  for (x = xlo; x <= xhi + 1; x++)
+    {
+      int value = 0;
+
+      if (x <= xhi)
+	{
+	  double c;
+
+	  full += coverageSet->delta[x];
+	  c = (coverageSet->area[x] + full)
+	    * ((double)MI_MAX_COVERAGE / MI_AA_SUBSCANLINES);
+	  coverageSet->area[x] = 0.0;
+	  coverageSet->delta[x] = 0.0;
+	  if (x < (int)coverageSet->width)
+	    value = (c >= (double)MI_MAX_COVERAGE ? MI_MAX_COVERAGE
+		     : c > 0.0 ? (int)(c + 0.5) : 0);
+	}
+      else
+	coverageSet->delta[x] = 0.0;
+
+      if (value > 0)
+	{
+	  if (xstart < 0)
+	    /* begin a new span */
+	    {
+	      miAASpan *span;
+
+	      coverageSet->spans =
+		(miAASpan *)miAAGrow (coverageSet->spans,
+				      &coverageSet->spans_size,
+				      coverageSet->nspans + 1, sizeof(miAASpan));
+	      span = coverageSet->spans + coverageSet->nspans++;
+	      span->pixel = pixel;
+	      span->x = x;
+	      span->y = y;
+	      span->offset = coverageSet->ncoverage;
+	      xstart = x;
+	    }
+	  coverageSet->coverage[coverageSet->ncoverage++] =
+	    (unsigned char)value;
+	}
+      else if (xstart >= 0)
+	/* end the current span */
+	{
+	  coverageSet->spans[coverageSet->nspans - 1].width =
+	    (unsigned int)(x - xstart);
+	  xstart = -1;
+	}
+    }
+}
+
+static int
+miAACompareEdges (const void *a, const void *b)
+{
+  double y0a = ((const miAAEdge *)a)->y0, y0b = ((const miAAEdge *)b)->y0;
+
+  return (y0a < y0b ? -1 : y0a > y0b ? 1 : 0);
+}
+
+static int
+miAACompareCrossings (const void *a, const void *b)
+{
+  double xa = ((const miAACrossing *)a)->x, xb = ((const miAACrossing *)b)->x;
+
+  return (xa < xb ? -1 : xa > xb ? 1 : 0);
+}
+
+/* Grow an array, if necessary, so that it has room for `needed'
+   elements; its size at least doubles. */
+static void *
+miAAGrow (void *p, int *size, int needed, size_t eltsize)
+{
+  int new_size;
+
+  if (needed <= *size)
+    return p;
+
+  new_size = (*size > 0 ? 2 * *size : 16);
+  while (new_size < needed)
+    new_size *= 2;
+  if (p == NULL)
+    p = mi_xmalloc (new_size * eltsize);
+  else
+    p = mi_xrealloc (p, new_size * eltsize);
+  *size = new_size;
+
+  return p;
+}
@@ -25,7 +25,9 @@
 Each of these is a wrapper around an internal function that takes as first
 argument a (miPaintedSet *).  A miPaintedSet struct is a structure that is
 used by Joel McCormack's span-merging module to implement the
-`touch-each-pixel-once' rule.  See mi_spans.c and mi_spans.h. */
+`touch-each-pixel-once' rule.  See mi_spans.c and mi_spans.h.  If the
+miPaintedSet is a deferred-mode one, the wrapper merely records the
+drawing operation; see mi_defer.c. */
 
 #include "sys-defines.h"
 #include "extern.h"
@@ -39,6 +41,15 @@ used by Joel McCormack's span-merging module to implement the
 {\
 }
 
+/* If the miPaintedSet is a deferred-mode one, the drawing operation is
+   merely recorded (see mi_defer.c). */
+#define MI_RECORD_IF_DEFERRED(paintedSet, opType, pGC, mode, shape, n, data) \
+if ((paintedSet)->deferred != (miDeferredOps *)NULL) \
+{\
+  miRecordDrawingOp ((paintedSet), (opType), (pGC), (int)(mode), (int)(shape), (n), (const void *)(data)); \
+  return; \
+}
+
 #define MI_TEAR_DOWN_PAINTED_SET(paintedSet) \
 {\
   miUniquifyPaintedSet (paintedSet); \
@@ -49,6 +60,7 @@ void
 miDrawPoints (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mode, int npt, const miPoint *pPts)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_DRAW_POINTS, pGC, mode, 0, npt, pPts)
   miDrawPoints_internal (paintedSet, pGC, mode, npt, pPts);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -58,6 +70,7 @@ void
 miDrawLines (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mode, int npt, const miPoint *pPts)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_DRAW_LINES, pGC, mode, 0, npt, pPts)
   miDrawLines_internal (paintedSet, pGC, mode, npt, pPts);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -67,6 +80,7 @@ void
 miFillPolygon (miPaintedSet *paintedSet, const miGC *pGC, miPolygonShape shape, miCoordMode mode, int count, const miPoint *pPts)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_FILL_POLYGON, pGC, mode, shape, count, pPts)
   miFillPolygon_internal (paintedSet, pGC, shape, mode, count, pPts);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -75,6 +89,7 @@ void
 miDrawRectangles (miPaintedSet *paintedSet, const miGC *pGC, int nrects, const miRectangle *prectInit)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC);
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_DRAW_RECTANGLES, pGC, 0, 0, nrects, prectInit)
   miDrawRectangles_internal (paintedSet, pGC, nrects, prectInit);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -85,6 +100,7 @@ miFillRectangles (miPaintedSet *paintedSet, const miGC *pGC, int nrectFill, cons
   fprintf (stderr, "miFillRectangles()\n");
 
   MI_SETUP_PAINTED_SET(paintedSet, pGC);
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_FILL_RECTANGLES, pGC, 0, 0, nrectFill, prectInit)
   miFillRectangles_internal (paintedSet, pGC, nrectFill, prectInit);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -94,6 +110,7 @@ void
 miDrawArcs (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_DRAW_ARCS, pGC, 0, 0, narcs, parcs)
   miDrawArcs_internal (paintedSet, pGC, narcs, parcs);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -103,6 +120,7 @@ void
 miFillArcs (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_FILL_ARCS, pGC, 0, 0, narcs, parcs)
   miFillArcs_internal (paintedSet, pGC, narcs, parcs);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
@@ -112,6 +130,7 @@ void
 miDrawArcs_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs, miEllipseCache *ellipseCache)
 {
   MI_SETUP_PAINTED_SET(paintedSet, pGC)
+  MI_RECORD_IF_DEFERRED(paintedSet, MI_OP_DRAW_ARCS, pGC, 0, 0, narcs, parcs)
   miDrawArcs_r_internal (paintedSet, pGC, narcs, parcs, ellipseCache);
   MI_TEAR_DOWN_PAINTED_SET(paintedSet)
 }
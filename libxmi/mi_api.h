@@ -42,6 +42,9 @@ extern void miZeroPolyArc (miPaintedSet *paintedSet, const miGC *pGC, int narcs,
 extern void miPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs, miEllipseCache *ellipse_cache);
 extern void miZeroPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs, miEllipseCache *ellipse_cache);
 
+/* ellipse cache statistics, see mi_arc.c */
+extern void miAccumEllipseCacheStats (miEllipseCache *ellipseCache, const miEllipseCache *other);
+
 /* Declarations of other internal functions, which should really be moved
    elsewhere. */
 
@@ -67,13 +67,17 @@
    wide ellipses so that we can retrieve them later, by keying on ellipse
    width, ellipse height, and line width.  Any such cache is an
    miEllipseCache object; equivalently, a lib_miEllipseCache structure,
-   which is basically an array of (cachedEllipse *)'s.  Each cachedEllipse
-   is a record, the `value' field of which is an (miArcSpanData *),
-   i.e. basically a list of spans, computed and returned by
-   miComputeWideEllipse().
+   which is basically an array of cachedEllipse records.  Each
+   cachedEllipse is a record, the `value' field of which is an
+   (miArcSpanData *), i.e. basically a list of spans, computed and returned
+   by miComputeWideEllipse().  The records in use are chained into a hash
+   table, for lookup, and into a doubly linked list in order of most recent
+   use, so that when the cache is full, the least recently used record can
+   be found at once and replaced.
 
    The currently used miEllipseCache structure is accessed via the
-   ellipseCache argument of miPolyArc_r(). */
+   ellipseCache argument of miPolyArc_r().  Since it is modified on every
+   lookup, it must not be shared between threads. */
 
 /* one or two spans (any rasterized ellipse contains a list of these,
    indexed by y) */
@@ -127,27 +131,33 @@ typedef struct
 } miArcSpanData;
 
 /* Cache record type (key/value); key consists of width,height,linewidth.
-   Also includes a timestamp. */
-typedef struct 
+   Also includes links into a hash chain and into the LRU list. */
+typedef struct lib_cachedEllipse
 {
-  unsigned long lrustamp;	/* timestamp (time of most recent retrieval) */
   unsigned int width, height;	/* ellipse width, height */
   unsigned int lw;		/* line width used when rasterizing */
   miArcSpanData *spdata;	/* `value' part of record */
+  struct lib_cachedEllipse *hashNext; /* next record in hash chain */
+  struct lib_cachedEllipse *lruPrev; /* next more recently used record */
+  struct lib_cachedEllipse *lruNext; /* next less recently used record */
 } cachedEllipse;
 
-/* The cache of scan-converted ellipses, including continually updated
-   timestamp. */
+/* The cache of scan-converted ellipses. */
 struct lib_miEllipseCache
 {
   cachedEllipse *ellipses;	/* beginning of array of records */
   int size;			/* number of records in array */
-  cachedEllipse *lastCacheHit;	/* pointer to last-accessed record */
-  unsigned long lrustamp;	/* clock, for timestamping records */
+  int count;			/* number of records in use */
+  cachedEllipse **buckets;	/* hash table (chains of records in use) */
+  unsigned int nbuckets;	/* number of hash chains, a power of 2 */
+  cachedEllipse *mru;		/* most recently used record */
+  cachedEllipse *lru;		/* least recently used record */
+  miEllipseCacheStats stats;	/* hits, misses, etc. */
 };
 
-/* Size of cache (i.e. number of (cachedEllipse *)'s the array contains) */
-#define ELLIPSECACHE_SIZE 25
+/* Default size of cache (i.e. number of cachedEllipse's the array
+   contains) */
+#define ELLIPSECACHE_SIZE 64
 
 /* Maximum height an ellipse can have, for its spans to be stored in
    the cache. */
@@ -298,6 +308,7 @@ static double miDsin (double a);
 static int computeAngleFromPath (int startAngle, int endAngle, const dashMap *map, int *lenp, bool backwards);
 static int miGetArcPts (const SppArc *parc, int cpt, SppPoint **ppPts);
 static miArcData * addArc (miPolyArcs *polyArcs, const miArc *xarc);
+static unsigned int miHashEllipseKey (unsigned int width, unsigned int height, unsigned int lw);
 static miArcSpanData * miComputeWideEllipse (unsigned int lw, const miArc *parc, bool *mustFree, miEllipseCache *ellipseCache);
 static miPolyArcs * miComputeArcs (const miGC *pGC, const miArc *parcs, int narcs);
 static void addCap (miPolyArcs *polyArcs, int end, int arcIndex);
@@ -505,71 +516,101 @@ miPolyArc (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *pa
 }
 #endif /* not NO_NONREENTRANT_POLYARC_SUPPORT */
 
-/* Initialize a cache of rasterized elliptic arcs.  (A pointer to such an
-   object is passed to miPolyArc_r.)  Such a cache comprises an array of
-   records (i.e. cachedEllipse's), a pointer to one of them (the most
-   recently used), and a timestamp variable that is incremented when any
-   record is cached.  `Replace least recently used' is the policy. */
+/* Initialize a cache of rasterized elliptic arcs, of the default size.
+   (A pointer to such an object is passed to miPolyArc_r.)  `Replace least
+   recently used' is the policy. */
 miEllipseCache *
 miNewEllipseCache (void)
 {
-  int k;
-  cachedEllipse *chead, *cent;
+  return miNewEllipseCacheOfSize (ELLIPSECACHE_SIZE);
+}
+
+/* Initialize a cache of rasterized elliptic arcs, which can hold `size'
+   of them.  If size is zero, nothing will be cached. */
+miEllipseCache *
+miNewEllipseCacheOfSize (int size)
+{
+  unsigned int k;
   miEllipseCache *ellipseCache;
 
+  if (size < 0)
+    size = 0;
   ellipseCache = (miEllipseCache *)mi_xmalloc (sizeof(miEllipseCache));
 
-  /* pointer to beginning of array of records */
-  ellipseCache->ellipses = (cachedEllipse *)mi_xmalloc (ELLIPSECACHE_SIZE * sizeof(cachedEllipse));
-  /* length of array */
-  ellipseCache->size = ELLIPSECACHE_SIZE;
-  /* pointer to beginning of last-accessed record (a dummy value) */
-  ellipseCache->lastCacheHit = ellipseCache->ellipses;
-  /* clock for timestamping */
-  ellipseCache->lrustamp = 0;
-
-  /* initialize elements of each record with null/bogus values */
-  chead = ellipseCache->ellipses;
-  for (k = ELLIPSECACHE_SIZE, cent = chead; --k >= 0; cent++)
-    {
-      cent->lrustamp = 0;
-      cent->lw = 0;
-      cent->width = cent->height = 0;
-      cent->spdata = (miArcSpanData *)NULL;
-    }
+  /* array of records; all are unused */
+  ellipseCache->ellipses = (size > 0 
+			    ? (cachedEllipse *)mi_xmalloc (size * sizeof(cachedEllipse))
+			    : (cachedEllipse *)NULL);
+  ellipseCache->size = size;
+  ellipseCache->count = 0;
+
+  /* hash table, with at least as many chains as records */
+  for (ellipseCache->nbuckets = 1; 
+       ellipseCache->nbuckets < (unsigned int)size; )
+    ellipseCache->nbuckets *= 2;
+  ellipseCache->buckets = (cachedEllipse **)mi_xmalloc (ellipseCache->nbuckets * sizeof(cachedEllipse *));
+  for (k = 0; k < ellipseCache->nbuckets; k++)
+    ellipseCache->buckets[k] = (cachedEllipse *)NULL;
+
+  /* LRU list is empty */
+  ellipseCache->mru = (cachedEllipse *)NULL;
+  ellipseCache->lru = (cachedEllipse *)NULL;
+
+  ellipseCache->stats.hits = 0;
+  ellipseCache->stats.misses = 0;
+  ellipseCache->stats.evictions = 0;
+  ellipseCache->stats.uncacheable = 0;
+  ellipseCache->stats.size = size;
+  ellipseCache->stats.count = 0;
 
   return ellipseCache;
 }
 
 /* Free a cache of rasterized ellipses, which must previously have been
-   allocated by invoking miNewEllipseCache. */
+   allocated by invoking miNewEllipseCache or miNewEllipseCacheOfSize. */
 void
 miDeleteEllipseCache (miEllipseCache *ellipseCache)
 {
-  int k, cache_size;
-  cachedEllipse *chead, *cent;
+  int k;
 
-  /* free span data in all records */
-  chead = ellipseCache->ellipses;
-  cache_size = ellipseCache->size;
-  for (k = cache_size, cent = chead; --k >= 0; cent++)
+  /* free span data in all records in use */
+  for (k = 0; k < ellipseCache->count; k++)
     {
       miArcSpanData *spdata;
       
-      spdata = cent->spdata;
-      if (spdata)
-	{
-	  free (spdata->spans);
-	  free (spdata);
-	}
+      spdata = ellipseCache->ellipses[k].spdata;
+      free (spdata->spans);
+      free (spdata);
     }
-  /* free the record array itself */
-  free (chead);
+  /* free the record array and hash table themselves */
+  if (ellipseCache->size > 0)
+    free (ellipseCache->ellipses);
+  free (ellipseCache->buckets);
 
   /* free pointer */
   free (ellipseCache);
 }
 
+/* Retrieve statistics on the use of a cache of rasterized ellipses. */
+void
+miGetEllipseCacheStats (const miEllipseCache *ellipseCache, miEllipseCacheStats *stats)
+{
+  *stats = ellipseCache->stats;
+  stats->count = ellipseCache->count;
+}
+
+/* Add the hit, miss, etc. counts of one cache of rasterized ellipses to
+   those of another (e.g., when the first was used temporarily by a worker
+   thread, on behalf of the second). */
+void
+miAccumEllipseCacheStats (miEllipseCache *ellipseCache, const miEllipseCache *other)
+{
+  ellipseCache->stats.hits += other->stats.hits;
+  ellipseCache->stats.misses += other->stats.misses;
+  ellipseCache->stats.evictions += other->stats.evictions;
+  ellipseCache->stats.uncacheable += other->stats.uncacheable;
+}
+
 /* Draw a single arc segment to an miAccumSpans struct, via drawArc() or
  * drawZeroArc().  Right and left faces may be specified, for mirroring
  * purposes (they're usually computed by miComputeArcs()).  The
@@ -704,8 +745,8 @@ miFillWideEllipse (miPaintedSet *paintedSet, miPixel pixel, const miGC *pGC, con
 
   /* allocate span array; will fill it from both ends, so that it will be
      sorted (i.e. in y-increasing order) */
-  pptInit = (miPoint *)mi_xmalloc (numSpans * sizeof(miPoint));
-  pwidthInit = (unsigned int *)mi_xmalloc (numSpans * sizeof(unsigned int));
+  pptInit = MI_ALLOC_SPAN_POINTS(paintedSet, numSpans);
+  pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, numSpans);
   ppt_downward = pptInit;
   pwidth_downward = pwidthInit;
   ppt_upward = pptInit + (numSpans - 1);
@@ -845,78 +886,114 @@ static miArcSpanData *
 miComputeWideEllipse (unsigned int lw, const miArc *parc, bool *mustFree, miEllipseCache *ellipseCache)
 {
   miArcSpanData *spdata;
-  cachedEllipse *cent, *lruent;
-  int k, cache_size;
-  cachedEllipse fakeent;
+  cachedEllipse *cent, **pcent;
+  unsigned int hash;
+  int k;
 
   /* map zero line width to width unity */
   if (lw == 0)
     lw = 1;
+  /* will need space for k+2 spans */
+  k = (int)(parc->height >> 1) + (int)((lw - 1) >> 1);
 
-  /* first, attempt to retrieve span data from cache */
-  if (parc->height <= MAX_CACHEABLE_ELLIPSE_HEIGHT)
+  if (parc->height > MAX_CACHEABLE_ELLIPSE_HEIGHT || ellipseCache->size == 0)
+    /* height is huge, or there is no cache, so ellipse won't be stored in
+       cache; caller will need to free it */
+    {
+      ellipseCache->stats.uncacheable++;
+      *mustFree = true;
+      spdata = (miArcSpanData *)mi_xmalloc (sizeof(miArcSpanData));
+      spdata->spans = (miArcSpan *)mi_xmalloc ((k + 2) * sizeof (miArcSpan));
+      spdata->k = k;
+    }
+  else
     {
       *mustFree = false;
-      cent = ellipseCache->lastCacheHit;
-      if (cent->lw == lw 
-	  && cent->width == parc->width && cent->height == parc->height)
-	/* last hit is still valid; won't need to search */
+
+      /* first, attempt to retrieve span data from cache, by searching the
+	 hash chain on which the key must lie */
+      hash = miHashEllipseKey (parc->width, parc->height, lw)
+	& (ellipseCache->nbuckets - 1);
+      for (cent = ellipseCache->buckets[hash]; cent; cent = cent->hashNext)
+	if (cent->lw == lw 
+	    && cent->width == parc->width && cent->height == parc->height)
+	  /* already in cache: a hit */
+	  {
+	    ellipseCache->stats.hits++;
+	    if (cent != ellipseCache->mru)
+	      /* move to front of LRU list */
+	      {
+		cent->lruPrev->lruNext = cent->lruNext;
+		if (cent->lruNext)
+		  cent->lruNext->lruPrev = cent->lruPrev;
+		else
+		  ellipseCache->lru = cent->lruPrev;
+		cent->lruPrev = (cachedEllipse *)NULL;
+		cent->lruNext = ellipseCache->mru;
+		ellipseCache->mru->lruPrev = cent;
+		ellipseCache->mru = cent;
+	      }
+	    return cent->spdata;
+	  }
+      ellipseCache->stats.misses++;
+
+      /* data not found in cache, so use an unused record, or if there are
+	 none, boot least-recently used record out of cache */
+      if (ellipseCache->count < ellipseCache->size)
 	{
-	  /* hit again; do timestamp, bumping time */
-	  cent->lrustamp = ++(ellipseCache->lrustamp);
-	  return cent->spdata;
+	  cent = &(ellipseCache->ellipses[ellipseCache->count++]);
+	  cent->spdata = (miArcSpanData *)NULL;
 	}
-      /* search cache (an array), beginning at 0'th element */
-      lruent = ellipseCache->ellipses;
-      cache_size = ellipseCache->size;
-      for (k = cache_size, cent = lruent; --k >= 0; cent++)
+      else
 	{
-	  /* key on width, height, linewidth */
-	  if (cent->lw == lw 
-	      && cent->width == parc->width && cent->height == parc->height)
-	    /* already in cache: a hit */
-	    {
-	      /* do timestamp, bumping time */
-	      cent->lrustamp = ++(ellipseCache->lrustamp);
-	      ellipseCache->lastCacheHit = cent;
-	      return cent->spdata;
-	    }
-	  /* keep track of least recently used record */
-	  if (cent->lrustamp < lruent->lrustamp)
-	    lruent = cent;
+	  unsigned int oldhash;
+
+	  ellipseCache->stats.evictions++;
+	  cent = ellipseCache->lru;
+	  /* remove from LRU list */
+	  ellipseCache->lru = cent->lruPrev;
+	  if (cent->lruPrev)
+	    cent->lruPrev->lruNext = (cachedEllipse *)NULL;
+	  else
+	    ellipseCache->mru = (cachedEllipse *)NULL;
+	  /* remove from hash chain */
+	  oldhash = miHashEllipseKey (cent->width, cent->height, cent->lw)
+	    & (ellipseCache->nbuckets - 1);
+	  for (pcent = &(ellipseCache->buckets[oldhash]); *pcent != cent;
+	       pcent = &((*pcent)->hashNext))
+	    ;
+	  *pcent = cent->hashNext;
 	}
-    } 
-  else /* height is huge, ellipse wouldn't be stored in cache */
-    {
-      lruent = &fakeent;	/* _very_ fake; automatic variable */
-      lruent->spdata = (miArcSpanData *)NULL;
-      *mustFree = true;
-    }
-
-  /* data not found in cache, so boot least-recently used record out of
-     cache, make new one; unless ellipse is too large, that is */
 
-  spdata = lruent->spdata;
-  /* will allocate space for k+2 spans */
-  k = (int)(parc->height >> 1) + (int)((lw - 1) >> 1);
-  if (spdata == (miArcSpanData *)NULL || spdata->k != k)
-    {
-      if (spdata)
+      /* reuse record's span data if it's the right size */
+      spdata = cent->spdata;
+      if (spdata == (miArcSpanData *)NULL || spdata->k != k)
 	{
-	  free (spdata->spans);
-	  free (spdata);
+	  if (spdata)
+	    {
+	      free (spdata->spans);
+	      free (spdata);
+	    }
+	  spdata = (miArcSpanData *)mi_xmalloc (sizeof(miArcSpanData));
+	  spdata->spans = (miArcSpan *)mi_xmalloc ((k + 2) * sizeof (miArcSpan));
+	  spdata->k = k;	/* k+2 is size of empty span array */
+	  cent->spdata = spdata;
 	}
-      spdata = (miArcSpanData *)mi_xmalloc (sizeof(miArcSpanData));
-      spdata->spans = (miArcSpan *)mi_xmalloc ((k + 2) * sizeof (miArcSpan));
-      spdata->k = k;		/* k+2 is size of empty span array */
-      lruent->spdata = spdata;
+      cent->lw = lw;
+      cent->width = parc->width;
+      cent->height = parc->height;
+
+      /* insert in hash chain, and at front of LRU list */
+      cent->hashNext = ellipseCache->buckets[hash];
+      ellipseCache->buckets[hash] = cent;
+      cent->lruPrev = (cachedEllipse *)NULL;
+      cent->lruNext = ellipseCache->mru;
+      if (ellipseCache->mru)
+	ellipseCache->mru->lruPrev = cent;
+      else
+	ellipseCache->lru = cent;
+      ellipseCache->mru = cent;
     }
-  lruent->lrustamp = ++(ellipseCache->lrustamp);	/* set timestamp, bump clock */
-  lruent->lw = lw;
-  lruent->width = parc->width;
-  lruent->height = parc->height;
-  if (lruent != &fakeent)	/* non-huge ellipse; store in cache */
-    ellipseCache->lastCacheHit = lruent;
 
   /* compute spans, place them in the new cache record */
   if (parc->width == parc->height)
@@ -926,6 +1003,18 @@ miComputeWideEllipse (unsigned int lw, const miArc *parc, bool *mustFree, miElli
   return spdata;
 }
 
+/* Hash an ellipse cache key, mixing the bits of width, height and line
+   width into the low-order bits of the result. */
+static unsigned int
+miHashEllipseKey (unsigned int width, unsigned int height, unsigned int lw)
+{
+  unsigned int hash;
+
+  hash = (width * 31U + height) * 31U + lw;
+  hash *= 2654435761U;
+  return hash ^ (hash >> 16);
+}
+
 /* Compute the spans that make up a complete wide circle, via a fast
    integer algorithm.  On entry, lw>=1, and `spdata' is a pointer to an
    miArcSpanData struct, which is a slot in a record in the ellipse span
@@ -3312,8 +3401,8 @@ fillSpans (miPaintedSet *paintedSet, miPixel pixel, miAccumSpans *accumSpans)
     return;
 
   /* from the miAccumSpans struct, construct an array of spans */
-  ppt = pptInit = (miPoint *) mi_xmalloc (accumSpans->nspans * sizeof (miPoint));
-  pwidth = pwidthInit = (unsigned int *) mi_xmalloc (accumSpans->nspans * sizeof (unsigned int));
+  ppt = pptInit = MI_ALLOC_SPAN_POINTS(paintedSet, accumSpans->nspans);
+  pwidth = pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, accumSpans->nspans);
 
   for (spany = accumSpans->finalMiny, f = accumSpans->finalSpans; 
        spany <= accumSpans->finalMaxy; 
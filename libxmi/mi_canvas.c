@@ -27,6 +27,36 @@
 #include "mi_spans.h"
 #include "mi_api.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Painting of spans onto a canvas, by miPaintCanvas() below, is done by
+   one of several kernels, each of which paints a single run of pixels
+   (part of a row) in a particular way: a solid color merged by the
+   default algorithm, texture pixels merged by the default algorithm, or
+   pixels merged by user-specified functions.  If the canvas has a
+   stipple, a further kernel splits each run into the sub-runs that the
+   stipple allows to be painted, and passes them to one of the others.
+   The kernels are selected once per list of spans, and pattern
+   coordinates advance incrementally along each run. */
+
+/* number of pixels that are merged at a time by the custom-merge kernel */
+#define MI_MERGE_CHUNK 256
+
+typedef struct lib_miPaintState miPaintState;
+
+typedef void (*miPaintKernel) (const miPaintState *state, int y, int xstart, int xend);
+
+struct lib_miPaintState
+{
+  miCanvas *canvas;		/* canvas being painted */
+  miPixel pixel;		/* source pixel */
+  int stippleXOrigin, stippleYOrigin; /* normalized to be nonpositive */
+  int textureXOrigin, textureYOrigin; /* normalized to be nonpositive */
+  miPaintKernel paintRun;	/* kernel for an unstippled run */
+};
+
 /* forward references (these are currently used only in this file) */
 static miPixmap * miNewPixmap (unsigned int width, unsigned int height, miPixel initPixel);
 static miPixmap * miCopyPixmap (const miPixmap *pPixmap);
@@ -36,7 +66,21 @@ static miBitmap * miNewBitmap (unsigned int width, unsigned int height, int init
 #endif
 static miBitmap * miCopyBitmap (const miBitmap *pBitmap);
 static void miDeleteBitmap (miBitmap *pBitmap);
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+static miPackedPixmap * miNewPackedPixmap (unsigned int width, unsigned int height, miPackedFormat format, miPixel initPixel);
+static miPackedPixmap * miCopyPackedPixmap (const miPackedPixmap *pPacked);
+static void miDeletePackedPixmap (miPackedPixmap *pPacked);
+static void miFillRGBA32 (miRGBA32 *row, miRGBA32 value, int count);
+static void miFillPackedSpans (const miPackedPixmap *pPacked, miPixel pixel, int n, const miPoint *ppt, const unsigned int *pwidth, miPoint offset);
+#endif
+static void miGetCanvasRun (const miCanvas *canvas, int y, int xstart, int count, miPixel *pixels);
+static void miGetTextureRun (const miPaintState *state, int y, int xstart, int count, miPixel *pixels);
 static void miPaintCanvas (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const unsigned int *pwidth, miPoint offset);
+static void miPaintRunMerged (const miPaintState *state, int y, int xstart, int xend);
+static void miPaintRunSolid (const miPaintState *state, int y, int xstart, int xend);
+static void miPaintRunStippled (const miPaintState *state, int y, int xstart, int xend);
+static void miPaintRunTextured (const miPaintState *state, int y, int xstart, int xend);
+static void miSetCanvasRun (miCanvas *canvas, int y, int xstart, int count, const miPixel *pixels);
 
 /* Ctor/dtor/copy ctor for the miCanvas class.  These are defined only if
    the symbol MI_CANVAS_DRAWABLE_TYPE hasn't been defined by the libxmi
@@ -57,12 +101,15 @@ miNewCanvas (unsigned int width, unsigned int height, miPixel initPixel)
 
   new_pCanvas = (miCanvas *)mi_xmalloc (sizeof (miCanvas));
   new_pCanvas->drawable = miNewPixmap (width, height, initPixel);
+  new_pCanvas->packed = (miPackedPixmap *)NULL;
 
   /* default values */
   new_pCanvas->texture = (miPixmap *)NULL;
   new_pCanvas->stipple = (miBitmap *)NULL;
   new_pCanvas->pixelMerge2 = (miPixelMerge2)NULL;
   new_pCanvas->pixelMerge3 = (miPixelMerge3)NULL;
+  new_pCanvas->spanMerge2 = (miSpanMerge2)NULL;
+  new_pCanvas->spanMerge3 = (miSpanMerge3)NULL;
 
   return new_pCanvas;
 }
@@ -78,8 +125,11 @@ miCopyCanvas (const miCanvas *pCanvas)
 
   new_pCanvas = (miCanvas *)mi_xmalloc (sizeof (miCanvas));
   new_pCanvas->drawable = miCopyPixmap (pCanvas->drawable);
+  new_pCanvas->packed = miCopyPackedPixmap (pCanvas->packed);
   new_pCanvas->pixelMerge2 = pCanvas->pixelMerge2;
   new_pCanvas->pixelMerge3 = pCanvas->pixelMerge3;
+  new_pCanvas->spanMerge2 = pCanvas->spanMerge2;
+  new_pCanvas->spanMerge3 = pCanvas->spanMerge3;
   new_pCanvas->texture = miCopyPixmap (pCanvas->texture);
   new_pCanvas->stipple = miCopyBitmap (pCanvas->stipple);
 
@@ -94,11 +144,181 @@ miDeleteCanvas (miCanvas *pCanvas)
     return;
 
   miDeletePixmap (pCanvas->drawable);
+  miDeletePackedPixmap (pCanvas->packed);
   miDeletePixmap (pCanvas->texture);
   miDeleteBitmap (pCanvas->stipple);
   free (pCanvas);
 }
 
+/* create (allocate) a new miCanvas, with a packed drawable */
+miCanvas * 
+miNewPackedCanvas (unsigned int width, unsigned int height, miPackedFormat format, miPixel initPixel)
+{
+  miCanvas *new_pCanvas;
+  
+  if (width < 1 || height < 1)
+    return (miCanvas *)NULL;
+
+  new_pCanvas = (miCanvas *)mi_xmalloc (sizeof (miCanvas));
+  new_pCanvas->drawable = (miCanvasPixmap *)NULL;
+  new_pCanvas->packed = miNewPackedPixmap (width, height, format, initPixel);
+
+  /* default values */
+  new_pCanvas->texture = (miPixmap *)NULL;
+  new_pCanvas->stipple = (miBitmap *)NULL;
+  new_pCanvas->pixelMerge2 = (miPixelMerge2)NULL;
+  new_pCanvas->pixelMerge3 = (miPixelMerge3)NULL;
+  new_pCanvas->spanMerge2 = (miSpanMerge2)NULL;
+  new_pCanvas->spanMerge3 = (miSpanMerge3)NULL;
+
+  return new_pCanvas;
+}
+
+/* create a new miPackedPixmap, and fill it with a specified miPixel */
+static miPackedPixmap * 
+miNewPackedPixmap (unsigned int width, unsigned int height, miPackedFormat format, miPixel initPixel)
+{
+  miPackedPixmap *new_pPacked;
+  unsigned int stride;
+  int j;
+  
+  new_pPacked = (miPackedPixmap *)mi_xmalloc (sizeof(miPackedPixmap));
+
+  /* each row is padded to a multiple of 16 bytes, so that rows can be
+     filled a vector register at a time */
+  stride = (format == MI_PACKED_RGBA32 ? 4 * width : width);
+  stride = (stride + 15) & ~(unsigned int)15;
+
+  new_pPacked->data = (unsigned char *)mi_xmalloc ((size_t)stride * height);
+  new_pPacked->width = width;
+  new_pPacked->height = height;
+  new_pPacked->stride = stride;
+  new_pPacked->format = format;
+
+  for (j = 0; j < (int)height; j++)
+    {
+      if (format == MI_PACKED_RGBA32)
+	miFillRGBA32 (MI_PACKED_RGBA32_ROW(new_pPacked, j),
+		      MI_PIXEL_TO_RGBA32(initPixel), (int)width);
+      else
+	memset (MI_PACKED_INDEX8_ROW(new_pPacked, j),
+		(int)MI_PIXEL_TO_INDEX8(initPixel), (size_t)width);
+    }
+
+  return new_pPacked;
+}
+
+/* copy a miPackedPixmap */
+static miPackedPixmap * 
+miCopyPackedPixmap (const miPackedPixmap *pPacked)
+{
+  miPackedPixmap *new_pPacked;
+  
+  if (pPacked == (const miPackedPixmap *)NULL)
+    return (miPackedPixmap *)NULL;
+
+  new_pPacked = (miPackedPixmap *)mi_xmalloc (sizeof(miPackedPixmap));
+  *new_pPacked = *pPacked;
+  new_pPacked->data = 
+    (unsigned char *)mi_xmalloc ((size_t)pPacked->stride * pPacked->height);
+  memcpy (new_pPacked->data, pPacked->data, 
+	  (size_t)pPacked->stride * pPacked->height);
+
+  return new_pPacked;
+}
+
+/* destroy (deallocate) an miPackedPixmap */
+static void
+miDeletePackedPixmap (miPackedPixmap *pPacked)
+{
+  if (pPacked == (miPackedPixmap *)NULL)
+    return;
+
+  free (pPacked->data);
+  free (pPacked);
+}
+
+/* Fill a run of packed RGBA32 pixels with a single value.  If SSE2 is
+   available, the aligned interior of the run is filled 4 pixels (16 bytes)
+   at a time. */
+static void
+miFillRGBA32 (miRGBA32 *row, miRGBA32 value, int count)
+{
+#ifdef __SSE2__
+  __m128i vec;
+
+  /* fill up to a 16-byte boundary */
+  while (count > 0 && ((size_t)row & 15) != 0)
+    {
+      *row++ = value;
+      count--;
+    }
+  vec = _mm_set1_epi32 ((int)value);
+  while (count >= 8)
+    {
+      _mm_store_si128 ((__m128i *)row, vec);
+      _mm_store_si128 ((__m128i *)(row + 4), vec);
+      row += 8;
+      count -= 8;
+    }
+  if (count >= 4)
+    {
+      _mm_store_si128 ((__m128i *)row, vec);
+      row += 4;
+      count -= 4;
+    }
+#endif
+  while (count > 0)
+    {
+      *row++ = value;
+      count--;
+    }
+}
+
+/* Fill a list of spans, in a specified miPixel color, on a packed pixmap;
+   each span is clipped, and filled as a single run.  The spans may be in
+   any order. */
+static void
+miFillPackedSpans (const miPackedPixmap *pPacked, miPixel pixel, int n, const miPoint *ppt, const unsigned int *pwidth, miPoint offset)
+{
+  int i, y, xstart, xend;
+  int xright = (int)pPacked->width - 1;
+  int ybottom = (int)pPacked->height - 1;
+
+  if (pPacked->format == MI_PACKED_RGBA32)
+    {
+      miRGBA32 value = MI_PIXEL_TO_RGBA32(pixel);
+
+      for (i = 0; i < n; i++)
+	{
+	  y = ppt[i].y + offset.y;
+	  if (y < 0 || y > ybottom)
+	    continue;
+	  xstart = IMAX(ppt[i].x + offset.x, 0);
+	  xend = IMIN(ppt[i].x + offset.x + (int)pwidth[i] - 1, xright);
+	  if (xstart <= xend)
+	    miFillRGBA32 (MI_PACKED_RGBA32_ROW(pPacked, y) + xstart,
+			  value, xend - xstart + 1);
+	}
+    }
+  else
+    {
+      unsigned char value = MI_PIXEL_TO_INDEX8(pixel);
+
+      for (i = 0; i < n; i++)
+	{
+	  y = ppt[i].y + offset.y;
+	  if (y < 0 || y > ybottom)
+	    continue;
+	  xstart = IMAX(ppt[i].x + offset.x, 0);
+	  xend = IMIN(ppt[i].x + offset.x + (int)pwidth[i] - 1, xright);
+	  if (xstart <= xend)
+	    memset (MI_PACKED_INDEX8_ROW(pPacked, y) + xstart,
+		    (int)value, (size_t)(xend - xstart + 1));
+	}
+    }
+}
+
 #endif /* not MI_CANVAS_DRAWABLE_TYPE */
 
 /* create a new miPixmap, and fill it with a specified miPixel */
@@ -270,6 +490,24 @@ miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3)
   pCanvas->pixelMerge3 = pixelMerge3;
 }
 
+/* set the binary span-merging function in an miCanvas */
+void 
+miSetSpanMerge2 (miCanvas *pCanvas, miSpanMerge2 spanMerge2)
+{
+  if (pCanvas == (miCanvas *)NULL)
+    return;
+  pCanvas->spanMerge2 = spanMerge2;
+}
+
+/* set the ternary span-merging function in an miCanvas */
+void 
+miSetSpanMerge3 (miCanvas *pCanvas, miSpanMerge3 spanMerge3)
+{
+  if (pCanvas == (miCanvas *)NULL)
+    return;
+  pCanvas->spanMerge3 = spanMerge3;
+}
+
 /* Copy a stipple miBitmap into an miCanvas.  The old stipple, if any, is
    deallocated. */
 void 
@@ -296,6 +534,296 @@ miSetCanvasTexture (miCanvas *pCanvas, const miPixmap *pTexture, miPoint texture
   pCanvas->textureOrigin = textureOrigin;
 }
 
+/* Paint a list of spans, in a specified miPixel color, straight onto a
+   canvas, on behalf of an immediate-mode miPaintedSet (see mi_spans.c).
+   The spans may be in any order, and may overlap.  This is possible only
+   if painting a pixel twice does no harm, i.e., if the painter's algorithm
+   is used, and there is no stipple or texture; if not, false is returned
+   and nothing is painted. */
+bool
+miPaintSpansImmediately (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const unsigned int *pwidth, miPoint offset)
+{
+#ifdef MI_DEFAULT_MERGE2_IS_REPLACE
+  int i, x, y, xstart, xend;
+  int xleft, xright, ybottom, ytop;
+
+  if (canvas->stipple != (miBitmap *)NULL
+      || canvas->texture != (miPixmap *)NULL
+      || canvas->pixelMerge2 != (miPixelMerge2)NULL
+      || canvas->spanMerge2 != (miSpanMerge2)NULL)
+    return false;
+
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  if (canvas->packed != (miPackedPixmap *)NULL)
+    {
+      miFillPackedSpans (canvas->packed, pixel, n, ppt, pwidth, offset);
+      return true;
+    }
+#endif
+
+  MI_GET_CANVAS_DRAWABLE_BOUNDS(canvas, xleft, ytop, xright, ybottom)
+  for (i = 0; i < n; i++)
+    {
+      y = ppt[i].y + offset.y;
+      if (y < ytop || y > ybottom)
+	continue;
+      xstart = IMAX(ppt[i].x + offset.x, xleft);
+      xend = IMIN(ppt[i].x + offset.x + (int)pwidth[i] - 1, xright);
+      for (x = xstart; x <= xend; x++) /* may be empty */
+	MI_SET_CANVAS_DRAWABLE_PIXEL(canvas, x, y, pixel);
+    }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* Read a run of pixels from a row of a canvas's drawable. */
+static void
+miGetCanvasRun (const miCanvas *canvas, int y, int xstart, int count, miPixel *pixels)
+{
+  int i;
+
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  if (canvas->packed == (miPackedPixmap *)NULL)
+    {
+      const miPixel *row = canvas->drawable->pixmap[y] + xstart;
+
+      for (i = 0; i < count; i++)
+	pixels[i] = row[i];
+    }
+  else if (canvas->packed->format == MI_PACKED_RGBA32)
+    {
+      const miRGBA32 *row = MI_PACKED_RGBA32_ROW(canvas->packed, y) + xstart;
+
+      for (i = 0; i < count; i++)
+	MI_RGBA32_TO_PIXEL(row[i], pixels[i])
+    }
+  else
+    {
+      const unsigned char *row = MI_PACKED_INDEX8_ROW(canvas->packed, y) + xstart;
+
+      for (i = 0; i < count; i++)
+	MI_INDEX8_TO_PIXEL(row[i], pixels[i])
+    }
+#else
+  for (i = 0; i < count; i++)
+    MI_GET_CANVAS_DRAWABLE_PIXEL(canvas, xstart + i, y, pixels[i]);
+#endif
+}
+
+/* Write a run of pixels to a row of a canvas's drawable. */
+static void
+miSetCanvasRun (miCanvas *canvas, int y, int xstart, int count, const miPixel *pixels)
+{
+  int i;
+
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  if (canvas->packed == (miPackedPixmap *)NULL)
+    {
+      miPixel *row = canvas->drawable->pixmap[y] + xstart;
+
+      for (i = 0; i < count; i++)
+	row[i] = pixels[i];
+    }
+  else if (canvas->packed->format == MI_PACKED_RGBA32)
+    {
+      miRGBA32 *row = MI_PACKED_RGBA32_ROW(canvas->packed, y) + xstart;
+
+      for (i = 0; i < count; i++)
+	row[i] = MI_PIXEL_TO_RGBA32(pixels[i]);
+    }
+  else
+    {
+      unsigned char *row = MI_PACKED_INDEX8_ROW(canvas->packed, y) + xstart;
+
+      for (i = 0; i < count; i++)
+	row[i] = MI_PIXEL_TO_INDEX8(pixels[i]);
+    }
+#else
+  for (i = 0; i < count; i++)
+    MI_SET_CANVAS_DRAWABLE_PIXEL(canvas, xstart + i, y, pixels[i]);
+#endif
+}
+
+/* Read the texture pixels that tile a run of a canvas.  Only one modulo
+   operation per coordinate is needed; the texture column wraps around as
+   the run is traversed. */
+static void
+miGetTextureRun (const miPaintState *state, int y, int xstart, int count, miPixel *pixels)
+{
+  const miPixmap *texture = state->canvas->texture;
+  const miPixel *row;
+  unsigned int column;
+  int i;
+
+  row = texture->pixmap[(unsigned int)(y - state->textureYOrigin) % texture->height];
+  column = (unsigned int)(xstart - state->textureXOrigin) % texture->width;
+  for (i = 0; i < count; i++)
+    {
+      pixels[i] = row[column];
+      if (++column == texture->width)
+	column = 0;
+    }
+}
+
+/* Kernel: paint a run in the source pixel, using the default binary
+   merging algorithm. */
+static void
+miPaintRunSolid (const miPaintState *state, int y, int xstart, int xend)
+{
+#ifdef MI_DEFAULT_MERGE2_IS_REPLACE
+  miCanvas *canvas = state->canvas;
+
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  if (canvas->packed != (miPackedPixmap *)NULL)
+    {
+      if (canvas->packed->format == MI_PACKED_RGBA32)
+	miFillRGBA32 (MI_PACKED_RGBA32_ROW(canvas->packed, y) + xstart,
+		      MI_PIXEL_TO_RGBA32(state->pixel), xend - xstart + 1);
+      else
+	memset (MI_PACKED_INDEX8_ROW(canvas->packed, y) + xstart,
+		(int)MI_PIXEL_TO_INDEX8(state->pixel),
+		(size_t)(xend - xstart + 1));
+    }
+  else
+    {
+      miPixel *row = canvas->drawable->pixmap[y];
+      int x;
+
+      for (x = xstart; x <= xend; x++)
+	row[x] = state->pixel;
+    }
+#else
+  int x;
+
+  for (x = xstart; x <= xend; x++)
+    MI_SET_CANVAS_DRAWABLE_PIXEL(canvas, x, y, state->pixel);
+#endif /* MI_CANVAS_DRAWABLE_TYPE */
+
+#else  /* not MI_DEFAULT_MERGE2_IS_REPLACE */
+  miPixel pixels[MI_MERGE_CHUNK];
+  int count, i;
+
+  for ( ; xstart <= xend; xstart += count)
+    {
+      count = IMIN(xend - xstart + 1, MI_MERGE_CHUNK);
+      miGetCanvasRun (state->canvas, y, xstart, count, pixels);
+      for (i = 0; i < count; i++)
+	MI_DEFAULT_MERGE2_PIXEL(pixels[i], state->pixel, pixels[i]);
+      miSetCanvasRun (state->canvas, y, xstart, count, pixels);
+    }
+#endif /* not MI_DEFAULT_MERGE2_IS_REPLACE */
+}
+
+/* Kernel: paint a run with the texture, using the default ternary merging
+   algorithm. */
+static void
+miPaintRunTextured (const miPaintState *state, int y, int xstart, int xend)
+{
+  miPixel textures[MI_MERGE_CHUNK];
+#ifndef MI_DEFAULT_MERGE3_IS_TEXTURE
+  miPixel pixels[MI_MERGE_CHUNK];
+  int i;
+#endif
+  int count;
+
+  for ( ; xstart <= xend; xstart += count)
+    {
+      count = IMIN(xend - xstart + 1, MI_MERGE_CHUNK);
+      miGetTextureRun (state, y, xstart, count, textures);
+#ifdef MI_DEFAULT_MERGE3_IS_TEXTURE
+      miSetCanvasRun (state->canvas, y, xstart, count, textures);
+#else
+      miGetCanvasRun (state->canvas, y, xstart, count, pixels);
+      for (i = 0; i < count; i++)
+	MI_DEFAULT_MERGE3_PIXEL(pixels[i], textures[i], state->pixel, pixels[i]);
+      miSetCanvasRun (state->canvas, y, xstart, count, pixels);
+#endif
+    }
+}
+
+/* Kernel: paint a run using the canvas's user-specified merging function,
+   span-at-a-time if available, otherwise pixel-at-a-time.  The
+   destination pixels (and texture pixels, if any) are gathered into
+   buffers, merged, and written back. */
+static void
+miPaintRunMerged (const miPaintState *state, int y, int xstart, int xend)
+{
+  const miCanvas *canvas = state->canvas;
+  miPixel pixels[MI_MERGE_CHUNK], textures[MI_MERGE_CHUNK];
+  bool textured = (canvas->texture != (miPixmap *)NULL);
+  int count, i;
+
+  for ( ; xstart <= xend; xstart += count)
+    {
+      count = IMIN(xend - xstart + 1, MI_MERGE_CHUNK);
+      miGetCanvasRun (canvas, y, xstart, count, pixels);
+      if (textured)
+	{
+	  miGetTextureRun (state, y, xstart, count, textures);
+	  if (canvas->spanMerge3 != (miSpanMerge3)NULL)
+	    (*canvas->spanMerge3)(textures, state->pixel, pixels, count);
+	  else if (canvas->pixelMerge3 != (miPixelMerge3)NULL)
+	    for (i = 0; i < count; i++)
+	      pixels[i] = (*canvas->pixelMerge3)(textures[i], state->pixel, 
+						 pixels[i]);
+	  else
+	    for (i = 0; i < count; i++)
+	      MI_DEFAULT_MERGE3_PIXEL(pixels[i], textures[i], state->pixel, 
+				      pixels[i]);
+	}
+      else
+	{
+	  if (canvas->spanMerge2 != (miSpanMerge2)NULL)
+	    (*canvas->spanMerge2)(state->pixel, pixels, count);
+	  else if (canvas->pixelMerge2 != (miPixelMerge2)NULL)
+	    for (i = 0; i < count; i++)
+	      pixels[i] = (*canvas->pixelMerge2)(state->pixel, pixels[i]);
+	  else
+	    for (i = 0; i < count; i++)
+	      MI_DEFAULT_MERGE2_PIXEL(pixels[i], state->pixel, pixels[i]);
+	}
+      miSetCanvasRun (state->canvas, y, xstart, count, pixels);
+    }
+}
+
+/* Kernel: paint those parts of a run that the canvas's stipple allows to
+   be painted, by passing each maximal sub-run of nonzero stipple bits to
+   the kernel for unstippled runs. */
+static void
+miPaintRunStippled (const miPaintState *state, int y, int xstart, int xend)
+{
+  const miBitmap *stipple = state->canvas->stipple;
+  const int *row;
+  unsigned int column;
+  int x, runStart = 0;
+  bool inRun = false;
+
+  row = stipple->bitmap[(unsigned int)(y - state->stippleYOrigin) % stipple->height];
+  column = (unsigned int)(xstart - state->stippleXOrigin) % stipple->width;
+  for (x = xstart; x <= xend; x++)
+    {
+      if (row[column] != 0)
+	{
+	  if (!inRun)
+	    {
+	      runStart = x;
+	      inRun = true;
+	    }
+	}
+      else if (inRun)
+	{
+	  (*state->paintRun)(state, y, runStart, x - 1);
+	  inRun = false;
+	}
+      if (++column == stipple->width)
+	column = 0;
+    }
+  if (inRun)
+    (*state->paintRun)(state, y, runStart, xend);
+}
+
 /* Paint a list of spans, in a specified miPixel color, to a canvas.  The
    spans must be in y-increasing order. */
 
@@ -310,76 +838,70 @@ miPaintCanvas (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const
 {
   int i;
   int xleft, xright, ybottom, ytop;
-  unsigned int stippleWidth = 0, stippleHeight = 0; /* keep lint happy */
-  unsigned int textureWidth = 0, textureHeight = 0; /* keep lint happy */
-  int stippleXOrigin = 0, stippleYOrigin = 0; /* keep lint happy */
-  int textureXOrigin = 0, textureYOrigin = 0;	/* keep lint happy */
-  int xstart, xend, xstart_clip, xend_clip, xoffset, yoffset, x, y;
-  unsigned int width;
-  const miCanvas *pCanvas;	/* `const' should be OK here */
-  miPixelMerge2 pixelMerge2;
-  miPixelMerge3 pixelMerge3;
-
-  pCanvas = canvas;
+  int xstart, xend, xoffset, yoffset, y;
+  miPaintState state;
+  miPaintKernel paintSpan;
+
   xoffset = offset.x;
   yoffset = offset.y;
 
   /* compute bounds of destination drawable */
-  MI_GET_CANVAS_DRAWABLE_BOUNDS(pCanvas, xleft, ytop, xright, ybottom)
+  MI_GET_CANVAS_DRAWABLE_BOUNDS(canvas, xleft, ytop, xright, ybottom)
 
   /* if source doesn't overlap with destination drawable, do nothing */
   if (ppt[0].y + yoffset > ybottom || ppt[n-1].y + yoffset < ytop)
     return;
 
-  /* determine user-specified merging functions (if any) */
-  pixelMerge2 = pCanvas->pixelMerge2;
-  pixelMerge3 = pCanvas->pixelMerge3;
-
-#define MI_MERGE_CANVAS_PIXEL(pCanvas, x, y, sourcePixel, texturePixel, have_texturePixel) \
-{ \
-  miPixel destinationPixel, newPixel; \
-  MI_GET_CANVAS_DRAWABLE_PIXEL((pCanvas), (x), (y), destinationPixel); \
-  if (!have_texturePixel) \
-    { \
-      if (pixelMerge2 != (miPixelMerge2)NULL) \
-        newPixel = (*pixelMerge2)((sourcePixel), destinationPixel); \
-      else \
-        MI_DEFAULT_MERGE2_PIXEL(newPixel, (sourcePixel), destinationPixel); \
-    } \
-  else \
-    { \
-      if (pixelMerge3 != (miPixelMerge3)NULL) \
-        newPixel = (*pixelMerge3)((texturePixel), (sourcePixel), destinationPixel); \
-      else \
-        MI_DEFAULT_MERGE3_PIXEL(newPixel, (texturePixel), (sourcePixel), destinationPixel); \
-    } \
-  MI_SET_CANVAS_DRAWABLE_PIXEL((pCanvas), (x), (y), newPixel); \
-}
+#if !defined(MI_CANVAS_DRAWABLE_TYPE) && defined(MI_DEFAULT_MERGE2_IS_REPLACE)
+  /* Fast path: a solid pixel, painted onto a packed drawable with the
+     painter's algorithm.  Each clipped span is filled as a single run. */
+  if (canvas->packed != (miPackedPixmap *)NULL
+      && canvas->stipple == (miBitmap *)NULL 
+      && canvas->texture == (miPixmap *)NULL
+      && canvas->pixelMerge2 == (miPixelMerge2)NULL
+      && canvas->spanMerge2 == (miSpanMerge2)NULL)
+    {
+      miFillPackedSpans (canvas->packed, pixel, n, ppt, pwidth, offset);
+      return;
+    }
+#endif
+
+  state.canvas = canvas;
+  state.pixel = pixel;
+  state.stippleXOrigin = state.stippleYOrigin = 0;
+  state.textureXOrigin = state.textureYOrigin = 0;
 
-  if (pCanvas->stipple)
+  if (canvas->stipple)
     {
-      stippleWidth = pCanvas->stipple->width;
-      stippleHeight = pCanvas->stipple->height;  
-      stippleXOrigin = pCanvas->stippleOrigin.x;
-      stippleYOrigin = pCanvas->stippleOrigin.y;
-      while (stippleXOrigin > 0)
-	stippleXOrigin -= stippleWidth;
-      while (stippleYOrigin > 0)
-	stippleYOrigin -= stippleHeight;
+      state.stippleXOrigin = canvas->stippleOrigin.x;
+      state.stippleYOrigin = canvas->stippleOrigin.y;
+      while (state.stippleXOrigin > 0)
+	state.stippleXOrigin -= canvas->stipple->width;
+      while (state.stippleYOrigin > 0)
+	state.stippleYOrigin -= canvas->stipple->height;
     }
   
-  if (pCanvas->texture)
+  if (canvas->texture)
     {
-      textureWidth = pCanvas->texture->width;
-      textureHeight = pCanvas->texture->height;  
-      textureXOrigin = pCanvas->textureOrigin.x;
-      textureYOrigin = pCanvas->textureOrigin.y;
-      while (textureXOrigin > 0)
-	textureXOrigin -= textureWidth;
-      while (textureYOrigin > 0)
-	textureYOrigin -= textureHeight;
+      state.textureXOrigin = canvas->textureOrigin.x;
+      state.textureYOrigin = canvas->textureOrigin.y;
+      while (state.textureXOrigin > 0)
+	state.textureXOrigin -= canvas->texture->width;
+      while (state.textureYOrigin > 0)
+	state.textureYOrigin -= canvas->texture->height;
     }
 
+  /* select kernels */
+  if (canvas->texture)
+    state.paintRun = (canvas->pixelMerge3 == (miPixelMerge3)NULL
+		      && canvas->spanMerge3 == (miSpanMerge3)NULL
+		      ? miPaintRunTextured : miPaintRunMerged);
+  else
+    state.paintRun = (canvas->pixelMerge2 == (miPixelMerge2)NULL
+		      && canvas->spanMerge2 == (miSpanMerge2)NULL
+		      ? miPaintRunSolid : miPaintRunMerged);
+  paintSpan = (canvas->stipple ? miPaintRunStippled : state.paintRun);
+
   for (i = 0; i < n; i++)
     {
       y = ppt[i].y + yoffset;
@@ -387,35 +909,12 @@ miPaintCanvas (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const
 	return;			/* no more spans will be painted */
       if (y >= ytop)
 	{
-	  width = pwidth[i];
-	  xstart = ppt[i].x + xoffset;
-	  xend = xstart + (int)width - 1;
-	  
-	  xstart_clip = IMAX(xstart,xleft);
-	  xend_clip = IMIN(xend,xright);
-	  
-	  for (x = xstart_clip; x <= xend_clip; x++) /* may be empty */
-	    /* merge pixel onto canvas */
-	    {
-	      miPixel texturePixel, sourcePixel;
-	      bool have_texturePixel = false;
-	      
-	      if (pCanvas->texture)
-		{
-		  texturePixel = pCanvas->texture->pixmap[(y-textureYOrigin) % textureHeight][(x-textureXOrigin) % textureWidth];
-		  have_texturePixel = true;
-		}
-	      else
-		texturePixel = pixel; /* dummy; keep lint happy */
-
-	      sourcePixel = pixel;
-	      
-	      if (pCanvas->stipple == (miBitmap *)NULL
-		  || pCanvas->stipple->bitmap[(y-stippleYOrigin) % stippleHeight][(x-stippleXOrigin) % stippleWidth] != 0)
-		MI_MERGE_CANVAS_PIXEL(pCanvas, x, y, sourcePixel, texturePixel, have_texturePixel)
-	    } /* end for x in ... */
-	} /* end if */
-    } /* end for y in ... */
+	  xstart = IMAX(ppt[i].x + xoffset, xleft);
+	  xend = IMIN(ppt[i].x + xoffset + (int)pwidth[i] - 1, xright);
+	  if (xstart <= xend)
+	    (*paintSpan)(&state, y, xstart, xend);
+	}
+    }
 }
 
 /* Copy a miPaintedSet to an miCanvas.  The miPaintedSet is assumed to have
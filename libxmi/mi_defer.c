@@ -0,0 +1,632 @@
+/* This file is part of the GNU libxmi package.  Copyright (C) 2005,
+   Free Software Foundation, Inc.
+
+   The GNU libxmi package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU libxmi package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* This module provides `deferred-mode' miPaintedSets, which record the
+   drawing operations applied to them rather than carrying them out, and
+   the function miRenderDeferredPaintedSet(), which renders the recorded
+   operations onto a miCanvas, possibly in parallel.
+
+   The recorded operations are rendered in batches.  Each batch is
+   rendered in two phases.  In the first, the operations are rasterized,
+   each into a miPaintedSet of its own; this is done by a pool of worker
+   threads, each of which takes the next unrasterized operation.  In the
+   second, the canvas is divided into square tiles, each operation is
+   binned (according to the bounding box of its spans) into the tiles that
+   it touches, and the worker threads composite the tiles, each taking the
+   next uncomposited tile.  Within a tile, the rasterized operations are
+   copied to the canvas in the order in which they were recorded, and no
+   two threads ever write to the same tile.  So the pixels on the canvas
+   end up exactly as if the operations had been carried out one at a time,
+   and copied to the canvas after each. */
+
+#include "sys-defines.h"
+#include "extern.h"
+
+#include "xmi.h"
+#include "mi_spans.h"
+#include "mi_gc.h"
+#include "mi_api.h"
+
+/* Worker threads are used only if libxmi is being compiled as part of
+   libplot/libplotter, and threads can be created. */
+#ifdef LIBPLOT
+#ifdef PTHREAD_SUPPORT
+#ifdef HAVE_PTHREAD_H
+#ifdef PTHREAD_CREATE_SUPPORT
+#define MI_USE_WORKER_THREADS
+#endif
+#endif
+#endif
+#endif
+
+/* width and height of a tile, in pixels */
+#define MI_TILE_SIZE 128
+
+/* number of recorded drawing operations rendered per batch (this bounds
+   the number of rasterized operations that are held in memory) */
+#define MI_DEFER_BATCH_SIZE 256
+
+/* upper limit on the number of worker threads */
+#define MI_MAX_WORKER_THREADS 64
+
+/* A recorded drawing operation.  Its arguments, including the miGC, are
+   copies of those passed to the drawing function. */
+typedef struct
+{
+  int opType;			/* MI_OP_DRAW_POINTS etc., see mi_spans.h */
+  miGC *pGC;			/* copy of graphics context */
+  int mode;			/* miCoordMode, if relevant */
+  int shape;			/* miPolygonShape, if relevant */
+  int n;			/* number of points, rectangles, or arcs */
+  void *data;			/* the points, rectangles, or arcs */
+
+  /* the following are used only while the operation is being rendered */
+  miPaintedSet *paintedSet;	/* result of rasterizing the operation */
+  bool empty;			/* paintedSet contains no spans? */
+  int xmin, ymin, xmax, ymax;	/* bounding box of its spans, if any */
+} miDeferredOp;
+
+/* The list of recorded drawing operations that a deferred-mode
+   miPaintedSet contains. */
+struct lib_miDeferredOps
+{
+  miDeferredOp *ops;		/* recorded operations */
+  int size;			/* number of slots allocated */
+  int count;			/* number of slots filled */
+};
+
+/* The state shared by the worker threads that render a batch of
+   operations.  A `job' is the rasterizing of an operation, or the
+   compositing of a tile. */
+typedef struct
+{
+  miDeferredOp *ops;		/* the batch */
+  int nops;			/* number of operations in it */
+  miCanvas *canvas;		/* destination canvas */
+  miPoint origin;		/* point that (0,0) is mapped to on it */
+  int width, height;		/* size of canvas */
+  int ntilesX, ntilesY;		/* number of tiles in each direction */
+  int *tileStart;		/* for each tile, first entry in tileOps */
+  int *tileOps;			/* operation indices, binned by tile */
+  void (*job) (const void *context, int j, miEllipseCache *ellipseCache);
+  int njobs;			/* number of jobs */
+  int nextJob;			/* next job to be taken by a worker */
+#ifdef MI_USE_WORKER_THREADS
+  pthread_mutex_t lock;		/* protects nextJob */
+#endif
+  int ellipseCacheSize;		/* size of ellipse caches */
+  miEllipseCache *ellipseCaches[MI_MAX_WORKER_THREADS]; /* one per worker,
+				   created when first needed */
+} miRenderContext;
+
+/* The argument passed to a worker thread: the shared state, and the
+   index of the worker (0 for the calling thread). */
+typedef struct
+{
+  miRenderContext *context;
+  int index;
+} miWorker;
+
+/* internal functions */
+static void miRasterizeOp (const void *context, int j, miEllipseCache *ellipseCache);
+static void miCompositeTile (const void *context, int j, miEllipseCache *ellipseCache);
+static void miBinOpsIntoTiles (miRenderContext *context);
+static void miRunJobs (miRenderContext *context, int nthreads);
+static void * miRunJobsWorker (void *context);
+static void miFreeDeferredOp (miDeferredOp *op);
+
+
+/* The following functions are the public functions of this module. */
+
+/* create a deferred-mode miPaintedSet, which contains no recorded
+   operations */
+miPaintedSet *
+miNewDeferredPaintedSet (void)
+{
+  miPaintedSet *paintedSet;
+  miDeferredOps *deferred;
+
+  deferred = (miDeferredOps *)mi_xmalloc (sizeof(miDeferredOps));
+  deferred->ops = (miDeferredOp *)NULL;
+  deferred->size = 0;
+  deferred->count = 0;
+
+  paintedSet = miNewPaintedSet ();
+  paintedSet->deferred = deferred;
+
+  return paintedSet;
+}
+
+/* Render the drawing operations recorded by a deferred-mode miPaintedSet
+   onto a miCanvas, using up to `nthreads' threads, and discard them.  If
+   the miPaintedSet isn't deferred-mode, this does nothing. */
+
+/* ARGS: origin = point that (0,0) is mapped to */
+void
+miRenderDeferredPaintedSet (miPaintedSet *paintedSet, miCanvas *canvas, miPoint origin, int nthreads, miEllipseCache *ellipseCache)
+{
+  miDeferredOps *deferred;
+  miRenderContext context;
+  int xleft, ytop, xright, ybottom;
+  int i, first;
+
+  if (paintedSet == (miPaintedSet *)NULL
+      || paintedSet->deferred == (miDeferredOps *)NULL)
+    return;
+  deferred = paintedSet->deferred;
+
+  if (nthreads > MI_MAX_WORKER_THREADS)
+    nthreads = MI_MAX_WORKER_THREADS;
+
+  MI_GET_CANVAS_DRAWABLE_BOUNDS(canvas, xleft, ytop, xright, ybottom)
+  context.canvas = canvas;
+  context.origin = origin;
+  context.width = xright - xleft + 1;
+  context.height = ybottom - ytop + 1;
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  context.ntilesX = (context.width + MI_TILE_SIZE - 1) / MI_TILE_SIZE;
+  context.ntilesY = (context.height + MI_TILE_SIZE - 1) / MI_TILE_SIZE;
+#else
+  /* we don't know how to construct a view of a portion of the drawable,
+     so the entire canvas is a single tile */
+  context.ntilesX = 1;
+  context.ntilesY = 1;
+#endif
+  context.tileStart =
+    (int *)mi_xmalloc ((context.ntilesX * context.ntilesY + 1) * sizeof(int));
+  context.tileOps = (int *)NULL;
+#ifdef MI_USE_WORKER_THREADS
+  pthread_mutex_init (&context.lock, (const pthread_mutexattr_t *)NULL);
+#endif
+
+  /* the calling thread uses the specified ellipse cache, if any, and the
+     other workers use caches of the same size */
+  for (i = 0; i < MI_MAX_WORKER_THREADS; i++)
+    context.ellipseCaches[i] = (miEllipseCache *)NULL;
+  if (ellipseCache)
+    {
+      miEllipseCacheStats stats;
+
+      miGetEllipseCacheStats (ellipseCache, &stats);
+      context.ellipseCacheSize = stats.size;
+      context.ellipseCaches[0] = ellipseCache;
+    }
+  else
+    context.ellipseCacheSize = -1; /* i.e., default */
+
+  for (first = 0; first < deferred->count; first += MI_DEFER_BATCH_SIZE)
+    {
+      context.ops = deferred->ops + first;
+      context.nops = IMIN(MI_DEFER_BATCH_SIZE, deferred->count - first);
+
+      /* phase 1: rasterize each operation in the batch */
+      context.job = miRasterizeOp;
+      context.njobs = context.nops;
+      miRunJobs (&context, nthreads);
+
+      /* phase 2: composite each tile */
+      miBinOpsIntoTiles (&context);
+      context.job = miCompositeTile;
+      context.njobs = context.ntilesX * context.ntilesY;
+      miRunJobs (&context, nthreads);
+
+      free (context.tileOps);
+      context.tileOps = (int *)NULL;
+      for (i = 0; i < context.nops; i++)
+	{
+	  /* credit the operation's span arena statistics to the
+	     deferred-mode miPaintedSet */
+	  miSpanArenaStats *stats = &(context.ops[i].paintedSet->arena.stats);
+
+	  paintedSet->arena.stats.allocations += stats->allocations;
+	  paintedSet->arena.stats.bytes += stats->bytes;
+	  paintedSet->arena.stats.blocks += stats->blocks;
+	  paintedSet->arena.stats.resets += stats->resets;
+	  miDeletePaintedSet (context.ops[i].paintedSet);
+	  context.ops[i].paintedSet = (miPaintedSet *)NULL;
+	}
+    }
+
+#ifdef MI_USE_WORKER_THREADS
+  pthread_mutex_destroy (&context.lock);
+#endif
+  free (context.tileStart);
+
+  /* delete the ellipse caches created by workers, crediting their
+     statistics to the specified cache */
+  for (i = (ellipseCache ? 1 : 0); i < MI_MAX_WORKER_THREADS; i++)
+    if (context.ellipseCaches[i])
+      {
+	if (ellipseCache)
+	  miAccumEllipseCacheStats (ellipseCache, context.ellipseCaches[i]);
+	miDeleteEllipseCache (context.ellipseCaches[i]);
+      }
+
+  /* discard the recorded operations */
+  for (i = 0; i < deferred->count; i++)
+    miFreeDeferredOp (deferred->ops + i);
+  deferred->count = 0;
+}
+
+/* The following are internal functions, called from elsewhere in libxmi. */
+
+/* Record a drawing operation in a deferred-mode miPaintedSet; called by
+   the API wrappers in mi_api.c.  The miGC, and the array of points,
+   rectangles, or arcs, are copied. */
+void
+miRecordDrawingOp (miPaintedSet *paintedSet, int opType, const miGC *pGC, int mode, int shape, int n, const void *data)
+{
+  miDeferredOps *deferred = paintedSet->deferred;
+  miDeferredOp *op;
+  size_t elementSize;
+
+  if (n <= 0)
+    return;			/* nothing would be drawn */
+
+  switch (opType)
+    {
+    case MI_OP_DRAW_RECTANGLES:
+    case MI_OP_FILL_RECTANGLES:
+      elementSize = sizeof(miRectangle);
+      break;
+    case MI_OP_DRAW_ARCS:
+    case MI_OP_FILL_ARCS:
+      elementSize = sizeof(miArc);
+      break;
+    default:
+      elementSize = sizeof(miPoint);
+      break;
+    }
+
+  if (deferred->count == deferred->size)
+    {
+      deferred->size = (deferred->size == 0 ? 16 : 2 * deferred->size);
+      deferred->ops = (miDeferredOp *)mi_xrealloc (deferred->ops, deferred->size * sizeof(miDeferredOp));
+    }
+  op = deferred->ops + deferred->count++;
+
+  op->opType = opType;
+  op->pGC = miCopyGC (pGC);
+  op->mode = mode;
+  op->shape = shape;
+  op->n = n;
+  op->data = mi_xmalloc (n * elementSize);
+  memcpy (op->data, data, n * elementSize);
+  op->paintedSet = (miPaintedSet *)NULL;
+  op->empty = true;
+}
+
+/* Deallocate the operations recorded by a deferred-mode miPaintedSet;
+   called when the miPaintedSet is deleted. */
+void
+miDeleteDeferredOps (miDeferredOps *deferred)
+{
+  int i;
+
+  if (deferred == (miDeferredOps *)NULL)
+    return;
+
+  for (i = 0; i < deferred->count; i++)
+    miFreeDeferredOp (deferred->ops + i);
+  if (deferred->size > 0)
+    free (deferred->ops);
+  free (deferred);
+}
+
+/* The remaining functions are private to this module. */
+
+/* Phase 1 job: rasterize the j'th operation in the batch into a
+   miPaintedSet of its own (exactly as the API wrappers in mi_api.c would
+   do), and compute the bounding box of the resulting spans. */
+static void
+miRasterizeOp (const void *ptr, int j, miEllipseCache *ellipseCache)
+{
+  const miRenderContext *context = (const miRenderContext *)ptr;
+  miDeferredOp *op = context->ops + j;
+  miPaintedSet *paintedSet;
+  int i, k;
+
+  paintedSet = miNewPaintedSet ();
+  switch (op->opType)
+    {
+    case MI_OP_DRAW_POINTS:
+      miDrawPoints_internal (paintedSet, op->pGC, (miCoordMode)op->mode,
+			     op->n, (const miPoint *)op->data);
+      break;
+    case MI_OP_DRAW_LINES:
+      miDrawLines_internal (paintedSet, op->pGC, (miCoordMode)op->mode,
+			    op->n, (const miPoint *)op->data);
+      break;
+    case MI_OP_FILL_POLYGON:
+      miFillPolygon_internal (paintedSet, op->pGC,
+			      (miPolygonShape)op->shape,
+			      (miCoordMode)op->mode,
+			      op->n, (const miPoint *)op->data);
+      break;
+    case MI_OP_DRAW_RECTANGLES:
+      miDrawRectangles_internal (paintedSet, op->pGC,
+				 op->n, (const miRectangle *)op->data);
+      break;
+    case MI_OP_FILL_RECTANGLES:
+      miFillRectangles_internal (paintedSet, op->pGC,
+				 op->n, (const miRectangle *)op->data);
+      break;
+    case MI_OP_DRAW_ARCS:
+      /* the worker's own cache is used, so this is reentrant */
+      miDrawArcs_r_internal (paintedSet, op->pGC,
+			     op->n, (const miArc *)op->data, ellipseCache);
+      break;
+    case MI_OP_FILL_ARCS:
+      miFillArcs_internal (paintedSet, op->pGC,
+			   op->n, (const miArc *)op->data);
+      break;
+    default:
+      break;
+    }
+  miUniquifyPaintedSet (paintedSet);
+
+  /* compute bounding box; after uniquification, each SpanGroup's spans
+     are in Spans #0, sorted by y */
+  op->empty = true;
+  for (i = 0; i < paintedSet->ngroups; i++)
+    {
+      const Spans *spans = &(paintedSet->groups[i]->group[0]);
+
+      if (paintedSet->groups[i]->count == 0 || spans->count == 0)
+	continue;
+      if (op->empty)
+	{
+	  op->xmin = spans->points[0].x;
+	  op->xmax = spans->points[0].x;
+	  op->ymin = spans->points[0].y;
+	  op->ymax = spans->points[0].y;
+	  op->empty = false;
+	}
+      op->ymin = IMIN(op->ymin, spans->points[0].y);
+      op->ymax = IMAX(op->ymax, spans->points[spans->count - 1].y);
+      for (k = 0; k < spans->count; k++)
+	{
+	  op->xmin = IMIN(op->xmin, spans->points[k].x);
+	  op->xmax = IMAX(op->xmax,
+			  spans->points[k].x + (int)spans->widths[k] - 1);
+	}
+    }
+  op->paintedSet = paintedSet;
+}
+
+/* Bin the rasterized operations in the batch into the tiles that their
+   bounding boxes overlap, preserving their order within each tile.  This
+   is a counting sort: tileStart[t]..tileStart[t+1]-1 are the indices in
+   tileOps of the operations that touch tile t. */
+static void
+miBinOpsIntoTiles (miRenderContext *context)
+{
+  int ntiles = context->ntilesX * context->ntilesY;
+  int tileSizeX, tileSizeY;
+  int *fill;
+  int i, t, tx, ty, total;
+  int tx0 = 0, tx1 = 0, ty0 = 0, ty1 = 0;
+
+  tileSizeX = (context->ntilesX == 1 ? context->width : MI_TILE_SIZE);
+  tileSizeY = (context->ntilesY == 1 ? context->height : MI_TILE_SIZE);
+
+  for (t = 0; t <= ntiles; t++)
+    context->tileStart[t] = 0;
+
+  /* first pass: count the operations touching each tile (counts are
+     accumulated in tileStart[t+1]) */
+  for (i = 0; i < context->nops; i++)
+    {
+      const miDeferredOp *op = context->ops + i;
+
+      if (op->empty
+	  || op->xmax + context->origin.x < 0
+	  || op->ymax + context->origin.y < 0
+	  || op->xmin + context->origin.x > context->width - 1
+	  || op->ymin + context->origin.y > context->height - 1)
+	continue;		/* not visible */
+      tx0 = IMAX(op->xmin + context->origin.x, 0) / tileSizeX;
+      tx1 = IMIN(op->xmax + context->origin.x, context->width - 1) / tileSizeX;
+      ty0 = IMAX(op->ymin + context->origin.y, 0) / tileSizeY;
+      ty1 = IMIN(op->ymax + context->origin.y, context->height - 1) / tileSizeY;
+      for (ty = ty0; ty <= ty1; ty++)
+	for (tx = tx0; tx <= tx1; tx++)
+	  context->tileStart[ty * context->ntilesX + tx + 1]++;
+    }
+  for (t = 0; t < ntiles; t++)
+    context->tileStart[t + 1] += context->tileStart[t];
+  total = context->tileStart[ntiles];
+
+  /* second pass: fill in operation indices, in order */
+  context->tileOps = (int *)mi_xmalloc (IMAX(total, 1) * sizeof(int));
+  fill = (int *)mi_xmalloc (ntiles * sizeof(int));
+  for (t = 0; t < ntiles; t++)
+    fill[t] = context->tileStart[t];
+  for (i = 0; i < context->nops; i++)
+    {
+      const miDeferredOp *op = context->ops + i;
+
+      if (op->empty
+	  || op->xmax + context->origin.x < 0
+	  || op->ymax + context->origin.y < 0
+	  || op->xmin + context->origin.x > context->width - 1
+	  || op->ymin + context->origin.y > context->height - 1)
+	continue;
+      tx0 = IMAX(op->xmin + context->origin.x, 0) / tileSizeX;
+      tx1 = IMIN(op->xmax + context->origin.x, context->width - 1) / tileSizeX;
+      ty0 = IMAX(op->ymin + context->origin.y, 0) / tileSizeY;
+      ty1 = IMIN(op->ymax + context->origin.y, context->height - 1) / tileSizeY;
+      for (ty = ty0; ty <= ty1; ty++)
+	for (tx = tx0; tx <= tx1; tx++)
+	  context->tileOps[fill[ty * context->ntilesX + tx]++] = i;
+    }
+  free (fill);
+}
+
+/* Phase 2 job: composite the j'th tile, by copying each rasterized
+   operation that touches it to a view of the corresponding portion of the
+   canvas, in order.  The view shares the canvas's pixels, so only those
+   within the tile can be written. */
+static void
+miCompositeTile (const void *ptr, int j, miEllipseCache *ellipseCache)
+{
+  const miRenderContext *context = (const miRenderContext *)ptr;
+  miCanvas *canvas = context->canvas;
+  miPoint offset;
+  int k;
+#ifndef MI_CANVAS_DRAWABLE_TYPE
+  miCanvas view;
+  miPixmap viewPixmap;
+  miPackedPixmap viewPacked;
+  int x0, y0, width, height, row;
+
+  if (context->tileStart[j] == context->tileStart[j + 1])
+    return;			/* no operation touches this tile */
+
+  x0 = (j % context->ntilesX) * MI_TILE_SIZE;
+  y0 = (j / context->ntilesX) * MI_TILE_SIZE;
+  width = IMIN(MI_TILE_SIZE, context->width - x0);
+  height = IMIN(MI_TILE_SIZE, context->height - y0);
+
+  view = *canvas;
+  viewPixmap.pixmap = (miPixel **)NULL;
+  if (canvas->packed != (miPackedPixmap *)NULL)
+    {
+      viewPacked = *(canvas->packed);
+      viewPacked.data = canvas->packed->data
+	+ (size_t)y0 * canvas->packed->stride
+	+ (size_t)x0 * (canvas->packed->format == MI_PACKED_RGBA32 ? 4 : 1);
+      viewPacked.width = (unsigned int)width;
+      viewPacked.height = (unsigned int)height;
+      view.packed = &viewPacked;
+    }
+  else
+    {
+      viewPixmap.pixmap = (miPixel **)mi_xmalloc (height * sizeof(miPixel *));
+      for (row = 0; row < height; row++)
+	viewPixmap.pixmap[row] = canvas->drawable->pixmap[y0 + row] + x0;
+      viewPixmap.width = (unsigned int)width;
+      viewPixmap.height = (unsigned int)height;
+      view.drawable = &viewPixmap;
+    }
+  /* stipple and texture stay aligned with the canvas */
+  view.stippleOrigin.x -= x0;
+  view.stippleOrigin.y -= y0;
+  view.textureOrigin.x -= x0;
+  view.textureOrigin.y -= y0;
+
+  offset.x = context->origin.x - x0;
+  offset.y = context->origin.y - y0;
+  for (k = context->tileStart[j]; k < context->tileStart[j + 1]; k++)
+    miCopyPaintedSetToCanvas (context->ops[context->tileOps[k]].paintedSet,
+			      &view, offset);
+
+  if (viewPixmap.pixmap != (miPixel **)NULL)
+    free (viewPixmap.pixmap);
+#else
+  /* a single tile, i.e. the entire canvas */
+  offset = context->origin;
+  for (k = context->tileStart[j]; k < context->tileStart[j + 1]; k++)
+    miCopyPaintedSetToCanvas (context->ops[context->tileOps[k]].paintedSet,
+			      canvas, offset);
+#endif /* MI_CANVAS_DRAWABLE_TYPE */
+}
+
+/* Carry out all jobs, using up to `nthreads' threads (including the
+   calling thread).  Each worker repeatedly takes the next job that
+   hasn't been taken, so the jobs are load-balanced. */
+static void
+miRunJobs (miRenderContext *context, int nthreads)
+{
+  miWorker workers[MI_MAX_WORKER_THREADS];
+#ifdef MI_USE_WORKER_THREADS
+  pthread_t threads[MI_MAX_WORKER_THREADS];
+  int i, nstarted = 0;
+#endif
+
+  context->nextJob = 0;
+  workers[0].context = context;
+  workers[0].index = 0;
+#ifdef MI_USE_WORKER_THREADS
+  nthreads = IMIN(nthreads, context->njobs);
+  for (i = 1; i < nthreads; i++)
+    {
+      workers[i].context = context;
+      workers[i].index = i;
+      if (pthread_create (&threads[nstarted], (const pthread_attr_t *)NULL,
+			  miRunJobsWorker, (void *)&workers[i]) != 0)
+	break;			/* calling thread will do the remainder */
+      nstarted++;
+    }
+#endif
+
+  miRunJobsWorker ((void *)&workers[0]);
+
+#ifdef MI_USE_WORKER_THREADS
+  for (i = 0; i < nstarted; i++)
+    pthread_join (threads[i], (void **)NULL);
+#endif
+}
+
+/* The body of a worker thread.  Each worker has its own ellipse cache, for
+   rasterizing arcs, which persists from batch to batch. */
+static void *
+miRunJobsWorker (void *ptr)
+{
+  miWorker *worker = (miWorker *)ptr;
+  miRenderContext *context = worker->context;
+  miEllipseCache *ellipseCache = (miEllipseCache *)NULL;
+  int j;
+
+  if (context->job == miRasterizeOp)
+    {
+      ellipseCache = context->ellipseCaches[worker->index];
+      if (ellipseCache == (miEllipseCache *)NULL)
+	{
+	  ellipseCache = (context->ellipseCacheSize >= 0
+			  ? miNewEllipseCacheOfSize (context->ellipseCacheSize)
+			  : miNewEllipseCache ());
+	  context->ellipseCaches[worker->index] = ellipseCache;
+	}
+    }
+
+  for ( ; ; )
+    {
+#ifdef MI_USE_WORKER_THREADS
+      pthread_mutex_lock (&context->lock);
+#endif
+      j = context->nextJob++;
+#ifdef MI_USE_WORKER_THREADS
+      pthread_mutex_unlock (&context->lock);
+#endif
+      if (j >= context->njobs)
+	break;
+      (*context->job) ((const void *)context, j, ellipseCache);
+    }
+
+  return NULL;
+}
+
+/* deallocate the copied arguments of a recorded operation */
+static void
+miFreeDeferredOp (miDeferredOp *op)
+{
+  miDeleteGC (op->pGC);
+  free (op->data);
+  miDeletePaintedSet (op->paintedSet);
+}
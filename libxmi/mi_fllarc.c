@@ -554,8 +554,8 @@ miFillEllipseI (miPaintedSet *paintedSet, const miGC *pGC, const miArc *arc)
   unsigned int *widths_upper, *widths_lower, *wids_upper, *wids_lower;
   int numUpperSpans, numLowerSpans;
 
-  points_upper = (miPoint *)mi_xmalloc (sizeof(miPoint) * arc->height);
-  widths_upper = (unsigned int *)mi_xmalloc (sizeof(unsigned int) * arc->height);
+  points_upper = MI_ALLOC_SPAN_POINTS(paintedSet, arc->height);
+  widths_upper = MI_ALLOC_SPAN_WIDTHS(paintedSet, arc->height);
   pts_upper = points_upper;
   wids_upper = widths_upper;
   points_lower = (miPoint *)mi_xmalloc (sizeof(miPoint) * arc->height);
@@ -593,8 +593,8 @@ miFillEllipseD (miPaintedSet *paintedSet, const miGC *pGC, const miArc *arc)
   unsigned int *widths_upper, *widths_lower, *wids_upper, *wids_lower;
   int numUpperSpans, numLowerSpans;
 
-  points_upper = (miPoint *)mi_xmalloc (sizeof(miPoint) * arc->height);
-  widths_upper = (unsigned int *)mi_xmalloc (sizeof(unsigned int) * arc->height);
+  points_upper = MI_ALLOC_SPAN_POINTS(paintedSet, arc->height);
+  widths_upper = MI_ALLOC_SPAN_WIDTHS(paintedSet, arc->height);
   pts_upper = points_upper;
   wids_upper = widths_upper;
   points_lower = (miPoint *)mi_xmalloc (sizeof(miPoint) * arc->height);
@@ -667,8 +667,8 @@ miFillArcSliceI (miPaintedSet *paintedSet, const miGC *pGC, const miArc *arc)
     slw += (int)(arc->height >> 1) + 1;
   orig_slw = slw;
 
-  points_upper = (miPoint *)mi_xmalloc (sizeof(miPoint) * slw);
-  widths_upper = (unsigned int *)mi_xmalloc (sizeof(unsigned int) * slw);
+  points_upper = MI_ALLOC_SPAN_POINTS(paintedSet, slw);
+  widths_upper = MI_ALLOC_SPAN_WIDTHS(paintedSet, slw);
   pts_upper = points_upper;
   wids_upper = widths_upper;
   points_lower = (miPoint *)mi_xmalloc (sizeof(miPoint) * slw);
@@ -732,8 +732,8 @@ miFillArcSliceD (miPaintedSet *paintedSet, const miGC *pGC, const miArc *arc)
     slw += (int)(arc->height >> 1) + 1;
   orig_slw = slw;
 
-  points_upper = (miPoint *)mi_xmalloc (sizeof(miPoint) * slw);
-  widths_upper = (unsigned int *)mi_xmalloc (sizeof(unsigned int) * slw);
+  points_upper = MI_ALLOC_SPAN_POINTS(paintedSet, slw);
+  widths_upper = MI_ALLOC_SPAN_WIDTHS(paintedSet, slw);
   pts_upper = points_upper;
   wids_upper = widths_upper;
   points_lower = (miPoint *)mi_xmalloc (sizeof(miPoint) * slw);
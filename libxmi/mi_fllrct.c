@@ -60,8 +60,8 @@ miFillRectangles_internal (miPaintedSet *paintedSet, const miGC *pGC, int nrects
 
       height = prect->height;
       width = prect->width;
-      pptFirst = (miPoint *)mi_xmalloc (height * sizeof(miPoint));
-      pwFirst = (unsigned int *)mi_xmalloc (height * sizeof(unsigned int));
+      pptFirst = MI_ALLOC_SPAN_POINTS(paintedSet, height);
+      pwFirst = MI_ALLOC_SPAN_WIDTHS(paintedSet, height);
       ppt = pptFirst;
       pw = pwFirst;
 
@@ -82,8 +82,8 @@ miFillSppPoly (miPaintedSet *paintedSet, miPixel pixel, int count, const SppPoin
   y = ymax - ymin + 1;
   if ((count < 3) || (y <= 0))
     return;
-  ptsOut = FirstPoint = (miPoint *)mi_xmalloc(sizeof(miPoint) * y);
-  width = FirstWidth = (unsigned int *)mi_xmalloc(sizeof(unsigned int) * y);
+  ptsOut = FirstPoint = MI_ALLOC_SPAN_POINTS(paintedSet, y);
+  width = FirstWidth = MI_ALLOC_SPAN_WIDTHS(paintedSet, y);
   Marked = (int *) mi_xmalloc(sizeof(int) * count);
 
   for (j = 0; j < count; j++)
@@ -80,19 +80,11 @@ miCopyGC (const miGC *pGC)
   miGC *new_gc;
   int i;
   
-  if (pGC == (const miGC *)pGC)
+  if (pGC == (const miGC *)NULL)
     return (miGC *)NULL;
 
   new_gc = (miGC *)mi_xmalloc (sizeof (miGC));
-  new_gc->fillRule = pGC->fillRule;
-  new_gc->joinStyle = pGC->joinStyle;
-  new_gc->capStyle = pGC->capStyle;
-  new_gc->lineStyle = pGC->lineStyle;
-  new_gc->arcMode = pGC->arcMode;
-  new_gc->lineWidth = pGC->lineWidth;
-  new_gc->miterLimit = pGC->miterLimit;
-  new_gc->dashOffset = pGC->dashOffset;
-  new_gc->numInDashList = pGC->numInDashList;
+  *new_gc = *pGC;		/* copy all attributes, then the arrays */
   if (pGC->numInDashList == 0)
     new_gc->dash = (unsigned int *)NULL;
   else
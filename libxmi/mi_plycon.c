@@ -80,8 +80,8 @@ miFillConvexPoly (miPaintedSet *paintedSet, const miGC *pGC, int count, const mi
   dy = ymax - ymin + 1;
   if ((count < 3) || (dy < 0))
     return;
-  ptsOut = FirstPoint = (miPoint *)mi_xmalloc(sizeof(miPoint) * dy);
-  width = FirstWidth = (unsigned int *)mi_xmalloc(sizeof(unsigned int) * dy);
+  ptsOut = FirstPoint = MI_ALLOC_SPAN_POINTS(paintedSet, dy);
+  width = FirstWidth = MI_ALLOC_SPAN_WIDTHS(paintedSet, dy);
   
   nextleft = nextright = imin;
   y = ptsIn[nextleft].y;
@@ -146,8 +146,8 @@ miFillConvexPoly (miPaintedSet *paintedSet, const miGC *pGC, int count, const mi
     /* in case we're called with non-convex polygon */
     if(i < 0)
       {
-	free (FirstWidth);
-	free (FirstPoint);
+	miFreeSpanStorage (paintedSet, FirstWidth);
+	miFreeSpanStorage (paintedSet, FirstPoint);
 	return;
       }
 
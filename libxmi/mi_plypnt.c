@@ -44,7 +44,7 @@ miDrawPoints_internal (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mo
   if (npt <= 0)
     return;
 
-  ppt = (miPoint *)mi_xmalloc (npt * sizeof(miPoint));
+  ppt = MI_ALLOC_SPAN_POINTS(paintedSet, npt);
   if (mode == MI_COORD_MODE_PREVIOUS)
     /* convert from relative to absolute coordinates */
     {
@@ -62,7 +62,7 @@ miDrawPoints_internal (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mo
 	ppt[i] = pPts[i];
     }
 
-  pwidthInit = (unsigned int *)mi_xmalloc (npt * sizeof(unsigned int));
+  pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, npt);
   pwidth = pwidthInit;
   for (i = 0; i < npt; i++)
     *pwidth++ = 1;
@@ -22,12 +22,13 @@
    Boston, MA 02110-1301, USA. */
 
 /* This module provides several public functions: miNewPaintedSet(),
-   miAddSpansToPaintedSet(), miUniquifyPaintedSet(), miClearPaintedSet(),
-   miDeletePaintedSet().  They maintain a structure called a miPaintedSet,
-   which is essentially an array of SpanGroup structures, one per pixel
-   value.  A SpanGroup is essentially an unsorted list of Spans's.  A Spans
-   is a list of spans (i.e. horizontal ranges) of miPoints, sorted so that
-   the starting points have increasing y-values.  See mi_spans.h.
+   miNewImmediatePaintedSet(), miAddSpansToPaintedSet(),
+   miUniquifyPaintedSet(), miClearPaintedSet(), miDeletePaintedSet().
+   They maintain a structure called a miPaintedSet, which is essentially
+   an array of SpanGroup structures, one per pixel value.  A SpanGroup is
+   essentially an unsorted list of Spans's.  A Spans is a list of spans
+   (i.e. horizontal ranges) of miPoints, sorted so that the starting points
+   have increasing y-values.  See mi_spans.h.
 
    Internally, each libxmi drawing function paints to a miPaintedSet by
    calling miAddSpansToPaintedSet() on one or more Spans's.  This function
@@ -48,7 +49,26 @@
    contents of a miPaintedSet, i.e. its spans of painted miPoints, to a
    miCanvas structure.  Sophisticated pixel merging is supported.  It would
    be easy to write other functions that copy pixels out of a
-   miPaintedSet. */
+   miPaintedSet.
+
+   An `immediate-mode' miPaintedSet, created by miNewImmediatePaintedSet(),
+   is bound to a miCanvas.  Provided that pixels on the canvas are opaque
+   (no stipple, texture, or merging function), each Spans added to it is
+   painted straight onto the canvas and freed, so that the sorting and
+   uniquifying are skipped, and the miPaintedSet remains empty.
+
+   The point and width arrays of the Spans's in a miPaintedSet are
+   allocated from a span arena private to it, by the MI_ALLOC_SPAN_POINTS()
+   and MI_ALLOC_SPAN_WIDTHS() macros in mi_spans.h, rather than by
+   malloc().  Allocation merely bumps a pointer, and freeing an array does
+   nothing, unless it is the most recently allocated one (in which case
+   the pointer is bumped back).  All arrays are freed in bulk, when the
+   miPaintedSet is cleared, e.g. after it has been copied to a canvas.
+
+   A `deferred-mode' miPaintedSet, created by miNewDeferredPaintedSet(),
+   also remains empty: the drawing functions merely record themselves in
+   it, and are carried out later by miRenderDeferredPaintedSet().  See
+   mi_defer.c. */
 
 /* Original version written by Joel McCormack, Summer 1989.  
    Hacked by Robert S. Maier, 1998-1999. */
@@ -65,14 +85,50 @@
 #define YMIN(spans) (spans->points[0].y)
 #define YMAX(spans) (spans->points[spans->count-1].y)
 
+/* lists of spans at least this long are sorted with a counting sort
+   rather than a quicksort, provided that the range of the sort key is at
+   most MI_COUNTING_SORT_MAX_RANGE (so that the array of counts is
+   comparable in size to the list) */
+#define MI_COUNTING_SORT_THRESHOLD 64
+#define MI_COUNTING_SORT_MAX_RANGE(numSpans) (4 * (numSpans) + 1024)
+
+/* Alignment of arrays allocated from a span arena.  Each array is preceded
+   by a header of this size, containing its (rounded-up) size. */
+#define MI_SPAN_ARENA_ALIGN 8
+#define MI_SPAN_ARENA_ROUND(size) \
+  (((size) + MI_SPAN_ARENA_ALIGN - 1) & ~(size_t)(MI_SPAN_ARENA_ALIGN - 1))
+
+/* Sizes of the blocks that a span arena obtains from malloc().  Each
+   block is twice the size of the last, up to a maximum (unless a larger
+   block is needed for a single array). */
+#define MI_SPAN_ARENA_MIN_BLOCK 4096
+#define MI_SPAN_ARENA_MAX_BLOCK 1048576
+
+/* A block of a span arena.  The storage follows the struct. */
+struct lib_miSpanArenaBlock
+{
+  miSpanArenaBlock *next;	/* next (newer) block, if any */
+  size_t size;			/* bytes of storage in block */
+  size_t used;			/* bytes allocated from it */
+  char *data;			/* storage */
+};
+
 /* internal functions */
 static SpanGroup * miNewSpanGroup (miPixel pixel);
+static void * miReallocSpanStorage (miPaintedSet *paintedSet, void *ptr, size_t size);
+static void miResetSpanArena (miSpanArena *arena);
+static void miDeleteSpanArena (miSpanArena *arena);
 static int miUniquifySpansX (const Spans *spans, miPoint *newPoints, unsigned int *newWidths);
 static void miAddSpansToSpanGroup (const Spans *spans, SpanGroup *spanGroup);
 static void miDeleteSpanGroup (SpanGroup *spanGroup);
 static void miQuickSortSpansX (miPoint *points, unsigned int *widths, int numSpans);
-static void miSubtractSpans (SpanGroup *spanGroup, const Spans *sub);
-static void miUniquifySpanGroup (SpanGroup *spanGroup);
+static void miSubtractSpans (miPaintedSet *paintedSet, SpanGroup *spanGroup, const Spans *sub);
+static void miUniquifySpanGroup (miPaintedSet *paintedSet, SpanGroup *spanGroup);
+static bool miSpansAreSortedX (const Spans *spans);
+static bool miSpansAreUnique (const Spans *spans);
+static bool miCountingSortSpans (miPoint *points, unsigned int *widths, int numSpans, bool sortOnY);
+static void miSortSpansX (miPoint *points, unsigned int *widths, int numSpans);
+static void miQuickSortSpansYInternal (miPoint *points, unsigned int *widths, int numSpans);
 
 
 
@@ -87,6 +143,29 @@ miNewPaintedSet (void)
   paintedSet->groups = (SpanGroup **)NULL; /* pointer-to-SpanGroup slots */
   paintedSet->size = 0;		/* slots allocated */
   paintedSet->ngroups = 0;	/* slots filled */
+  paintedSet->canvas = (miCanvas *)NULL; /* not immediate-mode */
+  paintedSet->origin.x = 0;
+  paintedSet->origin.y = 0;
+  paintedSet->deferred = (miDeferredOps *)NULL; /* not deferred-mode */
+  paintedSet->arena.blocks = (miSpanArenaBlock *)NULL;
+  paintedSet->arena.current = (miSpanArenaBlock *)NULL;
+  paintedSet->arena.stats.allocations = 0;
+  paintedSet->arena.stats.bytes = 0;
+  paintedSet->arena.stats.blocks = 0;
+  paintedSet->arena.stats.resets = 0;
+  paintedSet->lineArcCache = (miLineArcCache *)NULL;
+
+  return paintedSet;
+}
+
+miPaintedSet *
+miNewImmediatePaintedSet (miCanvas *canvas, miPoint origin)
+{
+  miPaintedSet *paintedSet;
+
+  paintedSet = miNewPaintedSet ();
+  paintedSet->canvas = canvas;
+  paintedSet->origin = origin;
 
   return paintedSet;
 }
@@ -103,6 +182,21 @@ miAddSpansToPaintedSet (const Spans *spans, miPaintedSet *paintedSet, miPixel pi
   if (spans->count == 0)
     return;
 
+  /* An immediate-mode miPaintedSet paints straight onto its canvas, if
+     pixels are opaque.  But if spans have already been stored (because
+     they weren't), later spans must be stored too, to preserve the
+     painting order. */
+  if (paintedSet->canvas != (miCanvas *)NULL && paintedSet->ngroups == 0
+      && miPaintSpansImmediately (paintedSet->canvas, pixel, spans->count,
+				  spans->points, spans->widths, 
+				  paintedSet->origin))
+    {
+      /* free in reverse order of allocation, so storage is reused */
+      miFreeSpanStorage (paintedSet, spans->widths);
+      miFreeSpanStorage (paintedSet, spans->points);
+      return;
+    }
+
   for (i = 0; i < paintedSet->ngroups; i++)
     {
       miPixel stored_pixel;
@@ -148,13 +242,14 @@ miAddSpansToPaintedSet (const Spans *spans, miPaintedSet *paintedSet, miPixel pi
       otherGroup = paintedSet->groups[i];
       if (otherGroup == spanGroup)
 	continue;
-      miSubtractSpans (otherGroup, spans);
+      miSubtractSpans (paintedSet, otherGroup, spans);
     }
 }
 
 /* Deallocate all of a miPaintedSet's SpanGroups, including the points and
-   width arrays that are part of its component Spans's.  So it will
-   effectively become the empty set, as if it had been newly created. */
+   width arrays that are part of its component Spans's (by resetting its
+   span arena).  So it will effectively become the empty set, as if it had
+   been newly created. */
 void
 miClearPaintedSet (miPaintedSet *paintedSet)
 {
@@ -169,6 +264,7 @@ miClearPaintedSet (miPaintedSet *paintedSet)
     free (paintedSet->groups);
   paintedSet->size = 0;		/* slots allocated */
   paintedSet->ngroups = 0;	/* slots filled */
+  miResetSpanArena (&(paintedSet->arena));
 }
 
 /* Deallocate a miPaintedSet, including the points and width arrays that
@@ -186,9 +282,90 @@ miDeletePaintedSet (miPaintedSet *paintedSet)
 
   if (paintedSet->size > 0)
     free (paintedSet->groups);
+  miDeleteSpanArena (&(paintedSet->arena));
+  miDeleteDeferredOps (paintedSet->deferred);
+  miDeleteLineArcCache (paintedSet->lineArcCache);
   free (paintedSet);
 }
 
+/* Retrieve statistics on a miPaintedSet's span arena. */
+void
+miGetSpanArenaStats (const miPaintedSet *paintedSet, miSpanArenaStats *stats)
+{
+  *stats = paintedSet->arena.stats;
+}
+
+/* Allocate an array from a miPaintedSet's span arena.  If the current
+   block is full, move on to the next block (left over from before the
+   arena was last reset), or obtain a new one. */
+void *
+miAllocSpanStorage (miPaintedSet *paintedSet, size_t size)
+{
+  miSpanArena *arena = &(paintedSet->arena);
+  miSpanArenaBlock *block = arena->current;
+  size_t need;
+  char *ptr;
+
+  size = MI_SPAN_ARENA_ROUND(size);
+  need = size + MI_SPAN_ARENA_ALIGN;
+  while (block == (miSpanArenaBlock *)NULL || block->used + need > block->size)
+    {
+      if (block != (miSpanArenaBlock *)NULL 
+	  && block->next != (miSpanArenaBlock *)NULL)
+	block = block->next;	/* unused since last reset */
+      else
+	{
+	  miSpanArenaBlock *newBlock;
+	  size_t blockSize;
+
+	  blockSize = (block == (miSpanArenaBlock *)NULL 
+		       ? MI_SPAN_ARENA_MIN_BLOCK : 2 * block->size);
+	  if (blockSize > MI_SPAN_ARENA_MAX_BLOCK)
+	    blockSize = MI_SPAN_ARENA_MAX_BLOCK;
+	  if (blockSize < need)
+	    blockSize = need;
+	  newBlock = (miSpanArenaBlock *)mi_xmalloc (MI_SPAN_ARENA_ROUND(sizeof(miSpanArenaBlock)) + blockSize);
+	  newBlock->next = (miSpanArenaBlock *)NULL;
+	  newBlock->size = blockSize;
+	  newBlock->used = 0;
+	  newBlock->data = 
+	    (char *)newBlock + MI_SPAN_ARENA_ROUND(sizeof(miSpanArenaBlock));
+	  if (block == (miSpanArenaBlock *)NULL)
+	    arena->blocks = newBlock;
+	  else
+	    block->next = newBlock;
+	  arena->stats.blocks++;
+	  block = newBlock;
+	}
+    }
+  arena->current = block;
+
+  ptr = block->data + block->used;
+  *(size_t *)ptr = size;
+  block->used += need;
+  arena->stats.allocations++;
+  arena->stats.bytes += size;
+
+  return (void *)(ptr + MI_SPAN_ARENA_ALIGN);
+}
+
+/* Free an array allocated from a miPaintedSet's span arena.  This does
+   nothing unless it was the most recently allocated array in the current
+   block, in which case its storage can be reused. */
+void
+miFreeSpanStorage (miPaintedSet *paintedSet, void *ptr)
+{
+  miSpanArenaBlock *block = paintedSet->arena.current;
+  char *p = (char *)ptr;
+
+  if (p == (char *)NULL || block == (miSpanArenaBlock *)NULL)
+    return;
+  if (p >= block->data + MI_SPAN_ARENA_ALIGN 
+      && p <= block->data + block->used
+      && p + *(size_t *)(p - MI_SPAN_ARENA_ALIGN) == block->data + block->used)
+    block->used -= *(size_t *)(p - MI_SPAN_ARENA_ALIGN) + MI_SPAN_ARENA_ALIGN;
+}
+
 /* `Uniquify' a miPaintedSet, i.e. uniquify each of its SpanGroups (see
    below). */
 void
@@ -203,7 +380,7 @@ miUniquifyPaintedSet (miPaintedSet *paintedSet)
     {
       if (paintedSet->groups[i]->count > 0)
 	{
-	  miUniquifySpanGroup (paintedSet->groups[i]);
+	  miUniquifySpanGroup (paintedSet, paintedSet->groups[i]);
 	}
     }
 }
@@ -254,22 +431,15 @@ miAddSpansToSpanGroup (const Spans *spans, SpanGroup *spanGroup)
     spanGroup->ymax = ymax;
 }
 
-/* Delete a SpanGroup, including the point and width arrays that are part
-   of each Spans. */
+/* Delete a SpanGroup.  (The point and width arrays that are part of each
+   Spans belong to the miPaintedSet's span arena, and are freed when it is
+   reset.) */
 static void
 miDeleteSpanGroup (SpanGroup *spanGroup)
 {
-  int i;
-
   if (spanGroup == (SpanGroup *)NULL)
     return;
 
-  for (i = 0; i < spanGroup->count; i++)
-    {
-      /*  free spanGroup->group[i], which is a Spans */
-      free (spanGroup->group[i].points);
-      free (spanGroup->group[i].widths);
-    }
   if (spanGroup->group)
     free (spanGroup->group);
   free (spanGroup);
@@ -278,7 +448,7 @@ miDeleteSpanGroup (SpanGroup *spanGroup)
 /* Subtract a Spans from a SpanGroup, i.e. from each of its Spans's; update
    SpanGroup's ymin, ymax. */
 static void 
-miSubtractSpans (SpanGroup *spanGroup, const Spans *sub)
+miSubtractSpans (miPaintedSet *paintedSet, SpanGroup *spanGroup, const Spans *sub)
 {
   int		i, subCount, spansCount;
   int		ymin, ymax, xmin, xmax;
@@ -394,11 +564,11 @@ miSubtractSpans (SpanGroup *spanGroup, const Spans *sub)
 			      miPoint *newPt;
 			      unsigned int *newwid;
 
-			      newPt = (miPoint *)mi_xrealloc (spans->points, 
+			      newPt = (miPoint *)miReallocSpanStorage (paintedSet, spans->points, 
 				       (spans->count + EXTRA)*sizeof(miPoint));
 			      spansPt = newPt + (spansPt - spans->points);
 			      spans->points = newPt;
-			      newwid = (unsigned int *)mi_xrealloc (spans->widths, 
+			      newwid = (unsigned int *)miReallocSpanStorage (paintedSet, spans->widths, 
 			          (spans->count + EXTRA)*sizeof(unsigned int));
 			      spansWid = newwid + (spansWid - spans->widths);
 			      spans->widths = newwid;
@@ -461,18 +631,17 @@ miSubtractSpans (SpanGroup *spanGroup, const Spans *sub)
 /* `Uniquify' a SpanGroup: merge all its Spans's into a single Spans, which
    will be sorted on x as well as on y. */
 static void
-miUniquifySpanGroup (SpanGroup *spanGroup)
+miUniquifySpanGroup (miPaintedSet *paintedSet, SpanGroup *spanGroup)
 {
-  int    i;
+  int    i, j;
   Spans  *spans;
-  Spans  *yspans;
-  int    *ysizes;
+  int    *ystarts;
   int    ymin, ylength;
 
   /* the new single Spans */
   miPoint *points;
   unsigned int *widths;
-  int count;
+  int count, newcount;
 
   if (spanGroup->count == 0) 
     return;
@@ -485,107 +654,210 @@ miUniquifySpanGroup (SpanGroup *spanGroup)
       return;
     }
 
-  /* Yuck.  Gross.  Radix sort into y buckets, then sort x and uniquify */
-  /* This seems to be the fastest thing to do.  I've tried sorting on
-     both x and y at the same time rather than creating into all those
-     y buckets, but it was somewhat slower. */
+  /* Special case: a single Spans that is already sorted on x as well as
+     on y, with no two spans touching or overlapping.  It is its own
+     uniquification. */
+  if (spanGroup->count == 1 && miSpansAreUnique (&(spanGroup->group[0])))
+    return;
+
+  /* Counting sort into y buckets (one for every scanline), then sort each
+     bucket on x and uniquify it.  The sort on y is stable, so a bucket
+     whose spans come from a single Spans that was sorted on x at each y
+     (as most are) is already sorted, and isn't sorted again. */
   
   ymin    = spanGroup->ymin;
   ylength = spanGroup->ymax - ymin + 1;
   
-  /* allocate Spans's for y buckets (one Spans for every scanline);
-     ysizes[] is number of allocated Span slots in each bucket */
-  yspans = (Spans *)mi_xmalloc (ylength * sizeof(Spans));
-  ysizes = (int *)mi_xmalloc (ylength * sizeof(int));
-  for (i = 0; i < ylength; i++) 
+  /* first pass: count spans in each bucket (ystarts[index+1] is the count
+     for bucket `index', until converted to a starting offset) */
+  ystarts = (int *)mi_xmalloc ((ylength + 1) * sizeof(int));
+  for (i = 0; i <= ylength; i++) 
+    ystarts[i] = 0;
+  for (i = 0, spans = spanGroup->group; 
+       i < spanGroup->count; i++, spans++) 
     {
-      ysizes[i]        = 0;
-      yspans[i].count  = 0;
-      yspans[i].points = (miPoint *)NULL;
-      yspans[i].widths = (unsigned int *)NULL;
+      for (j = 0; j < spans->count; j++)
+	{
+	  int index = spans->points[j].y - ymin;
+
+	  if (index >= 0 && index < ylength) /* paranoia */
+	    ystarts[index + 1]++;
+	}
     }
-  
-  /* go through every single span and put it into the correct y bucket */
-  count = 0;
+  for (i = 0; i < ylength; i++) 
+    ystarts[i + 1] += ystarts[i];
+  count = ystarts[ylength];
+
+  /* second pass: put every single span into the correct y bucket */
+  points = MI_ALLOC_SPAN_POINTS(paintedSet, count);
+  widths = MI_ALLOC_SPAN_WIDTHS(paintedSet, count);
   for (i = 0, spans = spanGroup->group; 
        i < spanGroup->count; i++, spans++) 
     {
-      int j, index;
-      
-      for (j = 0, points = spans->points, widths = spans->widths;
-	   j < spans->count; j++, points++, widths++) 
+      for (j = 0; j < spans->count; j++)
 	{
-	  index = points->y - ymin;
+	  int index = spans->points[j].y - ymin;
+
 	  if (index >= 0 && index < ylength) /* paranoia */
 	    {
-	      Spans *newspans = &(yspans[index]);
-	      
-	      if (newspans->count == ysizes[index]) 
-		/* expand bucket arrays by reallocating */
-		{
-		  ysizes[index] = (ysizes[index] + 8) * 2;
-		  newspans->points
-		    = (miPoint *)mi_xrealloc (newspans->points,
-					      ysizes[index] * sizeof(miPoint));
-		  newspans->widths
-		    = (unsigned int *)mi_xrealloc (newspans->widths,
-						   ysizes[index] * sizeof(unsigned int));
-		}
-	      newspans->points[newspans->count] = *points;
-	      newspans->widths[newspans->count] = *widths;
-	      (newspans->count)++;
-	    } /* if y value of span in range */
-	} /* for j through spans */
-      
-      count += spans->count;
-    } /* for i through Spans */
-  free (ysizes);
+	      int k = ystarts[index]++;
+
+	      points[k] = spans->points[j];
+	      widths[k] = spans->widths[j];
+	    }
+	}
+    }
+  /* ystarts[index] is now the end of bucket `index' */
   
-  /* now sort each bucket by x and uniquify it into new Spans */
-  points = (miPoint *)mi_xmalloc (count * sizeof(miPoint));
-  widths = (unsigned int *)mi_xmalloc (count * sizeof(unsigned int));
-  count = 0;
+  /* now sort each bucket by x and uniquify it, in place (the uniquified
+     spans are never written beyond the spans that are being read) */
+  newcount = 0;
   for (i = 0; i < ylength; i++) 
     {
-      int ycount = yspans[i].count;
+      int start = (i == 0 ? 0 : ystarts[i - 1]);
+      int ycount = ystarts[i] - start;
       
-      if (ycount > 0) 
+      if (ycount > 1) 
+	/* sort the >1 spans at this value of y, if not already sorted */
 	{
-	  if (ycount > 1) 
-	    /* sort the >1 spans at this value of y */
-	    {
-	      miQuickSortSpansX (yspans[i].points, yspans[i].widths, ycount);
-	      count += miUniquifySpansX
-		(&(yspans[i]), &(points[count]), &(widths[count]));
-	    } 
-	  else 
-	    /* just a single span at this value of y */
-	    {
-	      points[count] = yspans[i].points[0];
-	      widths[count] = yspans[i].widths[0];
-	      count++;
-	    }
-	  free (yspans[i].points);
-	  free (yspans[i].widths);
+	  Spans yspans;
+
+	  yspans.count = ycount;
+	  yspans.points = points + start;
+	  yspans.widths = widths + start;
+	  if (!miSpansAreSortedX (&yspans))
+	    miSortSpansX (yspans.points, yspans.widths, ycount);
+	  newcount += miUniquifySpansX
+	    (&yspans, &(points[newcount]), &(widths[newcount]));
+	} 
+      else if (ycount == 1)
+	/* just a single span at this value of y */
+	{
+	  points[newcount] = points[start];
+	  widths[newcount] = widths[start];
+	  newcount++;
 	}
     }
-  free (yspans);
+  free (ystarts);
   
-  /* free SpanGroup's original Spans's, including Span arrays */
-  for (i = 0; i < spanGroup->count; i++)
+  /* free SpanGroup's original Spans's, including Span arrays (which
+     actually remain in the span arena until it is reset) */
+  for (i = spanGroup->count - 1; i >= 0; i--)
     {
-      free (spanGroup->group[i].points);
-      free (spanGroup->group[i].widths);
+      miFreeSpanStorage (paintedSet, spanGroup->group[i].widths);
+      miFreeSpanStorage (paintedSet, spanGroup->group[i].points);
     }
 
   /* SpanGroup now has only a single Spans */
   spanGroup->count = 1;
   spanGroup->group[0].points = points;
   spanGroup->group[0].widths = widths;
-  spanGroup->group[0].count = count;
+  spanGroup->group[0].count = newcount;
+}
+
+/* Check whether the spans at each y value in a Spans (which is sorted on
+   y) are sorted on x. */
+static bool
+miSpansAreSortedX (const Spans *spans)
+{
+  int i;
+
+  for (i = 1; i < spans->count; i++)
+    if (spans->points[i].y == spans->points[i-1].y
+	&& spans->points[i].x < spans->points[i-1].x)
+      return false;
+  return true;
+}
+
+/* Check whether a Spans is already uniquified, i.e., is sorted on y, and
+   at each y value is sorted on x, with no two spans touching or
+   overlapping. */
+static bool
+miSpansAreUnique (const Spans *spans)
+{
+  int i;
+
+  for (i = 1; i < spans->count; i++)
+    {
+      const miPoint *prev = &(spans->points[i-1]);
+      const miPoint *cur = &(spans->points[i]);
+
+      if (cur->y < prev->y
+	  || (cur->y == prev->y 
+	      && cur->x <= prev->x + (int)(spans->widths[i-1])))
+	return false;
+    }
+  return true;
+}
+
+/* Sort a list of spans on x (if sortOnY is false) or y (if true), with a
+   counting sort, which is stable and takes O(numSpans) time.  This is
+   done only if the range of values of the sort key isn't much greater
+   than the number of spans, which is typical of spans bounded by the
+   canvas; if it is done, true is returned. */
+static bool
+miCountingSortSpans (miPoint *points, unsigned int *widths, int numSpans, bool sortOnY)
+{
+  int i, key, kmin, kmax, range;
+  int *starts;
+  miPoint *sortedPoints;
+  unsigned int *sortedWidths;
+
+  kmin = kmax = (sortOnY ? points[0].y : points[0].x);
+  for (i = 1; i < numSpans; i++)
+    {
+      key = (sortOnY ? points[i].y : points[i].x);
+      if (key < kmin)
+	kmin = key;
+      else if (key > kmax)
+	kmax = key;
+    }
+  /* compute the range as unsigned, so that it can't overflow */
+  if ((unsigned int)kmax - (unsigned int)kmin
+      >= (unsigned int)MI_COUNTING_SORT_MAX_RANGE(numSpans))
+    return false;
+  range = kmax - kmin + 1;
+
+  /* count the spans with each key, and convert to starting offsets */
+  starts = (int *)mi_xmalloc ((range + 1) * sizeof(int));
+  for (i = 0; i <= range; i++)
+    starts[i] = 0;
+  for (i = 0; i < numSpans; i++)
+    starts[(sortOnY ? points[i].y : points[i].x) - kmin + 1]++;
+  for (i = 0; i < range; i++)
+    starts[i + 1] += starts[i];
+
+  /* scatter, then copy back */
+  sortedPoints = (miPoint *)mi_xmalloc (numSpans * sizeof(miPoint));
+  sortedWidths = (unsigned int *)mi_xmalloc (numSpans * sizeof(unsigned int));
+  for (i = 0; i < numSpans; i++)
+    {
+      int k = starts[(sortOnY ? points[i].y : points[i].x) - kmin]++;
+
+      sortedPoints[k] = points[i];
+      sortedWidths[k] = widths[i];
+    }
+  memcpy (points, sortedPoints, numSpans * sizeof(miPoint));
+  memcpy (widths, sortedWidths, numSpans * sizeof(unsigned int));
+
+  free (sortedWidths);
+  free (sortedPoints);
+  free (starts);
+
+  return true;
+}
+
+/* Sort a list of spans on x.  Long lists are sorted by a counting sort if
+   possible, and otherwise by a quicksort.  Called only if numSpans > 1. */
+static void
+miSortSpansX (miPoint *points, unsigned int *widths, int numSpans)
+{
+  if (numSpans >= MI_COUNTING_SORT_THRESHOLD
+      && miCountingSortSpans (points, widths, numSpans, false))
+    return;
+  miQuickSortSpansX (points, widths, numSpans);
 }
 
-
 /* Sort each span in a Spans by x.  Called only if numSpans > 1. */
 static void 
 miQuickSortSpansX (miPoint *points, unsigned int *widths, int numSpans)
@@ -688,17 +960,38 @@ miQuickSortSpansX (miPoint *points, unsigned int *widths, int numSpans)
     } while (numSpans > 1);
 }
 
-/* Sort an unordered list of spans by y, so that it becomes a Spans. */
+/* Sort an unordered list of spans by y, so that it becomes a Spans.  A
+   list that is already sorted is left alone, and a long list is sorted by
+   a counting sort if possible. */
 void 
 miQuickSortSpansY (miPoint *points, unsigned int *widths, int numSpans)
 {
-  int	 y;
-  int	 i, j, m;
-  miPoint *r;
+  int	 i;
 
   if (numSpans <= 1)		/* nothing to do */
     return;
 
+  for (i = 1; i < numSpans; i++)
+    if (points[i].y < points[i-1].y)
+      break;
+  if (i == numSpans)		/* already sorted */
+    return;
+
+  if (numSpans >= MI_COUNTING_SORT_THRESHOLD
+      && miCountingSortSpans (points, widths, numSpans, true))
+    return;
+
+  miQuickSortSpansYInternal (points, widths, numSpans);
+}
+
+/* Sort a list of spans by y, by a quicksort.  Called only if numSpans > 1. */
+static void 
+miQuickSortSpansYInternal (miPoint *points, unsigned int *widths, int numSpans)
+{
+  int	 y;
+  int	 i, j, m;
+  miPoint *r;
+
 #define ExchangeSpans(a, b)				    \
   {							    \
     miPoint tpt;	     					    \
@@ -788,7 +1081,7 @@ miQuickSortSpansY (miPoint *points, unsigned int *widths, int numSpans)
 
       /* Recurse */
       if (numSpans-j-1 > 1)
-	miQuickSortSpansY (&points[j+1], &widths[j+1], numSpans-j-1);
+	miQuickSortSpansYInternal (&points[j+1], &widths[j+1], numSpans-j-1);
       numSpans = j;
     } while (numSpans > 1);
 }
@@ -844,3 +1137,64 @@ miUniquifySpansX (const Spans *spans, miPoint *newPoints, unsigned int *newWidth
 
   return (int)((newWidths - startNewWidths) + 1);
 }
+
+/* Resize an array allocated from a miPaintedSet's span arena.  If it is
+   the most recently allocated array in the current block, and there is
+   room, it is extended in place; otherwise it is copied. */
+static void *
+miReallocSpanStorage (miPaintedSet *paintedSet, void *ptr, size_t size)
+{
+  miSpanArenaBlock *block = paintedSet->arena.current;
+  char *p = (char *)ptr;
+  size_t oldSize;
+  void *newPtr;
+
+  oldSize = *(size_t *)(p - MI_SPAN_ARENA_ALIGN);
+  size = MI_SPAN_ARENA_ROUND(size);
+  if (size <= oldSize)
+    return ptr;
+
+  if (p >= block->data + MI_SPAN_ARENA_ALIGN 
+      && p + oldSize == block->data + block->used
+      && block->used + (size - oldSize) <= block->size)
+    {
+      *(size_t *)(p - MI_SPAN_ARENA_ALIGN) = size;
+      block->used += size - oldSize;
+      paintedSet->arena.stats.bytes += size - oldSize;
+      return ptr;
+    }
+
+  newPtr = miAllocSpanStorage (paintedSet, size);
+  memcpy (newPtr, ptr, oldSize);
+  miFreeSpanStorage (paintedSet, ptr);
+  return newPtr;
+}
+
+/* Reset a span arena, so that all its blocks are unused. */
+static void
+miResetSpanArena (miSpanArena *arena)
+{
+  miSpanArenaBlock *block;
+
+  if (arena->blocks == (miSpanArenaBlock *)NULL)
+    return;
+  for (block = arena->blocks; block; block = block->next)
+    block->used = 0;
+  arena->current = arena->blocks;
+  arena->stats.resets++;
+}
+
+/* Deallocate a span arena's blocks. */
+static void
+miDeleteSpanArena (miSpanArena *arena)
+{
+  miSpanArenaBlock *block, *next;
+
+  for (block = arena->blocks; block; block = next)
+    {
+      next = block->next;
+      free (block);
+    }
+  arena->blocks = (miSpanArenaBlock *)NULL;
+  arena->current = (miSpanArenaBlock *)NULL;
+}
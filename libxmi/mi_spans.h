@@ -50,6 +50,29 @@ typedef struct
     int		ymin, ymax;	/* min, max y values over all Spans's	*/
 } SpanGroup;
 
+/* A miSpanArena is a bump allocator for the point and width arrays of the
+   Spans's in a miPaintedSet; see mi_spans.c.  It is a list of blocks, each
+   obtained from malloc(), which are reused after the arena is reset. */
+
+typedef struct lib_miSpanArenaBlock miSpanArenaBlock;
+
+typedef struct
+{
+  miSpanArenaBlock *blocks;	/* list of blocks, oldest first	*/
+  miSpanArenaBlock *current;	/* block being allocated from	*/
+  miSpanArenaStats stats;	/* statistics, see xmi.h	*/
+} miSpanArena;
+
+/* A miDeferredOps structure is a list of recorded drawing operations; see
+   mi_defer.c.  It is opaque outside that file. */
+
+typedef struct lib_miDeferredOps miDeferredOps;
+
+/* A miLineArcCache structure is a small cache of rasterized round caps and
+   joins; see mi_widelin.c.  It is opaque outside that file. */
+
+typedef struct lib_miLineArcCache miLineArcCache;
+
 /* A miPaintedSet structure is an array of SpanGroups, specifying the
    partition into differently painted subsets.  There is at most one
    SpanGroup for any pixel. */
@@ -59,16 +82,32 @@ typedef struct lib_miPaintedSet
   SpanGroup	**groups;	/* SpanGroup slots			*/
   int		size;		/* number of SpanGroup slots allocated	*/
   int		ngroups;	/* number of SpanGroup slots filled	*/
+  miCanvas	*canvas;	/* if non-NULL, paint straight onto this */
+  miPoint	origin;		/* point that (0,0) is mapped to on it	*/
+  miDeferredOps	*deferred;	/* if non-NULL, record operations here	*/
+  miSpanArena	arena;		/* storage for point and width arrays	*/
+  miLineArcCache *lineArcCache;	/* templates for round caps, joins	*/
 } _miPaintedSet;
 
+/* Macros that allocate the point and width arrays of a Spans that will be
+   painted to a miPaintedSet by MI_PAINT_SPANS() below.  They are
+   allocated from the miPaintedSet's span arena, rather than the heap.
+   If arrays are freed (by miFreeSpanStorage()) in the reverse of the
+   order in which they were allocated, as they are when an immediate-mode
+   miPaintedSet paints them, their storage is reused at once. */
+#define MI_ALLOC_SPAN_POINTS(paintedSet, n) \
+  ((miPoint *)miAllocSpanStorage ((paintedSet), (size_t)(n) * sizeof(miPoint)))
+#define MI_ALLOC_SPAN_WIDTHS(paintedSet, n) \
+  ((unsigned int *)miAllocSpanStorage ((paintedSet), (size_t)(n) * sizeof(unsigned int)))
+
 /* libxmi's low-level painting macro.  It `paints' a Spans, i.e. a list of
    spans assumed to be in y-increasing order, to a miPaintedSet with a
    specified pixel value.  To do this, it invokes the lower-level function
    miAddSpansToPaintedSet() in mi_spans.c.
 
-   The passed point and width arrays should have been allocated on the
-   heap, since they will be eventually freed; e.g., when the miPaintedSet
-   is cleared or deallocated. */
+   The passed point and width arrays should have been allocated by the
+   above macros, since they will be eventually freed; e.g., when the
+   miPaintedSet is cleared or deallocated. */
 
 #define MI_PAINT_SPANS(paintedSet, pixel, numSpans, ppts, pwidths) \
   {\
@@ -82,8 +121,8 @@ typedef struct lib_miPaintedSet
       } \
     else \
       { \
-        free (ppts); \
-        free (pwidths); \
+        miFreeSpanStorage ((paintedSet), (pwidths)); \
+        miFreeSpanStorage ((paintedSet), (ppts)); \
       } \
     }
 
@@ -97,8 +136,8 @@ typedef struct lib_miPaintedSet
         miPoint		*ppt, *pptInit, *oldppt; \
         unsigned int	*pwidth, *pwidthInit, *oldpwidth; \
         int		ptsCounter; \
-        ppt = pptInit = (miPoint *) mi_xmalloc ((nPts) * sizeof (miPoint));\
-        pwidth = pwidthInit = (unsigned int *) mi_xmalloc ((nPts) * sizeof (unsigned int));\
+        ppt = pptInit = MI_ALLOC_SPAN_POINTS((paintedSet), (nPts));\
+        pwidth = pwidthInit = MI_ALLOC_SPAN_WIDTHS((paintedSet), (nPts));\
         oldppt = FirstPoint;\
         oldpwidth = FirstWidth;\
         for (ptsCounter = (nPts); --ptsCounter >= 0; )\
@@ -110,7 +149,24 @@ typedef struct lib_miPaintedSet
       } \
   }
 
+/* span arena routines */
+extern void * miAllocSpanStorage (miPaintedSet *paintedSet, size_t size);
+extern void miFreeSpanStorage (miPaintedSet *paintedSet, void *ptr);
+
 /* miPaintedSet manipulation routines (other than public) */
 extern void miAddSpansToPaintedSet (const Spans *spans, miPaintedSet *paintedSet, miPixel pixel);
 extern void miQuickSortSpansY (miPoint *points, unsigned int *widths, int numSpans);
 extern void miUniquifyPaintedSet (miPaintedSet *paintedSet);
+
+/* recording of drawing operations by a deferred-mode miPaintedSet
+   (defined in mi_defer.c) */
+enum { MI_OP_DRAW_POINTS, MI_OP_DRAW_LINES, MI_OP_FILL_POLYGON, MI_OP_DRAW_RECTANGLES, MI_OP_FILL_RECTANGLES, MI_OP_DRAW_ARCS, MI_OP_FILL_ARCS };
+extern void miRecordDrawingOp (miPaintedSet *paintedSet, int opType, const miGC *pGC, int mode, int shape, int n, const void *data);
+extern void miDeleteDeferredOps (miDeferredOps *deferred);
+
+/* deallocation of a cache of round cap and join templates (defined in
+   mi_widelin.c) */
+extern void miDeleteLineArcCache (miLineArcCache *cache);
+
+/* painting of spans straight onto a miCanvas (defined in mi_canvas.c) */
+extern bool miPaintSpansImmediately (miCanvas *canvas, miPixel pixel, int n, const miPoint *ppt, const unsigned int *pwidth, miPoint offset);
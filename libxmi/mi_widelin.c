@@ -57,7 +57,32 @@ static void miLineProjectingCap (miPaintedSet *paintedSet, miPixel pixel, const
 static void miWideDashSegment (miPaintedSet *paintedSet, const miGC *pGC, int *pDashNum, int *pDashIndex, int *pDashOffset, int x1, int y1, int x2, int y2, bool projectLeft, bool projectRight, LineFace *leftFace, LineFace *rightFace);
 static void miWideSegment (miPaintedSet *paintedSet, miPixel pixel, const miGC *pGC, int x1, int y1, int x2, int y2, bool projectLeft, bool projectRight, LineFace *leftFace, LineFace *rightFace);
 
+/* A template for the disk drawn by miLineArc() when no clipping edges
+   are needed, i.e., a round cap or join that is a full disk.  Its shape
+   depends only on the line width and, if floating point coordinates are
+   used, on the sub-pixel phase of the disk's center.  A miPaintedSet
+   keeps a small cache of these (see miGetLineArcTemplate()). */
+#define MI_LINE_ARC_CACHE_SIZE 8
+
+typedef struct
+{
+  unsigned int lineWidth;	/* diameter of disk */
+  bool isInt;			/* drawn by miLineArcI(), not miLineArcD()? */
+  double x0, y0;		/* if not, sub-pixel phase of center */
+  int count;			/* number of spans */
+  miPoint *points;		/* spans, relative to base point */
+  unsigned int *widths;
+} miLineArcTemplate;
+
+struct lib_miLineArcCache
+{
+  miLineArcTemplate templates[MI_LINE_ARC_CACHE_SIZE];
+  int count;			/* number of templates filled */
+  int next;			/* template to replace next, if full */
+};
+
 /* internal functions that don't do painting of pixels */
+static miLineArcTemplate * miGetLineArcTemplate (miPaintedSet *paintedSet, const miGC *pGC, bool isInt, double x0, double y0, double xorg, double yorg, int xbase, int ybase);
 static int miLineArcD (const miGC *pGC, double xorg, double yorg, miPoint *points, unsigned int *widths, PolyEdge *edge1, int edgey1, bool edgeleft1, PolyEdge *edge2, int edgey2, bool edgeleft2);
 static int miLineArcI (const miGC *pGC, int xorg, int yorg, miPoint *points, unsigned int *widths);
 static int miPolyBuildEdge (double x0, double y0, double k, int dx, int dy, int xi, int yi, bool left, PolyEdge *edge);
@@ -95,8 +120,8 @@ miFillPolyHelper (miPaintedSet *paintedSet, miPixel pixel, int y, unsigned int o
   unsigned int 	*pwidth;
   unsigned int 	*pwidthInit = (unsigned int *)NULL;
 
-  pptInit = (miPoint *)mi_xmalloc(overall_height * sizeof(miPoint));
-  pwidthInit = (unsigned int *)mi_xmalloc(overall_height * sizeof(unsigned int));
+  pptInit = MI_ALLOC_SPAN_POINTS(paintedSet, overall_height);
+  pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, overall_height);
   ppt = pptInit;
   pwidth = pwidthInit;
 
@@ -143,8 +168,8 @@ miFillRectPolyHelper (miPaintedSet *paintedSet, miPixel pixel, int x, int y, uns
   miPoint *ppt, *pptInit;
   unsigned int *pwidth, *pwidthInit;
 
-  pptInit = (miPoint *)mi_xmalloc (h * sizeof(miPoint));
-  pwidthInit = (unsigned int *)mi_xmalloc (h * sizeof(unsigned int));
+  pptInit = MI_ALLOC_SPAN_POINTS(paintedSet, h);
+  pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, h);
   ppt = pptInit;
   pwidth = pwidthInit;
   while (h--)
@@ -639,22 +664,145 @@ miLineArc (miPaintedSet *paintedSet, miPixel pixel, const miGC *pGC, LineFace *l
       isInt = false;
     }
 
-  points = (miPoint *)mi_xmalloc(sizeof(miPoint) * pGC->lineWidth);
-  widths = (unsigned int *)mi_xmalloc(sizeof(unsigned int) * pGC->lineWidth);
+  if (edge1.dy < 0 && edge2.dy < 0 && edgey1 == INT_MAX && edgey2 == INT_MAX)
+    /* no clipping, so will just draw a disk; use a cached template */
+    {
+      miLineArcTemplate *arc;
+      double x0 = 0.0, y0 = 0.0;
+      int xbase, ybase, i;
 
-  /* construct a Spans by calling integer or floating point routine */
-  if (isInt)
-    /* integer routine, no clipping: just draw a disk */
-    n = miLineArcI (pGC, xorgi, yorgi, points, widths);
-  else
-    /* call floating point routine, supporting clipping by edge(s) */
-    n = miLineArcD (pGC, xorg, yorg, points, widths,
-		    &edge1, edgey1, edgeleft1,
-		    &edge2, edgey2, edgeleft2);
+      if (isInt)
+	{
+	  xbase = xorgi;
+	  ybase = yorgi;
+	}
+      else
+	/* disk depends on sub-pixel phase of center; see miLineArcD() */
+	{
+	  xbase = (int)(floor(xorg));
+	  x0 = xorg - xbase;
+	  ybase = ICEIL (yorg);
+	  y0 = yorg - ybase;
+	}
+
+      arc = miGetLineArcTemplate (paintedSet, pGC, isInt, x0, y0,
+				       xorg, yorg, xbase, ybase);
+      n = arc->count;
+      points = MI_ALLOC_SPAN_POINTS(paintedSet, n);
+      widths = MI_ALLOC_SPAN_WIDTHS(paintedSet, n);
+      for (i = 0; i < n; i++)
+	{
+	  points[i].x = arc->points[i].x + xbase;
+	  points[i].y = arc->points[i].y + ybase;
+	  widths[i] = arc->widths[i];
+	}
+      MI_PAINT_SPANS(paintedSet, pixel, n, points, widths)
+      return;
+    }
+
+  points = MI_ALLOC_SPAN_POINTS(paintedSet, pGC->lineWidth);
+  widths = MI_ALLOC_SPAN_WIDTHS(paintedSet, pGC->lineWidth);
+
+  /* call floating point routine, supporting clipping by edge(s) */
+  n = miLineArcD (pGC, xorg, yorg, points, widths,
+		  &edge1, edgey1, edgeleft1,
+		  &edge2, edgey2, edgeleft2);
   
   MI_PAINT_SPANS(paintedSet, pixel, n, points, widths)
 }
 
+/* Look up, in a miPaintedSet's cache of line arc templates, the disk that
+   miLineArc() would draw for the specified line width and (in the
+   floating point case) sub-pixel phase of its center.  If there is none,
+   rasterize the disk centered at (xorg,yorg), or at (xbase,ybase) in the
+   integer case, and add it to the cache, replacing the oldest template if
+   the cache is full.  The spans of a template are relative to the point
+   (xbase,ybase), so a repeated round cap or join is just a translated
+   copy. */
+static miLineArcTemplate *
+miGetLineArcTemplate (miPaintedSet *paintedSet, const miGC *pGC, bool isInt, double x0, double y0, double xorg, double yorg, int xbase, int ybase)
+{
+  miLineArcCache *cache;
+  miLineArcTemplate *arc;
+  miPoint *points;
+  unsigned int *widths;
+  PolyEdge edge;
+  int i, n;
+
+  cache = paintedSet->lineArcCache;
+  if (cache == (miLineArcCache *)NULL)
+    {
+      cache = (miLineArcCache *)mi_xmalloc (sizeof(miLineArcCache));
+      cache->count = 0;
+      cache->next = 0;
+      paintedSet->lineArcCache = cache;
+    }
+
+  for (i = 0; i < cache->count; i++)
+    {
+      arc = &(cache->templates[i]);
+      if (arc->lineWidth == pGC->lineWidth
+	  && arc->isInt == isInt
+	  && (isInt || (arc->x0 == x0 && arc->y0 == y0)))
+	return arc;
+    }
+
+  /* not found; rasterize the disk at its actual location */
+  points = (miPoint *)mi_xmalloc (pGC->lineWidth * sizeof(miPoint));
+  widths = (unsigned int *)mi_xmalloc (pGC->lineWidth * sizeof(unsigned int));
+  if (isInt)
+    n = miLineArcI (pGC, xbase, ybase, points, widths);
+  else
+    {
+      edge.x = 0;		/* not used, keep memory checkers happy */
+      edge.dy = -1;
+      n = miLineArcD (pGC, xorg, yorg, points, widths,
+		      &edge, INT_MAX, false, &edge, INT_MAX, false);
+    }
+  for (i = 0; i < n; i++)
+    {
+      points[i].x -= xbase;
+      points[i].y -= ybase;
+    }
+
+  /* store it in a free slot, or in place of the oldest template */
+  if (cache->count < MI_LINE_ARC_CACHE_SIZE)
+    arc = &(cache->templates[cache->count++]);
+  else
+    {
+      arc = &(cache->templates[cache->next]);
+      cache->next = (cache->next + 1) % MI_LINE_ARC_CACHE_SIZE;
+      free (arc->points);
+      free (arc->widths);
+    }
+  arc->lineWidth = pGC->lineWidth;
+  arc->isInt = isInt;
+  arc->x0 = x0;
+  arc->y0 = y0;
+  arc->count = n;
+  arc->points = points;
+  arc->widths = widths;
+
+  return arc;
+}
+
+/* Deallocate a miPaintedSet's cache of line arc templates. */
+void
+miDeleteLineArcCache (miLineArcCache *cache)
+{
+  int i;
+
+  if (cache == (miLineArcCache *)NULL)
+    return;
+
+  for (i = 0; i < cache->count; i++)
+    {
+      free (cache->templates[i].points);
+      free (cache->templates[i].widths);
+    }
+  free (cache);
+}
+
 /* Draw a filled disk, of diameter equal to the linewidth, as a Spans.
    This is used for round caps or round joins, if the clipping by one or
    two edges can be ignored.  Integer coordinates only are used.  Returns
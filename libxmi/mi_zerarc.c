@@ -158,7 +158,7 @@ miZeroPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miA
 	      for (i = 0; i < numPixels; i++)
 		{
 		  if (i == 1)
-		    ptsInit[i] = (miPoint *)mi_xmalloc(numPts * sizeof(miPoint));
+		    ptsInit[i] = MI_ALLOC_SPAN_POINTS(paintedSet, numPts);
 		  else		/* `solid' uses paint type #1 only */
 		    ptsInit[i] = (miPoint *)NULL;
 		  pts[i] = ptsInit[i];
@@ -171,7 +171,7 @@ miZeroPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miA
 	    {
 	      for (i = 0; i < numPixels; i++)
 		{
-		  ptsInit[i] = (miPoint *)mi_xmalloc(numPts * sizeof(miPoint));
+		  ptsInit[i] = MI_ALLOC_SPAN_POINTS(paintedSet, numPts);
 		  pts[i] = ptsInit[i];
 		}
 
@@ -189,7 +189,7 @@ miZeroPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miA
 		continue;
 	      if (i == 0 && pGC->lineStyle != (int)MI_LINE_DOUBLE_DASH)
 		{
-		  free (ptsInit[i]);
+		  miFreeSpanStorage (paintedSet, ptsInit[i]);
 		  continue;
 		}
 
@@ -199,7 +199,7 @@ miZeroPolyArc_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miA
 		  unsigned int *widths;
 		  int k;
 	      
-		  widths = (unsigned int *)mi_xmalloc(n * sizeof(unsigned int));
+		  widths = MI_ALLOC_SPAN_WIDTHS(paintedSet, n);
 		  for (k = 0; k < n; k++)
 		    widths[k] = 1;
 		  miQuickSortSpansY (ptsInit[i], widths, n);
@@ -61,8 +61,6 @@
 /* forward references */
 static void cfbBresD (miPaintedSet *paintedSet, const miGC *pGC, int *pdashNum, int *pdashIndex, const unsigned int *pDash, int numInDashList, int *pdashOffset, bool isDoubleDash, int signdx, int signdy, int axis, int x1, int y1, int e, int e1, int e2, int len);
 static void cfbBresS (miPaintedSet *paintedSet, const miGC *pGC, int signdx, int signdy, int axis, int x1, int y1, int e, int e1, int e2, int len);
-static void cfbHorzS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1, int len);
-static void cfbVertS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1, int len);
 
 
 /* Macro for painting a single point.  Used for ending line segments. */
@@ -71,8 +69,8 @@ static void cfbVertS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1,
 {\
   miPoint *point;\
   unsigned int *width;\
-  point = (miPoint *)mi_xmalloc(sizeof(miPoint));\
-  width = (unsigned int *)mi_xmalloc(sizeof(unsigned int));\
+  point = MI_ALLOC_SPAN_POINTS(paintedSet, 1);\
+  width = MI_ALLOC_SPAN_WIDTHS(paintedSet, 1);\
   *width = 1;\
   point->x = xx;\
   point->y = yy;\
@@ -124,6 +122,15 @@ static void cfbVertS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1,
  * in paint type #1.
  */
 
+/* Since grid lines, tick marks, frames, and step plots consist almost
+   entirely of horizontal and vertical segments, and dense data of very
+   short ones, the spans of horizontal and vertical segments, of sloped
+   segments that are only one pixel long, and of the final point, are not
+   painted segment by segment.  Instead they are written directly into a
+   single batch of spans, sized by a first pass over the points, which is
+   sorted and painted at the end.  Since every segment is painted in the
+   same paint type, this doesn't alter the result. */
+
 /* ARGS: mode = Origin or Previous
    	 npt = number of points
 	 pPts = point array */
@@ -135,11 +142,41 @@ miZeroLine (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mode, int npt
   int xstart, ystart;
   int x1, x2;
   int y1, y2;
+  int i;
+  /* the batch of spans */
+  miPoint *batchPts;
+  unsigned int *batchWidths;
+  int batchSize, numBatchSpans;
 
   /* ensure we have >=1 points */
   if (npt <= 0)
     return;
 
+  /* first pass: size the batch (allowing for the final point) */
+  batchSize = 1;
+  x2 = pPts[0].x;
+  y2 = pPts[0].y;
+  for (i = 1; i < npt; i++)
+    {
+      x1 = x2;
+      y1 = y2;
+      x2 = pPts[i].x;
+      y2 = pPts[i].y;
+      if (mode == MI_COORD_MODE_PREVIOUS)
+	{
+	  x2 += x1;
+	  y2 += y1;
+	}
+      if (x1 == x2)		/* vertical: a span per row */
+	batchSize += abs (y2 - y1);
+      else if (y1 == y2		/* horizontal: a single span */
+	       || (abs (x2 - x1) == 1 && abs (y2 - y1) == 1))
+	batchSize++;		/* sloped, one pixel long: likewise */
+    }
+  batchPts = MI_ALLOC_SPAN_POINTS(paintedSet, batchSize);
+  batchWidths = MI_ALLOC_SPAN_WIDTHS(paintedSet, batchSize);
+  numBatchSpans = 0;
+
   /* loop through points, drawing a solid Bresenham segment for each line
      segment */
   ppt = pPts;
@@ -164,41 +201,47 @@ miZeroLine (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mode, int npt
 
       if (x1 == x2)  /* vertical line */
 	{
+	  int ytop, ybottom;
+
+	  /* make line go top to bottom, keeping endpoint semantics */
 	  if (y1 > y2)
-	    /* make line go top to bottom, keeping endpoint semantics */
 	    {
-	      int tmp;
-
-	      tmp = y2;
-	      y2 = y1 + 1;
-	      y1 = tmp + 1;
+	      ytop = y2 + 1;
+	      ybottom = y1 + 1;
+	    }
+	  else
+	    {
+	      ytop = y1;
+	      ybottom = y2;
 	    }
 
-	  /* draw line */
-	  if (y1 != y2)
-	    cfbVertS (paintedSet, pGC, x1, y1, y2 - y1);
-
-	  /* restore final point */
-	  y2 = ppt->y;
+	  /* add a column of spans to batch, i.e. rows ytop..ybottom-1 */
+	  for (i = ytop; i < ybottom; i++)
+	    {
+	      batchPts[numBatchSpans].x = x1;
+	      batchPts[numBatchSpans].y = i;
+	      batchWidths[numBatchSpans] = 1;
+	      numBatchSpans++;
+	    }
 	}
 
       else if (y1 == y2)  /* horizontal line */
 	{
-	  if (x1 > x2)
-	    /* force line from left to right, keeping endpoint semantics */
-	    {
-	      int tmp;
+	  /* force line from left to right, keeping endpoint semantics, and
+	     add it to batch, as a single span */
+	  batchPts[numBatchSpans].x = (x1 > x2 ? x2 + 1 : x1);
+	  batchPts[numBatchSpans].y = y1;
+	  batchWidths[numBatchSpans] = (unsigned int)abs (x2 - x1);
+	  numBatchSpans++;
+	}
 
-	      tmp = x2;
-	      x2 = x1 + 1;
-	      x1 = tmp + 1;
-	    }
-	  
-	  /* draw line */
-	  if (x1 != x2)
-	    cfbHorzS (paintedSet, pGC, x1, y1, x2 - x1);
-	  /* restore final point */
-	  x2 = ppt->x;
+      else if (abs (x2 - x1) == 1 && abs (y2 - y1) == 1)
+	/* sloped line, only one pixel long, i.e. just the initial point */
+	{
+	  batchPts[numBatchSpans].x = x1;
+	  batchPts[numBatchSpans].y = y1;
+	  batchWidths[numBatchSpans] = 1;
+	  numBatchSpans++;
 	}
 
       else	/* sloped line */
@@ -248,10 +291,20 @@ miZeroLine (miPaintedSet *paintedSet, const miGC *pGC, miCoordMode mode, int npt
   if (pGC->capStyle != (int)MI_CAP_NOT_LAST
       &&
       (xstart != x2 || ystart != y2 || ppt == pPts + 1))
-    MI_PAINT_POINT(paintedSet, pGC->pixels[1], x2, y2)
+    {
+      batchPts[numBatchSpans].x = x2;
+      batchPts[numBatchSpans].y = y2;
+      batchWidths[numBatchSpans] = 1;
+      numBatchSpans++;
+    }
+
+  /* paint the batch, sorted on y */
+  if (numBatchSpans > 1)
+    miQuickSortSpansY (batchPts, batchWidths, numBatchSpans);
+  MI_PAINT_SPANS(paintedSet, pGC->pixels[1], numBatchSpans, batchPts, batchWidths)
 }
 
-
+
 /*
  * Draw a dashed Bresenham polyline, i.e. a `zero-width' dashed polyline.
  */
@@ -407,8 +460,8 @@ cfbBresS (miPaintedSet *paintedSet, const miGC *pGC, int signdx, int signdy, int
     return;
 
   /* set up work arrays */
-  pptInit = (miPoint *)mi_xmalloc(len * sizeof(miPoint));
-  pwidthInit = (unsigned int *)mi_xmalloc(len * sizeof(unsigned int));
+  pptInit = MI_ALLOC_SPAN_POINTS(paintedSet, len);
+  pwidthInit = MI_ALLOC_SPAN_WIDTHS(paintedSet, len);
   pptLast = pptInit + (len - 1);
   pwidthLast = pwidthInit + (len - 1);
 
@@ -695,52 +748,3 @@ cfbBresD (miPaintedSet *paintedSet, const miGC *pGC, int *pdashNum, int *pdashIn
       free (pptInit_bg);
     }
 }
-
-/* Internal: draw horizontal zero-width solid line segment, in paint type #1.
-   Called by miZeroLine().
-   Called with len >= 1, and len=x2-x1.  Endpoint semantics
-   are used, so we paint only len pixels, i.e. x1..x2-1. */
-
-/* ARGS: x1,y1 = initial point, len = length of line */
-static void
-cfbHorzS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1, int len)
-{
-  miPoint *ppt;
-  unsigned int *pwidth;
-
-  ppt = (miPoint *)mi_xmalloc(sizeof(miPoint));
-  pwidth = (unsigned int *)mi_xmalloc(sizeof(unsigned int));
-
-  ppt->x = x1;
-  ppt->y = y1;
-  *pwidth = (unsigned int)len;
-
-  MI_PAINT_SPANS(paintedSet, pGC->pixels[1], 1, ppt, pwidth)
-}
-
-/* Internal: draw vertical zero-width solid line segment, in paint type #1.
-   Called by miZeroLine().
-   Called with len >= 1, and len=y2-y1.  Endpoint semantics
-   are used, so we paint only len pixels, i.e. y1..y2-1. */
-
-/* ARGS: x1,y1 = initial point, len = length of line */
-static void
-cfbVertS (miPaintedSet *paintedSet, const miGC *pGC, int x1, int y1, int len)
-{
-  miPoint *ppt, *pptInit;
-  unsigned int *pwidth, *pwidthInit;
-  int i;
-
-  ppt = pptInit = (miPoint *)mi_xmalloc(len * sizeof(miPoint));
-  pwidth = pwidthInit = (unsigned int *)mi_xmalloc(len * sizeof(unsigned int));
-
-  for (i = 0; i < len; i++)
-    {
-      ppt->x = x1;
-      ppt->y = y1 + i;
-      ppt++;
-      *pwidth++ = (unsigned int)1;
-    }
-
-  MI_PAINT_SPANS(paintedSet, pGC->pixels[1], len, pptInit, pwidthInit)
-}
@@ -120,6 +120,22 @@ extern void miDeletePaintedSet (miPaintedSet *paintedSet);
 /* A function that clears any miPaintedSet (i.e. makes it the empty set). */
 extern void miClearPaintedSet (miPaintedSet *paintedSet);
 
+/* The spans in a miPaintedSet are stored in an arena private to it,
+   which is emptied in bulk whenever the miPaintedSet is cleared.
+   Statistics on the arena, accumulated since the miPaintedSet was
+   created, may be retrieved.  Every allocation beyond the first `blocks'
+   is one that would otherwise have required a separate call to malloc(),
+   and a corresponding call to free(). */
+typedef struct
+{
+  unsigned long allocations;	/* arrays allocated from arena */
+  unsigned long bytes;		/* bytes allocated from arena */
+  unsigned long blocks;		/* blocks obtained by arena from malloc() */
+  unsigned long resets;		/* times arena emptied (and blocks reused) */
+} miSpanArenaStats;
+
+extern void miGetSpanArenaStats (const miPaintedSet *paintedSet, miSpanArenaStats *stats);
+
 /**********************************************************************/
 
 /* A miGC is an opaque structure that contains high-level drawing
@@ -276,14 +292,31 @@ extern void miFillArcs (miPaintedSet *paintedSet, const miGC *pGC, int narcs, co
 
    The caller of miDrawArcs_r must supply a pointer to an miEllipseCache
    object as the final argument.  A pointer to such an object, which is
-   opaque, is returned by miNewEllipseCache.  After zero or more calls to
-   miDrawArcs_r, the object may be deleted by calling
-   miDeleteEllipseCache. */
+   opaque, is returned by miNewEllipseCache, or by miNewEllipseCacheOfSize,
+   which specifies the number of rasterized ellipses that it can hold
+   (least recently used ones are replaced when it is full).  After zero or
+   more calls to miDrawArcs_r, the object may be deleted by calling
+   miDeleteEllipseCache.  An miEllipseCache must not be used by more than
+   one thread at a time.  Statistics on its use may be retrieved at any
+   time. */
 
 typedef struct lib_miEllipseCache miEllipseCache;
 extern miEllipseCache * miNewEllipseCache (void);
+extern miEllipseCache * miNewEllipseCacheOfSize (int size);
 extern void miDeleteEllipseCache (miEllipseCache *ellipseCache);
 
+typedef struct
+{
+  unsigned long hits;		/* ellipses found in cache */
+  unsigned long misses;		/* ellipses rasterized and cached */
+  unsigned long evictions;	/* cached ellipses replaced */
+  unsigned long uncacheable;	/* ellipses too large to cache */
+  int size;			/* number of ellipses cache can hold */
+  int count;			/* number of ellipses it now holds */
+} miEllipseCacheStats;
+
+extern void miGetEllipseCacheStats (const miEllipseCache *ellipseCache, miEllipseCacheStats *stats);
+
 extern void miDrawArcs_r (miPaintedSet *paintedSet, const miGC *pGC, int narcs, const miArc *parcs, miEllipseCache *ellipseCache);
 
 ___END_DECLS
@@ -306,6 +339,14 @@ typedef miPixel (*miPixelMerge2) (miPixel source, miPixel destination);
    pixel. */
 typedef miPixel (*miPixelMerge3) (miPixel texture, miPixel source, miPixel destination);
 
+/* Span-at-a-time counterparts of the above.  A binary span-merging
+   function merges a source pixel into each of `n' destination pixels, in
+   place; a ternary one does likewise, with a texture pixel for each.
+   Such a function, if specified, is used in preference to the
+   corresponding pixel-merging function. */
+typedef void (*miSpanMerge2) (miPixel source, miPixel *destinations, int n);
+typedef void (*miSpanMerge3) (const miPixel *textures, miPixel source, miPixel *destinations, int n);
+
 /* Definitions of miBitmap and miPixmap.  By convention, (0,0) is upper
    left hand corner. */
 typedef struct
@@ -324,6 +365,59 @@ typedef struct
 }
 miPixmap;
 
+/* Definition of miPackedPixmap, an alternative drawable.  Unlike a
+   miPixmap, it is a single contiguous block of memory, addressed row by
+   row with a fixed stride (in bytes), and each pixel is stored in packed
+   form rather than as a miPixel.  Two packed formats are supported: 32-bit
+   RGBA words (red in the low-order byte, alpha in the high-order byte),
+   and 8-bit color indices.  Solid spans can be painted onto a packed
+   pixmap much faster than onto a miPixmap, since whole rows of pixels can
+   be filled at once. */
+typedef enum { MI_PACKED_RGBA32, MI_PACKED_INDEX8 } miPackedFormat;
+
+typedef unsigned int miRGBA32;	/* assumed to be 32 bits wide */
+
+typedef struct
+{
+  unsigned char *data;		/* row 0 begins here */
+  unsigned int width;
+  unsigned int height;
+  unsigned int stride;		/* bytes per row, a multiple of 16 */
+  miPackedFormat format;
+}
+miPackedPixmap;
+
+/* Accessors for the rows of a miPackedPixmap, and for the components of a
+   packed RGBA32 pixel (component 0/1/2/3 = red/green/blue/alpha). */
+#define MI_PACKED_ROW(pPacked, y) \
+  ((pPacked)->data + (size_t)(y) * (pPacked)->stride)
+#define MI_PACKED_RGBA32_ROW(pPacked, y) \
+  ((miRGBA32 *)MI_PACKED_ROW((pPacked), (y)))
+#define MI_PACKED_INDEX8_ROW(pPacked, y) \
+  ((unsigned char *)MI_PACKED_ROW((pPacked), (y)))
+#define MI_RGBA32(red, green, blue, alpha) \
+  ((miRGBA32)(red) | ((miRGBA32)(green) << 8) \
+   | ((miRGBA32)(blue) << 16) | ((miRGBA32)(alpha) << 24))
+#define MI_RGBA32_COMPONENT(value, k) \
+  ((unsigned char)(((value) >> (8 * (k))) & 0xff))
+
+/* Conversions between miPixels and packed pixels.  The defaults are
+   appropriate if a miPixel is an unsigned int.  If the libxmi installer
+   redefines MI_PIXEL_TYPE, these macros will need to be redefined too, if
+   packed canvases are to be used. */
+#ifndef MI_PIXEL_TO_RGBA32
+#define MI_PIXEL_TO_RGBA32(pixel) ((miRGBA32)(pixel))
+#endif
+#ifndef MI_RGBA32_TO_PIXEL
+#define MI_RGBA32_TO_PIXEL(value, pixel) { (pixel) = (miPixel)(value); }
+#endif
+#ifndef MI_PIXEL_TO_INDEX8
+#define MI_PIXEL_TO_INDEX8(pixel) ((unsigned char)(pixel))
+#endif
+#ifndef MI_INDEX8_TO_PIXEL
+#define MI_INDEX8_TO_PIXEL(value, pixel) { (pixel) = (miPixel)(value); }
+#endif
+
 /* Definition of miCanvasPixmap, the datatype of the drawable encapsulated
    within a miCanvas.  By default, a miCanvasPixmap is a miPixmap.  The
    libxmi installer may alter the definition by defining the symbol
@@ -340,6 +434,11 @@ typedef struct
   /* Drawable. */
   miCanvasPixmap *drawable;
 
+  /* Packed drawable.  (Default is NULL.  If non-NULL, the canvas was
+     created by miNewPackedCanvas(), this is the drawable, and the
+     preceding member is NULL.) */
+  miPackedPixmap *packed;
+
   /* A stipple.  (Default is NULL, which means no stipping.  If non-NULL,
      the canvas will be tiled with the stipple, and painting will be
      allowed to take place only at points where the stipple is nonzero.) */
@@ -363,6 +462,10 @@ typedef struct
      pixel, and source pixel will be ignored.) */
   miPixelMerge3 pixelMerge3;
 
+  /* User-specified span-merging functions, if any.  (Default is NULL.) */
+  miSpanMerge2 spanMerge2;
+  miSpanMerge3 spanMerge3;
+
 } miCanvas;
 
 /* The public function that merges pixels from a miPaintedSet onto a
@@ -370,6 +473,36 @@ typedef struct
    (0,0) in the miPaintedSet is mapped.  (It could be called `offset'.) */
 extern void miCopyPaintedSetToCanvas (const miPaintedSet *paintedSet, miCanvas *canvas, miPoint origin);
 
+/* An alternative constructor for the miPaintedSet class, which creates an
+   `immediate-mode' miPaintedSet, bound to a miCanvas.  Spans painted to it
+   are not stored, sorted, and uniquified, but are written straight onto
+   the canvas, with the specified origin; so copying it to the canvas (and
+   clearing it) has no effect.  That is correct only if pixels are opaque,
+   i.e. if painting a pixel twice does no harm.  So whenever the canvas has
+   a stipple, a texture, or a binary pixel-merging function, or the
+   default MI_DEFAULT_MERGE2_PIXEL() has been redefined, painting reverts
+   to the usual way, and miCopyPaintedSetToCanvas() must be called as
+   usual.  The canvas must not be deleted before the miPaintedSet. */
+extern miPaintedSet * miNewImmediatePaintedSet (miCanvas *canvas, miPoint origin);
+
+/* A further alternative constructor, which creates a `deferred-mode'
+   miPaintedSet.  Drawing functions applied to it are not carried out, but
+   are recorded, together with copies of their miGC's and arguments; so
+   copying it to a canvas (and clearing it) has no effect.  The recorded
+   operations are carried out by miRenderDeferredPaintedSet(), which
+   paints them onto a miCanvas, with the specified origin, and then
+   discards them.  The canvas is divided into tiles, and the rasterizing of
+   the operations and the compositing of the tiles are shared among up to
+   `nthreads' threads, if libxmi supports threads.  The resulting canvas is
+   identical to what would be obtained by carrying out the operations in
+   order, and copying the miPaintedSet to the canvas after each.  Arcs are
+   rasterized with the aid of the specified miEllipseCache, if it is
+   non-NULL, or of default-sized caches otherwise; additional threads use
+   caches of their own, of the same size, and their hits, misses, etc.,
+   are added to those of the specified cache. */
+extern miPaintedSet * miNewDeferredPaintedSet (void);
+extern void miRenderDeferredPaintedSet (miPaintedSet *paintedSet, miCanvas *canvas, miPoint origin, int nthreads, miEllipseCache *ellipseCache);
+
 /* If MI_CANVAS_DRAWABLE_TYPE is defined by the libxmi installer (see
    above), then the accessor macros MI_GET_CANVAS_DRAWABLE_PIXEL() and
    MI_SET_CANVAS_DRAWABLE_PIXEL() will also need to be defined.  The
@@ -377,17 +510,37 @@ extern void miCopyPaintedSetToCanvas (const miPaintedSet *paintedSet, miCanvas *
    miPixmap.  MI_GET_CANVAS_DRAWABLE_BOUNDS() should be defined too. */
 #ifndef MI_GET_CANVAS_DRAWABLE_PIXEL
 #define MI_GET_CANVAS_DRAWABLE_PIXEL(pCanvas, x, y, pixel) \
-    (pixel) = (pCanvas)->drawable->pixmap[(y)][(x)];
+    { if ((pCanvas)->packed == (miPackedPixmap *)NULL) \
+        (pixel) = (pCanvas)->drawable->pixmap[(y)][(x)]; \
+      else if ((pCanvas)->packed->format == MI_PACKED_RGBA32) \
+        MI_RGBA32_TO_PIXEL(MI_PACKED_RGBA32_ROW((pCanvas)->packed, (y))[(x)], (pixel)) \
+      else \
+        MI_INDEX8_TO_PIXEL(MI_PACKED_INDEX8_ROW((pCanvas)->packed, (y))[(x)], (pixel)) \
+    }
 #endif
 #ifndef MI_SET_CANVAS_DRAWABLE_PIXEL
 #define MI_SET_CANVAS_DRAWABLE_PIXEL(pCanvas, x, y, pixel) \
-    (pCanvas)->drawable->pixmap[(y)][(x)] = (pixel);
+    { if ((pCanvas)->packed == (miPackedPixmap *)NULL) \
+        (pCanvas)->drawable->pixmap[(y)][(x)] = (pixel); \
+      else if ((pCanvas)->packed->format == MI_PACKED_RGBA32) \
+        MI_PACKED_RGBA32_ROW((pCanvas)->packed, (y))[(x)] = MI_PIXEL_TO_RGBA32(pixel); \
+      else \
+        MI_PACKED_INDEX8_ROW((pCanvas)->packed, (y))[(x)] = MI_PIXEL_TO_INDEX8(pixel); \
+    }
 #endif
 #ifndef MI_GET_CANVAS_DRAWABLE_BOUNDS
 #define MI_GET_CANVAS_DRAWABLE_BOUNDS(pCanvas, xleft, ytop, xright, ybottom) \
     { (xleft) = 0; (ytop) = 0; \
-      (xright) = (pCanvas)->drawable->width - 1; \
-      (ybottom) = (pCanvas)->drawable->height - 1; \
+      if ((pCanvas)->packed == (miPackedPixmap *)NULL) \
+        { \
+          (xright) = (pCanvas)->drawable->width - 1; \
+          (ybottom) = (pCanvas)->drawable->height - 1; \
+        } \
+      else \
+        { \
+          (xright) = (pCanvas)->packed->width - 1; \
+          (ybottom) = (pCanvas)->packed->height - 1; \
+        } \
     }
 #endif
 
@@ -395,11 +548,14 @@ extern void miCopyPaintedSetToCanvas (const miPaintedSet *paintedSet, miCanvas *
 extern void miSetCanvasStipple (miCanvas *pCanvas, const miBitmap *pStipple, miPoint stippleOrigin);
 extern void miSetCanvasTexture (miCanvas *pCanvas, const miPixmap *pTexture, miPoint textureOrigin);
 
-/* Functions that set the binary and ternary pixel-merging functions to be
-   used when pixels from a miPaintedSet are applied to a miCanvas.  The
-   defaults are NULL; for the meaning of NULL, see above. */
+/* Functions that set the binary and ternary pixel-merging (or
+   span-merging) functions to be used when pixels from a miPaintedSet are
+   applied to a miCanvas.  The defaults are NULL; for the meaning of NULL,
+   see above. */
 extern void miSetPixelMerge2 (miCanvas *pCanvas, miPixelMerge2 pixelMerge2);
 extern void miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3);
+extern void miSetSpanMerge2 (miCanvas *pCanvas, miSpanMerge2 spanMerge2);
+extern void miSetSpanMerge3 (miCanvas *pCanvas, miSpanMerge3 spanMerge3);
 
 /* The libxmi installer may request that the default algorithm used when
    applying pixels to a miPaintCanvas be something other than the Painter's
@@ -407,6 +563,8 @@ extern void miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3);
 #ifndef MI_DEFAULT_MERGE2_PIXEL
 /* use painter's algorithm */
 #define MI_DEFAULT_MERGE2_PIXEL(new, source, dest) { (new) = (source); }
+/* flag that allows solid spans to be painted by filling rows */
+#define MI_DEFAULT_MERGE2_IS_REPLACE
 #endif
 
 /* Likewise, the libxmi installer may request that the default algorithm
@@ -416,6 +574,8 @@ extern void miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3);
 #ifndef MI_DEFAULT_MERGE3_PIXEL
 /* use painter's algorithm */
 #define MI_DEFAULT_MERGE3_PIXEL(new, texture, source, dest) { (new) = (texture); }
+/* flag that allows textured spans to be painted by copying texture rows */
+#define MI_DEFAULT_MERGE3_IS_TEXTURE
 #endif
 
 #ifndef MI_CANVAS_DRAWABLE_TYPE
@@ -425,8 +585,94 @@ extern void miSetPixelMerge3 (miCanvas *pCanvas, miPixelMerge3 pixelMerge3);
 extern miCanvas * miNewCanvas (unsigned int width, unsigned int height, miPixel initPixel);
 extern void miDeleteCanvas (miCanvas *pCanvas);
 extern miCanvas * miCopyCanvas (const miCanvas *pCanvas);
+
+/* An alternative constructor, which creates a miCanvas whose drawable is a
+   contiguous miPackedPixmap (see above) of the specified format.  It may
+   be deleted and copied by the above functions. */
+extern miCanvas * miNewPackedCanvas (unsigned int width, unsigned int height, miPackedFormat format, miPixel initPixel);
 #endif /* not MI_CANVAS_DRAWABLE_TYPE */
 
+/*************** LIBXMI's Anti-Aliased Drawing *************************/
+
+/* The anti-aliased drawing functions differ from those above in that
+   vertices and arcs are specified by floating-point device coordinates,
+   and in that they do not produce a miPaintedSet.  Instead they add to a
+   miCoverageSet: a list of spans, each pixel of which carries a coverage
+   value (a fraction of the pixel's area, in the range
+   1..MI_MAX_COVERAGE).  Coverage is computed by sampling each row of
+   pixels along MI_AA_SUBSCANLINES horizontal lines, and computing the
+   exact horizontal extent of the region along each.  Pixel (x,y) is the
+   unit square centered on the point (x,y).
+
+   Each call to a drawing function computes the union of the shapes it is
+   asked to draw (e.g., the segments, joins, and caps of a wide polyline),
+   so no pixel is covered twice.  The color of the resulting spans is the
+   foreground pixel of the miGC, i.e., pGC->pixels[1].  The line width,
+   join and cap styles, miter limit, dash pattern, fill rule, and arc mode
+   are also taken from the miGC, except that the line width is passed
+   separately, as a double.  A line width of zero or less is treated as a
+   width of one pixel.
+
+   A miCoverageSet is blended onto a miCanvas in a single pass, by
+   miBlendCoverageSetToCanvas(), with spans applied in the order in which
+   they were added.  Its spans may also be retrieved, so that a caller may
+   blend them in some other way (e.g., by color-table lookup). */
+
+#define MI_MAX_COVERAGE 255
+#define MI_AA_SUBSCANLINES 16
+
+typedef struct
+{
+  double x, y;
+} miDoublePoint;
+
+/* A floating-point analogue of miArc; but the angles are in degrees. */
+typedef struct
+{
+  double x, y;			/* upper left corner of bounding box */
+  double width, height;		/* dimensions */
+  double angle1, angle2;	/* starting angle and angle range */
+} miDoubleArc;
+
+/* A span of pixels in a miCoverageSet. */
+typedef struct
+{
+  miPixel pixel;		/* color of span */
+  miPoint start;		/* leftmost pixel in span */
+  unsigned int width;		/* number of pixels in span */
+  const unsigned char *coverage; /* coverage of each pixel */
+} miCoverageSpan;
+
+typedef struct lib_miCoverageSet miCoverageSet;
+
+___BEGIN_DECLS
+
+/* Constructor, destructor, and clearing function for the miCoverageSet
+   class.  Spans are clipped to the rectangle [0,width)x[0,height). */
+extern miCoverageSet * miNewCoverageSet (unsigned int width, unsigned int height);
+extern void miDeleteCoverageSet (miCoverageSet *coverageSet);
+extern void miClearCoverageSet (miCoverageSet *coverageSet);
+
+/* Drawing functions.  A polyline is closed if its first and last points
+   are the same. */
+extern void miAAFillPolygon (miCoverageSet *coverageSet, const miGC *pGC, int npts, const miDoublePoint *pPts);
+extern void miAADrawLines (miCoverageSet *coverageSet, const miGC *pGC, double lineWidth, int npts, const miDoublePoint *pPts);
+extern void miAAFillArcs (miCoverageSet *coverageSet, const miGC *pGC, int narcs, const miDoubleArc *parcs);
+extern void miAADrawArcs (miCoverageSet *coverageSet, const miGC *pGC, double lineWidth, int narcs, const miDoubleArc *parcs);
+
+/* Blend a miCoverageSet onto a miCanvas.  On a packed RGBA32 canvas, each
+   pixel is interpolated linearly between the canvas pixel and the span's
+   pixel.  On any other canvas, pixels that are at least half covered are
+   painted, and others are left alone. */
+extern void miBlendCoverageSetToCanvas (const miCoverageSet *coverageSet, miCanvas *canvas);
+
+/* Retrieve the spans in a miCoverageSet, in the order in which they were
+   added; the return value is the number of spans.  The returned array is
+   valid until the miCoverageSet is next modified. */
+extern int miGetCoverageSpans (miCoverageSet *coverageSet, const miCoverageSpan **spans);
+
+___END_DECLS
+
 /**********************************************************************/
 
 #endif /* not _XMI_H_ */
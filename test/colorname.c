@@ -0,0 +1,189 @@
+/* This file is part of the GNU plotutils package.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* Generator and checker for the perfect hash index over the color name
+   table in libplot/g_colorname.h.  It recomputes the index from the
+   table, by the method described there: each bucket of names, largest
+   bucket first (and among buckets of the same size, the one whose first
+   name comes first in the table), is given the smallest displacement
+   that sends its names to distinct unused slots.
+
+   Usage: colorname            check that the index in g_colorname.h is
+                               the one computed from the table
+          colorname --generate print the computed index, to replace the
+                               one in g_colorname.h */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* as in include/plotter.h */
+typedef struct
+{
+  const char *name;
+  unsigned char red;
+  unsigned char green;
+  unsigned char blue;
+} plColorNameInfo;
+
+#include "g_colorname.h"
+
+static unsigned char displacements[NUM_COLORNAME_BUCKETS];
+static short slots[NUM_COLORNAME_SLOTS];
+
+/* hash a name as _string_to_color() in g_colors.c does */
+static unsigned long
+hash_name (const char *name)
+{
+  unsigned long hash = 2166136261UL;
+
+  for (; *name; name++)
+    if (*name != ' ')
+      {
+	hash ^= (unsigned char)tolower ((unsigned char)*name);
+	hash = (hash * 16777619UL) & 0xffffffffUL;
+      }
+  return hash;
+}
+
+static int
+slot_of (unsigned long hash, int displacement)
+{
+  return (int)(((hash >> 8) ^ displacement) & (NUM_COLORNAME_SLOTS - 1));
+}
+
+/* compute the index, return 0 if no displacement works for some bucket */
+static int
+compute_index (void)
+{
+  unsigned long hash[NUM_COLORNAMES];
+  int size[NUM_COLORNAME_BUCKETS], first[NUM_COLORNAME_BUCKETS];
+  int done[NUM_COLORNAME_BUCKETS];
+  int i, b;
+
+  for (b = 0; b < NUM_COLORNAME_BUCKETS; b++)
+    {
+      size[b] = 0;
+      first[b] = NUM_COLORNAMES;
+      done[b] = 0;
+      displacements[b] = 0;
+    }
+  for (i = 0; i < NUM_COLORNAME_SLOTS; i++)
+    slots[i] = -1;
+  for (i = 0; i < NUM_COLORNAMES; i++)
+    {
+      hash[i] = hash_name (_pl_g_colornames[i].name);
+      b = (int)(hash[i] & (NUM_COLORNAME_BUCKETS - 1));
+      if (size[b]++ == 0)
+	first[b] = i;
+    }
+
+  for (;;)
+    {
+      int best = -1, d;
+
+      /* next bucket to place */
+      for (b = 0; b < NUM_COLORNAME_BUCKETS; b++)
+	if (!done[b] && size[b] > 0
+	    && (best < 0 || size[b] > size[best]
+		|| (size[b] == size[best] && first[b] < first[best])))
+	  best = b;
+      if (best < 0)
+	return 1;
+      done[best] = 1;
+
+      for (d = 0; d < 256; d++)
+	{
+	  int ok = 1;
+
+	  /* are the bucket's slots unused, and (in table order) distinct? */
+	  for (i = first[best]; i < NUM_COLORNAMES && ok; i++)
+	    if ((int)(hash[i] & (NUM_COLORNAME_BUCKETS - 1)) == best)
+	      {
+		int s = slot_of (hash[i], d), j;
+
+		if (slots[s] >= 0)
+		  ok = 0;
+		for (j = first[best]; j < i && ok; j++)
+		  if ((int)(hash[j] & (NUM_COLORNAME_BUCKETS - 1)) == best
+		      && slot_of (hash[j], d) == s)
+		    ok = 0;
+	      }
+	  if (ok)
+	    break;
+	}
+      if (d == 256)
+	return 0;
+
+      displacements[best] = (unsigned char)d;
+      for (i = first[best]; i < NUM_COLORNAMES; i++)
+	if ((int)(hash[i] & (NUM_COLORNAME_BUCKETS - 1)) == best)
+	  slots[slot_of (hash[i], d)] = (short)i;
+    }
+}
+
+static void
+print_index (void)
+{
+  int i;
+
+  printf ("static const unsigned char _pl_g_colorname_displacements[NUM_COLORNAME_BUCKETS] =\n{\n");
+  for (i = 0; i < NUM_COLORNAME_BUCKETS; i++)
+    printf ("%s%3d%s", (i % 16 == 0 ? "  " : " "), displacements[i],
+	    (i == NUM_COLORNAME_BUCKETS - 1 ? "\n" : i % 16 == 15 ? ",\n" : ","));
+  printf ("};\n\n");
+  printf ("static const short _pl_g_colorname_slots[NUM_COLORNAME_SLOTS] =\n{\n");
+  for (i = 0; i < NUM_COLORNAME_SLOTS; i++)
+    printf ("%s%3d%s", (i % 12 == 0 ? "  " : " "), slots[i],
+	    (i == NUM_COLORNAME_SLOTS - 1 ? "\n" : i % 12 == 11 ? ",\n" : ","));
+  printf ("};\n");
+}
+
+int
+main (int argc, char *argv[])
+{
+  int i, stale = 0;
+
+  if (!compute_index ())
+    {
+      fprintf (stderr, "%s: no displacement works; enlarge the index\n",
+	       argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  if (argc > 1 && strcmp (argv[1], "--generate") == 0)
+    {
+      print_index ();
+      return EXIT_SUCCESS;
+    }
+
+  for (i = 0; i < NUM_COLORNAME_BUCKETS; i++)
+    if (displacements[i] != _pl_g_colorname_displacements[i])
+      stale = 1;
+  for (i = 0; i < NUM_COLORNAME_SLOTS; i++)
+    if (slots[i] != _pl_g_colorname_slots[i])
+      stale = 1;
+  if (stale)
+    {
+      fprintf (stderr, "%s: color name index in g_colorname.h is out of date;\nreplace it by the output of `%s --generate'\n",
+	       argv[0], argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,442 @@
+/* This file is part of the GNU plotutils package.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* Test program for gifanim.test.  It draws an animation on a GIF Plotter,
+   in which frames after the first are written as the rectangles in which
+   they differ from their predecessors, and draws each of its frames on a
+   PNM Plotter, which writes them in full.  It then decodes the GIF,
+   composites each of its images onto the logical screen, and checks that
+   the screen after each image is the corresponding PNM frame.  The frames
+   include some that are unchanged, and some in which a single pixel
+   changes.  Plotter parameters, e.g. INTERLACE and GIF_COMPRESSION, may
+   be set in the environment.
+
+   Usage: gifanim */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "plot.h"
+
+#define WIDTH 97		/* odd sizes, so rectangles reach the edges */
+#define HEIGHT 61
+#define NUM_FRAMES 12
+
+/* an RGB image, 3 bytes per pixel */
+typedef struct
+{
+  int width, height;
+  unsigned char *rgb;
+} image;
+
+static const char *progname;
+
+static void
+die (const char *message)
+{
+  fprintf (stderr, "%s: %s\n", progname, message);
+  exit (EXIT_FAILURE);
+}
+
+/* draw frame number k */
+static void
+draw_frame (plPlotter *plotter, int k)
+{
+  pl_fspace_r (plotter, 0.0, 0.0, (double)WIDTH, (double)HEIGHT);
+  if (k == 8 || k == 9)
+    return;			/* blank frames */
+
+  /* a box, which moves in frame 5 and later */
+  pl_filltype_r (plotter, 1);
+  pl_fillcolorname_r (plotter, "red");
+  pl_pencolorname_r (plotter, "blue");
+  if (k < 5)
+    pl_fbox_r (plotter, 10.0, 10.0, 40.0, 30.0);
+  else
+    pl_fbox_r (plotter, 14.0, 12.0, 44.0, 32.0);
+  pl_filltype_r (plotter, 0);
+  pl_fcircle_r (plotter, 70.0, 35.0, 15.0);
+
+  /* single pixels: frame 2 adds one, frame 3 moves it to a corner, and
+     frame 4 moves it to the opposite corner */
+  pl_pencolorname_r (plotter, "black");
+  if (k == 2)
+    pl_fpoint_r (plotter, 50.5, 50.5);
+  else if (k == 3)
+    pl_fpoint_r (plotter, 0.5, 0.5);
+  else if (k == 4)
+    pl_fpoint_r (plotter, WIDTH - 0.5, HEIGHT - 0.5);
+
+  /* a new color, which changes the colormap */
+  if (k == 6 || k == 7)
+    {
+      pl_pencolorname_r (plotter, "green");
+      pl_fline_r (plotter, 0.0, 5.0, (double)WIDTH, 55.0);
+    }
+  /* one pixel in that color */
+  if (k == 11)
+    {
+      pl_pencolorname_r (plotter, "green");
+      pl_fpoint_r (plotter, 30.5, 45.5);
+    }
+}
+
+static plPlotter *
+new_plotter (const char *type, FILE *outfile, plPlotterParams *params)
+{
+  plPlotter *plotter;
+
+  plotter = pl_newpl_r (type, NULL, outfile, stderr, params);
+  if (plotter == NULL || pl_openpl_r (plotter) < 0)
+    die ("couldn't open Plotter");
+  return plotter;
+}
+
+static void
+delete_plotter (plPlotter *plotter)
+{
+  pl_closepl_r (plotter);
+  pl_deletepl_r (plotter);
+}
+
+/* read a whole file, from the start */
+static unsigned char *
+read_file (FILE *fp, long *len)
+{
+  unsigned char *data;
+
+  fflush (fp);
+  fseek (fp, 0L, SEEK_END);
+  *len = ftell (fp);
+  rewind (fp);
+  data = (unsigned char *)malloc ((size_t)(*len > 0 ? *len : 1));
+  if (data == NULL || fread (data, 1, (size_t)*len, fp) != (size_t)*len)
+    die ("couldn't read temporary file");
+  return data;
+}
+
+/* decode a PNM file: P4 (bitmap), P5 (graymap) or P6 (pixmap), as the PNM
+   Plotter writes them */
+static void
+decode_pnm (const unsigned char *data, long len, image *im)
+{
+  int type, fields[3], num_fields, i;
+  long pos = 2, x, y;
+
+  if (len < 2 || data[0] != 'P' || data[1] < '4' || data[1] > '6')
+    die ("bad PNM header");
+  type = data[1] - '0';
+  num_fields = (type == 4 ? 2 : 3);
+  for (i = 0; i < num_fields; i++)
+    {
+      while (pos < len && (data[pos] == ' ' || data[pos] == '\n'
+			   || data[pos] == '\t' || data[pos] == '\r'
+			   || data[pos] == '#'))
+	if (data[pos] == '#')
+	  while (pos < len && data[pos] != '\n')
+	    pos++;
+	else
+	  pos++;
+      fields[i] = 0;
+      while (pos < len && data[pos] >= '0' && data[pos] <= '9')
+	fields[i] = 10 * fields[i] + (data[pos++] - '0');
+    }
+  pos++;			/* single whitespace character */
+  if (num_fields == 3 && fields[2] != 255)
+    die ("unexpected PNM maxval");
+
+  im->width = fields[0];
+  im->height = fields[1];
+  im->rgb = (unsigned char *)malloc ((size_t)(3 * im->width * im->height));
+  for (y = 0; y < im->height; y++)
+    for (x = 0; x < im->width; x++)
+      {
+	unsigned char *p = im->rgb + 3 * (y * im->width + x);
+	int value;
+
+	switch (type)
+	  {
+	  case 4:
+	    value = data[pos + y * ((im->width + 7) / 8) + x / 8];
+	    value = ((value >> (7 - x % 8)) & 1) ? 0 : 255;
+	    p[0] = p[1] = p[2] = (unsigned char)value;
+	    break;
+	  case 5:
+	    p[0] = p[1] = p[2] = data[pos + y * im->width + x];
+	    break;
+	  default:
+	    memcpy (p, data + pos + 3 * (y * im->width + x), 3);
+	    break;
+	  }
+      }
+}
+
+/* decode a GIF LZW stream into npixels color indices; return 0 if it is
+   malformed */
+static int
+decode_lzw (const unsigned char *data, long len, int min_code_size,
+	    unsigned char *out, long npixels)
+{
+  static int prefix[4096];
+  static unsigned char suffix[4096], first[4096], stack[4096];
+  int clear = 1 << min_code_size, end = clear + 1;
+  int code_size = min_code_size + 1, next = clear + 2, prev = -1;
+  long bitpos = 0, n = 0;
+  int i;
+
+  for (i = 0; i < clear; i++)
+    {
+      prefix[i] = -1;
+      suffix[i] = first[i] = (unsigned char)i;
+    }
+
+  for (;;)
+    {
+      int code = 0, c, depth;
+
+      if (bitpos + code_size > 8 * len)
+	return 0;
+      for (i = 0; i < code_size; i++, bitpos++)
+	code |= ((data[bitpos / 8] >> (bitpos % 8)) & 1) << i;
+
+      if (code == clear)
+	{
+	  code_size = min_code_size + 1;
+	  next = clear + 2;
+	  prev = -1;
+	  continue;
+	}
+      if (code == end)
+	break;
+
+      if (prev < 0)
+	{
+	  if (code > clear)
+	    return 0;
+	}
+      else if (code <= next && next < 4096)
+	/* add the previous string plus the first pixel of this one (which
+	   if the code is the one being added, is the previous string's) */
+	{
+	  prefix[next] = prev;
+	  first[next] = first[prev];
+	  suffix[next] = (code == next ? first[prev] : first[code]);
+	  next++;
+	  if (next == (1 << code_size) && code_size < 12)
+	    code_size++;
+	}
+      else if (code > next)
+	return 0;
+
+      /* output the string */
+      depth = 0;
+      for (c = code; c >= 0; c = prefix[c])
+	stack[depth++] = suffix[c];
+      if (n + depth > npixels)
+	return 0;
+      while (depth > 0)
+	out[n++] = stack[--depth];
+      prev = code;
+    }
+
+  return n == npixels;
+}
+
+/* decode an animated GIF, checking the logical screen after each image
+   against the corresponding frame; return the number of images */
+static int
+check_gif (const unsigned char *data, long len, const image frames[])
+{
+  unsigned char global_cmap[768];
+  image screen;
+  int global_size = 0, num_images = 0, transparent = -1, disposal = 0;
+  long pos = 13;
+
+  if (len < 13 || memcmp (data, "GIF8", 4) != 0)
+    die ("bad GIF header");
+  screen.width = data[6] | (data[7] << 8);
+  screen.height = data[8] | (data[9] << 8);
+  if (screen.width != WIDTH || screen.height != HEIGHT)
+    die ("GIF screen has the wrong size");
+  screen.rgb = (unsigned char *)calloc ((size_t)(3 * WIDTH * HEIGHT), 1);
+  if (data[10] & 0x80)
+    {
+      global_size = 2 << (data[10] & 0x07);
+      memcpy (global_cmap, data + pos, (size_t)(3 * global_size));
+      pos += 3 * global_size;
+    }
+
+  while (pos < len && data[pos] != ';')
+    {
+      if (data[pos] == '!')
+	/* extension, of which only the Graphic Control Extension matters */
+	{
+	  if (data[pos + 1] == 0xf9)
+	    {
+	      disposal = (data[pos + 3] >> 2) & 0x07;
+	      transparent = (data[pos + 3] & 1) ? data[pos + 6] : -1;
+	    }
+	  pos += 2;
+	  while (pos < len && data[pos] != 0)
+	    pos += data[pos] + 1;
+	  pos++;
+	}
+      else if (data[pos] == ',')
+	{
+	  const unsigned char *cmap = global_cmap;
+	  unsigned char *lzw_data, *indices;
+	  long lzw_len = 0, p;
+	  int left, top, w, h, packed, x, y, row;
+
+	  left = data[pos + 1] | (data[pos + 2] << 8);
+	  top = data[pos + 3] | (data[pos + 4] << 8);
+	  w = data[pos + 5] | (data[pos + 6] << 8);
+	  h = data[pos + 7] | (data[pos + 8] << 8);
+	  packed = data[pos + 9];
+	  pos += 10;
+	  if (w <= 0 || h <= 0
+	      || left + w > screen.width || top + h > screen.height)
+	    die ("GIF image is not within the screen");
+	  if (packed & 0x80)
+	    {
+	      cmap = data + pos;
+	      pos += 3 * (2 << (packed & 0x07));
+	    }
+
+	  /* gather the data sub-blocks, and decode them */
+	  lzw_data = (unsigned char *)malloc ((size_t)len);
+	  for (p = pos + 1; p < len && data[p] != 0; p += data[p] + 1)
+	    {
+	      memcpy (lzw_data + lzw_len, data + p + 1, data[p]);
+	      lzw_len += data[p];
+	    }
+	  indices = (unsigned char *)malloc ((size_t)(w * h));
+	  if (!decode_lzw (lzw_data, lzw_len, data[pos], indices, (long)w * h))
+	    die ("bad GIF image data");
+	  pos = p + 1;
+
+	  /* composite the image onto the screen, row by row in the order in
+	     which they were written */
+	  for (row = 0; row < h; row++)
+	    {
+	      if (packed & 0x40)	/* interlaced */
+		{
+		  int n1 = (h + 7) / 8, n2 = (h + 3) / 8, n3 = (h + 1) / 4;
+
+		  if (row < n1)
+		    y = 8 * row;
+		  else if (row < n1 + n2)
+		    y = 8 * (row - n1) + 4;
+		  else if (row < n1 + n2 + n3)
+		    y = 4 * (row - n1 - n2) + 2;
+		  else
+		    y = 2 * (row - n1 - n2 - n3) + 1;
+		}
+	      else
+		y = row;
+	      for (x = 0; x < w; x++)
+		{
+		  int index = indices[row * w + x];
+
+		  if (index != transparent)
+		    memcpy (screen.rgb + 3 * ((top + y) * screen.width
+					      + left + x),
+			    cmap + 3 * index, 3);
+		}
+	    }
+	  free (indices);
+	  free (lzw_data);
+
+	  if (num_images >= NUM_FRAMES)
+	    die ("GIF has too many images");
+	  if (frames[num_images].width != screen.width
+	      || frames[num_images].height != screen.height
+	      || memcmp (frames[num_images].rgb, screen.rgb,
+			 (size_t)(3 * screen.width * screen.height)) != 0)
+	    {
+	      fprintf (stderr, "%s: frame %d of the GIF is wrong\n",
+		       progname, num_images);
+	      exit (EXIT_FAILURE);
+	    }
+	  num_images++;
+
+	  /* frames written as differences must be left in place */
+	  if (num_images > 1 && disposal != 1)
+	    die ("GIF image has the wrong disposal method");
+	  transparent = -1;
+	  disposal = 0;
+	}
+      else
+	die ("bad GIF block");
+    }
+
+  free (screen.rgb);
+  return num_images;
+}
+
+int
+main (int argc, char *argv[])
+{
+  plPlotterParams *params;
+  plPlotter *plotter;
+  image frames[NUM_FRAMES];
+  unsigned char *data;
+  FILE *fp;
+  long len;
+  int k;
+
+  progname = argv[0];
+  params = pl_newplparams ();
+  pl_setplparam (params, "BITMAPSIZE", (void *)"97x61");
+
+  /* the frames, in full */
+  for (k = 0; k < NUM_FRAMES; k++)
+    {
+      if ((fp = tmpfile ()) == NULL)
+	die ("couldn't open temporary file");
+      plotter = new_plotter ("pnm", fp, params);
+      draw_frame (plotter, k);
+      delete_plotter (plotter);
+      data = read_file (fp, &len);
+      decode_pnm (data, len, &frames[k]);
+      free (data);
+      fclose (fp);
+    }
+
+  /* the animation */
+  if ((fp = tmpfile ()) == NULL)
+    die ("couldn't open temporary file");
+  plotter = new_plotter ("gif", fp, params);
+  for (k = 0; k < NUM_FRAMES; k++)
+    {
+      if (k > 0)
+	pl_erase_r (plotter);
+      draw_frame (plotter, k);
+    }
+  delete_plotter (plotter);
+  data = read_file (fp, &len);
+  if (check_gif (data, len, frames) != NUM_FRAMES)
+    die ("GIF has too few images");
+  free (data);
+  fclose (fp);
+
+  for (k = 0; k < NUM_FRAMES; k++)
+    free (frames[k].rgb);
+  pl_deleteplparams (params);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,365 @@
+/* This file is part of the GNU plotutils package.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* Test program for png.test.  For each of a list of cases, it draws a
+   page on a PNG Plotter and on a PNM Plotter, with the same Plotter
+   parameters.  It decodes the PNG file with libpng, and checks that it
+   has the expected image type (monochrome, grayscale, palette or RGB),
+   that its pixels are those of the PNM file, and that exactly the pixels
+   of the transparent color, if any, are transparent.  The cases include
+   palette images with and without a transparent color, monochrome images
+   with white or black transparent, and each value of the parameters
+   PNG_COMPRESSION_LEVEL, PNG_FILTER and PNG_STRATEGY.
+
+   Usage: pngout */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+#include "plot.h"
+
+#define WIDTH 83
+#define HEIGHT 67
+
+/* an RGBA image, 4 bytes per pixel */
+typedef struct
+{
+  int width, height;
+  unsigned char *rgba;
+} image;
+
+typedef struct
+{
+  const char *description;
+  void (*draw) (plPlotter *plotter);
+  const char *params[4];	/* parameter name, value, name, value */
+  int color_type;		/* expected PNG color type */
+  int bit_depth;		/* expected PNG bit depth */
+  int transparent[3];		/* RGB of transparent color, or -1's */
+  long size;			/* size of PNG file, when written */
+} test_case;
+
+static void draw_color (plPlotter *plotter);
+static void draw_gray (plPlotter *plotter);
+static void draw_mono (plPlotter *plotter);
+
+static test_case cases[] =
+{
+  { "palette", draw_color, { NULL },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "palette, blue transparent", draw_color,
+    { "TRANSPARENT_COLOR", "blue" },
+    PNG_COLOR_TYPE_PALETTE, 4, { 0, 0, 255 }, 0L },
+  { "palette, white transparent, interlaced", draw_color,
+    { "TRANSPARENT_COLOR", "white", "INTERLACE", "yes" },
+    PNG_COLOR_TYPE_PALETTE, 4, { 255, 255, 255 }, 0L },
+  { "RGB, anti-aliased", draw_color,
+    { "ANTIALIAS", "yes", "TRANSPARENT_COLOR", "red" },
+    PNG_COLOR_TYPE_RGB, 8, { 255, 0, 0 }, 0L },
+  { "gray", draw_gray, { "TRANSPARENT_COLOR", "white" },
+    PNG_COLOR_TYPE_GRAY, 8, { 255, 255, 255 }, 0L },
+  { "mono, white transparent", draw_mono,
+    { "TRANSPARENT_COLOR", "white" },
+    PNG_COLOR_TYPE_GRAY, 1, { 255, 255, 255 }, 0L },
+  { "mono, black transparent", draw_mono,
+    { "TRANSPARENT_COLOR", "black" },
+    PNG_COLOR_TYPE_GRAY, 1, { 0, 0, 0 }, 0L },
+  { "compression level 0", draw_color,
+    { "PNG_COMPRESSION_LEVEL", "0" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "compression level 9", draw_color,
+    { "PNG_COMPRESSION_LEVEL", "9" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter none", draw_color, { "PNG_FILTER", "none" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter sub", draw_color, { "PNG_FILTER", "sub" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter up", draw_color, { "PNG_FILTER", "up" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter average", draw_color, { "PNG_FILTER", "average" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter paeth", draw_color, { "PNG_FILTER", "paeth" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "filter all, anti-aliased", draw_color,
+    { "PNG_FILTER", "all", "ANTIALIAS", "yes" },
+    PNG_COLOR_TYPE_RGB, 8, { -1, -1, -1 }, 0L },
+  { "strategy filtered", draw_color, { "PNG_STRATEGY", "filtered" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "strategy huffman", draw_color, { "PNG_STRATEGY", "huffman" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "strategy rle", draw_color, { "PNG_STRATEGY", "rle" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "strategy fixed", draw_color, { "PNG_STRATEGY", "fixed" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L },
+  { "strategy plain", draw_color, { "PNG_STRATEGY", "plain" },
+    PNG_COLOR_TYPE_PALETTE, 4, { -1, -1, -1 }, 0L }
+};
+#define NUM_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+
+/* indices of the cases whose file sizes are compared */
+#define LEVEL_0_CASE 7
+#define LEVEL_9_CASE 8
+
+static const char *progname;
+
+static void
+die (const char *description, const char *message)
+{
+  fprintf (stderr, "%s: %s: %s\n", progname, description, message);
+  exit (EXIT_FAILURE);
+}
+
+/* a page in six colors (white background, five pen and fill colors) */
+static void
+draw_color (plPlotter *plotter)
+{
+  pl_flinewidth_r (plotter, 3.0);
+  pl_filltype_r (plotter, 1);
+  pl_pencolorname_r (plotter, "blue");
+  pl_fillcolorname_r (plotter, "yellow");
+  pl_fbox_r (plotter, 10.0, 10.0, 50.0, 40.0);
+  pl_pencolorname_r (plotter, "red");
+  pl_fillcolorname_r (plotter, "green");
+  pl_fcircle_r (plotter, 60.0, 45.0, 18.0);
+  pl_filltype_r (plotter, 0);
+  pl_pencolorname_r (plotter, "magenta");
+  pl_fline_r (plotter, 0.0, 0.0, (double)WIDTH, (double)HEIGHT);
+}
+
+/* a page in shades of gray */
+static void
+draw_gray (plPlotter *plotter)
+{
+  pl_filltype_r (plotter, 1);
+  pl_pencolorname_r (plotter, "black");
+  pl_fillcolorname_r (plotter, "gray50");
+  pl_fbox_r (plotter, 10.0, 10.0, 50.0, 40.0);
+  pl_pencolorname_r (plotter, "gray20");
+  pl_fcircle_r (plotter, 60.0, 45.0, 18.0);
+}
+
+/* a page in black and white */
+static void
+draw_mono (plPlotter *plotter)
+{
+  pl_flinewidth_r (plotter, 2.0);
+  pl_pencolorname_r (plotter, "black");
+  pl_fcircle_r (plotter, 40.0, 30.0, 20.0);
+  pl_fline_r (plotter, 0.0, (double)HEIGHT, (double)WIDTH, 0.0);
+}
+
+/* draw a case's page on a Plotter of the specified type, writing to a
+   temporary file */
+static FILE *
+draw_page (const test_case *c, const char *type)
+{
+  plPlotterParams *params;
+  plPlotter *plotter;
+  FILE *fp;
+  int i;
+
+  if ((fp = tmpfile ()) == NULL)
+    die (c->description, "couldn't open temporary file");
+  params = pl_newplparams ();
+  pl_setplparam (params, "BITMAPSIZE", (void *)"83x67");
+  for (i = 0; i < 4 && c->params[i]; i += 2)
+    pl_setplparam (params, c->params[i], (void *)c->params[i + 1]);
+  plotter = pl_newpl_r (type, NULL, fp, stderr, params);
+  if (plotter == NULL || pl_openpl_r (plotter) < 0)
+    die (c->description, "couldn't open Plotter");
+  pl_fspace_r (plotter, 0.0, 0.0, (double)WIDTH, (double)HEIGHT);
+  c->draw (plotter);
+  pl_closepl_r (plotter);
+  pl_deletepl_r (plotter);
+  pl_deleteplparams (params);
+
+  fflush (fp);
+  rewind (fp);
+  return fp;
+}
+
+/* decode a PNM file: P4 (bitmap), P5 (graymap) or P6 (pixmap), as the PNM
+   Plotter writes them; all pixels are opaque */
+static void
+decode_pnm (const test_case *c, FILE *fp, image *im)
+{
+  int type, fields[3], num_fields, i, ch, x, y;
+  unsigned char *data;
+  long bytes;
+
+  if (getc (fp) != 'P' || (type = getc (fp) - '0') < 4 || type > 6)
+    die (c->description, "bad PNM header");
+  num_fields = (type == 4 ? 2 : 3);
+  for (i = 0; i < num_fields; i++)
+    {
+      while ((ch = getc (fp)) == ' ' || ch == '\n' || ch == '\t'
+	     || ch == '\r' || ch == '#')
+	if (ch == '#')
+	  while ((ch = getc (fp)) != EOF && ch != '\n')
+	    ;
+      fields[i] = 0;
+      for (; ch >= '0' && ch <= '9'; ch = getc (fp))
+	fields[i] = 10 * fields[i] + (ch - '0');
+    }
+  if (num_fields == 3 && fields[2] != 255)
+    die (c->description, "unexpected PNM maxval");
+
+  im->width = fields[0];
+  im->height = fields[1];
+  bytes = (type == 4 ? (long)((im->width + 7) / 8) * im->height
+	   : (long)(type == 5 ? 1 : 3) * im->width * im->height);
+  data = (unsigned char *)malloc ((size_t)bytes);
+  if (fread (data, 1, (size_t)bytes, fp) != (size_t)bytes)
+    die (c->description, "short PNM file");
+  im->rgba = (unsigned char *)malloc ((size_t)(4 * im->width * im->height));
+  for (y = 0; y < im->height; y++)
+    for (x = 0; x < im->width; x++)
+      {
+	unsigned char *p = im->rgba + 4 * (y * im->width + x);
+	int value;
+
+	switch (type)
+	  {
+	  case 4:
+	    value = data[y * ((im->width + 7) / 8) + x / 8];
+	    value = ((value >> (7 - x % 8)) & 1) ? 0 : 255;
+	    p[0] = p[1] = p[2] = (unsigned char)value;
+	    break;
+	  case 5:
+	    p[0] = p[1] = p[2] = data[y * im->width + x];
+	    break;
+	  default:
+	    memcpy (p, data + 3 * (y * im->width + x), 3);
+	    break;
+	  }
+	p[3] = 255;
+      }
+  free (data);
+}
+
+/* decode a PNG file as RGBA, checking its type, and (for a monochrome
+   image) that its transparent gray value is the transparent color's */
+static void
+decode_png (const test_case *c, FILE *fp, image *im)
+{
+  png_struct *png_ptr;
+  png_info *info_ptr;
+  png_byte **rows;
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type, y;
+
+  png_ptr = png_create_read_struct (PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  info_ptr = png_create_info_struct (png_ptr);
+  if (setjmp (png_jmpbuf (png_ptr)))
+    die (c->description, "libpng couldn't read the PNG file");
+  png_init_io (png_ptr, fp);
+  png_read_info (png_ptr, info_ptr);
+  png_get_IHDR (png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+		&interlace_type, NULL, NULL);
+  if (color_type != c->color_type || bit_depth != c->bit_depth)
+    die (c->description, "PNG file has the wrong image type");
+
+  if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth == 1
+      && png_get_valid (png_ptr, info_ptr, PNG_INFO_tRNS))
+    {
+      png_color_16 *trans_color;
+
+      png_get_tRNS (png_ptr, info_ptr, NULL, NULL, &trans_color);
+      if (trans_color->gray != (c->transparent[0] ? 1 : 0))
+	die (c->description, "monochrome PNG has the wrong transparent gray value");
+    }
+
+  /* expand everything to 8-bit RGBA */
+  png_set_expand (png_ptr);
+  png_set_gray_to_rgb (png_ptr);
+  png_set_filler (png_ptr, 0xff, PNG_FILLER_AFTER);
+  png_set_interlace_handling (png_ptr);
+  png_read_update_info (png_ptr, info_ptr);
+  if (png_get_rowbytes (png_ptr, info_ptr) != 4 * width)
+    die (c->description, "PNG file didn't expand to RGBA");
+
+  im->width = (int)width;
+  im->height = (int)height;
+  im->rgba = (unsigned char *)malloc ((size_t)(4 * width * height));
+  rows = (png_byte **)malloc (height * sizeof(png_byte *));
+  for (y = 0; y < (int)height; y++)
+    rows[y] = im->rgba + 4 * width * y;
+  png_read_image (png_ptr, rows);
+  png_read_end (png_ptr, NULL);
+  png_destroy_read_struct (&png_ptr, &info_ptr, NULL);
+  free (rows);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int k;
+
+  progname = argv[0];
+  for (k = 0; k < NUM_CASES; k++)
+    {
+      test_case *c = &cases[k];
+      image pnm, png;
+      FILE *fp;
+      int i, num_transparent = 0;
+
+      fp = draw_page (c, "pnm");
+      decode_pnm (c, fp, &pnm);
+      fclose (fp);
+
+      fp = draw_page (c, "png");
+      fseek (fp, 0L, SEEK_END);
+      c->size = ftell (fp);
+      rewind (fp);
+      decode_png (c, fp, &png);
+      fclose (fp);
+
+      if (png.width != pnm.width || png.height != pnm.height)
+	die (c->description, "PNG has the wrong size");
+      for (i = 0; i < pnm.width * pnm.height; i++)
+	{
+	  unsigned char *p = pnm.rgba + 4 * i, *q = png.rgba + 4 * i;
+
+	  /* pixels of the transparent color should be exactly the
+	     transparent ones */
+	  if (p[0] == c->transparent[0] && p[1] == c->transparent[1]
+	      && p[2] == c->transparent[2])
+	    {
+	      p[3] = 0;
+	      num_transparent++;
+	    }
+	  if (memcmp (p, q, 4) != 0)
+	    {
+	      fprintf (stderr, "%s: %s: PNG pixel (%d, %d) is wrong\n",
+		       progname, c->description,
+		       i % pnm.width, i / pnm.width);
+	      return EXIT_FAILURE;
+	    }
+	}
+      if (c->transparent[0] >= 0 && num_transparent == 0)
+	die (c->description, "no pixel has the transparent color");
+      free (pnm.rgba);
+      free (png.rgba);
+    }
+
+  /* the compression level should make a difference */
+  if (cases[LEVEL_0_CASE].size <= cases[LEVEL_9_CASE].size)
+    die ("compression level", "level 0 file isn't larger than level 9 file");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/* This file is part of the GNU plotutils package.
+
+   The GNU plotutils package is free software.  You may redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software foundation; either version 2, or (at your
+   option) any later version.
+
+   The GNU plotutils package is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with the GNU plotutils package; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin St., Fifth Floor,
+   Boston, MA 02110-1301, USA. */
+
+/* Test program for polyline.test.  It draws the same open polylines,
+   filled polygons and points on a Plotter of the specified type, writing
+   to standard output, either one point at a time (with fcont() and
+   fpoint()) or in batches (with fpolyline() and fpoints()).  The output
+   should be identical.
+
+   Usage: polyline TYPE single|batch */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "plot.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264
+#endif
+
+#define NUM_POINTS 700		/* more than MAX_LINE_LENGTH (500) */
+
+static double x[NUM_POINTS], y[NUM_POINTS];
+
+/* draw n vertices, starting with a move to the first */
+static void
+draw_polyline (plPlotter *plotter, int batch, int n)
+{
+  int i;
+
+  pl_fmove_r (plotter, x[0], y[0]);
+  if (batch)
+    pl_fpolyline_r (plotter, n - 1, x + 1, y + 1);
+  else
+    for (i = 1; i < n; i++)
+      pl_fcont_r (plotter, x[i], y[i]);
+}
+
+static void
+draw_points (plPlotter *plotter, int batch, int n)
+{
+  int i;
+
+  if (batch)
+    pl_fpoints_r (plotter, n, x, y);
+  else
+    for (i = 0; i < n; i++)
+      pl_fpoint_r (plotter, x[i], y[i]);
+}
+
+int
+main (int argc, char *argv[])
+{
+  plPlotterParams *params;
+  plPlotter *plotter;
+  int batch;
+  int i;
+
+  if (argc != 3)
+    {
+      fprintf (stderr, "Usage: %s TYPE single|batch\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  batch = (strcmp (argv[2], "batch") == 0);
+
+  params = pl_newplparams ();
+  plotter = pl_newpl_r (argv[1], NULL, stdout, stderr, params);
+  if (plotter == NULL || pl_openpl_r (plotter) < 0)
+    {
+      fprintf (stderr, "%s: couldn't open %s Plotter\n", argv[0], argv[1]);
+      return EXIT_FAILURE;
+    }
+  pl_fspace_r (plotter, 0.0, 0.0, 1000.0, 1000.0);
+  pl_flinewidth_r (plotter, 2.0);
+
+  /* an open polyline, long enough to be flushed part way through */
+  for (i = 0; i < NUM_POINTS; i++)
+    {
+      x[i] = 50.0 + 900.0 * i / (NUM_POINTS - 1);
+      y[i] = 750.0 + 150.0 * sin (0.05 * i);
+    }
+  pl_pencolorname_r (plotter, "blue");
+  draw_polyline (plotter, batch, NUM_POINTS);
+  /* continue it with fcont(), then end it */
+  pl_fcont_r (plotter, 950.0, 550.0);
+  pl_endpath_r (plotter);
+
+  /* a filled, closed polygon (a star), which is never flushed early */
+  for (i = 0; i <= 10; i++)
+    {
+      double r = (i % 2 == 0 ? 200.0 : 80.0);
+
+      x[i] = 300.0 + r * sin (0.2 * M_PI * i);
+      y[i] = 350.0 + r * cos (0.2 * M_PI * i);
+    }
+  pl_filltype_r (plotter, 1);
+  pl_fillcolorname_r (plotter, "yellow");
+  pl_pencolorname_r (plotter, "red");
+  draw_polyline (plotter, batch, 11);
+  pl_endpath_r (plotter);
+  pl_filltype_r (plotter, 0);
+
+  /* a polyline following a primitive (a box), which must be flushed */
+  pl_fbox_r (plotter, 600.0, 200.0, 900.0, 450.0);
+  for (i = 0; i < 50; i++)
+    {
+      x[i] = 600.0 + 6.0 * i;
+      y[i] = 200.0 + 250.0 * (i % 2);
+    }
+  draw_polyline (plotter, batch, 50);
+  pl_endpath_r (plotter);
+
+  /* points */
+  for (i = 0; i < 200; i++)
+    {
+      x[i] = 100.0 + 4.0 * i;
+      y[i] = 100.0 + 50.0 * cos (0.1 * i);
+    }
+  pl_pencolorname_r (plotter, "green");
+  draw_points (plotter, batch, 200);
+
+  pl_closepl_r (plotter);
+  pl_deletepl_r (plotter);
+  pl_deleteplparams (params);
+
+  return EXIT_SUCCESS;
+}